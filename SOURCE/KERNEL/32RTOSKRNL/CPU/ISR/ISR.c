@@ -34,6 +34,7 @@ REMARKS
 #include <STD/MEM.h>
 #include <CPU/YIELD/YIELD.h>
 #include <CPU/FPU/FPU.h>
+#include <DEBUG/TRACE.h>
 static ISRHandler g_Handlers[IDT_COUNT] __attribute__((section(".data"))) = { 0 };
 #else // __RTOS__
 static ISRHandler g_Handlers[IDT_COUNT]  = { 0 };
@@ -86,6 +87,7 @@ void irq_common_handler(I32 vector, U32 errcode) {
     if (!g_Handlers[vector]) {
         if(vector != 0x21 && vector != 0x28) DUMP_ERRCODE(vector);
     }
+    TRACE(TRACE_EV_IRQ, vector, 0, 0);
     #endif // __RTOS__
     if (g_Handlers[vector]) {
         g_Handlers[vector](vector, errcode);
@@ -141,6 +143,9 @@ void page_fault_handler(I32 num, U32 errcode) {
     U8 reserved  = errcode & 0x8;    // Overwritten CPU-reserved bits of page entry?
     U8 id        = errcode & 0x10;   // Caused by an instruction fetch?
 
+    TCB *faulting = get_current_tcb();
+    if (faulting) faulting->info.page_faults++;
+
     U8 buf[128];
     ITOA_U(faulting_address, buf, 16);
     VBE_DRAW_STRING(10, 10, "Page fault at ", VBE_WHITE, VBE_BLACK);
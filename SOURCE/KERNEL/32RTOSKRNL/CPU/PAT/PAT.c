@@ -0,0 +1,141 @@
+#include <CPU/PAT/PAT.h>
+#include <DEBUG/KDEBUG.h>
+#include <STD/ASM.h>
+
+#define MSR_MTRRCAP         0x0FE
+#define MSR_MTRR_PHYSBASE0  0x200   // PHYSMASKn follows PHYSBASEn
+#define MSR_PAT             0x277
+#define MSR_MTRR_DEF_TYPE   0x2FF
+
+#define MTRRCAP_VCNT        0xFF
+#define MTRRCAP_WC          (1 << 10)
+#define MTRR_DEF_ENABLE     (1 << 11)
+#define MTRR_MASK_VALID     (1 << 11)
+
+#define CPUID_MTRR          (1 << 12)
+#define CPUID_PAT           (1 << 16)
+
+#define CR0_CD              (1u << 30)
+#define CR0_NW              (1u << 29)
+#define CR4_PGE             (1u << 7)
+
+static BOOLEAN pat_enabled ATTRIB_DATA = FALSE;
+
+static VOID cpuid(U32 leaf, U32 *a, U32 *d) {
+    U32 b, c;
+    ASM_VOLATILE("cpuid" : "=a"(*a), "=b"(b), "=c"(c), "=d"(*d) : "a"(leaf));
+}
+
+static BOOLEAN cpu_has(U32 edx_bit) {
+    U32 a, d;
+    cpuid(1, &a, &d);
+    return (d & edx_bit) != 0;
+}
+
+// Bits of a physical address above 4 GB, for the high half of PHYSMASKn
+static U32 phys_mask_hi(VOID) {
+    U32 max, d, bits = 36;
+    cpuid(0x80000000, &max, &d);
+    if (max >= 0x80000008) {
+        cpuid(0x80000008, &bits, &d);
+        bits &= 0xFF;
+    }
+    return bits > 32 ? (1u << (bits - 32)) - 1 : 0;
+}
+
+static inline U32 read_cr0(VOID) { U32 v; ASM_VOLATILE("mov %%cr0, %0" : "=r"(v)); return v; }
+static inline U32 read_cr4(VOID) { U32 v; ASM_VOLATILE("mov %%cr4, %0" : "=r"(v)); return v; }
+static inline VOID write_cr0(U32 v) { ASM_VOLATILE("mov %0, %%cr0" : : "r"(v) : "memory"); }
+static inline VOID write_cr4(U32 v) { ASM_VOLATILE("mov %0, %%cr4" : : "r"(v) : "memory"); }
+
+static inline VOID flush_tlb(VOID) {
+    U32 cr3;
+    ASM_VOLATILE("mov %%cr3, %0; mov %0, %%cr3" : "=r"(cr3) : : "memory");
+}
+
+typedef struct {
+    U32 irq;
+    U32 cr0;
+    U32 cr4;
+} CACHE_STATE;
+
+// Entry half of the SDM sequence for changing PAT or MTRRs: no-fill cache
+// mode, caches written back, global pages off so the TLB flush drops them too
+static VOID cache_off(CACHE_STATE *s) {
+    s->irq = irq_save();
+    s->cr0 = read_cr0();
+    s->cr4 = read_cr4();
+    write_cr0((s->cr0 | CR0_CD) & ~CR0_NW);
+    ASM_VOLATILE("wbinvd" ::: "memory");
+    if (s->cr4 & CR4_PGE) write_cr4(s->cr4 & ~CR4_PGE);
+    flush_tlb();
+}
+
+static VOID cache_on(CACHE_STATE *s) {
+    ASM_VOLATILE("wbinvd" ::: "memory");
+    flush_tlb();
+    write_cr0(s->cr0);
+    if (s->cr4 & CR4_PGE) write_cr4(s->cr4);
+    irq_restore(s->irq);
+}
+
+BOOLEAN PAT_INIT(VOID) {
+    if (pat_enabled) return TRUE;
+    if (!cpu_has(CPUID_PAT)) return FALSE;
+
+    U32 lo, hi;
+    rdmsr(MSR_PAT, &lo, &hi);
+    lo = (lo & ~0x0000FF00) | (MEM_TYPE_WC << 8); // PA1, the PWT=1 entry
+
+    CACHE_STATE s;
+    cache_off(&s);
+    wrmsr(MSR_PAT, lo, hi);
+    cache_on(&s);
+    pat_enabled = TRUE;
+    return TRUE;
+}
+
+BOOLEAN PAT_ENABLED(VOID) {
+    return pat_enabled;
+}
+
+BOOLEAN MTRR_SET_WC(U32 base, U32 size) {
+    if (size < PAGE_SIZE || (size & (size - 1)) || (base & (size - 1))) return FALSE;
+    if (!cpu_has(CPUID_MTRR)) return FALSE;
+
+    U32 cap, hi;
+    rdmsr(MSR_MTRRCAP, &cap, &hi);
+    if (!(cap & MTRRCAP_WC)) return FALSE;
+    U32 def, def_hi;
+    rdmsr(MSR_MTRR_DEF_TYPE, &def, &def_hi);
+    if (!(def & MTRR_DEF_ENABLE)) return FALSE; // everything is UC already
+
+    I32 slot = -1;
+    U32 mask = ~(size - 1);
+    for (U32 i = 0; i < (cap & MTRRCAP_VCNT); i++) {
+        U32 b_lo, b_hi, m_lo, m_hi;
+        rdmsr(MSR_MTRR_PHYSBASE0 + 2 * i, &b_lo, &b_hi);
+        rdmsr(MSR_MTRR_PHYSBASE0 + 2 * i + 1, &m_lo, &m_hi);
+        if (!(m_lo & MTRR_MASK_VALID)) {
+            if (slot < 0) slot = (I32)i;
+            continue;
+        }
+        if (b_hi) continue; // above 4 GB
+        // Power-of-two ranges overlap when they agree on the larger one's mask
+        U32 m = mask & m_lo & ~0xFFF;
+        if ((b_lo & m) != (base & m)) continue;
+        if ((b_lo & 0xFF) == MEM_TYPE_WC) continue;
+        KDEBUG_STR_HEX_LN("[PAT] Range overlaps variable MTRR ", i);
+        return FALSE;
+    }
+    if (slot < 0) return FALSE;
+
+    CACHE_STATE s;
+    cache_off(&s);
+    wrmsr(MSR_MTRR_DEF_TYPE, def & ~MTRR_DEF_ENABLE, def_hi);
+    wrmsr(MSR_MTRR_PHYSBASE0 + 2 * slot, base | MEM_TYPE_WC, 0);
+    wrmsr(MSR_MTRR_PHYSBASE0 + 2 * slot + 1, mask | MTRR_MASK_VALID, phys_mask_hi());
+    wrmsr(MSR_MTRR_DEF_TYPE, def, def_hi);
+    cache_on(&s);
+    return TRUE;
+}
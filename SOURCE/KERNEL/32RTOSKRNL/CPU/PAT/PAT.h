@@ -0,0 +1,47 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/CPU/PAT/PAT.h - Memory types through PAT and MTRRs
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Lets the kernel map memory write-combining, which the default caching
+    rules never pick for the linear framebuffer.
+
+    PAT_INIT reprograms PAT entry 1 (the one PWT alone selects, write-through
+    by default) to write-combining. Pages mapped with PAGE_WC after that are
+    WC whatever the MTRRs say. Without PAT, MTRR_SET_WC marks a physical range
+    WC through a free variable-range MTRR instead.
+
+REMARKS
+    Both rewrite caching state and flush every cache: boot time only, with
+    interrupts off. Every mapping of a range must use the same type.
+---*/
+#ifndef PAT_H
+#define PAT_H
+
+#include <STD/TYPEDEF.h>
+#include <MEMORY/PAGING/PAGING.h>
+
+// Memory types, as used in the PAT entries and the MTRRs
+#define MEM_TYPE_UC 0x00
+#define MEM_TYPE_WC 0x01
+#define MEM_TYPE_WT 0x04
+#define MEM_TYPE_WP 0x05
+#define MEM_TYPE_WB 0x06
+
+// Page flags selecting PAT entry 1. Write-combining once PAT_INIT returned TRUE
+#define PAGE_WC PAGE_WRITETHRU
+
+/// @return FALSE if the CPU has no PAT, PAGE_WC then means write-through.
+BOOLEAN PAT_INIT(VOID);
+BOOLEAN PAT_ENABLED(VOID);
+
+/// Makes [base, base + size) WC through a variable-range MTRR. `size` must
+/// be a power of two of at least 4 KB and `base` aligned to it.
+/// @return FALSE without MTRR WC support, a free MTRR, or if an uncached
+/// range already covers part of it (UC wins over WC).
+BOOLEAN MTRR_SET_WC(U32 base, U32 size);
+
+#endif // PAT_H
@@ -10,6 +10,7 @@
 #include <DEBUG/KDEBUG.h>
 #include <CPU/SYSCALL/SYSCALL.h>
 #include <CPU/YIELD/YIELD.h>
+#include <SYSINFO/SYSINFO.h>
 
 #define PIT_CHANNEL0 0x40
 #define PIT_COMMAND  0x43
@@ -138,6 +139,12 @@ __attribute__((naked)) void isr_pit(void) {
         "movw %%ax, %%fs\n\t"
         "movw %%ax, %%gs\n\t"
 
+        // Count the hardware tick here, not in the scheduler: isr_yield
+        // shares pit_handler_task_control and must not advance time.
+        // Then publish it to the shared SYSINFO page
+        "incl ticks\n\t"
+        "call SYSINFO_TICK\n\t"
+
         // Save current task's stack pointer and call scheduler
         "movl %%esp, current_task_esp\n\t"
 
@@ -13,6 +13,7 @@
 #include <FS/FAT/FAT.h>
 
 #include <DRIVERS/VESA/VBE.h>
+#include <DRIVERS/VESA/VBE_CMD.h>
 #include <DRIVERS/PS2/KEYBOARD_MOUSE.h>
 #include <DRIVERS/ATA_PIO/ATA_PIO.h>
 #include <DRIVERS/ATA_PIIX3/ATA_PIIX3.h>
@@ -23,7 +24,9 @@
 #include <RTOSKRNL/RTOSKRNL_INTERNAL.h>
 
 #include <CPU/PIT/PIT.h>
+#include <CPU/TSC/TSC.h>
 #include <DEBUG/KDEBUG.h>
+#include <DEBUG/TRACE.h>
 
 #define SYSCALL_ENTRY(id, fn) [id] = fn,
 static SYSCALL_HANDLER syscall_table[SYSCALL_MAX] = {
@@ -52,10 +55,44 @@ U32 SYS_GET_TIME(U32 unused1, U32 unused2, U32 unused3, U32 unused4, U32 unused5
     return m;
 }
 
-U32 SYS_VBE_UPDATE_VRAM(U32 unused1, U32 unused2, U32 unused3, U32 unused4, U32 unused5) {
+U32 SYS_GET_CLOCK(U32 clock_id, U32 ms_out, U32 unused3, U32 unused4, U32 unused5) {
+    (void)unused3; (void)unused4; (void)unused5;
+    return CLOCK_GET(clock_id, (U32 *)ms_out);
+}
+
+U32 SYS_TSC_KHZ(U32 unused1, U32 unused2, U32 unused3, U32 unused4, U32 unused5) {
     (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    return TSC_GET_KHZ();
+}
+
+U32 SYS_PROC_PROFILE(U32 op, U32 pid, U32 a1, U32 a2, U32 unused5) {
+    (void)unused5;
+    switch (op) {
+        case PROC_PROFILE_OP_START: return PROC_PROFILE_START(pid, a1);
+        case PROC_PROFILE_OP_STOP:  PROC_PROFILE_STOP(pid); return 0;
+        case PROC_PROFILE_OP_READ:  return PROC_PROFILE_READ(pid, (PROC_PROFILE *)a1, a2);
+    }
+    return (U32)-1;
+}
+
+U32 SYS_TRACE_CTL(U32 op, U32 a1, U32 a2, U32 a3, U32 unused5) {
+    (void)unused5;
+    switch (op) {
+        case TRACE_OP_GET_MASK: return TRACE_GET_MASK();
+        case TRACE_OP_SET_MASK: return TRACE_SET_MASK(a1);
+        case TRACE_OP_CLEAR:    TRACE_CLEAR(); return 0;
+        case TRACE_OP_DUMP:     return TRACE_DUMP((U16)a1);
+        case TRACE_OP_COUNT:    return TRACE_COUNT();
+        case TRACE_OP_MARK:     TRACE(TRACE_EV_MARK, a1, a2, a3); return 0;
+    }
+    return (U32)-1;
+}
+
+U32 SYS_VBE_UPDATE_VRAM(U32 rects, U32 count, U32 unused3, U32 unused4, U32 unused5) {
+    (void)unused3; (void)unused4; (void)unused5;
 
-    VBE_UPDATE_VRAM();
+    if (rects && count) flush_focused_framebuffer_rects((CONST VBE_RECT *)rects, count);
+    else VBE_UPDATE_VRAM();
     return 0;
 }
 U32 SYS_VBE_DRAW_CHARACTER(U32 x, U32 y, U32 ch, U32 fg, U32 bg) {
@@ -108,6 +145,12 @@ U32 SYS_VBE_DRAW_RECTANGLE(U32 x, U32 y, U32 width, U32 height, U32 colour) {
 
     return (U32)VBE_DRAW_RECTANGLE(x, y, width, height, (VBE_PIXEL_COLOUR)colour);
 }
+U32 SYS_VBE_SUBMIT(U32 cmds, U32 words, U32 unused3, U32 unused4, U32 unused5) {
+    (void)unused3; (void)unused4; (void)unused5;
+    if (!cmds) return 0;
+
+    return VBE_SUBMIT((CONST U32 *)cmds, words);
+}
 
 
 
@@ -164,6 +207,17 @@ U32 SYS_GET_MESSAGE(U32 unused1, U32 unused2, U32 unused3, U32 unused4, U32 unus
     // (Do not copy or allocate; remains valid as-is)
     // msg_copy->raw_data and msg_copy->raw_data_size already set
 
+    // --- Moved SHM region: map it here, the message's reference becomes ours ---
+    if (msg->shm) {
+        if (SHM_REGION_ATTACH(t, msg->shm)) {
+            msg_copy->raw_data = (VOIDPTR)SHM_REGION_ADDR(t, msg->shm);
+            msg_copy->raw_data_size = SHM_REGION_SIZE(msg->shm);
+        } else {
+            msg_copy->shm = 0;
+        }
+        msg->shm = 0;
+    }
+
     // Advance message queue
     t->msg_queue_head = (t->msg_queue_head + 1) % PROC_MSG_QUEUE_SIZE;
     t->msg_count--;
@@ -181,6 +235,17 @@ U32 SYS_GET_MESSAGE(U32 unused1, U32 unused2, U32 unused3, U32 unused4, U32 unus
     return (U32)msg_copy;
 }
 
+// As SYS_GET_MESSAGE, but with the queue empty the caller is parked until a
+// message arrives or timeout_ms pass (U32_MAX: no timeout, 0: don't wait).
+// Returns NULL then; STD's RECEIVE_MESSAGE yields and asks again
+U32 SYS_RECEIVE_MESSAGE(U32 timeout_ms, U32 unused2, U32 unused3, U32 unused4, U32 unused5) {
+    (void)unused2; (void)unused3; (void)unused4; (void)unused5;
+    TCB *t = get_current_tcb();
+    if (!t) return 0;
+    if (t->msg_count) return SYS_GET_MESSAGE(0, 0, 0, 0, 0);
+    if (timeout_ms) proc_wait(t, PROC_WAIT_MESSAGE, 0, timeout_ms == U32_MAX ? 0 : timeout_ms);
+    return 0;
+}
 
 U32 SYS_SEND_MESSAGE(U32 msg_ptr, U32 unused2, U32 unused3, U32 unused4, U32 unused5) {
     (void)unused2; (void)unused3; (void)unused4; (void)unused5;
@@ -199,10 +264,45 @@ U32 SYS_SEND_MESSAGE(U32 msg_ptr, U32 unused2, U32 unused3, U32 unused4, U32 unu
     KDEBUG_HEX32(msg->receiver_pid);
     KDEBUG_PUTS("\n");
     
-    send_msg(msg);
+    // A region changes hands: gone from the sender now, mapped into the
+    // receiver when it fetches the message. Restored if it can't be queued
+    U32 shm = msg->shm;
+    TCB *sender = get_current_tcb();
+    if (shm && !SHM_REGION_DETACH(sender, shm)) return (U32)-1;
+    if (!send_msg_shm(msg, shm)) {
+        if (shm) SHM_REGION_ATTACH(sender, shm);
+        return (U32)-1;
+    }
+    return 0;
+}
+
+U32 SYS_SHM(U32 op, U32 a1, U32 a2, U32 unused4, U32 unused5) {
+    (void)unused4; (void)unused5;
+    TCB *t = get_current_tcb();
+    switch (op) {
+        case SHM_OP_CREATE: return SHM_REGION_CREATE(t, (CONST U8 *)a1, a2);
+        case SHM_OP_OPEN:   return SHM_REGION_OPEN(t, (CONST U8 *)a1);
+        case SHM_OP_MAP:    return SHM_REGION_MAP(t, a1);
+        case SHM_OP_CLOSE:  return SHM_REGION_CLOSE(t, a1);
+        case SHM_OP_ADDR:   return SHM_REGION_ADDR(t, a1);
+        case SHM_OP_SIZE:   return SHM_REGION_SIZE(a1);
+    }
     return 0;
 }
 
+U32 SYS_PIPE(U32 op, U32 a1, U32 a2, U32 a3, U32 unused5) {
+    (void)unused5;
+    TCB *t = get_current_tcb();
+    switch (op) {
+        case PIPE_OP_CREATE: return PIPE_OBJECT_CREATE(t);
+        case PIPE_OP_READ:   return PIPE_OBJECT_READ(t, a1, (U8 *)a2, a3);
+        case PIPE_OP_WRITE:  return PIPE_OBJECT_WRITE(t, a1, (CONST U8 *)a2, a3);
+        case PIPE_OP_CLOSE:  return PIPE_OBJECT_CLOSE(t, a1, a2);
+        case PIPE_OP_STDIO:  return t ? (a1 ? t->stdout_pipe : t->stdin_pipe) : 0;
+    }
+    return PIPE_ERROR;
+}
+
 U32 SYS_GET_CURRENT_TCB(U32 unused1, U32 unused2, U32 unused3, U32 unused4, U32 unused5) {
     (void)unused1; (void)unused2; (void)unused3; (void)unused4; (void)unused5;
     TCB *t = get_current_tcb();
@@ -578,7 +678,11 @@ U32 syscall_dispatcher(U32 num, U32 a1, U32 a2, U32 a3, U32 a4, U32 a5) {
     SYSCALL_HANDLER h = syscall_table[num];
     if (!h) return (U32)-1;
 
-    return h(a1, a2, a3, a4, a5);
+    get_current_tcb()->info.syscalls++;
+    TRACE(TRACE_EV_SYSCALL_ENTER, num, a1, 0);
+    U32 ret = h(a1, a2, a3, a4, a5);
+    TRACE(TRACE_EV_SYSCALL_EXIT, num, ret, 0);
+    return ret;
 }
 
 
@@ -605,10 +709,14 @@ U32 SYS_KILL_BINARY(U32 pid, U32 unused2, U32 unused3, U32 unused4, U32 unused5)
     KILL_PROCESS(pid);
 }
 
+// Parks the caller for `ms`; it sleeps once it yields. The kernel task,
+// which is never parked, still spins
 U32 SYS_PIT_SLEEP(U32 ms, U32 unused2, U32 unused3, U32 unused4, U32 unused5) {
     (void)unused2; (void)unused3; (void)unused4; (void)unused5;
     if (ms == 0) return 1;
-    PIT_WAIT_MS(ms);
+    TCB *t = get_current_tcb();
+    if (!t || t->info.pid == 0) PIT_WAIT_MS(ms);
+    else proc_wait(t, PROC_WAIT_SLEEP, 0, ms);
     return 0;
 }
 __attribute__((naked)) void isr_syscall(void) {
@@ -625,3 +733,64 @@ __attribute__((naked)) void isr_syscall(void) {
     );
 }
 
+
+// SYSENTER fast path. Everything runs in ring 0 and SYSEXIT can only
+// return to ring 3, so the stub enters with SYSENTER and returns with a
+// plain `ret` into the frame SYSCALL() pushed (see SYSCALL.h).
+#define MSR_SYSENTER_CS  0x174
+#define MSR_SYSENTER_ESP 0x175
+#define MSR_SYSENTER_EIP 0x176
+
+// Only live between SYSENTER and the stub's first instruction, unless an
+// NMI lands there
+#define SYSENTER_STACK_SIZE 256
+static U8 sysenter_stack[SYSENTER_STACK_SIZE] ATTRIB_ALIGNED(16) ATTRIB_DATA = {0};
+static BOOLEAN sysenter_enabled ATTRIB_DATA = FALSE;
+
+// CPUID.1:EDX.SEP. The Pentium Pro (family 6, model < 3, stepping < 3)
+// reports it without implementing it
+static BOOLEAN cpu_has_sysenter(VOID) {
+    U32 a, b, c, d;
+    ASM_VOLATILE("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(1));
+    U32 family = (a >> 8) & 0xF, model = (a >> 4) & 0xF, stepping = a & 0xF;
+    if (family == 6 && model < 3 && stepping < 3) return FALSE;
+    return (d & (1 << 11)) != 0;
+}
+
+BOOLEAN SYSCALL_FAST_INIT(VOID) {
+    if (sysenter_enabled) return TRUE;
+    if (!cpu_has_sysenter()) {
+        KDEBUG_PUTS("[SYSCALL] No SYSENTER, using int 0x80\n");
+        return FALSE;
+    }
+    wrmsr(MSR_SYSENTER_CS, 0x08, 0);
+    wrmsr(MSR_SYSENTER_ESP, (U32)(sysenter_stack + SYSENTER_STACK_SIZE), 0);
+    wrmsr(MSR_SYSENTER_EIP, (U32)sysenter_entry, 0);
+    sysenter_enabled = TRUE;
+    return TRUE;
+}
+
+BOOLEAN SYSCALL_FAST_ENABLED(VOID) {
+    return sysenter_enabled;
+}
+
+// Entered with IF clear, EBP = caller's ESP pointing at its resume address.
+// EAX..EDI carry the same arguments as int 0x80; only EAX comes back changed
+__attribute__((naked)) void sysenter_entry(void) {
+    asm volatile(
+        "movl %ebp, %esp\n\t"        // back onto the caller's stack
+        "pushl %ecx\n\t"             // caller-saved in cdecl, kept for SYSCALL()
+        "pushl %edx\n\t"
+        "pushl %edi\n\t"             // syscall_dispatcher(num, a1..a5)
+        "pushl %esi\n\t"
+        "pushl %edx\n\t"
+        "pushl %ecx\n\t"
+        "pushl %ebx\n\t"
+        "pushl %eax\n\t"
+        "call syscall_dispatcher\n\t"
+        "addl $24, %esp\n\t"
+        "popl %edx\n\t"
+        "popl %ecx\n\t"
+        "ret\n\t"                    // to SYSCALL()'s popfl, which restores IF
+    );
+}
@@ -29,8 +29,8 @@ enum {
     #include <CPU/SYSCALL/SYSCALL_LIST.h>
 #undef SYSCALL_ENTRY
 
-/* user-space macros (unchanged) ... */
-#define SYSCALL(num, a1, a2, a3, a4, a5) ({ \
+/* user-space macros */
+#define SYSCALL_INT(num, a1, a2, a3, a4, a5) ({ \
     U32 ret; \
     __asm__ volatile ( \
         "int $0x80" \
@@ -41,6 +41,66 @@ enum {
     ret; \
 })
 
+#ifndef __RTOS__
+#define SYSINFO_ONLY_DEFINES
+#include <SYSINFO/SYSINFO.h>
+#undef SYSINFO_ONLY_DEFINES
+
+#define SYSCALL_FEATURES_ADDR (SYSINFO_VADDR + __builtin_offsetof(SYSINFO_PAGE, features))
+
+/* Same registers as SYSCALL_INT. SYSENTER does not save a return address
+ * and leaves ESP at the kernel's scratch stack, so the caller's frame
+ * (EBP, EFLAGS, resume address) goes on its own stack and EBP points at
+ * it; sysenter_entry switches back to that stack and `ret`s. The popfl
+ * restores IF, which SYSENTER cleared. */
+#define SYSCALL_SYSENTER(num, a1, a2, a3, a4, a5) ({ \
+    U32 ret; \
+    __asm__ volatile ( \
+        "pushl %%ebp\n\t" \
+        "pushfl\n\t" \
+        "pushl $1f\n\t" \
+        "movl %%esp, %%ebp\n\t" \
+        "sysenter\n" \
+        "1:\n\t" \
+        "popfl\n\t" \
+        "popl %%ebp" \
+        : "=a"(ret) \
+        : "a"(num), "b"(a1), "c"(a2), "d"(a3), "S"(a4), "D"(a5) \
+        : "memory", "cc" \
+    ); \
+    ret; \
+})
+
+/* SYSENTER when the kernel enabled it (SYSINFO_FEATURE_SYSENTER), int 0x80
+ * otherwise. The test is one load from the SYSINFO page. */
+#define SYSCALL(num, a1, a2, a3, a4, a5) ({ \
+    U32 ret; \
+    __asm__ volatile ( \
+        "testl %[fast], %c[features]\n\t" \
+        "jz 2f\n\t" \
+        "pushl %%ebp\n\t" \
+        "pushfl\n\t" \
+        "pushl $1f\n\t" \
+        "movl %%esp, %%ebp\n\t" \
+        "sysenter\n" \
+        "1:\n\t" \
+        "popfl\n\t" \
+        "popl %%ebp\n\t" \
+        "jmp 3f\n" \
+        "2:\n\t" \
+        "int $0x80\n" \
+        "3:" \
+        : "=a"(ret) \
+        : "a"(num), "b"(a1), "c"(a2), "d"(a3), "S"(a4), "D"(a5), \
+          [features] "i"(SYSCALL_FEATURES_ADDR), [fast] "i"(SYSINFO_FEATURE_SYSENTER) \
+        : "memory", "cc" \
+    ); \
+    ret; \
+})
+#else
+#define SYSCALL(num, a1, a2, a3, a4, a5) SYSCALL_INT(num, a1, a2, a3, a4, a5)
+#endif // __RTOS__
+
 #define SYSCALL0(num) SYSCALL(num, NULL, NULL, NULL, NULL, NULL)
 #define SYSCALL1(num, a1) SYSCALL(num, a1, NULL, NULL, NULL, NULL)
 #define SYSCALL2(num, a1, a2) SYSCALL(num, a1, a2, NULL, NULL, NULL)
@@ -64,6 +124,15 @@ typedef struct {
 #ifdef __RTOS__
 U32 syscall_dispatcher(U32 num, U32 a1, U32 a2, U32 a3, U32 a4, U32 a5);
 __attribute__((naked)) void isr_syscall(void);  
+__attribute__((naked)) void sysenter_entry(void);
+
+/// Points the SYSENTER MSRs at sysenter_entry if the CPU has a working
+/// SYSENTER. Call once during CPU init, before SYSINFO_INIT publishes it.
+/// @return FALSE if programs stay on int 0x80
+BOOLEAN SYSCALL_FAST_INIT(VOID);
+
+/// @return TRUE once SYSCALL_FAST_INIT enabled SYSENTER
+BOOLEAN SYSCALL_FAST_ENABLED(VOID);
 #endif // __RTOS__
 
 #endif // KERNEL_ENTRY
@@ -3,7 +3,10 @@ IPC
 ---*/ 
 SYSCALL_ENTRY(SYSCALL_MESSAGE_AMOUNT, SYS_MESSAGE_AMOUNT) // U32(U32 pid)
 SYSCALL_ENTRY(SYSCALL_GET_MESSAGE, SYS_GET_MESSAGE) // VOIDPTR(U32 pid)
-SYSCALL_ENTRY(SYSCALL_SEND_MESSAGE, SYS_SEND_MESSAGE) // VOID(U32 pid, U8 *msg, U8 length, U32 signal)
+SYSCALL_ENTRY(SYSCALL_SEND_MESSAGE, SYS_SEND_MESSAGE) // U32(PROC_MESSAGE *msg). 0, or -1 if it was not queued
+SYSCALL_ENTRY(SYSCALL_SHM, SYS_SHM) // U32(SHM_OP op, U32 a1, U32 a2). Shared memory regions, see SHM/SHM.h
+SYSCALL_ENTRY(SYSCALL_RECEIVE_MESSAGE, SYS_RECEIVE_MESSAGE) // VOIDPTR(U32 timeout_ms). NULL and parked until a message or the timeout
+SYSCALL_ENTRY(SYSCALL_PIPE, SYS_PIPE) // U32(PIPE_OP op, U32 a1, U32 a2, U32 a3). Pipes, see PIPE/PIPE.h
 
 /*+++
 Process structures
@@ -13,6 +16,7 @@ SYSCALL_ENTRY(SYSCALL_GET_MASTER_TCB, SYS_GET_MASTER_TCB) // TCB *(void)
 SYSCALL_ENTRY(SYSCALL_GET_TCB_BY_PID, SYS_GET_TCB_BY_PID) // TCB *(U32 pid)
 SYSCALL_ENTRY(SYSCALL_GET_PARENT_TCB, SYS_GET_PARENT_TCB) // TCB *(void)
 SYSCALL_ENTRY(SYSCALL_PROC_GETPID_BY_NAME, SYS_PROC_GETPID_BY_NAME) // U32(U8 *name)
+SYSCALL_ENTRY(SYSCALL_PROC_PROFILE, SYS_PROC_PROFILE) // U32(PROC_PROFILE_OP op, U32 pid, U32 a1, U32 a2). EIP sampling, see PROC.h
 
 /*+++
 PS/2 Keyboard and Mouse
@@ -36,7 +40,7 @@ Raw VBE graphics
 ---*/ 
 SYSCALL_ENTRY(SYSCALL_VBE_DRAW_CHARACTER, SYS_VBE_DRAW_CHARACTER) // void(U32 x, U32 y, U8 ch, U32 fg, U32 bg)
 SYSCALL_ENTRY(SYSCALL_VBE_DRAW_STRING, SYS_VBE_DRAW_STRING) // void(U32 x, U32 y, U8 *str, U32 fg, U32 bg)
-SYSCALL_ENTRY(SYSCALL_VBE_UPDATE_VRAM, SYS_VBE_UPDATE_VRAM) // void(void)
+SYSCALL_ENTRY(SYSCALL_VBE_UPDATE_VRAM, SYS_VBE_UPDATE_VRAM) // void(VBE_RECT *rects, U32 count). NULL rects flushes the whole screen
 SYSCALL_ENTRY(SYSCALL_VBE_CLEAR_SCREEN, SYS_VBE_CLEAR_SCREEN) // void(U32 color)
 SYSCALL_ENTRY(SYSCALL_VBE_DRAW_PIXEL, SYS_VBE_DRAW_PIXEL) // void(U32 x, U32 y, U32 color)
 SYSCALL_ENTRY(SYSCALL_VBE_DRAW_FRAMEBUFFER, SYS_VBE_DRAW_FRAMEBUFFER) // void(U32 pos, U32 color)
@@ -45,6 +49,7 @@ SYSCALL_ENTRY(SYSCALL_VBE_DRAW_FILLED_ELLIPSE, SYS_VBE_DRAW_FILLED_ELLIPSE) // v
 SYSCALL_ENTRY(SYSCALL_VBE_DRAW_LINE, SYS_VBE_DRAW_LINE) // void(U32 x1, U32 y1, U32 x2, U32 y2, U32 color)
 SYSCALL_ENTRY(SYSCALL_VBE_DRAW_RECTANGLE, SYS_VBE_DRAW_RECTANGLE) // void(U32 x, U32 y, U32 width, U32 height, U32 color)
 SYSCALL_ENTRY(SYSCALL_VBE_DRAW_FILLED_RECTANGLE, SYS_VBE_DRAW_FILLED_RECTANGLE) // void(U32 x, U32 y, U32 width, U32 height, U32 color)
+SYSCALL_ENTRY(SYSCALL_VBE_SUBMIT, SYS_VBE_SUBMIT) // U32(U32 *cmds, U32 words). Replays a command buffer, see DRIVERS/VESA/VBE_CMD.h
 // SYSCALL_ENTRY(SYSCALL_VBE_DRAW_TRIANGLE, SYS_VBE_DRAW_TRIANGLE) // void(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, U32 color)
 // SYSCALL_ENTRY(SYSCALL_VBE_DRAW_FILLED_TRIANGLE, SYS_VBE_DRAW_FILLED_TRIANGLE) // void(U32 x1, U32 y1, U32 x2,
 
@@ -53,7 +58,7 @@ PIT
 ---*/ 
 SYSCALL_ENTRY(SYSCALL_GET_PIT_TICK, SYS_GET_PIT_TICK) // void(void)
 SYSCALL_ENTRY(SYSCALL_GET_SECONDS, SYS_GET_SECONDS)
-SYSCALL_ENTRY(SYSCALL_PIT_SLEEP, SYS_PIT_SLEEP) // void(U32 ms)
+SYSCALL_ENTRY(SYSCALL_PIT_SLEEP, SYS_PIT_SLEEP) // U32(U32 ms). Parks the caller, which must yield to sleep
 
 
 /*+++
@@ -131,5 +136,8 @@ System/Misc
 SYSCALL_ENTRY(SYSCALL_RESTART_MACHINE, SYS_RESTART_MACHINE)
 SYSCALL_ENTRY(SYSCALL_SHUTDOWN_MACHINE, SYS_SHUTDOWN_MACHINE)
 SYSCALL_ENTRY(SYSCALL_GET_TIME, SYS_GET_TIME) // RTC_DATE_TIME*(void). Must be freed by caller
+SYSCALL_ENTRY(SYSCALL_GET_CLOCK, SYS_GET_CLOCK) // U32(U32 clock_id, U32 *ms_out). Seconds of CLOCK_MONOTONIC/CLOCK_REALTIME
+SYSCALL_ENTRY(SYSCALL_TRACE_CTL, SYS_TRACE_CTL) // U32(TRACE_OP op, U32 a1, U32 a2, U32 a3). Kernel trace ring control, see DEBUG/TRACE.h
+SYSCALL_ENTRY(SYSCALL_TSC_KHZ, SYS_TSC_KHZ) // U32(void). Calibrated TSC frequency in kHz, 0 if unavailable
 
 SYSCALL_ENTRY(SYSCALL_NULL, SYS_NULL) // U32(void) - always returns 0, for testing and placeholder purposes
\ No newline at end of file
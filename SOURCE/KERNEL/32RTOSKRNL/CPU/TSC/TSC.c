@@ -0,0 +1,93 @@
+#include <CPU/TSC/TSC.h>
+#include <CPU/PIT/PIT.h>
+#include <DEBUG/KDEBUG.h>
+#include <STD/ASM.h>
+
+#define PIT_FREQUENCY   1193182
+#define PIT_CHANNEL2    0x42
+#define PIT_COMMAND     0x43
+#define PIT_GATE_PORT   0x61    // bit 0 gates channel 2, bit 1 drives the speaker, bit 5 is OUT2
+
+// Busy-loop bound for machines whose channel 2 OUT2 never rises
+#define CALIBRATE_SPIN_LIMIT 50000000
+
+static U32 tsc_khz ATTRIB_DATA = 0;
+
+static BOOLEAN cpu_has_tsc(VOID) {
+    U32 a, b, c, d;
+    ASM_VOLATILE("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(1));
+    return (d & (1 << 4)) != 0;
+}
+
+// Counts TSC cycles while PIT channel 2 counts down TSC_CALIBRATE_MS in
+// mode 0 (OUT2 goes high on terminal count). Returns 0 on timeout.
+static U32 measure_cycles(VOID) {
+    U32 latch = PIT_FREQUENCY * TSC_CALIBRATE_MS / 1000;
+    U8 saved = _inb(PIT_GATE_PORT);
+
+    _outb(PIT_GATE_PORT, (saved & ~0x02) | 0x01);   // gate on, speaker off
+    _outb(PIT_COMMAND, 0xB0);                       // channel 2, lo/hi, mode 0
+    _outb(PIT_CHANNEL2, latch & 0xFF);
+    _outb(PIT_CHANNEL2, (latch >> 8) & 0xFF);
+
+    U32 start = rdtsc_lo();
+    U32 spins = 0;
+    while (!(_inb(PIT_GATE_PORT) & 0x20)) {
+        if (++spins == CALIBRATE_SPIN_LIMIT) break;
+    }
+    U32 end = rdtsc_lo();
+
+    _outb(PIT_GATE_PORT, saved);
+    return spins == CALIBRATE_SPIN_LIMIT ? 0 : end - start;
+}
+
+BOOLEAN TSC_INIT(VOID) {
+    if (tsc_khz) return TRUE;
+    if (!cpu_has_tsc()) {
+        KDEBUG_PUTS("[TSC] Not present\n");
+        return FALSE;
+    }
+
+    // Keep the lowest of a few runs: an SMI or emulator hiccup only ever
+    // makes a run longer
+    U32 best = 0;
+    for (U32 i = 0; i < 3; i++) {
+        U32 c = measure_cycles();
+        if (c && (!best || c < best)) best = c;
+    }
+    if (!best) {
+        KDEBUG_PUTS("[TSC] PIT channel 2 did not fire, TSC unused\n");
+        return FALSE;
+    }
+    tsc_khz = best / TSC_CALIBRATE_MS;
+    KDEBUG_STR_HEX_LN("[TSC] Calibrated kHz: 0x", tsc_khz);
+    return TRUE;
+}
+
+U32 TSC_GET_KHZ(VOID) {
+    return tsc_khz;
+}
+
+U32 TSC_CYCLES_TO_NS(U32 cycles) {
+    if (!tsc_khz) return 0;
+    return umuldiv32(cycles, 1000000, tsc_khz);
+}
+
+U32 TSC_CYCLES_TO_US(U32 cycles) {
+    if (!tsc_khz) return 0;
+    return umuldiv32(cycles, 1000, tsc_khz);
+}
+
+U32 TSC_ELAPSED_NS(U32 start) {
+    return TSC_CYCLES_TO_NS(rdtsc_lo() - start);
+}
+
+VOID TSC_DELAY_US(U32 us) {
+    if (!tsc_khz) {
+        PIT_WAIT_MS((us + 999) / 1000);
+        return;
+    }
+    U32 cycles = umuldiv32(us, tsc_khz, 1000);
+    U32 start = rdtsc_lo();
+    while (rdtsc_lo() - start < cycles) cpu_relax();
+}
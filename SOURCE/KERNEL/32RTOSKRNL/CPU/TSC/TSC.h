@@ -0,0 +1,44 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/CPU/TSC/TSC.h - Time stamp counter timing
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    RDTSC calibrated once at boot against PIT channel 2, for timing
+    operations far shorter than the 10 ms scheduler tick.
+
+    Take a start stamp with rdtsc_lo() (STD/ASM.h) and convert the cycle
+    delta with TSC_CYCLES_TO_NS / TSC_CYCLES_TO_US. The low 32 bits wrap
+    after about a second, so longer intervals belong to the PIT clocks.
+    User programs get the frequency via SYSCALL_TSC_KHZ (STD/TIME.h).
+
+REMARKS
+    Assumes an invariant TSC, which holds for anything newer than about
+    2008 and for QEMU/Bochs.
+---*/
+#ifndef TSC_H
+#define TSC_H
+
+#include <STD/TYPEDEF.h>
+
+#define TSC_CALIBRATE_MS 50
+
+/// Calibrates the TSC. Interrupts must be off, PIT channel 2 is borrowed.
+/// @return FALSE if the CPU has no TSC, the helpers then return 0.
+BOOLEAN TSC_INIT(VOID);
+
+/// @return Calibrated frequency in kHz, 0 if unavailable
+U32 TSC_GET_KHZ(VOID);
+
+U32 TSC_CYCLES_TO_NS(U32 cycles);
+U32 TSC_CYCLES_TO_US(U32 cycles);
+
+/// @brief Nanoseconds since `start`, a rdtsc_lo() stamp.
+U32 TSC_ELAPSED_NS(U32 start);
+
+/// @brief Busy-waits `us` microseconds. Falls back to PIT_WAIT_MS without a TSC.
+VOID TSC_DELAY_US(U32 us);
+
+#endif // TSC_H
@@ -1,11 +1,20 @@
 #include <DEBUG/KDEBUG.h>
 #include <STD/ASM.h>
+#include <DRIVERS/SERIAL/SERIAL.h>
 
 #define DBG_PORT 0xE9
 #define COM1_BASE 0x3F8
 
 static inline U8 com1_lsr(void) { return _inb(COM1_BASE + 5); }
-static inline void com1_out(U8 val) { _outb(COM1_BASE + 0, val); }
+static inline void com1_out(U8 val) {
+    // Once the serial driver owns COM1 the mirror goes through its TX ring
+    if (SERIAL_IS_BUFFERED(COM1_BASE)) {
+        SERIAL_WRITE_BYTE(COM1_BASE, val);
+        return;
+    }
+    while ((com1_lsr() & 0x20) == 0) { /* wait */ }
+    _outb(COM1_BASE + 0, val);
+}
 
 VOID KDEBUG_INIT(VOID) {
     // Initialize COM1: 115200 8N1, enable FIFO
@@ -20,8 +29,6 @@ VOID KDEBUG_INIT(VOID) {
 
 VOID KDEBUG_PUTC(U8 c) {
     _outb(DBG_PORT, c);
-    // Also write to COM1 if THR empty
-    while ((com1_lsr() & 0x20) == 0) { /* wait */ }
     com1_out(c);
 }
 
@@ -35,10 +42,8 @@ VOID KDEBUG_PUTS(const U8 *s) {
         // mirror to COM1
         U8 c = *(s-1);
         if (c == '\n') {
-            while ((com1_lsr() & 0x20) == 0) { }
             com1_out('\r');
         }
-        while ((com1_lsr() & 0x20) == 0) { }
         com1_out(c);
     }
 }
@@ -67,10 +72,8 @@ VOID KDEBUG_PUTSN(const U8 *s, U32 len) {
         // mirror to COM1
         U8 c = s[i];
         if (c == '\n') {
-            while ((com1_lsr() & 0x20) == 0) { }
             com1_out('\r');
         }
-        while ((com1_lsr() & 0x20) == 0) { }
         com1_out(c);
     }
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include <DEBUG/TRACE.h>
+#include <DEBUG/KDEBUG.h>
+#include <DRIVERS/SERIAL/SERIAL.h>
+#include <MEMORY/PAGEFRAME/PAGEFRAME.h>
+#include <CPU/PIT/PIT.h>
+#include <STD/MEM.h>
+#include <STD/ASM.h>
+
+#define TRACE_RING_PAGES ((TRACE_RING_ENTRIES * sizeof(TRACE_EVENT) + PAGE_SIZE - 1) / PAGE_SIZE)
+
+U32 trace_mask ATTRIB_DATA = TRACE_CLASS_DEFAULT;
+U32 trace_pid ATTRIB_DATA = 0;
+
+static TRACE_EVENT *ring ATTRIB_DATA = NULLPTR;
+static volatile U32 head ATTRIB_DATA = 0;     // total reservations, never wraps the index math
+static U32 base ATTRIB_DATA = 0;              // head at the last clear
+
+static U32 base_tsc_lo ATTRIB_DATA = 0;
+static U32 base_tsc_hi ATTRIB_DATA = 0;
+static U32 base_tick ATTRIB_DATA = 0;
+
+BOOLEAN TRACE_INIT(VOID) {
+    if (ring) return TRUE;
+    TRACE_EVENT *r = (TRACE_EVENT *)KREQUEST_PAGES(TRACE_RING_PAGES);
+    if (!r) return FALSE;
+    MEMZERO(r, TRACE_RING_PAGES * PAGE_SIZE);
+
+    rdtsc(&base_tsc_lo, &base_tsc_hi);
+    base_tick = *PIT_GET_TICKS_PTR();
+    head = base = 0;
+    ring = r;
+    return TRUE;
+}
+
+VOID TRACE_EMIT(U32 event, U32 a, U32 b, U32 c) {
+    if (!ring) return;
+
+    // The reservation is the only shared step; an IRQ that traces between
+    // here and the final store simply takes the next slot.
+    U32 idx = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+    TRACE_EVENT *e = &ring[idx & (TRACE_RING_ENTRIES - 1)];
+
+    e->event = TRACE_EV_NONE;
+    __asm__ volatile("" ::: "memory");
+    U32 lo, hi;
+    rdtsc(&lo, &hi);
+    e->tsc_lo = lo;
+    e->tsc_hi = hi;
+    e->pid = (U16)trace_pid;
+    e->a = a;
+    e->b = b;
+    e->c = c;
+    __asm__ volatile("" ::: "memory");
+    e->event = (U16)event;
+}
+
+U32 TRACE_SET_MASK(U32 mask) {
+    U32 old = trace_mask;
+    trace_mask = mask & TRACE_CLASS_ALL;
+    return old;
+}
+
+U32 TRACE_GET_MASK(VOID) {
+    return trace_mask;
+}
+
+VOID TRACE_CLEAR(VOID) {
+    U32 flags = irq_save();
+    base = head;
+    irq_restore(flags);
+}
+
+U32 TRACE_COUNT(VOID) {
+    U32 n = head - base;
+    return n > TRACE_RING_ENTRIES ? TRACE_RING_ENTRIES : n;
+}
+
+// Writes without overrunning the TX ring: while it is full the CPU halts
+// with interrupts on, so the THRE interrupt and other tasks keep running.
+static VOID dump_bytes(U16 port, const U8 *p, U32 n) {
+    while (n) {
+        U32 room = SERIAL_TX_FREE(port);
+        if (!room) {
+            ASM_VOLATILE("sti; hlt; cli" ::: "memory");
+            continue;
+        }
+        if (room > n) room = n;
+        SERIAL_WRITE_DATA(port, (PU8)p, room);
+        p += room;
+        n -= room;
+    }
+}
+
+U32 TRACE_DUMP(U16 port) {
+    if (!ring) return 0;
+    if (!port) port = TRACE_DUMP_PORT;
+
+    U32 flags = irq_save();
+    U32 saved_mask = trace_mask;
+    trace_mask = 0;
+
+    U32 total = head - base;
+    U32 count = total > TRACE_RING_ENTRIES ? TRACE_RING_ENTRIES : total;
+    U32 first = head - count;
+
+    TRACE_DUMP_HEADER hdr;
+    MEMZERO(&hdr, sizeof(hdr));
+    hdr.magic = TRACE_DUMP_MAGIC;
+    hdr.version = TRACE_DUMP_VERSION;
+    hdr.event_size = sizeof(TRACE_EVENT);
+    hdr.count = count;
+    hdr.lost = total - count;
+    hdr.mask = saved_mask;
+    hdr.tick_hz = PIT_TICKS_HZ;
+    hdr.base_tsc_lo = base_tsc_lo;
+    hdr.base_tsc_hi = base_tsc_hi;
+    hdr.base_tick = base_tick;
+    U32 lo, hi;
+    rdtsc(&lo, &hi);
+    hdr.now_tsc_lo = lo;
+    hdr.now_tsc_hi = hi;
+    hdr.now_tick = *PIT_GET_TICKS_PTR();
+
+    dump_bytes(port, (const U8 *)&hdr, sizeof(hdr));
+
+    U32 sum = 0;
+    for (U32 i = 0; i < count; i++) {
+        const U8 *e = (const U8 *)&ring[(first + i) & (TRACE_RING_ENTRIES - 1)];
+        for (U32 k = 0; k < sizeof(TRACE_EVENT); k++) sum += e[k];
+        dump_bytes(port, e, sizeof(TRACE_EVENT));
+    }
+    dump_bytes(port, (const U8 *)&sum, sizeof(sum));
+
+    trace_mask = saved_mask;
+    irq_restore(flags);
+
+    KDEBUG_STR_HEX_LN("[TRACE] Dumped events: 0x", count);
+    return count;
+}
@@ -0,0 +1,127 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/DEBUG/TRACE.h - Kernel event trace ring
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    A fixed-size binary ring of timestamped kernel events: context switches,
+    framebuffer flushes, syscall entry/exit, IRQ entry, disk submit/complete and KMALLOC/KFREE.
+    Recording an event is a mask test, one atomic slot reservation and a
+    24-byte store; nothing touches the serial port until the ring is dumped.
+    The oldest events are overwritten when the ring wraps.
+
+    Event classes are switched at runtime with TRACE_SET_MASK (SYSCALL_TRACE_CTL,
+    shell command `trace`). TRACE_DUMP streams the ring to a COM port in the
+    format below; TOOLS/TRACE decodes it into a timeline.
+
+REMARKS
+    Shared with user code and the host decoder via TRACE_ONLY_DEFINES.
+    Only append event ids and bump TRACE_DUMP_VERSION on format changes.
+---*/
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <STD/TYPEDEF.h>
+
+#define TRACE_RING_ENTRIES  4096        // Power of two
+#define TRACE_DUMP_MAGIC    0x52545441  // "ATTR"
+#define TRACE_DUMP_VERSION  1
+#define TRACE_DUMP_PORT     0x2F8       // COM2, COM1 carries the text log
+
+// Event id: class in the high nibble, event in the low one
+#define TRACE_CLASS_OF(ev)  (1u << ((ev) >> 4))
+
+#define TRACE_CLASS_SCHED   0x01
+#define TRACE_CLASS_SYSCALL 0x02
+#define TRACE_CLASS_IRQ     0x04
+#define TRACE_CLASS_DISK    0x08
+#define TRACE_CLASS_HEAP    0x10
+#define TRACE_CLASS_USER    0x20
+#define TRACE_CLASS_ALL     0x3F
+#define TRACE_CLASS_DEFAULT (TRACE_CLASS_SCHED | TRACE_CLASS_SYSCALL | TRACE_CLASS_IRQ | TRACE_CLASS_DISK)
+
+typedef enum {
+    TRACE_EV_NONE           = 0x00, // slot reserved but not written yet
+    TRACE_EV_SWITCH         = 0x01, // a = previous pid, b = next pid
+    TRACE_EV_FLUSH          = 0x02, // a = TSC cycles copying the focused framebuffer, b = bytes, c = its pid
+    TRACE_EV_SYSCALL_ENTER  = 0x10, // a = number, b = first argument
+    TRACE_EV_SYSCALL_EXIT   = 0x11, // a = number, b = return value
+    TRACE_EV_IRQ            = 0x20, // a = vector
+    TRACE_EV_DISK_SUBMIT    = 0x30, // a = lba, b = sectors, c = device | write << 8
+    TRACE_EV_DISK_COMPLETE  = 0x31, // a = lba, b = ok, c = ATA status
+    TRACE_EV_KMALLOC        = 0x40, // a = pointer, b = requested size
+    TRACE_EV_KFREE          = 0x41, // a = pointer, b = block size
+    TRACE_EV_MARK           = 0x50, // a, b, c = user values
+} TRACE_EVENT_ID;
+
+typedef struct {
+    U32 tsc_lo;
+    U32 tsc_hi;
+    U16 event;                  // TRACE_EVENT_ID
+    U16 pid;                    // running task
+    U32 a;
+    U32 b;
+    U32 c;
+} ATTRIB_PACKED TRACE_EVENT;
+
+/*
+ * Dump stream: TRACE_DUMP_HEADER, `count` TRACE_EVENTs oldest first, then
+ * a U32 sum of all event bytes. The two TSC/tick pairs let the decoder
+ * convert TSC cycles to time.
+ */
+typedef struct {
+    U32 magic;
+    U16 version;
+    U16 event_size;             // sizeof(TRACE_EVENT)
+    U32 count;
+    U32 lost;                   // overwritten by wrap-around
+    U32 mask;
+    U32 tick_hz;
+    U32 base_tsc_lo, base_tsc_hi;
+    U32 base_tick;
+    U32 now_tsc_lo, now_tsc_hi;
+    U32 now_tick;
+} ATTRIB_PACKED TRACE_DUMP_HEADER;
+
+// SYSCALL_TRACE_CTL operations
+typedef enum {
+    TRACE_OP_GET_MASK = 0,      // returns the mask
+    TRACE_OP_SET_MASK,          // a1 = mask, returns the previous mask
+    TRACE_OP_CLEAR,             // empties the ring
+    TRACE_OP_DUMP,              // a1 = COM port (0 = TRACE_DUMP_PORT), returns events written
+    TRACE_OP_COUNT,             // returns events currently held
+    TRACE_OP_MARK,              // a1..a3 recorded as TRACE_EV_MARK
+} TRACE_OP;
+
+#ifndef TRACE_ONLY_DEFINES
+
+extern U32 trace_mask;
+extern U32 trace_pid;
+
+BOOLEAN TRACE_INIT(VOID);
+VOID TRACE_EMIT(U32 event, U32 a, U32 b, U32 c);
+
+U32 TRACE_SET_MASK(U32 mask);
+U32 TRACE_GET_MASK(VOID);
+VOID TRACE_CLEAR(VOID);
+U32 TRACE_COUNT(VOID);
+/// @brief Streams the ring to `port`. Recording is paused meanwhile.
+/// @return Number of events written.
+U32 TRACE_DUMP(U16 port);
+
+/// @brief Records an event if its class is enabled. Costs one test when it is not.
+#define TRACE(ev, a, b, c) do { \
+    if (trace_mask & TRACE_CLASS_OF(ev)) TRACE_EMIT((ev), (U32)(a), (U32)(b), (U32)(c)); \
+} while (0)
+
+/// @brief Context switch hook: keeps the pid stamped on later events current.
+#define TRACE_SWITCH(prev, next) do { \
+    TRACE(TRACE_EV_SWITCH, (prev), (next), 0); \
+    trace_pid = (next); \
+} while (0)
+
+#endif // TRACE_ONLY_DEFINES
+
+#endif // TRACE_H
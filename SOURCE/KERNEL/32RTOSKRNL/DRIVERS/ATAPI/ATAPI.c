@@ -3,7 +3,28 @@
 #include "../../../../STD/ASM.h"
 
 #ifndef KERNEL_ENTRY
+#include <DRIVERS/ATA_PIIX3/ATA_PIIX3.h>
+#include <MEMORY/HEAP/KHEAP.h>
+#include <MEMORY/MEMORY.h>
+#include <STD/MEM.h>
+
 static U32 atapi_drive_info __attribute__((section(".data"))) = 0;
+
+/*
+DMA reads (PACKET with Features.DMA) go through the PIIX3 bus-master engine and
+complete on the channel IRQ. Each command moves at most one 64 KB PRDT span;
+kernel buffers below MEM_USER_SPACE_BASE are identity mapped and receive the
+data directly, anything else (user space, odd addresses) goes through a
+64 KB-aligned bounce buffer.
+*/
+#define ATAPI_DMA_MAX_SECTORS   32      // 64 KB per command
+#define ATAPI_DMA_PRDT_ENTRIES  2       // a 64 KB span crosses at most one 64 KB boundary
+#define ATAPI_DMA_BOUNCE_ALIGN  0x10000
+#define ATAPI_POLL_LIMIT        0xFFFFF
+
+static BOOL atapi_dma_capable __attribute__((section(".data"))) = FALSE;  // IDENTIFY PACKET word 49 bit 8
+static PRDT_ENTRY *atapi_prdt __attribute__((section(".data"))) = NULLPTR;
+static U8 *atapi_bounce __attribute__((section(".data"))) = NULLPTR;
 #endif // KERNEL_ENTRY
 
 // Check if ATAPI device exists on the given channel and drive (master/slave)
@@ -35,6 +56,9 @@ BOOLEAN atapi_cdrom_exists(U16 base_port, U8 drive) {
 
     // Word 0: device type info
     if ((ident[0] & 0xC000) == 0x8000) {
+#ifndef KERNEL_ENTRY
+        atapi_dma_capable = (ident[49] & (1 << 8)) != 0;
+#endif // KERNEL_ENTRY
         return TRUE; // ATAPI device (CD/DVD)
     }
 
@@ -66,6 +90,96 @@ U32 INITIALIZE_ATAPI() {
 U32 GET_ATAPI_INFO() {
     return atapi_drive_info;
 }
+
+// Allocates the PRDT and bounce buffer on first use (needs the kernel heap)
+static BOOL atapi_dma_setup(VOID) {
+    if (atapi_prdt) return TRUE;
+    if (!atapi_dma_capable) return FALSE;
+
+    atapi_prdt = KMALLOC_ALIGN(sizeof(PRDT_ENTRY) * ATAPI_DMA_PRDT_ENTRIES, ATA_PIIX3_PRDT_ALIGN);
+    atapi_bounce = KMALLOC_ALIGN(ATAPI_SECTORS(ATAPI_DMA_MAX_SECTORS), ATAPI_DMA_BOUNCE_ALIGN);
+    if (!atapi_prdt || !atapi_bounce) {
+        if (atapi_prdt) KFREE_ALIGN(atapi_prdt);
+        if (atapi_bounce) KFREE_ALIGN(atapi_bounce);
+        atapi_prdt = NULLPTR;
+        atapi_bounce = NULLPTR;
+        atapi_dma_capable = FALSE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Describes [phys, phys + bytes) in the PRDT, splitting at 64 KB boundaries
+static VOID atapi_fill_prdt(U32 phys, U32 bytes) {
+    U32 n = 0;
+    while (bytes) {
+        U32 room = 0x10000 - (phys & 0xFFFF);
+        U32 len = bytes < room ? bytes : room;
+        atapi_prdt[n].phys_addr  = phys;
+        atapi_prdt[n].byte_count = (U16)(len & 0xFFFF); // 0 == 64 KB
+        atapi_prdt[n].flags      = 0;
+        phys += len;
+        bytes -= len;
+        n++;
+    }
+    atapi_prdt[n - 1].flags = END_OF_TABLE_FLAG;
+}
+
+static BOOL atapi_wait_status(U16 port, U8 want) {
+    for (U32 i = 0; i < ATAPI_POLL_LIMIT; i++) {
+        U8 status = _inb(port + ATA_COMM_REG);
+        if (status & STAT_ERR) return FALSE;
+        if (!(status & STAT_BSY) && (status & want) == want) return TRUE;
+    }
+    return FALSE;
+}
+
+// One READ(12) of up to ATAPI_DMA_MAX_SECTORS sectors via the bus-master engine
+static BOOL read_cdrom_dma(U16 port, BOOLEAN slave, U32 lba, U32 sectors, U8 *buffer) {
+    U8 channel = (port == ATA_SECONDARY_BASE) ? ATA_PIIX3_CHANNEL_SECONDARY : ATA_PIIX3_CHANNEL_PRIMARY;
+    U32 bytes = ATAPI_SECTORS(sectors);
+    BOOL direct = ((U32)buffer & 1) == 0 && (U32)buffer + bytes <= MEM_USER_SPACE_BASE;
+    U8 *target = direct ? buffer : atapi_bounce;
+
+    U8 read_cmd[12] = {
+        ATAPI_CMD_READ12, 0,
+        (lba >> 24) & 0xFF, (lba >> 16) & 0xFF,
+        (lba >> 8) & 0xFF,  (lba >> 0) & 0xFF,
+        (sectors >> 24) & 0xFF, (sectors >> 16) & 0xFF,
+        (sectors >> 8) & 0xFF,  (sectors >> 0) & 0xFF,
+        0, 0
+    };
+
+    _outb(port + ATA_DRIVE_HEAD, 0xA0 | (slave << 4));
+    ata_io_wait(port);
+    if (!atapi_wait_status(port, 0)) return FALSE;
+
+    atapi_fill_prdt((U32)target, bytes);
+    ATA_PIIX3_BM_PREPARE(channel, atapi_prdt, FALSE);
+
+    _outb(port + ATA_CONTROL_REG, 0x00);        // Completion is signalled on INTRQ
+    _outb(port + ATA_ERR, ATAPI_FEATURE_DMA);   // Features: data phase by DMA
+    _outb(port + ATA_LBA_MID, ATAPI_SECTOR_SIZE & 0xFF);
+    _outb(port + ATA_LBA_HI, ATAPI_SECTOR_SIZE >> 8);
+    _outb(port + ATA_COMM_REG, ATAPI_CMD_SEND_PACKET);
+    ata_io_wait(port);
+
+    /* Only the 12-byte packet is moved by PIO */
+    if (!atapi_wait_status(port, STAT_DRQ)) return FALSE;
+    _outsw(port + ATA_DATA, (U16 *)read_cmd, 6);
+
+    ATA_PIIX3_BM_START(channel, FALSE);
+
+    U8 ata_status = 0;
+    if (!ATA_PIIX3_BM_WAIT(channel, &ata_status)) {
+        atapi_dma_capable = FALSE;  // engine timed out or faulted: stay on PIO
+        return FALSE;
+    }
+    if (ata_status & STAT_ERR) return FALSE;
+
+    if (!direct) MEMCPY(buffer, atapi_bounce, bytes);
+    return TRUE;
+}
 #endif // KERNEL_ENTRY
 
 
@@ -91,6 +205,22 @@ int read_cdrom(U32 atapiWhere, U32 lba, U32 sectors, U16 *buffer) {
             return ATA_FAILED;
     }
 
+#ifndef KERNEL_ENTRY
+    U8 channel = (port == ATA_SECONDARY_BASE) ? ATA_PIIX3_CHANNEL_SECONDARY : ATA_PIIX3_CHANNEL_PRIMARY;
+    if (ATA_PIIX3_BM_AVAILABLE(channel) && atapi_dma_setup()) {
+        U8 *out = (U8 *)buffer;
+        while (sectors && atapi_dma_capable) {
+            U32 count = sectors < ATAPI_DMA_MAX_SECTORS ? sectors : ATAPI_DMA_MAX_SECTORS;
+            if (!read_cdrom_dma(port, slave, lba, count, out)) break;
+            lba += count;
+            sectors -= count;
+            out += ATAPI_SECTORS(count);
+        }
+        if (!sectors) return ATA_SUCCESS;
+        buffer = (U16 *)out;    // Whatever DMA did not finish is read by PIO below
+    }
+#endif // KERNEL_ENTRY
+
     /* Prepare command */
     volatile U8 read_cmd[12] = {
         ATAPI_CMD_READ12, 0,
@@ -107,7 +237,7 @@ int read_cdrom(U32 atapiWhere, U32 lba, U32 sectors, U16 *buffer) {
     _outb(port + ATA_ERR, 0x00);
     _outb(port + ATA_LBA_MID, ATAPI_SECTOR_SIZE & 0xFF);
     _outb(port + ATA_LBA_HI, ATAPI_SECTOR_SIZE >> 8);
-    _outb(port + ATA_COMM_REG, 0xA0);
+    _outb(port + ATA_COMM_REG, ATAPI_CMD_SEND_PACKET);
     ata_io_wait(port);
 
     /* Wait for readiness */
@@ -161,5 +291,3 @@ U32 READ_CDROM(U32 atapiWhere, U32 lba, U32 sectors, U8 *buf) {
 U32 ATAPI_CALC_SECTORS(U32 len) {
     return (len + ATAPI_SECTOR_SIZE - 1) / ATAPI_SECTOR_SIZE;
 }
-#ifndef KERNEL_ENTRY
-#endif // KERNEL_ENTRY
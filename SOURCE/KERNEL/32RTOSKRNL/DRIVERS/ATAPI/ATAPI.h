@@ -8,6 +8,8 @@
 #define ATAPI_SLAVE   0xB0 // Slave drive
 
 
+#define ATAPI_FEATURE_DMA 0x01 // PACKET Features bit 0: data phase by DMA
+
 #define ATAPI_SECTOR_SIZE 2048
 #define ATAPI_SECTORS(num) (ATAPI_SECTOR_SIZE * (num))
 
@@ -63,6 +65,11 @@ REVISION HISTORY
 
 Remarks
     Buffer must be at least ATAPI_SECTOR_SIZE size in bytes
+    In the kernel image the data phase uses PIIX3 bus-master DMA when the drive
+    reports DMA support (IDENTIFY PACKET word 49) and the engine is available;
+    identity-mapped kernel buffers are filled directly, user-space buffers via
+    a bounce buffer. Before ATA_PIIX3_INIT, in KERNEL_ENTRY, or if the engine
+    fails, sectors are transferred by PIO.
 ---*/
 U32 READ_CDROM(U32 ATAPICheckRes, U32 lba, U32 sectors, U8 *buf);
 
@@ -6,6 +6,8 @@
 #include <STD/STRING.h>
 #include <DRIVERS/VESA/VBE.h>
 #include <CPU/PIC/PIC.h>
+#include <CPU/PIT/PIT.h>
+#include <DEBUG/TRACE.h>
 
 /*
 Add handler manually to IRQ handler tree
@@ -14,12 +16,6 @@ Get IRQ num from PCI
 
 #define POLLING_TIME 0xFFFFF
 
-typedef struct {
-    U32 phys_addr;
-    U16 byte_count;
-    U16 flags; // bit 15 = end-of-table
-} ATTRIB_PACKED PRDT_ENTRY;
-
 static PRDT_ENTRY* PRDT ATTRIB_DATA = NULL;
 static U8* DMA_BUFFER ATTRIB_DATA = NULL;
 static U32 BM_BASE_PRIMARY ATTRIB_DATA = 0;
@@ -39,10 +35,20 @@ typedef struct {
 
 static MDA_MODES supported_dma_modes ATTRIB_DATA = { 0, 0, 0, 0, 0 };
 
-static volatile BOOL dma_done ATTRIB_DATA = FALSE;
-static VOID* dma_target_buf ATTRIB_DATA = NULL;
-static U32 dma_bytes ATTRIB_DATA = 0;
-static U8 dma_write ATTRIB_DATA = FALSE;
+static BOOL bm_irq_hooked ATTRIB_DATA = FALSE;
+
+/* Per-channel completion state. `busy` is set by ATA_PIIX3_BM_START; the IRQ
+   handler (or the polling path of ATA_PIIX3_BM_WAIT) stops the engine, clears
+   it and records the final bus-master and device status. */
+static volatile BOOL bm_busy[2] ATTRIB_DATA = { FALSE, FALSE };
+static volatile BOOL bm_done[2] ATTRIB_DATA = { FALSE, FALSE };
+static volatile U8 bm_final_status[2] ATTRIB_DATA = { 0, 0 };
+static volatile U8 bm_ata_status[2] ATTRIB_DATA = { 0, 0 };
+
+#define BM_BASE(ch)  ((ch) ? BM_BASE_SECONDARY : BM_BASE_PRIMARY)
+#define BM_IS_IO(ch) ((ch) ? BM_SECONDARY_IS_IO : BM_PRIMARY_IS_IO)
+#define BM_PORT(ch)  ((ch) ? ATA_SECONDARY_BASE : ATA_PRIMARY_BASE)
+
 
 
 static BOOL ATA_PIIX3_LOCATE_BUS_MASTER(void) {
@@ -96,7 +102,7 @@ U32 ATA_GET_IDENTIFIER(VOID) {
     return IDENTIFIER;
 }
 
-// Initialize DMA (polling only)
+// Initialize DMA (completion via IRQ 14/15, see ATA_PIIX3_BM_WAIT)
 BOOLEAN ATA_PIIX3_INIT(VOID) {
     if (PRDT && DMA_BUFFER) return TRUE;
 
@@ -157,11 +163,87 @@ BOOLEAN ATA_PIIX3_INIT(VOID) {
     ISR_REGISTER_HANDLER(PIC_REMAP_OFFSET + 15, ATA_IRQ_HANDLER);
     PIC_Unmask(14);
     PIC_Unmask(15);
+    bm_irq_hooked = TRUE;
     return TRUE;
 }
 
+BOOLEAN ATA_PIIX3_BM_AVAILABLE(U8 channel) {
+    return bm_irq_hooked && BM_BASE(channel) != 0;
+}
+
+VOID ATA_PIIX3_BM_PREPARE(U8 channel, PRDT_ENTRY *prdt, BOOLEAN write) {
+    U32 bm_base = BM_BASE(channel);
+    BOOL is_io  = BM_IS_IO(channel);
+
+    bm_write32(bm_base, is_io, BM_PRDT_ADDR_OFFSET, (U32)prdt);
+    /* Clear stale IRQ and error bits (write-1-to-clear), then set direction */
+    bm_write8(bm_base, is_io, BM_STATUS_OFFSET,  BM_STATUS_ERROR | BM_STATUS_IRQ);
+    bm_write8(bm_base, is_io, BM_COMMAND_OFFSET, write ? BM_CMD_WRITE : BM_CMD_READ);
+}
+
+VOID ATA_PIIX3_BM_START(U8 channel, BOOLEAN write) {
+    bm_done[channel] = FALSE;
+    bm_busy[channel] = TRUE;
+    bm_write8(BM_BASE(channel), BM_IS_IO(channel), BM_COMMAND_OFFSET,
+              (write ? BM_CMD_WRITE : BM_CMD_READ) | BM_CMD_START_STOP);
+}
+
+BOOLEAN ATA_PIIX3_BM_WAIT(U8 channel, U8 *ata_status) {
+    U32 bm_base = BM_BASE(channel);
+    BOOL is_io  = BM_IS_IO(channel);
+
+    if (irq_enabled()) {
+        /* Sleep until the channel IRQ. The check runs with IF clear and
+         * "sti; hlt" only opens the interrupt window after hlt has started,
+         * so an IRQ landing between the check and the halt still wakes us.
+         * The PIT wakes us every tick, which bounds the wait and also covers
+         * a drive whose interrupt is masked (nIEN) by seeing the BM flag. */
+        volatile U32 *ticks = PIT_GET_TICKS_PTR();
+        U32 start = *ticks;
+        for (;;) {
+            CLI;
+            if (bm_done[channel] || *ticks - start > ATA_PIIX3_IRQ_TIMEOUT_TICKS) break;
+            if (bm_read8(bm_base, is_io, BM_STATUS_OFFSET) & (BM_STATUS_IRQ | BM_STATUS_ERROR)) break;
+            ASM_VOLATILE("sti; hlt");
+        }
+        STI;
+    } else {
+        /* -------------------------------------------------------------------
+         * Interrupts are off (syscall entered through an interrupt gate, or
+         * another ISR): the handler cannot run, so poll the Bus-Master Status
+         * register. BM_STATUS_IRQ is set by HARDWARE the moment the drive
+         * asserts its interrupt line, whether or not the PIC delivers it.
+         * ----------------------------------------------------------------- */
+        U32 timeout = POLLING_TIME * 10;
+        while (timeout > 0) {
+            U8 bm_st = bm_read8(bm_base, is_io, BM_STATUS_OFFSET);
+            if (bm_st & (BM_STATUS_IRQ | BM_STATUS_ERROR)) break;
+            cpu_relax();
+            timeout--;
+        }
+    }
+
+    /* Finish under CLI so a late IRQ cannot interleave with the cleanup */
+    U32 flags = irq_save();
+    if (!bm_done[channel]) {
+        U8 final_status = bm_read8(bm_base, is_io, BM_STATUS_OFFSET);
+        bm_write8(bm_base, is_io, BM_COMMAND_OFFSET, BM_STATUS_STOP);
+        bm_write8(bm_base, is_io, BM_STATUS_OFFSET, final_status | BM_STATUS_IRQ | BM_STATUS_ERROR);
+        /* Clear the ATA interrupt at the drive level */
+        bm_ata_status[channel]   = _inb(BM_PORT(channel) + ATA_COMM_REG);
+        bm_final_status[channel] = final_status;
+        bm_busy[channel] = FALSE;
+    }
+    U8 final_status = bm_final_status[channel];
+    U8 ata = bm_ata_status[channel];
+    irq_restore(flags);
+
+    if (ata_status) *ata_status = ata;
+    return (final_status & BM_STATUS_IRQ) && !(final_status & BM_STATUS_ERROR);
+}
+
 
-// Generic DMA sector read/write (BM-status polling — works with or without IRQs enabled)
+// Generic DMA sector read/write through the 64 KB bounce buffer (works with or without IRQs enabled)
 BOOLEAN ATA_PIIX3_XFER(U8 device, U32 lba, U8 sectors, VOIDPTR buf, BOOLEAN write) {
     if (!PRDT || !DMA_BUFFER) return FALSE;
 
@@ -170,28 +252,17 @@ BOOLEAN ATA_PIIX3_XFER(U8 device, U32 lba, U8 sectors, VOIDPTR buf, BOOLEAN writ
 
     BOOL is_secondary = (device == ATA_SECONDARY_MASTER || device == ATA_SECONDARY_SLAVE);
     BOOL is_slave     = (device == ATA_PRIMARY_SLAVE    || device == ATA_SECONDARY_SLAVE);
-    U16 base    = is_secondary ? ATA_SECONDARY_BASE    : ATA_PRIMARY_BASE;
-    U32 bm_base = is_secondary ? BM_BASE_SECONDARY     : BM_BASE_PRIMARY;
-    BOOL is_io  = is_secondary ? BM_SECONDARY_IS_IO    : BM_PRIMARY_IS_IO;
+    U8 channel  = is_secondary ? ATA_PIIX3_CHANNEL_SECONDARY : ATA_PIIX3_CHANNEL_PRIMARY;
+    U16 base    = BM_PORT(channel);
 
     // Setup PRDT + DMA buffer
-    MEMZERO(DMA_BUFFER, total_bytes);
     PRDT[0].phys_addr  = (U32)DMA_BUFFER;
     PRDT[0].byte_count = (U16)(total_bytes >= 0x10000 ? 0 : total_bytes); // 0 == 64 KB per PIIX3 spec
     PRDT[0].flags      = END_OF_TABLE_FLAG;
-    bm_write32(bm_base, is_io, BM_PRDT_ADDR_OFFSET, (U32)PRDT);
 
     if (write) MEMCPY(DMA_BUFFER, buf, total_bytes);
 
-    /* Keep globals in sync so the IRQ handler, if it fires, does the right thing */
-    dma_target_buf = buf;
-    dma_bytes      = total_bytes;
-    dma_write      = write;
-    dma_done       = FALSE;
-
-    /* Clear stale IRQ and error bits (write-1-to-clear), then set direction */
-    bm_write8(bm_base, is_io, BM_STATUS_OFFSET,  BM_STATUS_ERROR | BM_STATUS_IRQ);
-    bm_write8(bm_base, is_io, BM_COMMAND_OFFSET, write ? BM_CMD_WRITE : BM_CMD_READ);
+    ATA_PIIX3_BM_PREPARE(channel, PRDT, write);
 
     /* Program ATA registers (0xE0: fixed bits, bit6=LBA, bit4=slave select) */
     _outb(base + ATA_DRIVE_HEAD, 0xE0 | (is_slave ? 0x10 : 0x00) | ((lba >> 24) & 0x0F));
@@ -202,71 +273,15 @@ BOOLEAN ATA_PIIX3_XFER(U8 device, U32 lba, U8 sectors, VOIDPTR buf, BOOLEAN writ
     _outb(base + ATA_LBA_HI,  (U8)((lba >> 16) & 0xFF));
     _outb(base + ATA_COMM_REG, write ? ATA_MDA_CMD_WRITE28 : ATA_MDA_CMD_READ28);
 
-    /* Start DMA engine */
-    bm_write8(bm_base, is_io, BM_COMMAND_OFFSET,
-              (write ? BM_CMD_WRITE : BM_CMD_READ) | BM_CMD_START_STOP);
-
-    /* -----------------------------------------------------------------------
-     * Wait for completion by polling the Bus-Master Status register directly.
-     *
-     * Why polling instead of waiting on dma_done (set by IRQ handler):
-     *   The BM_STATUS_IRQ flag (bit 2) is set by HARDWARE the moment the IDE
-     *   drive asserts its interrupt line.  This happens regardless of whether
-     *   the CPU's IF flag is set and regardless of whether the PIC actually
-     *   delivers the interrupt.  Polling this bit is therefore safe in every
-     *   calling context:
-     *     - early boot (interrupts enabled, works as before)
-     *     - inside a syscall handler entered via an interrupt gate (IF=0, old
-     *       IRQ-driven wait would spin forever; polling still works)
-     *     - inside any other ISR
-     *
-     * If the IRQ handler fires first (IF is set) it will set dma_done and we
-     * break out on the dma_done check before we even read BM_STATUS; either
-     * path reaches the same cleanup code below.
-     * --------------------------------------------------------------------- */
-    U32 timeout = POLLING_TIME * 10;
-    BOOL completed = FALSE;
-    while (timeout > 0) {
-        /* Fast path: IRQ handler already ran (interrupts were enabled) */
-        if (dma_done) { completed = TRUE; break; }
-
-        /* Slow path: poll BM_STATUS for the hardware-set IRQ flag           */
-        U8 bm_st = bm_read8(bm_base, is_io, BM_STATUS_OFFSET);
-        if (bm_st & BM_STATUS_IRQ) {
-            /* Transfer complete — mirror what the IRQ handler would do */
-            completed = TRUE;
-            break;
-        }
-        if (bm_st & BM_STATUS_ERROR) {
-            /* DMA error flagged by hardware */
-            break;
-        }
-        cpu_relax();
-        timeout--;
-    }
-
-    /* Stop the DMA engine unconditionally */
-    bm_write8(bm_base, is_io, BM_COMMAND_OFFSET, BM_STATUS_STOP);
-
-    /* Re-read status, ack the IRQ flag and error bit (write-1-to-clear) */
-    U8 final_status = bm_read8(bm_base, is_io, BM_STATUS_OFFSET);
-    bm_write8(bm_base, is_io, BM_STATUS_OFFSET, final_status | BM_STATUS_IRQ | BM_STATUS_ERROR);
-
-    /* Clear the ATA interrupt at the drive level */
-    _inb(base + ATA_COMM_REG);
-
-    if (!completed || (final_status & BM_STATUS_ERROR))
-        return FALSE;
-
-    /* Copy result to caller's buffer if this was a read and the IRQ handler
-     * hasn't already done it (dma_done means the handler copied already). */
-    if (!write && !dma_done) {
-        MEMCPY(buf, DMA_BUFFER, total_bytes);
-    }
+    TRACE(TRACE_EV_DISK_SUBMIT, lba, sectors, device | (write ? 0x100 : 0));
+    ATA_PIIX3_BM_START(channel, write);
 
-    /* Signal to the IRQ handler (if it fires late) that we handled it */
-    dma_done = TRUE;
+    U8 ata_status = 0;
+    BOOLEAN ok = ATA_PIIX3_BM_WAIT(channel, &ata_status) && !(ata_status & STAT_ERR);
+    TRACE(TRACE_EV_DISK_COMPLETE, lba, ok, ata_status);
+    if (!ok) return FALSE;
 
+    if (!write) MEMCPY(buf, DMA_BUFFER, total_bytes);
     return TRUE;
 }
 
@@ -293,45 +308,31 @@ void ATA_IRQ_HANDLER(U32 vector, U32 errcode) {
     (void)errcode;
 
     // Determine primary/secondary channel
-    U32 bm_base = (vector == PIC_REMAP_OFFSET + 14) ? BM_BASE_PRIMARY : BM_BASE_SECONDARY;
-    BOOL is_io = (vector == PIC_REMAP_OFFSET + 14) ? BM_PRIMARY_IS_IO : BM_SECONDARY_IS_IO;
-    U16 base_port = (vector == PIC_REMAP_OFFSET + 14) ? ATA_PRIMARY_BASE : ATA_SECONDARY_BASE;
+    U8 channel = (vector == PIC_REMAP_OFFSET + 14) ? ATA_PIIX3_CHANNEL_PRIMARY : ATA_PIIX3_CHANNEL_SECONDARY;
+    U32 bm_base = BM_BASE(channel);
+    BOOL is_io  = BM_IS_IO(channel);
 
     // Read BM status
     U8 status = bm_read8(bm_base, is_io, BM_STATUS_OFFSET);
 
-    // Stop DMA engine
-    bm_write8(bm_base, is_io, BM_COMMAND_OFFSET, BM_STATUS_STOP);
+    // Only a transfer we started is completed here; anything else (PIO
+    // commands, a late IRQ after the polling path finished) is just acked.
+    BOOL finished = bm_busy[channel] && (status & (BM_STATUS_IRQ | BM_STATUS_ERROR));
+    if (finished) bm_write8(bm_base, is_io, BM_COMMAND_OFFSET, BM_STATUS_STOP);
 
     // Clear the interrupt and error bits in BM status (Write 1 to clear)
     bm_write8(bm_base, is_io, BM_STATUS_OFFSET, status | BM_STATUS_IRQ | BM_STATUS_ERROR);
 
     // Read the regular ATA status to clear the IRQ safely at the drive level
-    _inb(base_port + ATA_COMM_REG);
-
-    // If the polling path in ATA_PIIX3_XFER already completed the transfer
-    // (dma_done == TRUE), we only needed to acknowledge the IRQ above — skip
-    // the buffer copy and the error check to avoid double-copying or a false panic.
-    if (dma_done) {
-        // Ack IRQ (fall-through to EOI below)
-        goto ata_irq_ack;
-    }
-
-    // Check for errors
-    if (status & BM_STATUS_ERROR) {
-        panic("ATA DMA error", status);
-    }
+    U8 ata = _inb(BM_PORT(channel) + ATA_COMM_REG);
 
-    // Copy DMA buffer if reading
-    if (!dma_write && dma_target_buf) {
-        MEMCPY(dma_target_buf, DMA_BUFFER, dma_bytes);
+    if (finished) {
+        bm_final_status[channel] = status;
+        bm_ata_status[channel]   = ata;
+        bm_busy[channel] = FALSE;
+        bm_done[channel] = TRUE;
     }
 
-    // Signal completion
-    dma_done = TRUE;
-
-    ata_irq_ack:;
-
     // Ack IRQ
     pic_send_eoi(vector - PIC_REMAP_OFFSET);
 }
@@ -32,6 +32,20 @@
 #define BM_STATUS_IRQ    0x04  // bit set when device triggered IRQ; write-1 to clear
 #define BM_STATUS_ACK    0x06
 
+// Bus-master channels (IRQ 14 / IRQ 15)
+#define ATA_PIIX3_CHANNEL_PRIMARY   0
+#define ATA_PIIX3_CHANNEL_SECONDARY 1
+
+// Interrupt-driven waits give up after this many PIT ticks
+#define ATA_PIIX3_IRQ_TIMEOUT_TICKS 200
+
+// Physical Region Descriptor; a table must not cross a 64 KB boundary
+typedef struct {
+    U32 phys_addr;
+    U16 byte_count; // 0 == 64 KB
+    U16 flags;      // bit 15 = end-of-table
+} ATTRIB_PACKED PRDT_ENTRY;
+
 // Public API
 BOOLEAN ATA_PIIX3_INIT(VOID);
 
@@ -51,5 +65,29 @@ BOOLEAN ATA_PIIX3_WRITE_SECTORS_EXT(U8 device_id, U32 lba, U8 sector_count, VOID
 BOOLEAN ATA_PIIX3_READ_SECTORS(U32 lba, U8 sector_count, VOIDPTR out_buffer);
 BOOLEAN ATA_PIIX3_WRITE_SECTORS(U32 lba, U8 sector_count, VOIDPTR in_buffer);
 
+/*
+Bus-master engine, shared by the disk path above and the ATAPI driver.
+A transfer is: program the device's task file, ATA_PIIX3_BM_PREPARE,
+issue the command, ATA_PIIX3_BM_START, then ATA_PIIX3_BM_WAIT.
+*/
+
+/// @brief TRUE once ATA_PIIX3_INIT found the engine for `channel` and hooked its IRQ.
+BOOLEAN ATA_PIIX3_BM_AVAILABLE(U8 channel);
+
+/// @brief Loads the PRDT address, clears stale status and sets the direction.
+/// @param prdt Identity-mapped table, ATA_PIIX3_PRDT_ALIGN aligned.
+VOID ATA_PIIX3_BM_PREPARE(U8 channel, PRDT_ENTRY *prdt, BOOLEAN write);
+
+/// @brief Starts the engine; from here on the channel's IRQ completes the transfer.
+VOID ATA_PIIX3_BM_START(U8 channel, BOOLEAN write);
+
+/// @brief Waits for the transfer started by ATA_PIIX3_BM_START and stops the engine.
+/// With interrupts enabled the CPU halts until the channel IRQ arrives; with
+/// interrupts disabled (syscalls enter through interrupt gates) the bus-master
+/// status register is polled instead.
+/// @param ata_status Receives the device status read at completion (may be NULLPTR).
+/// @return TRUE if the engine reported completion without a DMA error.
+BOOLEAN ATA_PIIX3_BM_WAIT(U8 channel, U8 *ata_status);
+
 VOID ATA_IRQ_HANDLER(U32, U32);
 #endif // ATA_PIIX3_DRIVER_H
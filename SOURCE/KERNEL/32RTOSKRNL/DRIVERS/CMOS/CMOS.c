@@ -3,6 +3,7 @@
 #include <CPU/PIC/PIC.h>
 #include <STD/MEM.h>
 #include <STD/ASM.h>
+#include <CPU/PIT/PIT.h>
 
 #define RTC_REG_B_DM     0x04  // Data Mode (1=Binary, 0=BCD)
 #define RTC_REG_B_24H    0x02  // Hour Mode (1=24hr, 0=12hr)
@@ -17,8 +18,17 @@
 
 #define POLLING_TIME    0xFFFFF
 
+#define SECONDS_PER_DAY  86400
+
 static RTC_REG rtc ATTRIB_DATA = { 0 };
 
+// Wall clock: realtime = clock_base_epoch + (ticks - clock_base_tick) / HZ.
+// Only the RTC handler moves the base, once per RTC_RESYNC_SECONDS.
+static volatile U32 clock_base_epoch ATTRIB_DATA = 0;
+static volatile U32 clock_base_tick ATTRIB_DATA = 0;
+static volatile U32 clock_updates ATTRIB_DATA = 0;
+static volatile BOOLEAN clock_aligned ATTRIB_DATA = FALSE;
+
 static U8 cmos_read_register(U8 reg_addr) {
     // Write the address to port 0x70. Bit 7 is NMI disable (usually 0).
     _outb(CMOS_ADDR_REG, reg_addr);
@@ -103,11 +113,65 @@ BOOLEAN cmos_get_date_time(RTC_DATE_TIME* datetime) {
     return TRUE;
 }
 
+// Days since 1970-01-01 of a proleptic Gregorian date (year >= 1970)
+static U32 days_from_civil(U32 y, U32 m, U32 d) {
+    if (m <= 2) y--;
+    U32 era = y / 400;
+    U32 yoe = y - era * 400;
+    U32 doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    U32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static VOID civil_from_days(U32 days, RTC_DATE_TIME *dt) {
+    U32 z = days + 719468;
+    U32 era = z / 146097;
+    U32 doe = z - era * 146097;
+    U32 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    U32 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    U32 mp = (5 * doy + 2) / 153;
+    U32 d = doy - (153 * mp + 2) / 5 + 1;
+    U32 m = mp < 10 ? mp + 3 : mp - 9;
+    U32 y = yoe + era * 400 + (m <= 2);
+
+    dt->day_of_month = (U8)d;
+    dt->month = (U8)m;
+    dt->year = (U16)y;
+    dt->century = (U8)(y / 100);
+    dt->weekday = (U8)((days + 4) % 7 + 1); // 1970-01-01 was a Thursday
+}
+
+// Reads the RTC and rebases the wall clock on the current tick.
+// Callers hold interrupts off.
+static BOOLEAN clock_resync(VOID) {
+    RTC_DATE_TIME now;
+    if (!cmos_get_date_time(&now)) return FALSE;
+    MEMCPY(&rtc.t, &now, sizeof(RTC_DATE_TIME));
+
+    U32 year = now.year;
+    if (now.century == 0) year += 2000; // no century register
+    if (year < 1970 || now.month < 1 || now.month > 12 || now.day_of_month < 1) return FALSE;
+
+    clock_base_epoch = days_from_civil(year, now.month, now.day_of_month) * SECONDS_PER_DAY +
+                       now.hours * 3600 + now.minutes * 60 + now.seconds;
+    clock_base_tick = *PIT_GET_TICKS_PTR();
+    clock_updates = 0;
+    return TRUE;
+}
+
+// Update-ended interrupt, once per second. The first one after boot aligns
+// the sub-second phase of the clock to the RTC second boundary; after that
+// the RTC is only read again every RTC_RESYNC_SECONDS to correct PIT drift.
 VOID RTC_HANDLER(U32 vector, U32 errcode) {
-    cmos_get_date_time(&rtc.t);
+    U8 reg_c = cmos_read_register(RTC_REG_C);
+
+    if (reg_c & RTC_REG_C_UF) {
+        clock_updates++;
+        if (!clock_aligned || clock_updates >= RTC_RESYNC_SECONDS) {
+            if (clock_resync()) clock_aligned = TRUE;
+        }
+    }
 
-    cmos_read_register(RTC_REG_C);
-    
     pic_send_eoi(vector - PIC_REMAP_OFFSET);
 }
 
@@ -118,31 +182,59 @@ BOOLEAN INIT_RTC(VOID) {
     NMI_disable();
 
     U8 status_b = cmos_read_register(RTC_REG_B);
-    status_b |= (RTC_REG_B_24H | RTC_REG_B_DM | RTC_REG_B_PIE);
-    status_b &= ~(RTC_REG_B_SET | RTC_REG_B_UIE | RTC_REG_B_SQWE); // Ensure SET, UIE, SQWE are clear
+    status_b |= (RTC_REG_B_24H | RTC_REG_B_DM | RTC_REG_B_UIE);
+    status_b &= ~(RTC_REG_B_SET | RTC_REG_B_PIE | RTC_REG_B_SQWE); // Only the 1 Hz update-ended interrupt
     cmos_write_register(RTC_REG_B, status_b);
     rtc.reg_b = status_b;
-
-    U8 status_a = cmos_read_register(RTC_REG_A);
-    status_a = (status_a & (RTC_REG_A_UIP | 0xF0)) | 0x06; // Preserve UIP, other bits 4-7, set RS=0x06 (1024 Hz)
-    cmos_write_register(RTC_REG_A, status_a);
-    rtc.reg_a = status_a;
+    rtc.reg_a = cmos_read_register(RTC_REG_A);
 
     cmos_read_register(RTC_REG_C);
 
     NMI_enable();
-    
+
+    // Usable immediately; the first update-ended interrupt aligns it
+    clock_aligned = FALSE;
+    clock_resync();
+
     ISR_REGISTER_HANDLER(PIC_REMAP_OFFSET + 8, RTC_HANDLER);
     PIC_Unmask(8);
     STI;
     return TRUE;
 }
 
+U32 CLOCK_MONOTONIC_MS(VOID) {
+    return *PIT_GET_TICKS_PTR() * PIT_TICK_MS;
+}
+
+U32 CLOCK_REALTIME_S(U32 *ms) {
+    U32 flags = irq_save();
+    U32 elapsed = *PIT_GET_TICKS_PTR() - clock_base_tick;
+    U32 secs = clock_base_epoch + elapsed / PIT_TICKS_HZ;
+    irq_restore(flags);
+
+    if (ms) *ms = (elapsed % PIT_TICKS_HZ) * PIT_TICK_MS;
+    return secs;
+}
+
+U32 CLOCK_GET(U32 clock_id, U32 *ms) {
+    if (clock_id == CLOCK_REALTIME) return CLOCK_REALTIME_S(ms);
+
+    U32 now = CLOCK_MONOTONIC_MS();
+    if (ms) *ms = now % 1000;
+    return now / 1000;
+}
+
+VOID CLOCK_TO_DATE_TIME(U32 secs, RTC_DATE_TIME *dt) {
+    U32 tod = secs % SECONDS_PER_DAY;
+    MEMZERO(dt, sizeof(RTC_DATE_TIME));
+    civil_from_days(secs / SECONDS_PER_DAY, dt);
+    dt->hours = tod / 3600;
+    dt->minutes = (tod / 60) % 60;
+    dt->seconds = tod % 60;
+}
+
 RTC_DATE_TIME GET_SYS_TIME() {
     RTC_DATE_TIME retval;
-    CLI;
-    MEMCPY(&retval, &rtc.t, sizeof(RTC_DATE_TIME));
-    // cmos_get_date_time(&retval);
-    STI;
+    CLOCK_TO_DATE_TIME(CLOCK_REALTIME_S(NULLPTR), &retval);
     return retval;
-}
\ No newline at end of file
+}
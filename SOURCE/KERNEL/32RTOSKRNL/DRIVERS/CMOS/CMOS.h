@@ -14,6 +14,10 @@ typedef struct {
     U8 century; // +0x32, 19-20?
 } RTC_DATE_TIME;
 
+// Clock ids for CLOCK_GET / SYSCALL_GET_CLOCK
+#define CLOCK_MONOTONIC 0 // time since boot, never steps
+#define CLOCK_REALTIME  1 // seconds since 1970-01-01 00:00:00, RTC local time
+
 #ifndef CMOS_ONLY_DEFINES
 typedef struct {
     RTC_DATE_TIME t; // 0x0-0x9
@@ -31,10 +35,27 @@ typedef struct {
 #define RTC_REG_C       0x0C
 #define RTC_REG_CENTURY 0x32
 
+#define RTC_REG_C_UF    0x10  // Update-ended interrupt flag
+
+#define RTC_RESYNC_SECONDS 64 // RTC reads between PIT-driven seconds
+
 BOOLEAN INIT_RTC(VOID);
 
+/// Current date and time, derived from the PIT tick. Does not touch the RTC.
 RTC_DATE_TIME GET_SYS_TIME();
 
+/// Milliseconds since boot, at PIT_TICK_MS resolution.
+U32 CLOCK_MONOTONIC_MS(VOID);
+
+/// Seconds since the epoch; the sub-second part goes to `ms` if not NULL.
+U32 CLOCK_REALTIME_S(U32 *ms);
+
+/// Breaks CLOCK_REALTIME seconds down into a date and time.
+VOID CLOCK_TO_DATE_TIME(U32 secs, RTC_DATE_TIME *dt);
+
+/// Seconds of `clock_id` (CLOCK_MONOTONIC or CLOCK_REALTIME) plus milliseconds in `ms`.
+U32 CLOCK_GET(U32 clock_id, U32 *ms);
+
 
 #endif // CMOS_ONLY_DEFINES
 #endif // CMOS_DRIVER_H
\ No newline at end of file
@@ -1,12 +1,77 @@
 #include <SERIAL/SERIAL.h>
 #include <DRIVER_INC.h>
 #include <DEBUG/KDEBUG.h>
+#include <CPU/PIT/PIT.h>
 
 #define COM1_PORT 0x3F8
 #define COM2_PORT 0x2F8
 #define COM3_PORT 0x3E8
 #define COM4_PORT 0x2E8
 
+// Register offsets
+#define UART_DATA    0
+#define UART_IER     1
+#define UART_IIR     2   // read
+#define UART_FCR     2   // write
+#define UART_LCR     3
+#define UART_MCR     4
+#define UART_LSR     5
+#define UART_MSR     6
+#define UART_SCRATCH 7
+
+#define UART_IER_RDA      0x01  // Received data available
+#define UART_IER_THRE     0x02  // Transmitter holding register empty
+#define UART_IER_RLS      0x04  // Receiver line status
+
+#define UART_IIR_NONE     0x01  // No interrupt pending
+#define UART_IIR_ID_MASK  0x0E
+#define UART_IIR_MSR      0x00
+#define UART_IIR_THRE     0x02
+#define UART_IIR_RDA      0x04
+#define UART_IIR_RLS      0x06
+#define UART_IIR_TIMEOUT  0x0C  // FIFO character timeout
+
+#define UART_LSR_DR       0x01  // Data ready
+#define UART_LSR_THRE     0x20  // THR / TX FIFO empty
+
+#define UART_FIFO_DEPTH   16
+#define SERIAL_POLL_LIMIT 1000000
+
+#define SERIAL_PORT_COUNT 4
+
+typedef struct {
+    U16 base;
+    U8  irq;
+    BOOLEAN irq_mode;   // FALSE: polled, as before SERIAL_IRQ_INIT or when the UART is missing
+    U8  ier;
+
+    volatile U32 tx_head, tx_tail;
+    volatile U32 rx_head, rx_tail;
+    U32 rx_dropped;
+
+    U8 tx[SERIAL_TX_RING_SIZE];
+    U8 rx[SERIAL_RX_RING_SIZE];
+} SERIAL_PORT_STATE;
+
+// COM1/COM3 share IRQ4, COM2/COM4 share IRQ3
+static SERIAL_PORT_STATE ports[SERIAL_PORT_COUNT] ATTRIB_DATA = {
+    { .base = COM1_PORT, .irq = 4 },
+    { .base = COM2_PORT, .irq = 3 },
+    { .base = COM3_PORT, .irq = 4 },
+    { .base = COM4_PORT, .irq = 3 },
+};
+
+#define TX_COUNT(p)   ((p)->tx_head - (p)->tx_tail)
+#define RX_COUNT(p)   ((p)->rx_head - (p)->rx_tail)
+#define TX_FULL(p)    (TX_COUNT(p) == SERIAL_TX_RING_SIZE)
+#define RX_FULL(p)    (RX_COUNT(p) == SERIAL_RX_RING_SIZE)
+
+static SERIAL_PORT_STATE *port_state(U16 port) {
+    for (U32 i = 0; i < SERIAL_PORT_COUNT; i++)
+        if (ports[i].base == port) return &ports[i];
+    return NULLPTR;
+}
+
 VOID SERIAL_PORT_INIT(U16 port) {
     _outb(port + 1, 0x00);    // Disable interrupts
     _outb(port + 3, 0x80);    // Enable DLAB
@@ -32,16 +97,143 @@ I32 IS_SERIAL_TRANSIT_EMPTY(U16 port) {
     return _inb(port + 5) & 0x20;
 }
 
-VOID SERIAL_WRITE_BYTE(U16 port, U8 data) {
+// Moves up to one FIFO worth of queued bytes into the UART. Caller holds
+// interrupts off and has seen THRE (or is the THRE interrupt).
+static VOID tx_fill(SERIAL_PORT_STATE *p) {
+    for (U32 n = 0; n < UART_FIFO_DEPTH && TX_COUNT(p); n++) {
+        _outb(p->base + UART_DATA, p->tx[p->tx_tail & (SERIAL_TX_RING_SIZE - 1)]);
+        p->tx_tail++;
+    }
+    if (p->irq_mode) {
+        U8 ier = TX_COUNT(p) ? (p->ier | UART_IER_THRE) : (p->ier & ~UART_IER_THRE);
+        if (ier != p->ier) {
+            p->ier = ier;
+            _outb(p->base + UART_IER, ier);
+        }
+    }
+}
+
+static VOID rx_pull(SERIAL_PORT_STATE *p) {
+    while (_inb(p->base + UART_LSR) & UART_LSR_DR) {
+        U8 c = _inb(p->base + UART_DATA);
+        if (RX_FULL(p)) { p->rx_dropped++; continue; }
+        p->rx[p->rx_head & (SERIAL_RX_RING_SIZE - 1)] = c;
+        p->rx_head++;
+    }
+}
+
+// Pushes queued bytes out by polling. Used when the ring is full and when
+// interrupts will not come back (panic).
+static BOOLEAN tx_drain_polled(SERIAL_PORT_STATE *p, U32 keep) {
     U32 poll = 0;
-    while(!IS_SERIAL_TRANSIT_EMPTY(port) && poll < 1000000) {
-        poll++;
+    while (TX_COUNT(p) > keep) {
+        if (_inb(p->base + UART_LSR) & UART_LSR_THRE) {
+            tx_fill(p);
+            poll = 0;
+        } else if (++poll >= SERIAL_POLL_LIMIT) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static VOID SERIAL_IRQ_HANDLER(I32 vector, U32 errcode) {
+    (void)errcode;
+    U8 irq = (U8)(vector - PIC_REMAP_OFFSET);
+
+    for (U32 i = 0; i < SERIAL_PORT_COUNT; i++) {
+        SERIAL_PORT_STATE *p = &ports[i];
+        if (!p->irq_mode || p->irq != irq) continue;
+
+        for (U32 guard = 0; guard < UART_FIFO_DEPTH; guard++) {
+            U8 iir = _inb(p->base + UART_IIR);
+            if (iir & UART_IIR_NONE) break;
+            switch (iir & UART_IIR_ID_MASK) {
+                case UART_IIR_RDA:
+                case UART_IIR_TIMEOUT:
+                    rx_pull(p);
+                    break;
+                case UART_IIR_THRE:
+                    tx_fill(p);
+                    break;
+                case UART_IIR_RLS:
+                    _inb(p->base + UART_LSR);
+                    break;
+                default:
+                    _inb(p->base + UART_MSR);
+                    break;
+            }
+        }
+    }
+
+    pic_send_eoi(irq);
+}
+
+VOID SERIAL_IRQ_INIT(VOID) {
+    U32 flags = irq_save();
+    BOOLEAN irq3 = FALSE, irq4 = FALSE;
+
+    for (U32 i = 0; i < SERIAL_PORT_COUNT; i++) {
+        SERIAL_PORT_STATE *p = &ports[i];
+
+        // Scratch register round trip: a missing UART reads back 0xFF
+        _outb(p->base + UART_SCRATCH, 0xA5);
+        if (_inb(p->base + UART_SCRATCH) != 0xA5) continue;
+
+        tx_drain_polled(p, 0);
+        _outb(p->base + UART_FCR, 0xC7);  // Enable and clear FIFOs, 14-byte RX trigger
+        _outb(p->base + UART_MCR, 0x0B);  // DTR, RTS, OUT2 (IRQ line enable)
+        p->irq_mode = TRUE;
+        p->ier = UART_IER_RDA | UART_IER_RLS;
+        _outb(p->base + UART_IER, p->ier);
+        rx_pull(p);
+        _inb(p->base + UART_IIR);
+
+        if (p->irq == 3) irq3 = TRUE;
+        else irq4 = TRUE;
+    }
+
+    if (irq4) {
+        ISR_REGISTER_HANDLER(PIC_REMAP_OFFSET + 4, SERIAL_IRQ_HANDLER);
+        PIC_Unmask(4);
+    }
+    if (irq3) {
+        ISR_REGISTER_HANDLER(PIC_REMAP_OFFSET + 3, SERIAL_IRQ_HANDLER);
+        PIC_Unmask(3);
+    }
+    irq_restore(flags);
+}
+
+VOID SERIAL_WRITE_BYTE(U16 port, U8 data) {
+    SERIAL_PORT_STATE *p = port_state(port);
+    if (!p || !p->irq_mode) {
+        U32 poll = 0;
+        while(!IS_SERIAL_TRANSIT_EMPTY(port) && poll < SERIAL_POLL_LIMIT) {
+            poll++;
+        }
+        if(poll == SERIAL_POLL_LIMIT) {
+            KDEBUG_STR_HEX_LN("[SERIAL] Warning: Serial port 0x", port);
+            KDEBUG_PUTS(" is not responding. Data may be lost.\n");
+        }
+        _outb(port, data);
+        return;
+    }
+
+    U32 flags = irq_save();
+    // Ring full: make room by hand. Waiting for the THRE interrupt could
+    // deadlock, since writers also run with interrupts off.
+    if (TX_FULL(p) && !tx_drain_polled(p, SERIAL_TX_RING_SIZE - 1)) {
+        irq_restore(flags);
+        return; // UART stopped transmitting, drop the byte
     }
-    if(poll == 1000000) {
-        KDEBUG_STR_HEX_LN("[SERIAL] Warning: Serial port 0x", port);
-        KDEBUG_PUTS(" is not responding. Data may be lost.\n");
+    p->tx[p->tx_head & (SERIAL_TX_RING_SIZE - 1)] = data;
+    p->tx_head++;
+
+    // Idle transmitter: prime the FIFO, the THRE interrupt does the rest
+    if (!(p->ier & UART_IER_THRE) && (_inb(p->base + UART_LSR) & UART_LSR_THRE)) {
+        tx_fill(p);
     }
-    _outb(port, data);
+    irq_restore(flags);
 }
 
 VOID SERIAL_WRITE_DATA(U16 port, PU8 data, U32 len) {
@@ -50,11 +242,63 @@ VOID SERIAL_WRITE_DATA(U16 port, PU8 data, U32 len) {
     }
 }
 
+VOID SERIAL_FLUSH(U16 port) {
+    SERIAL_PORT_STATE *p = port_state(port);
+    if (!p || !p->irq_mode) return;
+    U32 flags = irq_save();
+    tx_drain_polled(p, 0);
+    irq_restore(flags);
+}
+
+BOOLEAN SERIAL_IS_BUFFERED(U16 port) {
+    SERIAL_PORT_STATE *p = port_state(port);
+    return p && p->irq_mode;
+}
+
+U32 SERIAL_TX_FREE(U16 port) {
+    SERIAL_PORT_STATE *p = port_state(port);
+    if (!p || !p->irq_mode) return U32_MAX;
+    return SERIAL_TX_RING_SIZE - TX_COUNT(p);
+}
+
+U32 SERIAL_RX_AVAILABLE(U16 port) {
+    SERIAL_PORT_STATE *p = port_state(port);
+    if (!p || !p->irq_mode) return (_inb(port + 5) & 0x01) ? 1 : 0;
+    return RX_COUNT(p);
+}
+
+// Waits until the RX ring has data, at most `timeout_ticks` PIT ticks (0 = forever).
+// Called with interrupts off; they are enabled only while halted, so the
+// wait also works from syscalls and lets the scheduler run other tasks.
+static BOOLEAN rx_wait(SERIAL_PORT_STATE *p, U32 timeout_ticks) {
+    volatile U32 *ticks = PIT_GET_TICKS_PTR();
+    U32 start = *ticks;
+    while (!RX_COUNT(p)) {
+        if (timeout_ticks && *ticks - start >= timeout_ticks) return FALSE;
+        ASM_VOLATILE("sti; hlt; cli" ::: "memory");
+    }
+    return TRUE;
+}
+
+static U8 rx_pop(SERIAL_PORT_STATE *p) {
+    U8 c = p->rx[p->rx_tail & (SERIAL_RX_RING_SIZE - 1)];
+    p->rx_tail++;
+    return c;
+}
 
 VOID SERIAL_READ_BYTE(U16 port, PU8 data) {
-    // Wait for Data Ready (bit 0 of LSR)
-    while (!(_inb(port + 5) & 0x01));
-    *data = _inb(port); // Read from Receiver Buffer Register
+    SERIAL_PORT_STATE *p = port_state(port);
+    if (!p || !p->irq_mode) {
+        // Wait for Data Ready (bit 0 of LSR)
+        while (!(_inb(port + 5) & 0x01));
+        *data = _inb(port); // Read from Receiver Buffer Register
+        return;
+    }
+
+    U32 flags = irq_save();
+    rx_wait(p, 0);
+    *data = rx_pop(p);
+    irq_restore(flags);
 }
 
 VOID SERIAL_READ_STRING(U16 port, PU8 buffer, U32 max_len) {
@@ -78,6 +322,27 @@ VOID SERIAL_READ_BUFFER(U16 port, PU8 buffer, U32 max_len) {
     }
 }
 
+// Next received byte, waiting at most `timeout_ticks` (interrupt mode) or
+// `idle_polls` LSR reads (polled mode).
+static BOOLEAN read_byte_timeout(U16 port, PU8 data, U32 timeout_ticks, U32 idle_polls) {
+    SERIAL_PORT_STATE *p = port_state(port);
+    if (!p || !p->irq_mode) {
+        for (U32 idle = 0; idle < idle_polls; idle++) {
+            if (_inb(port + 5) & 0x01) {
+                *data = _inb(port);
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+
+    U32 flags = irq_save();
+    BOOLEAN ok = timeout_ticks ? rx_wait(p, timeout_ticks) : RX_COUNT(p) != 0;
+    if (ok) *data = rx_pop(p);
+    irq_restore(flags);
+    return ok;
+}
+
 PU8 SERIAL_READ_WHOLE_BUFFER_HEAP(U16 port, U32* out_len)
 {
     U32 capacity = 64;
@@ -89,28 +354,19 @@ PU8 SERIAL_READ_WHOLE_BUFFER_HEAP(U16 port, U32* out_len)
         return NULL;
     }
 
-    U32 idle = 0;
     const U32 IDLE_LIMIT = 200000; // tuning value
+    U8 c;
 
-    while (idle < IDLE_LIMIT)
+    while (read_byte_timeout(port, &c, SERIAL_IDLE_TICKS, IDLE_LIMIT))
     {
-        if (_inb(port + 5) & 0x01) // data ready
-        {
-            idle = 0; // reset timeout
-
-            if (length >= capacity) {
-                PU8 tmp = KREALLOC(buffer, capacity * 2);
-                if (!tmp) break;
-                buffer = tmp;
-                capacity *= 2;
-            }
-
-            buffer[length++] = _inb(port);
-        }
-        else
-        {
-            idle++;
+        if (length >= capacity) {
+            PU8 tmp = KREALLOC(buffer, capacity * 2);
+            if (!tmp) break;
+            buffer = tmp;
+            capacity *= 2;
         }
+
+        buffer[length++] = c;
     }
 
     if (out_len) *out_len = length;
@@ -126,17 +382,18 @@ PU8 SERIAL_READ_WHOLE_STRING_HEAP(U16 port, U32* out_len) {
         return NULL;
     }
 
-    while (_inb(port + 5) & 0x01) {
+    U8 c;
+    while (read_byte_timeout(port, &c, 0, 1)) {
         if (length >= capacity - 1) { // leave space for null
             PU8 tmp = (PU8) KREALLOC(buffer, capacity * 2);
             if (!tmp) break;
             buffer = tmp;
             capacity *= 2;
         }
-        buffer[length++] = _inb(port);
+        buffer[length++] = c;
     }
 
     buffer[length] = 0; // Null-terminate
     if (out_len) *out_len = length;
     return buffer;
-}
\ No newline at end of file
+}
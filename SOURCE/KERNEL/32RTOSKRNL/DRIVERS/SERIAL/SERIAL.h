@@ -9,9 +9,31 @@
 
 #ifdef __RTOS__
 
+/*+++
+    Before SERIAL_IRQ_INIT the ports are polled, so early boot and panic
+    output works without interrupts. Afterwards every present 16550 runs
+    with FIFOs enabled and RDA/THRE interrupts (COM1/COM3 on IRQ4,
+    COM2/COM4 on IRQ3): writers enqueue into a per-port TX ring and return,
+    readers sleep (sti; hlt) until the RX ring has data.
+---*/
+#define SERIAL_TX_RING_SIZE 2048    // Power of two
+#define SERIAL_RX_RING_SIZE 1024    // Power of two
+#define SERIAL_IDLE_TICKS   10      // READ_WHOLE_BUFFER_HEAP gives up after this much silence
+
 VOID SERIAL_INIT();
+/// @brief Switches present ports to interrupt mode. Call after the PIC and PIT are set up.
+VOID SERIAL_IRQ_INIT(VOID);
 I32 IS_SERIAL_TRANSIT_EMPTY(U16 port);
 
+/// @brief Pushes all queued TX bytes out by polling. Safe with interrupts off (panic paths).
+VOID SERIAL_FLUSH(U16 port);
+/// @brief TRUE once the port runs from its rings (after SERIAL_IRQ_INIT).
+BOOLEAN SERIAL_IS_BUFFERED(U16 port);
+/// @brief Bytes SERIAL_WRITE_DATA can queue without draining by hand. U32_MAX for polled ports.
+U32 SERIAL_TX_FREE(U16 port);
+/// @brief Number of received bytes waiting in the RX ring.
+U32 SERIAL_RX_AVAILABLE(U16 port);
+
 VOID SERIAL_WRITE_BYTE(U16 port, U8 data);
 VOID SERIAL_WRITE_DATA(U16 port, PU8 data, U32 len);
 
@@ -48,6 +48,12 @@ VOIDPTR __memcpy_safe_chunks(VOIDPTR dest, const VOIDPTR src, U32 n) {
 #include <PROC/PROC.h>
 #include <STD/ASM.h>
 #include <DEBUG/KDEBUG.h>
+#include <DEBUG/TRACE.h>
+#include <DRIVERS/VESA/VBE_TEXT.h>
+#include <CPU/PAT/PAT.h>
+#include <CPU/TSC/TSC.h>
+#include <MEMORY/PAGING/PAGING.h>
+#include <STD/STRING.h>
 static VOIDPTR focused_task_framebuffer ATTRIB_DATA = FRAMEBUFFER_ADDRESS;
 static VOIDPTR current_frambuffer ATTRIB_DATA = FRAMEBUFFER_ADDRESS;
 static BOOLEAN early_mode = TRUE;
@@ -72,27 +78,104 @@ static inline void *__memcpy_fast(void *dest, const void *src, U32 n) {
     return dest;
 }
 
-void flush_focused_framebuffer() {
-    VBE_MODEINFO* mode = GET_VBE_MODE();
-    if (!mode) return;
-    
-    U32 copy_size = mode->BytesPerScanLineLinear * mode->YResolution;
-    if (copy_size == 0) return;
-    if (copy_size > FRAMEBUFFER_SIZE) copy_size = FRAMEBUFFER_SIZE;
+// Bochs/QEMU DISPI registers, for moving the display start
+#define DISPI_INDEX_PORT    0x01CE
+#define DISPI_DATA_PORT     0x01CF
+#define DISPI_ID            0x00
+#define DISPI_XRES          0x01
+#define DISPI_YRES          0x02
+#define DISPI_BPP           0x03
+#define DISPI_VIRT_WIDTH    0x06
+#define DISPI_VIRT_HEIGHT   0x07
+#define DISPI_X_OFFSET      0x08
+#define DISPI_Y_OFFSET      0x09
+#define DISPI_ID_OFFSETS    0xB0C1  // first version with the virtual screen
+#define DISPI_ID_LAST       0xB0C5
+
+static BOOLEAN flip_enabled ATTRIB_DATA = FALSE;
+static U32 flip_shown ATTRIB_DATA = 0;          // page on screen, 0 or 1
+static volatile BOOLEAN presenting ATTRIB_DATA = FALSE;
+
+static U16 dispi_read(U16 index) {
+    _outw(DISPI_INDEX_PORT, index);
+    return _inw(DISPI_DATA_PORT);
+}
 
-    if (early_mode) {
-        // If early mode uses identity mapping or kernel mapping, use that:
-        void *src_kv = (void*)FRAMEBUFFER_ADDRESS;    // kernel-mapped early buffer
-        void *dst_kv = (void*)(mode->PhysBasePtr);    // treat as kernel-virt in kernel CR3
-        // If mode->PhysBasePtr is physical, the kernel page table must map it to the same VA.
-        __memcpy_fast(dst_kv, src_kv, copy_size);
+static VOID dispi_write(U16 index, U16 value) {
+    _outw(DISPI_INDEX_PORT, index);
+    _outw(DISPI_DATA_PORT, value);
+}
+
+U32 VBE_LFB_SIZE(VOID) {
+    VBE_MODEINFO *mode = GET_VBE_MODE();
+    U32 screen = mode->YResolution * mode->BytesPerScanLine;
+    U32 vram = GET_VESA_INFO()->TotalMemory * 0x10000;
+    return vram >= 2 * screen ? 2 * screen : screen;
+}
+
+BOOLEAN VBE_PAGE_FLIP_INIT(VOID) {
+    VBE_MODEINFO *mode = GET_VBE_MODE();
+    U32 pitch = mode->BytesPerScanLineLinear;
+    U16 id = dispi_read(DISPI_ID);
+    if (id < DISPI_ID_OFFSETS || id > DISPI_ID_LAST) {
+        KDEBUG_PUTS("[VBE] No DISPI display start, presenting by copy\n");
+        return FALSE;
+    }
+    // DISPI must be what drives the mode the BIOS set
+    if (dispi_read(DISPI_XRES) != mode->XResolution || dispi_read(DISPI_YRES) != mode->YResolution ||
+        dispi_read(DISPI_BPP) != mode->BitsPerPixel) return FALSE;
+
+    // Writing the virtual width makes the adapter recompute the virtual
+    // height from video memory
+    dispi_write(DISPI_VIRT_WIDTH, mode->XResolution);
+    U32 virt_height = dispi_read(DISPI_VIRT_HEIGHT);
+    if ((U32)dispi_read(DISPI_VIRT_WIDTH) * ((mode->BitsPerPixel + 7) / 8) != pitch ||
+        virt_height < 2u * mode->YResolution || VBE_LFB_SIZE() < 2 * mode->YResolution * pitch) {
+        KDEBUG_STR_HEX_LN("[VBE] Virtual screen too small to flip, height ", virt_height);
+        return FALSE;
+    }
+    dispi_write(DISPI_X_OFFSET, 0);
+    dispi_write(DISPI_Y_OFFSET, 0);
+    flip_shown = 0;
+    flip_enabled = TRUE;
+    KDEBUG_STR_HEX_LN("[VBE] Page flipping through DISPI, virtual height ", virt_height);
+    return TRUE;
+}
+
+BOOLEAN VBE_PAGE_FLIP_ENABLED(VOID) {
+    return flip_enabled;
+}
+
+// Puts a finished frame on screen. With page flipping it is copied to the
+// page not on screen, which is then shown whole; otherwise straight over
+// the visible one. A present that interrupts another is dropped, the next
+// refresh catches up.
+static VOID present(VBE_MODEINFO *mode, const void *src, U32 bytes) {
+    if (!flip_enabled) {
+        __memcpy_fast((void *)mode->PhysBasePtr, src, bytes);
         return;
     }
+    if (presenting) return;
+    presenting = TRUE;
+    U32 page = flip_shown ^ 1;
+    __memcpy_fast((void *)(mode->PhysBasePtr + page * mode->YResolution * mode->BytesPerScanLineLinear), src, bytes);
+    dispi_write(DISPI_Y_OFFSET, page * mode->YResolution);
+    flip_shown = page;
+    presenting = FALSE;
+}
+
+// Framebuffer of the focused task as seen from the current address space,
+// NULL when there is nothing to show
+static U8 *flush_source(VOID) {
+    if (early_mode) {
+        // Early mode draws into the kernel-mapped buffer; the LFB is identity mapped
+        return (U8 *)FRAMEBUFFER_ADDRESS;
+    }
 
     TCB *focused = get_focused_task();
     if (!focused || !focused->framebuffer_mapped) {
         focused_task_framebuffer = NULL;
-        return;
+        return NULL;
     }
 
     if(get_current_tcb()->info.pid == get_master_tcb()->info.pid)
@@ -100,9 +183,57 @@ void flush_focused_framebuffer() {
     else if(focused->info.pid == get_current_tcb()->info.pid) 
         focused_task_framebuffer = focused->framebuffer_virt;
     else focused_task_framebuffer = NULLPTR;
+    return (U8 *)focused_task_framebuffer;
+}
 
-    if(!focused_task_framebuffer) return;
-    __memcpy_fast(mode->PhysBasePtr, (void*)focused_task_framebuffer, copy_size);
+void flush_focused_framebuffer() {
+    VBE_MODEINFO* mode = GET_VBE_MODE();
+    if (!mode) return;
+    
+    U32 copy_size = mode->BytesPerScanLineLinear * mode->YResolution;
+    if (copy_size == 0) return;
+    if (copy_size > FRAMEBUFFER_SIZE) copy_size = FRAMEBUFFER_SIZE;
+
+    U8 *src = flush_source();
+    if(!src) return;
+    BOOLEAN timed = !early_mode && (trace_mask & TRACE_CLASS_SCHED) != 0;
+    U32 t0 = timed ? rdtsc_lo() : 0;
+    present(mode, src, copy_size);
+    if (timed) TRACE(TRACE_EV_FLUSH, rdtsc_lo() - t0, copy_size, get_focused_task()->info.pid);
+}
+
+void flush_focused_framebuffer_rects(CONST VBE_RECT *rects, U32 count) {
+    // Both pages have to hold the whole frame, so a flip always copies all of it
+    if (flip_enabled) {
+        flush_focused_framebuffer();
+        return;
+    }
+    VBE_MODEINFO* mode = GET_VBE_MODE();
+    if (!mode) return;
+    U8 *src = flush_source();
+    if (!src) return;
+
+    U32 pitch = mode->BytesPerScanLineLinear;
+    U32 bpp = (mode->BitsPerPixel + 7) / 8;
+    U32 rows = FRAMEBUFFER_SIZE / pitch;
+    if (rows > mode->YResolution) rows = mode->YResolution;
+    if (count > VBE_UPDATE_MAX_RECTS) count = VBE_UPDATE_MAX_RECTS;
+
+    BOOLEAN timed = !early_mode && (trace_mask & TRACE_CLASS_SCHED) != 0;
+    U32 t0 = timed ? rdtsc_lo() : 0;
+    U32 bytes = 0;
+    for (U32 i = 0; i < count; i++) {
+        U32 x = rects[i].x, y = rects[i].y, w = rects[i].w, h = rects[i].h;
+        if (x >= mode->XResolution || y >= rows) continue;
+        if (w > mode->XResolution - x) w = mode->XResolution - x;
+        if (h > rows - y) h = rows - y;
+        U32 offset = y * pitch + x * bpp;
+        for (U32 row = 0; row < h; row++, offset += pitch) {
+            __memcpy_fast((U8 *)mode->PhysBasePtr + offset, src + offset, w * bpp);
+        }
+        bytes += w * bpp * h;
+    }
+    if (timed && bytes) TRACE(TRACE_EV_FLUSH, rdtsc_lo() - t0, bytes, get_focused_task()->info.pid);
 }
 
 void update_current_framebuffer() {
@@ -122,6 +253,27 @@ void update_current_framebuffer() {
     current_frambuffer = current->framebuffer_virt;
 }
 
+U8 *vbe_current_framebuffer() {
+    return (U8 *)current_frambuffer;
+}
+
+CONST VBE_FONT VBE_FONT_8x8 = { &VBE_LETTERS[0][0], VBE_CHAR_HEIGHT, UNUSABLE_CHARS, VBE_MAX_CHARS };
+VBE_GLYPH_CACHE VBE_KERNEL_SPANS ATTRIB_DATA = { 0 };
+
+/* Text target covering the whole current framebuffer */
+static BOOLEAN console_target(VBE_TEXT_TARGET *t) {
+    VBE_MODEINFO* mode = GET_VBE_MODE();
+    if (!mode || !current_frambuffer) return FALSE;
+    t->fb = (U8 *)current_frambuffer;
+    t->pitch = mode->BytesPerScanLineLinear;
+    t->bpp = (mode->BitsPerPixel + 7) / 8;
+    t->cx0 = 0;
+    t->cy0 = 0;
+    t->cx1 = (I32)mode->XResolution;
+    t->cy1 = (I32)mode->YResolution;
+    return TRUE;
+}
+
 void debug_vram_start() {
     early_mode = TRUE;
     current_frambuffer = FRAMEBUFFER_ADDRESS;
@@ -137,12 +289,80 @@ void debug_vram_dump() {
     // Copy only the required framebuffer bytes
     U32 copy_size = mode->BytesPerScanLineLinear * mode->YResolution;
     if (copy_size > FRAMEBUFFER_SIZE) copy_size = FRAMEBUFFER_SIZE;
-    __memcpy_fast(mode->PhysBasePtr, FRAMEBUFFER_ADDRESS, copy_size);
+    present(mode, (void*)FRAMEBUFFER_ADDRESS, copy_size);
     early_mode = FALSE;
 }
 
+// MB/s of full-screen copies from the kernel framebuffer into the LFB,
+// best of a few runs. 0 without a TSC
+static U32 lfb_flush_mbps(VBE_MODEINFO *mode, U32 bytes) {
+    U32 khz = TSC_GET_KHZ();
+    if (!khz) return 0;
+    U32 best = 0;
+    for (U32 i = 0; i < 4; i++) {
+        U32 t0 = rdtsc_lo();
+        __memcpy_fast((void *)mode->PhysBasePtr, (void *)FRAMEBUFFER_ADDRESS, bytes);
+        U32 cycles = rdtsc_lo() - t0;
+        if (cycles && (!best || cycles < best)) best = cycles;
+    }
+    if (!best) return 0;
+    return umuldiv32(umuldiv32(bytes, khz, best), 1000, 1024 * 1024);
+}
+
+static VOID kdebug_dec(U32 v) {
+    U8 buf[12];
+    ITOA_U(v, buf, 10);
+    KDEBUG_PUTS(buf);
+}
+
+BOOLEAN VBE_FRAMEBUFFER_WC_INIT(VOID) {
+    VBE_MODEINFO *mode = GET_VBE_MODE();
+    if (!mode || !mode->PhysBasePtr || !mode->YResolution) return FALSE;
+    U32 base = mode->PhysBasePtr;
+    U32 mapped = VBE_LFB_SIZE();
+    U32 bytes = mode->BytesPerScanLineLinear * mode->YResolution;
+    if (bytes > FRAMEBUFFER_SIZE) bytes = FRAMEBUFFER_SIZE;
+
+    U32 before = lfb_flush_mbps(mode, bytes);
+    PU8 how = NULLPTR;
+    if (PAT_INIT()) {
+        PAGING_SET_CACHING((U32 *)get_page_directory(), base, base + mapped, PAGE_WC);
+        how = "PAT";
+    } else {
+        // One power-of-two MTRR, and it must not reach past video memory
+        U32 size = PAGE_SIZE;
+        while (size < mapped && size < 0x80000000) size <<= 1;
+        U32 vram = GET_VESA_INFO()->TotalMemory * 0x10000;
+        if ((!vram || size <= vram) && MTRR_SET_WC(base, size)) how = "MTRR";
+    }
+
+    if (!how) {
+        KDEBUG_PUTS("[VBE] LFB stays uncached, no PAT and no usable MTRR\n");
+        return FALSE;
+    }
+    KDEBUG_PUTS("[VBE] LFB write-combining via ");
+    KDEBUG_PUTS(how);
+    if (before) {
+        KDEBUG_PUTS(", flush ");
+        kdebug_dec(before);
+        KDEBUG_PUTS(" -> ");
+        kdebug_dec(lfb_flush_mbps(mode, bytes));
+        KDEBUG_PUTS(" MB/s");
+    }
+    KDEBUG_PUTC('\n');
+    return TRUE;
+}
+
 #endif
 
+#ifdef __RTOS__
+BOOLEAN VBE_DRAW_CHARACTER(U32 x, U32 y, U8 c, VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
+    VBE_TEXT_TARGET t;
+    if (!console_target(&t)) return FALSE;
+    return VBE_TEXT_RUN(&t, &VBE_FONT_8x8, &VBE_KERNEL_SPANS, (I32)x, (I32)y, &c, 1,
+                        VBE_CHAR_WIDTH, fg, bg) == 1;
+}
+#else
 BOOLEAN VBE_DRAW_CHARACTER(U32 x, U32 y, U8 c, VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
     VBE_MODEINFO* mode = GET_VBE_MODE();
     if (!mode) return FALSE;
@@ -161,6 +381,7 @@ BOOLEAN VBE_DRAW_CHARACTER(U32 x, U32 y, U8 c, VBE_PIXEL_COLOUR fg, VBE_PIXEL_CO
 
     return TRUE;
 }
+#endif
 
 U0 ___memcpy(void* dest, const void* src, U32 n) {
     U8* d = (U8*)dest;
@@ -204,9 +425,16 @@ U32 strlen(const char* str) {
 
 BOOLEAN VBE_DRAW_STRING(U32 x, U32 y, const char* str, VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
     U32 length = strlen(str);
+#ifdef __RTOS__
+    VBE_TEXT_TARGET t;
+    if (!console_target(&t)) return FALSE;
+    VBE_TEXT_RUN(&t, &VBE_FONT_8x8, &VBE_KERNEL_SPANS, (I32)x, (I32)y, (CONST U8 *)str, length,
+                 VBE_CHAR_WIDTH, fg, bg);
+#else
     for (U32 i = 0; i < length; i++) {
         VBE_DRAW_CHARACTER(x + i * VBE_CHAR_WIDTH, y, str[i], fg, bg);
     }
+#endif
     return TRUE;
 }
 
@@ -69,6 +69,18 @@ Video memory data is written into this location, and updated to the vbe framebuf
 
 void flush_focused_framebuffer();
 void update_current_framebuffer();
+/// Maps the linear framebuffer write-combining (PAT, else an MTRR) and logs
+/// the flush throughput before and after. After PAGING_INIT, before any process.
+BOOLEAN VBE_FRAMEBUFFER_WC_INIT(VOID);
+/// Bytes of the LFB the kernel maps: two screens when video memory holds
+/// them, for page flipping, one otherwise
+U32 VBE_LFB_SIZE(VOID);
+/// Presents frames by flipping between two screens with the Bochs/QEMU
+/// DISPI display start. @return FALSE if frames keep being copied over
+/// the visible screen instead.
+BOOLEAN VBE_PAGE_FLIP_INIT(VOID);
+BOOLEAN VBE_PAGE_FLIP_ENABLED(VOID);
+U8 *vbe_current_framebuffer();
 
 void debug_vram_start();
 void debug_vram_dump();
@@ -187,7 +199,21 @@ typedef struct {
 #define CREATE_VBE_PIXEL_INFO(x, y, colour) \
     ((VBE_PIXEL_INFO){(U32)(x), (U32)(y), (VBE_PIXEL_COLOUR)(colour)})
 
+// Screen area for partial VRAM updates (SYSCALL_VBE_UPDATE_VRAM)
+typedef struct {
+    U32 x;
+    U32 y;
+    U32 w;
+    U32 h;
+} VBE_RECT;
+
+#define VBE_UPDATE_MAX_RECTS 64
+
 #if defined(__RTOS__) || defined(KERNEL_ENTRY)
+/// Copies only `rects` of the focused task's framebuffer to the screen.
+/// With page flipping the whole frame is presented instead.
+void flush_focused_framebuffer_rects(CONST VBE_RECT *rects, U32 count);
+
 /// @brief VESA BIOS Extensions (VBE) mode information
 typedef struct {
     U16 ModeAttributes;      // Mode attributes (bit flags)
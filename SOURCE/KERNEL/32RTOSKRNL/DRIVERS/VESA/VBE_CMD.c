@@ -0,0 +1,240 @@
+#include <DRIVERS/VESA/VBE.h>
+#include <DRIVERS/VESA/VBE_CMD.h>
+#include <DRIVERS/VESA/VBE_TEXT.h>
+
+/* Replay state for one submit. The clip rectangle is half-open and always
+   lies inside the screen, so the writers below index the framebuffer
+   without further checks. */
+typedef struct {
+    U8 *fb;
+    U32 bpp;
+    U32 pitch;
+    I32 width, height;
+    I32 cx0, cy0, cx1, cy1;
+} VBE_REPLAY;
+
+static inline VOID put_pixel(VBE_REPLAY *r, I32 x, I32 y, VBE_PIXEL_COLOUR c) {
+    if (x < r->cx0 || y < r->cy0 || x >= r->cx1 || y >= r->cy1) return;
+    if (c == VBE_SEE_THROUGH) return;
+
+    U32 pos = (U32)y * r->pitch + (U32)x * r->bpp;
+    if (r->bpp == 4) {
+        *(U32 *)(r->fb + pos) = c;
+    } else if (r->bpp == 3) {
+        r->fb[pos]     = (U8)(c & 0xFF);
+        r->fb[pos + 1] = (U8)((c >> 8) & 0xFF);
+        r->fb[pos + 2] = (U8)((c >> 16) & 0xFF);
+    } else {
+        VBE_DRAW_FRAMEBUFFER(pos, c);
+    }
+}
+
+/* Horizontal run [x0, x1) on row y */
+static VOID span(VBE_REPLAY *r, I32 x0, I32 x1, I32 y, VBE_PIXEL_COLOUR c) {
+    if (y < r->cy0 || y >= r->cy1 || c == VBE_SEE_THROUGH) return;
+    if (x0 < r->cx0) x0 = r->cx0;
+    if (x1 > r->cx1) x1 = r->cx1;
+    if (x0 >= x1) return;
+
+    U8 *p = r->fb + (U32)y * r->pitch + (U32)x0 * r->bpp;
+    U32 n = (U32)(x1 - x0);
+    if (r->bpp == 4) {
+        U32 *p32 = (U32 *)p;
+        while (n--) *p32++ = c;
+    } else if (r->bpp == 3) {
+        U8 b0 = (U8)(c & 0xFF);
+        U8 b1 = (U8)((c >> 8) & 0xFF);
+        U8 b2 = (U8)((c >> 16) & 0xFF);
+        while (n--) { *p++ = b0; *p++ = b1; *p++ = b2; }
+    } else {
+        for (I32 x = x0; x < x1; x++) put_pixel(r, x, y, c);
+    }
+}
+
+static VOID fill_rect(VBE_REPLAY *r, I32 x, I32 y, I32 w, I32 h, VBE_PIXEL_COLOUR c) {
+    if (w <= 0 || h <= 0) return;
+    I32 y0 = y < r->cy0 ? r->cy0 : y;
+    I32 y1 = y + h > r->cy1 ? r->cy1 : y + h;
+    for (I32 yy = y0; yy < y1; yy++) span(r, x, x + w, yy, c);
+}
+
+static VOID draw_line(VBE_REPLAY *r, I32 x0, I32 y0, I32 x1, I32 y1, VBE_PIXEL_COLOUR c) {
+    if (y0 == y1) {
+        if (x0 > x1) { I32 t = x0; x0 = x1; x1 = t; }
+        span(r, x0, x1 + 1, y0, c);
+        return;
+    }
+    /* Reject lines whose bounding box misses the clip */
+    if ((x0 < r->cx0 && x1 < r->cx0) || (x0 >= r->cx1 && x1 >= r->cx1) ||
+        (y0 < r->cy0 && y1 < r->cy0) || (y0 >= r->cy1 && y1 >= r->cy1)) return;
+
+    I32 dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    I32 dy = y1 > y0 ? y0 - y1 : y1 - y0;
+    I32 sx = x0 < x1 ? 1 : -1;
+    I32 sy = y0 < y1 ? 1 : -1;
+    I32 err = dx + dy;
+    for (;;) {
+        put_pixel(r, x0, y0, c);
+        if (x0 == x1 && y0 == y1) break;
+        I32 e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+/* Same outline as VBE_DRAW_RECTANGLE: corners at (x, y) and (x+w-1, y+h-1) */
+static VOID draw_rect(VBE_REPLAY *r, I32 x, I32 y, I32 w, I32 h, VBE_PIXEL_COLOUR c) {
+    if (w <= 0 || h <= 0) return;
+    span(r, x, x + w, y, c);
+    span(r, x, x + w, y + h - 1, c);
+    for (I32 yy = y + 1; yy < y + h - 1; yy++) {
+        put_pixel(r, x, yy, c);
+        put_pixel(r, x + w - 1, yy, c);
+    }
+}
+
+/* Midpoint ellipse, the same walk as VBE_DRAW_ELLIPSE */
+static VOID draw_ellipse(VBE_REPLAY *r, I32 cx, I32 cy, I32 a, I32 b, VBE_PIXEL_COLOUR c) {
+    if (a <= 0 || b <= 0) return;
+    I32 x = 0, y = b;
+    I32 a2 = a * a, b2 = b * b;
+    I32 err = b2 + a2 * b2;
+    do {
+        put_pixel(r, cx + x, cy + y, c);
+        put_pixel(r, cx - x, cy + y, c);
+        put_pixel(r, cx - x, cy - y, c);
+        put_pixel(r, cx + x, cy - y, c);
+        I32 e2 = 2 * err;
+        if (e2 > -(2 * a2 * y)) err -= 2 * a2 * --y;
+        if (e2 < (2 * b2 * x))  err += 2 * b2 * ++x;
+    } while (y >= 0);
+}
+
+/* Same two-region walk as VBE_DRAW_FILLED_ELLIPSE, one span per row */
+static VOID fill_ellipse(VBE_REPLAY *r, I32 cx, I32 cy, I32 a, I32 b, VBE_PIXEL_COLOUR c) {
+    if (a < 0 || b < 0) return;
+    I32 x = 0, y = b;
+    I32 a2 = a * a, b2 = b * b;
+    I32 dx = 0, dy = 2 * a2 * y;
+    I32 d1 = b2 - a2 * b + a2 / 4;
+    while (dx < dy) {
+        span(r, cx - x, cx + x + 1, cy + y, c);
+        span(r, cx - x, cx + x + 1, cy - y, c);
+        x++;
+        dx += 2 * b2;
+        if (d1 < 0) {
+            d1 += b2 + dx;
+        } else {
+            y--;
+            dy -= 2 * a2;
+            d1 += b2 + dx - dy;
+        }
+    }
+    I32 d2 = b2 * (x * x + x) + a2 * (y - 1) * (y - 1) - a2 * b2;
+    while (y >= 0) {
+        span(r, cx - x, cx + x + 1, cy + y, c);
+        span(r, cx - x, cx + x + 1, cy - y, c);
+        y--;
+        dy -= 2 * a2;
+        if (d2 > 0) {
+            d2 += a2 - dy;
+        } else {
+            x++;
+            dx += 2 * b2;
+            d2 += a2 - dy + dx;
+        }
+    }
+}
+
+/* Glyphs follow VBE_DRAW_CHARACTER: characters outside the font, space
+   included, are skipped but still advance the pen. */
+static VOID draw_glyphs(VBE_REPLAY *r, I32 x, I32 y, VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg,
+                        CONST U8 *chars, U32 count) {
+    VBE_TEXT_TARGET t = { r->fb, r->pitch, r->bpp, r->cx0, r->cy0, r->cx1, r->cy1 };
+    VBE_TEXT_RUN(&t, &VBE_FONT_8x8, &VBE_KERNEL_SPANS, x, y, chars, count, VBE_CHAR_WIDTH, fg, bg);
+}
+
+static VOID blit(VBE_REPLAY *r, I32 x, I32 y, I32 w, I32 h, U32 stride, CONST U32 *pixels) {
+    if (!pixels || w <= 0 || h <= 0) return;
+    I32 x0 = x < r->cx0 ? r->cx0 : x;
+    I32 x1 = x + w > r->cx1 ? r->cx1 : x + w;
+    I32 y0 = y < r->cy0 ? r->cy0 : y;
+    I32 y1 = y + h > r->cy1 ? r->cy1 : y + h;
+    for (I32 yy = y0; yy < y1; yy++) {
+        CONST U32 *src = pixels + (U32)(yy - y) * stride + (U32)(x0 - x);
+        for (I32 xx = x0; xx < x1; xx++) put_pixel(r, xx, yy, *src++);
+    }
+}
+
+static VOID set_clip(VBE_REPLAY *r, I32 x, I32 y, I32 w, I32 h) {
+    if (w <= 0 || h <= 0) {
+        r->cx0 = 0; r->cy0 = 0;
+        r->cx1 = r->width; r->cy1 = r->height;
+        return;
+    }
+    r->cx0 = x < 0 ? 0 : x;
+    r->cy0 = y < 0 ? 0 : y;
+    r->cx1 = x + w > r->width ? r->width : x + w;
+    r->cy1 = y + h > r->height ? r->height : y + h;
+    /* An empty intersection clips everything away */
+    if (r->cx0 > r->cx1) r->cx0 = r->cx1;
+    if (r->cy0 > r->cy1) r->cy0 = r->cy1;
+}
+
+U32 VBE_SUBMIT(CONST U32 *cmds, U32 words) {
+    VBE_MODEINFO *mode = GET_VBE_MODE();
+    if (!mode || !cmds) return 0;
+    if (words > VBE_CMD_MAX_WORDS) words = VBE_CMD_MAX_WORDS;
+
+    VBE_REPLAY r;
+    r.fb = vbe_current_framebuffer();
+    if (!r.fb) return 0;
+    r.bpp = (mode->BitsPerPixel + 7) / 8;
+    r.pitch = mode->BytesPerScanLineLinear;
+    r.width = (I32)mode->XResolution;
+    r.height = (I32)mode->YResolution;
+    set_clip(&r, 0, 0, 0, 0);
+
+    U32 done = 0;
+    U32 i = 0;
+    while (i < words) {
+        U32 op = VBE_CMD_OP_OF(cmds[i]);
+        U32 len = VBE_CMD_WORDS_OF(cmds[i]);
+        if (len == 0 || len > words - i) break;
+        CONST U32 *a = &cmds[i + 1];
+        CONST I32 *s = (CONST I32 *)a;
+        U32 need;
+
+        switch (op) {
+            case VBE_CMD_CLIP:          need = VBE_CMD_CLIP_WORDS; break;
+            case VBE_CMD_CLEAR:         need = VBE_CMD_CLEAR_WORDS; break;
+            case VBE_CMD_PIXEL:         need = VBE_CMD_PIXEL_WORDS; break;
+            case VBE_CMD_LINE:
+            case VBE_CMD_RECT:
+            case VBE_CMD_FILL_RECT:
+            case VBE_CMD_ELLIPSE:
+            case VBE_CMD_FILL_ELLIPSE:  need = VBE_CMD_SHAPE_WORDS; break;
+            case VBE_CMD_GLYPHS:        /* the character count must fit in the command */
+                                        need = (len >= 6 && a[4] <= (len - 6) * 4) ? len : 0; break;
+            case VBE_CMD_BLIT:          need = VBE_CMD_BLIT_WORDS; break;
+            default:                    need = 0; break;
+        }
+        if (!need || len < need) break;
+
+        switch (op) {
+            case VBE_CMD_CLIP:         set_clip(&r, s[0], s[1], s[2], s[3]); break;
+            case VBE_CMD_CLEAR:        fill_rect(&r, r.cx0, r.cy0, r.cx1 - r.cx0, r.cy1 - r.cy0, a[0]); break;
+            case VBE_CMD_PIXEL:        put_pixel(&r, s[0], s[1], a[2]); break;
+            case VBE_CMD_LINE:         draw_line(&r, s[0], s[1], s[2], s[3], a[4]); break;
+            case VBE_CMD_RECT:         draw_rect(&r, s[0], s[1], s[2], s[3], a[4]); break;
+            case VBE_CMD_FILL_RECT:    fill_rect(&r, s[0], s[1], s[2], s[3], a[4]); break;
+            case VBE_CMD_ELLIPSE:      draw_ellipse(&r, s[0], s[1], s[2], s[3], a[4]); break;
+            case VBE_CMD_FILL_ELLIPSE: fill_ellipse(&r, s[0], s[1], s[2], s[3], a[4]); break;
+            case VBE_CMD_GLYPHS:       draw_glyphs(&r, s[0], s[1], a[2], a[3], (CONST U8 *)&a[5], a[4]); break;
+            case VBE_CMD_BLIT:         blit(&r, s[0], s[1], s[2], s[3], a[4], (CONST U32 *)a[5]); break;
+        }
+        done++;
+        i += len;
+    }
+    return done;
+}
@@ -0,0 +1,67 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/DRIVERS/VESA/VBE_CMD.h - Batched drawing commands
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    A command buffer is an array of U32 words recorded in user space
+    (STD/GRAPHICS.c, DRAW_BATCH_*) and handed to the kernel with one
+    SYSCALL_VBE_SUBMIT. VBE_SUBMIT replays it against the calling process's
+    framebuffer, so a frame of a few thousand primitives costs one trap
+    instead of one per primitive.
+
+    Every command starts with a header word holding the opcode in the low
+    byte and the command length in words, header included, above it. The
+    arguments follow in the order listed below. Coordinates are signed, so
+    shapes may hang off any edge of the screen.
+
+    The clip rectangle starts as the whole screen on every submit and is
+    applied to all commands after a VBE_CMD_CLIP. VBE_SEE_THROUGH is never
+    written, it leaves the pixel as it was.
+
+REMARKS
+    Only append opcodes; old programs keep their recorded layout.
+---*/
+#ifndef VBE_CMD_H
+#define VBE_CMD_H
+
+#include <STD/TYPEDEF.h>
+
+typedef enum {
+    VBE_CMD_CLIP = 1,       // x, y, w, h. A zero width or height resets to the whole screen
+    VBE_CMD_CLEAR,          // colour. Fills the clip rectangle
+    VBE_CMD_PIXEL,          // x, y, colour
+    VBE_CMD_LINE,           // x1, y1, x2, y2, colour
+    VBE_CMD_RECT,           // x, y, w, h, colour
+    VBE_CMD_FILL_RECT,      // x, y, w, h, colour
+    VBE_CMD_ELLIPSE,        // cx, cy, rx, ry, colour
+    VBE_CMD_FILL_ELLIPSE,   // cx, cy, rx, ry, colour
+    VBE_CMD_GLYPHS,         // x, y, fg, bg, count, then `count` 8x8 characters packed 4 per word
+    VBE_CMD_BLIT,           // x, y, w, h, stride in pixels, pointer to 0x00RRGGBB pixels
+} VBE_CMD_OP;
+
+#define VBE_CMD_HEADER(op, words)   ((U32)(op) | ((U32)(words) << 8))
+#define VBE_CMD_OP_OF(header)       ((header) & 0xFF)
+#define VBE_CMD_WORDS_OF(header)    ((header) >> 8)
+
+// Words taken by each fixed-size command, header included
+#define VBE_CMD_CLIP_WORDS          5
+#define VBE_CMD_CLEAR_WORDS         2
+#define VBE_CMD_PIXEL_WORDS         4
+#define VBE_CMD_SHAPE_WORDS         6   // LINE, RECT, FILL_RECT, ELLIPSE, FILL_ELLIPSE
+#define VBE_CMD_BLIT_WORDS          7
+#define VBE_CMD_GLYPHS_WORDS(n)     (6 + ((n) + 3) / 4)
+#define VBE_CMD_GLYPH_ADVANCE       8   // pixels between the characters of a GLYPHS run
+
+// Largest buffer accepted by one submit
+#define VBE_CMD_MAX_WORDS           (64 * 1024)
+
+#ifdef __RTOS__
+/// @brief Replays `words` words of commands onto the current task's framebuffer.
+/// @return Number of commands drawn. Replay stops at the first malformed command.
+U32 VBE_SUBMIT(CONST U32 *cmds, U32 words);
+#endif
+
+#endif // VBE_CMD_H
@@ -0,0 +1,132 @@
+#include <DRIVERS/VESA/VBE_TEXT.h>
+
+static VOID colour_bytes(VBE_PIXEL_COLOUR c, U8 out[VBE_TEXT_MAX_BPP]) {
+    out[0] = (U8)(c & 0xFF);
+    out[1] = (U8)((c >> 8) & 0xFF);
+    out[2] = (U8)((c >> 16) & 0xFF);
+    out[3] = (U8)((c >> 24) & 0xFF);
+}
+
+/* Expands every possible glyph row byte into 8 pixels of fg/bg */
+static VOID build_spans(VBE_GLYPH_SPANS *s, U32 bpp, VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
+    U8 f[VBE_TEXT_MAX_BPP], b[VBE_TEXT_MAX_BPP];
+    colour_bytes(fg, f);
+    colour_bytes(bg, b);
+    for (U32 m = 0; m < 256; m++) {
+        U8 *p = s->rows[m];
+        for (U32 col = 0; col < VBE_TEXT_GLYPH_WIDTH; col++) {
+            CONST U8 *c = (m & (0x80 >> col)) ? f : b;
+            for (U32 k = 0; k < bpp; k++) *p++ = c[k];
+        }
+    }
+    s->fg = fg;
+    s->bg = bg;
+    s->bpp = bpp;
+}
+
+/* The table for fg/bg at `bpp`, building it over the least recently used
+   slot if the cache has none */
+static CONST VBE_GLYPH_SPANS *lookup_spans(VBE_GLYPH_CACHE *cache, U32 bpp,
+                                           VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
+    VBE_GLYPH_SPANS *victim = &cache->slot[0];
+    for (U32 i = 0; i < VBE_TEXT_SPAN_SLOTS; i++) {
+        VBE_GLYPH_SPANS *s = &cache->slot[i];
+        if (s->bpp == bpp && s->fg == fg && s->bg == bg) {
+            s->used = ++cache->clock;
+            return s;
+        }
+        if (!s->bpp) {
+            if (victim->bpp) victim = s;
+        } else if (victim->bpp && s->used < victim->used) {
+            victim = s;
+        }
+    }
+    build_spans(victim, bpp, fg, bg);
+    victim->used = ++cache->clock;
+    return victim;
+}
+
+/* Writes `n` pixels of one colour, given as its framebuffer bytes */
+static VOID put_run(U8 *dst, CONST U8 *px, U32 n, U32 bpp) {
+    while (n--) {
+        for (U32 k = 0; k < bpp; k++) *dst++ = px[k];
+    }
+}
+
+U32 VBE_TEXT_RUN(CONST VBE_TEXT_TARGET *t, CONST VBE_FONT *font, VBE_GLYPH_CACHE *cache,
+                 I32 x, I32 y, CONST U8 *text, U32 len, U32 advance,
+                 VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
+    if (!t || !t->fb || !font || !font->bits || !cache || !text || !len) return 0;
+    U32 bpp = t->bpp;
+    if (bpp == 0 || bpp > VBE_TEXT_MAX_BPP) return 0;
+    if (advance < VBE_TEXT_GLYPH_WIDTH) advance = VBE_TEXT_GLYPH_WIDTH;
+
+    /* Clip once: the scanlines and the cells that reach into the clip rectangle */
+    I32 ry0 = y > t->cy0 ? y : t->cy0;
+    I32 ry1 = y + (I32)font->height < t->cy1 ? y + (I32)font->height : t->cy1;
+    if (ry0 >= ry1 || x >= t->cx1) return 0;
+    U32 i0 = x < t->cx0 ? (U32)(t->cx0 - x) / advance : 0;
+    U32 i1 = (U32)(t->cx1 - x + (I32)advance - 1) / advance;
+    if (i1 > len) i1 = len;
+    if (i0 >= i1) return 0;
+
+    BOOLEAN opaque = fg != VBE_SEE_THROUGH && bg != VBE_SEE_THROUGH;
+    CONST VBE_GLYPH_SPANS *spans = opaque ? lookup_spans(cache, bpp, fg, bg) : NULLPTR;
+    U8 f[VBE_TEXT_MAX_BPP], b[VBE_TEXT_MAX_BPP];
+    colour_bytes(fg, f);
+    colour_bytes(bg, b);
+
+    for (I32 row = ry0; row < ry1; row++) {
+        U8 *line = t->fb + (U32)row * t->pitch;
+        CONST U8 *glyph_row = font->bits + (U32)(row - y);
+        I32 gx = x + (I32)(i0 * advance);
+
+        for (U32 i = i0; i < i1; i++, gx += (I32)advance) {
+            U32 code = (U32)text[i] - font->first;
+            if (code >= font->count) continue;
+            U8 mask = glyph_row[code * font->height];
+
+            /* Visible columns: [a, ge) of the glyph, then [max(a, ge), e) of spacing */
+            I32 ge = gx + VBE_TEXT_GLYPH_WIDTH;
+            I32 a = gx < t->cx0 ? t->cx0 : gx;
+            I32 e = gx + (I32)advance < t->cx1 ? gx + (I32)advance : t->cx1;
+            if (ge > e) ge = e;
+
+            if (opaque) {
+                CONST U8 *src = spans->rows[mask];
+                if (a == gx && ge == gx + VBE_TEXT_GLYPH_WIDTH) {
+                    /* The whole row: 8 to 32 bytes, copied a word at a time */
+                    U32 *d = (U32 *)(line + (U32)gx * bpp);
+                    CONST U32 *s = (CONST U32 *)src;
+                    switch (bpp) {
+                        case 4: d[7] = s[7]; d[6] = s[6]; /* fall through */
+                        case 3: d[5] = s[5]; d[4] = s[4]; /* fall through */
+                        case 2: d[3] = s[3]; d[2] = s[2]; /* fall through */
+                        default: d[1] = s[1]; d[0] = s[0];
+                    }
+                } else if (a < ge) {
+                    U8 *d = line + (U32)a * bpp;
+                    CONST U8 *s = src + (U32)(a - gx) * bpp;
+                    for (U32 n = (U32)(ge - a) * bpp; n; n--) *d++ = *s++;
+                }
+            } else {
+                for (I32 c = a; c < ge; c++) {
+                    if (mask & (0x80 >> (c - gx))) {
+                        if (fg != VBE_SEE_THROUGH) put_run(line + (U32)c * bpp, f, 1, bpp);
+                    } else if (bg != VBE_SEE_THROUGH) {
+                        put_run(line + (U32)c * bpp, b, 1, bpp);
+                    }
+                }
+            }
+
+            I32 gap = ge > a ? ge : a;
+            if (gap < e && bg != VBE_SEE_THROUGH)
+                put_run(line + (U32)gap * bpp, b, (U32)(e - gap), bpp);
+        }
+    }
+
+    U32 drawn = 0;
+    for (U32 i = i0; i < i1; i++)
+        if ((U32)text[i] - font->first < font->count) drawn++;
+    return drawn;
+}
@@ -0,0 +1,97 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/DRIVERS/VESA/VBE_TEXT.h - Span-based text renderer
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Draws runs of 8 pixel wide bitmap glyphs straight into a framebuffer.
+    A run is clipped once, then written a scanline at a time: each glyph
+    row byte indexes a VBE_GLYPH_SPANS table holding that row already
+    expanded to framebuffer pixels, so an opaque row is one 8 pixel copy
+    instead of eight VBE_DRAW_PIXEL calls.
+
+    Tables live in a VBE_GLYPH_CACHE owned by the caller, one per fg/bg
+    pair and pixel size, built on first use. The cache holds
+    VBE_TEXT_SPAN_SLOTS of them and rebuilds the least recently used one
+    for a new pair, so text that alternates a few colour schemes (a
+    selected list row, a coloured prompt) does not rebuild on every run.
+
+    Used by the kernel console (VBE_DRAW_CHARACTER, VBE_DRAW_STRING), by
+    VBE_CMD_GLYPHS and by the shell, which draws FONT8x16 into its own
+    framebuffer. Nothing here depends on the kernel, so user programs may
+    compile VBE_TEXT.c in.
+
+REMARKS
+    If fg or bg is VBE_SEE_THROUGH those pixels are left as they were and
+    the run falls back to writing single pixels.
+---*/
+#ifndef VBE_TEXT_H
+#define VBE_TEXT_H
+
+#include <STD/TYPEDEF.h>
+#include <DRIVERS/VESA/VBE.h>
+
+#define VBE_TEXT_GLYPH_WIDTH 8
+#define VBE_TEXT_MAX_BPP     4
+
+typedef struct {
+    CONST U8 *bits;     // `height` bytes per glyph, bit 7 is the leftmost pixel
+    U32 height;
+    U32 first;          // character code of the first glyph in `bits`
+    U32 count;          // glyphs in `bits`. Other characters are skipped
+} VBE_FONT;
+
+typedef struct {
+    U8 *fb;
+    U32 pitch;          // bytes per scanline
+    U32 bpp;            // bytes per pixel, 1 to 4
+    I32 cx0, cy0;       // clip rectangle, half-open and inside the framebuffer
+    I32 cx1, cy1;
+} VBE_TEXT_TARGET;
+
+typedef struct {
+    VBE_PIXEL_COLOUR fg, bg;
+    U32 bpp;            // 0 while the slot is unused
+    U32 used;           // cache clock at its last run
+    U8 rows[256][VBE_TEXT_GLYPH_WIDTH * VBE_TEXT_MAX_BPP];
+} VBE_GLYPH_SPANS;
+
+#define VBE_TEXT_SPAN_SLOTS 4
+
+typedef struct {
+    U32 clock;
+    VBE_GLYPH_SPANS slot[VBE_TEXT_SPAN_SLOTS];
+} VBE_GLYPH_CACHE;
+
+/*+++
+U32 VBE_TEXT_RUN(CONST VBE_TEXT_TARGET *t, CONST VBE_FONT *font, VBE_GLYPH_CACHE *cache,
+                 I32 x, I32 y, CONST U8 *text, U32 len, U32 advance,
+                 VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg)
+
+DESCRIPTION
+    Draws `len` characters of `text` with the top-left corner of the
+    first glyph at (x, y), one glyph every `advance` pixels.
+
+PARAMETERS
+    advance
+        Pixels from one glyph to the next, at least 8. The columns past
+        the glyph are filled with bg, so a run paints its whole cell row.
+
+RETURN
+    Number of glyphs with at least one pixel inside the clip rectangle.
+    Characters missing from the font leave their cell untouched and are
+    not counted.
+---*/
+U32 VBE_TEXT_RUN(CONST VBE_TEXT_TARGET *t, CONST VBE_FONT *font, VBE_GLYPH_CACHE *cache,
+                 I32 x, I32 y, CONST U8 *text, U32 len, U32 advance,
+                 VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg);
+
+#ifdef __RTOS__
+// FONT8x8 and the span tables shared by the kernel's text drawing (VBE.c)
+extern CONST VBE_FONT VBE_FONT_8x8;
+extern VBE_GLYPH_CACHE VBE_KERNEL_SPANS;
+#endif
+
+#endif // VBE_TEXT_H
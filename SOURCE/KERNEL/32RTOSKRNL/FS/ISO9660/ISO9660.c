@@ -4,8 +4,6 @@
 #include <STD/MEM.h>
 #include <MEMORY/HEAP/KHEAP.h>
 #include <DRIVERS/ATAPI/ATAPI.h>
-#include <DRIVERS/VESA/VBE.h>
-#include <RTOSKRNL/RTOSKRNL_INTERNAL.h>
 
 static PrimaryVolumeDescriptor *pvd = NULLPTR;
 
@@ -129,79 +127,318 @@ U32 ISO9660_CALCULATE_SECTORS(U32 extent_length) {
         sectors++;
     return sectors;
 }
-/* Recursive directory reading */
-BOOLEAN ISO9660_READ_FROM_DIRECTORY(
-    U32 lba,
-    U32 size,
-    CHAR *target,
-    CHAR *original_target,
-    IsoDirectoryRecord *output
-) {
-    if (!target || !original_target || !output) return FALSE;
-
-    U32 sectors = ISO9660_CALCULATE_SECTORS(size);
-    if (sectors > (0xFFFFFFFFu / ISO9660_SECTOR_SIZE))
-        return FALSE;
-    U32 buf_sz = sectors * ISO9660_SECTOR_SIZE;
-    U8 *buffer = KMALLOC(buf_sz);
-    if (!buffer) return FALSE;
-    MEMZERO(buffer, buf_sz);
-    if (READ_CDROM(GET_ATAPI_INFO(), lba, sectors, buffer) == ATA_FAILED) {
-        ISO9660_FREE_MEMORY_INTERNAL(&buffer);
-        return FALSE;
+/* ═══════════════════════════════════════════════════════════════════════════
+   Directory cache
+
+   Directory extents are read once and kept, keyed by extent LBA, together
+   with a hash table over their record names. The L path table is parsed
+   once into a (parent, name) hash, so every directory component of a path
+   resolves without touching the disc; only the final directory's extent is
+   needed, and that is usually cached already.
+   ═══════════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    U32 offset;             // record offset inside the extent
+    U32 hash;
+    U16 next;               // index + 1 of the next name in the bucket, 0 ends
+} ISO9660_NAME;
+
+typedef struct {
+    U32 lba;                // 0 = free slot
+    U32 size;
+    U32 last_use;
+    U8 *data;               // whole extent, sector padded
+    ISO9660_NAME *names;    // in record order, "." and ".." excluded
+    U32 count;
+    U16 heads[ISO9660_NAME_BUCKETS];
+} ISO9660_DIR;
+
+typedef struct {
+    U32 lba;
+    U32 hash;               // name hash mixed with the parent number
+    U8 *name;
+    U8 name_len;
+    U16 parent;             // 1-based path table number
+    U16 next;
+} ISO9660_PT_DIR;
+
+static ISO9660_DIR dir_cache[ISO9660_DIR_CACHE_SLOTS];
+static U32 dir_cache_clock = 0;
+
+static U8 *pt_raw = NULLPTR;
+static ISO9660_PT_DIR *pt_dirs = NULLPTR;
+static U32 pt_count = 0;
+static U16 pt_heads[ISO9660_PT_BUCKETS];
+static BOOL pt_loaded = FALSE;      // set after the first attempt, even a failed one
+
+static U32 ISO9660_NAME_HASH(const U8 *name, U32 len) {
+    U32 h = 0x811C9DC5;
+    for (U32 i = 0; i < len; i++) {
+        h ^= name[i];
+        h *= 0x01000193;
     }
+    return h;
+}
 
+static U32 ISO9660_PT_KEY(U32 parent, const U8 *name, U32 len) {
+    return ISO9660_NAME_HASH(name, len) ^ (parent * 0x9E3779B9);
+}
+
+/* Record at or after *offset, skipping the zero padding at sector ends */
+static IsoDirectoryRecord *ISO9660_NEXT_RECORD(U8 *data, U32 size, U32 *offset) {
+    while (*offset < size) {
+        IsoDirectoryRecord *record = (IsoDirectoryRecord *)(data + *offset);
+        if (record->length == 0) {
+            *offset = ((*offset / ISO9660_SECTOR_SIZE) + 1) * ISO9660_SECTOR_SIZE;
+            continue;
+        }
+        if (*offset + record->length > size) return NULLPTR;
+        if (record->length < IDR_SIZE - 1 + record->fileNameLength) return NULLPTR;
+        return record;
+    }
+    return NULLPTR;
+}
+
+static BOOL ISO9660_IS_DOT_ENTRY(IsoDirectoryRecord *record) {
+    return record->fileNameLength == 1 && record->fileIdentifier[0] <= 1;
+}
+
+static VOID ISO9660_DROP_DIR(ISO9660_DIR *dir) {
+    ISO9660_FREE_MEMORY_INTERNAL(&dir->data);
+    ISO9660_FREE_MEMORY_INTERNAL(&dir->names);
+    dir->lba = 0;
+    dir->size = 0;
+    dir->count = 0;
+}
+
+/* Reads an extent. A size of 0 (directory found through the path table)
+   is taken from the extent's own "." record. */
+static U8 *ISO9660_READ_EXTENT(U32 lba, U32 *size) {
+    U8 *data = KMALLOC(ISO9660_SECTOR_SIZE);
+    if (!data) return NULLPTR;
+    if (READ_CDROM(GET_ATAPI_INFO(), lba, 1, data) == ATA_FAILED) {
+        ISO9660_FREE_MEMORY_INTERNAL(&data);
+        return NULLPTR;
+    }
+    if (*size == 0) *size = ((IsoDirectoryRecord *)data)->extentLengthLE;
+    if (*size == 0 || *size > ISO9660_MAX_DIR_EXTENT) {
+        ISO9660_FREE_MEMORY_INTERNAL(&data);
+        return NULLPTR;
+    }
+
+    U32 sectors = ISO9660_CALCULATE_SECTORS(*size);
+    if (sectors > 1) {
+        U8 *grown = KREALLOC(data, sectors * ISO9660_SECTOR_SIZE);
+        if (!grown) {
+            ISO9660_FREE_MEMORY_INTERNAL(&data);
+            return NULLPTR;
+        }
+        data = grown;
+        if (READ_CDROM(GET_ATAPI_INFO(), lba + 1, sectors - 1, data + ISO9660_SECTOR_SIZE) == ATA_FAILED) {
+            ISO9660_FREE_MEMORY_INTERNAL(&data);
+            return NULLPTR;
+        }
+    }
+    return data;
+}
 
+static BOOL ISO9660_INDEX_DIR(ISO9660_DIR *dir) {
     U32 offset = 0;
-    while (offset < size) {
-        if(offset >= buf_sz) break;  
-        IsoDirectoryRecord *record = (IsoDirectoryRecord *)(buffer + offset);
-        if (record->length == 0) break;
-        if (record->fileNameLength >= ISO9660_MAX_PATH) {
-            ISO9660_FREE_MEMORY_INTERNAL(&buffer);
-            return FALSE;
+    U32 count = 0;
+    IsoDirectoryRecord *record;
+    while ((record = ISO9660_NEXT_RECORD(dir->data, dir->size, &offset))) {
+        if (!ISO9660_IS_DOT_ENTRY(record)) count++;
+        offset += record->length;
+    }
+    if (count > 0xFFFF) return FALSE;
+
+    MEMZERO(dir->heads, sizeof(dir->heads));
+    dir->count = 0;
+    if (count == 0) return TRUE;
+    dir->names = KMALLOC(count * sizeof(ISO9660_NAME));
+    if (!dir->names) return FALSE;
+
+    offset = 0;
+    while ((record = ISO9660_NEXT_RECORD(dir->data, dir->size, &offset))) {
+        if (!ISO9660_IS_DOT_ENTRY(record)) {
+            ISO9660_NAME *n = &dir->names[dir->count];
+            U32 bucket;
+            n->offset = offset;
+            n->hash = ISO9660_NAME_HASH(record->fileIdentifier, record->fileNameLength);
+            bucket = n->hash & (ISO9660_NAME_BUCKETS - 1);
+            n->next = dir->heads[bucket];
+            dir->heads[bucket] = (U16)++dir->count;
         }
-        CHAR record_name[ISO9660_MAX_PATH];
-        STRNCPY(record_name, record->fileIdentifier, record->fileNameLength);
-        record_name[record->fileNameLength] = '\0';
-
-        if (record->fileFlags & ISO9660_FILE_FLAG_DIRECTORY) {
-            if (STRCMP(record_name, target) == 0) {
-                CHAR *slash = STRCHR(original_target, '/');
-                if (slash) {
-                    U32 remaining = STRLEN(slash + 1);
-                    MEMMOVE(original_target, slash + 1, remaining);
-                    original_target[remaining] = '\0';
-
-                    MEMCPY(target, original_target, remaining + 1);
-                    slash = STRCHR(target, '/');
-                    if (slash) *slash = '\0';
-                } else {
-                    target[0] = '\0';
-                }
+        offset += record->length;
+    }
+    return TRUE;
+}
 
-                BOOLEAN res = ISO9660_READ_FROM_DIRECTORY(
-                    record->extentLocationLE_LBA,
-                    record->extentLengthLE,
-                    target,
-                    original_target,
-                    output
-                );
-                ISO9660_FREE_MEMORY_INTERNAL(&buffer);
-                return res;
-            }
-        } else {
-            if (STRCMP(record_name, target) == 0) {
-                MEMCPY(output, record, sizeof(IsoDirectoryRecord));
-                ISO9660_FREE_MEMORY_INTERNAL(&buffer);
-                return TRUE;
+/* Cached directory for the extent at `lba`, reading and indexing it on a miss */
+static ISO9660_DIR *ISO9660_LOAD_DIR(U32 lba, U32 size) {
+    if (lba == 0) return NULLPTR;
+
+    ISO9660_DIR *victim = &dir_cache[0];
+    for (U32 i = 0; i < ISO9660_DIR_CACHE_SLOTS; i++) {
+        ISO9660_DIR *dir = &dir_cache[i];
+        if (dir->lba == lba) {
+            dir->last_use = ++dir_cache_clock;
+            return dir;
+        }
+        if (victim->lba && (!dir->lba || dir->last_use < victim->last_use)) victim = dir;
+    }
+
+    U8 *data = ISO9660_READ_EXTENT(lba, &size);
+    if (!data) return NULLPTR;
+
+    if (victim->lba) ISO9660_DROP_DIR(victim);
+    victim->data = data;
+    victim->size = size;
+    if (!ISO9660_INDEX_DIR(victim)) {
+        ISO9660_DROP_DIR(victim);
+        return NULLPTR;
+    }
+    victim->lba = lba;
+    victim->last_use = ++dir_cache_clock;
+    return victim;
+}
+
+/* Record named `name` in `dir`; directories only if `want_dir` */
+static IsoDirectoryRecord *ISO9660_DIR_FIND(ISO9660_DIR *dir, const U8 *name, U32 len, BOOL want_dir) {
+    U32 hash = ISO9660_NAME_HASH(name, len);
+    for (U16 i = dir->heads[hash & (ISO9660_NAME_BUCKETS - 1)]; i; i = dir->names[i - 1].next) {
+        ISO9660_NAME *n = &dir->names[i - 1];
+        if (n->hash != hash) continue;
+        IsoDirectoryRecord *record = (IsoDirectoryRecord *)(dir->data + n->offset);
+        if (record->fileNameLength != len || MEMCMP(record->fileIdentifier, name, len) != 0) continue;
+        if (((record->fileFlags & ISO9660_FILE_FLAG_DIRECTORY) != 0) != want_dir) continue;
+        return record;
+    }
+    return NULLPTR;
+}
+
+static VOID ISO9660_DROP_PATH_TABLE(VOID) {
+    ISO9660_FREE_MEMORY_INTERNAL(&pt_raw);
+    ISO9660_FREE_MEMORY_INTERNAL(&pt_dirs);
+    pt_count = 0;
+    pt_loaded = FALSE;
+}
+
+static VOID ISO9660_LOAD_PATH_TABLE(VOID) {
+    pt_loaded = TRUE;
+    if (!pvd) return;
+
+    U32 size = pvd->pathTableSizeLE;
+    U32 sectors = ATAPI_CALC_SECTORS(size);
+    if (size == 0 || size > ISO9660_MAX_DIR_EXTENT) return;
+    pt_raw = KMALLOC(sectors * ISO9660_SECTOR_SIZE);
+    if (!pt_raw) return;
+    if (READ_CDROM(GET_ATAPI_INFO(), pvd->pathTableLocationLE, sectors, pt_raw) == ATA_FAILED) {
+        ISO9660_DROP_PATH_TABLE();
+        pt_loaded = TRUE;
+        return;
+    }
+
+    U32 count = 0;
+    for (U32 pos = 0; pos + sizeof(PathTableEntry) - 1 <= size; ) {
+        PathTableEntry *ent = (PathTableEntry *)(pt_raw + pos);
+        if (ent->nameLength == 0) break;
+        count++;
+        pos += sizeof(PathTableEntry) - 1 + ent->nameLength + (ent->nameLength & 1);
+    }
+    if (count == 0 || count > 0xFFFF) return;
+
+    pt_dirs = KMALLOC(count * sizeof(ISO9660_PT_DIR));
+    if (!pt_dirs) return;
+    MEMZERO(pt_heads, sizeof(pt_heads));
+
+    U32 pos = 0;
+    for (U32 i = 0; i < count; i++) {
+        PathTableEntry *ent = (PathTableEntry *)(pt_raw + pos);
+        ISO9660_PT_DIR *dir = &pt_dirs[i];
+        dir->lba = ent->lbaLocation;
+        dir->name = ent->name;
+        dir->name_len = ent->nameLength;
+        dir->parent = ent->parentDirNum;
+        dir->hash = ISO9660_PT_KEY(dir->parent, dir->name, dir->name_len);
+        U32 bucket = dir->hash & (ISO9660_PT_BUCKETS - 1);
+        dir->next = pt_heads[bucket];
+        pt_heads[bucket] = (U16)(i + 1);
+        pos += sizeof(PathTableEntry) - 1 + ent->nameLength + (ent->nameLength & 1);
+    }
+    pt_count = count;
+}
+
+/* Path table number of directory `name` under `parent`, 0 if absent */
+static U32 ISO9660_PT_FIND(U32 parent, const U8 *name, U32 len) {
+    U32 hash = ISO9660_PT_KEY(parent, name, len);
+    for (U16 i = pt_heads[hash & (ISO9660_PT_BUCKETS - 1)]; i; i = pt_dirs[i - 1].next) {
+        ISO9660_PT_DIR *dir = &pt_dirs[i - 1];
+        if (dir->hash == hash && dir->parent == parent && dir->name_len == len &&
+            MEMCMP(dir->name, name, len) == 0 && i != 1)
+            return i;
+    }
+    return 0;
+}
+
+/* The path table describes the volume of the global PVD only */
+static BOOL ISO9660_PATH_TABLE_READY(IsoDirectoryRecord *root) {
+    if (!pvd || root->extentLocationLE_LBA != pvd->rootDirectoryRecord.extentLocationLE_LBA) return FALSE;
+    if (!pt_loaded) ISO9660_LOAD_PATH_TABLE();
+    return pt_count > 0;
+}
+
+/* Length of the path component starting at `p`, which is `len` bytes long */
+static U32 ISO9660_COMPONENT_LEN(const U8 *p, U32 len) {
+    U32 i = 0;
+    while (i < len && p[i] != '/') i++;
+    return i;
+}
+
+/* Resolves the directory path `path` (`len` bytes, '/' separated) to its extent.
+   `*size` is 0 when it is only known from the directory's "." record. */
+static BOOLEAN ISO9660_RESOLVE_DIR(const U8 *path, U32 len, IsoDirectoryRecord *root, U32 *lba, U32 *size) {
+    *lba = root->extentLocationLE_LBA;
+    *size = root->extentLengthLE;
+
+    if (ISO9660_PATH_TABLE_READY(root)) {
+        U32 num = 1;
+        while (len) {
+            U32 clen = ISO9660_COMPONENT_LEN(path, len);
+            if (clen) {
+                num = ISO9660_PT_FIND(num, path, clen);
+                if (!num) return FALSE;
+                *lba = pt_dirs[num - 1].lba;
+                *size = 0;
             }
+            path += clen;
+            len -= clen;
+            if (len) { path++; len--; }
         }
+        return TRUE;
+    }
 
-        offset += record->length;
+    while (len) {
+        U32 clen = ISO9660_COMPONENT_LEN(path, len);
+        if (clen) {
+            ISO9660_DIR *dir = ISO9660_LOAD_DIR(*lba, *size);
+            if (!dir) return FALSE;
+            IsoDirectoryRecord *record = ISO9660_DIR_FIND(dir, path, clen, TRUE);
+            if (!record) return FALSE;
+            *lba = record->extentLocationLE_LBA;
+            *size = record->extentLengthLE;
+        }
+        path += clen;
+        len -= clen;
+        if (len) { path++; len--; }
     }
-    ISO9660_FREE_MEMORY_INTERNAL(&buffer);
-    return FALSE;
+    return TRUE;
+}
+
+void ISO9660_CACHE_FLUSH(void) {
+    for (U32 i = 0; i < ISO9660_DIR_CACHE_SLOTS; i++)
+        if (dir_cache[i].lba) ISO9660_DROP_DIR(&dir_cache[i]);
+    ISO9660_DROP_PATH_TABLE();
 }
 
 BOOLEAN ISO9660_PATH_TABLE_SEARCH(
@@ -209,83 +446,18 @@ BOOLEAN ISO9660_PATH_TABLE_SEARCH(
     IsoDirectoryRecord *output,
     IsoDirectoryRecord *root
 ) {
-    if(!pvd) return FALSE;
-    U32 path_table_size = pvd->pathTableSizeLE;
-    U32 path_table_loc = pvd->pathTableLocationLE;
-    U32 sectors = ATAPI_CALC_SECTORS(path_table_size);
-    U8 *buf = KMALLOC(path_table_size);
-    if(!buf) return FALSE;
-    MEMZERO(buf, path_table_size);
-    BOOL res = READ_CDROM(GET_ATAPI_INFO(), path_table_loc, sectors, buf);
-    if(!res) {
-        ISO9660_FREE_MEMORY_INTERNAL(&buf);
-        return res;
-    }
-    U8 *target = KMALLOC(STRLEN(original_target) + 1);
-    if (!target) {
-        ISO9660_FREE_MEMORY_INTERNAL(&buf);
-        return FALSE;
-    };
-    MEMZERO(target, STRLEN(original_target) + 1);
-    STRCPY(target, original_target);
-    U8 *slash = (U8 *)STRCHR(target, '/');
-    if (slash) *slash = '\0';
-
-    PathTableEntry *ent = NULLPTR;
-    U32 pos = 0;
-    U32 look_for_parent_id = 1;//root id
-    BOOL found_dir = FALSE;
-    while(1) {
-        ent = (PathTableEntry *)(buf + pos);
+    if (!original_target || !output || !root) return FALSE;
 
-        if (STRNCMP(target, ent->name, ent->nameLength) == 0 &&
-            ent->parentDirNum == look_for_parent_id) {
-            
-            look_for_parent_id = ent->parentDirNum;
-
-            // Check for remaining path
-            CHAR *slash = STRCHR(original_target, '/');
-            if (slash) {
-                U32 remaining = STRLEN(slash + 1);
-                MEMMOVE(original_target, slash + 1, remaining);
-                original_target[remaining] = '\0';
-                MEMCPY(target, original_target, remaining + 1);
-                slash = STRCHR(target, '/');
-                if (slash) *slash = '\0';
-                pos = 0; // restart scanning path table
-            } else {
-                // Last component reached
-                found_dir = TRUE;
-                break;
-            }
-        }
+    U32 len = STRLEN(original_target);
+    if (len >= 2 && original_target[len - 2] == ';' && original_target[len - 1] == '1') len -= 2;
 
-        pos += sizeof(PathTableEntry) - 1 + ent->nameLength;
-        if (ent->nameLength % 2 == 1) pos++;
-        if(pos >= path_table_size) break;
-    }
-    // ISO9660_FREE_MEMORY_INTERNAL(&buf);
-    if (!found_dir && STRLEN(target) == 0) {
-        ISO9660_FREE_MEMORY_INTERNAL(&target);
-        return FALSE;
-    }
-    
-    res = READ_CDROM(GET_ATAPI_INFO(), ent->lbaLocation, 1, buf);
-    if(!res) {
-        ISO9660_FREE_MEMORY_INTERNAL(&target);
-        ISO9660_FREE_MEMORY_INTERNAL(&buf);
-        return FALSE;
-    }
-    MEMCPY(output, buf, sizeof(IsoDirectoryRecord));
-    DUMP_MEMORY(output, sizeof(IsoDirectoryRecord));
-    // ISO9660_FREE_MEMORY_INTERNAL(&buf);
-    HLT;
-    if(STRLEN(target) != 0) {
-        DUMP_MEMORY(buf, ATAPI_SECTOR_SIZE);
-        HLT;
-    }
-    ISO9660_FREE_MEMORY_INTERNAL(&target);
-    ISO9660_FREE_MEMORY_INTERNAL(&buf);
+    U32 lba, size;
+    if (!ISO9660_RESOLVE_DIR((U8 *)original_target, len, root, &lba, &size)) return FALSE;
+    ISO9660_DIR *dir = ISO9660_LOAD_DIR(lba, size);
+    if (!dir) return FALSE;
+
+    // The "." record describes the directory itself
+    MEMCPY(output, dir->data, sizeof(IsoDirectoryRecord));
     return TRUE;
 }
 
@@ -295,31 +467,28 @@ BOOLEAN ISO9660_READ_DIRECTORY_RECORD(
     IsoDirectoryRecord *out_record
 ) {
     if (!path || !root_record || !out_record) return FALSE;
-
-    U32 LBA = root_record->extentLocationLE_LBA;
-    U32 size = root_record->extentLengthLE;
-    if (size == 0 || LBA == 0) return FALSE;
-
-    U32 mod_path_len = STRLEN(path) + 1;
-    U8 *modifiable_path = KMALLOC(mod_path_len);
-    if (!modifiable_path) return FALSE;
-    MEMZERO(modifiable_path, mod_path_len);
-    STRCPY(modifiable_path, path);
-
-    U8 *slash = (U8 *)STRCHR(modifiable_path, '/');
-    if (slash) *slash = '\0';
-
-    *out_record = *root_record;
-
-    BOOLEAN res = ISO9660_READ_FROM_DIRECTORY(
-        LBA,
-        size,
-        (CHAR *)modifiable_path,
-        path,
-        out_record
-    );
-    ISO9660_FREE_MEMORY_INTERNAL(&modifiable_path);
-    return res;
+    if (root_record->extentLengthLE == 0 || root_record->extentLocationLE_LBA == 0) return FALSE;
+
+    U8 *p = (U8 *)path;
+    while (*p == '/') p++;
+    U8 *last = (U8 *)STRRCHR(p, '/');
+    U8 *name = last ? last + 1 : p;
+    U32 name_len = STRLEN(name);
+    if (name_len == 0) return FALSE;
+
+    U32 lba, size;
+    if (!ISO9660_RESOLVE_DIR(p, last ? (U32)(last - p) : 0, root_record, &lba, &size)) return FALSE;
+    ISO9660_DIR *dir = ISO9660_LOAD_DIR(lba, size);
+    if (!dir) return FALSE;
+
+    IsoDirectoryRecord *record = ISO9660_DIR_FIND(dir, name, name_len, FALSE);
+    // Directories carry no ";1" version, which ISO9660_NORMALIZE_PATH appends
+    if (!record && name_len > 2 && name[name_len - 2] == ';' && name[name_len - 1] == '1')
+        record = ISO9660_DIR_FIND(dir, name, name_len - 2, TRUE);
+    if (!record) return FALSE;
+
+    MEMCPY(out_record, record, sizeof(IsoDirectoryRecord));
+    return TRUE;
 }
 
 IsoDirectoryRecord *ISO9660_FILERECORD_TO_MEMORY(CHAR *path) {
@@ -435,41 +604,21 @@ IsoDirectoryRecord **ISO9660_GET_DIR_CONTENTS(IsoDirectoryRecord *dir, BOOLEAN r
     U32 size = dir->extentLengthLE;
     if (lba == 0 || size == 0) return NULLPTR;
     
-    U32 sectors = ISO9660_CALCULATE_SECTORS(size);
-    U8 *buffer = KMALLOC(sectors * ISO9660_SECTOR_SIZE);
-    if (!buffer) return NULLPTR;
-    MEMZERO(buffer, sectors * ISO9660_SECTOR_SIZE);
-
-    if (READ_CDROM(GET_ATAPI_INFO(), lba, sectors, buffer) == ATA_FAILED) {
-        ISO9660_FREE_MEMORY_INTERNAL(&buffer);
-        return NULLPTR;
-    }
+    ISO9660_DIR *cached = ISO9660_LOAD_DIR(lba, size);
+    if (!cached) return NULLPTR;
 
     U32 offset = 0;
     IsoDirectoryRecord **entries = NULL;
     U32 count = 0;
-    while (offset < size) {
-        IsoDirectoryRecord *record = (IsoDirectoryRecord *)(buffer + offset);
-        if (record->length == 0) {
-            offset = ((offset / ISO9660_SECTOR_SIZE) + 1) * ISO9660_SECTOR_SIZE;
-            continue;
-        }
-        if (offset + record->length > size) {
-            break; 
-        }
-        if (record->fileNameLength >= ISO9660_MAX_PATH) 
-        {
-            ISO9660_FREE_MEMORY_INTERNAL(&buffer);
-            return FALSE;
-        }
+    IsoDirectoryRecord *record;
+    while ((record = ISO9660_NEXT_RECORD(cached->data, cached->size, &offset))) {
         if(record->fileNameLength > 2 && record->fileIdentifier[0] != '.' && record->fileIdentifier[1] != '.') 
         {
             // DUMP_STRINGN(record->fileIdentifier, record->fileNameLength);
             IsoDirectoryRecord *copy = KMALLOC(record->length);
             if (!copy) {
                 // Cleanup
-                ISO9660_FREE_LIST_INTERNAL(entries, count);
-                ISO9660_FREE_MEMORY_INTERNAL(&buffer);
+                ISO9660_FREE_LIST_INTERNAL(&entries, count);
                 return NULLPTR;
             }
 
@@ -479,9 +628,8 @@ IsoDirectoryRecord **ISO9660_GET_DIR_CONTENTS(IsoDirectoryRecord *dir, BOOLEAN r
             if (entries == NULL) {
                 tmp = KMALLOC((count + 1) * sizeof(IsoDirectoryRecord *));
                 if (!tmp) {
-                    ISO9660_FREE_LIST_INTERNAL(entries, count);
+                    ISO9660_FREE_LIST_INTERNAL(&entries, count);
                     ISO9660_FREE_MEMORY_INTERNAL(&copy);
-                    ISO9660_FREE_MEMORY_INTERNAL(&buffer);
                     return NULLPTR;
                 }
                 MEMZERO(tmp, (count) * sizeof(IsoDirectoryRecord *));
@@ -490,9 +638,8 @@ IsoDirectoryRecord **ISO9660_GET_DIR_CONTENTS(IsoDirectoryRecord *dir, BOOLEAN r
                 // Use your KREALLOC correctly
                 tmp = (IsoDirectoryRecord **)KREALLOC(entries, (count + 1) * sizeof(IsoDirectoryRecord *));
                 if (!tmp) {
-                    ISO9660_FREE_LIST_INTERNAL(entries, count);
+                    ISO9660_FREE_LIST_INTERNAL(&entries, count);
                     ISO9660_FREE_MEMORY_INTERNAL(&copy);
-                    ISO9660_FREE_MEMORY_INTERNAL(&buffer);
                     return NULLPTR;
                 }
                 entries = tmp;
@@ -501,7 +648,6 @@ IsoDirectoryRecord **ISO9660_GET_DIR_CONTENTS(IsoDirectoryRecord *dir, BOOLEAN r
         }
         offset += record->length;
     }
-    ISO9660_FREE_MEMORY_INTERNAL(&buffer);
     *size_out = count;
     *success = TRUE;
     // DUMP_INTNO(count);
@@ -17,6 +17,10 @@ for only definitions
 #define ISO9660_MAX_FULLNAME_LENGTH (ISO9660_MAX_FILENAME_LENGTH + 1 + ISO9660_MAX_EXTENSION_LENGTH + 2) // including . and ;1
 #define ISO9660_MAX_DIR_RECORDS 64 // Max records in a directory. Practically could be more, but we limit it for simplicity
 #define ISO9660_FILE_FLAG_DIRECTORY 0b00000010
+#define ISO9660_DIR_CACHE_SLOTS 16 // Cached directory extents (LRU)
+#define ISO9660_NAME_BUCKETS 32 // Name hash buckets per cached directory, power of two
+#define ISO9660_PT_BUCKETS 256 // Path table hash buckets, power of two
+#define ISO9660_MAX_DIR_EXTENT (1024 * 1024) // Larger directories/path tables are rejected
 
 typedef U8 strD;
 typedef U8 strA;
@@ -184,6 +188,19 @@ void ISO9660_EXTRACT_ROOT_FROM_PVD(PrimaryVolumeDescriptor *pvd, IsoDirectoryRec
 /// @return TRUE if successful, FALSE otherwise.
 BOOLEAN ISO9660_READ_DIRECTORY_RECORD(CHAR *path, IsoDirectoryRecord *root_record, IsoDirectoryRecord *out_record);
 
+/// @brief Resolve a directory path through the path table.
+/// @param original_target Directory path, e.g. "ATOS/BIN" (a trailing ";1" is ignored).
+/// @param output Filled with the directory's "." record.
+/// @param root Root record of the volume.
+/// @return TRUE if the directory exists.
+/// @note Directories are resolved from the path table when `root` belongs to the
+///       volume of the cached PVD, otherwise by walking cached directory extents.
+BOOLEAN ISO9660_PATH_TABLE_SEARCH(CHAR *original_target, IsoDirectoryRecord *output, IsoDirectoryRecord *root);
+
+/// @brief Drop every cached directory extent and the parsed path table.
+/// @note Directory extents are cached by LBA after the first read; call this if the medium changes.
+void ISO9660_CACHE_FLUSH(void);
+
 /// @brief Reads file record from the ISO9660 image into memory.
 /// @param path Path inside the ISO9660 image, formatted inside the function
 /// @return Pointer to the allocated buffer containing the file data, or NULLPTR on failure.
@@ -0,0 +1,173 @@
+#include <MEMORY/BUDDY/BUDDY.h>
+
+static inline U32 pages_of(U32 order) {
+    return 1u << order;
+}
+
+static VOID push(BUDDY_POOL *p, U32 rel, U32 order) {
+    U32 h = p->head[order];
+    p->next[rel] = h;
+    p->prev[rel] = BUDDY_NONE;
+    if (h != BUDDY_NONE) p->prev[h] = rel;
+    p->head[order] = rel;
+    p->order[rel] = BUDDY_FREE_HEAD | order;
+    p->blocks[order]++;
+    p->free_frames += pages_of(order);
+}
+
+static VOID unlink(BUDDY_POOL *p, U32 rel, U32 order) {
+    U32 n = p->next[rel], pr = p->prev[rel];
+    if (pr != BUDDY_NONE) p->next[pr] = n;
+    else p->head[order] = n;
+    if (n != BUDDY_NONE) p->prev[n] = pr;
+    p->order[rel] = 0;
+    p->blocks[order]--;
+    p->free_frames -= pages_of(order);
+}
+
+// Frees one aligned block, merging it upwards while its buddy is free
+static VOID free_block(BUDDY_POOL *p, U32 rel, U32 order) {
+    while (order < BUDDY_MAX_ORDER) {
+        U32 buddy = rel ^ pages_of(order);
+        if (buddy + pages_of(order) > p->frames) break;
+        if (p->order[buddy] != (BUDDY_FREE_HEAD | order)) break;
+        unlink(p, buddy, order);
+        rel &= ~pages_of(order);
+        order++;
+    }
+    push(p, rel, order);
+}
+
+// Largest order whose block at `rel` is aligned and no longer than `count`
+static U32 fit_order(U32 rel, U32 count) {
+    U32 order = 0;
+    while (order < BUDDY_MAX_ORDER && !(rel & pages_of(order)) && pages_of(order + 1) <= count) order++;
+    return order;
+}
+
+static VOID free_run(BUDDY_POOL *p, U32 rel, U32 count) {
+    while (count) {
+        U32 order = fit_order(rel, count);
+        free_block(p, rel, order);
+        rel += pages_of(order);
+        count -= pages_of(order);
+    }
+}
+
+// The free block holding `rel`, found by trying every alignment
+static BOOLEAN find_block(BUDDY_POOL *p, U32 rel, U32 *head, U32 *order) {
+    for (U32 o = 0; o <= BUDDY_MAX_ORDER; o++) {
+        U32 h = rel & ~(pages_of(o) - 1);
+        if (p->order[h] == (BUDDY_FREE_HEAD | o)) {
+            *head = h;
+            *order = o;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Whether a free block ends right before `rel`
+static BOOLEAN free_before(BUDDY_POOL *p, U32 rel) {
+    for (U32 o = 0; o <= BUDDY_MAX_ORDER && pages_of(o) <= rel; o++) {
+        U32 h = rel - pages_of(o);
+        if (!(h & (pages_of(o) - 1)) && p->order[h] == (BUDDY_FREE_HEAD | o)) return TRUE;
+    }
+    return FALSE;
+}
+
+// Free frames from `rel` on. Blocks never overlap, so a free frame right
+// after a free block is the head of the next one
+static U32 run_length(BUDDY_POOL *p, U32 rel) {
+    U32 len = 0;
+    while (rel < p->frames && (p->order[rel] & BUDDY_FREE_HEAD)) {
+        U32 n = pages_of(p->order[rel] & ~BUDDY_FREE_HEAD);
+        len += n;
+        rel += n;
+    }
+    return len;
+}
+
+static inline BOOLEAN in_pool(BUDDY_POOL *p, U32 frame, U32 count) {
+    return frame >= p->base && count <= p->frames && frame - p->base <= p->frames - count;
+}
+
+VOID BUDDY_INIT(BUDDY_POOL *p, U32 base, U32 frames, VOIDPTR meta) {
+    p->base = base;
+    p->frames = frames;
+    p->next = (U32 *)meta;
+    p->prev = p->next + frames;
+    p->order = (U8 *)(p->prev + frames);
+    for (U32 i = 0; i < frames; i++) p->order[i] = 0;
+    for (U32 o = 0; o <= BUDDY_MAX_ORDER; o++) {
+        p->head[o] = BUDDY_NONE;
+        p->blocks[o] = 0;
+    }
+    p->free_frames = 0;
+}
+
+U32 BUDDY_ALLOC(BUDDY_POOL *p, U32 count) {
+    if (!count || count > pages_of(BUDDY_MAX_ORDER)) return BUDDY_NONE;
+    U32 want = 0;
+    while (pages_of(want) < count) want++;
+    U32 order = want;
+    while (order <= BUDDY_MAX_ORDER && p->head[order] == BUDDY_NONE) order++;
+    if (order > BUDDY_MAX_ORDER) return BUDDY_NONE;
+
+    U32 rel = p->head[order];
+    unlink(p, rel, order);
+    while (order > want) {
+        order--;
+        push(p, rel + pages_of(order), order);
+    }
+    if (pages_of(want) > count) free_run(p, rel + count, pages_of(want) - count);
+    return p->base + rel;
+}
+
+VOID BUDDY_FREE(BUDDY_POOL *p, U32 frame, U32 count) {
+    if (!count || !in_pool(p, frame, count)) return;
+    free_run(p, frame - p->base, count);
+}
+
+BOOLEAN BUDDY_TAKE(BUDDY_POOL *p, U32 frame, U32 count) {
+    if (!in_pool(p, frame, count)) return FALSE;
+    U32 rel = frame - p->base, end = rel + count;
+    while (rel < end) {
+        U32 head, order;
+        if (!find_block(p, rel, &head, &order)) return FALSE;
+        unlink(p, head, order);
+        U32 block_end = head + pages_of(order);
+        if (head < rel) free_run(p, head, rel - head);
+        if (block_end > end) free_run(p, end, block_end - end);
+        rel = block_end;
+    }
+    return TRUE;
+}
+
+U32 BUDDY_FIND_RUN(BUDDY_POOL *p, U32 count) {
+    U32 best = BUDDY_NONE, best_len = 0;
+    if (!count) return BUDDY_NONE;
+    for (U32 o = 0; o <= BUDDY_MAX_ORDER; o++) {
+        for (U32 h = p->head[o]; h != BUDDY_NONE; h = p->next[h]) {
+            if (free_before(p, h)) continue;
+            U32 len = run_length(p, h);
+            if (len < count || (best != BUDDY_NONE && len >= best_len)) continue;
+            best = h;
+            best_len = len;
+            if (len == count) return p->base + best;
+        }
+    }
+    return best == BUDDY_NONE ? BUDDY_NONE : p->base + best;
+}
+
+BOOLEAN BUDDY_IS_FREE(BUDDY_POOL *p, U32 frame) {
+    U32 head, order;
+    return in_pool(p, frame, 1) && find_block(p, frame - p->base, &head, &order);
+}
+
+U32 BUDDY_LARGEST_FREE(BUDDY_POOL *p) {
+    for (I32 o = BUDDY_MAX_ORDER; o >= 0; o--) {
+        if (p->head[o] != BUDDY_NONE) return pages_of((U32)o);
+    }
+    return 0;
+}
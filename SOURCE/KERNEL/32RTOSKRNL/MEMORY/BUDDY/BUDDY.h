@@ -0,0 +1,80 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/MEMORY/BUDDY/BUDDY.h - Binary buddy allocator for page frames
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Tracks the free frames of one range of physical memory as aligned
+    blocks of 2^order frames, one free list per order. Allocating pops a
+    block of the smallest order that fits and splits it; freeing merges a
+    block with its buddy for as long as the buddy is free too. Both are
+    O(BUDDY_MAX_ORDER).
+
+    Runs need not be powers of two: BUDDY_ALLOC returns the part of the
+    block past `count` straight away, and BUDDY_FREE takes any run and
+    frees it as the largest aligned blocks it holds. Rounding up still
+    pins the block's alignment, so BUDDY_FIND_RUN also places a run across
+    adjacent free blocks, at O(free blocks).
+
+    The pool keeps no per-frame state beyond its free lists. PAGEFRAME
+    still owns the page states in its bytemap and calls in here for the
+    user pool (PS_FUSER / PS_AUSER).
+
+REMARKS
+    Frame numbers are physical addresses / PAGE_SIZE. Depends on nothing
+    but STD/TYPEDEF.h, so TESTS/test_buddy.c builds it for the host.
+---*/
+#ifndef BUDDY_H
+#define BUDDY_H
+
+#include <STD/TYPEDEF.h>
+
+#define BUDDY_MAX_ORDER 16          // largest block, 2^16 frames = 256 MiB
+#define BUDDY_NONE      0xFFFFFFFF  // no frame / empty list
+
+// Metadata BUDDY_INIT needs for a pool of `frames` frames
+#define BUDDY_META_BYTES(frames) ((frames) * (2 * sizeof(U32) + 1))
+
+typedef struct {
+    U32 base;                           // first frame of the pool
+    U32 frames;
+    U32 *next;                          // free list links, by frame - base
+    U32 *prev;
+    U8 *order;                          // BUDDY_FREE_HEAD | order at the first frame of a free block
+    U32 head[BUDDY_MAX_ORDER + 1];      // free lists
+    U32 blocks[BUDDY_MAX_ORDER + 1];    // free blocks per order
+    U32 free_frames;
+} BUDDY_POOL;
+
+#define BUDDY_FREE_HEAD 0x80
+
+/// Sets up an empty pool over frames [base, base + frames); hand it free
+/// frames with BUDDY_FREE. `meta` holds BUDDY_META_BYTES(frames).
+VOID BUDDY_INIT(BUDDY_POOL *p, U32 base, U32 frames, VOIDPTR meta);
+
+/// @return First frame of `count` contiguous free frames, BUDDY_NONE if
+/// no free block of the next power of two is left.
+U32 BUDDY_ALLOC(BUDDY_POOL *p, U32 count);
+
+/// Returns [frame, frame + count) to the pool. The frames must not be free.
+VOID BUDDY_FREE(BUDDY_POOL *p, U32 frame, U32 count);
+
+/// Takes [frame, frame + count) out of the free lists, for runs found
+/// some other way. @return FALSE if a frame of it was not free.
+BOOLEAN BUDDY_TAKE(BUDDY_POOL *p, U32 frame, U32 count);
+
+/// Best fit over the runs of adjacent free blocks, for counts that would
+/// waste most of a rounded-up block. Walks every free block, so it costs
+/// O(free blocks) rather than O(BUDDY_MAX_ORDER); carve the run out with
+/// BUDDY_TAKE. @return First frame of the shortest run of at least
+/// `count` free frames, BUDDY_NONE if there is none.
+U32 BUDDY_FIND_RUN(BUDDY_POOL *p, U32 count);
+
+BOOLEAN BUDDY_IS_FREE(BUDDY_POOL *p, U32 frame);
+
+/// @return Frames in the largest free block, 0 if the pool is full
+U32 BUDDY_LARGEST_FREE(BUDDY_POOL *p);
+
+#endif // BUDDY_H
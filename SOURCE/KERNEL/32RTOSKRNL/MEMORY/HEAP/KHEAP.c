@@ -7,6 +7,7 @@
 #include <STD/ASM.h>
 #include <STD/ASSERT.h>
 #include <PROC/PROC.h>
+#include <DEBUG/TRACE.h>
 
 /*+++
 
@@ -284,6 +285,7 @@ have_fit:
 
         /* Return pointer to payload area */
         get_current_tcb()->info.heap_allocated += block->real_size;
+        TRACE(TRACE_EV_KMALLOC, (U8*)block + sizeof(KHeapBlock), size, 0);
         return (VOIDPTR)((U8*)block + sizeof(KHeapBlock));
     }
 
@@ -328,6 +330,7 @@ VOID KFREE(VOIDPTR ptr) {
     kernelHeap.freeSize += current_block->real_size;
     get_current_tcb()->info.heap_allocated -= current_block->real_size;
     current_block->size = 0;
+    TRACE(TRACE_EV_KFREE, ptr, current_block->real_size, 0);
 
     block_to_merge_from = current_block;
 
@@ -76,6 +76,14 @@
 #define MEM_LIBRARY_BASE              0x20000000   // Base address for dynamic libraries
 #define MEM_LIBRARY_END               0x30000000   // End of library area (256 MiB for libraries)
 
+// ----------------------------------------------------------
+// Shared Memory Window (RTOSKRNL/SHM)
+// ----------------------------------------------------------
+// Regions mapped into several processes at the same address. Sits above the
+// RAM a typical atOS machine has; SHM stays off if the kernel maps RAM here
+#define MEM_SHARED_BASE               0xC0000000
+#define MEM_SHARED_END                0xD0000000   // 256 MiB, up to KERNEL_VIRT_ALLOC_BASE
+
 // ----------------------------------------------------------
 // System Memory Limits
 // ----------------------------------------------------------
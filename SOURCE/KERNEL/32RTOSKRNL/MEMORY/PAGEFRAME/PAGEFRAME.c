@@ -6,6 +6,7 @@
 #include <STD/BINARY.h>
 #include <STD/ASM.h>
 #include <MEMORY/BYTEMAP/BYTEMAP.h>
+#include <MEMORY/BUDDY/BUDDY.h>
 #include <VESA/VBE.h>
 #include <RTOSKRNL/RTOSKRNL_INTERNAL.h>
 #include <STD/MATH.h>
@@ -19,6 +20,9 @@ static BYTEMAP pageFrameBytemap __attribute__((section(".data"))) = {0, 0};
 static PAGEFRAME_INFO pageFrameInfo __attribute__((section(".data"))) = {0, 0, 0, 0, FALSE};
 static U8 bytemapData[MAX_BYTEMAP_SIZE] __attribute__((section(".data"))) = {0}; // enough for largest physical memory
 static U32 next_kernel_virt __attribute__((section(".data"))) = KERNEL_VIRT_ALLOC_BASE;
+// Free user frames by block size, so runs for new processes do not need a
+// bytemap scan. Empty (frames == 0) when no RAM reaches the user window
+static BUDDY_POOL userPool __attribute__((section(".data"))) = {0};
 PAGEFRAME_INFO* GET_PAGEFRAME_INFO() {
     return &pageFrameInfo;
 }
@@ -99,7 +103,7 @@ BOOLEAN CREATE_PAGEFRAME_BYTEMAP() {
     set_range((U32)MEM_RTOSKRNL_BASE, (U32)MEM_RTOSKRNL_END, PS_FREE, PS_RESERVED); // kernel itself
     set_range(E820_TABLE_PHYS, E820_TABLE_END, PS_FREE, PS_RESERVED);         // E820 table
     set_range(MEM_VESA_BASE, VBE_MODE_LOAD_ADDRESS_PHYS + sizeof(VBE_MODEINFO), PS_FREE, PS_RESERVED);
-    set_range(vbe->PhysBasePtr, vbe->PhysBasePtr + (vbe->YResolution * vbe->BytesPerScanLineLinear), PS_FREE, PS_RESERVED); // VESA framebuffer
+    set_range(vbe->PhysBasePtr, vbe->PhysBasePtr + VBE_LFB_SIZE(), PS_FREE, PS_RESERVED); // VESA framebuffer, both flip pages
     set_range(MEM_FRAMEBUFFER_BASE, MEM_FRAMEBUFFER_END, PS_FREE, PS_RESERVED); // video buffer
     set_range(MEM_KERNEL_HEAP_BASE, MEM_KERNEL_HEAP_END, PS_FREE, PS_RESERVED); // kernel heap
     set_range(MEM_BIOS_BASE, MEM_BIOS_END, PS_FREE, PS_RESERVED);
@@ -148,6 +152,43 @@ BOOLEAN CREATE_PAGEFRAME() {
     return TRUE;
 }
 
+ADDR REQUEST_PAGES_RAW(U32 numPages, U32 look_for, U32 set_to);
+
+// Builds the user pool from the E820 RAM entries inside the user window.
+// Its free lists live in kernel pages, identity mapped like all E820 RAM
+BOOLEAN CREATE_USER_POOL() {
+    U32 first = MEM_USER_SPACE_BASE / PAGE_SIZE;
+    U32 end = MEM_USER_SPACE_END_MIN / PAGE_SIZE;
+    if (end > pageFrameBytemap.size) end = pageFrameBytemap.size;
+    if (first >= end) return TRUE; // not enough RAM for a user window
+
+    U32 frames = end - first;
+    ADDR meta = REQUEST_PAGES_RAW(pages_from_bytes(BUDDY_META_BYTES(frames)), PS_FREE, PS_ALLOC);
+    if (!meta) return FALSE;
+    BUDDY_INIT(&userPool, first, frames, (VOIDPTR)meta);
+
+    E820Info *e820 = GET_E820_INFO();
+    for (U32 i = 0; i < e820->RawEntryCount; i++) {
+        E820_ENTRY *entry = &e820->RawEntries[i];
+        if (entry->Type != TYPE_E820_RAM) continue;
+        U32 f = page_align_up(entry->BaseAddressLow) / PAGE_SIZE;
+        U32 last = page_align_down(entry->BaseAddressLow + entry->LengthLow) / PAGE_SIZE;
+        if (f < first) f = first;
+        if (last > end) last = end;
+
+        // Entries may overlap, and the bytemap has the final word on
+        // which frames are free
+        while (f < last) {
+            U32 run = 0;
+            while (f + run < last && BYTEMAP_GET(&pageFrameBytemap, f + run) == PS_FUSER &&
+                   !BUDDY_IS_FREE(&userPool, f + run)) run++;
+            if (run) BUDDY_FREE(&userPool, f, run);
+            f += run ? run : 1;
+        }
+    }
+    return TRUE;
+}
+
 BOOLEAN PAGEFRAME_INIT() {
     if (pageFrameInfo.initialized) {
         return TRUE; // Already initialized
@@ -158,6 +199,9 @@ BOOLEAN PAGEFRAME_INIT() {
     if(!CREATE_PAGEFRAME()) {
         return FALSE;
     }
+    if(!CREATE_USER_POOL()) {
+        return FALSE;
+    }
     pageFrameInfo.initialized = TRUE;
     return TRUE;
 }
@@ -238,23 +282,23 @@ ADDR REQUEST_PAGES_RAW(U32 numPages, U32 look_for, U32 set_to) {
 }
 
 
-VOID FREE_PS_RAW(ADDR addr, U32 set_to) {
+BOOLEAN FREE_PS_RAW(ADDR addr, U32 set_to) {
     BYTEMAP *bm = &pageFrameBytemap;
     PAGEFRAME_INFO *info = &pageFrameInfo;
 
     U32 pageIndex = addr / PAGE_SIZE;
     if (pageIndex >= bm->size) {
-        return; // Out of bounds
+        return FALSE; // Out of bounds
     }
     PageState state = BYTEMAP_GET(bm, pageIndex);
     if (state == set_to) {
         SET_ERROR_CODE(ERROR_DOUBLE_PAGE_FREE);
-        return; // Already free
+        return FALSE; // Already free
     }
     if (state == PS_RESERVED || state == PS_LOCKED) {
         SET_ERROR_CODE(state == PS_LOCKED ? ERROR_FREEING_OF_LOCKED_PAGE
                                           : ERROR_FREEING_OF_RESERVED_PAGE);
-        return; // Cannot free reserved or locked page
+        return FALSE; // Cannot free reserved or locked page
     }
     BYTEMAP_SET(bm, pageIndex, set_to); // Mark as free
     info->freeMemory += PAGE_SIZE;
@@ -262,6 +306,7 @@ VOID FREE_PS_RAW(ADDR addr, U32 set_to) {
     if (pageIndex < info->pIndex) {
         info->pIndex = pageIndex; // Update pIndex for next search
     }
+    return TRUE;
 }
 
 VOID RESET_PAGEINDEX() {
@@ -332,19 +377,46 @@ VOID KFREE_PAGES(ADDR addr, U32 numPages) {
     }
 }
 
+// User frames come from the buddy pool. A power of two is one block. Any
+// other count would pin a whole rounded-up block (a ~1830 page process
+// image takes 2048, and only 32 of those fit the window), so it goes to the
+// best-fit run search, which packs it against its neighbours. The pool holds
+// every PS_FUSER frame, so the bytemap scan is only for when there is no pool
 ADDR KREQUEST_USER_PAGES(U32 numPages) {
-    return REQUEST_PAGES_RAW(numPages, PS_FUSER, PS_AUSER);
+    if (numPages == 0) return 0;
+    if (!userPool.frames) return REQUEST_PAGES_RAW(numPages, PS_FUSER, PS_AUSER);
+
+    U32 frame = BUDDY_NONE;
+    if (is_power_of_two(numPages)) frame = BUDDY_ALLOC(&userPool, numPages);
+    if (frame == BUDDY_NONE) {
+        frame = BUDDY_FIND_RUN(&userPool, numPages);
+        if (frame == BUDDY_NONE || !BUDDY_TAKE(&userPool, frame, numPages)) return 0;
+    }
+    for (U32 i = 0; i < numPages; i++) {
+        BYTEMAP_SET(&pageFrameBytemap, frame + i, PS_AUSER);
+    }
+    pageFrameInfo.freeMemory -= numPages * PAGE_SIZE;
+    pageFrameInfo.usedMemory += numPages * PAGE_SIZE;
+    return frame * PAGE_SIZE;
 }
 
 ADDR KREQUEST_USER_PAGE() {
-    return REQUEST_PAGE_RAW(PS_FUSER, PS_AUSER);
+    return KREQUEST_USER_PAGES(1);
 }
 VOID KFREE_USER_PAGE(ADDR addr) {
-    FREE_PS_RAW(addr, PS_FUSER);
+    KFREE_USER_PAGES(addr, 1);
 }
+// Frees page by page in the bytemap, which rejects double frees, and hands
+// each run that was really freed back to the pool in one go
 VOID KFREE_USER_PAGES(ADDR addr, U32 numPages) {
-    for (U32 i = 0; i < numPages; i++) {
-        KFREE_USER_PAGE(addr + (i * PAGE_SIZE));
+    U32 run = 0;
+    for (U32 i = 0; i <= numPages; i++) {
+        if (i < numPages && FREE_PS_RAW(addr + (i * PAGE_SIZE), PS_FUSER)) {
+            run++;
+            continue;
+        }
+        if (run && userPool.frames) BUDDY_FREE(&userPool, addr / PAGE_SIZE + i - run, run);
+        run = 0;
     }
 }
 
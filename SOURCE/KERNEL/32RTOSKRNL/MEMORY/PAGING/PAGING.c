@@ -22,22 +22,95 @@ ADDR *get_page_directory(VOID) {
 }
 
 
-void identity_map_range(U32 *pd, U32 start, U32 end, U32 flags) {
-    // inclusive start, exclusive end; page-align
-    U32 s = start & ~0xFFF;
-    U32 e = (end + 0xFFF) & ~0xFFF;
-    for (U32 addr = s; addr < e; addr += PAGE_SIZE) {
-        map_page(pd, addr, addr, flags);
+// Flags a 4 MB PDE keeps when it is split or compared. Bit 7 is PS there
+// but PAT in a PTE, so it never carries over.
+#define LARGE_PDE_FLAGS (PAGE_PRESENT | PAGE_READ_WRITE | PAGE_USER | PAGE_WRITETHRU | PAGE_CACHEDIS | PAGE_GLOBAL)
+
+static U32 paging_features __attribute__((section(".data"))) = 0;
+
+U32 PAGING_FEATURES(VOID) {
+    return paging_features;
+}
+
+static inline U32 large_pde(U32 phys, U32 flags) {
+    return (phys & ~LARGE_PAGE_MASK) | (flags & LARGE_PDE_FLAGS) | PAGE_4MB;
+}
+
+// Replaces the 4 MB page at pd[pd_index] with a page table mapping the
+// same frames, so single pages in it can be changed
+static void split_large_page(U32 *pd, U32 pd_index) {
+    U32 pde = pd[pd_index];
+    U32 pt_phys = (U32)KREQUEST_PAGE();
+    panic_if(!pt_phys, PANIC_TEXT("Failed to allocate page table"), PANIC_OUT_OF_MEMORY);
+
+    U32 *pt = (U32 *)phys_to_virt_pd(pt_phys);
+    U32 base = pde & ~LARGE_PAGE_MASK;
+    U32 flags = pde & LARGE_PDE_FLAGS;
+    for (U32 i = 0; i < PAGE_ENTRIES; i++) {
+        pt[i] = (base + i * PAGE_SIZE) | flags;
     }
+    pd[pd_index] = pt_phys | PAGE_PRESENT | PAGE_READ_WRITE | (pde & PAGE_USER);
+
+    // One invlpg drops the whole large TLB entry, global or not
+    ASM_VOLATILE("invlpg (%0)" : : "r"(pd_index << 22) : "memory");
+}
+
+void map_range(U32 *pd, U32 virt, U32 phys, U32 size, U32 flags) {
+    U32 v = virt & ~0xFFF;
+    U32 p = phys & ~0xFFF;
+    U32 pages = ((phys & 0xFFF) + size + 0xFFF) / PAGE_SIZE;
+    BOOLEAN large = (paging_features & PAGING_FEATURE_PSE) != 0;
+
+    for (U32 i = 0; i < pages;) {
+        U32 va = v + i * PAGE_SIZE;
+        U32 pa = p + i * PAGE_SIZE;
+        U32 pd_index = va >> 22;
+        if (large && !((va | pa) & LARGE_PAGE_MASK) && pages - i >= PAGE_ENTRIES &&
+            (!(pd[pd_index] & PAGE_PRESENT) || pd[pd_index] == large_pde(pa, flags))) {
+            pd[pd_index] = large_pde(pa, flags);
+            ASM_VOLATILE("invlpg (%0)" : : "r"(va) : "memory");
+            i += PAGE_ENTRIES;
+            continue;
+        }
+        map_page(pd, va, pa, flags);
+        i++;
+    }
+}
+
+void PAGING_SET_CACHING(U32 *pd, U32 start, U32 end, U32 cache) {
+    U32 bits = PAGE_WRITETHRU | PAGE_CACHEDIS;
+    cache &= bits;
+    for (U32 va = start & ~0xFFF; va < end && va >= (start & ~0xFFF);) {
+        U32 *pde = &pd[va >> 22];
+        if (!(*pde & PAGE_PRESENT)) {
+            va = (va & ~LARGE_PAGE_MASK) + LARGE_PAGE_SIZE;
+            continue;
+        }
+        if (*pde & PAGE_4MB) {
+            *pde = (*pde & ~bits) | cache;
+            ASM_VOLATILE("invlpg (%0)" : : "r"(va) : "memory");
+            va = (va & ~LARGE_PAGE_MASK) + LARGE_PAGE_SIZE;
+            continue;
+        }
+        U32 *pte = &((U32 *)phys_to_virt_pd(*pde & ~0xFFF))[(va >> 12) & 0x3FF];
+        if (*pte & PAGE_PRESENT) {
+            *pte = (*pte & ~bits) | cache;
+            ASM_VOLATILE("invlpg (%0)" : : "r"(va) : "memory");
+        }
+        va += PAGE_SIZE;
+    }
+}
+
+void identity_map_range(U32 *pd, U32 start, U32 end, U32 flags) {
+    identity_map_range_with_offset(pd, start, end, 0, flags);
 }
 
 void identity_map_range_with_offset(U32 *pd, U32 start, U32 end, U32 offset, U32 flags) {
     // inclusive start, exclusive end; page-align
     U32 s = start & ~0xFFF;
     U32 e = (end + 0xFFF) & ~0xFFF;
-    for (U32 addr = s; addr < e; addr += PAGE_SIZE) {
-        map_page(pd, addr + offset, addr, flags);
-    }
+    if (e <= s) return;
+    map_range(pd, s + offset, s, e - s, flags);
 }
 
 // Load CR3 with page directory physical address
@@ -45,11 +118,40 @@ VOID load_page_directory(ADDR phys_addr) {
     ASM_VOLATILE("mov %0, %%cr3" : : "r"(phys_addr) : "memory");
 }
 
+#if PAGING_LARGE_PAGES
+static BOOLEAN cpu_has(U32 edx_bit) {
+    U32 a, b, c, d;
+    ASM_VOLATILE("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(1));
+    return (d & edx_bit) != 0;
+}
+#endif
+
+static VOID set_cr4(U32 bits) {
+    U32 cr4;
+    ASM_VOLATILE("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= bits;
+    ASM_VOLATILE("mov %0, %%cr4" : : "r"(cr4) : "memory");
+}
+
+// Kernel ranges look the same in every page directory, so their TLB
+// entries may outlive a CR3 load. The user window (USER_PDE..USER_PDE_END)
+// is remapped by each process and stays non-global.
+static void identity_map_kernel(U32 start, U32 end) {
+    U32 g = (paging_features & PAGING_FEATURE_PGE) ? PAGE_GLOBAL : 0;
+    U32 lo = USER_PDE << 22;
+    U32 hi = (USER_PDE_END + 1) << 22;
+    if (end <= start) return;
+    if (start < lo) identity_map_range(page_directory, start, end < lo ? end : lo, PAGE_PRW | g);
+    if (start < hi && end > lo) identity_map_range(page_directory, start > lo ? start : lo, end < hi ? end : hi, PAGE_PRW);
+    if (end > hi) identity_map_range(page_directory, start > hi ? start : hi, end, PAGE_PRW | g);
+}
+
 // Enable paging by setting CR0.PG
 VOID enable_paging(VOID) {
     U32 cr0;
     ASM_VOLATILE("mov %%cr0, %0" : "=r"(cr0));
     cr0 |= 0x80000000; // Set PG
+    cr0 |= 0x00010000; // Set WP: processes run in ring 0, read-only pages must hold for them too
     ASM_VOLATILE("mov %0, %%cr0" : : "r"(cr0) : "memory");
 }
 
@@ -87,6 +189,13 @@ BOOLEAN PAGING_INIT(void) {
     panic_if(STACK_0_BASE < PAGE_SIZE,
             PANIC_TEXT("Stack base too low for guard page"), PANIC_INVALID_STATE);
 
+#if PAGING_LARGE_PAGES
+    // CR4.PSE before the first 4 MB PDE is loaded, CR4.PGE once paging is on
+    if (cpu_has(1 << 3)) paging_features |= PAGING_FEATURE_PSE;
+    if (cpu_has(1 << 13)) paging_features |= PAGING_FEATURE_PGE;
+    if (paging_features & PAGING_FEATURE_PSE) set_cr4(1 << 4);
+#endif
+
     // Identity-map all memory reported by E820
     E820Info *e820_entries = GET_E820_INFO();
     panic_if(!e820_entries || e820_entries->RawEntryCount == 0,
@@ -94,29 +203,35 @@ BOOLEAN PAGING_INIT(void) {
     for (U32 i = 0; i < e820_entries->RawEntryCount; i++) {
         E820_ENTRY *e = &e820_entries->RawEntries[i];
         if (e->Type == TYPE_E820_RAM) { // usable RAM
-            identity_map_range(page_directory, e->BaseAddressLow, e->BaseAddressLow + e->LengthLow, PAGE_PRW);
+            identity_map_kernel(e->BaseAddressLow, e->BaseAddressLow + e->LengthLow);
         }
     }
 
     // NOTE: If you map new ranges, add to PROC.c identity_map_range calls too!
-    identity_map_range(page_directory, MEM_LOW_RESERVED_BASE, MEM_LOW_RESERVED_END, PAGE_PRW);
-    identity_map_range(page_directory, MEM_E820_BASE,          MEM_E820_END,          PAGE_PRW);
-    identity_map_range(page_directory, MEM_VESA_BASE,          MEM_VESA_END,          PAGE_PRW);
+    identity_map_kernel(MEM_LOW_RESERVED_BASE, MEM_LOW_RESERVED_END);
+    identity_map_kernel(MEM_E820_BASE,         MEM_E820_END);
+    identity_map_kernel(MEM_VESA_BASE,         MEM_VESA_END);
     VBE_MODEINFO *vmi = GET_VBE_MODE();
     if(vmi && vmi->PhysBasePtr && vmi->XResolution && vmi->YResolution && vmi->BitsPerPixel) {
         U32 fb_start = vmi->PhysBasePtr;
-        U32 fb_size = vmi->YResolution * vmi->BytesPerScanLine;
+        U32 fb_size = VBE_LFB_SIZE();
         U32 fb_end = fb_start + fb_size;
-        identity_map_range(page_directory, fb_start, fb_end, PAGE_PRW);
+        // Round up to whole 4 MB pages as far as video memory goes
+        U32 vram_end = fb_start + GET_VESA_INFO()->TotalMemory * 0x10000;
+        U32 fb_large_end = (fb_end + LARGE_PAGE_MASK) & ~LARGE_PAGE_MASK;
+        if ((paging_features & PAGING_FEATURE_PSE) && fb_large_end > fb_end && fb_large_end <= vram_end)
+            fb_end = fb_large_end;
+        identity_map_kernel(fb_start, fb_end);
     }
-    identity_map_range(page_directory, MEM_RTOSKRNL_BASE,      MEM_RTOSKRNL_END,      PAGE_PRW);
-    identity_map_range(page_directory, MEM_KERNEL_HEAP_BASE,   MEM_KERNEL_HEAP_END,   PAGE_PRW);
-    identity_map_range(page_directory, STACK_0_BASE,           STACK_0_END,           PAGE_PRW);
-    identity_map_range(page_directory, MEM_FRAMEBUFFER_BASE,   MEM_FRAMEBUFFER_END,   PAGE_PRW);
+    identity_map_kernel(MEM_RTOSKRNL_BASE,     MEM_RTOSKRNL_END);
+    identity_map_kernel(MEM_KERNEL_HEAP_BASE,  MEM_KERNEL_HEAP_END);
+    identity_map_kernel(STACK_0_BASE,          STACK_0_END);
+    identity_map_kernel(MEM_FRAMEBUFFER_BASE,  MEM_FRAMEBUFFER_END);
 
-    identity_map_range(page_directory, MEM_USER_SPACE_BASE, MEM_USER_SPACE_END_MIN, PAGE_PRW);
+    identity_map_kernel(MEM_USER_SPACE_BASE, MEM_USER_SPACE_END_MIN);
     load_page_directory((ADDR)page_directory);
     enable_paging();
+    if (paging_features & PAGING_FEATURE_PGE) set_cr4(1 << 7);
     return TRUE;
 }
 
@@ -133,6 +248,13 @@ void map_page(U32 *pd, U32 virt, U32 phys, U32 flags) {
     // Get or create the page table for this directory entry
     U32 pt_phys;
 
+    if ((pd[pd_index] & (PAGE_PRESENT | PAGE_4MB)) == (PAGE_PRESENT | PAGE_4MB)) {
+        // Inside a 4 MB page: nothing to do if it maps this page already
+        U32 mapped = (pd[pd_index] & ~LARGE_PAGE_MASK) + (virt & LARGE_PAGE_MASK & ~0xFFF);
+        if (mapped == (phys & ~0xFFF) && (pd[pd_index] & LARGE_PDE_FLAGS) == (flags & LARGE_PDE_FLAGS)) return;
+        split_large_page(pd, pd_index);
+    }
+
     if (pd[pd_index] & PAGE_PRESENT) {
         // Page table already exists
         pt_phys = pd[pd_index] & ~0xFFF;
@@ -167,6 +289,7 @@ BOOLEAN unmap_page(U32 *pd, U32 virt) {
     if (!(pd[pd_index] & PAGE_PRESENT)) {
         return FALSE; // Page table not present
     }
+    if (pd[pd_index] & PAGE_4MB) split_large_page(pd, pd_index);
 
     U32 pt_phys = pd[pd_index] & ~0xFFF;
     U32 *pt = (U32 *)phys_to_virt_pd(pt_phys);
@@ -175,8 +298,6 @@ BOOLEAN unmap_page(U32 *pd, U32 virt) {
         return FALSE; // Page not mapped
     }
 
-    KFREE(pt_phys);
-
     pt[pt_index] = 0; // Unmap the page
 
     ASM_VOLATILE("invlpg (%0)" : : "r"(virt) : "memory");
@@ -35,9 +35,23 @@ See README.md
 #define PAGE_CACHEDIS   0b000010000
 #define PAGE_ACCESSED   0b000100000
 #define PAGE_DIRTY      0b001000000
-#define PAGE_4MB        0b100000000
+#define PAGE_4MB        0b010000000 // PDE only: maps 4 MB directly, needs PSE
+#define PAGE_GLOBAL     0b100000000 // Survives CR3 loads, needs PGE
 #define PAGE_PRW        (PAGE_PRESENT | PAGE_READ_WRITE)
 
+#define LARGE_PAGE_SIZE 0x400000
+#define LARGE_PAGE_MASK (LARGE_PAGE_SIZE - 1)
+
+// 4 MB pages and global kernel mappings are used whenever the CPU has
+// them. Build with -DPAGING_LARGE_PAGES=0 to compare against 4 KB pages only.
+#ifndef PAGING_LARGE_PAGES
+#define PAGING_LARGE_PAGES 1
+#endif
+
+// PAGING_FEATURES()
+#define PAGING_FEATURE_PSE 0x01     // 4 MB pages in use
+#define PAGING_FEATURE_PGE 0x02     // kernel mappings are global
+
 #define USER_PDE        (MEM_USER_SPACE_BASE >> 22) // 9
 #define USER_PDE_END    (MEM_USER_SPACE_END_MIN >> 22) // 15
 
@@ -54,6 +68,14 @@ BOOLEAN unmap_page(U32 *pd, U32 virt);
 
 void identity_map_range_with_offset(U32 *pd, U32 start, U32 end, U32 offset, U32 flags);
 void identity_map_range(U32 *pd, U32 start, U32 end, U32 flags);
+/// Maps `size` bytes at `phys` to `virt`. Stretches where both are 4 MB
+/// aligned and the PDE is still empty get a 4 MB page, the rest 4 KB pages.
+void map_range(U32 *pd, U32 virt, U32 phys, U32 size, U32 flags);
+/// @return PAGING_FEATURE_* bits enabled by PAGING_INIT
+U32 PAGING_FEATURES(VOID);
+/// Sets the PWT/PCD bits of every present mapping in [start, end) to
+/// `cache`, in place and in 4 MB pages as a whole.
+void PAGING_SET_CACHING(U32 *pd, U32 start, U32 end, U32 cache);
 
 /*
 Here are a set of functions,
@@ -24,6 +24,7 @@
 
 #include <RTOSKRNL/RTOSKRNL_INTERNAL.h>
 #include <RTOSKRNL/PROC/PROC.h>
+#include <RTOSKRNL/SYSINFO/SYSINFO.h>
 
 #include <MEMORY/E820/E820.h>
 #include <MEMORY/PAGING/PAGING.h>
@@ -37,8 +38,12 @@
 #include <CPU/ISR/ISR.h>
 #include <CPU/IRQ/IRQ.h>
 #include <CPU/FPU/FPU.h>
+#include <CPU/TSC/TSC.h>
+#include <CPU/PAT/PAT.h>
 #include <CPU/SYSCALL/SYSCALL.h>
 #include <CPU/INTERRUPTS/INTERRUPTS.h>
+
+#include <DEBUG/TRACE.h>
 #endif // NO_INCLUDES
 
 __attribute__((noreturn))
@@ -0,0 +1,165 @@
+#include <PIPE/PIPE.h>
+#include <PROC/PROC.h>
+#include <MEMORY/HEAP/KHEAP.h>
+#include <STD/MEM.h>
+#include <STD/ASM.h>
+
+typedef struct {
+    BOOLEAN used;
+    U32 handle;
+    U8 *buf;        // PIPE_BUFFER_SIZE bytes
+    U32 head;       // next byte to read
+    U32 count;      // bytes buffered
+    U32 readers;    // processes holding the read end
+    U32 writers;    // processes holding the write end
+} PIPE;
+
+static PIPE pipes[PIPE_MAX] ATTRIB_DATA = {0};
+static U32 generation ATTRIB_DATA = 0;
+
+static PIPE *lookup(U32 handle) {
+    U32 slot = PIPE_HANDLE_SLOT(handle);
+    if (!handle || slot >= PIPE_MAX) return NULLPTR;
+    PIPE *p = &pipes[slot];
+    return (p->used && p->handle == handle) ? p : NULLPTR;
+}
+
+static inline U32 slot_of(PIPE *p) {
+    return (U32)(p - pipes);
+}
+
+// Drops `ends` held by `t` and wakes whoever waits on the other side.
+// The pipe goes with its last end
+static VOID drop_ends(TCB *t, PIPE *p, U32 ends) {
+    U32 slot = slot_of(p);
+    ends &= t->pipe_ends[slot];
+    if (!ends) return;
+    t->pipe_ends[slot] &= ~ends;
+    if (ends & PIPE_END_READ) p->readers--;
+    if (ends & PIPE_END_WRITE) p->writers--;
+    proc_wake(PROC_WAIT_PIPE_READ, p->handle);
+    proc_wake(PROC_WAIT_PIPE_WRITE, p->handle);
+    if (!p->readers && !p->writers) {
+        KFREE(p->buf);
+        MEMZERO(p, sizeof(PIPE));
+    }
+}
+
+U32 PIPE_OBJECT_CREATE(TCB *t) {
+    if (!t) return 0;
+    U8 *buf = KMALLOC(PIPE_BUFFER_SIZE);
+    if (!buf) return 0;
+
+    U32 flags = irq_save();
+    U32 handle = 0;
+    for (U32 i = 0; i < PIPE_MAX && !handle; i++) {
+        PIPE *p = &pipes[i];
+        if (p->used) continue;
+        MEMZERO(p, sizeof(PIPE));
+        generation++;
+        p->handle = ((generation & 0xFFFFFF) << 8) | (i + 1);
+        p->buf = buf;
+        p->readers = 1;
+        p->writers = 1;
+        p->used = TRUE;
+        t->pipe_ends[i] = PIPE_END_BOTH;
+        handle = p->handle;
+    }
+    irq_restore(flags);
+    if (!handle) KFREE(buf);
+    return handle;
+}
+
+U32 PIPE_OBJECT_READ(TCB *t, U32 handle, U8 *buf, U32 len) {
+    if (!t || !buf) return PIPE_ERROR;
+    U32 flags = irq_save();
+    PIPE *p = lookup(handle);
+    U32 res;
+    if (!p || !(t->pipe_ends[slot_of(p)] & PIPE_END_READ)) {
+        res = PIPE_ERROR;
+    } else if (p->count) {
+        res = len < p->count ? len : p->count;
+        U32 first = PIPE_BUFFER_SIZE - p->head;
+        if (first > res) first = res;
+        MEMCPY(buf, p->buf + p->head, first);
+        MEMCPY(buf + first, p->buf, res - first);
+        p->head = (p->head + res) % PIPE_BUFFER_SIZE;
+        p->count -= res;
+        proc_wake(PROC_WAIT_PIPE_WRITE, handle);
+    } else if (!p->writers || !len) {
+        res = 0;
+    } else {
+        proc_wait(t, PROC_WAIT_PIPE_READ, handle, 0);
+        res = PIPE_WOULD_BLOCK;
+    }
+    irq_restore(flags);
+    return res;
+}
+
+U32 PIPE_OBJECT_WRITE(TCB *t, U32 handle, CONST U8 *buf, U32 len) {
+    if (!t || !buf) return PIPE_ERROR;
+    U32 flags = irq_save();
+    PIPE *p = lookup(handle);
+    U32 res;
+    if (!p || !(t->pipe_ends[slot_of(p)] & PIPE_END_WRITE) || !p->readers) {
+        res = PIPE_ERROR;
+    } else if (p->count < PIPE_BUFFER_SIZE) {
+        U32 space = PIPE_BUFFER_SIZE - p->count;
+        res = len < space ? len : space;
+        U32 tail = (p->head + p->count) % PIPE_BUFFER_SIZE;
+        U32 first = PIPE_BUFFER_SIZE - tail;
+        if (first > res) first = res;
+        MEMCPY(p->buf + tail, buf, first);
+        MEMCPY(p->buf, buf + first, res - first);
+        p->count += res;
+        if (res) proc_wake(PROC_WAIT_PIPE_READ, handle);
+    } else if (!len) {
+        res = 0;
+    } else {
+        proc_wait(t, PROC_WAIT_PIPE_WRITE, handle, 0);
+        res = PIPE_WOULD_BLOCK;
+    }
+    irq_restore(flags);
+    return res;
+}
+
+BOOLEAN PIPE_OBJECT_CLOSE(TCB *t, U32 handle, U32 ends) {
+    if (!t) return FALSE;
+    U32 flags = irq_save();
+    PIPE *p = lookup(handle);
+    BOOLEAN ok = p && (t->pipe_ends[slot_of(p)] & ends);
+    if (ok) drop_ends(t, p, ends);
+    irq_restore(flags);
+    return ok;
+}
+
+BOOLEAN PIPE_MOVE_ENDS(TCB *from, TCB *to, U32 handle, U32 ends) {
+    if (!from) return FALSE;
+    U32 flags = irq_save();
+    PIPE *p = lookup(handle);
+    U32 slot = p ? slot_of(p) : 0;
+    BOOLEAN ok = p && (from->pipe_ends[slot] & ends) == ends;
+    if (ok && !to) {
+        drop_ends(from, p, ends);
+    } else if (ok) {
+        // An end `to` already holds does not count twice
+        if (to->pipe_ends[slot] & ends & PIPE_END_READ) p->readers--;
+        if (to->pipe_ends[slot] & ends & PIPE_END_WRITE) p->writers--;
+        from->pipe_ends[slot] &= ~ends;
+        to->pipe_ends[slot] |= ends;
+    }
+    irq_restore(flags);
+    return ok;
+}
+
+VOID PIPE_RELEASE_PROCESS(TCB *t) {
+    if (!t) return;
+    U32 flags = irq_save();
+    for (U32 slot = 0; slot < PIPE_MAX; slot++) {
+        if (t->pipe_ends[slot] && pipes[slot].used) drop_ends(t, &pipes[slot], t->pipe_ends[slot]);
+        t->pipe_ends[slot] = 0;
+    }
+    t->stdin_pipe = 0;
+    t->stdout_pipe = 0;
+    irq_restore(flags);
+}
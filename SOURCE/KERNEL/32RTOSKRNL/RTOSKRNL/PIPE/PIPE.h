@@ -0,0 +1,73 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/RTOSKRNL/PIPE/PIPE.h - Pipes
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Byte streams between processes: a ring of PIPE_BUFFER_SIZE bytes in
+    the kernel heap with a read end and a write end. Every process holding
+    an end counts as one reader or writer.
+
+    Reading an empty pipe and writing a full one park the caller in the
+    scheduler (proc_wait) until the other side makes progress or goes
+    away; the syscall returns PIPE_WOULD_BLOCK and the STD wrapper yields
+    and calls again. A reader sees 0 once the pipe is empty and nobody
+    holds the write end; writing with no readers left fails.
+
+    The creator holds both ends. An end moves to a new process through
+    RUN_BINARY_STRUCT (stdin_pipe / stdout_pipe), which is how TSHELL
+    connects `A | B`.
+
+REMARKS
+    Shared with user code; STD/PIPE.h wraps SYSCALL_PIPE. Kernel functions
+    are under __RTOS__.
+---*/
+#ifndef RTOS_PIPE_H
+#define RTOS_PIPE_H
+
+#include <STD/TYPEDEF.h>
+
+#define PIPE_MAX         32
+#define PIPE_BUFFER_SIZE (16 * 1024)
+
+// Handles are never 0, laid out as SHM handles: slot + 1 in the low byte,
+// a generation count above it
+#define PIPE_HANDLE_SLOT(h) (((h) & 0xFF) - 1)
+
+// Ends, as bits of TCB.pipe_ends[slot]
+#define PIPE_END_READ  0x01
+#define PIPE_END_WRITE 0x02
+#define PIPE_END_BOTH  (PIPE_END_READ | PIPE_END_WRITE)
+
+// PIPE_OP_READ / PIPE_OP_WRITE results besides a byte count
+#define PIPE_WOULD_BLOCK 0xFFFFFFFE // the caller is parked, yield and retry
+#define PIPE_ERROR       0xFFFFFFFF // not an end the caller holds, or no readers left
+
+// SYSCALL_PIPE operations
+typedef enum {
+    PIPE_OP_CREATE = 0, // Returns the handle, 0 on failure. The caller holds both ends
+    PIPE_OP_READ,       // a1 = handle, a2 = buffer, a3 = size. Bytes read, 0 at end of stream
+    PIPE_OP_WRITE,      // a1 = handle, a2 = buffer, a3 = size. Bytes written, may be fewer than size
+    PIPE_OP_CLOSE,      // a1 = handle, a2 = PIPE_END_* bits to let go of. Returns TRUE
+    PIPE_OP_STDIO,      // a1 = 0 for stdin, 1 for stdout. The handle the process was started with, or 0
+} PIPE_OP;
+
+#ifdef __RTOS__
+struct TCB;
+
+U32 PIPE_OBJECT_CREATE(struct TCB *t);
+U32 PIPE_OBJECT_READ(struct TCB *t, U32 handle, U8 *buf, U32 len);
+U32 PIPE_OBJECT_WRITE(struct TCB *t, U32 handle, CONST U8 *buf, U32 len);
+BOOLEAN PIPE_OBJECT_CLOSE(struct TCB *t, U32 handle, U32 ends);
+
+// Hands `ends` of a pipe from one process to another. With `to` NULL the
+// ends are closed instead, e.g. when the new process could not be started
+BOOLEAN PIPE_MOVE_ENDS(struct TCB *from, struct TCB *to, U32 handle, U32 ends);
+
+// Closes every end `t` holds. Called by KILL_PROCESS
+VOID PIPE_RELEASE_PROCESS(struct TCB *t);
+#endif // __RTOS__
+
+#endif // RTOS_PIPE_H
@@ -24,10 +24,12 @@
 #include <CPU/ISR/ISR.h> // for regs struct
 #include <CPU/PIC/PIC.h>
 #include <CPU/FPU/FPU.h>
+#include <SYSINFO/SYSINFO.h>
 
 #include <PROGRAMS/ASTRAC/AC_FH.h>
 
 #include <DEBUG/KDEBUG.h>
+#include <DEBUG/TRACE.h>
 #define EFLAGS_IF 0x0200
 #define KDS 0x10
 #define KCS 0x08
@@ -37,6 +39,8 @@ static TCB *current_tcb __attribute__((section(".data"))) = &master_tcb;
 static U32 next_pid __attribute__((section(".data"))) = 1; // start from 1 since 0 is master tcb
 static U8 initialized __attribute__((section(".data"))) = FALSE;
 static U32 proc_amount __attribute__((section(".data"))) = 0;
+static U32 context_switches ATTRIB_DATA = 0;
+static U32 last_sched_tick ATTRIB_DATA = 0; // tick seen by the previous scheduler call
 static TCB *last_tcb __attribute__((section(".data"))) = &master_tcb;
 static TCB *current_shell ATTRIB_DATA = &master_tcb;
 static TCB *last_fpu_user ATTRIB_DATA = NULL;
@@ -75,6 +79,9 @@ static inline void PROC_SET_EIP(U32 eip) {
 U32 get_active_task_count(void) {
     return proc_amount;
 }
+U32 get_context_switches(void) {
+    return context_switches;
+}
 TCB *get_last_tcb(void) {
     return last_tcb;
 }
@@ -477,6 +484,10 @@ U32 *setup_user_process(TCB *proc, U8 *binary_data, U32 bin_size, U32 heap_size,
     proc->stack_pages = stack_pages;
     proc->framebuffer_pages = framebuffer_pages;
     U32 amount_of_pages_needed = bin_pages + heap_pages + stack_pages + framebuffer_pages;
+    if (USER_BINARY_VADDR + amount_of_pages_needed * PAGE_SIZE > SYSINFO_VADDR) {
+        destroy_process_pagedir(proc->pagedir_phys);
+        return NULL;
+    }
 
     VOIDPTR pages = KREQUEST_USER_PAGES(amount_of_pages_needed);
     if (!pages) {
@@ -525,15 +536,15 @@ U32 *setup_user_process(TCB *proc, U8 *binary_data, U32 bin_size, U32 heap_size,
     KDEBUG_PUTS("[proc] Mapped heap\n");
 
     // Map pages ONLY after all physical pages are allocated and binary is copied
+    // 4 MB aligned stretches of the block get large pages
     #ifndef MAP_IN_FUNCTIONS
-    for(U32 i = 0; i < amount_of_pages_needed; i++) {
-        U32 phys = (U32)pages + (i * PAGE_SIZE);
-        U32 vaddr = USER_BINARY_VADDR + (( (U32)phys - layout.bin_base));
-        map_page(proc->pagedir_phys, vaddr, phys, PAGE_PRW);
-    }
+    map_range(proc->pagedir_phys, USER_BINARY_VADDR + ((U32)pages - layout.bin_base), (U32)pages,
+              amount_of_pages_needed * PAGE_SIZE, PAGE_PRW);
     #endif
     KDEBUG_PUTS("[proc] Mapped pagedir\n");
 
+    SYSINFO_MAP(proc->pagedir_phys);
+
     // +1 is to adjust for padding between stack and framebuffer
     proc->framebuffer_phys = (VOIDPTR)( (U32)pages + ( (bin_pages + heap_pages + stack_pages + 1) * PAGE_SIZE) );
     proc->framebuffer_virt = (VOIDPTR)USER_BINARY_VADDR + ( (bin_pages + heap_pages + stack_pages + 1) * PAGE_SIZE);
@@ -828,6 +839,11 @@ void KILL_PROCESS(U32 pid) {
     // Remove from scheduler (this adjusts proc_amount automatically)
     remove_tcb_from_scheduler(target);
 
+    // Drop shared regions while the page directory still exists
+    SHM_RELEASE_PROCESS(target);
+    // Readers see end of stream, writers a broken pipe
+    PIPE_RELEASE_PROCESS(target);
+
     // Free argv if present
     if (target->argv) {
         for (U32 i = 0; i < target->argc; i++) {
@@ -864,6 +880,11 @@ void KILL_PROCESS(U32 pid) {
             set_focused_task(current_shell);
         }
     }
+    if (target->profile) {
+        KFREE(target->profile);
+        target->profile = NULL;
+    }
+
     // Finally free the TCB itself
     KFREE(target);
 
@@ -876,6 +897,17 @@ void KILL_PROCESS(U32 pid) {
 
 volatile static U32 tcks __attribute__((section(".data"))) = 0;
 volatile static U32 last_screen_buf_update ATTRIB_DATA = 0;
+// A parked task whose deadline has passed is woken here
+static BOOLEAN is_runnable(TCB *t, U32 now) {
+    if (t->info.state == TCB_STATE_INACTIVE || t->info.state == TCB_STATE_ZOMBIE) return FALSE;
+    if (t->wait_reason == PROC_WAIT_NONE) return TRUE;
+    if (t->wait_deadline && (I32)(now - t->wait_deadline) >= 0) {
+        t->wait_reason = PROC_WAIT_NONE;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 TCB *find_next_active_task(void) {
     if (!initialized) return NULL;
 
@@ -884,17 +916,18 @@ TCB *find_next_active_task(void) {
         return &master_tcb; // master must always be immortal
     }
 
+    U32 now = *PIT_GET_TICKS_PTR();
     TCB *start = current_tcb;
     TCB *next = start->next;
 
     while(next != start) {
-        if (next->info.state != TCB_STATE_INACTIVE && next->info.state != TCB_STATE_ZOMBIE) {
+        if (is_runnable(next, now)) {
             return next;
         }
         next = next->next;
     }
 
-    if (start->info.state != TCB_STATE_INACTIVE && start->info.state != TCB_STATE_ZOMBIE) {
+    if (is_runnable(start, now)) {
         return start; // only current is active
     }
 
@@ -903,13 +936,74 @@ TCB *find_next_active_task(void) {
     return &master_tcb;
 }
 
+static inline VOID profile_sample(PROC_PROFILE *p, U32 eip) {
+    p->samples++;
+    U32 idx = (eip - p->base) >> p->shift;
+    if (eip >= p->base && idx < p->bucket_count) p->buckets[idx]++;
+    else p->outside++;
+}
+
+BOOLEAN PROC_PROFILE_START(U32 pid, U32 shift) {
+    TCB *t = get_tcb_by_pid(pid);
+    if (!t || !t->binary_size || (t->info.state & TCB_STATE_LIBRARY)) return FALSE;
+    if (shift >= 32) return FALSE;  // comes from user space, 1u << shift must be defined
+
+    if (!shift) {
+        shift = 2;
+        while ((t->binary_size >> shift) >= PROC_PROFILE_MAX_BUCKETS) shift++;
+    }
+    U32 count = (t->binary_size + (1u << shift) - 1) >> shift;
+    if (count > PROC_PROFILE_MAX_BUCKETS) return FALSE;
+
+    PROC_PROFILE *p = KCALLOC(1, sizeof(PROC_PROFILE) + count * sizeof(U32));
+    if (!p) return FALSE;
+    p->pid = pid;
+    p->base = USER_BINARY_VADDR;
+    p->shift = shift;
+    p->bucket_count = count;
+
+    // The PIT handler reads t->profile, swap it with interrupts off
+    U32 flags = irq_save();
+    PROC_PROFILE *old = t->profile;
+    t->profile = p;
+    irq_restore(flags);
+    if (old) KFREE(old);
+    return TRUE;
+}
+
+VOID PROC_PROFILE_STOP(U32 pid) {
+    TCB *t = get_tcb_by_pid(pid);
+    if (!t) return;
+    U32 flags = irq_save();
+    PROC_PROFILE *old = t->profile;
+    t->profile = NULLPTR;
+    irq_restore(flags);
+    if (old) KFREE(old);
+}
+
+U32 PROC_PROFILE_READ(U32 pid, PROC_PROFILE *dst, U32 size) {
+    TCB *t = get_tcb_by_pid(pid);
+    if (!t || !t->profile || !dst) return 0;
+    U32 flags = irq_save();
+    PROC_PROFILE *p = t->profile;
+    U32 bytes = sizeof(PROC_PROFILE) + p->bucket_count * sizeof(U32);
+    if (bytes > size) bytes = size;
+    MEMCPY(dst, p, bytes);
+    irq_restore(flags);
+    return bytes;
+}
+
 // Called from PIT ISR to perform task switch
 // Arg: current trap frame (already pushed by ISR)
 // Returns: new trap frame to load (or same if no switch)
 // Called from PIT ISR to perform task switch
 static U32 past = FALSE;
 TrapFrame* pit_handler_task_control(TrapFrame *cur) {
-    // todo: tick counter here
+    // isr_pit counts the tick before calling us, isr_yield does not
+    U32 now = *PIT_GET_TICKS_PTR();
+    BOOLEAN hw_tick = now != last_sched_tick;
+    last_sched_tick = now;
+
     tcks++;
     if(EVERY_HZ(tcks, REFRESH_HZ) || past) {
         past = TRUE;
@@ -935,7 +1029,11 @@ TrapFrame* pit_handler_task_control(TrapFrame *cur) {
 
     if (current_tcb) {
         current_tcb->tf = cur;
-        current_tcb->info.cpu_time += PIT_TICK_MS;
+        if (hw_tick) {
+            current_tcb->info.cpu_time += PIT_TICK_MS;
+            current_tcb->info.ticks_run++;
+            if (current_tcb->profile) profile_sample(current_tcb->profile, cur->cpu.eip);
+        }
     }
     
     TCB *next = find_next_active_task();
@@ -945,6 +1043,14 @@ TrapFrame* pit_handler_task_control(TrapFrame *cur) {
         next = current_tcb; 
     }
     
+    if (next != current_tcb) {
+        context_switches++;
+        if (current_tcb) {
+            if (hw_tick) current_tcb->info.involuntary_switches++;
+            else current_tcb->info.voluntary_switches++;
+        }
+        TRACE_SWITCH(current_tcb ? current_tcb->info.pid : 0, next->info.pid);
+    }
     current_tcb = next;
     update_current_framebuffer();
     current_tcb->info.num_switches++;
@@ -1153,11 +1259,11 @@ void TCB_DUMP(TCB *t) {
 
 
 U32 get_ticks(void) {
-    return tcks;
+    return *PIT_GET_TICKS_PTR();
 }
 
 U32 get_uptime_sec(void) {
-    return tcks / TICKS_PER_SECOND;
+    return *PIT_GET_TICKS_PTR() / TICKS_PER_SECOND;
 }
 
 TCB *get_focused_task(void) {
@@ -1190,33 +1296,74 @@ void empty_msg_queue(U32 pid) {
     TCB *tcb = get_tcb_by_pid(pid);
     if (!tcb) return;
     
-    // Clear message queue
+    // Drop regions travelling in the queue, then clear it
+    for (U32 i = 0, at = tcb->msg_queue_head; i < tcb->msg_count; i++, at = (at + 1) % PROC_MSG_QUEUE_SIZE) {
+        if (tcb->msg_queue[at].shm) SHM_REGION_PUT(tcb->msg_queue[at].shm);
+    }
     tcb->msg_queue_head = 0;
     tcb->msg_queue_tail = 0;
+    tcb->msg_count = 0;
+}
+
+void proc_wait(TCB *t, U32 reason, U32 object, U32 timeout_ms) {
+    if (!t || t == &master_tcb) return; // the kernel loop never parks
+    U32 flags = irq_save();
+    t->wait_reason = reason;
+    t->wait_object = object;
+    t->wait_deadline = 0;
+    if (timeout_ms) {
+        U32 ticks = timeout_ms / PIT_TICK_MS + (timeout_ms % PIT_TICK_MS != 0);
+        t->wait_deadline = *PIT_GET_TICKS_PTR() + ticks;
+        if (!t->wait_deadline) t->wait_deadline = 1;
+    }
+    irq_restore(flags);
+}
+
+void proc_wake_task(TCB *t, U32 reason) {
+    if (!t) return;
+    U32 flags = irq_save();
+    if (t->wait_reason == reason) t->wait_reason = PROC_WAIT_NONE;
+    irq_restore(flags);
+}
+
+void proc_wake(U32 reason, U32 object) {
+    U32 flags = irq_save();
+    for (TCB *t = master_tcb.next; t && t != &master_tcb; t = t->next) {
+        if (t->wait_reason == reason && t->wait_object == object) t->wait_reason = PROC_WAIT_NONE;
+    }
+    irq_restore(flags);
 }
 
-void add_message(TCB *t, PROC_MESSAGE *msg) {
-    if (!t || !msg) return;
+BOOLEAN add_message(TCB *t, PROC_MESSAGE *msg, U32 shm) {
+    if (!t || !msg) return FALSE;
     U32 next_tail = (t->msg_queue_tail + 1) % PROC_MSG_QUEUE_SIZE;
     if (next_tail == t->msg_queue_head) {
-        // Queue is full, drop message
-        return;
+        // Queue is full, the sender decides whether to retry
+        return FALSE;
     }
     // Add message into queue
     MEMCPY(&t->msg_queue[t->msg_queue_tail], msg, sizeof(PROC_MESSAGE));
+    t->msg_queue[t->msg_queue_tail].shm = shm;
     t->msg_queue_tail = next_tail;
     t->msg_count++;
+    proc_wake_task(t, PROC_WAIT_MESSAGE);
+    return TRUE;
 }
 
 
-void send_msg(PROC_MESSAGE *msg) {
-    if (!msg) return;
+BOOLEAN send_msg_shm(PROC_MESSAGE *msg, U32 shm) {
+    if (!msg) return FALSE;
     TCB *receiver = get_tcb_by_pid(msg->receiver_pid);
 
-    if (!receiver) return;
+    if (!receiver) return FALSE;
+    if (shm && receiver == &master_tcb) return FALSE; // the kernel maps no regions
 
     // Add message to queue
-    add_message(receiver, msg);
+    return add_message(receiver, msg, shm);
+}
+
+BOOLEAN send_msg(PROC_MESSAGE *msg) {
+    return send_msg_shm(msg, 0);
 }
 
 // e.g., terminate self, sleep, wait, etc.
@@ -1411,7 +1558,9 @@ void handle_kernel_messages(void) {
                         goto free_create_proc_data;
                     };
                     KDEBUG_PUTS("[proc_msg] Creating new process\n");
-                    RUN_BINARY(
+                    // Pipe ends are handed over before the new process gets a time slice
+                    U32 flags = irq_save();
+                    BOOLEAN started = RUN_BINARY(
                         sct->proc_name,
                         sct->file,
                         sct->bin_size,
@@ -1422,6 +1571,15 @@ void handle_kernel_messages(void) {
                         sct->argv,
                         sct->argc
                     );
+                    if (sct->stdin_pipe || sct->stdout_pipe) {
+                        TCB *sender = get_tcb_by_pid(msg->sender_pid);
+                        TCB *child = started ? get_tcb_by_pid(get_last_pid()) : NULLPTR;
+                        if (sct->stdin_pipe && PIPE_MOVE_ENDS(sender, child, sct->stdin_pipe, PIPE_END_READ) && child)
+                            child->stdin_pipe = sct->stdin_pipe;
+                        if (sct->stdout_pipe && PIPE_MOVE_ENDS(sender, child, sct->stdout_pipe, PIPE_END_WRITE) && child)
+                            child->stdout_pipe = sct->stdout_pipe;
+                    }
+                    irq_restore(flags);
                     for(U32 i = 0; i < sct->argc; i++) {
                         KDEBUG_HEX32(i);
                         KDEBUG_PUTC('\n');
@@ -13,6 +13,8 @@ and message passing between processes and the kernel.
 #include <MEMORY/HEAP/KHEAP.h> // for USER_HEAP_BLOCK
 #include <MEMORY/MEMORY.h>
 #include <STD/ASM.h>
+#include <SHM/SHM.h>
+#include <PIPE/PIPE.h>
 
 #define USER_BINARY_VADDR MEM_USER_SPACE_BASE
 
@@ -104,13 +106,20 @@ typedef struct TaskInfo {
 
     U32 priority; // Not used yet
 
-    U32 cpu_time; // in ticks, total CPU time used
+    U32 cpu_time; // in ms, total CPU time used (PIT ticks run * PIT_TICK_MS)
     U32 num_switches; // number of times scheduled
     PROC_EVENT_TYPE event_types; // Bitfield of event types this process is interested in
     BOOL8 request_yield;
     BOOL8 fpu_initialized;
 
     U32 heap_allocated; // in bytes, total allocated heap memory
+
+    // Accounting, maintained by pit_handler_task_control and the syscall path
+    U32 ticks_run; // PIT ticks that interrupted this task
+    U32 syscalls; // syscalls issued
+    U32 page_faults;
+    U32 voluntary_switches; // gave up the CPU by yielding
+    U32 involuntary_switches; // preempted by the PIT
 } __attribute__((packed)) TaskInfo;
 
 #define PROC_MSG_QUEUE_SIZE 30
@@ -244,12 +253,53 @@ typedef struct proc_message {
 
     VOIDPTR raw_data; // Raw data. Is not copied, not freed by message queue handler
     U32 raw_data_size; // Raw data. Is not copied, not freed by message queue handler
+
+    // SHM region handed to the receiver, 0 for none. Sending unmaps it from
+    // the sender; the fetched message has it mapped, with raw_data/raw_data_size
+    // set to its address and size. The receiver closes it or passes it on
+    U32 shm;
 } PROC_MESSAGE;
 
 typedef struct {
     U8 fxstate[512] ATTRIB_ALIGNED(16); // fxsave requires 512-byte aligned area
 } FPUState;
 
+/*+++
+PIT-sampled EIP histogram of one process.
+
+Every PIT tick that interrupts the process adds one sample: to
+buckets[(eip - base) >> shift] when EIP is inside the binary image, to
+`outside` otherwise (kernel code run on the task's behalf: syscalls, IRQs).
+Symbolise buckets against the program's linker map (ATOS/<NAME>.MAP).
+---*/
+#define PROC_PROFILE_MAX_BUCKETS 4096
+typedef struct {
+    U32 pid;
+    U32 base;           // address of bucket 0 (USER_BINARY_VADDR)
+    U32 shift;          // log2 of the bytes per bucket
+    U32 bucket_count;
+    U32 samples;        // all samples, including `outside`
+    U32 outside;
+    U32 buckets[];
+} PROC_PROFILE;
+
+// SYSCALL_PROC_PROFILE operations
+typedef enum {
+    PROC_PROFILE_OP_START = 0,  // a1 = shift (0 = smallest that fits), restarts a running profile
+    PROC_PROFILE_OP_STOP,       // frees the histogram
+    PROC_PROFILE_OP_READ,       // a1 = PROC_PROFILE *dst, a2 = dst size. Returns bytes copied
+} PROC_PROFILE_OP;
+
+// What a parked task waits for. The scheduler passes over a task with a
+// wait_reason until proc_wake/proc_wake_task clears it or its deadline passes
+typedef enum {
+    PROC_WAIT_NONE = 0,
+    PROC_WAIT_MESSAGE,      // a message arriving in its queue
+    PROC_WAIT_SLEEP,        // nothing but the deadline
+    PROC_WAIT_PIPE_READ,    // object = pipe handle: data, or the last writer gone
+    PROC_WAIT_PIPE_WRITE,   // object = pipe handle: free space, or the last reader gone
+} PROC_WAIT_REASON;
+
 typedef struct TCB {
     TaskInfo info;
     TrapFrame *tf; // saved trap frame for context switching
@@ -294,6 +344,18 @@ typedef struct TCB {
 
     U32 argc;
     PPU8 argv;
+
+    PROC_PROFILE *profile; // NULL unless SYSCALL_PROC_PROFILE started sampling
+
+    U32 shm_mapped[SHM_MAX_REGIONS / 32]; // bit per SHM slot mapped into this process
+
+    U32 wait_reason;   // PROC_WAIT_REASON, PROC_WAIT_NONE while runnable
+    U32 wait_object;
+    U32 wait_deadline; // PIT tick that ends the wait, 0 for none
+
+    U8 pipe_ends[PIPE_MAX]; // PIPE_END_* bits per pipe slot
+    U32 stdin_pipe;         // pipe handles the process was started with, 0 for none
+    U32 stdout_pipe;
 } TCB;
 
 
@@ -306,6 +368,8 @@ typedef struct {
     U32 parent_pid;
     PPU8 argv;
     U32 argc;
+    U32 stdin_pipe;  // the sender's read end of this pipe moves to the new process, 0 for none
+    U32 stdout_pipe; // likewise its write end
 } RUN_BINARY_STRUCT;
 
 typedef struct {
@@ -344,8 +408,23 @@ static inline void write_cr3(U32 val) {
 }
 
 void free_message(PROC_MESSAGE *msg);
-void send_msg(PROC_MESSAGE *msg);
+// Queues a copy of msg for its receiver. FALSE if there is no such process
+// or its queue is full. Kernel messages never carry a region: shm is cleared
+BOOLEAN send_msg(PROC_MESSAGE *msg);
+// As send_msg, with `shm` moved along. The caller owns one reference to it,
+// which the queued message takes over on success
+BOOLEAN send_msg_shm(PROC_MESSAGE *msg, U32 shm);
 U32 get_active_task_count(void);
+U32 get_context_switches(void);
+
+// Parks `t` until woken for `reason` (and `object`), or `timeout_ms` passed;
+// 0 waits without a deadline. Only call it for the task issuing the current
+// syscall: it keeps running until it yields
+void proc_wait(TCB *t, U32 reason, U32 object, U32 timeout_ms);
+// Makes `t` runnable again if it waits for `reason`
+void proc_wake_task(TCB *t, U32 reason);
+// Makes every task waiting for `reason` on `object` runnable again
+void proc_wake(U32 reason, U32 object);
 U32 get_uptime_sec(void);
 
 /// @brief Run a user binary in a new process
@@ -387,6 +466,15 @@ void handle_immediate_reschedule();
 
 TCB *get_tcb_by_pid(U32 pid);
 TCB *get_tcb_by_name(U8 *name);
+
+/// @brief Starts (or restarts) EIP sampling of a process.
+/// @param shift log2 bytes per bucket, 0 picks the smallest that covers the image
+/// @return FALSE for shift >= 32 or if the histogram would need too many buckets
+BOOLEAN PROC_PROFILE_START(U32 pid, U32 shift);
+VOID PROC_PROFILE_STOP(U32 pid);
+/// @brief Copies the histogram of `pid` into `dst`.
+/// @return Bytes copied, 0 if the process is not being profiled
+U32 PROC_PROFILE_READ(U32 pid, PROC_PROFILE *dst, U32 size);
 #endif // __RTOS__
 
 #endif // RTOS_PROC_H
\ No newline at end of file
@@ -8,6 +8,7 @@ and some not-so-important functions are here.
 #include <DRIVERS/ATAPI/ATAPI.h>
 #include <DRIVERS/ATA_PIO/ATA_PIO.h>
 #include <DRIVERS/VESA/VBE.h>
+#include <DRIVERS/SERIAL/SERIAL.h>
 #include <DRIVERS/PS2/KEYBOARD_MOUSE.h>
 #include <DRIVERS/AC97/AC97.h>
 
@@ -356,6 +357,7 @@ void panic_reg(regs *r, const U8 *msg, U32 errmsg) {
 
     KDEBUG_PUTS("System halted.\n");
     VBE_UPDATE_VRAM();
+    SERIAL_FLUSH(COM1_PORT);
     ASM_VOLATILE("cli; hlt");
 }
 
@@ -503,6 +505,7 @@ void PANIC_RAW(const U8 *msg, U32 errmsg, VBE_COLOUR fg, VBE_COLOUR bg) {
     KDEBUG_PUTS("\n");
 
     VBE_UPDATE_VRAM();
+    SERIAL_FLUSH(COM1_PORT);
     ASM_VOLATILE("cli; hlt");
 }
 
@@ -0,0 +1,249 @@
+#include <SHM/SHM.h>
+#include <PROC/PROC.h>
+#include <MEMORY/PAGEFRAME/PAGEFRAME.h>
+#include <MEMORY/PAGING/PAGING.h>
+#include <STD/MEM.h>
+#include <STD/STRING.h>
+#include <STD/ASM.h>
+#include <DEBUG/KDEBUG.h>
+
+#define WINDOW_PDE_FIRST (MEM_SHARED_BASE >> 22)
+#define WINDOW_PDE_END   (MEM_SHARED_END >> 22)
+
+typedef struct {
+    BOOLEAN used;
+    U8 name[SHM_NAME_MAX];  // empty for anonymous regions
+    U32 handle;
+    U32 phys;               // first of `pages` contiguous physical pages
+    U32 virt;               // the region's range in the shared window
+    U32 pages;
+    U32 refs;               // processes mapping it + messages carrying it
+} SHM_REGION;
+
+static SHM_REGION regions[SHM_MAX_REGIONS] ATTRIB_DATA = {0};
+static U32 generation ATTRIB_DATA = 0;
+static I32 window_state ATTRIB_DATA = 0; // 0 unchecked, 1 usable, -1 the kernel maps RAM there
+
+static BOOLEAN window_usable(VOID) {
+    if (!window_state) {
+        U32 *kpd = (U32 *)get_page_directory();
+        window_state = kpd ? 1 : -1;
+        for (U32 i = WINDOW_PDE_FIRST; kpd && i < WINDOW_PDE_END; i++) {
+            if (kpd[i] & PAGE_PRESENT) window_state = -1;
+        }
+        if (window_state < 0) KDEBUG_PUTS("[shm] Shared window overlaps kernel mappings, disabled\n");
+    }
+    return window_state > 0;
+}
+
+// The master task runs on the kernel page directory, which every new
+// process copies: it never maps regions
+static BOOLEAN can_map(TCB *t) {
+    return t && t->info.pid != 0 && t->pagedir_phys && window_usable();
+}
+
+static inline BOOLEAN is_mapped(TCB *t, U32 slot) {
+    return (t->shm_mapped[slot / 32] >> (slot % 32)) & 1;
+}
+
+static SHM_REGION *lookup(U32 handle) {
+    U32 slot = SHM_HANDLE_SLOT(handle);
+    if (!handle || slot >= SHM_MAX_REGIONS) return NULLPTR;
+    SHM_REGION *r = &regions[slot];
+    return (r->used && r->handle == handle) ? r : NULLPTR;
+}
+
+static SHM_REGION *find_name(CONST U8 *name) {
+    for (U32 i = 0; i < SHM_MAX_REGIONS; i++) {
+        if (regions[i].used && regions[i].name[0] && STRCMP(regions[i].name, name) == 0)
+            return &regions[i];
+    }
+    return NULLPTR;
+}
+
+// Lowest free range of the window with an unmapped guard page after it
+static U32 place(U32 bytes) {
+    U32 base = MEM_SHARED_BASE;
+    BOOLEAN moved = TRUE;
+    while (moved) {
+        moved = FALSE;
+        for (U32 i = 0; i < SHM_MAX_REGIONS; i++) {
+            SHM_REGION *r = &regions[i];
+            if (!r->used) continue;
+            U32 end = r->virt + (r->pages + 1) * PAGE_SIZE;
+            if (base < end && r->virt < base + bytes + PAGE_SIZE) {
+                base = end;
+                moved = TRUE;
+            }
+        }
+        if (base > MEM_SHARED_END - bytes) return 0;
+    }
+    return base;
+}
+
+static VOID map_into(TCB *t, SHM_REGION *r) {
+    for (U32 i = 0; i < r->pages; i++)
+        map_page(t->pagedir_phys, r->virt + i * PAGE_SIZE, r->phys + i * PAGE_SIZE, PAGE_PRW);
+    U32 slot = (U32)(r - regions);
+    t->shm_mapped[slot / 32] |= 1u << (slot % 32);
+}
+
+// Clears the PTEs only; the page tables stay until the process exits
+static VOID unmap_from(TCB *t, SHM_REGION *r) {
+    for (U32 i = 0; i < r->pages; i++)
+        unmap_page(t->pagedir_phys, r->virt + i * PAGE_SIZE);
+    U32 slot = (U32)(r - regions);
+    t->shm_mapped[slot / 32] &= ~(1u << (slot % 32));
+}
+
+static VOID release(SHM_REGION *r) {
+    if (--r->refs) return;
+    KFREE_USER_PAGES((ADDR)r->phys, r->pages);
+    MEMZERO(r, sizeof(SHM_REGION));
+}
+
+U32 SHM_REGION_CREATE(TCB *t, CONST U8 *name, U32 size) {
+    if (!can_map(t) || !size || size > SHM_MAX_SIZE) return 0;
+    if (name && (!name[0] || STRLEN(name) >= SHM_NAME_MAX)) return 0;
+
+    U32 flags = irq_save();
+    U32 handle = 0;
+    SHM_REGION *r = NULLPTR;
+    for (U32 i = 0; i < SHM_MAX_REGIONS && !r; i++) {
+        if (!regions[i].used) r = &regions[i];
+    }
+    U32 pages = pages_from_bytes(size);
+    U32 virt = r ? place(pages * PAGE_SIZE) : 0;
+    if (virt && !(name && find_name(name))) {
+        U32 phys = (U32)KREQUEST_USER_PAGES(pages);
+        if (phys) {
+            MEMZERO((VOIDPTR)phys, pages * PAGE_SIZE);
+            MEMZERO(r, sizeof(SHM_REGION));
+            if (name) STRNCPY(r->name, name, SHM_NAME_MAX - 1);
+            generation++;
+            r->handle = ((generation & 0xFFFFFF) << 8) | ((U32)(r - regions) + 1);
+            r->phys = phys;
+            r->virt = virt;
+            r->pages = pages;
+            r->refs = 1;
+            r->used = TRUE;
+            map_into(t, r);
+            handle = r->handle;
+        }
+    }
+    irq_restore(flags);
+    return handle;
+}
+
+// One reference per process, however often it opens the region
+static U32 map_existing(TCB *t, SHM_REGION *r) {
+    if (!r || !can_map(t)) return 0;
+    if (!is_mapped(t, (U32)(r - regions))) {
+        r->refs++;
+        map_into(t, r);
+    }
+    return r->handle;
+}
+
+U32 SHM_REGION_OPEN(TCB *t, CONST U8 *name) {
+    if (!name || !name[0]) return 0;
+    U32 flags = irq_save();
+    U32 handle = map_existing(t, find_name(name));
+    irq_restore(flags);
+    return handle;
+}
+
+U32 SHM_REGION_MAP(TCB *t, U32 handle) {
+    U32 flags = irq_save();
+    handle = map_existing(t, lookup(handle));
+    irq_restore(flags);
+    return handle;
+}
+
+BOOLEAN SHM_REGION_CLOSE(TCB *t, U32 handle) {
+    if (!t) return FALSE;
+    U32 flags = irq_save();
+    SHM_REGION *r = lookup(handle);
+    BOOLEAN ok = r && is_mapped(t, (U32)(r - regions));
+    if (ok) {
+        unmap_from(t, r);
+        release(r);
+    }
+    irq_restore(flags);
+    return ok;
+}
+
+U32 SHM_REGION_ADDR(TCB *t, U32 handle) {
+    SHM_REGION *r = lookup(handle);
+    return (t && r && is_mapped(t, (U32)(r - regions))) ? r->virt : 0;
+}
+
+U32 SHM_REGION_SIZE(U32 handle) {
+    SHM_REGION *r = lookup(handle);
+    return r ? r->pages * PAGE_SIZE : 0;
+}
+
+BOOLEAN SHM_REGION_DETACH(TCB *t, U32 handle) {
+    if (!t) return FALSE;
+    U32 flags = irq_save();
+    SHM_REGION *r = lookup(handle);
+    BOOLEAN ok = r && is_mapped(t, (U32)(r - regions));
+    if (ok) unmap_from(t, r);
+    irq_restore(flags);
+    return ok;
+}
+
+BOOLEAN SHM_REGION_ATTACH(TCB *t, U32 handle) {
+    U32 flags = irq_save();
+    SHM_REGION *r = lookup(handle);
+    BOOLEAN ok = r != NULLPTR;
+    if (ok) {
+        if (!can_map(t)) {
+            release(r);
+            ok = FALSE;
+        } else if (is_mapped(t, (U32)(r - regions))) {
+            release(r); // already holds a reference of its own
+        } else {
+            map_into(t, r);
+        }
+    }
+    irq_restore(flags);
+    return ok;
+}
+
+VOID SHM_REGION_PUT(U32 handle) {
+    U32 flags = irq_save();
+    SHM_REGION *r = lookup(handle);
+    if (r) release(r);
+    irq_restore(flags);
+}
+
+VOID SHM_RELEASE_PROCESS(TCB *t) {
+    if (!t) return;
+    U32 flags = irq_save();
+
+    // Regions still travelling to `t`
+    for (U32 i = 0, at = t->msg_queue_head; i < t->msg_count; i++, at = (at + 1) % PROC_MSG_QUEUE_SIZE) {
+        PROC_MESSAGE *m = &t->msg_queue[at];
+        if (m->shm) {
+            SHM_REGION *r = lookup(m->shm);
+            if (r) release(r);
+            m->shm = 0;
+        }
+    }
+
+    for (U32 slot = 0; slot < SHM_MAX_REGIONS; slot++) {
+        if (!is_mapped(t, slot)) continue;
+        unmap_from(t, &regions[slot]);
+        release(&regions[slot]);
+    }
+
+    // Window page tables are private to the process (map_page made them)
+    U32 *pd = t->pagedir_phys;
+    for (U32 i = WINDOW_PDE_FIRST; pd && window_state > 0 && i < WINDOW_PDE_END; i++) {
+        if (!(pd[i] & PAGE_PRESENT)) continue;
+        KFREE_PAGE((ADDR)(pd[i] & ~0xFFF));
+        pd[i] = 0;
+    }
+    irq_restore(flags);
+}
@@ -0,0 +1,76 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/RTOSKRNL/SHM/SHM.h - Shared memory regions
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Runs of physical pages mapped into several page directories at once.
+    Every region gets its own range of the shared window (MEM_SHARED_BASE
+    to MEM_SHARED_END) when it is created, so a pointer into a region is
+    the same in every process that has it mapped.
+
+    A region is named, and found by other processes with SHM_OP_OPEN, or
+    anonymous and passed around by handle: mapped next to the owner with
+    SHM_OP_MAP, or moved in a PROC_MESSAGE. A message with `shm` set
+    unmaps the region from the sender and maps it into the receiver when
+    the message is fetched, so no bytes are copied (SYS_SEND_MESSAGE,
+    SYS_GET_MESSAGE).
+
+    Each process that has a region mapped and each message carrying it
+    holds one reference. The pages are freed with the last one: on
+    SHM_OP_CLOSE, when a process exits (SHM_RELEASE_PROCESS) or when a
+    queued message is thrown away.
+
+REMARKS
+    Shared with user code; STD/SHM.h wraps SYSCALL_SHM. Kernel functions
+    are under __RTOS__.
+---*/
+#ifndef RTOS_SHM_H
+#define RTOS_SHM_H
+
+#include <STD/TYPEDEF.h>
+#include <MEMORY/MEMORY.h>
+
+#define SHM_MAX_REGIONS 64
+#define SHM_NAME_MAX    32                  // including the terminator
+#define SHM_MAX_SIZE    (16 * 1024 * 1024)  // one region, physically contiguous
+
+// Handles are never 0. The low byte is the slot + 1, the rest a generation
+// count, so a handle of a freed region does not reach its successor
+#define SHM_HANDLE_SLOT(h) (((h) & 0xFF) - 1)
+
+// SYSCALL_SHM operations. Failures return 0
+typedef enum {
+    SHM_OP_CREATE = 0,  // a1 = name (NULL for anonymous), a2 = size. Maps it, returns the handle
+    SHM_OP_OPEN,        // a1 = name. Maps a named region, returns its handle
+    SHM_OP_MAP,         // a1 = handle. Maps an existing region, returns the handle
+    SHM_OP_CLOSE,       // a1 = handle. Unmaps it and drops the caller's reference. Returns TRUE
+    SHM_OP_ADDR,        // a1 = handle. Address in the shared window if the caller has it mapped
+    SHM_OP_SIZE,        // a1 = handle. Size in bytes, a multiple of PAGE_SIZE
+} SHM_OP;
+
+#ifdef __RTOS__
+struct TCB;
+
+U32 SHM_REGION_CREATE(struct TCB *t, CONST U8 *name, U32 size);
+U32 SHM_REGION_OPEN(struct TCB *t, CONST U8 *name);
+U32 SHM_REGION_MAP(struct TCB *t, U32 handle);
+BOOLEAN SHM_REGION_CLOSE(struct TCB *t, U32 handle);
+U32 SHM_REGION_ADDR(struct TCB *t, U32 handle);
+U32 SHM_REGION_SIZE(U32 handle);
+
+// Message transfer. DETACH unmaps the region from the sender but keeps its
+// reference for the message; ATTACH maps it into the receiver with that
+// reference, PUT drops it when the message is thrown away instead
+BOOLEAN SHM_REGION_DETACH(struct TCB *t, U32 handle);
+BOOLEAN SHM_REGION_ATTACH(struct TCB *t, U32 handle);
+VOID SHM_REGION_PUT(U32 handle);
+
+// Drops every region `t` has mapped or waiting in its message queue, and
+// frees its page tables in the shared window. Called by KILL_PROCESS
+VOID SHM_RELEASE_PROCESS(struct TCB *t);
+#endif // __RTOS__
+
+#endif // RTOS_SHM_H
@@ -0,0 +1,85 @@
+#include <SYSINFO/SYSINFO.h>
+#include <CPU/PIT/PIT.h>
+#include <MEMORY/PAGEFRAME/PAGEFRAME.h>
+#include <MEMORY/PAGING/PAGING.h>
+#include <MEMORY/HEAP/KHEAP.h>
+#include <VESA/VBE.h>
+#include <PROC/PROC.h>
+#include <CPU/SYSCALL/SYSCALL.h>
+#include <STD/MEM.h>
+#include <STD/ASM.h>
+
+static SYSINFO_PAGE *page ATTRIB_DATA = NULLPTR;
+
+static inline VOID write_begin(VOID) {
+    page->seq++;
+    __asm__ volatile("" ::: "memory");
+}
+
+static inline VOID write_end(VOID) {
+    __asm__ volatile("" ::: "memory");
+    page->seq++;
+}
+
+static VOID publish_stats(VOID) {
+    KHeap *kheap = KHEAP_GET_INFO();
+
+    page->proc_count = get_active_task_count();
+    page->context_switches = get_context_switches();
+    page->kheap_total = kheap ? kheap->totalSize : 0;
+    page->kheap_free = kheap ? kheap->freeSize : 0;
+    page->ram_free = GET_FREE_RAM();
+    page->ram_used = GET_USED_RAM();
+}
+
+BOOLEAN SYSINFO_INIT(VOID) {
+    if (page) return TRUE;
+    page = (SYSINFO_PAGE *)KREQUEST_PAGE();
+    if (!page) return FALSE;
+    MEMZERO(page, PAGE_SIZE);
+
+    U32 flags = irq_save();
+    write_begin();
+    page->magic = SYSINFO_MAGIC;
+    page->version = SYSINFO_VERSION;
+    page->tick_hz = PIT_TICKS_HZ;
+    if (SYSCALL_FAST_ENABLED()) page->features |= SYSINFO_FEATURE_SYSENTER;
+    if (PAGING_FEATURES() & PAGING_FEATURE_PSE) page->features |= SYSINFO_FEATURE_LARGE_PAGES;
+    if (PAGING_FEATURES() & PAGING_FEATURE_PGE) page->features |= SYSINFO_FEATURE_GLOBAL_PAGES;
+
+    VBE_MODEINFO *mode = GET_VBE_MODE();
+    if (mode) {
+        page->screen_width = mode->XResolution;
+        page->screen_height = mode->YResolution;
+        page->screen_bpp = mode->BitsPerPixel;
+        page->screen_pitch = mode->BytesPerScanLineLinear;
+    }
+    publish_stats();
+    write_end();
+    irq_restore(flags);
+    return TRUE;
+}
+
+VOID SYSINFO_MAP(U32 *pd) {
+    if (!page || !pd) return;
+    map_page(pd, SYSINFO_VADDR, (U32)page, PAGE_PRESENT);
+}
+
+VOID SYSINFO_TICK(VOID) {
+    if (!page) return;
+
+    U32 ms;
+    U32 ticks = *PIT_GET_TICKS_PTR();
+    U32 secs = CLOCK_REALTIME_S(&ms);
+
+    write_begin();
+    page->ticks = ticks;
+    page->uptime_ms = ticks * PIT_TICK_MS;
+    page->realtime_ms = ms;
+    if (secs != page->realtime_s) {
+        page->realtime_s = secs;
+        CLOCK_TO_DATE_TIME(secs, &page->date_time);
+    }
+    if (EVERY_TICKS(ticks, SYSINFO_STATS_TICKS)) publish_stats();
+    write_end();
+}
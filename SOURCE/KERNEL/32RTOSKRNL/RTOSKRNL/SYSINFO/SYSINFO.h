@@ -0,0 +1,88 @@
+/*+++
+    SOURCE/KERNEL/32RTOSKRNL/RTOSKRNL/SYSINFO/SYSINFO.h - Shared system information page
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    One kernel-maintained page, mapped read-only at SYSINFO_VADDR into every
+    process. It carries the tick count, the wall clock, screen geometry and a
+    few system counters, so programs can poll them without a syscall.
+
+    The kernel is the only writer. It bumps `seq` to an odd value before an
+    update and to the next even value after it; readers copy the fields and
+    retry if `seq` was odd or changed meanwhile. STD/SYSINFO.h wraps this.
+
+REMARKS
+    Shared with user code via SYSINFO_ONLY_DEFINES. Only append fields and
+    bump SYSINFO_VERSION.
+---*/
+#ifndef SYSINFO_H
+#define SYSINFO_H
+
+#include <STD/TYPEDEF.h>
+#ifdef SYSINFO_ONLY_DEFINES
+#define CMOS_ONLY_DEFINES
+#include <DRIVERS/CMOS/CMOS.h>
+#undef CMOS_ONLY_DEFINES
+#else
+#include <DRIVERS/CMOS/CMOS.h>
+#endif
+
+#define SYSINFO_VADDR       0x1FFFF000  // last page of the user space window
+#define SYSINFO_MAGIC       0x4F464E49  // "INFO"
+#define SYSINFO_VERSION     2
+
+#define SYSINFO_STATS_TICKS 10          // counters refresh period
+
+// SYSINFO_PAGE.features
+#define SYSINFO_FEATURE_SYSENTER 0x01   // SYSCALL() enters with SYSENTER instead of int 0x80
+#define SYSINFO_FEATURE_LARGE_PAGES 0x02 // 4 MB pages where the mapping allows
+#define SYSINFO_FEATURE_GLOBAL_PAGES 0x04 // kernel TLB entries survive task switches
+
+typedef struct {
+    U32 magic;
+    U32 version;
+    volatile U32 seq;           // odd while the kernel is writing
+
+    // Time, every PIT tick
+    U32 ticks;                  // PIT ticks since boot
+    U32 tick_hz;
+    U32 uptime_ms;
+    U32 realtime_s;             // CLOCK_REALTIME
+    U32 realtime_ms;
+    RTC_DATE_TIME date_time;    // realtime_s broken down
+
+    // Screen, set at boot
+    U32 screen_width;
+    U32 screen_height;
+    U32 screen_bpp;
+    U32 screen_pitch;           // bytes per scanline
+
+    // Counters, every SYSINFO_STATS_TICKS
+    U32 proc_count;
+    U32 context_switches;
+    U32 kheap_total;            // bytes
+    U32 kheap_free;
+    U32 ram_free;
+    U32 ram_used;
+
+    // Version 2, set at boot
+    U32 features;               // SYSINFO_FEATURE_* bits
+} SYSINFO_PAGE;
+
+#ifndef SYSINFO_ONLY_DEFINES
+
+/// Allocates and fills the page. Call after PAGING_INIT.
+BOOLEAN SYSINFO_INIT(VOID);
+
+/// Maps the page read-only into a process page directory.
+VOID SYSINFO_MAP(U32 *pd);
+
+/// Publishes the time fields, and the counters every SYSINFO_STATS_TICKS.
+/// Called from the PIT interrupt.
+VOID SYSINFO_TICK(VOID);
+
+#endif // SYSINFO_ONLY_DEFINES
+#endif // SYSINFO_H
@@ -23,6 +23,8 @@ void rtos_kernel(U0) {
     KDEBUG_PUTS("[atOS] ISR OK\n");
     fpu_enable();
     KDEBUG_PUTS("[atOS] FPU OK\n");
+    if (TSC_INIT()) KDEBUG_PUTS("[atOS] TSC OK\n");
+    if (SYSCALL_FAST_INIT()) KDEBUG_PUTS("[atOS] SYSENTER OK\n");
 
     panic_if(!vesa_check(), PANIC_TEXT("Failed to initialize VESA"), PANIC_INITIALIZATION_FAILED);
     panic_if(!vbe_check(), PANIC_TEXT("Failed to initialize VBE"), PANIC_INITIALIZATION_FAILED);
@@ -42,6 +44,12 @@ void rtos_kernel(U0) {
     KDEBUG_PUTS("[atOS] E820 REINIT OK\n");
     panic_if(!PAGING_INIT(), PANIC_TEXT("Failed to initialize paging!"), PANIC_INITIALIZATION_FAILED);
     KDEBUG_PUTS("[atOS] PAGING OK\n");
+    VBE_FRAMEBUFFER_WC_INIT();
+    VBE_PAGE_FLIP_INIT();
+    panic_if(!SYSINFO_INIT(), PANIC_TEXT("Failed to initialize SYSINFO page!"), PANIC_INITIALIZATION_FAILED);
+    KDEBUG_PUTS("[atOS] SYSINFO OK\n");
+    panic_if(!TRACE_INIT(), PANIC_TEXT("Failed to initialize kernel trace ring!"), PANIC_INITIALIZATION_FAILED);
+    KDEBUG_PUTS("[atOS] TRACE OK\n");
 
     
     panic_if(!PS2_KEYBOARD_INIT(), PANIC_TEXT("Failed to initialize PS2 keyboard"), PANIC_INITIALIZATION_FAILED);
@@ -66,6 +74,7 @@ void rtos_kernel(U0) {
     debug_vram_end(); // End early mode, now using task framebuffers
     init_multitasking();
     INIT_RTC();
+    SERIAL_IRQ_INIT();
     KDEBUG_PUTS("[atOS] RTC init OK\n");
     STI;
 
@@ -39,6 +39,8 @@ VOID ATGL_CREATE_SCREEN(ATGL_SCREEN_ATTRIBS attrs)
     atgl.focus  = NULLPTR;
     atgl.next_id = 1;
     atgl.needs_full_clear = TRUE;
+    atgl.damage_count = 0;
+    atgl_clip_reset();
 
     /* Create root node spanning the entire screen */
     atgl.root = ATGL_NODE_CREATE(
@@ -107,6 +109,7 @@ VOID ATGL_INIT(VOID)
         atgl.cursor.previous_buffer = NULLPTR;
     }
 
+    atgl_clip_reset();
     DEBUG_PRINTF("[ATGL] Initialized (%dx%d)\n", atgl.width, atgl.height);
     
 }
@@ -148,8 +151,19 @@ BOOL ATGL_SHOULD_QUIT(VOID) { return atgl.quit;  }
 /*              DIRECT FRAMEBUFFER RENDERING                        */
 /* ================================================================ */
 /* All helpers write to the per-process framebuffer obtained from
-   TCB during ATGL_INIT.  They perform clipping against the screen
-   dimensions and support 3-byte and 4-byte pixel formats.          */
+   TCB during ATGL_INIT.  They clip against atgl.clip (the screen
+   outside the render pass) and support 3-byte and 4-byte pixel
+   formats.                                                         */
+
+/* Narrows x/y/w/h to atgl.clip.  FALSE when nothing is left. */
+static inline BOOL fb_clip(I32 *x, I32 *y, I32 *w, I32 *h)
+{
+    ATGL_RECT r = { *x, *y, *w, *h }, vis;
+    if (!ATGL_RECT_INTERSECT(&r, &atgl.clip, &vis)) return FALSE;
+    *x = vis.x; *y = vis.y;
+    *w = vis.w; *h = vis.h;
+    return TRUE;
+}
 
 static inline VOID fb_write_pixel_at(U8 *fb, U32 offset, VBE_COLOUR c, U32 bpp)
 {
@@ -195,16 +209,11 @@ static inline VOID fb_fill_span24(U8 *dst, I32 pixels, VBE_COLOUR colour)
 VOID atgl_fb_hline(I32 x, I32 y, I32 w, VBE_COLOUR colour)
 {
     if (colour == VBE_SEE_THROUGH) return;
+    I32 h = 1;
+    if (!fb_clip(&x, &y, &w, &h)) return;
     U8 *fb = (U8 *)atgl.cursor.framebuffer;
     if (!fb) { DRAW_LINE(x, y, x + w - 1, y, colour); return; }
 
-    /* Clip */
-    if (y < 0 || (U32)y >= atgl.height || w <= 0) return;
-    if (x < 0) { w += x; x = 0; }
-    if (w <= 0) return;
-    if ((U32)(x + w) > atgl.width) w = (I32)atgl.width - x;
-    if (w <= 0) return;
-
     U32 bpp    = atgl.bpp;
     U32 stride = atgl.cursor.stride;
     U32 offset = (U32)y * stride + (U32)x * bpp;
@@ -220,15 +229,11 @@ VOID atgl_fb_hline(I32 x, I32 y, I32 w, VBE_COLOUR colour)
 VOID atgl_fb_vline(I32 x, I32 y, I32 h, VBE_COLOUR colour)
 {
     if (colour == VBE_SEE_THROUGH) return;
+    I32 w = 1;
+    if (!fb_clip(&x, &y, &w, &h)) return;
     U8 *fb = (U8 *)atgl.cursor.framebuffer;
     if (!fb) { DRAW_LINE(x, y, x, y + h - 1, colour); return; }
 
-    if (x < 0 || (U32)x >= atgl.width || h <= 0) return;
-    if (y < 0) { h += y; y = 0; }
-    if (h <= 0) return;
-    if ((U32)(y + h) > atgl.height) h = (I32)atgl.height - y;
-    if (h <= 0) return;
-
     U32 bpp    = atgl.bpp;
     U32 stride = atgl.cursor.stride;
     U32 base   = (U32)y * stride + (U32)x * bpp;
@@ -252,18 +257,10 @@ VOID atgl_fb_vline(I32 x, I32 y, I32 h, VBE_COLOUR colour)
 VOID atgl_fb_fill(I32 x, I32 y, I32 w, I32 h, VBE_COLOUR colour)
 {
     if (colour == VBE_SEE_THROUGH) return;
+    if (!fb_clip(&x, &y, &w, &h)) return;
     U8 *fb = (U8 *)atgl.cursor.framebuffer;
     if (!fb) { DRAW_FILLED_RECTANGLE(x, y, w, h, colour); return; }
 
-    /* Clip */
-    if (w <= 0 || h <= 0) return;
-    if (x < 0) { w += x; x = 0; }
-    if (y < 0) { h += y; y = 0; }
-    if (w <= 0 || h <= 0) return;
-    if ((U32)(x + w) > atgl.width)  w = (I32)atgl.width  - x;
-    if ((U32)(y + h) > atgl.height) h = (I32)atgl.height - y;
-    if (w <= 0 || h <= 0) return;
-
     U32 bpp    = atgl.bpp;
     U32 stride = atgl.cursor.stride;
 
@@ -289,6 +286,47 @@ VOID atgl_fb_rect(I32 x, I32 y, I32 w, I32 h, VBE_COLOUR colour)
     atgl_fb_vline(x + w - 1, y + 1, h - 2, colour); /* right */
 }
 
+/* ================================================================ */
+/*                  CLIPPED KERNEL DRAWING                          */
+/* ================================================================ */
+/* The kernel clips batched commands to a DRAW_SET_CLIP rectangle,
+   so a kernel-drawn shape that crosses the clip edge is recorded
+   into this batch behind the clip and submitted at once.  Shapes
+   fully inside go straight through as before.  Draws that overflow
+   the batch are submitted in pieces, each behind the same clip.    */
+
+#define ATGL_CLIP_BATCH_WORDS \
+    (VBE_CMD_CLIP_WORDS + 4 * VBE_CMD_SHAPE_WORDS + VBE_CMD_GLYPHS_WORDS(ATGL_TEXTINPUT_MAX))
+
+static U32 clip_words[ATGL_CLIP_BATCH_WORDS];
+static DRAW_BATCH clip_batch ATTRIB_DATA = { clip_words, 0, ATGL_CLIP_BATCH_WORDS, 0 };
+static BOOL clip_batching ATTRIB_DATA = FALSE;
+
+VOID atgl_clip_reset(VOID)
+{
+    atgl.clip = (ATGL_RECT){ 0, 0, (I32)atgl.width, (I32)atgl.height };
+}
+
+BOOL atgl_clip_begin(I32 x, I32 y, I32 w, I32 h)
+{
+    ATGL_RECT box = { x, y, w, h }, vis;
+    if (!ATGL_RECT_INTERSECT(&box, &atgl.clip, &vis)) return FALSE;
+    if (vis.w == w && vis.h == h) return TRUE;
+
+    DRAW_BATCH_BEGIN(&clip_batch);
+    DRAW_SET_CLIP(atgl.clip.x, atgl.clip.y,
+                  (U32)atgl.clip.w, (U32)atgl.clip.h);
+    clip_batching = TRUE;
+    return TRUE;
+}
+
+VOID atgl_clip_end(VOID)
+{
+    if (!clip_batching) return;
+    clip_batching = FALSE;
+    DRAW_BATCH_END();
+}
+
 /* ================================================================ */
 /*                     DRAWING HELPERS                              */
 /* ================================================================ */
@@ -338,7 +376,10 @@ VOID ATGL_DRAW_SUNKEN(I32 x, I32 y, I32 w, I32 h)
 VOID ATGL_DRAW_TEXT(I32 x, I32 y, PU8 text, VBE_COLOUR fg, VBE_COLOUR bg)
 {
     if (!text) return;
+    I32 w = (I32)(STRLEN(text) * atgl.theme.char_w);
+    if (!atgl_clip_begin(x, y, w, (I32)atgl.theme.char_h)) return;
     DRAW_8x8_STRING(x, y, text, fg, bg);
+    atgl_clip_end();
 }
 
 VOID ATGL_DRAW_TEXT_CLIPPED(I32 x, I32 y, I32 max_w, PU8 text,
@@ -349,6 +390,10 @@ VOID ATGL_DRAW_TEXT_CLIPPED(I32 x, I32 y, I32 max_w, PU8 text,
     U32 char_w    = atgl.theme.char_w;
     U32 max_chars = (U32)max_w / char_w;
     U32 len       = STRLEN(text);
+    U32 shown     = (len < max_chars) ? len : max_chars;
+
+    if (!atgl_clip_begin(x, y, (I32)(shown * char_w), (I32)atgl.theme.char_h))
+        return;
 
     if (len <= max_chars) {
         /* Whole string fits — single batched syscall */
@@ -362,6 +407,7 @@ VOID ATGL_DRAW_TEXT_CLIPPED(I32 x, I32 y, I32 max_w, PU8 text,
         buf[max_chars] = '\0';
         DRAW_8x8_STRING(x, y, (PU8)buf, fg, bg);
     }
+    atgl_clip_end();
 }
 
 /* ================================================================ */
@@ -383,16 +429,22 @@ VOID ATGL_LAYOUT_APPLY(PATGL_NODE panel)
         PATGL_NODE child = panel->children[i];
         if (!child->visible) continue;
 
+        I32 x = child->rect.x, y = child->rect.y;
         if (is_vert) {
-            child->rect.x = pad;
-            child->rect.y = offset;
+            x = pad;
+            y = offset;
             offset += child->rect.h + space;
         } else if (is_horz) {
-            child->rect.x = offset;
-            child->rect.y = pad;
+            x = offset;
+            y = pad;
             offset += child->rect.w + space;
         }
-        ATGL_NODE_INVALIDATE(child);
+        /* Only children that actually move need repainting */
+        if (x != child->rect.x || y != child->rect.y) {
+            child->rect.x = x;
+            child->rect.y = y;
+            ATGL_NODE_INVALIDATE(child);
+        }
     }
 }
 
@@ -414,7 +466,8 @@ VOID ATGL_CENTER_IN_SCREEN(PATGL_NODE node)
 }
 
 VOID ATGL_DRAW_PIXEL(U32 x, U32 y, VBE_COLOUR colour) {
-    if (atgl.cursor.framebuffer && x < atgl.width && y < atgl.height) {
+    if (!ATGL_RECT_CONTAINS(&atgl.clip, (I32)x, (I32)y)) return;
+    if (atgl.cursor.framebuffer) {
         fb_write_pixel_at((U8 *)atgl.cursor.framebuffer,
                           y * atgl.cursor.stride + x * atgl.bpp,
                           colour, atgl.bpp);
@@ -438,17 +491,39 @@ VOID ATGL_DRAW_LINE(U32 x1, U32 y1, U32 x2, U32 y2, VBE_COLOUR colour) {
         I32 h = (I32)((y1 < y2) ? y2 - y1 : y1 - y2) + 1;
         atgl_fb_vline((I32)x1, y, h, colour);
     } else {
+        I32 x0 = (x1 < x2) ? (I32)x1 : (I32)x2;
+        I32 y0 = (y1 < y2) ? (I32)y1 : (I32)y2;
+        I32 w  = (I32)((x1 < x2) ? x2 - x1 : x1 - x2) + 1;
+        I32 h  = (I32)((y1 < y2) ? y2 - y1 : y1 - y2) + 1;
+        if (!atgl_clip_begin(x0, y0, w, h)) return;
         DRAW_LINE(x1, y1, x2, y2, colour);
+        atgl_clip_end();
     }
 }
 VOID ATGL_DRAW_FILLED_ELLIPSE(U32 x, U32 y, U32 rx, U32 ry, VBE_COLOUR colour) {
+    if (!atgl_clip_begin((I32)(x - rx), (I32)(y - ry),
+                         (I32)(2 * rx + 1), (I32)(2 * ry + 1))) return;
     DRAW_FILLED_ELLIPSE(x, y, rx, ry, colour);
+    atgl_clip_end();
 }
 
 
+static BOOL atgl_clip_begin_triangle(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3) {
+    U32 x0 = x1 < x2 ? x1 : x2, xe = x1 > x2 ? x1 : x2;
+    U32 y0 = y1 < y2 ? y1 : y2, ye = y1 > y2 ? y1 : y2;
+    if (x3 < x0) x0 = x3;
+    if (x3 > xe) xe = x3;
+    if (y3 < y0) y0 = y3;
+    if (y3 > ye) ye = y3;
+    return atgl_clip_begin((I32)x0, (I32)y0, (I32)(xe - x0) + 1, (I32)(ye - y0) + 1);
+}
 VOID ATGL_DRAW_TRIANGLE(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, VBE_COLOUR colour) {
+    if (!atgl_clip_begin_triangle(x1, y1, x2, y2, x3, y3)) return;
     DRAW_TRIANGLE(x1, y1, x2, y2, x3, y3, colour);
+    atgl_clip_end();
 }
 VOID ATGL_DRAW_FILLED_TRIANGLE(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, VBE_COLOUR colour) {
+    if (!atgl_clip_begin_triangle(x1, y1, x2, y2, x3, y3)) return;
     DRAW_FILLED_TRIANGLE(x1, y1, x2, y2, x3, y3, colour);
+    atgl_clip_end();
 }
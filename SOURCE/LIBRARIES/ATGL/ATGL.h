@@ -224,6 +224,7 @@ BOOL ATGL_IMAGE_SAVE(PATGL_NODE node, const CHAR *filename);
 BOOL ATGL_POLL_EVENTS(ATGL_EVENT *ev);
 VOID ATGL_DISPATCH_EVENT(PATGL_NODE root, ATGL_EVENT *ev);
 VOID ATGL_RENDER_TREE(PATGL_NODE root);
+VOID ATGL_GET_RENDER_STATS(ATGL_RENDER_STATS *out);
 
 /* ================================================================ */
 /*                          FOCUS                                   */
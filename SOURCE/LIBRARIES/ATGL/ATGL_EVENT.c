@@ -310,7 +310,8 @@ static VOID atgl_cursor_show(I32 mx, I32 my)
    redundant invalidations during rendering. */
 static VOID layout_recursive(PATGL_NODE node)
 {
-    if (!node || !node->visible || !node->dirty) return;
+    if (!node || !node->visible) return;
+    if (!node->dirty && !node->child_dirty) return;
 
     if (node->type == ATGL_NODE_PANEL &&
         node->data.panel.layout != ATGL_LAYOUT_NONE)
@@ -323,66 +324,250 @@ static VOID layout_recursive(PATGL_NODE node)
     }
 }
 
-static VOID render_recursive(PATGL_NODE node, I32 px, I32 py, BOOL force)
+/* ---- Damage rectangles ---- */
+
+static inline U32 rect_area(CONST ATGL_RECT *r)
+{
+    return (U32)r->w * (U32)r->h;
+}
+
+static ATGL_RECT rect_union(CONST ATGL_RECT *a, CONST ATGL_RECT *b)
+{
+    I32 x0 = (a->x < b->x) ? a->x : b->x;
+    I32 y0 = (a->y < b->y) ? a->y : b->y;
+    I32 x1 = (a->x + a->w > b->x + b->w) ? a->x + a->w : b->x + b->w;
+    I32 y1 = (a->y + a->h > b->y + b->h) ? a->y + a->h : b->y + b->h;
+    return (ATGL_RECT){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+/* Two rects are merged when their union costs no more pixels than
+   painting both, so overlapping and side-by-side pieces fold into
+   one while distant widgets stay separate.  Past ATGL_MAX_DAMAGE a
+   rect joins the one it grows least. */
+static VOID damage_add(ATGL_RECT r)
+{
+    ATGL_RECT screen = { 0, 0, (I32)atgl.width, (I32)atgl.height };
+    if (!ATGL_RECT_INTERSECT(&r, &screen, &r)) return;
+
+    for (U32 i = 0; i < atgl.damage_count; ) {
+        ATGL_RECT u = rect_union(&atgl.damage[i], &r);
+        if (rect_area(&u) <= rect_area(&atgl.damage[i]) + rect_area(&r)) {
+            /* The union may now reach rects already passed */
+            atgl.damage[i] = atgl.damage[--atgl.damage_count];
+            r = u;
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+
+    if (atgl.damage_count == ATGL_MAX_DAMAGE) {
+        U32 best = 0, best_growth = U32_MAX;
+        for (U32 i = 0; i < atgl.damage_count; i++) {
+            ATGL_RECT u = rect_union(&atgl.damage[i], &r);
+            U32 growth = rect_area(&u) - rect_area(&atgl.damage[i]);
+            if (growth < best_growth) {
+                best_growth = growth;
+                best = i;
+            }
+        }
+        r = rect_union(&atgl.damage[best], &r);
+        atgl.damage[best] = atgl.damage[--atgl.damage_count];
+        damage_add(r);
+        return;
+    }
+    atgl.damage[atgl.damage_count++] = r;
+}
+
+/* TRUE if a later (drawn on top), clean, opaque sibling of node or
+   of one of its ancestors covers area.  Dirty nodes may be about to
+   move, so they never hide anything. */
+static BOOL hidden_by_siblings(PATGL_NODE node, CONST ATGL_RECT *area)
+{
+    for (PATGL_NODE n = node; n->parent; n = n->parent) {
+        PATGL_NODE p = n->parent;
+        BOOL after = FALSE;
+        for (U32 i = 0; i < p->child_count; i++) {
+            PATGL_NODE s = p->children[i];
+            if (s == n) { after = TRUE; continue; }
+            if (!after || !s->visible || s->dirty) continue;
+            if (atgl_node_opaque(s) && ATGL_RECT_COVERS(&s->abs_rect, area))
+                return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static VOID damage_unless_hidden(PATGL_NODE node, ATGL_RECT r)
+{
+    if (r.w <= 0 || r.h <= 0) return;
+    if (hidden_by_siblings(node, &r)) atgl.stats.occluded++;
+    else damage_add(r);
+}
+
+/* Turns dirty flags into damage, refreshing abs_rect on the way.
+   Until then abs_rect still holds where the node was last painted,
+   so a dirty node damages both its old and new bounds.  Its subtree
+   is repainted with it, so below that point the walk only updates
+   positions and clears flags.  Clean subtrees are not entered. */
+static VOID collect_damage(PATGL_NODE node, I32 px, I32 py, BOOL covered)
 {
     if (!node || !node->visible) return;
 
-    /* Compute absolute position from parent origin */
+    ATGL_RECT old = atgl_node_paint_bounds(node);
     atgl_compute_abs_rect(node, px, py);
 
-    BOOL render_this = force || node->dirty;
+    if (node->dirty && !covered) {
+        ATGL_RECT bounds = atgl_node_paint_bounds(node);
+        damage_unless_hidden(node, bounds);
+        if (!ATGL_RECT_COVERS(&bounds, &old)) damage_unless_hidden(node, old);
+        covered = TRUE;
+    }
+
+    if (covered || node->child_dirty) {
+        for (U32 i = 0; i < node->child_count; i++) {
+            collect_damage(node->children[i],
+                           node->abs_rect.x, node->abs_rect.y, covered);
+        }
+    }
+
+    node->dirty       = FALSE;
+    node->child_dirty = FALSE;
+}
 
-    /* With upward dirty propagation (ATGL_NODE_INVALIDATE), a clean
-       node guarantees all descendants are also clean — skip the
-       entire subtree in O(1). */
-    if (!render_this) return;
+/* ---- Painting ---- */
 
-    /* Render this node */
-    if (node->fn_render) {
-        node->fn_render(node);
+/* TRUE if the later opaque siblings of parent->children[index]
+   cover area, which is inside the parent's clip. */
+static BOOL covered_by_later(PATGL_NODE parent, U32 index, CONST ATGL_RECT *area)
+{
+    for (U32 j = index + 1; j < parent->child_count; j++) {
+        PATGL_NODE s = parent->children[j];
+        if (s->visible && atgl_node_opaque(s) &&
+            ATGL_RECT_COVERS(&s->abs_rect, area))
+            return TRUE;
     }
+    return FALSE;
+}
 
-    /* Render children */
-    for (U32 i = 0; i < node->child_count; i++) {
-        render_recursive(node->children[i],
-                         node->abs_rect.x, node->abs_rect.y, render_this);
+/* Repaints the part of node's subtree inside clip.  The node draws
+   within clip and its own paint bounds; its children within clip and
+   the node's rect, so nothing spills out of its parent.  Children
+   outside the clip, or hidden there behind a later opaque sibling,
+   are skipped with their subtrees, and a node whose area is covered
+   by an opaque child skips its own fn_render. */
+static VOID paint_recursive(PATGL_NODE node, CONST ATGL_RECT *clip)
+{
+    ATGL_RECT bounds = atgl_node_paint_bounds(node);
+    ATGL_RECT area, inner;
+    if (!ATGL_RECT_INTERSECT(&bounds, clip, &area)) {
+        atgl.stats.clipped++;
+        return;
+    }
+    BOOL has_inner = ATGL_RECT_INTERSECT(&node->abs_rect, clip, &inner);
+
+    BOOL self_hidden = FALSE;
+    if (has_inner && ATGL_RECT_COVERS(&inner, &area)) {
+        for (U32 i = 0; i < node->child_count && !self_hidden; i++) {
+            PATGL_NODE c = node->children[i];
+            self_hidden = c->visible && atgl_node_opaque(c) &&
+                          ATGL_RECT_COVERS(&c->abs_rect, &area);
+        }
+    }
+
+    if (self_hidden) {
+        atgl.stats.occluded++;
+    } else {
+        atgl.clip = area;
+        if (node->fn_render) {
+            node->fn_render(node);
+        } else if (node->type == ATGL_NODE_ROOT) {
+            atgl_fb_fill(area.x, area.y, area.w, area.h, atgl.theme.bg);
+        }
+        atgl.stats.painted++;
     }
 
-    node->dirty = FALSE;
+    if (!has_inner) return;
+    for (U32 i = 0; i < node->child_count; i++) {
+        PATGL_NODE c = node->children[i];
+        if (!c->visible) continue;
+
+        ATGL_RECT cb = atgl_node_paint_bounds(c), carea;
+        if (!ATGL_RECT_INTERSECT(&cb, &inner, &carea)) {
+            atgl.stats.clipped++;
+            continue;
+        }
+        if (covered_by_later(node, i, &carea)) {
+            atgl.stats.occluded++;
+            continue;
+        }
+        paint_recursive(c, &inner);
+    }
 }
 
 VOID ATGL_RENDER_TREE(PATGL_NODE root)
 {
-    if (!root) return;
+    if (!root || !root->visible) return;
 
-    /* 1. Restore framebuffer under the old cursor position so it
-          does not interfere with rendering or get "baked in". */
-    atgl_cursor_hide();  
+    ATGL_CURSOR *c = &atgl.cursor;
+    MEMSET_OPT(&atgl.stats, 0, sizeof(atgl.stats));
 
-    /* 2. Pre-render layout pass: reposition children of dirty panels
+    /* 1. Pre-render layout pass: reposition children of dirty panels
           BEFORE any drawing occurs, so the render pass sees final
           positions and does not trigger redundant invalidations. */
     layout_recursive(root);
 
-    /* 3. Render dirty sub-trees.  Only do a full screen clear on
-          first frame, theme change, or screen resize — not on every
-          single child invalidation that bubbles up to root. */
-    BOOL force = FALSE;
+    /* 2. Gather what changed into damage rectangles.  Only the first
+          frame and theme changes repaint the whole screen. */
     if (atgl.needs_full_clear) {
-        atgl_fb_fill(0, 0, (I32)atgl.width, (I32)atgl.height,
-                     atgl.theme.bg);
-        force = TRUE;
+        damage_add((ATGL_RECT){ 0, 0, (I32)atgl.width, (I32)atgl.height });
         atgl.needs_full_clear = FALSE;
     }
-    render_recursive(root, 0, 0, force);
+    collect_damage(root, 0, 0, FALSE);
 
-    /* 4. Save the screen content at the new cursor position and draw
+    BOOL cursor_moved = !c->has_saved ||
+                        c->x != (U32)atgl.last_mouse_x ||
+                        c->y != (U32)atgl.last_mouse_y;
+    if (!atgl.damage_count && !cursor_moved) return;
+
+    /* 3. Restore framebuffer under the old cursor position so it
+          does not interfere with rendering or get "baked in". */
+    ATGL_RECT old_cursor = { (I32)c->x, (I32)c->y, (I32)c->width, (I32)c->height };
+    atgl_cursor_hide();
+
+    /* 4. Repaint each damage rectangle, clipped to it */
+    for (U32 i = 0; i < atgl.damage_count; i++) {
+        paint_recursive(root, &atgl.damage[i]);
+        atgl.stats.pixels += rect_area(&atgl.damage[i]);
+    }
+    atgl_clip_reset();
+
+    /* 5. Save the screen content at the new cursor position and draw
           the cursor on top.  This uses direct framebuffer access —
           no syscalls needed for the cursor itself. */
     atgl_cursor_show(atgl.last_mouse_x, atgl.last_mouse_y);
 
-    /* 5. Push to display */
-    FLUSH_VRAM();
+    /* 6. Push the damage and both cursor positions to the display */
+    VBE_RECT rects[ATGL_MAX_DAMAGE + 2];
+    U32 n = 0;
+    for (U32 i = 0; i < atgl.damage_count; i++) {
+        ATGL_RECT *d = &atgl.damage[i];
+        rects[n++] = (VBE_RECT){ (U32)d->x, (U32)d->y, (U32)d->w, (U32)d->h };
+    }
+    if (cursor_moved) {
+        rects[n++] = (VBE_RECT){ (U32)old_cursor.x, (U32)old_cursor.y,
+                                 (U32)old_cursor.w, (U32)old_cursor.h };
+        rects[n++] = (VBE_RECT){ c->x, c->y, c->width, c->height };
+    }
+    FLUSH_VRAM_RECTS(rects, n);
+
+    atgl.stats.rects  = atgl.damage_count;
+    atgl.damage_count = 0;
+}
+
+VOID ATGL_GET_RENDER_STATS(ATGL_RENDER_STATS *out)
+{
+    if (out) *out = atgl.stats;
 }
 
 /* ================================================================ */
@@ -16,6 +16,10 @@
 #define ATGL_SCREEN_HEIGHT 768
 #endif
 
+/* Damage rectangles kept per frame; more are merged into the
+   closest one */
+#define ATGL_MAX_DAMAGE    16
+
 /* Mouse cursor dimensions */
 #define ATGL_CURSOR_WIDTH  8
 #define ATGL_CURSOR_HEIGHT 12
@@ -62,6 +66,12 @@ typedef struct {
 
     /* Mouse cursor */
     ATGL_CURSOR cursor;
+
+    /* Render pass */
+    ATGL_RECT clip;                     /* Drawing stays inside, screen between frames */
+    ATGL_RECT damage[ATGL_MAX_DAMAGE];  /* Areas to repaint and flush next frame */
+    U32       damage_count;
+    ATGL_RENDER_STATS stats;
 } ATGL_STATE;
 
 typedef struct _ATGL_IMAGE_HEADER {
@@ -96,6 +106,24 @@ VOID atgl_fb_hline(I32 x, I32 y, I32 w, VBE_COLOUR colour);
 /* Vertical line — O(h) single-pixel writes, no syscalls. */
 VOID atgl_fb_vline(I32 x, I32 y, I32 h, VBE_COLOUR colour);
 
+/* Glyphs, diagonal lines, ellipses and triangles are drawn by the
+   kernel.  Wrap them in atgl_clip_begin / atgl_clip_end with their
+   bounding box:
+   begin returns FALSE when the box is outside atgl.clip (skip the
+   draw), and routes the draw through a clipped DRAW_BATCH when the
+   box crosses the clip edge. */
+BOOL atgl_clip_begin(I32 x, I32 y, I32 w, I32 h);
+VOID atgl_clip_end(VOID);
+VOID atgl_clip_reset(VOID);
+
+/* Area a node's fn_render may touch: abs_rect plus room for the
+   focus ring. Implemented in ATGL_WIDGETS.c */
+ATGL_RECT atgl_node_paint_bounds(PATGL_NODE node);
+
+/* TRUE if fn_render paints every pixel of abs_rect with an opaque
+   colour, so nodes below it there need no painting. */
+BOOL atgl_node_opaque(PATGL_NODE node);
+
 /* Internal helpers (implemented in ATGL_NODE.c) */
 VOID       atgl_compute_abs_rect(PATGL_NODE node, I32 parent_x, I32 parent_y);
 PATGL_NODE atgl_hit_test_recursive(PATGL_NODE node, I32 x, I32 y);
@@ -173,11 +173,11 @@ VOID ATGL_NODE_INVALIDATE(PATGL_NODE node)
     /* Mark this node dirty */
     node->dirty = TRUE;
 
-    /* Propagate upward so the render pass never skips
-       a clean ancestor whose subtree contains dirty nodes. */
+    /* Propagate upward so the render pass finds dirty nodes
+       without walking clean subtrees. */
     PATGL_NODE p = node->parent;
-    while (p && !p->dirty) {
-        p->dirty = TRUE;
+    while (p && !p->child_dirty) {
+        p->child_dirty = TRUE;
         p = p->parent;
     }
 }
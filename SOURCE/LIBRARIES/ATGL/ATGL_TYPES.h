@@ -33,6 +33,32 @@ static inline BOOL ATGL_RECT_CONTAINS(ATGL_RECT *r, I32 px, I32 py)
             py >= r->y && py < r->y + r->h);
 }
 
+/* Overlap of a and b in *out.  FALSE (and an empty *out) when they
+   do not overlap. */
+static inline BOOL ATGL_RECT_INTERSECT(CONST ATGL_RECT *a, CONST ATGL_RECT *b,
+                                       ATGL_RECT *out)
+{
+    I32 x0 = (a->x > b->x) ? a->x : b->x;
+    I32 y0 = (a->y > b->y) ? a->y : b->y;
+    I32 x1 = (a->x + a->w < b->x + b->w) ? a->x + a->w : b->x + b->w;
+    I32 y1 = (a->y + a->h < b->y + b->h) ? a->y + a->h : b->y + b->h;
+
+    if (x1 <= x0 || y1 <= y0) {
+        *out = (ATGL_RECT){ 0, 0, 0, 0 };
+        return FALSE;
+    }
+    *out = (ATGL_RECT){ x0, y0, x1 - x0, y1 - y0 };
+    return TRUE;
+}
+
+/* TRUE if every pixel of inner lies inside outer */
+static inline BOOL ATGL_RECT_COVERS(CONST ATGL_RECT *outer, CONST ATGL_RECT *inner)
+{
+    return (inner->x >= outer->x && inner->y >= outer->y &&
+            inner->x + inner->w <= outer->x + outer->w &&
+            inner->y + inner->h <= outer->y + outer->h);
+}
+
 /* ================================================================ */
 /*                       SCREEN ATTRIBUTES                          */
 /* ================================================================ */
@@ -116,6 +142,19 @@ typedef struct {
     BOOL handled;
 } ATGL_EVENT;
 
+/* ================================================================ */
+/*                       RENDER STATISTICS                          */
+/* ================================================================ */
+
+/* What the last ATGL_RENDER_TREE did (see ATGL_GET_RENDER_STATS) */
+typedef struct {
+    U32 rects;      /* Damage rectangles repainted and flushed   */
+    U32 pixels;     /* Pixels they cover                         */
+    U32 painted;    /* fn_render calls                           */
+    U32 clipped;    /* Nodes skipped, outside the damage or clip */
+    U32 occluded;   /* Nodes skipped, hidden by opaque nodes     */
+} ATGL_RENDER_STATS;
+
 /* ================================================================ */
 /*                            THEME                                 */
 /* ================================================================ */
@@ -283,7 +322,8 @@ struct _ATGL_NODE {
     BOOL visible;
     BOOL enabled;
     BOOL focused;
-    BOOL dirty;
+    BOOL dirty;             /* Must be repainted                 */
+    BOOL child_dirty;       /* Some descendant must be repainted */
     BOOL focusable;         /* Can receive keyboard focus        */
 
     VBE_COLOUR fg;
@@ -166,8 +166,11 @@ static VOID render_checkbox(PATGL_NODE node)
     if (cd->checked) {
         I32 cx = r->x + 3;
         I32 cy = box_y + 3;
-        DRAW_LINE(cx,     cy,     cx + 5, cy + 5, t->check_mark);
-        DRAW_LINE(cx + 5, cy,     cx,     cy + 5, t->check_mark);
+        if (atgl_clip_begin(cx, cy, 6, 6)) {
+            DRAW_LINE(cx,     cy,     cx + 5, cy + 5, t->check_mark);
+            DRAW_LINE(cx + 5, cy,     cx,     cy + 5, t->check_mark);
+            atgl_clip_end();
+        }
     }
 
     /* Label */
@@ -209,7 +212,11 @@ static VOID render_radio(PATGL_NODE node)
     atgl_fb_fill(r->x, r->y, r->w, r->h, bg);
 
     // Draw border (outer ellipse)
-    DRAW_ELLIPSE(cx, cy, circle_sz / 2, circle_sz / 2, t->widget_border);
+    I32 rad = (I32)circle_sz / 2;
+    if (atgl_clip_begin(cx - rad, cy - rad, 2 * rad + 1, 2 * rad + 1)) {
+        DRAW_ELLIPSE(cx, cy, circle_sz / 2, circle_sz / 2, t->widget_border);
+        atgl_clip_end();
+    }
 
     // Draw body (slightly smaller filled ellipse)
     ATGL_DRAW_FILLED_ELLIPSE((U32)cx, (U32)cy,
@@ -278,8 +285,8 @@ static VOID render_textinput(PATGL_NODE node)
                 CHAR pwd_buf[ATGL_TEXTINPUT_MAX];
                 MEMSET_OPT(pwd_buf, '*', draw_count);
                 pwd_buf[draw_count] = '\0';
-                DRAW_8x8_STRING(text_x, text_y, (PU8)pwd_buf,
-                                node->fg, node->bg);
+                ATGL_DRAW_TEXT(text_x, text_y, (PU8)pwd_buf,
+                               node->fg, node->bg);
             } else {
                 /* Selection present — batch into up to 3 runs */
                 CHAR pwd_buf[ATGL_TEXTINPUT_MAX];
@@ -292,8 +299,8 @@ static VOID render_textinput(PATGL_NODE node)
                 /* Before selection */
                 if (vis_sel_start > 0) {
                     pwd_buf[vis_sel_start] = '\0';
-                    DRAW_8x8_STRING(text_x, text_y, (PU8)pwd_buf,
-                                    node->fg, node->bg);
+                    ATGL_DRAW_TEXT(text_x, text_y, (PU8)pwd_buf,
+                                   node->fg, node->bg);
                     pwd_buf[vis_sel_start] = '*';
                 }
                 /* Selected region */
@@ -302,17 +309,17 @@ static VOID render_textinput(PATGL_NODE node)
                     U32 sel_len = vis_sel_end - vis_sel_start;
                     MEMSET_OPT(sel_buf, '*', sel_len);
                     sel_buf[sel_len] = '\0';
-                    DRAW_8x8_STRING(text_x + (I32)(vis_sel_start * t->char_w),
-                                    text_y, (PU8)sel_buf,
-                                    t->list_sel_fg, t->list_sel_bg);
+                    ATGL_DRAW_TEXT(text_x + (I32)(vis_sel_start * t->char_w),
+                                   text_y, (PU8)sel_buf,
+                                   t->list_sel_fg, t->list_sel_bg);
                 }
                 /* After selection */
                 if (vis_sel_end < draw_count) {
                     pwd_buf[vis_sel_end] = '*';
                     pwd_buf[draw_count]  = '\0';
-                    DRAW_8x8_STRING(text_x + (I32)(vis_sel_end * t->char_w),
-                                    text_y, (PU8)&pwd_buf[vis_sel_end],
-                                    node->fg, node->bg);
+                    ATGL_DRAW_TEXT(text_x + (I32)(vis_sel_end * t->char_w),
+                                   text_y, (PU8)&pwd_buf[vis_sel_end],
+                                   node->fg, node->bg);
                 }
             }
         } else {
@@ -321,8 +328,8 @@ static VOID render_textinput(PATGL_NODE node)
                 CHAR tmp_buf[ATGL_TEXTINPUT_MAX];
                 MEMCPY_OPT(tmp_buf, display_str, draw_count);
                 tmp_buf[draw_count] = '\0';
-                DRAW_8x8_STRING(text_x, text_y, (PU8)tmp_buf,
-                                t->input_fg, t->input_bg);
+                ATGL_DRAW_TEXT(text_x, text_y, (PU8)tmp_buf,
+                               t->input_fg, t->input_bg);
             } else {
                 /* Selection present — batch into up to 3 runs */
                 U32 vis_sel_start = (sel_min > td->scroll_offset) ? sel_min - td->scroll_offset : 0;
@@ -334,8 +341,8 @@ static VOID render_textinput(PATGL_NODE node)
                     CHAR tmp_buf[ATGL_TEXTINPUT_MAX];
                     MEMCPY_OPT(tmp_buf, display_str, vis_sel_start);
                     tmp_buf[vis_sel_start] = '\0';
-                    DRAW_8x8_STRING(text_x, text_y, (PU8)tmp_buf,
-                                    t->input_fg, t->input_bg);
+                    ATGL_DRAW_TEXT(text_x, text_y, (PU8)tmp_buf,
+                                   t->input_fg, t->input_bg);
                 }
                 /* Selected region */
                 if (vis_sel_end > vis_sel_start) {
@@ -343,9 +350,9 @@ static VOID render_textinput(PATGL_NODE node)
                     U32 sel_len = vis_sel_end - vis_sel_start;
                     MEMCPY_OPT(sel_buf, &display_str[vis_sel_start], sel_len);
                     sel_buf[sel_len] = '\0';
-                    DRAW_8x8_STRING(text_x + (I32)(vis_sel_start * t->char_w),
-                                    text_y, (PU8)sel_buf,
-                                    t->list_sel_fg, t->list_sel_bg);
+                    ATGL_DRAW_TEXT(text_x + (I32)(vis_sel_start * t->char_w),
+                                   text_y, (PU8)sel_buf,
+                                   t->list_sel_fg, t->list_sel_bg);
                 }
                 /* After selection */
                 if (vis_sel_end < draw_count) {
@@ -353,9 +360,9 @@ static VOID render_textinput(PATGL_NODE node)
                     U32 after_len = draw_count - vis_sel_end;
                     MEMCPY_OPT(tmp_buf, &display_str[vis_sel_end], after_len);
                     tmp_buf[after_len] = '\0';
-                    DRAW_8x8_STRING(text_x + (I32)(vis_sel_end * t->char_w),
-                                    text_y, (PU8)tmp_buf,
-                                    t->input_fg, t->input_bg);
+                    ATGL_DRAW_TEXT(text_x + (I32)(vis_sel_end * t->char_w),
+                                   text_y, (PU8)tmp_buf,
+                                   t->input_fg, t->input_bg);
                 }
             }
         }
@@ -687,6 +694,42 @@ static VOID render_image(PATGL_NODE node)
     }
 }
 
+/* ------------------------- Render culling ------------------------ */
+
+/* Widest focus ring drawn outside abs_rect (button) */
+#define ATGL_FOCUS_MARGIN 3
+
+ATGL_RECT atgl_node_paint_bounds(PATGL_NODE node)
+{
+    ATGL_RECT r = node->abs_rect;
+    if (node->focusable) {
+        r.x -= ATGL_FOCUS_MARGIN;
+        r.y -= ATGL_FOCUS_MARGIN;
+        r.w += 2 * ATGL_FOCUS_MARGIN;
+        r.h += 2 * ATGL_FOCUS_MARGIN;
+    }
+    return r;
+}
+
+BOOL atgl_node_opaque(PATGL_NODE node)
+{
+    /* These clear their rect with the resolved background */
+    if (node->fn_render == render_label  ||
+        node->fn_render == render_radio  ||
+        node->fn_render == render_slider ||
+        node->fn_render == render_panel)
+        return TRUE;
+
+    /* These fill with their own bg, which may be see-through */
+    if (node->fn_render == render_button      ||
+        node->fn_render == render_textinput   ||
+        node->fn_render == render_progressbar ||
+        node->fn_render == render_listbox)
+        return node->bg != VBE_SEE_THROUGH;
+
+    return FALSE;
+}
+
 /* ================================================================ */
 /*                       EVENT HANDLERS                             */
 /* ================================================================ */
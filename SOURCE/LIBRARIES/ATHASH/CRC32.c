@@ -0,0 +1,70 @@
+#include <LIBRARIES/ATHASH/CRC32.h>
+
+/* ---- CRC-32, slice-by-8 ----
+   crc_table[0] is the classic byte-at-a-time table. crc_table[k][b] is the
+   CRC of byte b followed by k zero bytes, which lets the main loop fold
+   eight input bytes per iteration with eight independent lookups. */
+
+#define CRC32_POLY 0xEDB88320U
+
+static U32 crc_table[8][256] ATTRIB_DATA;
+static BOOL crc_table_ready ATTRIB_DATA = FALSE;
+
+static VOID crc32_build_tables(VOID) {
+    U32 i, k;
+    for (i = 0; i < 256; i++) {
+        U32 c = i;
+        for (k = 0; k < 8; k++)
+            c = (c & 1) ? (c >> 1) ^ CRC32_POLY : (c >> 1);
+        crc_table[0][i] = c;
+    }
+    for (i = 0; i < 256; i++) {
+        U32 c = crc_table[0][i];
+        for (k = 1; k < 8; k++) {
+            c = crc_table[0][c & 0xFF] ^ (c >> 8);
+            crc_table[k][i] = c;
+        }
+    }
+    crc_table_ready = TRUE;
+}
+
+static U32 load_le32(CONST U8 *p) {
+    return (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
+}
+
+U32 CRC32_UPDATE(U32 crc, CONST U8 *data, U32 len) {
+    if (!crc_table_ready) crc32_build_tables();
+    if (!data) return crc;
+
+    crc = ~crc;
+
+    /* Byte steps until the pointer is 4-byte aligned */
+    while (len && ((U32)data & 3)) {
+        crc = crc_table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        len--;
+    }
+
+    while (len >= 8) {
+        U32 one = load_le32(data) ^ crc;
+        U32 two = load_le32(data + 4);
+        crc = crc_table[7][one & 0xFF]         ^
+              crc_table[6][(one >> 8) & 0xFF]  ^
+              crc_table[5][(one >> 16) & 0xFF] ^
+              crc_table[4][one >> 24]          ^
+              crc_table[3][two & 0xFF]         ^
+              crc_table[2][(two >> 8) & 0xFF]  ^
+              crc_table[1][(two >> 16) & 0xFF] ^
+              crc_table[0][two >> 24];
+        data += 8;
+        len -= 8;
+    }
+
+    while (len--)
+        crc = crc_table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+U32 CRC32(CONST U8 *data, U32 len) {
+    return CRC32_UPDATE(0, data, len);
+}
@@ -0,0 +1,22 @@
+#ifndef ATHASH_CRC32_H
+#define ATHASH_CRC32_H
+
+#include <STD/TYPEDEF.h>
+
+/* CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320), same as zlib/PNG/ZIP */
+
+/* Continue a CRC over more data. Start with crc = 0. */
+U32 CRC32_UPDATE(U32 crc, CONST U8 *data, U32 len);
+
+/* Convenience: CRC of a single buffer */
+U32 CRC32(CONST U8 *data, U32 len);
+
+/*
+Usage example:
+U32 crc = 0;
+crc = CRC32_UPDATE(crc, part1, len1);
+crc = CRC32_UPDATE(crc, part2, len2);
+CRC32((U8 *)"123456789", 9) == 0xCBF43926
+*/
+
+#endif // ATHASH_CRC32_H
@@ -0,0 +1,125 @@
+#include <LIBRARIES/ATHASH/SHA256.h>
+#include <STD/MEM.h>
+
+/* ---- SHA-256 (FIPS 180-4) ---- */
+
+static CONST U32 K[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define CH(x,y,z)  ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x,y,z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define EP0(x)     (ROR32(x, 2) ^ ROR32(x,13) ^ ROR32(x,22))
+#define EP1(x)     (ROR32(x, 6) ^ ROR32(x,11) ^ ROR32(x,25))
+#define SIG0(x)    (ROR32(x, 7) ^ ROR32(x,18) ^ ((x) >>  3))
+#define SIG1(x)    (ROR32(x,17) ^ ROR32(x,19) ^ ((x) >> 10))
+
+/* Message schedule in a 16-word ring: W[i&15] still holds W[i-16] */
+#define BLK0(i) (W[i] = load_be32(&data[(i)*4]))
+#define BLK(i)  (W[(i)&15] += SIG1(W[((i)-2)&15]) + W[((i)-7)&15] + SIG0(W[((i)-15)&15]))
+
+/* One round; the caller rotates the variable names instead of the values */
+#define RND(a,b,c,d,e,f,g,h,i,w) \
+    t = h + EP1(e) + CH(e,f,g) + K[i] + (w); d += t; h = t + EP0(a) + MAJ(a,b,c);
+
+#define R8(i, BLKF) \
+    RND(a,b,c,d,e,f,g,h,(i)+0,BLKF((i)+0)) RND(h,a,b,c,d,e,f,g,(i)+1,BLKF((i)+1)) \
+    RND(g,h,a,b,c,d,e,f,(i)+2,BLKF((i)+2)) RND(f,g,h,a,b,c,d,e,(i)+3,BLKF((i)+3)) \
+    RND(e,f,g,h,a,b,c,d,(i)+4,BLKF((i)+4)) RND(d,e,f,g,h,a,b,c,(i)+5,BLKF((i)+5)) \
+    RND(c,d,e,f,g,h,a,b,(i)+6,BLKF((i)+6)) RND(b,c,d,e,f,g,h,a,(i)+7,BLKF((i)+7))
+
+static inline U32 load_be32(CONST U8 *p) {
+    return ((U32)p[0] << 24) | ((U32)p[1] << 16) | ((U32)p[2] << 8) | (U32)p[3];
+}
+
+static inline VOID store_be32(U8 *p, U32 v) {
+    p[0] = (U8)(v >> 24);
+    p[1] = (U8)(v >> 16);
+    p[2] = (U8)(v >> 8);
+    p[3] = (U8)v;
+}
+
+/* Compresses `blocks` consecutive 64-byte blocks into state */
+static VOID sha256_blocks(U32 state[8], CONST U8 *data, U32 blocks) {
+    U32 W[16], t;
+    for (; blocks; blocks--, data += 64) {
+        U32 a = state[0], b = state[1], c = state[2], d = state[3];
+        U32 e = state[4], f = state[5], g = state[6], h = state[7];
+
+        R8( 0, BLK0) R8( 8, BLK0)
+        R8(16, BLK)  R8(24, BLK)  R8(32, BLK)  R8(40, BLK)  R8(48, BLK)  R8(56, BLK)
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+VOID SHA256_INIT(SHA256_CTX *ctx) {
+    ctx->state[0] = 0x6A09E667;
+    ctx->state[1] = 0xBB67AE85;
+    ctx->state[2] = 0x3C6EF372;
+    ctx->state[3] = 0xA54FF53A;
+    ctx->state[4] = 0x510E527F;
+    ctx->state[5] = 0x9B05688C;
+    ctx->state[6] = 0x1F83D9AB;
+    ctx->state[7] = 0x5BE0CD19;
+    ctx->count[0] = 0;
+    ctx->count[1] = 0;
+}
+
+VOID SHA256_UPDATE(SHA256_CTX *ctx, CONST U8 *data, U32 len) {
+    U32 used = (ctx->count[0] >> 3) & 63;
+    if ((ctx->count[0] += len << 3) < (len << 3)) ctx->count[1]++;
+    ctx->count[1] += (len >> 29);
+
+    if (used) {
+        U32 fill = 64 - used;
+        if (len < fill) {
+            MEMCPY(&ctx->buffer[used], data, len);
+            return;
+        }
+        MEMCPY(&ctx->buffer[used], data, fill);
+        sha256_blocks(ctx->state, ctx->buffer, 1);
+        data += fill;
+        len  -= fill;
+    }
+    if (len >= 64) {
+        sha256_blocks(ctx->state, data, len >> 6);
+        data += len & ~63U;
+        len  &= 63;
+    }
+    if (len) MEMCPY(ctx->buffer, data, len);
+}
+
+VOID SHA256_FINAL(U8 digest[SHA256_DIGEST_SIZE], SHA256_CTX *ctx) {
+    U32 used = (ctx->count[0] >> 3) & 63;
+    ctx->buffer[used++] = 0x80;
+    if (used > 56) {
+        MEMSET(&ctx->buffer[used], 0, 64 - used);
+        sha256_blocks(ctx->state, ctx->buffer, 1);
+        used = 0;
+    }
+    MEMSET(&ctx->buffer[used], 0, 56 - used);
+    store_be32(&ctx->buffer[56], ctx->count[1]);
+    store_be32(&ctx->buffer[60], ctx->count[0]);
+    sha256_blocks(ctx->state, ctx->buffer, 1);
+
+    for (U32 i = 0; i < 8; i++) store_be32(&digest[i * 4], ctx->state[i]);
+    MEMZERO(ctx, sizeof(SHA256_CTX));
+}
+
+VOID SHA256_HASH(CONST U8 *data, U32 len, U8 digest[SHA256_DIGEST_SIZE]) {
+    SHA256_CTX ctx;
+    SHA256_INIT(&ctx);
+    SHA256_UPDATE(&ctx, data, len);
+    SHA256_FINAL(digest, &ctx);
+}
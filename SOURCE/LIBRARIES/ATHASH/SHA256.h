@@ -0,0 +1,31 @@
+#ifndef ATHASH_SHA256_H
+#define ATHASH_SHA256_H
+
+#include <STD/TYPEDEF.h>
+
+#define SHA256_DIGEST_SIZE 32
+
+typedef struct {
+    U32 state[8];
+    U32 count[2];
+    U8  buffer[64];
+} SHA256_CTX;
+
+VOID SHA256_INIT(SHA256_CTX *ctx);
+VOID SHA256_UPDATE(SHA256_CTX *ctx, CONST U8 *data, U32 len);
+VOID SHA256_FINAL(U8 digest[SHA256_DIGEST_SIZE], SHA256_CTX *ctx);
+
+/* Convenience: hash a buffer in one call, writes 32-byte digest */
+VOID SHA256_HASH(CONST U8 *data, U32 len, U8 digest[SHA256_DIGEST_SIZE]);
+
+/*
+Usage example:
+SHA256_CTX ctx;
+U8 digest[SHA256_DIGEST_SIZE];
+SHA256_INIT(&ctx);
+SHA256_UPDATE(&ctx, part1, len1);
+SHA256_UPDATE(&ctx, part2, len2);
+SHA256_FINAL(digest, &ctx);
+*/
+
+#endif // ATHASH_SHA256_H
@@ -0,0 +1,334 @@
+#include <LIBRARIES/ATZP/ATZ.h>
+#include <LIBRARIES/ATZP/ATZP.h>
+#include <LIBRARIES/ATHASH/CRC32.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+
+#define ATZ_V1_ENTRY_FIXED (2 + 4 + 4 + 4 + 1)
+
+static VOID put_le16(PU8 p, U16 v) {
+    p[0] = (U8)v;
+    p[1] = (U8)(v >> 8);
+}
+
+static VOID put_le32(PU8 p, U32 v) {
+    p[0] = (U8)v;
+    p[1] = (U8)(v >> 8);
+    p[2] = (U8)(v >> 16);
+    p[3] = (U8)(v >> 24);
+}
+
+static U16 get_le16(PU8 p) {
+    return (U16)(p[0] | (p[1] << 8));
+}
+
+static U32 get_le32(PU8 p) {
+    return (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
+}
+
+/* ── Memory I/O helpers ──────────────────────────────────────────── */
+
+BOOL ATZ_MEM_SINK_WRITE(VOIDPTR sink, PU8 data, U32 len) {
+    ATZ_MEM_SINK *s = (ATZ_MEM_SINK *)sink;
+    if (len == 0) return TRUE;
+    if (len > 0xFFFFFFFFU - s->size) return FALSE;
+
+    if (s->size + len > s->capacity) {
+        U32 cap = s->capacity ? s->capacity : 4096;
+        while (cap < s->size + len) {
+            if (cap > 0x7FFFFFFFU) { cap = s->size + len; break; }
+            cap *= 2;
+        }
+        PU8 grown = (PU8)ReAlloc(s->data, cap);
+        if (!grown) return FALSE;
+        s->data = grown;
+        s->capacity = cap;
+    }
+    MEMCPY_OPT(s->data + s->size, data, len);
+    s->size += len;
+    return TRUE;
+}
+
+VOID ATZ_MEM_SINK_FREE(ATZ_MEM_SINK *sink) {
+    if (!sink) return;
+    if (sink->data) MFreeNull(sink->data);
+    sink->size = 0;
+    sink->capacity = 0;
+}
+
+BOOL ATZ_MEM_SOURCE_READ_AT(VOIDPTR source, U32 offset, PU8 buf, U32 len) {
+    ATZ_MEM_SOURCE *s = (ATZ_MEM_SOURCE *)source;
+    if (offset > s->size || len > s->size - offset) return FALSE;
+    MEMCPY_OPT(buf, s->data + offset, len);
+    return TRUE;
+}
+
+/* ── Writer ──────────────────────────────────────────────────────── */
+
+static BOOL writer_emit(ATZ_WRITER *w, PU8 data, U32 len) {
+    if (w->failed) return FALSE;
+    if (len > 0xFFFFFFFFU - w->offset || !w->write(w->io, data, len)) {
+        w->failed = TRUE;
+        return FALSE;
+    }
+    w->offset += len;
+    return TRUE;
+}
+
+BOOL ATZ_WRITER_INIT(ATZ_WRITER *w, ATZ_WRITE_FN write, VOIDPTR io, U32 hc_level) {
+    if (!w || !write) return FALSE;
+    MEMZERO(w, sizeof(*w));
+    w->write    = write;
+    w->io       = io;
+    w->hc_level = hc_level;
+    return writer_emit(w, (PU8)ATZ_MAGIC_V2, 4);
+}
+
+BOOL ATZ_WRITER_ADD(ATZ_WRITER *w, PU8 name, PU8 data, U32 size) {
+    if (!w || !name || (!data && size) || w->failed) return FALSE;
+    U32 nlen = STRLEN(name);
+    if (nlen == 0 || nlen > 0xFFFF) return FALSE;
+
+    if (w->count == w->capacity) {
+        U32 cap = w->capacity ? w->capacity * 2 : 32;
+        ATZ_ENTRY *grown = (ATZ_ENTRY *)ReAlloc(w->entries, cap * sizeof(ATZ_ENTRY));
+        if (!grown) return FALSE;
+        w->entries  = grown;
+        w->capacity = cap;
+    }
+
+    ATZ_ENTRY *e = &w->entries[w->count];
+    MEMZERO(e, sizeof(*e));
+    e->name = STRDUP(name);
+    if (!e->name) return FALSE;
+    e->original_size = size;
+    e->data_offset   = w->offset;
+    e->crc32         = CRC32(data, size);
+    e->flags         = ATZ_FLAG_CRC;
+
+    /* Compress; keep the result only if it is actually smaller */
+    PU8 cmp = NULLPTR;
+    U32 cmp_sz = 0;
+    if (size > 0) {
+        U32 bound = LZ4_COMPRESS_BOUND(size);
+        cmp = (PU8)MAlloc(bound);
+        if (cmp) {
+            cmp_sz = w->hc_level ? LZ4_COMPRESS_HC(data, size, cmp, bound, w->hc_level)
+                                 : LZ4_COMPRESS(data, size, cmp, bound);
+        }
+    }
+
+    BOOL ok;
+    if (cmp_sz > 0 && cmp_sz < size) {
+        e->flags |= ATZ_FLAG_LZ4;
+        e->compressed_size = cmp_sz;
+        ok = writer_emit(w, cmp, cmp_sz);
+    } else {
+        e->compressed_size = size;
+        ok = size == 0 || writer_emit(w, data, size);
+    }
+    if (cmp) MFree(cmp);
+
+    if (!ok) {
+        MFreeNull(e->name);
+        return FALSE;
+    }
+    w->count++;
+    return TRUE;
+}
+
+BOOL ATZ_WRITER_FINISH(ATZ_WRITER *w) {
+    if (!w || w->failed) return FALSE;
+
+    U32 dir_size = 0;
+    U32 i;
+    for (i = 0; i < w->count; i++)
+        dir_size += ATZ_DIR_ENTRY_FIXED + STRLEN(w->entries[i].name);
+
+    PU8 dir = (PU8)MAlloc(dir_size ? dir_size : 1);
+    if (!dir) return FALSE;
+
+    PU8 p = dir;
+    for (i = 0; i < w->count; i++) {
+        ATZ_ENTRY *e = &w->entries[i];
+        U32 nlen = STRLEN(e->name);
+        put_le16(p, (U16)nlen);                 p += 2;
+        MEMCPY(p, e->name, nlen);               p += nlen;
+        put_le32(p, e->original_size);          p += 4;
+        put_le32(p, e->compressed_size);        p += 4;
+        put_le32(p, e->data_offset);            p += 4;
+        put_le32(p, e->crc32);                  p += 4;
+        *p++ = e->flags;
+    }
+
+    U8 trailer[ATZ_TRAILER_SIZE];
+    put_le32(trailer,      w->offset);
+    put_le32(trailer + 4,  dir_size);
+    put_le32(trailer + 8,  w->count);
+    put_le32(trailer + 12, CRC32(dir, dir_size));
+    MEMCPY(trailer + 16, ATZ_MAGIC_END, 4);
+
+    BOOL ok = writer_emit(w, dir, dir_size) && writer_emit(w, trailer, ATZ_TRAILER_SIZE);
+    MFree(dir);
+    return ok;
+}
+
+VOID ATZ_WRITER_FREE(ATZ_WRITER *w) {
+    if (!w) return;
+    U32 i;
+    for (i = 0; i < w->count; i++)
+        if (w->entries[i].name) MFree(w->entries[i].name);
+    if (w->entries) MFreeNull(w->entries);
+    w->count = 0;
+    w->capacity = 0;
+}
+
+/* ── Reader ──────────────────────────────────────────────────────── */
+
+/* Parses n directory records from dir (dir_len bytes). v2 records carry a CRC. */
+static BOOL reader_parse_dir(ATZ_READER *r, PU8 dir, U32 dir_len, U32 n, U32 version, U32 archive_size) {
+    U32 fixed = (version == 2) ? ATZ_DIR_ENTRY_FIXED : ATZ_V1_ENTRY_FIXED;
+
+    /* Every record needs at least `fixed` bytes, which bounds n before allocating */
+    if (n > dir_len / fixed) return FALSE;
+
+    r->entries = (ATZ_ENTRY *)CAlloc(n ? n : 1, sizeof(ATZ_ENTRY));
+    r->names   = (PU8)MAlloc(dir_len + 1);
+    if (!r->entries || !r->names) return FALSE;
+
+    PU8 p = dir, end = dir + dir_len;
+    PU8 np = r->names;
+    U32 i;
+    for (i = 0; i < n; i++) {
+        ATZ_ENTRY *e = &r->entries[i];
+        if ((U32)(end - p) < fixed) return FALSE;
+        U32 nlen = get_le16(p);
+        p += 2;
+        if ((U32)(end - p) < nlen + fixed - 2) return FALSE;
+
+        MEMCPY(np, p, nlen);
+        np[nlen] = '\0';
+        e->name = np;
+        np += nlen + 1;
+        p  += nlen;
+
+        e->original_size   = get_le32(p);   p += 4;
+        e->compressed_size = get_le32(p);   p += 4;
+        e->data_offset     = get_le32(p);   p += 4;
+        if (version == 2) { e->crc32 = get_le32(p); p += 4; }
+        e->flags = *p++;
+        if (version != 2) e->flags &= ~ATZ_FLAG_CRC;
+
+        if (e->data_offset > archive_size || e->compressed_size > archive_size - e->data_offset)
+            return FALSE;
+    }
+    r->count = n;
+    return TRUE;
+}
+
+static BOOL reader_open_v2(ATZ_READER *r, U32 archive_size) {
+    U8 trailer[ATZ_TRAILER_SIZE];
+    if (archive_size < 4 + ATZ_TRAILER_SIZE) return FALSE;
+    if (!r->read_at(r->io, archive_size - ATZ_TRAILER_SIZE, trailer, ATZ_TRAILER_SIZE)) return FALSE;
+    if (MEMCMP(trailer + 16, ATZ_MAGIC_END, 4) != 0) return FALSE;
+
+    U32 dir_offset = get_le32(trailer);
+    U32 dir_size   = get_le32(trailer + 4);
+    U32 count      = get_le32(trailer + 8);
+    U32 dir_crc    = get_le32(trailer + 12);
+    if (dir_offset < 4 || dir_offset > archive_size - ATZ_TRAILER_SIZE ||
+        dir_size != archive_size - ATZ_TRAILER_SIZE - dir_offset)
+        return FALSE;
+
+    PU8 dir = (PU8)MAlloc(dir_size ? dir_size : 1);
+    if (!dir) return FALSE;
+    BOOL ok = r->read_at(r->io, dir_offset, dir, dir_size) &&
+              CRC32(dir, dir_size) == dir_crc &&
+              reader_parse_dir(r, dir, dir_size, count, 2, dir_offset);
+    MFree(dir);
+    return ok;
+}
+
+static BOOL reader_open_v1(ATZ_READER *r, U32 archive_size) {
+    U8 cnt[4];
+    if (!r->read_at(r->io, 4, cnt, 4)) return FALSE;
+    U32 count = get_le32(cnt);
+
+    /* The v1 header is not length-prefixed: read the largest possible prefix */
+    U32 max_hdr = archive_size - 8;
+    U32 want = count * (ATZ_V1_ENTRY_FIXED + 0xFFFF);
+    if (count > max_hdr / ATZ_V1_ENTRY_FIXED) return FALSE;
+    if (want / (ATZ_V1_ENTRY_FIXED + 0xFFFF) != count || want > max_hdr) want = max_hdr;
+
+    PU8 hdr = (PU8)MAlloc(want ? want : 1);
+    if (!hdr) return FALSE;
+    BOOL ok = r->read_at(r->io, 8, hdr, want) &&
+              reader_parse_dir(r, hdr, want, count, 1, archive_size);
+    MFree(hdr);
+    return ok;
+}
+
+BOOL ATZ_READER_OPEN(ATZ_READER *r, ATZ_READ_AT_FN read_at, VOIDPTR io, U32 archive_size) {
+    U8 magic[4];
+    if (!r || !read_at) return FALSE;
+    MEMZERO(r, sizeof(*r));
+    r->read_at = read_at;
+    r->io      = io;
+
+    if (archive_size < 8 || !read_at(io, 0, magic, 4)) return FALSE;
+
+    BOOL ok = FALSE;
+    if (MEMCMP(magic, ATZ_MAGIC_V2, 4) == 0) {
+        r->version = 2;
+        ok = reader_open_v2(r, archive_size);
+    } else if (MEMCMP(magic, ATZ_MAGIC_V1, 4) == 0) {
+        r->version = 1;
+        ok = reader_open_v1(r, archive_size);
+    }
+    if (!ok) ATZ_READER_CLOSE(r);
+    return ok;
+}
+
+ATZ_ENTRY *ATZ_READER_FIND(ATZ_READER *r, PU8 name) {
+    if (!r || !name) return NULLPTR;
+    U32 i;
+    for (i = 0; i < r->count; i++)
+        if (STRCMP(r->entries[i].name, name) == 0) return &r->entries[i];
+    return NULLPTR;
+}
+
+PU8 ATZ_READER_EXTRACT(ATZ_READER *r, ATZ_ENTRY *e) {
+    if (!r || !e) return NULLPTR;
+
+    PU8 out = (PU8)MAlloc(e->original_size ? e->original_size : 1);
+    if (!out) return NULLPTR;
+    if (e->original_size == 0) return out;
+
+    if (e->flags & ATZ_FLAG_LZ4) {
+        PU8 cmp = (PU8)MAlloc(e->compressed_size ? e->compressed_size : 1);
+        BOOL ok = cmp &&
+                  r->read_at(r->io, e->data_offset, cmp, e->compressed_size) &&
+                  LZ4_DECOMPRESS(cmp, e->compressed_size, out, e->original_size) == e->original_size;
+        if (cmp) MFree(cmp);
+        if (!ok) { MFree(out); return NULLPTR; }
+    } else {
+        if (e->compressed_size != e->original_size ||
+            !r->read_at(r->io, e->data_offset, out, e->original_size)) {
+            MFree(out);
+            return NULLPTR;
+        }
+    }
+
+    if ((e->flags & ATZ_FLAG_CRC) && CRC32(out, e->original_size) != e->crc32) {
+        MFree(out);
+        return NULLPTR;
+    }
+    return out;
+}
+
+VOID ATZ_READER_CLOSE(ATZ_READER *r) {
+    if (!r) return;
+    if (r->entries) MFreeNull(r->entries);
+    if (r->names)   MFreeNull(r->names);
+    r->count = 0;
+}
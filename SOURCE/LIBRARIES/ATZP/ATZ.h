@@ -0,0 +1,121 @@
+#ifndef ATZ_H
+#define ATZ_H
+#include <STD/TYPEDEF.h>
+
+/*
+ * ════════════════════════════════════════════════════════════════════
+ *  ATZ Archive Format  (.atz)
+ *
+ *  Version 2 (written by ATZ_WRITER_*):
+ *    [4]  magic "ATZ2"
+ *    Data section: each entry's data, compressed independently
+ *    Central directory, per entry:
+ *      [2]  name_len        U16
+ *      [?]  name            bytes (relative stored path, no leading /)
+ *      [4]  original_size   U32
+ *      [4]  compressed_size U32
+ *      [4]  data_offset     U32  (absolute byte offset from start of file)
+ *      [4]  crc32           U32  (CRC-32 of the original data)
+ *      [1]  flags           U8
+ *    Trailer (last ATZ_TRAILER_SIZE bytes of the file):
+ *      [4]  dir_offset      U32
+ *      [4]  dir_size        U32
+ *      [4]  entry_count     U32
+ *      [4]  dir_crc32       U32
+ *      [4]  magic "ATZE"
+ *
+ *  A reader seeks to the trailer, loads the directory in one read and
+ *  then reaches any entry with a single seek.
+ *
+ *  Version 1 ("ATZ1", leading header with no checksums) is still read.
+ *  All integers are little-endian.
+ * ════════════════════════════════════════════════════════════════════
+ */
+
+#define ATZ_MAGIC_V1        "ATZ1"
+#define ATZ_MAGIC_V2        "ATZ2"
+#define ATZ_MAGIC_END       "ATZE"
+#define ATZ_TRAILER_SIZE    20
+#define ATZ_DIR_ENTRY_FIXED (2 + 4 + 4 + 4 + 4 + 1)
+
+#define ATZ_FLAG_LZ4        0x01  /* entry is an LZ4 block, else stored raw   */
+#define ATZ_FLAG_CRC        0x02  /* crc32 is valid (always set in version 2) */
+
+typedef struct {
+    PU8 name;               /* stored relative path, NUL-terminated */
+    U32 original_size;
+    U32 compressed_size;
+    U32 data_offset;
+    U32 crc32;
+    U8  flags;
+} ATZ_ENTRY;
+
+/* Archive I/O is done through callbacks so the same code runs on atOS
+   files, in-memory buffers and host stdio. */
+typedef BOOL (*ATZ_WRITE_FN)(VOIDPTR io, PU8 data, U32 len);
+typedef BOOL (*ATZ_READ_AT_FN)(VOIDPTR io, U32 offset, PU8 buf, U32 len);
+
+/* Growable in-memory sink usable as ATZ_WRITE_FN */
+typedef struct {
+    PU8 data;
+    U32 size;
+    U32 capacity;
+} ATZ_MEM_SINK;
+
+BOOL ATZ_MEM_SINK_WRITE(VOIDPTR sink, PU8 data, U32 len);
+VOID ATZ_MEM_SINK_FREE(ATZ_MEM_SINK *sink);
+
+/* In-memory source usable as ATZ_READ_AT_FN */
+typedef struct {
+    PU8 data;
+    U32 size;
+} ATZ_MEM_SOURCE;
+
+BOOL ATZ_MEM_SOURCE_READ_AT(VOIDPTR source, U32 offset, PU8 buf, U32 len);
+
+typedef struct {
+    ATZ_WRITE_FN write;
+    VOIDPTR      io;
+    U32          offset;    /* bytes written so far */
+    U32          hc_level;  /* 0: fast LZ4, else LZ4_COMPRESS_HC level */
+    ATZ_ENTRY   *entries;
+    U32          count;
+    U32          capacity;
+    BOOL         failed;
+} ATZ_WRITER;
+
+/// @brief Starts a version 2 archive and writes its magic.
+BOOL ATZ_WRITER_INIT(ATZ_WRITER *w, ATZ_WRITE_FN write, VOIDPTR io, U32 hc_level);
+
+/// @brief Compresses one entry and writes it straight to the output.
+/// The caller may free data as soon as this returns. There is no entry limit.
+BOOL ATZ_WRITER_ADD(ATZ_WRITER *w, PU8 name, PU8 data, U32 size);
+
+/// @brief Writes the central directory and trailer. The writer must still be freed.
+BOOL ATZ_WRITER_FINISH(ATZ_WRITER *w);
+
+VOID ATZ_WRITER_FREE(ATZ_WRITER *w);
+
+typedef struct {
+    ATZ_READ_AT_FN read_at;
+    VOIDPTR        io;
+    U32            version;     /* 1 or 2 */
+    ATZ_ENTRY     *entries;
+    U32            count;
+    PU8            names;       /* backing store for entries[].name */
+} ATZ_READER;
+
+/// @brief Loads the directory of an archive of archive_size bytes.
+BOOL ATZ_READER_OPEN(ATZ_READER *r, ATZ_READ_AT_FN read_at, VOIDPTR io, U32 archive_size);
+
+/// @brief Looks up an entry by stored name. Returns NULLPTR if absent.
+ATZ_ENTRY *ATZ_READER_FIND(ATZ_READER *r, PU8 name);
+
+/// @brief Reads, decompresses and CRC-checks one entry.
+/// @return MAlloc'd buffer of e->original_size bytes (MFree it), or NULLPTR on error.
+/// An empty entry returns a valid 1-byte allocation.
+PU8 ATZ_READER_EXTRACT(ATZ_READER *r, ATZ_ENTRY *e);
+
+VOID ATZ_READER_CLOSE(ATZ_READER *r);
+
+#endif // ATZ_H
@@ -2,7 +2,44 @@
 #include <STD/STRING.h>
 #include <STD/MEM.h>
 
-U32 LZ4_DECOMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity) {
+#define LZ4_MINMATCH        4
+#define LZ4_LASTLITERALS    5   /* last 5 bytes of a block are always literals   */
+#define LZ4_MFLIMIT         12  /* last match must start 12 bytes before the end */
+#define LZ4_MAX_DISTANCE    65535
+#define LZ4_SKIP_TRIGGER    6   /* search step grows by one every 64 misses      */
+
+#define LZ4_HASH_LOG        12
+#define LZ4_HASH_SIZE       (1 << LZ4_HASH_LOG)
+#define LZ4HC_HASH_LOG      15
+#define LZ4HC_HASH_SIZE     (1 << LZ4HC_HASH_LOG)
+#define LZ4HC_CHAIN_SIZE    65536
+
+/* Stream offsets stored in match finder tables are restarted before they
+   can wrap, which costs at most one block of history. */
+#define LZ4_OFFSET_LIMIT    0x7FFF0000
+
+/* Unaligned 32-bit access (fine on i386) */
+typedef U32 __attribute__((may_alias, aligned(1))) LZ4_U32_UA;
+#define LOAD32(p) (*(CONST LZ4_U32_UA *)(p))
+
+static U32 read_le32(PU8 p) {
+    return (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
+}
+
+static VOID write_le32(PU8 p, U32 v) {
+    p[0] = (U8)v;
+    p[1] = (U8)(v >> 8);
+    p[2] = (U8)(v >> 16);
+    p[3] = (U8)(v >> 24);
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Block decoder
+ * ════════════════════════════════════════════════════════════════════ */
+
+/* prefix_len bytes directly before dst are valid history that matches
+   may reference (linked frame blocks). */
+static U32 lz4_decompress_prefix(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity, U32 prefix_len) {
     PU8 ip = src;
     PU8 ip_end = src + src_len;
     PU8 op = dst;
@@ -24,7 +61,7 @@ U32 LZ4_DECOMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity) {
         }
 
         /* Step 3: bounds check then copy literals verbatim */
-        if (op + lit_len > op_end) return 0;
+        if (lit_len > (U32)(op_end - op) || lit_len > (U32)(ip_end - ip)) return 0;
         MEMCPY_OPT(op, ip, lit_len);
         ip += lit_len;
         op += lit_len;
@@ -36,7 +73,7 @@ U32 LZ4_DECOMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity) {
         if (ip + 2 > ip_end) return 0;
         U16 offset = (U16)(ip[0]) | ((U16)(ip[1]) << 8);
         ip += 2;
-        if (offset == 0 || op - dst < (U32)offset) return 0; /* invalid offset */
+        if (offset == 0 || (U32)(op - dst) + prefix_len < (U32)offset) return 0; /* invalid offset */
         PU8 match_ptr = op - offset;
 
         /* Step 6: decode match length (raw nibble checked before +4) */
@@ -51,22 +88,48 @@ U32 LZ4_DECOMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity) {
             } while (extra == 255);
         }
 
-        /* Step 7: copy match byte-by-byte to handle overlapping regions */
-        if (op + match_len > op_end) return 0;
-        U32 m;
-        for (m = 0; m < match_len; m++)
-            *op++ = *match_ptr++;
+        /* Step 7: copy match; byte-by-byte when the regions overlap */
+        if (match_len > (U32)(op_end - op)) return 0;
+        if (offset >= match_len) {
+            MEMCPY_OPT(op, match_ptr, match_len);
+            op += match_len;
+        } else {
+            U32 m;
+            for (m = 0; m < match_len; m++)
+                *op++ = *match_ptr++;
+        }
     }
 
     return (U32)(op - dst);
 }
 
-/* Hash table: maps 12-bit hash → last seen position in src. Zeroed each call. */
-static U32 hash_table[4096];
+U32 LZ4_DECOMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity) {
+    return lz4_decompress_prefix(src, src_len, dst, dst_capacity, 0);
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Sequence encoding shared by both match finders
+ * ════════════════════════════════════════════════════════════════════ */
 
 static U32 lz4_hash(PU8 p) {
-    U32 v = (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
-    return (v * 2654435761UL) >> 20; /* Knuth multiplicative hash → 12-bit index */
+    return (LOAD32(p) * 2654435761U) >> (32 - LZ4_HASH_LOG); /* Knuth multiplicative hash */
+}
+
+static U32 lz4hc_hash(PU8 p) {
+    return (LOAD32(p) * 2654435761U) >> (32 - LZ4HC_HASH_LOG);
+}
+
+/* Number of equal bytes at a and b, stopping at a_limit */
+static U32 lz4_count(PU8 a, PU8 b, PU8 a_limit) {
+    PU8 start = a;
+    while (a + 4 <= a_limit) {
+        U32 diff = LOAD32(a) ^ LOAD32(b);
+        if (diff) return (U32)(a - start) + ((U32)__builtin_ctz(diff) >> 3);
+        a += 4;
+        b += 4;
+    }
+    while (a < a_limit && *a == *b) { a++; b++; }
+    return (U32)(a - start);
 }
 
 /* Emit extra-length extension bytes for lengths >= 15 */
@@ -76,89 +139,652 @@ static PU8 emit_extra(PU8 op, U32 remainder) {
     return op;
 }
 
-U32 LZ4_COMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity) {
-    if (src_len < 4) {
-        /* Too small to compress — emit as literals only */
-        if (dst_capacity < src_len + 1) return 0;
-        PU8 op = dst;
-        *op++ = (U8)(src_len << 4); /* token: lit_len nibble, match nibble = 0 */
-        MEMCPY_OPT(op, src, src_len);
-        return (U32)(op + src_len - dst);
-    }
-
-    /* Zero hash table for this call */
-    MEMZERO(hash_table, sizeof(hash_table));
-
-    PU8 op           = dst;
-    PU8 op_end       = dst + dst_capacity;
-    U32 i            = 0;                  /* current input position */
-    U32 literal_start = 0;                 /* start of accumulated literals */
-
-    /* Leave last 5 bytes as mandatory literals (LZ4 spec) */
-    U32 limit = src_len > 5 ? src_len - 5 : 0;
-
-    while (i < limit) {
-        /* Step 1: hash current 4 bytes, look up candidate */
-        U32 h         = lz4_hash(src + i);
-        U32 candidate = hash_table[h];
-        hash_table[h] = i;
-
-        /* Step 2: check for a valid match (min 4 bytes, offset fits in U16) */
-        if (candidate < i &&
-            (i - candidate) <= 65535 &&
-            MEMCMP(src + candidate, src + i, 4) == 0)
-        {
-            /* Step 3: extend match as far as possible */
-            U32 match_len = 4;
-            while (i + match_len < src_len - 1 &&
-                   src[candidate + match_len] == src[i + match_len]) {
-                match_len++;
+/* Writes one sequence. Returns the new output pointer, NULLPTR if it does not fit. */
+static PU8 lz4_emit_sequence(PU8 op, PU8 op_end, PU8 lit, U32 lit_len, U32 offset, U32 match_len) {
+    /* Worst case: token + extras + lits + 2 + extras */
+    if ((U32)(op_end - op) < 1 + (lit_len / 255) + 1 + lit_len + 2 + (match_len / 255) + 1)
+        return NULLPTR;
+
+    U8 lit_nibble   = (lit_len >= 15) ? 15 : (U8)lit_len;
+    U8 match_nibble = (match_len - 4 >= 15) ? 15 : (U8)(match_len - 4);
+    *op++ = (U8)((lit_nibble << 4) | match_nibble);
+    if (lit_len >= 15) op = emit_extra(op, lit_len - 15);
+    MEMCPY_OPT(op, lit, lit_len);
+    op += lit_len;
+    *op++ = (U8)(offset & 0xFF);
+    *op++ = (U8)((offset >> 8) & 0xFF);
+    if (match_len - 4 >= 15) op = emit_extra(op, match_len - 4 - 15);
+    return op;
+}
+
+/* Final literal-only sequence of a block */
+static PU8 lz4_emit_last_literals(PU8 op, PU8 op_end, PU8 lit, U32 lit_len) {
+    if ((U32)(op_end - op) < 1 + (lit_len / 255) + 1 + lit_len) return NULLPTR;
+
+    U8 lit_nibble = (lit_len >= 15) ? 15 : (U8)lit_len;
+    *op++ = (U8)(lit_nibble << 4); /* low nibble = 0: no match */
+    if (lit_len >= 15) op = emit_extra(op, lit_len - 15);
+    MEMCPY_OPT(op, lit, lit_len);
+    return op + lit_len;
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Fast match finder
+ *
+ *  Compresses base[start..end). Matches may reach back to base[low].
+ *  The table maps a 4-byte hash to (offset + position), so entries left
+ *  behind by earlier calls or earlier stream blocks are recognised as
+ *  stale by value instead of clearing the table every time.
+ * ════════════════════════════════════════════════════════════════════ */
+
+static U32 lz4_compress_fast_core(PU8 base, U32 start, U32 end, U32 low, PU32 table, U32 offset,
+                                  U32 acceleration, PU8 dst, U32 dst_capacity) {
+    PU8 op     = dst;
+    PU8 op_end = dst + dst_capacity;
+    U32 ip     = start;
+    U32 anchor = start;
+
+    if (end - start >= LZ4_MFLIMIT + 1) {
+        U32 mflimit    = end - LZ4_MFLIMIT;
+        U32 matchlimit = end - LZ4_LASTLITERALS;
+
+        table[lz4_hash(base + ip)] = offset + ip;
+        ip++;
+
+        for (;;) {
+            /* Step 1: find a match, skipping faster the longer nothing is found */
+            U32 ref;
+            U32 search = acceleration << LZ4_SKIP_TRIGGER;
+            U32 next   = ip;
+            for (;;) {
+                ip = next;
+                if (ip > mflimit) goto last_literals;
+                next = ip + (search++ >> LZ4_SKIP_TRIGGER);
+
+                U32 h    = lz4_hash(base + ip);
+                U32 cand = table[h];
+                table[h] = offset + ip;
+
+                if (cand < offset + low) continue;         /* stale or outside window */
+                ref = cand - offset;
+                if (ref >= ip || ip - ref > LZ4_MAX_DISTANCE) continue;
+                if (LOAD32(base + ref) == LOAD32(base + ip)) break;
             }
 
-            U32 lit_len = i - literal_start;
-            U32 offset  = i - candidate;
+            /* Step 2: extend backwards over pending literals */
+            while (ip > anchor && ref > low && base[ip - 1] == base[ref - 1]) {
+                ip--;
+                ref--;
+            }
 
-            /* Bounds guard (worst case: token + extras + lits + 2 + extras) */
-            if (op + 1 + (lit_len / 255) + 1 + lit_len + 2 + (match_len / 255) + 1 > op_end)
-                return 0;
+            /* Step 3: extend forwards */
+            U32 match_len = LZ4_MINMATCH +
+                lz4_count(base + ip + LZ4_MINMATCH, base + ref + LZ4_MINMATCH, base + matchlimit);
 
-            /* Step 4a: write token */
-            U8 lit_nibble   = (lit_len   >= 15) ? 15 : (U8)lit_len;
-            U8 match_nibble = (match_len - 4 >= 15) ? 15 : (U8)(match_len - 4);
-            *op++ = (U8)((lit_nibble << 4) | match_nibble);
+            op = lz4_emit_sequence(op, op_end, base + anchor, ip - anchor, ip - ref, match_len);
+            if (!op) return 0;
 
-            /* Step 4b: write extra literal length bytes */
-            if (lit_len >= 15) op = emit_extra(op, lit_len - 15);
+            ip += match_len;
+            anchor = ip;
+            if (ip > mflimit) break;
 
-            /* Step 4c: write literals */
-            MEMCPY_OPT(op, src + literal_start, lit_len);
-            op += lit_len;
+            /* Keep the table warm for the bytes just skipped */
+            table[lz4_hash(base + ip - 2)] = offset + ip - 2;
+        }
+    }
 
-            /* Step 4d: write 2-byte little-endian offset */
-            *op++ = (U8)(offset & 0xFF);
-            *op++ = (U8)((offset >> 8) & 0xFF);
+last_literals:
+    op = lz4_emit_last_literals(op, op_end, base + anchor, end - anchor);
+    if (!op) return 0;
+    return (U32)(op - dst);
+}
 
-            /* Step 4e: write extra match length bytes */
-            if (match_len - 4 >= 15) op = emit_extra(op, match_len - 4 - 15);
+/* Shared by every LZ4_COMPRESS_FAST call; see g_hash_offset. */
+static U32 hash_table[LZ4_HASH_SIZE] ATTRIB_DATA;
+static U32 g_hash_offset = 1;
 
-            /* Advance past the match */
-            i += match_len;
-            literal_start = i;
-        } else {
-            /* No match — accumulate literal */
-            i++;
+static U32 clamp_acceleration(U32 acceleration) {
+    if (acceleration < 1) return 1;
+    if (acceleration > LZ4_ACCELERATION_MAX) return LZ4_ACCELERATION_MAX;
+    return acceleration;
+}
+
+U32 LZ4_COMPRESS_FAST(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity, U32 acceleration) {
+    if (!dst || (!src && src_len)) return 0;
+
+    if (src_len > LZ4_OFFSET_LIMIT - g_hash_offset) {
+        MEMZERO(hash_table, sizeof(hash_table));
+        g_hash_offset = 1;
+        if (src_len > LZ4_OFFSET_LIMIT - g_hash_offset) return 0;
+    }
+
+    U32 n = lz4_compress_fast_core(src, 0, src_len, 0, hash_table, g_hash_offset,
+                                   clamp_acceleration(acceleration), dst, dst_capacity);
+
+    /* Every position of this call is now below the next call's offset */
+    g_hash_offset += src_len;
+    return n;
+}
+
+U32 LZ4_COMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity) {
+    return LZ4_COMPRESS_FAST(src, src_len, dst, dst_capacity, LZ4_ACCELERATION_DEFAULT);
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  High-compression match finder (hash chains)
+ *
+ *  head[] holds the most recent stream offset per hash, chain[] the
+ *  distance from a position to the previous one with the same hash
+ *  (0 terminates the chain). Every position is inserted, so the search
+ *  sees all candidates inside the 64 KB window.
+ * ════════════════════════════════════════════════════════════════════ */
+
+typedef struct {
+    U32 head[LZ4HC_HASH_SIZE];
+    U16 chain[LZ4HC_CHAIN_SIZE];
+    U32 next_to_update;     /* stream offset of the next position to insert */
+} LZ4HC_STATE;
+
+static VOID lz4hc_insert(LZ4HC_STATE *hc, PU8 base, U32 offset, U32 target) {
+    while (hc->next_to_update < target) {
+        U32 cur   = hc->next_to_update++;
+        U32 h     = lz4hc_hash(base + (cur - offset));
+        U32 prev  = hc->head[h];
+        U32 delta = (prev && cur - prev <= LZ4_MAX_DISTANCE) ? cur - prev : 0;
+        hc->chain[cur & (LZ4HC_CHAIN_SIZE - 1)] = (U16)delta;
+        hc->head[h] = cur;
+    }
+}
+
+static U32 lz4hc_find_best(LZ4HC_STATE *hc, PU8 base, U32 offset, U32 low, U32 ip,
+                           U32 matchlimit, U32 attempts, U32 *ref_out) {
+    U32 cur = offset + ip;
+    lz4hc_insert(hc, base, offset, cur);
+
+    U32 min_cand = offset + low;
+    if (cur - min_cand > LZ4_MAX_DISTANCE) min_cand = cur - LZ4_MAX_DISTANCE;
+
+    U32 best = 0;
+    U32 cand = hc->head[lz4hc_hash(base + ip)];
+    while (attempts-- && cand >= min_cand && cand < cur) {
+        U32 ref = cand - offset;
+        if (base[ref + best] == base[ip + best] && LOAD32(base + ref) == LOAD32(base + ip)) {
+            U32 len = LZ4_MINMATCH +
+                lz4_count(base + ip + LZ4_MINMATCH, base + ref + LZ4_MINMATCH, base + matchlimit);
+            if (len > best) {
+                best = len;
+                *ref_out = ref;
+                if (ip + len >= matchlimit) break; /* cannot get any longer */
+            }
         }
+        U32 delta = hc->chain[cand & (LZ4HC_CHAIN_SIZE - 1)];
+        if (delta == 0 || delta > cand) break;
+        cand -= delta;
     }
+    return best;
+}
 
-    /* Step 5: flush all remaining bytes (including mandatory last-5) as literals */
-    U32 lit_len = src_len - literal_start;
-    if (op + 1 + (lit_len / 255) + 1 + lit_len > op_end) return 0;
+static U32 lz4_compress_hc_core(PU8 base, U32 start, U32 end, U32 low, LZ4HC_STATE *hc, U32 offset,
+                                U32 level, PU8 dst, U32 dst_capacity) {
+    PU8 op       = dst;
+    PU8 op_end   = dst + dst_capacity;
+    U32 ip       = start;
+    U32 anchor   = start;
+    U32 attempts = 1U << (level - 1);
 
-    U8 lit_nibble = (lit_len >= 15) ? 15 : (U8)lit_len;
-    *op++ = (U8)(lit_nibble << 4); /* low nibble = 0: no match */
-    if (lit_len >= 15) op = emit_extra(op, lit_len - 15);
-    MEMCPY_OPT(op, src + literal_start, lit_len);
-    op += lit_len;
+    if (end - start >= LZ4_MFLIMIT + 1) {
+        U32 mflimit    = end - LZ4_MFLIMIT;
+        U32 matchlimit = end - LZ4_LASTLITERALS;
+
+        while (ip <= mflimit) {
+            U32 ref = 0;
+            U32 len = lz4hc_find_best(hc, base, offset, low, ip, matchlimit, attempts, &ref);
+            if (len < LZ4_MINMATCH) { ip++; continue; }
+
+            /* Lazy evaluation: prefer a longer match starting one byte later */
+            while (ip + 1 <= mflimit) {
+                U32 ref2 = 0;
+                U32 len2 = lz4hc_find_best(hc, base, offset, low, ip + 1, matchlimit, attempts, &ref2);
+                if (len2 <= len) break;
+                ip++;
+                len = len2;
+                ref = ref2;
+            }
 
+            op = lz4_emit_sequence(op, op_end, base + anchor, ip - anchor, ip - ref, len);
+            if (!op) return 0;
+            ip += len;
+            anchor = ip;
+        }
+    }
+
+    op = lz4_emit_last_literals(op, op_end, base + anchor, end - anchor);
+    if (!op) return 0;
     return (U32)(op - dst);
-}
\ No newline at end of file
+}
+
+static U32 clamp_hc_level(U32 level) {
+    if (level < LZ4HC_LEVEL_MIN) return LZ4HC_LEVEL_MIN;
+    if (level > LZ4HC_LEVEL_MAX) return LZ4HC_LEVEL_MAX;
+    return level;
+}
+
+U32 LZ4_COMPRESS_HC(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity, U32 level) {
+    if (!dst || (!src && src_len) || src_len > LZ4_OFFSET_LIMIT) return 0;
+
+    LZ4HC_STATE *hc = (LZ4HC_STATE *)CAlloc(1, sizeof(LZ4HC_STATE));
+    if (!hc) return 0;
+    hc->next_to_update = 1;
+
+    U32 n = lz4_compress_hc_core(src, 0, src_len, 0, hc, 1, clamp_hc_level(level), dst, dst_capacity);
+    MFree(hc);
+    return n;
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  xxHash32 (frame header and content checksums)
+ * ════════════════════════════════════════════════════════════════════ */
+
+#define XXH_PRIME32_1 2654435761U
+#define XXH_PRIME32_2 2246822519U
+#define XXH_PRIME32_3 3266489917U
+#define XXH_PRIME32_4 668265263U
+#define XXH_PRIME32_5 374761393U
+
+static U32 xxh_rotl(U32 x, U32 r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+static U32 xxh_round(U32 acc, U32 input) {
+    acc += input * XXH_PRIME32_2;
+    acc = xxh_rotl(acc, 13);
+    return acc * XXH_PRIME32_1;
+}
+
+static VOID xxh32_init(LZ4F_XXH32_STATE *s) {
+    MEMZERO(s, sizeof(*s));
+    s->v[0] = XXH_PRIME32_1 + XXH_PRIME32_2;
+    s->v[1] = XXH_PRIME32_2;
+    s->v[2] = 0;
+    s->v[3] = 0 - XXH_PRIME32_1;
+}
+
+static VOID xxh32_stripe(LZ4F_XXH32_STATE *s, PU8 p) {
+    s->v[0] = xxh_round(s->v[0], LOAD32(p));
+    s->v[1] = xxh_round(s->v[1], LOAD32(p + 4));
+    s->v[2] = xxh_round(s->v[2], LOAD32(p + 8));
+    s->v[3] = xxh_round(s->v[3], LOAD32(p + 12));
+}
+
+static VOID xxh32_update(LZ4F_XXH32_STATE *s, PU8 p, U32 len) {
+    s->total_len += len;
+    if (len >= 16 || s->total_len >= 16) s->large_len = TRUE;
+
+    if (s->mem_size + len < 16) {
+        MEMCPY(s->mem + s->mem_size, p, len);
+        s->mem_size += len;
+        return;
+    }
+    if (s->mem_size) {
+        U32 fill = 16 - s->mem_size;
+        MEMCPY(s->mem + s->mem_size, p, fill);
+        xxh32_stripe(s, s->mem);
+        p += fill;
+        len -= fill;
+        s->mem_size = 0;
+    }
+    while (len >= 16) {
+        xxh32_stripe(s, p);
+        p += 16;
+        len -= 16;
+    }
+    if (len) {
+        MEMCPY(s->mem, p, len);
+        s->mem_size = len;
+    }
+}
+
+static U32 xxh32_digest(LZ4F_XXH32_STATE *s) {
+    U32 h;
+    if (s->large_len)
+        h = xxh_rotl(s->v[0], 1) + xxh_rotl(s->v[1], 7) + xxh_rotl(s->v[2], 12) + xxh_rotl(s->v[3], 18);
+    else
+        h = s->v[2] + XXH_PRIME32_5;    /* v[2] still holds the seed */
+    h += s->total_len;
+
+    PU8 p = s->mem;
+    U32 rem = s->mem_size;
+    while (rem >= 4) {
+        h += LOAD32(p) * XXH_PRIME32_3;
+        h = xxh_rotl(h, 17) * XXH_PRIME32_4;
+        p += 4;
+        rem -= 4;
+    }
+    while (rem--) {
+        h += (U32)(*p++) * XXH_PRIME32_5;
+        h = xxh_rotl(h, 11) * XXH_PRIME32_1;
+    }
+
+    h ^= h >> 15;
+    h *= XXH_PRIME32_2;
+    h ^= h >> 13;
+    h *= XXH_PRIME32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+static U32 xxh32(PU8 p, U32 len) {
+    LZ4F_XXH32_STATE s;
+    xxh32_init(&s);
+    xxh32_update(&s, p, len);
+    return xxh32_digest(&s);
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Frame compression
+ * ════════════════════════════════════════════════════════════════════ */
+
+#define LZ4F_FLG_VERSION        0x40    /* version 01 in bits 7-6   */
+#define LZ4F_FLG_BLOCK_INDEP    0x20
+#define LZ4F_FLG_BLOCK_CHECKSUM 0x10
+#define LZ4F_FLG_CONTENT_SIZE   0x08
+#define LZ4F_FLG_CONTENT_CHKSUM 0x04
+#define LZ4F_FLG_DICT_ID        0x01
+#define LZ4F_BD_64KB            0x40    /* block max size id 4 in bits 6-4 */
+#define LZ4F_BLOCK_UNCOMPRESSED 0x80000000U
+
+VOID LZ4F_COMPRESS_FREE(LZ4F_CCTX *ctx) {
+    if (!ctx) return;
+    if (ctx->window)     MFreeNull(ctx->window);
+    if (ctx->hash_table) MFreeNull(ctx->hash_table);
+    if (ctx->hc)         MFreeNull(ctx->hc);
+}
+
+static VOID lz4f_reset_tables(LZ4F_CCTX *ctx) {
+    ctx->offset = 1;
+    if (ctx->hash_table) MEMZERO(ctx->hash_table, LZ4_HASH_SIZE * sizeof(U32));
+    if (ctx->hc) {
+        MEMZERO(ctx->hc, sizeof(LZ4HC_STATE));
+        ((LZ4HC_STATE *)ctx->hc)->next_to_update = ctx->offset + ctx->pos;
+    }
+}
+
+BOOL LZ4F_COMPRESS_BEGIN(LZ4F_CCTX *ctx, U32 acceleration, U32 hc_level, PU8 dst, U32 dst_capacity, U32 *out_len) {
+    if (out_len) *out_len = 0;
+    if (!ctx || !dst || dst_capacity < LZ4F_HEADER_SIZE) return FALSE;
+
+    MEMZERO(ctx, sizeof(*ctx));
+    ctx->acceleration = clamp_acceleration(acceleration);
+    ctx->hc_level     = hc_level ? clamp_hc_level(hc_level) : 0;
+    ctx->window       = (PU8)MAlloc(LZ4F_WINDOW_SIZE + LZ4F_BLOCK_SIZE);
+    if (ctx->hc_level) ctx->hc         = (PU8)CAlloc(1, sizeof(LZ4HC_STATE));
+    else               ctx->hash_table = (PU32)CAlloc(LZ4_HASH_SIZE, sizeof(U32));
+    if (!ctx->window || (!ctx->hc && !ctx->hash_table)) {
+        LZ4F_COMPRESS_FREE(ctx);
+        return FALSE;
+    }
+    lz4f_reset_tables(ctx);
+    xxh32_init(&ctx->xxh);
+
+    write_le32(dst, LZ4F_MAGIC);
+    dst[4] = LZ4F_FLG_VERSION | LZ4F_FLG_CONTENT_CHKSUM;   /* linked blocks */
+    dst[5] = LZ4F_BD_64KB;
+    dst[6] = (U8)(xxh32(dst + 4, 2) >> 8);
+    if (out_len) *out_len = LZ4F_HEADER_SIZE;
+    return TRUE;
+}
+
+/* Compresses the pending block into dst, storing it raw if it does not shrink. */
+static BOOL lz4f_flush_block(LZ4F_CCTX *ctx, PU8 dst, U32 dst_capacity, U32 *written) {
+    U32 len = ctx->pending;
+    *written = 0;
+    if (len == 0) return TRUE;
+    if (dst_capacity < len + 4) return FALSE;
+
+    U32 start = ctx->pos;
+    U32 n;
+    if (ctx->hc)
+        n = lz4_compress_hc_core(ctx->window, start, start + len, 0, (LZ4HC_STATE *)ctx->hc,
+                                 ctx->offset, ctx->hc_level, dst + 4, len - 1);
+    else
+        n = lz4_compress_fast_core(ctx->window, start, start + len, 0, ctx->hash_table,
+                                   ctx->offset, ctx->acceleration, dst + 4, len - 1);
+
+    if (n == 0) {
+        write_le32(dst, len | LZ4F_BLOCK_UNCOMPRESSED);
+        MEMCPY_OPT(dst + 4, ctx->window + start, len);
+        n = len;
+    } else {
+        write_le32(dst, n);
+    }
+    *written = n + 4;
+
+    ctx->pos += len;
+    ctx->pending = 0;
+
+    /* Keep only the last 64 KB of history so the next block fits */
+    if (ctx->pos > LZ4F_WINDOW_SIZE) {
+        U32 shift = ctx->pos - LZ4F_WINDOW_SIZE;
+        MEMMOVE_OPT(ctx->window, ctx->window + shift, LZ4F_WINDOW_SIZE);
+        ctx->pos = LZ4F_WINDOW_SIZE;
+        ctx->offset += shift;
+        if (ctx->offset > LZ4_OFFSET_LIMIT) lz4f_reset_tables(ctx);
+    }
+    return TRUE;
+}
+
+BOOL LZ4F_COMPRESS_UPDATE(LZ4F_CCTX *ctx, PU8 src, U32 src_len, PU8 dst, U32 dst_capacity, U32 *out_len) {
+    U32 total = 0;
+    if (out_len) *out_len = 0;
+    if (!ctx || !ctx->window || (!src && src_len)) return FALSE;
+
+    while (src_len) {
+        U32 n = LZ4F_BLOCK_SIZE - ctx->pending;
+        if (n > src_len) n = src_len;
+
+        MEMCPY_OPT(ctx->window + ctx->pos + ctx->pending, src, n);
+        xxh32_update(&ctx->xxh, src, n);
+        ctx->pending += n;
+        src += n;
+        src_len -= n;
+
+        if (ctx->pending == LZ4F_BLOCK_SIZE) {
+            U32 written;
+            if (!dst || !lz4f_flush_block(ctx, dst + total, dst_capacity - total, &written))
+                return FALSE;
+            total += written;
+        }
+    }
+
+    if (out_len) *out_len = total;
+    return TRUE;
+}
+
+BOOL LZ4F_COMPRESS_END(LZ4F_CCTX *ctx, PU8 dst, U32 dst_capacity, U32 *out_len) {
+    U32 total = 0;
+    if (out_len) *out_len = 0;
+    if (!ctx || !ctx->window || !dst) return FALSE;
+
+    if (!lz4f_flush_block(ctx, dst, dst_capacity, &total) || dst_capacity - total < 8) {
+        LZ4F_COMPRESS_FREE(ctx);
+        return FALSE;
+    }
+    write_le32(dst + total, 0);                        /* end mark */
+    write_le32(dst + total + 4, xxh32_digest(&ctx->xxh));
+    total += 8;
+
+    LZ4F_COMPRESS_FREE(ctx);
+    if (out_len) *out_len = total;
+    return TRUE;
+}
+
+/* ════════════════════════════════════════════════════════════════════
+ *  Frame decompression
+ * ════════════════════════════════════════════════════════════════════ */
+
+typedef enum {
+    LZ4F_STAGE_HEADER = 0,      /* magic, FLG, BD            */
+    LZ4F_STAGE_HEADER_REST,     /* content size, dict id, HC */
+    LZ4F_STAGE_BLOCK_SIZE,
+    LZ4F_STAGE_BLOCK_DATA,
+    LZ4F_STAGE_CHECKSUM,
+    LZ4F_STAGE_DONE,
+} LZ4F_STAGE;
+
+VOID LZ4F_DECOMPRESS_INIT(LZ4F_DCTX *ctx) {
+    if (!ctx) return;
+    MEMZERO(ctx, sizeof(*ctx));
+    ctx->stage    = LZ4F_STAGE_HEADER;
+    ctx->tmp_need = 6;
+}
+
+VOID LZ4F_DECOMPRESS_FREE(LZ4F_DCTX *ctx) {
+    if (!ctx) return;
+    if (ctx->window) MFreeNull(ctx->window);
+    if (ctx->block)  MFreeNull(ctx->block);
+}
+
+/* Copies up to tmp_need bytes into ctx->tmp. TRUE once the field is complete. */
+static BOOL lz4f_collect(LZ4F_DCTX *ctx, PU8 *ip, PU8 ip_end) {
+    U32 n = ctx->tmp_need - ctx->tmp_have;
+    if (n > (U32)(ip_end - *ip)) n = (U32)(ip_end - *ip);
+    MEMCPY(ctx->tmp + ctx->tmp_have, *ip, n);
+    ctx->tmp_have += n;
+    *ip += n;
+    return ctx->tmp_have == ctx->tmp_need;
+}
+
+static VOID lz4f_expect(LZ4F_DCTX *ctx, U32 stage, U32 need) {
+    ctx->stage    = stage;
+    ctx->tmp_have = 0;
+    ctx->tmp_need = need;
+}
+
+static BOOL lz4f_parse_header(LZ4F_DCTX *ctx) {
+    U8  flg = ctx->tmp[4];
+    U8  bd  = ctx->tmp[5];
+    U32 bsid = (bd >> 4) & 0x07;
+
+    if ((flg & 0xC0) != LZ4F_FLG_VERSION || (flg & 0x02) || (bd & 0x8F)) return FALSE;
+    if (bsid < 4) return FALSE;
+    if (flg & LZ4F_FLG_DICT_ID) return FALSE;  /* external dictionaries are not supported */
+
+    ctx->flg       = flg;
+    ctx->block_max = 1U << (8 + 2 * bsid);      /* 4: 64 KB .. 7: 4 MB */
+
+    U32 rest = 1 + ((flg & LZ4F_FLG_CONTENT_SIZE) ? 8 : 0);
+    ctx->stage    = LZ4F_STAGE_HEADER_REST;
+    ctx->tmp_need = 6 + rest;
+    return TRUE;
+}
+
+static BOOL lz4f_decode_block(LZ4F_DCTX *ctx) {
+    if (ctx->flg & LZ4F_FLG_BLOCK_CHECKSUM) {
+        if (read_le32(ctx->block + ctx->blk_size) != xxh32(ctx->block, ctx->blk_size)) return FALSE;
+    }
+
+    /* Make room for a full block after the retained history */
+    if (ctx->pos + ctx->block_max > LZ4F_WINDOW_SIZE + ctx->block_max) {
+        MEMMOVE_OPT(ctx->window, ctx->window + ctx->pos - LZ4F_WINDOW_SIZE, LZ4F_WINDOW_SIZE);
+        ctx->pos = LZ4F_WINDOW_SIZE;
+    }
+
+    U32 n;
+    if (ctx->blk_raw) {
+        MEMCPY_OPT(ctx->window + ctx->pos, ctx->block, ctx->blk_size);
+        n = ctx->blk_size;
+    } else {
+        n = lz4_decompress_prefix(ctx->block, ctx->blk_size, ctx->window + ctx->pos,
+                                  ctx->block_max, ctx->pos);
+        if (n == 0) return FALSE;
+    }
+
+    if (ctx->flg & LZ4F_FLG_CONTENT_CHKSUM) xxh32_update(&ctx->xxh, ctx->window + ctx->pos, n);
+    ctx->out_start   = ctx->pos;
+    ctx->out_pending = n;
+    ctx->pos += n;
+    return TRUE;
+}
+
+LZ4F_STATUS LZ4F_DECOMPRESS_UPDATE(LZ4F_DCTX *ctx, PU8 src, U32 *src_len, PU8 dst, U32 *dst_len) {
+    PU8 ip = src, ip_end = src + *src_len;
+    PU8 op = dst, op_end = dst + *dst_len;
+    LZ4F_STATUS status = LZ4F_NEED_MORE;
+
+    for (;;) {
+        /* Hand out decoded bytes first */
+        if (ctx->out_pending) {
+            U32 n = ctx->out_pending;
+            if (n > (U32)(op_end - op)) n = (U32)(op_end - op);
+            MEMCPY_OPT(op, ctx->window + ctx->out_start, n);
+            op += n;
+            ctx->out_start   += n;
+            ctx->out_pending -= n;
+            if (ctx->out_pending) break;    /* caller's buffer is full */
+        }
+
+        if (ctx->stage == LZ4F_STAGE_DONE) { status = LZ4F_FRAME_DONE; break; }
+        if (ip >= ip_end) break;
+
+        switch (ctx->stage) {
+        case LZ4F_STAGE_HEADER:
+            if (!lz4f_collect(ctx, &ip, ip_end)) break;
+            if (read_le32(ctx->tmp) != LZ4F_MAGIC || !lz4f_parse_header(ctx)) goto fail;
+            break;
+
+        case LZ4F_STAGE_HEADER_REST:
+            if (!lz4f_collect(ctx, &ip, ip_end)) break;
+            if ((U8)(xxh32(ctx->tmp + 4, ctx->tmp_need - 5) >> 8) != ctx->tmp[ctx->tmp_need - 1]) goto fail;
+            ctx->window = (PU8)MAlloc(LZ4F_WINDOW_SIZE + ctx->block_max);
+            ctx->block  = (PU8)MAlloc(ctx->block_max + 4);
+            if (!ctx->window || !ctx->block) goto fail;
+            xxh32_init(&ctx->xxh);
+            lz4f_expect(ctx, LZ4F_STAGE_BLOCK_SIZE, 4);
+            break;
+
+        case LZ4F_STAGE_BLOCK_SIZE: {
+            if (!lz4f_collect(ctx, &ip, ip_end)) break;
+            U32 word = read_le32(ctx->tmp);
+            if (word == 0) {
+                if (ctx->flg & LZ4F_FLG_CONTENT_CHKSUM) lz4f_expect(ctx, LZ4F_STAGE_CHECKSUM, 4);
+                else ctx->stage = LZ4F_STAGE_DONE;
+                break;
+            }
+            ctx->blk_raw  = (word & LZ4F_BLOCK_UNCOMPRESSED) != 0;
+            ctx->blk_size = word & ~LZ4F_BLOCK_UNCOMPRESSED;
+            ctx->blk_have = 0;
+            if (ctx->blk_size > ctx->block_max) goto fail;
+            ctx->stage = LZ4F_STAGE_BLOCK_DATA;
+            break;
+        }
+
+        case LZ4F_STAGE_BLOCK_DATA: {
+            U32 need = ctx->blk_size + ((ctx->flg & LZ4F_FLG_BLOCK_CHECKSUM) ? 4 : 0);
+            U32 n = need - ctx->blk_have;
+            if (n > (U32)(ip_end - ip)) n = (U32)(ip_end - ip);
+            MEMCPY_OPT(ctx->block + ctx->blk_have, ip, n);
+            ctx->blk_have += n;
+            ip += n;
+            if (ctx->blk_have < need) break;
+            if (!lz4f_decode_block(ctx)) goto fail;
+            lz4f_expect(ctx, LZ4F_STAGE_BLOCK_SIZE, 4);
+            break;
+        }
+
+        case LZ4F_STAGE_CHECKSUM:
+            if (!lz4f_collect(ctx, &ip, ip_end)) break;
+            if (read_le32(ctx->tmp) != xxh32_digest(&ctx->xxh)) goto fail;
+            ctx->stage = LZ4F_STAGE_DONE;
+            break;
+        }
+    }
+
+    *src_len = (U32)(ip - src);
+    *dst_len = (U32)(op - dst);
+    return status;
+
+fail:
+    *src_len = (U32)(ip - src);
+    *dst_len = (U32)(op - dst);
+    return LZ4F_ERROR;
+}
@@ -11,6 +11,7 @@
 U32 LZ4_DECOMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity);
 
 /// @brief Compresses data using LZ4 algorithm.
+/// Same as LZ4_COMPRESS_FAST with LZ4_ACCELERATION_DEFAULT.
 /// @param src Pointer to the source data to be compressed.
 /// @param src_len Length of the source data.
 /// @param dst Pointer to the destination buffer for compressed data.
@@ -18,8 +19,143 @@ U32 LZ4_DECOMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity);
 /// @return The number of bytes compressed, or 0 if an error occurred.
 U32 LZ4_COMPRESS(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity);
 
+#define LZ4_ACCELERATION_DEFAULT 1
+#define LZ4_ACCELERATION_MAX     65537
+
+/// @brief Compresses data using LZ4 with a configurable acceleration.
+/// Acceleration controls how quickly the match finder skips ahead over data
+/// that does not match: 1 gives the best ratio, larger values trade ratio
+/// for speed on poorly compressible input. Values are clamped to
+/// [1, LZ4_ACCELERATION_MAX].
+/// @return The number of bytes compressed, or 0 if dst was too small.
+U32 LZ4_COMPRESS_FAST(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity, U32 acceleration);
+
+#define LZ4HC_LEVEL_MIN     1
+#define LZ4HC_LEVEL_DEFAULT 9
+#define LZ4HC_LEVEL_MAX     12
+
+/// @brief Compresses data using the high-compression (hash chain) match finder.
+/// Output is a plain LZ4 block, decodable with LZ4_DECOMPRESS.
+/// The level selects how many chain candidates are searched per position
+/// (1 << (level - 1)) and is clamped to [LZ4HC_LEVEL_MIN, LZ4HC_LEVEL_MAX].
+/// Allocates ~256 KB of working memory for the duration of the call.
+/// @return The number of bytes compressed, or 0 if an error occurred.
+U32 LZ4_COMPRESS_HC(PU8 src, U32 src_len, PU8 dst, U32 dst_capacity, U32 level);
+
 /// @brief Returns the maximum compressed size for a given input length.
 /// Use this to allocate the dst buffer before calling LZ4_COMPRESS.
 #define LZ4_COMPRESS_BOUND(n) ((n) + ((n) / 255) + 16)
 
-#endif // ATZP_H
\ No newline at end of file
+/*
+ * ════════════════════════════════════════════════════════════════════
+ *  LZ4 Frame (streaming) API
+ *
+ *  Produces and consumes the standard LZ4 frame format (magic
+ *  0x184D2204), so .lz4 files are interchangeable with the reference
+ *  lz4 tool. Frames written here use 64 KB linked blocks (each block may
+ *  reference the previous 64 KB of output) and carry a content checksum.
+ *
+ *  Compression:
+ *      LZ4F_CCTX c;
+ *      LZ4F_COMPRESS_BEGIN(&c, LZ4_ACCELERATION_DEFAULT, 0, out, cap, &n);
+ *      while (more input)
+ *          LZ4F_COMPRESS_UPDATE(&c, chunk, len, out, cap, &n);
+ *      LZ4F_COMPRESS_END(&c, out, cap, &n);
+ *
+ *  Decompression:
+ *      LZ4F_DCTX d;
+ *      LZ4F_DECOMPRESS_INIT(&d);
+ *      do {
+ *          in_len = ...; out_len = cap;
+ *          st = LZ4F_DECOMPRESS_UPDATE(&d, in, &in_len, out, &out_len);
+ *      } while (st == LZ4F_NEED_MORE);
+ *      LZ4F_DECOMPRESS_FREE(&d);
+ * ════════════════════════════════════════════════════════════════════
+ */
+
+#define LZ4F_MAGIC          0x184D2204
+#define LZ4F_BLOCK_SIZE     (64 * 1024)     /* block size used by the compressor */
+#define LZ4F_WINDOW_SIZE    (64 * 1024)     /* history kept for linked blocks    */
+#define LZ4F_HEADER_SIZE    7               /* magic + FLG + BD + HC             */
+
+/// @brief Worst-case output of one LZ4F_COMPRESS_UPDATE call fed n bytes.
+#define LZ4F_UPDATE_BOUND(n) ((((n) / LZ4F_BLOCK_SIZE) + 1) * (LZ4F_BLOCK_SIZE + 4))
+/// @brief Worst-case output of LZ4F_COMPRESS_END (last block + end mark + checksum).
+#define LZ4F_END_BOUND       (LZ4F_BLOCK_SIZE + 4 + 4 + 4)
+
+typedef struct {
+    U32  total_len;
+    BOOL large_len;
+    U32  v[4];
+    U8   mem[16];
+    U32  mem_size;
+} LZ4F_XXH32_STATE;
+
+typedef struct {
+    PU8  window;        /* LZ4F_WINDOW_SIZE history + one pending block */
+    PU32 hash_table;    /* fast match finder, NULLPTR in HC mode        */
+    PU8  hc;            /* hash chain state, NULLPTR in fast mode       */
+    U32  offset;        /* stream offset of window[0] plus one          */
+    U32  pos;           /* start of the pending block inside window     */
+    U32  pending;       /* input bytes buffered for the next block      */
+    U32  acceleration;
+    U32  hc_level;
+    LZ4F_XXH32_STATE xxh;
+} LZ4F_CCTX;
+
+typedef enum {
+    LZ4F_ERROR      = 0,    /* malformed frame, checksum mismatch or out of memory */
+    LZ4F_NEED_MORE  = 1,    /* call again with more input and/or output space      */
+    LZ4F_FRAME_DONE = 2,    /* end mark reached and content checksum verified      */
+} LZ4F_STATUS;
+
+typedef struct {
+    PU8  window;        /* LZ4F_WINDOW_SIZE history + one decoded block  */
+    PU8  block;         /* staging buffer for the compressed block       */
+    U32  block_max;
+    U32  pos;           /* end of decoded data inside window             */
+    U32  out_start;     /* decoded bytes not yet handed to the caller    */
+    U32  out_pending;
+    U32  stage;
+    U8   flg;
+    U8   tmp[20];       /* frame header / block size / checksum fields   */
+    U32  tmp_have;
+    U32  tmp_need;
+    U32  blk_size;
+    U32  blk_have;
+    BOOL blk_raw;
+    LZ4F_XXH32_STATE xxh;
+} LZ4F_DCTX;
+
+/// @brief Starts a new frame and writes its LZ4F_HEADER_SIZE byte header to dst.
+/// @param hc_level 0 to use the fast match finder with the given acceleration,
+///                 otherwise the hash chain match finder at that level.
+/// @return TRUE on success. Free the context with LZ4F_COMPRESS_END or LZ4F_COMPRESS_FREE.
+BOOL LZ4F_COMPRESS_BEGIN(LZ4F_CCTX *ctx, U32 acceleration, U32 hc_level, PU8 dst, U32 dst_capacity, U32 *out_len);
+
+/// @brief Feeds src into the frame. Every full 64 KB block is written to dst.
+/// dst_capacity must be at least LZ4F_UPDATE_BOUND(src_len).
+/// @return FALSE if dst was too small.
+BOOL LZ4F_COMPRESS_UPDATE(LZ4F_CCTX *ctx, PU8 src, U32 src_len, PU8 dst, U32 dst_capacity, U32 *out_len);
+
+/// @brief Flushes the last block, writes the end mark and content checksum,
+/// and releases the context. dst_capacity must be at least LZ4F_END_BOUND.
+BOOL LZ4F_COMPRESS_END(LZ4F_CCTX *ctx, PU8 dst, U32 dst_capacity, U32 *out_len);
+
+/// @brief Releases a compression context without finishing the frame.
+VOID LZ4F_COMPRESS_FREE(LZ4F_CCTX *ctx);
+
+/// @brief Prepares a decompression context. Buffers are allocated once the
+/// frame header has been read.
+VOID LZ4F_DECOMPRESS_INIT(LZ4F_DCTX *ctx);
+
+/// @brief Decodes as much of src as fits into dst.
+/// @param src_len In: bytes available at src. Out: bytes consumed.
+/// @param dst_len In: space available at dst. Out: bytes written.
+/// @return LZ4F_NEED_MORE until the frame is complete, then LZ4F_FRAME_DONE.
+LZ4F_STATUS LZ4F_DECOMPRESS_UPDATE(LZ4F_DCTX *ctx, PU8 src, U32 *src_len, PU8 dst, U32 *dst_len);
+
+/// @brief Releases the buffers held by a decompression context.
+VOID LZ4F_DECOMPRESS_FREE(LZ4F_DCTX *ctx);
+
+#endif // ATZP_H
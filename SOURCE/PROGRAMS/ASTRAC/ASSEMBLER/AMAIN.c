@@ -21,6 +21,7 @@ VOID DESTROY_TOK_ARR(ASM_TOK_ARRAY *toks) {
         if (tok && tok->txt) MFree(tok->txt);
         if (tok) MFree(tok);
     }
+    if (toks->toks) MFree(toks->toks);
     MFree(toks);
 }
 
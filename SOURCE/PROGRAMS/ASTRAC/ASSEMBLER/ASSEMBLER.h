@@ -204,11 +204,10 @@ typedef struct {
     };
 } ASM_TOK, *PASM_TOK;
 
-#define MAX_TOKENS 4096
-
 typedef struct {
     U32       len;
-    PASM_TOK  toks[MAX_TOKENS];
+    U32       cap;          /* allocated slots in toks (grows on demand) */
+    PASM_TOK *toks;
 } ASM_TOK_ARRAY;
 
 
@@ -540,14 +539,40 @@ typedef struct ASM_NODE {
     };
 } ASM_NODE, *PASM_NODE;
 
-#define MAX_NODES 4096
-
 typedef struct {
-    U32       len;
-    PASM_NODE nodes[MAX_NODES];
+    U32        len;
+    U32        cap;         /* allocated slots in nodes (grows on demand) */
+    PASM_NODE *nodes;
 } ASM_AST_ARRAY;
 
 
+/*
+ * ════════════════════════════════════════════════════════════════════════════
+ *  SYMBOL TABLE  (SYMTAB.c)
+ * ════════════════════════════════════════════════════════════════════════════
+ *  Open-addressing hash table from a label/variable name to a U32 value.
+ *  Names compare case-insensitively, like STRICMP. The table keeps its own
+ *  copy of every name and grows without a fixed limit.
+ */
+typedef struct {
+    PU8 name;               /* owned copy, NULLPTR = empty slot */
+    U32 hash;
+    U32 value;
+} ASM_SYM, *PASM_SYM;
+
+typedef struct {
+    ASM_SYM *slots;
+    U32      cap;           /* slot count, power of two (0 until first add) */
+    U32      len;           /* used slots */
+} ASM_SYMTAB;
+
+PASM_SYM ASM_SYMTAB_FIND(ASM_SYMTAB *t, PU8 name);
+/* Inserts name with value. If name is already present, the existing entry
+   is returned unchanged. Returns NULLPTR when out of memory. */
+PASM_SYM ASM_SYMTAB_ADD(ASM_SYMTAB *t, PU8 name, U32 value);
+VOID     ASM_SYMTAB_FREE(ASM_SYMTAB *t);
+
+
 /*
  * ════════════════════════════════════════════════════════════════════════════
  *  TOKEN CURSOR  (used by AST builder to walk the token stream)
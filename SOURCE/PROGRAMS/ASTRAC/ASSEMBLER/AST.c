@@ -1,4 +1,5 @@
 #include <PROGRAMS/ASTRAC/ASSEMBLER/MNEMONICS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/PHASH.h>
 #include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
 
 /* Forward declarations */
@@ -91,13 +92,16 @@ STATIC BOOL ast_operand_type_ok(ASM_OPERAND_TYPE actual,
 }
 
 /*
- * After all operands are parsed, scan asm_mnemonics[] for the best table
- * entry whose name, operand count, operand types, and operand sizes all
- * agree with the parsed operands.
+ * After all operands are parsed, scan the asm_mnemonics[] entries named
+ * `name` (found through the perfect hash, in table order) for the best one
+ * whose operand count, operand types, and operand sizes all agree with the
+ * parsed operands.
  */
 STATIC const ASM_MNEMONIC_TABLE *RESOLVE_MNEMONIC(
         PU8 name, ASM_OPERAND *operands, U32 op_count) {
-    U32 tbl_len = sizeof(asm_mnemonics) / sizeof(asm_mnemonics[0]);
+    U32 n_variants = 0;
+    const U16 *variants = ASM_FIND_MNEMONIC(name, &n_variants);
+    if (!variants) return NULLPTR;
 
     /* Determine native operand size from the current code mode. */
     ASM_OPERAND_SIZE native_size =
@@ -124,11 +128,8 @@ STATIC const ASM_MNEMONIC_TABLE *RESOLVE_MNEMONIC(
 
     const ASM_MNEMONIC_TABLE *fallback = NULLPTR;
 
-    for (U32 i = 0; i < tbl_len; i++) {
-        const ASM_MNEMONIC_TABLE *tbl = &asm_mnemonics[i];
-
-        /* ── Name must match ──────────────────────────────────────── */
-        if (!tbl->name || STRICMP(name, tbl->name) != 0) continue;
+    for (U32 i = 0; i < n_variants; i++) {
+        const ASM_MNEMONIC_TABLE *tbl = &asm_mnemonics[variants[i]];
 
         /* ── Operand count ────────────────────────────────────────── */
         if ((U32)tbl->operand_count != op_count) continue;
@@ -292,7 +293,14 @@ STATIC PASM_NODE ALLOC_NODE(ASM_NODE_TYPE type, PASM_TOK tok) {
 }
 
 STATIC BOOL PUSH_NODE(ASM_AST_ARRAY *arr, PASM_NODE node) {
-    if (!node || arr->len >= MAX_NODES) return FALSE;
+    if (!node) return FALSE;
+    if (arr->len == arr->cap) {
+        U32 cap = arr->cap ? arr->cap * 2 : 1024;
+        PASM_NODE *grown = ReAlloc(arr->nodes, cap * sizeof(PASM_NODE));
+        if (!grown) return FALSE;
+        arr->nodes = grown;
+        arr->cap   = cap;
+    }
     arr->nodes[arr->len++] = node;
     return TRUE;
 }
@@ -1176,5 +1184,6 @@ VOID DESTROY_AST_ARR(ASM_AST_ARRAY *ast) {
         MFree(n);
     }
 
+    if (ast->nodes) MFree(ast->nodes);
     MFree(ast);
 }
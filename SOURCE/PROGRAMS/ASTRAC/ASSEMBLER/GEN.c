@@ -14,8 +14,6 @@ typedef struct {
     ASM_DIRECTIVE section; // which section this label belongs to (code/data/rodata) - affects how origin is applied when resolving addresses
 } ASM_PTR;
 
-#define MAX_PTRS 1024
-
 typedef struct {
     U32 code; // current code section offset
     U32 data; // current data section offset
@@ -23,11 +21,25 @@ typedef struct {
     U32 origin;             /* .org base address    */
     ASM_DIRECTIVE current_section;
     ASM_DIRECTIVE code_type;
-    ASM_PTR ptrs[MAX_PTRS];
+    ASM_PTR *ptrs;          /* labels in definition order (grows on demand) */
     U32 arr_tail;
+    U32 arr_cap;
+    ASM_SYMTAB index;       /* name -> position in ptrs */
 } ASM_PTR_ARRAY;
 
-STATIC ASM_PTR_ARRAY ptrs;
+STATIC ASM_PTR_ARRAY ptrs ATTRIB_DATA = { 0 };
+
+/*
+ * Pass 2 output. Bytes are collected in memory and written to the output
+ * file with a single FWRITE once the pass is done: FS_DISK rewrites the
+ * whole file on every FWRITE, so emitting byte by byte was quadratic.
+ */
+typedef struct {
+    PU8  data;
+    U32  len;
+    U32  cap;
+    BOOL failed;            /* set if the buffer could not grow */
+} ASM_OUT;
 
 #define FIRST_PASS 0
 #define SECOND_PASS 1
@@ -49,9 +61,24 @@ STATIC U32 CURRENT_OFFSET(VOID) {
     }
 }
 
+/* Append bytes to the output buffer, doubling it when full. */
+STATIC VOID OUT_WRITE(ASM_OUT *out, const U8 *buf, U32 len) {
+    if (out->failed) return;
+    if (out->len + len > out->cap) {
+        U32 cap = out->cap ? out->cap : 4096;
+        while (cap < out->len + len) cap *= 2;
+        PU8 grown = ReAlloc(out->data, cap);
+        if (!grown) { out->failed = TRUE; return; }
+        out->data = grown;
+        out->cap  = cap;
+    }
+    MEMCPY(out->data + out->len, buf, len);
+    out->len += len;
+}
+
 /* Write bytes to output and advance the section offset. */
-STATIC VOID EMIT(FILE *file, const U8 *buf, U32 len) {
-    if (file) FWRITE(file, (VOIDPTR)buf, len);
+STATIC VOID EMIT(ASM_OUT *out, const U8 *buf, U32 len) {
+    if (out) OUT_WRITE(out, buf, len);
 
     switch (ptrs.current_section) {
         case DIR_CODE: case DIR_CODE_TYPE_32: case DIR_CODE_TYPE_16:
@@ -63,23 +90,23 @@ STATIC VOID EMIT(FILE *file, const U8 *buf, U32 len) {
 }
 
 /* Convenience: emit a single byte. */
-STATIC VOID EMIT_U8(FILE *f, U8 val) { EMIT(f, &val, 1); }
+STATIC VOID EMIT_U8(ASM_OUT *f, U8 val) { EMIT(f, &val, 1); }
 
 /* Emit a little-endian 16-bit value. */
-STATIC VOID EMIT_U16(FILE *f, U16 val) {
+STATIC VOID EMIT_U16(ASM_OUT *f, U16 val) {
     U8 buf[2] = { val & 0xFF, (val >> 8) & 0xFF };
     EMIT(f, buf, 2);
 }
 
 /* Emit a little-endian 32-bit value. */
-STATIC VOID EMIT_U32(FILE *f, U32 val) {
+STATIC VOID EMIT_U32(ASM_OUT *f, U32 val) {
     U8 buf[4] = { val & 0xFF, (val >> 8) & 0xFF,
                   (val >> 16) & 0xFF, (val >> 24) & 0xFF };
     EMIT(f, buf, 4);
 }
 
 /* Emit an immediate of the given size (little-endian). */
-STATIC VOID EMIT_IMM(FILE *f, U32 val, ASM_OPERAND_SIZE sz) {
+STATIC VOID EMIT_IMM(ASM_OUT *f, U32 val, ASM_OPERAND_SIZE sz) {
     DEBUGM_PRINTF("[ASM GEN] Emitting immediate value 0x%X with size %u bits\n", val, sz);
     switch (sz) {
         case SZ_8BIT:  EMIT_U8(f, (U8)val);   break;
@@ -94,19 +121,31 @@ STATIC VOID EMIT_IMM(FILE *f, U32 val, ASM_OPERAND_SIZE sz) {
  * ── Label table ──────────────────────────────────────────────────────────────
  */
 STATIC BOOL ADD_ASM_PTR(PU8 name, U32 offset, ASM_DIRECTIVE section) {
-    /* Update existing entry if already present */
-    for (U32 i = 0; i < ptrs.arr_tail; i++) {
-        if (ptrs.ptrs[i].name && STRICMP(ptrs.ptrs[i].name, name) == 0) {
-            ptrs.ptrs[i].offset  = offset;
-            ptrs.ptrs[i].section = section;
-            return TRUE;
+    /* Make room first so a new index entry always has a slot behind it */
+    if (ptrs.arr_tail == ptrs.arr_cap) {
+        U32 cap = ptrs.arr_cap ? ptrs.arr_cap * 2 : 256;
+        ASM_PTR *grown = ReAlloc(ptrs.ptrs, cap * sizeof(ASM_PTR));
+        if (!grown) {
+            printf("[ASM GEN] Error: out of memory for label '%s'\n", name);
+            return FALSE;
         }
+        ptrs.ptrs    = grown;
+        ptrs.arr_cap = cap;
     }
-    if (ptrs.arr_tail >= MAX_PTRS) {
-        printf("[ASM GEN] Error: Exceeded maximum number of labels (%u)\n", MAX_PTRS);
+
+    PASM_SYM sym = ASM_SYMTAB_ADD(&ptrs.index, name, ptrs.arr_tail);
+    if (!sym) {
+        printf("[ASM GEN] Error: out of memory for label '%s'\n", name);
         return FALSE;
     }
-    ptrs.ptrs[ptrs.arr_tail].name      = name;
+
+    /* Update existing entry if already present */
+    if (sym->value != ptrs.arr_tail) {
+        ptrs.ptrs[sym->value].offset  = offset;
+        ptrs.ptrs[sym->value].section = section;
+        return TRUE;
+    }
+    ptrs.ptrs[ptrs.arr_tail].name      = sym->name;
     ptrs.ptrs[ptrs.arr_tail].offset    = offset;
     ptrs.ptrs[ptrs.arr_tail].byte_size = 0;
     ptrs.ptrs[ptrs.arr_tail].section   = section;
@@ -114,12 +153,19 @@ STATIC BOOL ADD_ASM_PTR(PU8 name, U32 offset, ASM_DIRECTIVE section) {
     return TRUE;
 }
 
+/* The returned pointer is only valid until the next ADD_ASM_PTR. */
 STATIC ASM_PTR *FIND_ASM_PTR(PU8 name) {
-    for (U32 i = 0; i < ptrs.arr_tail; i++) {
-        if (ptrs.ptrs[i].name && STRICMP(ptrs.ptrs[i].name, name) == 0)
-            return &ptrs.ptrs[i];
-    }
-    return NULLPTR;
+    PASM_SYM sym = ASM_SYMTAB_FIND(&ptrs.index, name);
+    return sym ? &ptrs.ptrs[sym->value] : NULLPTR;
+}
+
+/* Drops all labels; section offsets and origin are left alone. */
+STATIC VOID FREE_ASM_PTRS(VOID) {
+    if (ptrs.ptrs) MFree(ptrs.ptrs);
+    ASM_SYMTAB_FREE(&ptrs.index);
+    ptrs.ptrs     = NULLPTR;
+    ptrs.arr_tail = 0;
+    ptrs.arr_cap  = 0;
 }
 
 /*
@@ -370,7 +416,7 @@ STATIC BOOL IS_REG16(ASM_REGS reg) {
  *
  *  Displacement is 0 (mod=00), 8-bit (mod=01), or 16-bit (mod=10).
  */
-STATIC VOID EMIT_MODRM_16(FILE *f, U8 reg_field, ASM_OPERAND *op) {
+STATIC VOID EMIT_MODRM_16(ASM_OUT *f, U8 reg_field, ASM_OPERAND *op) {
     if (op->type == OP_REG || op->type == OP_SEG) {
         /* mod=11 register-direct — same as 32-bit */
         EMIT_U8(f, MODRM(3, reg_field, REG_NUM(op->reg)));
@@ -448,7 +494,7 @@ STATIC VOID EMIT_MODRM_16(FILE *f, U8 reg_field, ASM_OPERAND *op) {
  *  reg_field: the /r or /digit value (3 bits placed in ModR/M reg field).
  *  operand:   the r/m side operand (OP_REG or OP_MEM).
  */
-STATIC VOID EMIT_MODRM(FILE *f, U8 reg_field, ASM_OPERAND *op) {
+STATIC VOID EMIT_MODRM(ASM_OUT *f, U8 reg_field, ASM_OPERAND *op) {
     if (op->type == OP_REG || op->type == OP_SEG) {
         /* mod=11  register-direct */
         EMIT_U8(f, MODRM(3, reg_field, REG_NUM(op->reg)));
@@ -514,7 +560,7 @@ STATIC VOID EMIT_MODRM(FILE *f, U8 reg_field, ASM_OPERAND *op) {
  *  ENC_IMM         — opcode + immediate value only (e.g. INT, PUSH imm)
  *  ENC_MODRM       — opcode + ModR/M (± SIB ± disp) + optional imm
  */
-STATIC BOOL ENCODE_INSTRUCTION(FILE *f, PASM_NODE node) {
+STATIC BOOL ENCODE_INSTRUCTION(ASM_OUT *f, PASM_NODE node) {
     const ASM_MNEMONIC_TABLE *tbl = node->instr.table_entry;
     if (!tbl) {
         printf("[ASM GEN] Line %u: Instruction has no table entry — skipping\n",
@@ -772,7 +818,7 @@ STATIC BOOL ENCODE_INSTRUCTION(FILE *f, PASM_NODE node) {
  *  Emits the raw binary data for DB / DW / DD declarations.
  *  Writes each initialiser element according to the declared type width.
  */
-STATIC BOOL ENCODE_DATA_VAR(FILE *f, PASM_NODE node) {
+STATIC BOOL ENCODE_DATA_VAR(ASM_OUT *f, PASM_NODE node) {
     PASM_VAR var = node->data.var;
     if (!var || !var->name) return FALSE;
 
@@ -1138,7 +1184,7 @@ STATIC VOID RESOLVE_LOCAL_REFS(ASM_AST_ARRAY *ast) {
  *  When f is NULL the pass only calculates offsets and records labels
  *  (Pass 1).  When f is a real file pointer it emits binary data (Pass 2).
  */
-STATIC BOOL GEN_EMIT_PASS(FILE *f, ASM_AST_ARRAY *ast, ASTRAC_ARGS *cfg) {
+STATIC BOOL GEN_EMIT_PASS(ASM_OUT *f, ASM_AST_ARRAY *ast, ASTRAC_ARGS *cfg) {
 
     for (U32 i = 0; i < ast->len; i++) {
         PASM_NODE node = ast->nodes[i];
@@ -1283,6 +1329,7 @@ BOOLEAN GEN_BINARY(ASM_AST_ARRAY *ast, PASM_INFO info) {
     }
 
     /* ── Reset state ──────────────────────────────────────────────────── */
+    FREE_ASM_PTRS();
     MEMSET(&ptrs, 0, sizeof(ptrs));
     ptrs.current_section = DIR_NONE;
     ptrs.code_type       = DIR_CODE_TYPE_32;
@@ -1297,6 +1344,7 @@ BOOLEAN GEN_BINARY(ASM_AST_ARRAY *ast, PASM_INFO info) {
      * ────────────────────────────────────────────────────────────────── */
     if (!GEN_EMIT_PASS(NULLPTR, ast, cfg)) {
         printf("[ASM GEN] Pass 1 (offset calculation) failed\n");
+        FREE_ASM_PTRS();
         return FALSE;
     }
 
@@ -1316,18 +1364,8 @@ BOOLEAN GEN_BINARY(ASM_AST_ARRAY *ast, PASM_INFO info) {
     ptrs.origin          = cfg->org;
     DEBUGM_PRINTF("[ASM GEN] Offsets reset for Pass 2: code=0, data=0, rodata=0, origin=0x%X\n", ptrs.origin);
 
-    /* ── Open output file ─────────────────────────────────────────────── */
+    ASM_OUT out = { 0 };
     PU8 outputfile = cfg->outfile;
-    if (FILE_EXISTS(outputfile)) FILE_DELETE(outputfile);
-    if (!FILE_CREATE(outputfile)) {
-        printf("[ASM GEN] Failed to create output file: %s\n", outputfile);
-        return FALSE;
-    }
-    FILE *out = FOPEN(outputfile, MODE_A | MODE_FAT32);
-    if (!out) {
-        printf("[ASM GEN] Failed to open output file: %s\n", outputfile);
-        return FALSE;
-    }
 
     ASM_PTR *main_ptr = FIND_ASM_PTR("_start");
     DEBUGM_PRINTF("[ASM GEN] Entry point '_start' offset: 0x%X\n", main_ptr ? main_ptr->offset : OFFSET_NON_EXISTENT);
@@ -1335,7 +1373,7 @@ BOOLEAN GEN_BINARY(ASM_AST_ARRAY *ast, PASM_INFO info) {
      *  Pass 2:  Emit binary
      * ────────────────────────────────────────────────────────────────── */
     CURRENT_PASS = SECOND_PASS;
-    DEBUGM_PRINTF("[ASM GEN] Starting Pass 2: emitting binary to %s\n", outputfile);
+    DEBUGM_PRINTF("[ASM GEN] Starting Pass 2: emitting binary for %s\n", outputfile);
 
     AC_FILE_HEADER h = { 0 };
     MEMZERO(&h, sizeof(AC_FILE_HEADER));
@@ -1358,17 +1396,44 @@ BOOLEAN GEN_BINARY(ASM_AST_ARRAY *ast, PASM_INFO info) {
     
     DEBUGM_PRINTF("[ASM GEN] Writing file header with entry point offset: 0x%X\n", h.entry_point_offset);
 
-    EMIT(out, (U8 *)&h, sizeof(h));
+    EMIT(&out, (U8 *)&h, sizeof(h));
 
-    if (!GEN_EMIT_PASS(out, ast, cfg)) {
-        FCLOSE(out);
+    BOOL ok = GEN_EMIT_PASS(&out, ast, cfg);
+    FREE_ASM_PTRS();
+    if (!ok) {
+        if (out.data) MFree(out.data);
+        return FALSE;
+    }
+    if (out.failed) {
+        printf("[ASM GEN] Out of memory while emitting %s\n", outputfile);
+        if (out.data) MFree(out.data);
         return FALSE;
     }
 
     DEBUGM_PRINTF("[ASM GEN] Pass 2 complete: code=%u bytes, data=%u bytes, rodata=%u bytes\n",
                  ptrs.code, ptrs.data, ptrs.rodata);
 
-    if (cfg->verbose) printf("[ASM GEN] Finished writing output file: %s, sz %u bytes\n", outputfile, out->sz);
-    FCLOSE(out);
+    /* ── Write output file in one go ──────────────────────────────────── */
+    if (FILE_EXISTS(outputfile)) FILE_DELETE(outputfile);
+    if (!FILE_CREATE(outputfile)) {
+        printf("[ASM GEN] Failed to create output file: %s\n", outputfile);
+        MFree(out.data);
+        return FALSE;
+    }
+    FILE *file = FOPEN(outputfile, MODE_W | MODE_FAT32);
+    if (!file) {
+        printf("[ASM GEN] Failed to open output file: %s\n", outputfile);
+        MFree(out.data);
+        return FALSE;
+    }
+    ok = FWRITE(file, out.data, out.len) == out.len;
+    FCLOSE(file);
+    MFree(out.data);
+    if (!ok) {
+        printf("[ASM GEN] Failed to write output file: %s\n", outputfile);
+        return FALSE;
+    }
+
+    if (cfg->verbose) printf("[ASM GEN] Finished writing output file: %s, sz %u bytes\n", outputfile, out.len);
     return TRUE;
 }
@@ -1,5 +1,7 @@
 #include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
 #include <PROGRAMS/ASTRAC/ASSEMBLER/MNEMONICS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/REGISTERS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/PHASH.h>
 
 /*
  * ════════════════════════════════════════════════════════════════════════════
@@ -7,45 +9,6 @@
  * ════════════════════════════════════════════════════════════════════════════
  */
 
-STATIC CONST KEYWORD registers[] ATTRIB_DATA = {
-    /* General Purpose 32-bit */
-    { "eax", REG_EAX }, { "ebx", REG_EBX }, { "ecx", REG_ECX }, { "edx", REG_EDX },
-    { "esi", REG_ESI }, { "edi", REG_EDI }, { "ebp", REG_EBP }, { "esp", REG_ESP },
-
-    /* General Purpose 16-bit */
-    { "ax",  REG_AX  }, { "bx",  REG_BX  }, { "cx",  REG_CX  }, { "dx",  REG_DX  },
-    { "si",  REG_SI  }, { "di",  REG_DI  }, { "bp",  REG_BP  }, { "sp",  REG_SP  },
-
-    /* 8-bit */
-    { "ah",  REG_AH  }, { "al",  REG_AL  }, { "bh",  REG_BH  }, { "bl",  REG_BL  },
-    { "ch",  REG_CH  }, { "cl",  REG_CL  }, { "dh",  REG_DH  }, { "dl",  REG_DL  },
-
-    /* Segment */
-    { "cs",  REG_CS  }, { "ds",  REG_DS  }, { "es",  REG_ES  },
-    { "fs",  REG_FS  }, { "gs",  REG_GS  }, { "ss",  REG_SS  },
-
-    /* Control */
-    { "cr0", REG_CR0 }, { "cr2", REG_CR2 }, { "cr3", REG_CR3 }, { "cr4", REG_CR4 },
-
-    /* Debug */
-    { "dr0", REG_DR0 }, { "dr1", REG_DR1 }, { "dr2", REG_DR2 }, { "dr3", REG_DR3 },
-    { "dr6", REG_DR6 }, { "dr7", REG_DR7 },
-
-    /* x87 FPU */
-    { "st0", REG_ST0 }, { "st1", REG_ST1 }, { "st2", REG_ST2 }, { "st3", REG_ST3 },
-    { "st4", REG_ST4 }, { "st5", REG_ST5 }, { "st6", REG_ST6 }, { "st7", REG_ST7 },
-
-    /* MMX */
-    { "mm0", REG_MM0 }, { "mm1", REG_MM1 }, { "mm2", REG_MM2 }, { "mm3", REG_MM3 },
-    { "mm4", REG_MM4 }, { "mm5", REG_MM5 }, { "mm6", REG_MM6 }, { "mm7", REG_MM7 },
-
-    /* SSE */
-    { "xmm0", REG_XMM0 }, { "xmm1", REG_XMM1 }, { "xmm2", REG_XMM2 }, { "xmm3", REG_XMM3 },
-    { "xmm4", REG_XMM4 }, { "xmm5", REG_XMM5 }, { "xmm6", REG_XMM6 }, { "xmm7", REG_XMM7 },
-
-    { NULL, REG_NONE }
-};
-
 STATIC CONST KEYWORD directives[] ATTRIB_DATA = {
     { "data",   DIR_DATA          },
     { "rodata", DIR_RODATA        },
@@ -98,7 +61,7 @@ STATIC CONST KEYWORD variable_types[] ATTRIB_DATA = {
     { NULL, TYPE_NONE }
 };
 
-const KEYWORD *get_registers()      { return registers;      }
+const KEYWORD *get_registers()      { return asm_registers;  }
 const KEYWORD *get_directives()     { return directives;     }
 const KEYWORD *get_symbols()        { return symbols;        }
 const KEYWORD *get_variable_types() { return variable_types; }
@@ -111,7 +74,13 @@ const KEYWORD *get_variable_types() { return variable_types; }
  */
 STATIC BOOL ADD_TOKEN(ASM_TOK_ARRAY *arr, ASM_TOKEN_TYPE type,
                       PU8 txt, U32 uval, U32 line, U32 col) {
-    if (arr->len >= MAX_TOKENS) return FALSE;
+    if (arr->len == arr->cap) {
+        U32 cap = arr->cap ? arr->cap * 2 : 1024;
+        PASM_TOK *grown = ReAlloc(arr->toks, cap * sizeof(PASM_TOK));
+        if (!grown) return FALSE;
+        arr->toks = grown;
+        arr->cap  = cap;
+    }
 
     PASM_TOK tok = MAlloc(sizeof(ASM_TOK));
     if (!tok) return FALSE;
@@ -243,18 +212,17 @@ STATIC BOOL emit_token_from_buf(ASM_TOK_ARRAY *arr, PU8 tokbuf, U32 line, U32 co
     if (kw) return ADD_TOKEN(arr, TOK_DIRECTIVE, tokbuf, kw->enum_val, line, col);
 
     /* Register */
-    kw = lookup_keyword(registers, tokbuf);
+    kw = ASM_FIND_REGISTER(tokbuf);
     if (kw) return ADD_TOKEN(arr, TOK_REGISTER, tokbuf, kw->enum_val, line, col);
 
     /* Variable type keyword (DB, DW, DD, BYTE, WORD, DWORD, REAL4, PTR) */
     kw = lookup_keyword(variable_types, tokbuf);
     if (kw) return ADD_TOKEN(arr, TOK_IDENT_VAR, tokbuf, kw->enum_val, line, col);
 
-    /* Mnemonic — look up in the auto-generated table */
-    for (U32 i = 0; i < sizeof(asm_mnemonics) / sizeof(asm_mnemonics[0]); i++) {
-        if (asm_mnemonics[i].name && STRICMP(tokbuf, asm_mnemonics[i].name) == 0)
-            return ADD_TOKEN(arr, TOK_MNEMONIC, tokbuf, asm_mnemonics[i].mnemonic, line, col);
-    }
+    /* Mnemonic — perfect-hash lookup over the auto-generated table */
+    const U16 *variants = ASM_FIND_MNEMONIC(tokbuf, NULLPTR);
+    if (variants)
+        return ADD_TOKEN(arr, TOK_MNEMONIC, tokbuf, asm_mnemonics[variants[0]].mnemonic, line, col);
 
     /* Number literal (decimal, hex, binary) */
     U32 num_val = 0;
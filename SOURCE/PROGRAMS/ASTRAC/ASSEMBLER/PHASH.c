@@ -0,0 +1,38 @@
+#include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/REGISTERS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/PHASH.h>
+#include <ASM_PHASH_TABLES.h>   /* generated by PHASH/PHASH_GEN.c */
+
+/*
+ * ════════════════════════════════════════════════════════════════════════════
+ *  PERFECT-HASH KEYWORD LOOKUP
+ * ════════════════════════════════════════════════════════════════════════════
+ *  Replaces the linear STRICMP scans over asm_mnemonics[] (lexer and
+ *  RESOLVE_MNEMONIC) and registers[] (lexer). See PHASH.h for the scheme.
+ */
+
+STATIC const ASM_PHASH_SLOT *PH_PROBE(PU8 name, const U32 *disp, U32 seed, U32 buckets,
+                                      const ASM_PHASH_SLOT *slots, U32 nslots) {
+    if (!name || !*name) return NULLPTR;
+    U32 d = disp[ASM_PHASH_STR(name, seed) % buckets];
+    if (d == 0) return NULLPTR;         /* empty bucket: no key hashes here */
+    const ASM_PHASH_SLOT *s = &slots[ASM_PHASH_STR(name, d) % nslots];
+    if (!s->name || STRICMP(name, (PU8)s->name) != 0) return NULLPTR;
+    return s;
+}
+
+const U16 *ASM_FIND_MNEMONIC(PU8 name, U32 *count) {
+    const ASM_PHASH_SLOT *s = PH_PROBE(name, asm_ph_mnem_disp, ASM_PH_MNEM_SEED,
+                                       ASM_PH_MNEM_BUCKETS, asm_ph_mnem_slots,
+                                       ASM_PH_MNEM_SLOTS);
+    if (!s) return NULLPTR;
+    if (count) *count = s->count;
+    return &asm_ph_mnem_index[s->first];
+}
+
+const KEYWORD *ASM_FIND_REGISTER(PU8 name) {
+    const ASM_PHASH_SLOT *s = PH_PROBE(name, asm_ph_reg_disp, ASM_PH_REG_SEED,
+                                       ASM_PH_REG_BUCKETS, asm_ph_reg_slots,
+                                       ASM_PH_REG_SLOTS);
+    return s ? &asm_registers[s->first] : NULLPTR;
+}
@@ -0,0 +1,55 @@
+#ifndef ASM_PHASH_H
+#define ASM_PHASH_H
+#include <STD/TYPEDEF.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
+
+/*
+ * ════════════════════════════════════════════════════════════════════════════
+ *  PERFECT-HASH KEYWORD LOOKUP  (PHASH.c)
+ *
+ *  The mnemonic names of asm_mnemonics[] (MNEMONICS.h) and the register
+ *  names of asm_registers[] (REGISTERS.h) are hashed at build time by the
+ *  host tool PHASH/PHASH_GEN.c into ASM_PHASH_TABLES.h.
+ *
+ *  Lookup is two probes of ASM_PHASH_STR:
+ *      bucket = ASM_PHASH_STR(name, seed) % buckets
+ *      slot   = ASM_PHASH_STR(name, disp[bucket]) % slots
+ *  followed by one STRICMP against the slot's name, so a miss costs the same
+ *  as a hit. The hash folds ASCII case, matching the STRICMP the lexer used.
+ * ════════════════════════════════════════════════════════════════════════════
+ */
+
+/// @brief One hash slot. For mnemonics `first`/`count` select a run of
+/// asm_ph_mnem_index[]; for registers `first` is the asm_registers[] index.
+typedef struct {
+    const U8 *name;         /* lower-case key, NULLPTR for an empty slot */
+    U16 first;
+    U16 count;
+} ASM_PHASH_SLOT;
+
+/// @brief Case-insensitive string hash shared by PHASH_GEN.c and PHASH.c.
+static inline U32 ASM_PHASH_STR(const U8 *s, U32 seed) {
+    U32 h = 0x811C9DC5 ^ (seed * 0x9E3779B9);
+    while (*s) {
+        U8 c = *s++;
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        h ^= c;
+        h *= 0x01000193;
+    }
+    h ^= h >> 16;
+    h *= 0x85EBCA6B;
+    h ^= h >> 13;
+    return h;
+}
+
+/// @brief Finds every asm_mnemonics[] entry named `name` (case-insensitive).
+/// @param count Receives the number of entries.
+/// @return Their indices in ascending table order, or NULLPTR if `name` is
+///         not a mnemonic. Same result as a linear scan of the table.
+const U16 *ASM_FIND_MNEMONIC(PU8 name, U32 *count);
+
+/// @brief Finds the asm_registers[] entry named `name` (case-insensitive).
+/// @return The entry, or NULLPTR if `name` is not a register.
+const KEYWORD *ASM_FIND_REGISTER(PU8 name);
+
+#endif // ASM_PHASH_H
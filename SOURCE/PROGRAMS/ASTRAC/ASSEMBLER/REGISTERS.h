@@ -0,0 +1,55 @@
+#ifndef REGISTERS_H
+#define REGISTERS_H
+#include <STD/TYPEDEF.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
+
+/*
+ * ════════════════════════════════════════════════════════════════════════════
+ *  REGISTER NAME TABLE
+ *
+ *  Shared by the lexer and by the perfect-hash generator (PHASH/PHASH_GEN.c),
+ *  which builds the O(1) lookup in PHASH.c from this list. Order matters only
+ *  for the NULL terminator; any edit here regenerates the hash at build time.
+ * ════════════════════════════════════════════════════════════════════════════
+ */
+
+static const KEYWORD asm_registers[] ATTRIB_DATA = {
+    /* General Purpose 32-bit */
+    { "eax", REG_EAX }, { "ebx", REG_EBX }, { "ecx", REG_ECX }, { "edx", REG_EDX },
+    { "esi", REG_ESI }, { "edi", REG_EDI }, { "ebp", REG_EBP }, { "esp", REG_ESP },
+
+    /* General Purpose 16-bit */
+    { "ax",  REG_AX  }, { "bx",  REG_BX  }, { "cx",  REG_CX  }, { "dx",  REG_DX  },
+    { "si",  REG_SI  }, { "di",  REG_DI  }, { "bp",  REG_BP  }, { "sp",  REG_SP  },
+
+    /* 8-bit */
+    { "ah",  REG_AH  }, { "al",  REG_AL  }, { "bh",  REG_BH  }, { "bl",  REG_BL  },
+    { "ch",  REG_CH  }, { "cl",  REG_CL  }, { "dh",  REG_DH  }, { "dl",  REG_DL  },
+
+    /* Segment */
+    { "cs",  REG_CS  }, { "ds",  REG_DS  }, { "es",  REG_ES  },
+    { "fs",  REG_FS  }, { "gs",  REG_GS  }, { "ss",  REG_SS  },
+
+    /* Control */
+    { "cr0", REG_CR0 }, { "cr2", REG_CR2 }, { "cr3", REG_CR3 }, { "cr4", REG_CR4 },
+
+    /* Debug */
+    { "dr0", REG_DR0 }, { "dr1", REG_DR1 }, { "dr2", REG_DR2 }, { "dr3", REG_DR3 },
+    { "dr6", REG_DR6 }, { "dr7", REG_DR7 },
+
+    /* x87 FPU */
+    { "st0", REG_ST0 }, { "st1", REG_ST1 }, { "st2", REG_ST2 }, { "st3", REG_ST3 },
+    { "st4", REG_ST4 }, { "st5", REG_ST5 }, { "st6", REG_ST6 }, { "st7", REG_ST7 },
+
+    /* MMX */
+    { "mm0", REG_MM0 }, { "mm1", REG_MM1 }, { "mm2", REG_MM2 }, { "mm3", REG_MM3 },
+    { "mm4", REG_MM4 }, { "mm5", REG_MM5 }, { "mm6", REG_MM6 }, { "mm7", REG_MM7 },
+
+    /* SSE */
+    { "xmm0", REG_XMM0 }, { "xmm1", REG_XMM1 }, { "xmm2", REG_XMM2 }, { "xmm3", REG_XMM3 },
+    { "xmm4", REG_XMM4 }, { "xmm5", REG_XMM5 }, { "xmm6", REG_XMM6 }, { "xmm7", REG_XMM7 },
+
+    { NULL, REG_NONE }
+};
+
+#endif // REGISTERS_H
@@ -0,0 +1,84 @@
+#include <PROGRAMS/ASTRAC/ASTRAC.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
+
+/*
+ * ════════════════════════════════════════════════════════════════════════════
+ *  SYMBOL TABLE
+ * ════════════════════════════════════════════════════════════════════════════
+ *  Linear-probing hash table shared by VERIFY_AST.c (duplicate / undefined
+ *  label checks) and GEN.c (label offsets). Lookups are O(1) on average, so
+ *  large sources no longer pay a full scan per symbol reference.
+ *
+ *  The table is kept at most half full; it doubles and rehashes past that.
+ */
+
+#define SYMTAB_MIN_CAP 64
+
+/* FNV-1a over upper-cased bytes, so it agrees with STRICMP. */
+STATIC U32 SYM_HASH(PU8 name) {
+    U32 h = 0x811C9DC5;
+    while (*name) {
+        h ^= TOUPPER(*name++);
+        h *= 0x01000193;
+    }
+    return h;
+}
+
+/* Returns the slot holding name, or the empty slot where it would go. */
+STATIC ASM_SYM *SYM_SLOT(ASM_SYM *slots, U32 cap, PU8 name, U32 hash) {
+    U32 mask = cap - 1;
+    U32 i = hash & mask;
+    while (slots[i].name) {
+        if (slots[i].hash == hash && STRICMP(slots[i].name, name) == 0)
+            return &slots[i];
+        i = (i + 1) & mask;
+    }
+    return &slots[i];
+}
+
+STATIC BOOL SYM_GROW(ASM_SYMTAB *t) {
+    U32 new_cap = t->cap ? t->cap * 2 : SYMTAB_MIN_CAP;
+    ASM_SYM *slots = CAlloc(new_cap, sizeof(ASM_SYM));
+    if (!slots) return FALSE;
+
+    for (U32 i = 0; i < t->cap; i++) {
+        if (!t->slots[i].name) continue;
+        *SYM_SLOT(slots, new_cap, t->slots[i].name, t->slots[i].hash) = t->slots[i];
+    }
+    if (t->slots) MFree(t->slots);
+    t->slots = slots;
+    t->cap   = new_cap;
+    return TRUE;
+}
+
+PASM_SYM ASM_SYMTAB_FIND(ASM_SYMTAB *t, PU8 name) {
+    if (!t || !name || t->len == 0) return NULLPTR;
+    ASM_SYM *s = SYM_SLOT(t->slots, t->cap, name, SYM_HASH(name));
+    return s->name ? s : NULLPTR;
+}
+
+PASM_SYM ASM_SYMTAB_ADD(ASM_SYMTAB *t, PU8 name, U32 value) {
+    if (!t || !name) return NULLPTR;
+    if ((t->len + 1) * 2 > t->cap && !SYM_GROW(t)) return NULLPTR;
+
+    U32 hash = SYM_HASH(name);
+    ASM_SYM *s = SYM_SLOT(t->slots, t->cap, name, hash);
+    if (s->name) return s;
+
+    s->name = STRDUP(name);
+    if (!s->name) return NULLPTR;
+    s->hash  = hash;
+    s->value = value;
+    t->len++;
+    return s;
+}
+
+VOID ASM_SYMTAB_FREE(ASM_SYMTAB *t) {
+    if (!t) return;
+    for (U32 i = 0; i < t->cap; i++)
+        if (t->slots[i].name) MFree(t->slots[i].name);
+    if (t->slots) MFree(t->slots);
+    t->slots = NULLPTR;
+    t->cap   = 0;
+    t->len   = 0;
+}
@@ -19,55 +19,9 @@
  * ────────────────────────────────────────────────────────────────────────────
  *  LABEL TABLE  (first pass collection)
  * ────────────────────────────────────────────────────────────────────────────
+ *  Labels and data variables live in an ASM_SYMTAB (SYMTAB.c); the value of
+ *  each entry is the AST index where the name is defined.
  */
-typedef struct {
-    PU8  name;
-    U32  node_index;        /* index in AST where this label is defined */
-} LABEL_ENTRY, *PLABEL_ENTRY;
-
-#define MAX_LABELS 512
-
-typedef struct {
-    PLABEL_ENTRY entries[MAX_LABELS];
-    U32 len;
-} LABEL_TABLE, *PLABEL_TABLE;
-
-STATIC PLABEL_TABLE alloc_label_table() {
-    PLABEL_TABLE t = MAlloc(sizeof(LABEL_TABLE));
-    if (t) MEMSET(t, 0, sizeof(LABEL_TABLE));
-    return t;
-}
-
-STATIC VOID free_label_table(PLABEL_TABLE t) {
-    if (!t) return;
-    for (U32 i = 0; i < t->len; i++) {
-        if (t->entries[i]) {
-            if (t->entries[i]->name) MFree(t->entries[i]->name);
-            MFree(t->entries[i]);
-        }
-    }
-    MFree(t);
-}
-
-STATIC PLABEL_ENTRY find_label(PLABEL_TABLE t, PU8 name) {
-    if (!t || !name) return NULLPTR;
-    for (U32 i = 0; i < t->len; i++) {
-        if (t->entries[i] && STRICMP(t->entries[i]->name, name) == 0) {
-            return t->entries[i];
-        }
-    }
-    return NULLPTR;
-}
-
-STATIC BOOL add_label(PLABEL_TABLE t, PU8 name, U32 node_index) {
-    if (!t || t->len >= MAX_LABELS) return FALSE;
-    PLABEL_ENTRY e = MAlloc(sizeof(LABEL_ENTRY));
-    if (!e) return FALSE;
-    e->name = STRDUP(name);
-    e->node_index = node_index;
-    t->entries[t->len++] = e;
-    return TRUE;
-}
 
 /*
  * ────────────────────────────────────────────────────────────────────────────
@@ -147,14 +101,14 @@ STATIC BOOL imm_in_bounds(U32 value, ASM_OPERAND_SIZE size) {
 }
 
 /* Verify a symbol name from an operand exists in the label table. */
-STATIC BOOL verify_symbol_ref(PU8 sym, PLABEL_TABLE labels, U32 line, U32 op_idx) {
+STATIC BOOL verify_symbol_ref(PU8 sym, ASM_SYMTAB *labels, U32 line, U32 op_idx) {
     if (!sym || !*sym) return TRUE;                     /* no symbol → ok */
     if (*sym == '$')   return TRUE;                     /* $ (current offset) */
     if (STRICMP(sym, "@f") == 0 || STRICMP(sym, "@b") == 0)
         return TRUE;                                    /* @f/@b resolved in codegen */
     if ((*sym == '@' && sym[1] == '@') || *sym == '.') 
         return TRUE;                                    /* @@name/.name scoped + resolved in codegen */
-    if (find_label(labels, sym)) return TRUE;
+    if (ASM_SYMTAB_FIND(labels, sym)) return TRUE;
     printf("[ASM VERIFY] Line %u: Operand %u references undefined symbol '%s'\n",
            line, op_idx + 1, sym);
     return FALSE;
@@ -167,7 +121,7 @@ STATIC BOOL verify_symbol_ref(PU8 sym, PLABEL_TABLE labels, U32 line, U32 op_idx
  * ────────────────────────────────────────────────────────────────────────────
  */
 
-STATIC BOOL verify_instruction(PASM_NODE node, PLABEL_TABLE labels) {
+STATIC BOOL verify_instruction(PASM_NODE node, ASM_SYMTAB *labels) {
     if (!node || node->type != NODE_INSTRUCTION) return FALSE;
 
     const ASM_MNEMONIC_TABLE *tbl = node->instr.table_entry;
@@ -471,11 +425,7 @@ BOOLEAN VERIFY_AST(ASM_AST_ARRAY *ast, PASM_INFO info) {
     }
 
     /* ── Pass 1: Collect all labels (check for duplicates) ─────────────── */
-    PLABEL_TABLE labels = alloc_label_table();
-    if (!labels) {
-        printf("[ASM VERIFY] Failed to allocate label table\n");
-        return FALSE;
-    }
+    ASM_SYMTAB labels = { 0 };
 
     U32 error_count = 0;
 
@@ -503,15 +453,15 @@ BOOLEAN VERIFY_AST(ASM_AST_ARRAY *ast, PASM_INFO info) {
                 STRNCAT(scoped, check_name, BUF_SZ - STRLEN(scoped) - 1);
                 check_name = scoped;
             }
-            if (find_label(labels, check_name)) {
+            if (ASM_SYMTAB_FIND(&labels, check_name)) {
                 printf("[ASM VERIFY] Line %u: Duplicate label '%s'\n",
                        node->line, check_name);
                 error_count++;
                 continue;
             }
-            if (!add_label(labels, check_name, i)) {
-                printf("[ASM VERIFY] Failed to add label (table full)\n");
-                free_label_table(labels);
+            if (!ASM_SYMTAB_ADD(&labels, check_name, i)) {
+                printf("[ASM VERIFY] Failed to add label (out of memory)\n");
+                ASM_SYMTAB_FREE(&labels);
                 return FALSE;
             }
         }
@@ -519,13 +469,11 @@ BOOLEAN VERIFY_AST(ASM_AST_ARRAY *ast, PASM_INFO info) {
         /* Also register data variable names so [varname] refs resolve */
         if (node->type == NODE_DATA_VAR && node->data.var
             && node->data.var->name) {
-            if (!find_label(labels, node->data.var->name)) {
-                add_label(labels, node->data.var->name, i);
-            }
+            ASM_SYMTAB_ADD(&labels, node->data.var->name, i);
         }
     }
 
-    if (cfg->verbose) printf("[ASM VERIFY] Collected %u labels\n", labels->len);
+    if (cfg->verbose) printf("[ASM VERIFY] Collected %u labels\n", labels.len);
 
     /* ── Pass 2: Verify each node ──────────────────────────────────────── */
     for (U32 i = 0; i < ast->len; i++) {
@@ -536,7 +484,7 @@ BOOLEAN VERIFY_AST(ASM_AST_ARRAY *ast, PASM_INFO info) {
 
         switch (node->type) {
             case NODE_INSTRUCTION:
-                ok = verify_instruction(node, labels);
+                ok = verify_instruction(node, &labels);
                 break;
             case NODE_DATA_VAR:
                 ok = verify_data_variable(node, ast, i);
@@ -564,7 +512,7 @@ BOOLEAN VERIFY_AST(ASM_AST_ARRAY *ast, PASM_INFO info) {
         if (!ok) error_count++;
     }
 
-    free_label_table(labels);
+    ASM_SYMTAB_FREE(&labels);
 
     if (error_count > 0) {
         printf("[ASM VERIFY] %u error(s) found\n", error_count);
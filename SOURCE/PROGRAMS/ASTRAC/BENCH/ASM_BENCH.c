@@ -0,0 +1,157 @@
+/*
+ * ASM_BENCH.c — Host benchmark for the ASTRAC assembler pipeline.
+ *
+ * Generates assembly sources with a growing number of labels and data
+ * variables, runs START_ASSEMBLING() on each and reports wall time, output
+ * size and how many bytes the file system would have had to write, both for
+ * the output file and in total.
+ *
+ *   ASTRAC_BENCH                         default label counts
+ *   ASTRAC_BENCH <labels> [labels ...]   custom label counts
+ *   ASTRAC_BENCH --file <in.ASM> <out>   assemble one host file (for diffing)
+ *
+ * Built by the ASTRAC_BENCH target in ../CMakeLists.txt.
+ */
+
+#include <PROGRAMS/ASTRAC/ASTRAC.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
+#include <PROGRAMS/ASTRAC/BENCH/HOST_FS.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+
+/* The atOS headers redefine size_t, so libc is declared by hand here. */
+typedef struct HOST_FILE HOST_FILE;
+extern HOST_FILE *fopen(const char *path, const char *mode);
+extern int fclose(HOST_FILE *f);
+extern unsigned long fread(void *buf, unsigned long size, unsigned long n, HOST_FILE *f);
+extern unsigned long fwrite(const void *buf, unsigned long size, unsigned long n, HOST_FILE *f);
+extern long clock(void);
+extern int atoi(const char *s);
+#define HOST_CLOCKS_PER_SEC 1000000L
+
+#define BENCH_IN  "/BENCH.ASM"
+#define BENCH_OUT "/BENCH.BIN"
+
+static ASTRAC_ARGS args;
+
+ASTRAC_ARGS* GET_ARGS() { return &args; }
+
+static VOID RESET_ARGS(VOID) {
+    MEMZERO(&args, sizeof(args));
+    args.build_type = ASSEMBLE;
+    args.quiet = TRUE;
+    args.org = 0x10000000;
+    args.dsm_bits = 32;
+    args.input_files[args.input_file_count++] = BENCH_IN;
+    args.outfile = BENCH_OUT;
+    args.got_outfile = TRUE;
+}
+
+/* ── Source generator ────────────────────────────────────────────────────── */
+
+typedef struct {
+    PU8 data;
+    U32 len;
+    U32 cap;
+} TEXT;
+
+static VOID PUT(TEXT *t, PU8 s) {
+    U32 n = STRLEN(s);
+    if (t->len + n + 1 > t->cap) {
+        t->cap = (t->len + n + 1) * 2;
+        t->data = ReAlloc(t->data, t->cap);
+    }
+    MEMCPY(t->data + t->len, s, n + 1);
+    t->len += n;
+}
+
+/*
+ * Each block has a code label with forward and backward references and one
+ * data variable, so both the symbol table and the emitter scale with n.
+ */
+static VOID GENERATE(TEXT *t, U32 n) {
+    U8 line[128];
+    PUT(t, ".use32\n.code\n_start:\n    call fn_0\n    ret\n");
+    for (U32 i = 0; i < n; i++) {
+        SPRINTF(line, "fn_%u:\n", i);                                   PUT(t, line);
+        SPRINTF(line, "    mov eax, [var_%u]\n", i);                    PUT(t, line);
+        PUT(t, "    add eax, 1\n");
+        SPRINTF(line, "    mov [var_%u], eax\n", i);                    PUT(t, line);
+        PUT(t, "    cmp eax, 100\n");
+        SPRINTF(line, "    jne fn_%u\n", (i + 1) % n);                  PUT(t, line);
+        SPRINTF(line, "    call fn_%u\n", i / 2);                       PUT(t, line);
+        PUT(t, "    ret\n");
+    }
+    PUT(t, ".data\n");
+    for (U32 i = 0; i < n; i++) {
+        SPRINTF(line, "var_%u DD %u\n", i, i);                          PUT(t, line);
+    }
+}
+
+/* ── Runs ────────────────────────────────────────────────────────────────── */
+
+static BOOL RUN(U32 n) {
+    TEXT src = { 0 };
+    GENERATE(&src, n);
+    HOST_FS_PUT(BENCH_IN, src.data, src.len);
+    MFree(src.data);
+
+    RESET_ARGS();
+    HOST_FS_RESET_STATS();
+    long t0 = clock();
+    ASTRAC_RESULT r = START_ASSEMBLING();
+    double secs = (double)(clock() - t0) / HOST_CLOCKS_PER_SEC;
+
+    U32 out_sz = 0;
+    if (r != ASTRAC_OK || !HOST_FS_GET(BENCH_OUT, &out_sz)) {
+        printf("  %6u labels: assembly failed (%d)\n", n, r);
+        return FALSE;
+    }
+    /* Output-file numbers are the assembler's own; the totals also include
+       the preprocessor's temporary files. */
+    U32 out_writes = 0;
+    double out_written = 0;
+    HOST_FS_FILE_STATS(BENCH_OUT, &out_writes, &out_written);
+    printf("  %6u labels  %7u src lines  %8u B out  %8.3f s  "
+           "out: %6u writes %12.0f B  total: %6u writes %12.0f B\n",
+           n, 5 + n * 8 + 1 + n, out_sz, secs, out_writes, out_written,
+           HOST_FS_WRITE_CALLS(), HOST_FS_BYTES_WRITTEN());
+    return TRUE;
+}
+
+static int RUN_FILE(const char *in, const char *out) {
+    HOST_FILE *f = fopen(in, "rb");
+    if (!f) { printf("cannot read %s\n", in); return 1; }
+    static U8 buf[1 << 20];
+    U32 len = (U32)fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    HOST_FS_PUT(BENCH_IN, buf, len);
+
+    RESET_ARGS();
+    if (START_ASSEMBLING() != ASTRAC_OK) return 1;
+
+    U32 sz = 0;
+    PU8 bin = HOST_FS_GET(BENCH_OUT, &sz);
+    f = fopen(out, "wb");
+    if (!f || !bin) return 1;
+    fwrite(bin, 1, sz, f);
+    fclose(f);
+    printf("%s: %u bytes\n", out, sz);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    static U32 defaults[] = { 250, 1000, 4000 };
+
+    if (argc == 4 && STRCMP((PU8)argv[1], (PU8)"--file") == 0)
+        return RUN_FILE(argv[2], argv[3]);
+
+    printf("=== ASTRAC assembler benchmark ===\n");
+    BOOL ok = TRUE;
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) ok &= RUN((U32)atoi(argv[i]));
+    } else {
+        for (U32 i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) ok &= RUN(defaults[i]);
+    }
+    return ok ? 0 : 1;
+}
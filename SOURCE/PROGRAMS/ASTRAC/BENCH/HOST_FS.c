@@ -0,0 +1,158 @@
+/*
+ * HOST_FS.c — In-memory stand-in for STD/FS_DISK.c used by the host
+ * benchmark build.
+ *
+ * Files live in a small table of heap buffers. FWRITE follows the atOS
+ * semantics (append mode pushes the whole file back to "disk" on every
+ * call) and the number of bytes pushed is counted, so the benchmark shows
+ * the I/O cost the assembler would have on the real FAT32 driver.
+ */
+
+#include <PROGRAMS/ASTRAC/ASTRAC.h>
+#include <PROGRAMS/ASTRAC/BENCH/HOST_FS.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+
+#define HOST_FS_MAX_FILES 64
+
+typedef struct {
+    PU8 path;
+    PU8 data;
+    U32 sz;
+    U32 writes;         /* FWRITE calls since the file was created */
+    double written;     /* bytes pushed to storage by those calls */
+} HOST_FS_FILE;
+
+static HOST_FS_FILE files[HOST_FS_MAX_FILES];
+static double bytes_written;   /* can exceed 4 GB when output is quadratic */
+static U32 write_calls;
+
+static HOST_FS_FILE *FIND(PU8 path) {
+    for (U32 i = 0; i < HOST_FS_MAX_FILES; i++)
+        if (files[i].path && STRCMP(files[i].path, path) == 0) return &files[i];
+    return NULLPTR;
+}
+
+/* Replaces the stored contents of path (creating it if needed). */
+static BOOL STORE(PU8 path, PU8 data, U32 sz) {
+    HOST_FS_FILE *f = FIND(path);
+    if (!f) {
+        if (!FILE_CREATE(path)) return FALSE;
+        f = FIND(path);
+    }
+    PU8 copy = MAlloc(sz ? sz : 1);
+    if (!copy) return FALSE;
+    if (sz) MEMCPY(copy, data, sz);
+    if (f->data) MFree(f->data);
+    f->data = copy;
+    f->sz = sz;
+    return TRUE;
+}
+
+BOOL HOST_FS_PUT(PU8 path, PU8 data, U32 sz) { return STORE(path, data, sz); }
+
+PU8 HOST_FS_GET(PU8 path, U32 *sz) {
+    HOST_FS_FILE *f = FIND(path);
+    if (!f) return NULLPTR;
+    *sz = f->sz;
+    return f->data;
+}
+
+VOID HOST_FS_RESET_STATS(VOID) { bytes_written = 0; write_calls = 0; }
+double HOST_FS_BYTES_WRITTEN(VOID) { return bytes_written; }
+U32  HOST_FS_WRITE_CALLS(VOID) { return write_calls; }
+
+BOOL HOST_FS_FILE_STATS(PU8 path, U32 *writes, double *written) {
+    HOST_FS_FILE *f = FIND(path);
+    if (!f) return FALSE;
+    *writes = f->writes;
+    *written = f->written;
+    return TRUE;
+}
+
+/* ── FS_DISK API ─────────────────────────────────────────────────────────── */
+
+BOOLEAN FILE_EXISTS(PU8 path) { return FIND(path) != NULLPTR; }
+
+BOOLEAN FILE_CREATE(PU8 path) {
+    if (FIND(path)) return FALSE;
+    for (U32 i = 0; i < HOST_FS_MAX_FILES; i++) {
+        if (files[i].path) continue;
+        files[i].path = STRDUP(path);
+        files[i].data = NULLPTR;
+        files[i].sz = 0;
+        files[i].writes = 0;
+        files[i].written = 0;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+BOOLEAN FILE_DELETE(PU8 path) {
+    HOST_FS_FILE *f = FIND(path);
+    if (!f) return FALSE;
+    MFree(f->path);
+    if (f->data) MFree(f->data);
+    MEMZERO(f, sizeof(*f));
+    return TRUE;
+}
+
+FILE *FOPEN(PU8 path, FILEMODES mode) {
+    HOST_FS_FILE *src = FIND(path);
+    if (!src) return NULLPTR;
+    FILE *file = CAlloc(1, sizeof(FILE));
+    if (!file) return NULLPTR;
+    file->data = MAlloc(src->sz ? src->sz : 1);
+    if (src->sz) MEMCPY(file->data, src->data, src->sz);
+    file->sz = src->sz;
+    file->mode = mode;
+    STRNCPY(file->path, path, sizeof(file->path) - 1);
+    return file;
+}
+
+VOID FCLOSE(FILE *file) {
+    if (!file) return;
+    if (file->data) MFree(file->data);
+    MFree(file);
+}
+
+U32 FWRITE(FILE *file, VOIDPTR buffer, U32 len) {
+    if (!file || !buffer || len == 0) return 0;
+    if (file->mode & MODE_A) {
+        PU8 tmp = ReAlloc(file->data, file->sz + len);
+        if (!tmp) return 0;
+        MEMCPY(tmp + file->sz, buffer, len);
+        file->data = tmp;
+        file->sz += len;
+    } else if (file->mode & MODE_W) {
+        PU8 tmp = ReAlloc(file->data, len);
+        if (!tmp) return 0;
+        MEMCPY(tmp, buffer, len);
+        file->data = tmp;
+        file->sz = len;
+    } else {
+        return 0;
+    }
+    /* Like FAT32_FILE_WRITE, every call rewrites the complete file */
+    write_calls++;
+    bytes_written += file->sz;
+    if (!STORE(file->path, file->data, file->sz)) return 0;
+    HOST_FS_FILE *f = FIND(file->path);
+    f->writes++;
+    f->written += file->sz;
+    return len;
+}
+
+BOOLEAN FILE_GET_LINE(FILE *file, PU8 line, U32 max_len) {
+    if (!file || !line || !file->data || max_len == 0) return FALSE;
+
+    U32 i = 0;
+    while (file->read_ptr < file->sz && i < max_len - 1) {
+        U8 ch = ((U8*)file->data)[file->read_ptr++];
+        line[i++] = ch;
+        if (ch == '\n' || ch == '\r') break;
+    }
+
+    line[i] = '\0';
+    return i != 0;
+}
@@ -0,0 +1,23 @@
+#ifndef ASTRAC_HOST_FS_H
+#define ASTRAC_HOST_FS_H
+#include <STD/TYPEDEF.h>
+
+/*
+ * In-memory file system for the host benchmark build (see HOST_FS.c).
+ */
+
+/// @brief Creates or replaces a file with a copy of data.
+BOOL HOST_FS_PUT(PU8 path, PU8 data, U32 sz);
+
+/// @brief Returns the stored contents of path (owned by HOST_FS), or NULLPTR.
+PU8 HOST_FS_GET(PU8 path, U32 *sz);
+
+/// @brief Write accounting: bytes pushed to storage and FWRITE calls since reset.
+VOID HOST_FS_RESET_STATS(VOID);
+double HOST_FS_BYTES_WRITTEN(VOID);
+U32  HOST_FS_WRITE_CALLS(VOID);
+
+/// @brief Same accounting for a single file, counted since it was created.
+BOOL HOST_FS_FILE_STATS(PU8 path, U32 *writes, double *written);
+
+#endif // ASTRAC_HOST_FS_H
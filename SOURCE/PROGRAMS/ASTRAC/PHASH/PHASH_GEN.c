@@ -0,0 +1,229 @@
+/*
+ * PHASH_GEN.c — Host generator for the assembler's keyword perfect hash.
+ *
+ * Reads the mnemonic table (MNEMONICS.h) and the register table
+ * (REGISTERS.h), and writes ASM_PHASH_TABLES.h for ASSEMBLER/PHASH.c:
+ *
+ *   PHASH_GEN <out.h>
+ *
+ * Keys are hashed with ASM_PHASH_STR (PHASH.h) using the "hash and
+ * displace" scheme: keys are first spread over buckets with a fixed seed,
+ * then, biggest bucket first, each bucket gets the smallest displacement
+ * seed that sends all of its keys to free slots. The result is collision
+ * free, so a lookup is two hashes and one compare.
+ *
+ * Run by the ASTRAC CMake build and by TESTS/Makefile; the output is never
+ * checked in. The atOS headers redefine size_t, so libc is declared by hand.
+ */
+
+#include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/MNEMONICS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/REGISTERS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/PHASH.h>
+
+typedef struct HOST_FILE HOST_FILE;
+extern HOST_FILE *fopen(const char *path, const char *mode);
+extern int fclose(HOST_FILE *f);
+extern int fprintf(HOST_FILE *f, const char *fmt, ...);
+extern void *calloc(unsigned long n, unsigned long sz);
+extern void free(void *p);
+
+#define MAX_KEYS    1024
+#define MAX_DISP    (1u << 20)
+#define MAX_SEEDS   64
+
+typedef struct {
+    U8  name[32];           /* lower-cased */
+    U16 first;              /* mnemonics: start in index list; registers: table index */
+    U16 count;
+} KEY;
+
+typedef struct {
+    KEY  keys[MAX_KEYS];
+    U32  n;
+    U16  index[MAX_KEYS];   /* mnemonics only: table indices grouped by key */
+    U32  index_len;
+
+    /* Result */
+    U32  seed;
+    U32  buckets;
+    U32  slots;
+    U32 *disp;
+    I32 *slot_key;          /* slot -> key, -1 when empty */
+} PH_SET;
+
+static PH_SET mnem;
+static PH_SET regs;
+
+static VOID LOWER_COPY(U8 *dst, const U8 *src) {
+    U32 i = 0;
+    for (; src[i] && i < 31; i++)
+        dst[i] = (src[i] >= 'A' && src[i] <= 'Z') ? src[i] + 32 : src[i];
+    dst[i] = 0;
+}
+
+static BOOL SAME(const U8 *a, const U8 *b) {
+    while (*a && *a == *b) { a++; b++; }
+    return *a == *b;
+}
+
+static I32 FIND_KEY(PH_SET *s, const U8 *lower) {
+    for (U32 i = 0; i < s->n; i++)
+        if (SAME(s->keys[i].name, lower)) return (I32)i;
+    return -1;
+}
+
+/* One key per distinct name; its entries are listed in ascending table order,
+   which is the order the linear scan in AST.c visited them. */
+static VOID COLLECT_MNEMONICS(VOID) {
+    U32 total = sizeof(asm_mnemonics) / sizeof(asm_mnemonics[0]);
+    for (U32 i = 0; i < total; i++) {
+        U8 lower[32];
+        if (!asm_mnemonics[i].name) continue;
+        LOWER_COPY(lower, (const U8 *)asm_mnemonics[i].name);
+        if (FIND_KEY(&mnem, lower) >= 0) continue;
+
+        KEY *k = &mnem.keys[mnem.n++];
+        LOWER_COPY(k->name, lower);
+        k->first = (U16)mnem.index_len;
+        for (U32 j = i; j < total; j++) {
+            U8 other[32];
+            if (!asm_mnemonics[j].name) continue;
+            LOWER_COPY(other, (const U8 *)asm_mnemonics[j].name);
+            if (SAME(other, lower)) mnem.index[mnem.index_len++] = (U16)j;
+        }
+        k->count = (U16)(mnem.index_len - k->first);
+    }
+}
+
+/* The lexer's lookup_keyword() returned the first match, so later
+   duplicates (if any) are dropped here the same way. */
+static VOID COLLECT_REGISTERS(VOID) {
+    for (U32 i = 0; asm_registers[i].value; i++) {
+        U8 lower[32];
+        LOWER_COPY(lower, (const U8 *)asm_registers[i].value);
+        if (FIND_KEY(&regs, lower) >= 0) continue;
+        KEY *k = &regs.keys[regs.n++];
+        LOWER_COPY(k->name, lower);
+        k->first = (U16)i;
+        k->count = 1;
+    }
+}
+
+static BOOL TRY_SEED(PH_SET *s, U32 seed) {
+    U32 nb = s->buckets, ns = s->slots;
+    U32 *bucket_of = calloc(s->n, sizeof(U32));
+    U32 *bucket_sz = calloc(nb, sizeof(U32));
+    U32 *order     = calloc(nb, sizeof(U32));
+    U32 *slot_tmp  = calloc(s->n, sizeof(U32));
+    BOOL ok = TRUE;
+
+    for (U32 i = 0; i < ns; i++) s->slot_key[i] = -1;
+    for (U32 i = 0; i < s->n; i++) {
+        bucket_of[i] = ASM_PHASH_STR(s->keys[i].name, seed) % nb;
+        bucket_sz[bucket_of[i]]++;
+    }
+
+    /* Biggest buckets first: they are the hardest to place */
+    for (U32 i = 0; i < nb; i++) order[i] = i;
+    for (U32 i = 1; i < nb; i++) {
+        U32 b = order[i], j = i;
+        while (j > 0 && bucket_sz[order[j - 1]] < bucket_sz[b]) { order[j] = order[j - 1]; j--; }
+        order[j] = b;
+    }
+
+    for (U32 oi = 0; oi < nb && ok; oi++) {
+        U32 b = order[oi];
+        s->disp[b] = 0;
+        if (bucket_sz[b] == 0) continue;
+
+        BOOL placed = FALSE;
+        for (U32 d = 1; d < MAX_DISP && !placed; d++) {
+            U32 cnt = 0;
+            placed = TRUE;
+            for (U32 k = 0; k < s->n; k++) {
+                if (bucket_of[k] != b) continue;
+                U32 slot = ASM_PHASH_STR(s->keys[k].name, d) % ns;
+                BOOL clash = s->slot_key[slot] >= 0;
+                for (U32 c = 0; c < cnt && !clash; c++) clash = slot_tmp[c] == slot;
+                if (clash) { placed = FALSE; break; }
+                slot_tmp[cnt++] = slot;
+            }
+            if (!placed) continue;
+
+            cnt = 0;
+            for (U32 k = 0; k < s->n; k++)
+                if (bucket_of[k] == b) s->slot_key[slot_tmp[cnt++]] = (I32)k;
+            s->disp[b] = d;
+        }
+        ok = placed;
+    }
+
+    free(bucket_of);
+    free(bucket_sz);
+    free(order);
+    free(slot_tmp);
+    if (ok) s->seed = seed;
+    return ok;
+}
+
+static BOOL BUILD_SET(PH_SET *s) {
+    s->buckets = s->n / 4 + 1;
+    s->slots   = s->n + s->n / 8 + 1;
+    s->disp     = calloc(s->buckets, sizeof(U32));
+    s->slot_key = calloc(s->slots, sizeof(I32));
+    for (U32 seed = 1; seed <= MAX_SEEDS; seed++)
+        if (TRY_SEED(s, seed)) return TRUE;
+    return FALSE;
+}
+
+static VOID EMIT_SET(HOST_FILE *f, PH_SET *s, const char *pfx, const char *what) {
+    fprintf(f, "/* %u %s keys in %u slots */\n", s->n, what, s->slots);
+    fprintf(f, "#define ASM_PH_%s_SEED    %uu\n", pfx, s->seed);
+    fprintf(f, "#define ASM_PH_%s_BUCKETS %uu\n", pfx, s->buckets);
+    fprintf(f, "#define ASM_PH_%s_SLOTS   %uu\n\n", pfx, s->slots);
+
+    fprintf(f, "static const U32 asm_ph_%s_disp[ASM_PH_%s_BUCKETS] = {", what, pfx);
+    for (U32 i = 0; i < s->buckets; i++)
+        fprintf(f, "%s%u,", (i % 16) ? " " : "\n    ", s->disp[i]);
+    fprintf(f, "\n};\n\n");
+
+    fprintf(f, "static const ASM_PHASH_SLOT asm_ph_%s_slots[ASM_PH_%s_SLOTS] = {\n", what, pfx);
+    for (U32 i = 0; i < s->slots; i++) {
+        if (s->slot_key[i] < 0) { fprintf(f, "    { NULLPTR, 0, 0 },\n"); continue; }
+        KEY *k = &s->keys[s->slot_key[i]];
+        fprintf(f, "    { (const U8 *)\"%s\", %u, %u },\n", k->name, k->first, k->count);
+    }
+    fprintf(f, "};\n\n");
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("usage: PHASH_GEN <out.h>\n");
+        return 2;
+    }
+
+    COLLECT_MNEMONICS();
+    COLLECT_REGISTERS();
+    if (!BUILD_SET(&mnem) || !BUILD_SET(&regs)) {
+        printf("PHASH_GEN: no collision-free layout found\n");
+        return 1;
+    }
+
+    HOST_FILE *f = fopen(argv[1], "w");
+    if (!f) return 1;
+
+    fprintf(f, "/* ASM_PHASH_TABLES.h — generated by PHASH_GEN.c from MNEMONICS.h and\n"
+               "   REGISTERS.h. Do not edit; it is rebuilt with the assembler. */\n");
+    fprintf(f, "#ifndef ASM_PHASH_TABLES_H\n#define ASM_PHASH_TABLES_H\n\n");
+
+    EMIT_SET(f, &mnem, "MNEM", "mnem");
+    fprintf(f, "static const U16 asm_ph_mnem_index[%u] = {", mnem.index_len);
+    for (U32 i = 0; i < mnem.index_len; i++)
+        fprintf(f, "%s%u,", (i % 16) ? " " : "\n    ", mnem.index[i]);
+    fprintf(f, "\n};\n\n");
+
+    EMIT_SET(f, &regs, "REG", "reg");
+    fprintf(f, "#endif // ASM_PHASH_TABLES_H\n");
+    return fclose(f) == 0 ? 0 : 1;
+}
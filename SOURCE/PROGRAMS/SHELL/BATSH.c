@@ -9,6 +9,7 @@
 #include <STD/AUDIO.h>
 #include <STD/MEM.h>
 #include <STD/PROC_COM.h>
+#include <STD/PIPE.h>
 #include <STD/DEBUG.h>
 
 #define LEND "\r\n"
@@ -1179,6 +1180,13 @@ VOID HANDLE_COMMAND(U8 *line) {
     U32 i = 0;
     U32 j = 0;
 
+    // Programs connected with '|' bypass the built-in commands
+    if (IS_PIPELINE(line)) {
+        RUN_PIPELINE(line);
+        cursor->CURSOR_VISIBLE = TRUE;
+        return;
+    }
+
     while (line[i] && line[i] != ' ' && j < sizeof(command) - 1)
         command[j++] = line[i++];
     command[j] = '\0';
@@ -1327,6 +1335,10 @@ VOID SETUP_BATSH_PROCESSER() {
 
 
 BOOLEAN RUN_PROCESS(PU8 line) {
+    return RUN_PROCESS_PIPED(line, 0, 0);
+}
+
+BOOLEAN RUN_PROCESS_PIPED(PU8 line, U32 stdin_pipe, U32 stdout_pipe) {
     if (!line || !*line) return FALSE;
 
     // ---------------------------------------------------------------------
@@ -1538,11 +1550,12 @@ BOOLEAN RUN_PROCESS(PU8 line) {
         U32 res = 0;
         DEBUG_PRINTF("Starting process: %s with args:", abs_path_buf);
         if(STRICMP(abs_path_buf, "/ATOS/TSHELL.BIN") == 0) {
-            res = START_PROCESS(abs_path_buf, data, file_size, 
-                                TCB_STATE_ACTIVE | TCB_STATE_INFO_CHILD_PROC_HANDLER, 0, argv, argc);
+            res = START_PROCESS_PIPED(abs_path_buf, data, file_size, 
+                                TCB_STATE_ACTIVE | TCB_STATE_INFO_CHILD_PROC_HANDLER, 0, argv, argc,
+                                stdin_pipe, stdout_pipe);
         } else {
-            res = START_PROCESS(abs_path_buf, data, file_size,
-                                TCB_STATE_ACTIVE, pid, argv, argc);
+            res = START_PROCESS_PIPED(abs_path_buf, data, file_size,
+                                TCB_STATE_ACTIVE, pid, argv, argc, stdin_pipe, stdout_pipe);
         }
         if (res) PRINTNEWLINE();
         result = (res != 0);
@@ -1552,7 +1565,11 @@ BOOLEAN RUN_PROCESS(PU8 line) {
     // Execute script
     // ---------------------------------------------------------------------
     else if (STRICMP(ext, "SH") == 0) {
-        result = RUN_BATSH_SCRIPT(abs_path_buf, argc, argv);
+        if (stdin_pipe || stdout_pipe) {
+            PUTS("\nError: Scripts can't be part of a pipeline.\n");
+        } else {
+            result = RUN_BATSH_SCRIPT(abs_path_buf, argc, argv);
+        }
         for (U32 i = 0; i < argc; i++) {
             if (argv[i]) MFree(argv[i]);
             SET_NULL(argv[i]);
@@ -1571,3 +1588,63 @@ BOOLEAN RUN_PROCESS(PU8 line) {
     SET_NULL(prog_name);
     return result;
 }
+
+// First '|' outside double quotes
+static PU8 find_pipe_bar(PU8 line) {
+    BOOL quoted = FALSE;
+    for (; *line; line++) {
+        if (*line == '"') quoted = !quoted;
+        else if (*line == '|' && !quoted) return line;
+    }
+    return NULLPTR;
+}
+
+BOOLEAN IS_PIPELINE(PU8 line) {
+    return line && find_pipe_bar(line) != NULLPTR;
+}
+
+BOOLEAN RUN_PIPELINE(PU8 line) {
+    if (!line) return FALSE;
+    U8 copy[512];
+    STRNCPY(copy, line, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+
+    PU8 stages[MAX_PIPELINE_STAGES];
+    U32 count = 0;
+    PU8 p = copy;
+    stages[count++] = p;
+    PU8 bar;
+    while ((bar = find_pipe_bar(p)) != NULLPTR) {
+        if (count == MAX_PIPELINE_STAGES) {
+            PUTS("\nError: Too many programs in the pipeline.\n");
+            return FALSE;
+        }
+        *bar = 0;
+        p = bar + 1;
+        stages[count++] = p;
+    }
+
+    // Each pipe's write end goes to stage i, its read end stays with us
+    // until stage i + 1 takes it. Ends of a stage that didn't start are
+    // closed so its neighbours see end of stream or a broken pipe
+    BOOLEAN ok = TRUE;
+    U32 in = 0;
+    for (U32 i = 0; i < count; i++) {
+        U32 out = 0;
+        if (i + 1 < count && !(out = PIPE_CREATE())) {
+            PUTS("\nError: Failed to create a pipe.\n");
+            if (in) PIPE_CLOSE(in, PIPE_END_READ);
+            return FALSE;
+        }
+        if (!RUN_PROCESS_PIPED(stages[i], in, out)) {
+            PUTS("\nError: Failed to start: ");
+            PUTS(stages[i]);
+            PRINTNEWLINE();
+            if (in) PIPE_CLOSE(in, PIPE_END_READ);
+            if (out) PIPE_CLOSE(out, PIPE_END_WRITE);
+            ok = FALSE;
+        }
+        in = out;
+    }
+    return ok;
+}
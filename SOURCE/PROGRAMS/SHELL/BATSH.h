@@ -54,6 +54,14 @@ VOID SETUP_BATSH_PROCESSER();
 VOID BATSH_SET_MODE(U8 mode);
 U8 BATSH_GET_MODE(void);
 BOOLEAN RUN_PROCESS(PU8 line);
+// As RUN_PROCESS, with the read end of stdin_pipe and the write end of
+// stdout_pipe handed to the program (0 for none)
+BOOLEAN RUN_PROCESS_PIPED(PU8 line, U32 stdin_pipe, U32 stdout_pipe);
+
+// `A | B | C`: each program's output is the next one's input
+#define MAX_PIPELINE_STAGES 8
+BOOLEAN IS_PIPELINE(PU8 line);
+BOOLEAN RUN_PIPELINE(PU8 line);
 
 VOID SET_VAR(PU8 name, PU8 value);
 PU8 GET_VAR(PU8 name);
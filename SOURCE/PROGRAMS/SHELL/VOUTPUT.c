@@ -1,6 +1,9 @@
 #ifndef __SHELL__
 #define __SHELL__
 #endif 
+#define __RTOS__
+#include <DRIVERS/VESA/VBE.h>
+#undef __RTOS__
 #include <PROGRAMS/SHELL/VOUTPUT.h>
 #include <PROGRAMS/SHELL/FONT8x16.h>
 #include <PROGRAMS/SHELL/SHELL.h>
@@ -10,6 +13,7 @@
 #include <CPU/PIT/PIT.h>
 #include <STD/GRAPHICS.h>
 #include <STD/MEM.h>
+#include <DRIVERS/VESA/VBE_TEXT.h>
 #define RESTORE_CURSOR_BEFORE_MOVE() \
     RESTORE_CURSOR_UNDERNEATH(cursor.Column, cursor.Row)
 
@@ -37,75 +41,38 @@ static inline BOOLEAN is_printable(U8 c) {
     return (c >= 0x20 && c != 0x7F);
 }
 
-// Draw a background rectangle for len characters at (col,row)
-static inline VOID DRAW_CELL_BG_RUN(U32 col, U32 row, U32 len, VBE_PIXEL_COLOUR bg) {
-    if (len == 0) return;
-    U32 x = COL_TO_PIX(col);
-    U32 y = ROW_TO_PIX(row);
-    U32 cell_adv = CHAR_WIDTH + CHAR_SPACING;
-    U32 w = len * cell_adv;
-    DRAW_FILLED_RECTANGLE(x, y, x + w, y + CHAR_HEIGHT, bg);
-}
-
-
 #define GLYPH_COUNT (sizeof(toshiba_t5200c_bios_vers_3__2__8x16) / CHAR_HEIGHT)
 
-// Efficiently draw a string of length len at cell (col,row)
-// Background is cleared with a single filled-rectangle per run, then
-// foreground spans are emitted as horizontal lines per bit-run.
+static CONST VBE_FONT shell_font = { toshiba_t5200c_bios_vers_3__2__8x16, CHAR_HEIGHT, 0, GLYPH_COUNT };
+static VBE_GLYPH_CACHE shell_spans ATTRIB_DATA = { 0 };
+static VBE_TEXT_TARGET screen ATTRIB_DATA = { 0 };
+
+// Text is written straight into the shell's own framebuffer, as ATGL does.
+// The framebuffer is mapped for the life of the process; drawing only
+// becomes visible once the kernel has granted it.
+static BOOLEAN TEXT_TARGET_READY(VOID) {
+    if (screen.fb) return TRUE;
+    VBE_MODEINFO *mode = GET_VBE_MODE();
+    TCB *tcb = GET_CURRENT_TCB();
+    if (!mode || !tcb || !tcb->framebuffer_virt) return FALSE;
+    screen.pitch = mode->BytesPerScanLineLinear ? mode->BytesPerScanLineLinear : mode->BytesPerScanLine;
+    screen.bpp = (mode->BitsPerPixel + 7) / 8;
+    screen.cx0 = 0;
+    screen.cy0 = 0;
+    screen.cx1 = (I32)mode->XResolution;
+    screen.cy1 = (I32)mode->YResolution;
+    screen.fb = (U8 *)tcb->framebuffer_virt;
+    return TRUE;
+}
+
+// Draw a string of length len at cell (col,row). The run paints whole
+// cells, spacing included, so no separate background clear is needed.
 static VOID DRAW_STRING_AT(U32 col, U32 row, const U8 *s, U32 len,
                            VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg)
 {
-    if (!s || len == 0) return;
-
-    // Clear background for the entire span with a single call (per row strip)
-    DRAW_CELL_BG_RUN(col, row, len, bg);
-
-    // For each glyph scanline, draw contiguous foreground runs merged across characters
-    U32 base_x = COL_TO_PIX(col);
-    U32 base_y = ROW_TO_PIX(row);
-    const U32 cell_adv = CHAR_WIDTH + CHAR_SPACING;
-
-    for (U32 i = 0; i < CHAR_HEIGHT; i++) {
-        BOOLEAN in_run = FALSE;
-        U32 run_start_x = 0;
-
-        for (U32 ci = 0; ci < len; ci++) {
-            U8 ch = s[ci];
-
-            // ✅ Clamp character index to valid glyph range
-            if (ch >= GLYPH_COUNT)
-                ch = '?'; // fallback glyph
-
-            // ✅ Also check that the index is safe before dereferencing
-            U32 glyph_index = ch * CHAR_HEIGHT;
-            if (glyph_index + i >= sizeof(toshiba_t5200c_bios_vers_3__2__8x16))
-                continue; // skip invalid glyph line
-
-            const U8 *glyph = &toshiba_t5200c_bios_vers_3__2__8x16[glyph_index];
-            U8 bits = glyph[i];
-
-            for (U32 bj = 0; bj < CHAR_WIDTH; bj++) {
-                U8 bit = (bits >> (CHAR_WIDTH - 1 - bj)) & 1;
-                U32 px = base_x + ci * cell_adv + bj;
-
-                if (bit) {
-                    if (!in_run) {
-                        in_run = TRUE;
-                        run_start_x = px;
-                    }
-                } else if (in_run) {
-                    DRAW_LINE(run_start_x, base_y + i, px - 1, base_y + i, fg);
-                    in_run = FALSE;
-                }
-            }
-        }
-
-        if (in_run) {
-            U32 end_x = base_x + len * cell_adv - CHAR_SPACING - 1;
-            DRAW_LINE(run_start_x, base_y + i, end_x, base_y + i, fg);
-        }
-    }
+    if (!s || len == 0 || !TEXT_TARGET_READY()) return;
+    VBE_TEXT_RUN(&screen, &shell_font, &shell_spans, (I32)COL_TO_PIX(col), (I32)ROW_TO_PIX(row),
+                 s, len, CHAR_WIDTH + CHAR_SPACING, fg, bg);
 }
 
 // Write a span into the text buffer and draw it in batched mode.
@@ -429,6 +429,9 @@ VOID MOVEMENT_CALLBACK(PATGL_NODE node) {
     for(int r=0;r<ROWS&&cr==-1;r++) for(int c=0;c<COLS&&cr==-1;c++) if(board_nodes[r][c]==node){cr=r;cc=c;}
     if(cr==-1) return;
 
+    /* Squares' text is edited in place below, repaint the whole board */
+    ATGL_NODE_INVALIDATE(board_root);
+
     U8 cp=chessboard[cr][cc];
 
     if(selected_row>=0){
@@ -17,8 +17,10 @@ static VOID draw_hand(I32 cx, I32 cy, F32 angle, I32 length, U32 color, U32 thic
 }
 
 static U32 prev_sec ATTRIB_DATA = 99; // Force initial draw
+static DRAW_BATCH frame ATTRIB_DATA = {0}; // A whole face in one syscall
 
 VOID DRAW_CLOCK(RTC_DATE_TIME *ts) {
+    DRAW_BATCH_BEGIN(&frame);
     CLEAR_SCREEN_COLOUR(VBE_NOTEPAD_PAPER2);
 
     I32 cx = SCREEN_CENTER_X;
@@ -97,6 +99,7 @@ VOID DRAW_CLOCK(RTC_DATE_TIME *ts) {
     U8 buf[21];
     FORMATTED_DATE_TIME_STRING(buf, ts);
     DRAW_8x8_STRING(10, row, buf, VBE_BLACK, VBE_SEE_THROUGH);
+    DRAW_BATCH_END();
 }
 
 VOID UPDATE_CLOCK() {
@@ -124,6 +127,7 @@ U32 main(U32 argc, PPU8 argv) {
 
     // Initialize previous second to something impossible so it draws immediately
     prev_sec = 99; 
+    DRAW_BATCH_INIT(&frame, 0); // Draws unbatched if this fails
     
     BOOL8 running = TRUE;
     while (running) {
@@ -141,5 +145,6 @@ U32 main(U32 argc, PPU8 argv) {
         YIELD();
     }
 
+    DRAW_BATCH_FREE(&frame);
     return 0;
 }
\ No newline at end of file
@@ -1,16 +1,22 @@
 #include <LIBRARIES/ATHASH/BASE64.h>
 #include <LIBRARIES/ATHASH/SHA1.h>
+#include <LIBRARIES/ATHASH/SHA256.h>
 #include <STD/STRING.h>
 #include <STD/IO.h>
 #include <STD/DEBUG.h>
 #include <STD/MEM.h>
 #include <STD/FS_DISK.h>
+#include <STD/PIPE.h>
 
 /* ============================================================
-   HASH - SHA-1 / Base64 encode-decode utility
+   HASH - SHA-1 / SHA-256 / Base64 encode-decode utility
+
+   Without --string or --file the input is read from a pipe,
+   e.g. `HASH base64 encode --string hi | HASH sha256`.
 
    Usage:
      HASH sha1   [--string <text>|--file <path>] [--out <path>]
+     HASH sha256 [--string <text>|--file <path>] [--out <path>]
      HASH base64 encode [--string <text>|--file <path>] [--out <path>]
      HASH base64 decode [--string <text>|--file <path>] [--out <path>]
      HASH --help
@@ -19,14 +25,16 @@
 /* ---------- helpers ---------------------------------------- */
 
 static VOID print_help(VOID) {
-    printf("HASH - SHA-1 / Base64 utility\n");
+    printf("HASH - SHA-1 / SHA-256 / Base64 utility\n");
     printf("\nUsage:\n");
     printf("  HASH sha1   [--string <text>|--file <path>] [--out <path>]\n");
+    printf("  HASH sha256 [--string <text>|--file <path>] [--out <path>]\n");
     printf("  HASH base64 encode [--string <text>|--file <path>] [--out <path>]\n");
     printf("  HASH base64 decode [--string <text>|--file <path>] [--out <path>]\n");
     printf("\nNotes:\n");
-    printf("  SHA-1 is a one-way hash - only encoding is supported.\n");
+    printf("  SHA-1 and SHA-256 are one-way hashes - only encoding is supported.\n");
     printf("  Output defaults to stdout when --out is not specified.\n");
+    printf("  Input defaults to stdin when HASH runs in a pipeline: A | HASH sha256\n");
 }
 
 /* Read a file into a heap-allocated buffer. Sets *out_len. Returns NULL on error. */
@@ -50,6 +58,84 @@ static PU8 read_file_buf(PU8 path, U32 *out_len) {
     return buf;
 }
 
+/* Hash a file in CHUNK_SIZE pieces so no second full-size copy is needed.
+   Writes SHA1_DIGEST_SIZE or SHA256_DIGEST_SIZE bytes to digest. */
+#define CHUNK_SIZE 4096
+
+static BOOL hash_file(PU8 path, BOOL sha256, PU8 digest) {
+    FILE *f = FOPEN(path, MODE_FR);
+    if (!f) {
+        printf("[HASH] Error: cannot open file '%s'\n", path);
+        return FALSE;
+    }
+    PU8 chunk = (PU8)MAlloc(CHUNK_SIZE);
+    if (!chunk) {
+        FCLOSE(f);
+        printf("[HASH] Error: out of memory\n");
+        return FALSE;
+    }
+    SHA1_CTX   sha1;
+    SHA256_CTX sha2;
+    if (sha256) SHA256_INIT(&sha2);
+    else        SHA1_INIT(&sha1);
+
+    U32 n;
+    while ((n = FREAD(f, chunk, CHUNK_SIZE)) > 0) {
+        if (sha256) SHA256_UPDATE(&sha2, chunk, n);
+        else        SHA1_UPDATE(&sha1, chunk, n);
+    }
+
+    if (sha256) SHA256_FINAL(digest, &sha2);
+    else        SHA1_FINAL(digest, &sha1);
+    MFree(chunk);
+    FCLOSE(f);
+    return TRUE;
+}
+
+/* Hash the stdin pipe as it arrives. */
+static BOOL hash_stdin(BOOL sha256, PU8 digest) {
+    PU8 chunk = (PU8)MAlloc(CHUNK_SIZE);
+    if (!chunk) {
+        printf("[HASH] Error: out of memory\n");
+        return FALSE;
+    }
+    SHA1_CTX   sha1;
+    SHA256_CTX sha2;
+    if (sha256) SHA256_INIT(&sha2);
+    else        SHA1_INIT(&sha1);
+
+    U32 n;
+    while ((n = STDIN_READ(chunk, CHUNK_SIZE)) > 0) {
+        if (sha256) SHA256_UPDATE(&sha2, chunk, n);
+        else        SHA1_UPDATE(&sha1, chunk, n);
+    }
+
+    if (sha256) SHA256_FINAL(digest, &sha2);
+    else        SHA1_FINAL(digest, &sha1);
+    MFree(chunk);
+    return TRUE;
+}
+
+/* Read the stdin pipe to its end into a heap-allocated buffer. Sets *out_len. */
+static PU8 read_stdin_buf(U32 *out_len) {
+    U32 cap = CHUNK_SIZE, len = 0, n;
+    PU8 buf = (PU8)MAlloc(cap + 1);
+    while (buf && (n = STDIN_READ(buf + len, cap - len)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            buf = (PU8)ReAlloc(buf, cap + 1);
+        }
+    }
+    if (!buf) {
+        printf("[HASH] Error: out of memory\n");
+        return NULLPTR;
+    }
+    buf[len] = '\0';
+    *out_len = len;
+    return buf;
+}
+
 /* Write data to a file, or print to stdout if path is NULL. */
 static VOID write_output(PU8 path, PU8 data, U32 len) {
     if (!path) {
@@ -69,15 +155,15 @@ static VOID write_output(PU8 path, PU8 data, U32 len) {
     printf("[HASH] Written %u bytes to %s\n", len, path);
 }
 
-/* Convert 20-byte SHA-1 digest to 40-char hex string (+ NUL). */
-static VOID digest_to_hex(CONST U8 digest[SHA1_DIGEST_SIZE], U8 out[41]) {
+/* Convert a len-byte digest to a 2*len-char hex string (+ NUL). */
+static VOID digest_to_hex(CONST U8 *digest, U32 len, PU8 out) {
     static CONST U8 hex[] = "0123456789abcdef";
     U32 i;
-    for (i = 0; i < SHA1_DIGEST_SIZE; i++) {
+    for (i = 0; i < len; i++) {
         out[i*2]     = hex[(digest[i] >> 4) & 0xF];
         out[i*2 + 1] = hex[digest[i] & 0xF];
     }
-    out[40] = '\0';
+    out[len * 2] = '\0';
 }
 
 /* ============================================================
@@ -91,15 +177,16 @@ U32 main(U32 argc, PPU8 argv) {
     }
 
     /* --- parse mode --- */
-    PU8 mode = argv[1];          /* "sha1" or "base64" */
+    PU8 mode = argv[1];          /* "sha1", "sha256" or "base64" */
     PU8 op   = NULLPTR;          /* "encode" / "decode" (base64 only) */
     U32 arg_start = 2;
 
     BOOL is_sha1   = (STRCMP(mode, "sha1")   == 0);
+    BOOL is_sha256 = (STRCMP(mode, "sha256") == 0);
     BOOL is_base64 = (STRCMP(mode, "base64") == 0);
 
-    if (!is_sha1 && !is_base64) {
-        printf("[HASH] Error: unknown mode '%s'. Use sha1 or base64.\n", mode);
+    if (!is_sha1 && !is_sha256 && !is_base64) {
+        printf("[HASH] Error: unknown mode '%s'. Use sha1, sha256 or base64.\n", mode);
         return 1;
     }
 
@@ -134,7 +221,8 @@ U32 main(U32 argc, PPU8 argv) {
         }
     }
 
-    if (!input_string && !input_file) {
+    BOOL from_stdin = !input_string && !input_file && PIPE_STDIN();
+    if (!input_string && !input_file && !from_stdin) {
         printf("[HASH] Error: provide --string <text> or --file <path>\n");
         return 1;
     }
@@ -143,6 +231,25 @@ U32 main(U32 argc, PPU8 argv) {
         return 1;
     }
 
+    /* --- digests: files are hashed in chunks --- */
+    if (is_sha1 || is_sha256) {
+        U32 dlen = is_sha256 ? SHA256_DIGEST_SIZE : SHA1_DIGEST_SIZE;
+        U8 digest[SHA256_DIGEST_SIZE];
+        U8 hex[SHA256_DIGEST_SIZE * 2 + 1];
+        if (input_file) {
+            if (!hash_file(input_file, is_sha256, digest)) return 1;
+        } else if (from_stdin) {
+            if (!hash_stdin(is_sha256, digest)) return 1;
+        } else if (is_sha256) {
+            SHA256_HASH(input_string, STRLEN(input_string), digest);
+        } else {
+            SHA1_HASH(input_string, STRLEN(input_string), digest);
+        }
+        digest_to_hex(digest, dlen, hex);
+        write_output(output_file, hex, dlen * 2);
+        return 0;
+    }
+
     /* --- load input --- */
     PU8 data     = NULLPTR;
     U32 data_len = 0;
@@ -151,21 +258,18 @@ U32 main(U32 argc, PPU8 argv) {
     if (input_string) {
         data     = (PU8)input_string;
         data_len = STRLEN(input_string);
+    } else if (from_stdin) {
+        data = read_stdin_buf(&data_len);
+        if (!data) return 1;
+        allocated = TRUE;
     } else {
         data = read_file_buf(input_file, &data_len);
         if (!data) return 1;
         allocated = TRUE;
     }
 
-    /* --- process --- */
-    if (is_sha1) {
-        U8 digest[SHA1_DIGEST_SIZE];
-        U8 hex[41];
-        SHA1_HASH(data, data_len, digest);
-        digest_to_hex(digest, hex);
-        write_output(output_file, hex, 40);
-
-    } else { /* base64 */
+    /* --- process: base64 --- */
+    {
         if (STRCMP(op, "encode") == 0) {
             /* output length: 4 * ceil(n/3) + 1 */
             U32 out_len = 4 * ((data_len + 2) / 3) + 1;
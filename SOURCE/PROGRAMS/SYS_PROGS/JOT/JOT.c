@@ -20,6 +20,11 @@
         ^L  Refresh screen
         ^T  Go to top
         ^B  Go to bottom
+        ^Z  Undo
+        ^Y  Redo
+
+    The document is a piece table (TEXTBUF.c): files of any size open
+    without splitting them into lines, and undo/redo replays the edit log.
 ---*/
 
 // #define ATRC_IMPLEMENTATION// defined in ATUI
@@ -33,16 +38,14 @@
 #include <LIBRARIES/ATUI/ATUI.h>
 #include <LIBRARIES/ATUI/ATUI_WIDGETS.h>
 #include <LIBRARIES/ATRC/ATRC.h>
+#include <PROGRAMS/SYS_PROGS/JOT/TEXTBUF.h>
 
 /* ====== Configuration ====== */
 
 #define JOT_VERSION       "1.0"
-#define MAX_LINES         4096
-#define MAX_LINE_LEN      512
 #define CUT_BUFFER_SIZE   64
 #define SEARCH_MAX        128
 #define TAB_SIZE_DEFAULT  4
-#define UNDO_MAX          128
 #define MAX_SYNTAX_RULES  32
 #define MAX_SYNTAX_KWS    64
 #define MAX_KW_LEN        32
@@ -53,30 +56,13 @@
 
 /* ====== Editor data structures ====== */
 
+/* One line copied out of the text buffer, NUL-terminated */
 typedef struct {
-    PU8  data;        /* heap-allocated line content                */
+    PU8  data;
     U32  len;         /* length of content (excluding NUL)          */
     U32  cap;         /* allocated capacity                         */
 } LINE_BUF;
 
-/* Undo record */
-typedef enum {
-    UNDO_INSERT_CHAR,
-    UNDO_DELETE_CHAR,
-    UNDO_INSERT_LINE,
-    UNDO_DELETE_LINE,
-    UNDO_JOIN_LINE,
-    UNDO_SPLIT_LINE,
-} UNDO_TYPE;
-
-typedef struct {
-    UNDO_TYPE type;
-    U32       row;
-    U32       col;
-    CHAR      ch;
-    PU8       line_data;  /* heap copy for line ops */
-} UNDO_RECORD;
-
 /* Syntax highlighting rule */
 typedef struct {
     CHAR      keywords[MAX_SYNTAX_KWS][MAX_KW_LEN];
@@ -94,6 +80,7 @@ typedef enum {
     JOT_ACT_REPLACE,
     JOT_ACT_HELP,
     JOT_ACT_UNDO,
+    JOT_ACT_REDO,
     JOT_ACT_TOP,
     JOT_ACT_BOTTOM,
     JOT_ACT_GOTO_LINE,
@@ -124,8 +111,8 @@ typedef struct {
 /* Main editor state */
 typedef struct {
     /* Text buffer */
-    LINE_BUF  lines[MAX_LINES];
-    U32       line_count;
+    TEXTBUF  *text;
+    LINE_BUF  line;         /* scratch copy of one line, see line_get */
 
     /* Cursor */
     U32       cur_row;
@@ -156,10 +143,6 @@ typedef struct {
     CHAR      replace_str[SEARCH_MAX];
     BOOL      search_case_sensitive;
 
-    /* Undo stack */
-    UNDO_RECORD undo[UNDO_MAX];
-    U32       undo_top;
-
     /* Config */
     PATRC_FD  config;
     U32       tab_size;
@@ -214,179 +197,109 @@ typedef struct {
 
 static JOT_STATE ed ATTRIB_DATA = {0};
 
-/* ====== Line buffer operations ====== */
+/* ====== Status message ====== */
 
-static VOID line_init(LINE_BUF *lb) {
-    lb->cap  = MAX_LINE_LEN;
-    lb->data = CAlloc(lb->cap, 1);
-    lb->len  = 0;
+static VOID set_status(PU8 msg) {
+    STRNCPY(ed.status_msg, msg, sizeof(ed.status_msg) - 1);
+    ed.status_msg[sizeof(ed.status_msg) - 1] = NULLT;
+    ed.status_tick = 100; /* display for ~100 refresh cycles */
 }
 
-static VOID line_free(LINE_BUF *lb) {
-    if (lb->data) MFree(lb->data);
-    lb->data = NULLPTR;
-    lb->len  = 0;
-    lb->cap  = 0;
+/* ====== Text buffer access ====== */
+
+static U32 line_count(VOID) {
+    return TEXTBUF_LINE_COUNT(ed.text);
 }
 
-static VOID line_ensure(LINE_BUF *lb, U32 needed) {
-    if (needed >= lb->cap) {
-        U32 newcap = needed + 128;
+static U32 line_len(U32 row) {
+    return TEXTBUF_LINE_LENGTH(ed.text, row);
+}
+
+static U32 text_offset(U32 row, U32 col) {
+    return TEXTBUF_LINE_START(ed.text, row) + col;
+}
+
+/* Copies line `row` into the scratch line. The copy is only valid until the
+   next call and does not follow edits. */
+static LINE_BUF *line_get(U32 row) {
+    static U8 empty[1];
+    LINE_BUF *lb = &ed.line;
+    U32 len = line_len(row);
+    if (len >= lb->cap) {
+        U32 newcap = len + 128;
         PU8 nd = ReAlloc(lb->data, newcap);
         if (nd) {
             lb->data = nd;
             lb->cap  = newcap;
+        } else if (lb->cap) {
+            len = lb->cap - 1;  /* show what fits */
+        } else {
+            lb->data = empty;
+            lb->len  = 0;
+            return lb;
         }
     }
+    lb->len = TEXTBUF_READ(ed.text, TEXTBUF_LINE_START(ed.text, row), lb->data, len);
+    lb->data[lb->len] = NULLT;
+    return lb;
 }
 
-static VOID line_set(LINE_BUF *lb, PU8 str, U32 len) {
-    line_ensure(lb, len + 1);
-    MEMCPY(lb->data, str, len);
-    lb->data[len] = NULLT;
-    lb->len = len;
-}
-
-static VOID line_insert_char(LINE_BUF *lb, U32 pos, CHAR ch) {
-    if (pos > lb->len) pos = lb->len;
-    line_ensure(lb, lb->len + 2);
-    MEMMOVE(lb->data + pos + 1, lb->data + pos, lb->len - pos + 1);
-    lb->data[pos] = ch;
-    lb->len++;
-}
-
-static VOID line_delete_char(LINE_BUF *lb, U32 pos) {
-    if (pos >= lb->len) return;
-    MEMMOVE(lb->data + pos, lb->data + pos + 1, lb->len - pos);
-    lb->len--;
+static BOOL text_insert(U32 offset, PU8 str, U32 len) {
+    if (!TEXTBUF_INSERT(ed.text, offset, str, len)) {
+        set_status("[ Out of memory ]");
+        return FALSE;
+    }
+    if (len) ed.modified = TRUE;
+    return TRUE;
 }
 
-static VOID line_append(LINE_BUF *lb, PU8 str, U32 len) {
-    line_ensure(lb, lb->len + len + 1);
-    MEMCPY(lb->data + lb->len, str, len);
-    lb->len += len;
-    lb->data[lb->len] = NULLT;
+static BOOL text_delete(U32 offset, U32 len) {
+    if (offset >= TEXTBUF_LENGTH(ed.text) || !len) return TRUE;
+    if (!TEXTBUF_DELETE(ed.text, offset, len)) {
+        set_status("[ Out of memory ]");
+        return FALSE;
+    }
+    ed.modified = TRUE;
+    return TRUE;
 }
 
 /* ====== Undo ====== */
 
-static VOID undo_push(UNDO_TYPE type, U32 row, U32 col, CHAR ch, PU8 line_data) {
-    if (ed.undo_top >= UNDO_MAX) {
-        /* Shift out oldest */
-        if (ed.undo[0].line_data) MFree(ed.undo[0].line_data);
-        MEMMOVE(&ed.undo[0], &ed.undo[1], (UNDO_MAX - 1) * sizeof(UNDO_RECORD));
-        ed.undo_top = UNDO_MAX - 1;
-    }
-    UNDO_RECORD *r = &ed.undo[ed.undo_top++];
-    r->type = type;
-    r->row  = row;
-    r->col  = col;
-    r->ch   = ch;
-    r->line_data = line_data ? STRDUP(line_data) : NULLPTR;
+static VOID cursor_to_offset(U32 offset) {
+    ed.cur_row = TEXTBUF_LINE_OF(ed.text, offset);
+    ed.cur_col = offset - TEXTBUF_LINE_START(ed.text, ed.cur_row);
 }
 
-static VOID undo_pop(VOID) {
-    if (ed.undo_top == 0) return;
-    ed.undo_top--;
-    UNDO_RECORD *r = &ed.undo[ed.undo_top];
-    LINE_BUF *lb;
-
-    switch (r->type) {
-    case UNDO_INSERT_CHAR:
-        /* Was an insert -> delete it */
-        lb = &ed.lines[r->row];
-        line_delete_char(lb, r->col);
-        ed.cur_row = r->row;
-        ed.cur_col = r->col;
-        break;
-    case UNDO_DELETE_CHAR:
-        /* Was a delete -> re-insert it */
-        lb = &ed.lines[r->row];
-        line_insert_char(lb, r->col, r->ch);
-        ed.cur_row = r->row;
-        ed.cur_col = r->col;
-        break;
-    case UNDO_SPLIT_LINE:
-        /* Was a split (Enter) -> join lines back */
-        if (r->row + 1 < ed.line_count) {
-            LINE_BUF *cur = &ed.lines[r->row];
-            LINE_BUF *nxt = &ed.lines[r->row + 1];
-            line_append(cur, nxt->data, nxt->len);
-            line_free(nxt);
-            MEMMOVE(&ed.lines[r->row + 1], &ed.lines[r->row + 2],
-                    (ed.line_count - r->row - 2) * sizeof(LINE_BUF));
-            ed.line_count--;
-            ed.cur_row = r->row;
-            ed.cur_col = r->col;
-        }
-        break;
-    case UNDO_JOIN_LINE:
-        /* Was a join (Backspace at col 0) -> split again */
-        if (r->line_data) {
-            if (ed.line_count < MAX_LINES) {
-                MEMMOVE(&ed.lines[r->row + 1], &ed.lines[r->row],
-                        (ed.line_count - r->row) * sizeof(LINE_BUF));
-                ed.line_count++;
-                line_init(&ed.lines[r->row]);
-                line_set(&ed.lines[r->row], r->line_data, STRLEN(r->line_data));
-                /* Trim joined portion from next line */
-                LINE_BUF *nxt = &ed.lines[r->row + 1];
-                U32 old_len = STRLEN(r->line_data);
-                if (nxt->len >= old_len) {
-                    MEMMOVE(nxt->data, nxt->data + old_len, nxt->len - old_len + 1);
-                    nxt->len -= old_len;
-                }
-                ed.cur_row = r->row;
-                ed.cur_col = old_len;
-            }
-        }
-        break;
-    case UNDO_DELETE_LINE:
-        /* Line was deleted (cut) -> re-insert */
-        if (r->line_data && ed.line_count < MAX_LINES) {
-            MEMMOVE(&ed.lines[r->row + 1], &ed.lines[r->row],
-                    (ed.line_count - r->row) * sizeof(LINE_BUF));
-            ed.line_count++;
-            line_init(&ed.lines[r->row]);
-            line_set(&ed.lines[r->row], r->line_data, STRLEN(r->line_data));
-            ed.cur_row = r->row;
-            ed.cur_col = 0;
-        }
-        break;
-    case UNDO_INSERT_LINE:
-        /* Line was inserted (uncut) -> remove it */
-        if (r->row < ed.line_count) {
-            line_free(&ed.lines[r->row]);
-            MEMMOVE(&ed.lines[r->row], &ed.lines[r->row + 1],
-                    (ed.line_count - r->row - 1) * sizeof(LINE_BUF));
-            ed.line_count--;
-            if (ed.cur_row >= ed.line_count && ed.line_count > 0)
-                ed.cur_row = ed.line_count - 1;
-            ed.cur_col = 0;
-        }
-        break;
+static VOID op_undo(VOID) {
+    U32 offset;
+    if (!TEXTBUF_UNDO(ed.text, &offset)) {
+        set_status("[ Nothing to undo ]");
+        return;
     }
-
-    if (r->line_data) { MFree(r->line_data); r->line_data = NULLPTR; }
+    cursor_to_offset(offset);
     ed.modified = TRUE;
+    set_status("[ Undo ]");
 }
 
-/* ====== Status message ====== */
-
-static VOID set_status(PU8 msg) {
-    STRNCPY(ed.status_msg, msg, sizeof(ed.status_msg) - 1);
-    ed.status_msg[sizeof(ed.status_msg) - 1] = NULLT;
-    ed.status_tick = 100; /* display for ~100 refresh cycles */
+static VOID op_redo(VOID) {
+    U32 offset;
+    if (!TEXTBUF_REDO(ed.text, &offset)) {
+        set_status("[ Nothing to redo ]");
+        return;
+    }
+    cursor_to_offset(offset);
+    ed.modified = TRUE;
+    set_status("[ Redo ]");
 }
 
 /* ====== Clamp cursor ====== */
 
 static VOID clamp_cursor(VOID) {
-    if (ed.cur_row >= ed.line_count)
-        ed.cur_row = ed.line_count > 0 ? ed.line_count - 1 : 0;
-    U32 line_len = ed.lines[ed.cur_row].len;
-    if (ed.cur_col > line_len)
-        ed.cur_col = line_len;
+    if (ed.cur_row >= line_count())
+        ed.cur_row = line_count() - 1;
+    U32 len = line_len(ed.cur_row);
+    if (ed.cur_col > len)
+        ed.cur_col = len;
 }
 
 /* ====== Scroll viewport to keep cursor visible ====== */
@@ -509,6 +422,7 @@ static VOID init_default_keybinds(VOID) {
     set_keybind(JOT_ACT_REPLACE,   KEY_BACKSLASH, TRUE, FALSE);
     set_keybind(JOT_ACT_HELP,      KEY_G,         TRUE, FALSE);
     set_keybind(JOT_ACT_UNDO,      KEY_Z,         TRUE, FALSE);
+    set_keybind(JOT_ACT_REDO,      KEY_Y,         TRUE, FALSE);
     set_keybind(JOT_ACT_TOP,       KEY_T,         TRUE, FALSE);
     set_keybind(JOT_ACT_BOTTOM,    KEY_B,         TRUE, FALSE);
     set_keybind(JOT_ACT_GOTO_LINE, KEY_SLASH,     TRUE, TRUE);
@@ -547,6 +461,7 @@ static VOID load_keybinds(VOID) {
         {"REPLACE",   JOT_ACT_REPLACE},
         {"HELP",      JOT_ACT_HELP},
         {"UNDO",      JOT_ACT_UNDO},
+        {"REDO",      JOT_ACT_REDO},
         {"TOP",       JOT_ACT_TOP},
         {"BOTTOM",    JOT_ACT_BOTTOM},
         {"GOTO_LINE", JOT_ACT_GOTO_LINE},
@@ -875,53 +790,45 @@ static VOID detect_syntax(VOID) {
 
 /* ====== File I/O ====== */
 
-static VOID strip_cr(PU8 line, U32 *len) {
-    while (*len > 0 && (line[*len - 1] == '\r' || line[*len - 1] == '\n')) {
-        line[--(*len)] = NULLT;
+/* Drops the '\r' of "\r\n" line ends in place, returns the new length */
+static U32 strip_cr(PU8 data, U32 len) {
+    U32 out = 0;
+    for (U32 i = 0; i < len; i++) {
+        if (data[i] == '\r' && i + 1 < len && data[i + 1] == '\n') continue;
+        data[out++] = data[i];
     }
+    return out;
 }
 
-static VOID load_file(PU8 filepath) {
-    if (!filepath || !filepath[0]) {
-        ed.new_file = TRUE;
-        line_init(&ed.lines[0]);
-        ed.line_count = 1;
-        return;
-    }
-
-    STRCPY(ed.filepath, filepath);
-    FILE *f = FOPEN(filepath, MODE_FR);
-    if (!f) {
-        /* New file */
-        ed.new_file = TRUE;
-        line_init(&ed.lines[0]);
-        ed.line_count = 1;
-        set_status("[ New File ]");
-        return;
-    }
-
-    ed.new_file = FALSE;
-    U8 line_buf[MAX_LINE_LEN];
-    ed.line_count = 0;
-
-    while (FILE_GET_LINE(f, line_buf, sizeof(line_buf)) && ed.line_count < MAX_LINES) {
-        U32 len = STRLEN(line_buf);
-        strip_cr(line_buf, &len);
-        line_init(&ed.lines[ed.line_count]);
-        line_set(&ed.lines[ed.line_count], line_buf, len);
-        ed.line_count++;
+static BOOL load_file(PU8 filepath) {
+    FILE *f = NULLPTR;
+    PU8 data = NULLPTR;
+    U32 len = 0;
+
+    ed.new_file = TRUE;
+    if (filepath && filepath[0]) {
+        STRCPY(ed.filepath, filepath);
+        f = FOPEN(filepath, MODE_FR);
+        if (!f) set_status("[ New File ]");
+    }
+    if (f) {
+        /* The file data becomes the original buffer of the piece table */
+        data = (PU8)f->data;
+        len  = data ? strip_cr(data, f->sz) : 0;
+        f->data = NULLPTR;
+        FCLOSE(f);
+        ed.new_file = FALSE;
     }
 
-    FCLOSE(f);
+    ed.text = TEXTBUF_CREATE(data, len);
+    if (!ed.text) return FALSE;
 
-    if (ed.line_count == 0) {
-        line_init(&ed.lines[0]);
-        ed.line_count = 1;
+    if (!ed.new_file) {
+        CHAR msg[128];
+        SPRINTF(msg, "Read %d lines", line_count());
+        set_status(msg);
     }
-
-    CHAR msg[128];
-    SPRINTF(msg, "Read %d lines", ed.line_count);
-    set_status(msg);
+    return TRUE;
 }
 
 static BOOL save_file(VOID) {
@@ -940,11 +847,7 @@ static BOOL save_file(VOID) {
     }
 
     /* Build full buffer and write at once */
-    U32 total_size = 0;
-    for (U32 i = 0; i < ed.line_count; i++) {
-        total_size += ed.lines[i].len + 1; /* +1 for newline */
-    }
-
+    U32 total_size = TEXTBUF_LENGTH(ed.text);
     PU8 buf = MAlloc(total_size + 1);
     if (!buf) {
         FCLOSE(f);
@@ -952,14 +855,7 @@ static BOOL save_file(VOID) {
         return FALSE;
     }
 
-    U32 pos = 0;
-    for (U32 i = 0; i < ed.line_count; i++) {
-        MEMCPY(buf + pos, ed.lines[i].data, ed.lines[i].len);
-        pos += ed.lines[i].len;
-        if (i < ed.line_count - 1) {
-            buf[pos++] = '\n';
-        }
-    }
+    U32 pos = TEXTBUF_READ(ed.text, 0, buf, total_size);
     buf[pos] = NULLT;
 
     FWRITE(f, buf, pos);
@@ -968,7 +864,7 @@ static BOOL save_file(VOID) {
 
     ed.modified = FALSE;
     CHAR msg[128];
-    SPRINTF(msg, "[ Wrote %d lines ]", ed.line_count);
+    SPRINTF(msg, "[ Wrote %d lines ]", line_count());
     set_status(msg);
     return TRUE;
 }
@@ -1062,8 +958,10 @@ static VOID compute_syntax_state_at(U32 target_row,
     U32  bc_e_len  = STRLEN(ed.syntax_block_comment_end);
     U32  sc_len    = STRLEN(ed.syntax_comment_start);
 
-    for (U32 row = 0; row < target_row && row < ed.line_count; row++) {
-        LINE_BUF *lb = &ed.lines[row];
+    U32  rows      = line_count();
+
+    for (U32 row = 0; row < target_row && row < rows; row++) {
+        LINE_BUF *lb = line_get(row);
         in_str = FALSE;            /* strings don't span lines */
         for (U32 col = 0; col < lb->len; col++) {
             CHAR c = lb->data[col];
@@ -1199,7 +1097,7 @@ static VOID draw_status_bar(VOID) {
 
     /* Right side: line/col info */
     CHAR info[48];
-    SPRINTF(info, "Ln %d/%d  Col %d", ed.cur_row + 1, ed.line_count, ed.cur_col + 1);
+    SPRINTF(info, "Ln %d/%d  Col %d", ed.cur_row + 1, line_count(), ed.cur_col + 1);
     U32 infolen = STRLEN(info);
     if (infolen < ed.screen_cols - 2)
         ATUI_MVADDSTR(bar_y, ed.screen_cols - infolen - 2, info);
@@ -1223,6 +1121,7 @@ static VOID draw_text(VOID) {
     U32 comment_len  = STRLEN(ed.syntax_comment_start);
     U32 bc_start_len = STRLEN(ed.syntax_block_comment_start);
     U32 bc_end_len   = STRLEN(ed.syntax_block_comment_end);
+    U32 rows         = line_count();
 
     for (U32 scr_row = 0; scr_row < ed.edit_rows; scr_row++) {
         U32 file_row = scr_row + ed.scroll_y;
@@ -1230,7 +1129,7 @@ static VOID draw_text(VOID) {
 
         ATUI_MOVE(y, 0);
 
-        if (file_row < ed.line_count) {
+        if (file_row < rows) {
             /* Line number gutter */
             if (ed.show_line_numbers) {
                 ATUI_SET_COLOR(ed.fg_line_number, ed.bg_text);
@@ -1239,7 +1138,7 @@ static VOID draw_text(VOID) {
             }
 
             /* Line content with syntax highlighting */
-            LINE_BUF *lb = &ed.lines[file_row];
+            LINE_BUF *lb = line_get(file_row);
             BOOL in_string = FALSE;
             CHAR string_char = 0;
             BOOL in_comment = FALSE;
@@ -1397,6 +1296,7 @@ static VOID draw_help_screen(VOID) {
         "   ^K               Cut current line",
         "   ^U               Uncut (paste last cut lines)",
         "   ^Z               Undo last action",
+        "   ^Y               Redo undone action",
         "",
         " File:",
         "   ^O               Write Out (save file)",
@@ -1505,7 +1405,7 @@ static U32 prompt_input(PU8 prompt_text, PU8 buf, U32 buflen) {
 /* ====== Editor operations ====== */
 
 static VOID op_insert_char(CHAR ch) {
-    LINE_BUF *lb = &ed.lines[ed.cur_row];
+    LINE_BUF *lb = line_get(ed.cur_row);
 
     /* Skip over closing pair character if it matches what's under cursor */
     if (ed.auto_pair_count > 0 && ed.cur_col < lb->len && lb->data[ed.cur_col] == ch) {
@@ -1517,10 +1417,8 @@ static VOID op_insert_char(CHAR ch) {
         }
     }
 
-    line_insert_char(lb, ed.cur_col, ch);
-    undo_push(UNDO_INSERT_CHAR, ed.cur_row, ed.cur_col, ch, NULLPTR);
+    if (!text_insert(text_offset(ed.cur_row, ed.cur_col), (PU8)&ch, 1)) return;
     ed.cur_col++;
-    ed.modified = TRUE;
 
     /* Auto-insert closing pair */
     if (ed.auto_pair_count > 0) {
@@ -1532,8 +1430,7 @@ static VOID op_insert_char(CHAR ch) {
                     if (ed.cur_col >= 2 && is_word_char(lb->data[ed.cur_col - 2]))
                         break;
                 }
-                line_insert_char(lb, ed.cur_col, close);
-                undo_push(UNDO_INSERT_CHAR, ed.cur_row, ed.cur_col, close, NULLPTR);
+                text_insert(text_offset(ed.cur_row, ed.cur_col), (PU8)&close, 1);
                 break;
             }
         }
@@ -1552,57 +1449,20 @@ static VOID op_insert_tab(VOID) {
 }
 
 static VOID op_delete_char_at(VOID) {
-    LINE_BUF *lb = &ed.lines[ed.cur_row];
-    if (ed.cur_col < lb->len) {
-        CHAR ch = lb->data[ed.cur_col];
-        line_delete_char(lb, ed.cur_col);
-        undo_push(UNDO_DELETE_CHAR, ed.cur_row, ed.cur_col, ch, NULLPTR);
-        ed.modified = TRUE;
-    } else if (ed.cur_row + 1 < ed.line_count) {
-        /* Join with next line */
-        LINE_BUF *nxt = &ed.lines[ed.cur_row + 1];
-        undo_push(UNDO_JOIN_LINE, ed.cur_row + 1, 0, 0, nxt->data);
-        line_append(lb, nxt->data, nxt->len);
-        line_free(nxt);
-        MEMMOVE(&ed.lines[ed.cur_row + 1], &ed.lines[ed.cur_row + 2],
-                (ed.line_count - ed.cur_row - 2) * sizeof(LINE_BUF));
-        ed.line_count--;
-        ed.modified = TRUE;
-    }
+    /* At the end of a line this deletes the '\n' and joins the next one */
+    text_delete(text_offset(ed.cur_row, ed.cur_col), 1);
 }
 
 static VOID op_backspace(VOID) {
-    if (ed.cur_col > 0) {
-        ed.cur_col--;
-        LINE_BUF *lb = &ed.lines[ed.cur_row];
-        CHAR ch = lb->data[ed.cur_col];
-        line_delete_char(lb, ed.cur_col);
-        undo_push(UNDO_DELETE_CHAR, ed.cur_row, ed.cur_col, ch, NULLPTR);
-        ed.modified = TRUE;
-    } else if (ed.cur_row > 0) {
-        /* Join current line to end of previous */
-        LINE_BUF *prev = &ed.lines[ed.cur_row - 1];
-        LINE_BUF *cur  = &ed.lines[ed.cur_row];
-        U32 join_col = prev->len;
-        undo_push(UNDO_JOIN_LINE, ed.cur_row, 0, 0, cur->data);
-        line_append(prev, cur->data, cur->len);
-        line_free(cur);
-        MEMMOVE(&ed.lines[ed.cur_row], &ed.lines[ed.cur_row + 1],
-                (ed.line_count - ed.cur_row - 1) * sizeof(LINE_BUF));
-        ed.line_count--;
-        ed.cur_row--;
-        ed.cur_col = join_col;
-        ed.modified = TRUE;
-    }
+    if (ed.cur_col == 0 && ed.cur_row == 0) return;
+    U32 offset = text_offset(ed.cur_row, ed.cur_col);
+    if (!text_delete(offset - 1, 1)) return;
+    /* At column 0 this joined the line to the end of the previous one */
+    cursor_to_offset(offset - 1);
 }
 
 static VOID op_enter(VOID) {
-    if (ed.line_count >= MAX_LINES) {
-        set_status("[ Maximum lines reached ]");
-        return;
-    }
-
-    LINE_BUF *cur = &ed.lines[ed.cur_row];
+    LINE_BUF *cur = line_get(ed.cur_row);
 
     /* Calculate auto-indent */
     U32 indent = 0;
@@ -1612,61 +1472,38 @@ static VOID op_enter(VOID) {
         if (indent > ed.cur_col) indent = ed.cur_col;
     }
 
-    /* Split: text after cursor goes to new line */
-    PU8 after = cur->data + ed.cur_col;
-    U32 after_len = cur->len - ed.cur_col;
-
-    /* Make room */
-    MEMMOVE(&ed.lines[ed.cur_row + 2], &ed.lines[ed.cur_row + 1],
-            (ed.line_count - ed.cur_row - 1) * sizeof(LINE_BUF));
-    ed.line_count++;
-
-    /* New line */
-    line_init(&ed.lines[ed.cur_row + 1]);
-
-    /* Auto-indent: copy leading whitespace */
-    if (indent > 0) {
-        line_append(&ed.lines[ed.cur_row + 1], cur->data, indent);
-    }
-    line_append(&ed.lines[ed.cur_row + 1], after, after_len);
-
-    /* Truncate current line at cursor */
-    cur->data[ed.cur_col] = NULLT;
-    cur->len = ed.cur_col;
-
-    undo_push(UNDO_SPLIT_LINE, ed.cur_row, ed.cur_col, 0, NULLPTR);
+    /* Split: the newline and the copied indent are one undo step */
+    U32 offset = text_offset(ed.cur_row, ed.cur_col);
+    if (!text_insert(offset, "\n", 1)) return;
+    if (indent > 0 && !text_insert(offset + 1, cur->data, indent)) indent = 0;
 
     ed.cur_row++;
     ed.cur_col = indent;
-    ed.modified = TRUE;
 }
 
 static VOID op_cut_line(VOID) {
-    if (ed.line_count <= 1 && ed.lines[0].len == 0) return;
+    U32 count = line_count();
+    if (count <= 1 && line_len(0) == 0) return;
+
+    LINE_BUF *lb = line_get(ed.cur_row);
 
     /* Append to cut buffer */
     if (ed.cut_count < CUT_BUFFER_SIZE) {
-        ed.cut_buf[ed.cut_count] = STRDUP(ed.lines[ed.cur_row].data);
+        ed.cut_buf[ed.cut_count] = STRDUP(lb->data);
         ed.cut_count++;
     }
 
-    undo_push(UNDO_DELETE_LINE, ed.cur_row, 0, 0, ed.lines[ed.cur_row].data);
-
-    line_free(&ed.lines[ed.cur_row]);
-
-    if (ed.line_count > 1) {
-        MEMMOVE(&ed.lines[ed.cur_row], &ed.lines[ed.cur_row + 1],
-                (ed.line_count - ed.cur_row - 1) * sizeof(LINE_BUF));
-        ed.line_count--;
-    } else {
-        /* Last line: just clear it */
-        line_init(&ed.lines[0]);
-        ed.line_count = 1;
+    /* The line goes with its '\n'; the last line takes the one before it */
+    U32 start = TEXTBUF_LINE_START(ed.text, ed.cur_row);
+    U32 len   = lb->len + 1;
+    if (ed.cur_row + 1 >= count) {
+        if (ed.cur_row > 0) start--;
+        else len--;
     }
+    if (!text_delete(start, len)) return;
 
     clamp_cursor();
     ed.cur_col = 0;
-    ed.modified = TRUE;
     set_status("[ Cut 1 line ]");
 }
 
@@ -1677,21 +1514,15 @@ static VOID op_uncut(VOID) {
     }
 
     for (U32 i = 0; i < ed.cut_count; i++) {
-        if (ed.line_count >= MAX_LINES) break;
-
         /* Insert a new line at cur_row */
-        MEMMOVE(&ed.lines[ed.cur_row + 1], &ed.lines[ed.cur_row],
-                (ed.line_count - ed.cur_row) * sizeof(LINE_BUF));
-        ed.line_count++;
-
-        line_init(&ed.lines[ed.cur_row]);
-        line_set(&ed.lines[ed.cur_row], ed.cut_buf[i], STRLEN(ed.cut_buf[i]));
-        undo_push(UNDO_INSERT_LINE, ed.cur_row, 0, 0, NULLPTR);
+        U32 offset = TEXTBUF_LINE_START(ed.text, ed.cur_row);
+        U32 len    = STRLEN(ed.cut_buf[i]);
+        if (!text_insert(offset, ed.cut_buf[i], len)) return;
+        if (!text_insert(offset + len, "\n", 1)) return;
         ed.cur_row++;
     }
 
     ed.cur_col = 0;
-    ed.modified = TRUE;
 
     CHAR msg[48];
     SPRINTF(msg, "[ Pasted %d line(s) ]", ed.cut_count);
@@ -1711,9 +1542,10 @@ static VOID op_search(VOID) {
     }
 
     /* Search forward from current position */
-    for (U32 i = 0; i < ed.line_count; i++) {
-        U32 row = (ed.cur_row + i) % ed.line_count;
-        PU8 line = ed.lines[row].data;
+    U32 rows = line_count();
+    for (U32 i = 0; i < rows; i++) {
+        U32 row = (ed.cur_row + i) % rows;
+        PU8 line = line_get(row)->data;
         PU8 found;
 
         if (ed.search_case_sensitive)
@@ -1763,8 +1595,10 @@ static VOID op_replace(VOID) {
     U32 search_len = STRLEN(ed.search_str);
     U32 replace_len = STRLEN(ed.replace_str);
 
-    for (U32 row = 0; row < ed.line_count; row++) {
-        LINE_BUF *lb = &ed.lines[row];
+    for (U32 row = 0; row < line_count(); row++) {
+        LINE_BUF *lb = line_get(row);
+        U32 start = TEXTBUF_LINE_START(ed.text, row);
+        I32 shift = 0;  /* how far earlier replacements moved the rest of the line */
         U32 pos = 0;
         while (pos + search_len <= lb->len) {
             PU8 found;
@@ -1776,22 +1610,12 @@ static VOID op_replace(VOID) {
             if (!found) break;
 
             U32 idx = (U32)(found - lb->data);
+            U32 at  = start + idx + shift;
+            if (!text_delete(at, search_len)) break;
+            if (!text_insert(at, ed.replace_str, replace_len)) break;
 
-            /* Build new line */
-            U32 new_len = lb->len - search_len + replace_len;
-            PU8 new_data = MAlloc(new_len + 1);
-            if (!new_data) break;
-
-            MEMCPY(new_data, lb->data, idx);
-            MEMCPY(new_data + idx, ed.replace_str, replace_len);
-            MEMCPY(new_data + idx + replace_len, lb->data + idx + search_len,
-                   lb->len - idx - search_len);
-            new_data[new_len] = NULLT;
-
-            line_set(lb, new_data, new_len);
-            MFree(new_data);
-
-            pos = idx + replace_len;
+            shift += (I32)replace_len - (I32)search_len;
+            pos = idx + search_len;
             count++;
         }
     }
@@ -1816,7 +1640,7 @@ static VOID op_goto_line(VOID) {
 
     U32 line_num = ATOI(buf);
     if (line_num == 0) line_num = 1;
-    if (line_num > ed.line_count) line_num = ed.line_count;
+    if (line_num > line_count()) line_num = line_count();
     ed.cur_row = line_num - 1;
     ed.cur_col = 0;
 
@@ -1826,11 +1650,12 @@ static VOID op_goto_line(VOID) {
 }
 
 static VOID op_show_pos(VOID) {
+    LINE_BUF *lb = line_get(ed.cur_row);
     CHAR msg[80];
     SPRINTF(msg, "[ Line %d/%d, Col %d/%d, Char %d ]",
-            ed.cur_row + 1, ed.line_count,
-            ed.cur_col + 1, ed.lines[ed.cur_row].len,
-            ed.cur_col < ed.lines[ed.cur_row].len ? ed.lines[ed.cur_row].data[ed.cur_col] : 0);
+            ed.cur_row + 1, line_count(),
+            ed.cur_col + 1, lb->len,
+            ed.cur_col < lb->len ? lb->data[ed.cur_col] : 0);
     set_status(msg);
 }
 
@@ -1848,25 +1673,25 @@ static VOID op_read_file(VOID) {
         return;
     }
 
-    U8 line_buf[MAX_LINE_LEN];
-    U32 inserted = 0;
-
-    while (FILE_GET_LINE(f, line_buf, sizeof(line_buf)) && ed.line_count < MAX_LINES) {
-        U32 ll = STRLEN(line_buf);
-        strip_cr(line_buf, &ll);
+    U32 before = line_count();
+    PU8 data = (PU8)f->data;
+    U32 data_len = data ? strip_cr(data, f->sz) : 0;
 
-        /* Insert after current row */
-        U32 insert_row = ed.cur_row + 1 + inserted;
-        MEMMOVE(&ed.lines[insert_row + 1], &ed.lines[insert_row],
-                (ed.line_count - insert_row) * sizeof(LINE_BUF));
-        ed.line_count++;
-        line_init(&ed.lines[insert_row]);
-        line_set(&ed.lines[insert_row], line_buf, ll);
-        inserted++;
+    /* The file goes in as whole lines below the current row: its own final
+       '\n' is dropped and one is added on the side facing the existing text */
+    if (data_len && data[data_len - 1] == '\n') data_len--;
+    if (f->sz) {
+        if (ed.cur_row + 1 < before) {
+            U32 offset = TEXTBUF_LINE_START(ed.text, ed.cur_row + 1);
+            if (text_insert(offset, data, data_len)) text_insert(offset + data_len, "\n", 1);
+        } else {
+            U32 offset = TEXTBUF_LENGTH(ed.text);
+            if (text_insert(offset, "\n", 1)) text_insert(offset + 1, data, data_len);
+        }
     }
 
     FCLOSE(f);
-    ed.modified = TRUE;
+    U32 inserted = line_count() - before;
 
     CHAR msg[80];
     SPRINTF(msg, "[ Read %d lines from %s ]", inserted, path);
@@ -1900,6 +1725,10 @@ static VOID handle_input(VOID) {
     MODIFIERS *mods = kb_mods();
     KEYCODES key = kb->cur.keycode;
 
+    /* A run of typed characters is one undo step, any other key ends it */
+    if (mods->ctrl || kb->cur.ASCII < 32 || kb->cur.ASCII > 126)
+        TEXTBUF_COMMIT(ed.text);
+
     /* ---- Ctrl shortcuts (configurable via JOT.CNF [KEYBINDS]) ---- */
     if (mods->ctrl) {
         JOT_ACTION action = lookup_action(key, TRUE, mods->shift);
@@ -1922,7 +1751,8 @@ static VOID handle_input(VOID) {
         case JOT_ACT_SEARCH:    op_search();     return;
         case JOT_ACT_REPLACE:   op_replace();    return;
         case JOT_ACT_HELP:      ed.show_help = TRUE; return;
-        case JOT_ACT_UNDO:      undo_pop(); set_status("[ Undo ]"); return;
+        case JOT_ACT_UNDO:      op_undo();       return;
+        case JOT_ACT_REDO:      op_redo();       return;
         case JOT_ACT_POSITION:  op_show_pos();   return;
         case JOT_ACT_READ_FILE: op_read_file();  return;
         case JOT_ACT_GOTO_LINE: op_goto_line();  return;
@@ -1932,13 +1762,13 @@ static VOID handle_input(VOID) {
             set_status("[ Top of file ]"); return;
 
         case JOT_ACT_BOTTOM:
-            ed.cur_row = ed.line_count > 0 ? ed.line_count - 1 : 0;
-            ed.cur_col = ed.lines[ed.cur_row].len;
+            ed.cur_row = line_count() - 1;
+            ed.cur_col = line_len(ed.cur_row);
             set_status("[ Bottom of file ]"); return;
 
         case JOT_ACT_REFRESH:   ATUI_TOUCHSCREEN(); return;
         case JOT_ACT_HOME:      ed.cur_col = 0; return;
-        case JOT_ACT_END:       ed.cur_col = ed.lines[ed.cur_row].len; return;
+        case JOT_ACT_END:       ed.cur_col = line_len(ed.cur_row); return;
         case JOT_ACT_COUNT:
         default: break;
         }
@@ -1950,16 +1780,16 @@ static VOID handle_input(VOID) {
     case KEY_ARROW_UP:
         if (ed.cur_row > 0) {
             ed.cur_row--;
-            if (ed.cur_col > ed.lines[ed.cur_row].len)
-                ed.cur_col = ed.lines[ed.cur_row].len;
+            if (ed.cur_col > line_len(ed.cur_row))
+                ed.cur_col = line_len(ed.cur_row);
         }
         return;
 
     case KEY_ARROW_DOWN:
-        if (ed.cur_row + 1 < ed.line_count) {
+        if (ed.cur_row + 1 < line_count()) {
             ed.cur_row++;
-            if (ed.cur_col > ed.lines[ed.cur_row].len)
-                ed.cur_col = ed.lines[ed.cur_row].len;
+            if (ed.cur_col > line_len(ed.cur_row))
+                ed.cur_col = line_len(ed.cur_row);
         }
         return;
 
@@ -1968,14 +1798,14 @@ static VOID handle_input(VOID) {
             ed.cur_col--;
         } else if (ed.cur_row > 0) {
             ed.cur_row--;
-            ed.cur_col = ed.lines[ed.cur_row].len;
+            ed.cur_col = line_len(ed.cur_row);
         }
         return;
 
     case KEY_ARROW_RIGHT:
-        if (ed.cur_col < ed.lines[ed.cur_row].len) {
+        if (ed.cur_col < line_len(ed.cur_row)) {
             ed.cur_col++;
-        } else if (ed.cur_row + 1 < ed.line_count) {
+        } else if (ed.cur_row + 1 < line_count()) {
             ed.cur_row++;
             ed.cur_col = 0;
         }
@@ -1986,7 +1816,7 @@ static VOID handle_input(VOID) {
         return;
 
     case KEY_END:
-        ed.cur_col = ed.lines[ed.cur_row].len;
+        ed.cur_col = line_len(ed.cur_row);
         return;
 
     case KEY_PAGEUP: {
@@ -2044,21 +1874,15 @@ static VOID handle_input(VOID) {
 /* ====== Cleanup ====== */
 
 static VOID cleanup_editor(VOID) {
-    /* Free all lines */
-    for (U32 i = 0; i < ed.line_count; i++) {
-        line_free(&ed.lines[i]);
-    }
+    /* Free the text and its undo log */
+    TEXTBUF_DESTROY(ed.text);
+    if (ed.line.cap) MFree(ed.line.data);
 
     /* Free cut buffer */
     for (U32 i = 0; i < ed.cut_count; i++) {
         if (ed.cut_buf[i]) MFree(ed.cut_buf[i]);
     }
 
-    /* Free undo records */
-    for (U32 i = 0; i < ed.undo_top; i++) {
-        if (ed.undo[i].line_data) MFree(ed.undo[i].line_data);
-    }
-
     /* Free config */
     if (ed.config) DESTROY_ATRCFD(ed.config);
     if (ed.syntax_config) DESTROY_ATRCFD(ed.syntax_config);
@@ -2097,7 +1921,11 @@ CMAIN() {
     if (argc > 1) filename = argv[1];
 
     /* Load file */
-    load_file(filename);
+    if (!load_file(filename)) {
+        ATUI_DESTROY();
+        printf("jot: out of memory\n");
+        return 1;
+    }
 
     /* Set up syntax highlighting based on file extension */
     detect_syntax();
@@ -0,0 +1,555 @@
+/*
+ * TEXTBUF.c — Piece table text storage for JOT
+ *
+ * The pieces live in a treap ordered by position: each node is one span of
+ * the original or the add buffer, with a random heap priority and the byte
+ * and newline totals of its subtree. Edits split the tree at the edit
+ * offset(s) and merge the parts back, so only O(log n) nodes are touched.
+ * A split that falls inside a piece cuts it in two; both halves keep
+ * pointing into the same buffer.
+ *
+ * The edit log is an array of TB_EDIT records. Pieces removed by a delete
+ * are appended to a span pool in log order, so dropping the redo tail is a
+ * truncation of both arrays.
+ */
+
+#include <STD/MEM.h>
+#include <PROGRAMS/SYS_PROGS/JOT/TEXTBUF.h>
+
+#define TB_ORIGINAL 0
+#define TB_ADDED    1
+
+typedef struct {
+    U32 start;
+    U32 len;
+    U32 buf;        /* TB_ORIGINAL or TB_ADDED */
+} TB_SPAN;
+
+typedef struct _TB_NODE {
+    struct _TB_NODE *left;
+    struct _TB_NODE *right;
+    U32     prio;
+    TB_SPAN span;
+    U32     lf;             /* '\n' inside span       */
+    U32     total_len;      /* bytes in this subtree  */
+    U32     total_lf;       /* '\n' in this subtree   */
+} TB_NODE;
+
+typedef struct {
+    PU8  data;  U32 len,      cap;
+    U32 *nl;    U32 nl_count, nl_cap;   /* sorted offsets of every '\n' */
+} TB_STORE;
+
+typedef struct {
+    U32 offset;
+    U32 ins_start;      /* inserted text is add[ins_start .. +ins_len) */
+    U32 ins_len;
+    U32 del_first;      /* removed pieces are removed[del_first .. +del_count) */
+    U32 del_count;
+    U32 del_len;
+    U32 group;
+} TB_EDIT;
+
+struct _TEXTBUF {
+    TB_STORE store[2];
+    TB_NODE *root;
+    TB_NODE *spare[2];  /* one per split an edit may need */
+    U32      seed;
+
+    TB_EDIT *log;       U32 log_count,     log_cap;
+    U32      log_pos;   /* records below this are applied */
+    TB_SPAN *removed;   U32 removed_count, removed_cap;
+    U32      group;
+};
+
+static BOOL GROW(VOIDPTR *arr, U32 *cap, U32 need, U32 elem) {
+    if (need <= *cap) return TRUE;
+    U32 n = *cap ? *cap * 2 : 16;
+    while (n < need) n *= 2;
+    VOIDPTR p = ReAlloc(*arr, n * elem);
+    if (!p) return FALSE;
+    *arr = p;
+    *cap = n;
+    return TRUE;
+}
+
+/* ===================================================
+ * Buffers and their newline index
+ * =================================================== */
+
+/* Index of the first '\n' at or after `off` */
+static U32 nl_lower(TB_STORE *s, U32 off) {
+    U32 lo = 0, hi = s->nl_count;
+    while (lo < hi) {
+        U32 mid = lo + (hi - lo) / 2;
+        if (s->nl[mid] < off) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static U32 span_lf(TEXTBUF *tb, TB_SPAN *sp) {
+    TB_STORE *s = &tb->store[sp->buf];
+    return nl_lower(s, sp->start + sp->len) - nl_lower(s, sp->start);
+}
+
+static BOOL store_append(TB_STORE *s, PU8 text, U32 len) {
+    U32 lf = 0;
+    for (U32 i = 0; i < len; i++) if (text[i] == '\n') lf++;
+    if (!GROW((VOIDPTR *)&s->data, &s->cap, s->len + len, 1)) return FALSE;
+    if (!GROW((VOIDPTR *)&s->nl, &s->nl_cap, s->nl_count + lf, sizeof(U32))) return FALSE;
+    for (U32 i = 0; i < len; i++) {
+        if (text[i] == '\n') s->nl[s->nl_count++] = s->len + i;
+    }
+    MEMCPY(s->data + s->len, text, len);
+    s->len += len;
+    return TRUE;
+}
+
+/* ===================================================
+ * Treap
+ * =================================================== */
+
+static U32 next_prio(TEXTBUF *tb) {
+    U32 x = tb->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    tb->seed = x;
+    return x;
+}
+
+static VOID update(TB_NODE *n) {
+    n->total_len = n->span.len;
+    n->total_lf  = n->lf;
+    if (n->left)  { n->total_len += n->left->total_len;  n->total_lf += n->left->total_lf; }
+    if (n->right) { n->total_len += n->right->total_len; n->total_lf += n->right->total_lf; }
+}
+
+static TB_NODE *node_new(TEXTBUF *tb, TB_SPAN *sp) {
+    TB_NODE *n = MAlloc(sizeof(TB_NODE));
+    if (!n) return NULLPTR;
+    n->left = n->right = NULLPTR;
+    n->prio = next_prio(tb);
+    n->span = *sp;
+    n->lf   = span_lf(tb, sp);
+    update(n);
+    return n;
+}
+
+static VOID free_tree(TB_NODE *n) {
+    while (n) {
+        TB_NODE *right = n->right;
+        free_tree(n->left);
+        MFree(n);
+        n = right;
+    }
+}
+
+static U32 count_nodes(TB_NODE *n) {
+    U32 c = 0;
+    for (; n; n = n->right) c += 1 + count_nodes(n->left);
+    return c;
+}
+
+/* In-order copy of the pieces of `n` to `out` */
+static U32 collect(TB_NODE *n, TB_SPAN *out) {
+    U32 c = 0;
+    for (; n; n = n->right) {
+        c += collect(n->left, out + c);
+        out[c++] = n->span;
+    }
+    return c;
+}
+
+static BOOL reserve_spares(TEXTBUF *tb) {
+    for (U32 i = 0; i < 2; i++) {
+        if (!tb->spare[i]) tb->spare[i] = MAlloc(sizeof(TB_NODE));
+        if (!tb->spare[i]) return FALSE;
+    }
+    return TRUE;
+}
+
+static TB_NODE *take_spare(TEXTBUF *tb) {
+    TB_NODE *n = tb->spare[0] ? tb->spare[0] : tb->spare[1];
+    if (n == tb->spare[0]) tb->spare[0] = NULLPTR;
+    else tb->spare[1] = NULLPTR;
+    return n;
+}
+
+/* Splits `t` into its first `pos` bytes (*l) and the rest (*r). Cutting a
+   piece takes a node from the spares, callers reserve them beforehand. */
+static VOID split(TEXTBUF *tb, TB_NODE *t, U32 pos, TB_NODE **l, TB_NODE **r) {
+    if (!t) { *l = *r = NULLPTR; return; }
+    U32 left_len = t->left ? t->left->total_len : 0;
+    if (pos <= left_len) {
+        split(tb, t->left, pos, l, &t->left);
+        update(t);
+        *r = t;
+    } else if (pos >= left_len + t->span.len) {
+        split(tb, t->right, pos - left_len - t->span.len, &t->right, r);
+        update(t);
+        *l = t;
+    } else {
+        /* The tail of the piece becomes the root of the right part and
+           inherits the priority, so it stays above t's right subtree */
+        U32 cut = pos - left_len;
+        TB_NODE *tail = take_spare(tb);
+        tail->span.buf   = t->span.buf;
+        tail->span.start = t->span.start + cut;
+        tail->span.len   = t->span.len - cut;
+        tail->lf    = span_lf(tb, &tail->span);
+        tail->prio  = t->prio;
+        tail->left  = NULLPTR;
+        tail->right = t->right;
+        update(tail);
+        t->span.len = cut;
+        t->lf      -= tail->lf;
+        t->right    = NULLPTR;
+        update(t);
+        *l = t;
+        *r = tail;
+    }
+}
+
+static TB_NODE *merge(TB_NODE *a, TB_NODE *b) {
+    if (!a) return b;
+    if (!b) return a;
+    if (a->prio > b->prio) {
+        a->right = merge(a->right, b);
+        update(a);
+        return a;
+    }
+    b->left = merge(a, b->left);
+    update(b);
+    return b;
+}
+
+/* Extends the last piece of `n` by `len` bytes holding `lf` newlines */
+static VOID grow_last(TB_NODE *n, U32 len, U32 lf) {
+    for (; n; n = n->right) {
+        n->total_len += len;
+        n->total_lf  += lf;
+        if (!n->right) {
+            n->span.len += len;
+            n->lf       += lf;
+        }
+    }
+}
+
+static TB_NODE *last_node(TB_NODE *n) {
+    while (n && n->right) n = n->right;
+    return n;
+}
+
+/* ===================================================
+ * Unlogged edits, shared by the public calls and undo/redo
+ * =================================================== */
+
+static BOOL insert_spans(TEXTBUF *tb, U32 offset, TB_SPAN *spans, U32 count) {
+    TB_NODE *chain = NULLPTR;
+    if (!reserve_spares(tb)) return FALSE;
+    /* Allocate first so failure leaves the tree alone; chained via ->left */
+    for (U32 i = count; i-- > 0;) {
+        TB_NODE *n = node_new(tb, &spans[i]);
+        if (!n) {
+            while (chain) { TB_NODE *next = chain->left; MFree(chain); chain = next; }
+            return FALSE;
+        }
+        n->left = chain;
+        chain = n;
+    }
+
+    TB_NODE *a, *b;
+    split(tb, tb->root, offset, &a, &b);
+    while (chain) {
+        TB_NODE *n = chain;
+        chain = n->left;
+        n->left = NULLPTR;
+        /* Typing appends to the add buffer right behind the previous
+           keystroke: grow that piece instead of adding one per character */
+        TB_NODE *prev = last_node(a);
+        if (prev && prev->span.buf == n->span.buf &&
+            prev->span.start + prev->span.len == n->span.start) {
+            grow_last(a, n->span.len, n->lf);
+            MFree(n);
+            continue;
+        }
+        a = merge(a, n);
+    }
+    tb->root = merge(a, b);
+    return TRUE;
+}
+
+/* Removes [offset, offset + len). With `capture`, the removed pieces are
+   appended to the span pool and their count stored in *count. */
+static BOOL remove_range(TEXTBUF *tb, U32 offset, U32 len, BOOL capture, U32 *count) {
+    if (!reserve_spares(tb)) return FALSE;
+    TB_NODE *a, *b, *gone, *c;
+    split(tb, tb->root, offset, &a, &b);
+    split(tb, b, len, &gone, &c);
+    if (capture) {
+        U32 n = count_nodes(gone);
+        if (!GROW((VOIDPTR *)&tb->removed, &tb->removed_cap,
+                  tb->removed_count + n, sizeof(TB_SPAN))) {
+            tb->root = merge(merge(a, gone), c);
+            return FALSE;
+        }
+        collect(gone, tb->removed + tb->removed_count);
+        tb->removed_count += n;
+        *count = n;
+    }
+    free_tree(gone);
+    tb->root = merge(a, c);
+    return TRUE;
+}
+
+/* ===================================================
+ * Edit log
+ * =================================================== */
+
+/* A new edit makes the undone records unreachable */
+static VOID drop_redo(TEXTBUF *tb) {
+    if (tb->log_pos < tb->log_count) {
+        tb->removed_count = tb->log[tb->log_pos].del_first;
+        tb->log_count = tb->log_pos;
+    }
+}
+
+static TB_EDIT *log_push(TEXTBUF *tb) {
+    TB_EDIT *e = &tb->log[tb->log_count++];
+    tb->log_pos = tb->log_count;
+    MEMZERO(e, sizeof(TB_EDIT));
+    e->group = tb->group;
+    e->del_first = tb->removed_count;
+    return e;
+}
+
+static BOOL undo_edit(TEXTBUF *tb, TB_EDIT *e) {
+    if (e->ins_len && !remove_range(tb, e->offset, e->ins_len, FALSE, NULLPTR)) return FALSE;
+    if (e->del_count && !insert_spans(tb, e->offset, tb->removed + e->del_first, e->del_count)) return FALSE;
+    return TRUE;
+}
+
+static BOOL redo_edit(TEXTBUF *tb, TB_EDIT *e) {
+    if (e->del_len && !remove_range(tb, e->offset, e->del_len, FALSE, NULLPTR)) return FALSE;
+    if (e->ins_len) {
+        TB_SPAN sp = { e->ins_start, e->ins_len, TB_ADDED };
+        if (!insert_spans(tb, e->offset, &sp, 1)) return FALSE;
+    }
+    return TRUE;
+}
+
+/* ===================================================
+ * Public API
+ * =================================================== */
+
+TEXTBUF *TEXTBUF_CREATE(PU8 data, U32 len) {
+    TEXTBUF *tb = MAlloc(sizeof(TEXTBUF));
+    if (!tb) {
+        if (data) MFree(data);
+        return NULLPTR;
+    }
+    MEMZERO(tb, sizeof(TEXTBUF));
+    tb->seed = 0x9E3779B9;
+
+    TB_STORE *orig = &tb->store[TB_ORIGINAL];
+    orig->data = data;
+    orig->len  = orig->cap = data ? len : 0;
+    for (U32 i = 0; i < orig->len; i++) if (data[i] == '\n') orig->nl_count++;
+    if (orig->nl_count) {
+        orig->nl = MAlloc(orig->nl_count * sizeof(U32));
+        if (!orig->nl) { TEXTBUF_DESTROY(tb); return NULLPTR; }
+        orig->nl_cap = orig->nl_count;
+        for (U32 i = 0, k = 0; i < orig->len; i++) if (data[i] == '\n') orig->nl[k++] = i;
+    }
+    if (orig->len) {
+        TB_SPAN sp = { 0, orig->len, TB_ORIGINAL };
+        tb->root = node_new(tb, &sp);
+        if (!tb->root) { TEXTBUF_DESTROY(tb); return NULLPTR; }
+    }
+    return tb;
+}
+
+VOID TEXTBUF_DESTROY(TEXTBUF *tb) {
+    if (!tb) return;
+    free_tree(tb->root);
+    for (U32 i = 0; i < 2; i++) {
+        if (tb->spare[i]) MFree(tb->spare[i]);
+        if (tb->store[i].data) MFree(tb->store[i].data);
+        if (tb->store[i].nl) MFree(tb->store[i].nl);
+    }
+    if (tb->log) MFree(tb->log);
+    if (tb->removed) MFree(tb->removed);
+    MFree(tb);
+}
+
+U32 TEXTBUF_LENGTH(TEXTBUF *tb) {
+    return tb->root ? tb->root->total_len : 0;
+}
+
+U32 TEXTBUF_LINE_COUNT(TEXTBUF *tb) {
+    return (tb->root ? tb->root->total_lf : 0) + 1;
+}
+
+U32 TEXTBUF_LINE_START(TEXTBUF *tb, U32 line) {
+    if (!line) return 0;
+    if (line >= TEXTBUF_LINE_COUNT(tb)) return TEXTBUF_LENGTH(tb);
+    /* Find the line-th '\n', the line starts right after it */
+    U32 k = line, off = 0;
+    TB_NODE *n = tb->root;
+    while (n) {
+        U32 left_lf = n->left ? n->left->total_lf : 0;
+        if (k <= left_lf) { n = n->left; continue; }
+        k   -= left_lf;
+        off += n->left ? n->left->total_len : 0;
+        if (k <= n->lf) {
+            TB_STORE *s = &tb->store[n->span.buf];
+            U32 nl = s->nl[nl_lower(s, n->span.start) + k - 1];
+            return off + (nl - n->span.start) + 1;
+        }
+        k   -= n->lf;
+        off += n->span.len;
+        n = n->right;
+    }
+    return TEXTBUF_LENGTH(tb);
+}
+
+U32 TEXTBUF_LINE_LENGTH(TEXTBUF *tb, U32 line) {
+    U32 count = TEXTBUF_LINE_COUNT(tb);
+    if (line >= count) return 0;
+    U32 start = TEXTBUF_LINE_START(tb, line);
+    U32 end = line + 1 < count ? TEXTBUF_LINE_START(tb, line + 1) - 1 : TEXTBUF_LENGTH(tb);
+    return end - start;
+}
+
+U32 TEXTBUF_LINE_OF(TEXTBUF *tb, U32 offset) {
+    U32 lines = 0;
+    TB_NODE *n = tb->root;
+    while (n) {
+        U32 left_len = n->left ? n->left->total_len : 0;
+        if (offset < left_len) { n = n->left; continue; }
+        lines  += n->left ? n->left->total_lf : 0;
+        offset -= left_len;
+        if (offset < n->span.len) {
+            TB_STORE *s = &tb->store[n->span.buf];
+            return lines + nl_lower(s, n->span.start + offset) - nl_lower(s, n->span.start);
+        }
+        lines  += n->lf;
+        offset -= n->span.len;
+        n = n->right;
+    }
+    return lines;
+}
+
+/* Copies [offset, offset + len) of the subtree `n`, offset relative to it */
+static U32 read_tree(TEXTBUF *tb, TB_NODE *n, U32 offset, PU8 dst, U32 len) {
+    U32 done = 0;
+    while (n && len) {
+        U32 left_len = n->left ? n->left->total_len : 0;
+        if (offset < left_len) {
+            U32 got = read_tree(tb, n->left, offset, dst + done, len);
+            done += got;
+            len  -= got;
+            offset = left_len;
+            if (!len) break;
+        }
+        U32 in = offset - left_len;
+        if (in < n->span.len) {
+            U32 take = n->span.len - in;
+            if (take > len) take = len;
+            MEMCPY(dst + done, tb->store[n->span.buf].data + n->span.start + in, take);
+            done += take;
+            len  -= take;
+            in   += take;
+        }
+        offset = in - n->span.len;
+        n = n->right;
+    }
+    return done;
+}
+
+U32 TEXTBUF_READ(TEXTBUF *tb, U32 offset, PU8 dst, U32 len) {
+    U32 total = TEXTBUF_LENGTH(tb);
+    if (offset >= total) return 0;
+    if (len > total - offset) len = total - offset;
+    return read_tree(tb, tb->root, offset, dst, len);
+}
+
+BOOL TEXTBUF_INSERT(TEXTBUF *tb, U32 offset, PU8 text, U32 len) {
+    if (offset > TEXTBUF_LENGTH(tb)) return FALSE;
+    if (!len) return TRUE;
+    drop_redo(tb);
+    if (!GROW((VOIDPTR *)&tb->log, &tb->log_cap, tb->log_count + 1, sizeof(TB_EDIT))) return FALSE;
+
+    /* Bytes appended to the add buffer by a failed insert are just unused */
+    TB_STORE *add = &tb->store[TB_ADDED];
+    U32 start = add->len;
+    if (!store_append(add, text, len)) return FALSE;
+    TB_SPAN sp = { start, len, TB_ADDED };
+    if (!insert_spans(tb, offset, &sp, 1)) return FALSE;
+
+    /* Continued typing extends the previous record */
+    TB_EDIT *prev = tb->log_count ? &tb->log[tb->log_count - 1] : NULLPTR;
+    if (prev && prev->group == tb->group && !prev->del_len &&
+        prev->ins_start + prev->ins_len == start && prev->offset + prev->ins_len == offset) {
+        prev->ins_len += len;
+        return TRUE;
+    }
+    TB_EDIT *e = log_push(tb);
+    e->offset    = offset;
+    e->ins_start = start;
+    e->ins_len   = len;
+    return TRUE;
+}
+
+BOOL TEXTBUF_DELETE(TEXTBUF *tb, U32 offset, U32 len) {
+    U32 total = TEXTBUF_LENGTH(tb);
+    if (offset >= total || !len) return TRUE;
+    if (len > total - offset) len = total - offset;
+    drop_redo(tb);
+    if (!GROW((VOIDPTR *)&tb->log, &tb->log_cap, tb->log_count + 1, sizeof(TB_EDIT))) return FALSE;
+
+    U32 first = tb->removed_count, count = 0;
+    if (!remove_range(tb, offset, len, TRUE, &count)) return FALSE;
+    TB_EDIT *e = log_push(tb);
+    e->offset    = offset;
+    e->del_first = first;
+    e->del_count = count;
+    e->del_len   = len;
+    return TRUE;
+}
+
+VOID TEXTBUF_COMMIT(TEXTBUF *tb) {
+    if (tb->log_count && tb->log[tb->log_count - 1].group == tb->group) tb->group++;
+}
+
+BOOL TEXTBUF_UNDO(TEXTBUF *tb, U32 *cursor) {
+    if (!tb->log_pos) return FALSE;
+    U32 group = tb->log[tb->log_pos - 1].group;
+    while (tb->log_pos && tb->log[tb->log_pos - 1].group == group) {
+        TB_EDIT *e = &tb->log[tb->log_pos - 1];
+        if (!undo_edit(tb, e)) return FALSE;
+        tb->log_pos--;
+        if (cursor) *cursor = e->offset + e->del_len;
+    }
+    tb->group++;
+    return TRUE;
+}
+
+BOOL TEXTBUF_REDO(TEXTBUF *tb, U32 *cursor) {
+    if (tb->log_pos >= tb->log_count) return FALSE;
+    U32 group = tb->log[tb->log_pos].group;
+    while (tb->log_pos < tb->log_count && tb->log[tb->log_pos].group == group) {
+        TB_EDIT *e = &tb->log[tb->log_pos];
+        if (!redo_edit(tb, e)) return FALSE;
+        tb->log_pos++;
+        if (cursor) *cursor = e->offset + e->ins_len;
+    }
+    tb->group++;
+    return TRUE;
+}
+
+U32 TEXTBUF_PIECE_COUNT(TEXTBUF *tb) {
+    return count_nodes(tb->root);
+}
@@ -0,0 +1,81 @@
+#ifndef TEXTBUF_H
+#define TEXTBUF_H
+
+#include <STD/TYPEDEF.h>
+
+/*
+ * ════════════════════════════════════════════════════════════════════════════
+ *  PIECE TABLE  (TEXTBUF.c)
+ *
+ *  A document is the file data as read (never modified) plus an append-only
+ *  buffer of typed text. The text itself is a sequence of pieces, each a span
+ *  of one of the two buffers, kept in a balanced tree (treap) whose nodes
+ *  carry the byte and newline totals of their subtree. Both buffers have a
+ *  sorted index of their '\n' offsets, so a span's newline count and the n-th
+ *  newline inside it are binary searches: line <-> offset lookups, inserts and
+ *  deletes are O(log n) in the number of pieces and lines.
+ *
+ *  Memory is the file size, four bytes per line and whatever the edits add.
+ *
+ *  Every edit is logged as the span it inserted and the pieces it removed,
+ *  so undo and redo only move pieces around and never copy text. Edits are
+ *  collected into groups; TEXTBUF_UNDO/REDO step over a whole group.
+ *
+ *  The core only needs STD/MEM, which lets the host tests drive it.
+ * ════════════════════════════════════════════════════════════════════════════
+ */
+
+typedef struct _TEXTBUF TEXTBUF;
+
+/// @brief Creates a buffer over `data`, which must come from MAlloc.
+/// @param data Initial text or NULLPTR. Ownership passes to the buffer, even
+///             when creation fails.
+/// @return The buffer (free with TEXTBUF_DESTROY), or NULLPTR when out of memory.
+TEXTBUF *TEXTBUF_CREATE(PU8 data, U32 len);
+
+VOID TEXTBUF_DESTROY(TEXTBUF *tb);
+
+/// @brief Total size of the text in bytes.
+U32 TEXTBUF_LENGTH(TEXTBUF *tb);
+
+/// @brief Number of lines, which is the number of '\n' plus one.
+U32 TEXTBUF_LINE_COUNT(TEXTBUF *tb);
+
+/// @brief Offset of the first byte of `line` (0-based), or TEXTBUF_LENGTH if past the end.
+U32 TEXTBUF_LINE_START(TEXTBUF *tb, U32 line);
+
+/// @brief Length of `line` without its '\n', 0 if past the end.
+U32 TEXTBUF_LINE_LENGTH(TEXTBUF *tb, U32 line);
+
+/// @brief Line that contains `offset` (0-based).
+U32 TEXTBUF_LINE_OF(TEXTBUF *tb, U32 offset);
+
+/// @brief Copies up to `len` bytes starting at `offset` into `dst`.
+/// @return Number of bytes copied. No terminator is written.
+U32 TEXTBUF_READ(TEXTBUF *tb, U32 offset, PU8 dst, U32 len);
+
+/// @brief Inserts `len` bytes of `text` at `offset` and logs the edit.
+/// @return FALSE if `offset` is past the end or memory ran out; the text is unchanged then.
+BOOL TEXTBUF_INSERT(TEXTBUF *tb, U32 offset, PU8 text, U32 len);
+
+/// @brief Deletes `len` bytes at `offset` (clipped to the end) and logs the edit.
+/// @return FALSE if memory ran out; the text is unchanged then.
+BOOL TEXTBUF_DELETE(TEXTBUF *tb, U32 offset, U32 len);
+
+/// @brief Closes the current undo group. Later edits start a new one.
+VOID TEXTBUF_COMMIT(TEXTBUF *tb);
+
+/// @brief Reverts the most recent group of edits.
+/// @param cursor Receives the offset just after the restored text. May be NULLPTR.
+/// @return FALSE if there is nothing to undo.
+BOOL TEXTBUF_UNDO(TEXTBUF *tb, U32 *cursor);
+
+/// @brief Re-applies the most recently undone group.
+/// @param cursor Receives the offset just after the re-inserted text. May be NULLPTR.
+/// @return FALSE if there is nothing to redo.
+BOOL TEXTBUF_REDO(TEXTBUF *tb, U32 *cursor);
+
+/// @brief Number of pieces the text is made of, for diagnostics and benchmarks.
+U32 TEXTBUF_PIECE_COUNT(TEXTBUF *tb);
+
+#endif /* TEXTBUF_H */
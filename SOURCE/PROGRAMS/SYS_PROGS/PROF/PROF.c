@@ -0,0 +1,230 @@
+/*
+ * PROF.c — Sampling profiler for a running process
+ *
+ * Asks the kernel to histogram the EIP of <pid> on every PIT tick, waits,
+ * then attributes each bucket to the nearest preceding symbol of the
+ * program's linker map (/ATOS/<NAME>.MAP, written next to the .BIN).
+ */
+#include <STD/TYPEDEF.h>
+#include <STD/IO.h>
+#include <STD/MEM.h>
+#include <STD/STRING.h>
+#include <STD/FS_DISK.h>
+#include <STD/PROC_COM.h>
+#include <RTOSKRNL/PROC/PROC.h>
+
+#define DEFAULT_SECONDS 5
+#define TOP_COUNT       15
+
+typedef struct {
+    U32 addr;
+    PU8 name;       // points into the map file data
+    U32 hits;
+} SYMBOL;
+
+static U0 HELP_MESSAGE(VOID) {
+    printf(
+        #include "PROF.HELP"
+    );
+}
+
+static BOOL is_blank(U8 c) {
+    return c == ' ' || c == '\t';
+}
+
+static BOOL is_hex(U8 c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/*
+ * GNU ld map symbol lines are "<spaces>0x<addr><spaces><name>" with nothing
+ * after the name. Section, fill and assignment lines have more fields or
+ * start with something else, so they fail this test.
+ * Terminates the name in place.
+ */
+static BOOL parse_symbol_line(PU8 line, U32 len, SYMBOL *out) {
+    U32 i = 0;
+    if (!len || !is_blank(line[0])) return FALSE;
+    while (i < len && is_blank(line[i])) i++;
+    if (i + 2 >= len || line[i] != '0' || (line[i + 1] != 'x' && line[i + 1] != 'X')) return FALSE;
+    U32 hex = i + 2, hex_end = hex;
+    while (hex_end < len && is_hex(line[hex_end])) hex_end++;
+    if (hex_end == hex || hex_end >= len || !is_blank(line[hex_end])) return FALSE;
+
+    i = hex_end;
+    while (i < len && is_blank(line[i])) i++;
+    if (i >= len) return FALSE;
+    U8 c = line[i];
+    if (!(c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))) return FALSE;
+    U32 name = i;
+    while (i < len && !is_blank(line[i])) i++;
+    U32 name_end = i;
+    while (i < len && is_blank(line[i])) i++;
+    if (i != len) return FALSE;
+
+    // Only the low 32 bits matter, 64-bit hosts print 16 digits
+    U32 addr = 0;
+    for (U32 k = hex; k < hex_end; k++) {
+        U8 h = line[k];
+        addr = (addr << 4) | (h <= '9' ? h - '0' : (h | 0x20) - 'a' + 10);
+    }
+    line[name_end] = '\0';
+    out->addr = addr;
+    out->name = &line[name];
+    out->hits = 0;
+    return TRUE;
+}
+
+// Returns the symbol count, *syms is MAlloc'd and sorted by address
+static U32 load_map(FILE *file, SYMBOL **syms) {
+    PU8 data = (PU8)file->data;
+    U32 sz = file->sz;
+    U32 cap = 0;
+    for (U32 i = 0; i < sz; i++) if (data[i] == '\n') cap++;
+    *syms = MAlloc((cap + 1) * sizeof(SYMBOL));
+    if (!*syms) return 0;
+
+    // ld terminates every line, so each name can be cut at its '\n' or '\r'
+    U32 n = 0, start = 0;
+    for (U32 i = 0; i < sz && n < cap; i++) {
+        if (data[i] != '\n') continue;
+        U32 len = i - start;
+        if (len && data[start + len - 1] == '\r') len--;
+        if (parse_symbol_line(&data[start], len, &(*syms)[n])) n++;
+        start = i + 1;
+    }
+
+    // ld already emits most symbols in address order, insertion sort is cheap
+    for (U32 i = 1; i < n; i++) {
+        SYMBOL s = (*syms)[i];
+        U32 j = i;
+        while (j && (*syms)[j - 1].addr > s.addr) {
+            (*syms)[j] = (*syms)[j - 1];
+            j--;
+        }
+        (*syms)[j] = s;
+    }
+    return n;
+}
+
+// Index of the last symbol at or below addr, n if there is none
+static U32 find_symbol(SYMBOL *syms, U32 n, U32 addr) {
+    U32 lo = 0, hi = n;
+    while (lo < hi) {
+        U32 mid = lo + (hi - lo) / 2;
+        if (syms[mid].addr <= addr) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo ? lo - 1 : n;
+}
+
+static VOID print_row(U32 hits, U32 total, PU8 what) {
+    U32 permille = total ? (hits * 1000 + total / 2) / total : 0;
+    printf("%7d  %3d.%d%%  %s\n", hits, permille / 10, permille % 10, what);
+}
+
+CMAIN() {
+    if (argc < 2) {
+        HELP_MESSAGE();
+        return 1;
+    }
+    for (U32 i = 1; i < argc; i++) {
+        if (STRCMP(argv[i], "-h") == 0 || STRCMP(argv[i], "--help") == 0) {
+            HELP_MESSAGE();
+            return 0;
+        }
+    }
+
+    U32 pid = 0, seconds = DEFAULT_SECONDS;
+    if (!ATOI_E(argv[1], &pid) || !pid) {
+        printf("prof: invalid pid '%s'\n", argv[1]);
+        return 1;
+    }
+    if (argc > 2 && (!ATOI_E(argv[2], &seconds) || !seconds)) {
+        printf("prof: invalid duration '%s'\n", argv[2]);
+        return 1;
+    }
+
+    TCB *target = GET_TCB_BY_PID(pid);
+    if (!target) {
+        printf("prof: no process with pid %d\n", pid);
+        return 1;
+    }
+    U8 map_path[TASK_NAME_MAX_LEN + 4];
+    if (argc > 3) {
+        STRNCPY(map_path, argv[3], sizeof(map_path) - 1);
+    } else {
+        STRNCPY(map_path, target->info.name, sizeof(map_path) - 1);
+        PU8 dot = STRRCHR(map_path, '.');
+        if (dot) *dot = '\0';
+        STRCAT(map_path, ".MAP");
+    }
+    map_path[sizeof(map_path) - 1] = '\0';
+    printf("Profiling %s (pid %d) for %d s...\n", target->info.name, pid, seconds);
+    FREE_TCB(target);
+
+    if (!PROFILE_START(pid, 0)) {
+        printf("prof: cannot profile pid %d\n", pid);
+        return 1;
+    }
+    CPU_SLEEP(seconds * 1000);
+    PROC_PROFILE *p = PROFILE_READ(pid);
+    PROFILE_STOP(pid);
+    if (!p) {
+        printf("prof: process %d exited\n", pid);
+        return 1;
+    }
+    if (!p->samples) {
+        printf("No samples: the process did not run.\n");
+        MFree(p);
+        return 0;
+    }
+
+    SYMBOL *syms = NULLPTR;
+    U32 nsyms = 0;
+    FILE *map = FOPEN(map_path, MODE_FR);
+    if (map) nsyms = load_map(map, &syms);
+    else printf("prof: no map '%s', showing raw addresses\n", map_path);
+
+    U32 unknown = 0;
+    for (U32 i = 0; i < p->bucket_count; i++) {
+        if (!p->buckets[i]) continue;
+        U32 s = find_symbol(syms, nsyms, p->base + (i << p->shift));
+        if (s < nsyms) syms[s].hits += p->buckets[i];
+        else unknown += p->buckets[i];
+    }
+
+    printf("\n%d samples, %d bytes per bucket\n", p->samples, 1 << p->shift);
+    printf("%7s  %6s  %s\n", "SAMPLES", "SHARE", "FUNCTION");
+    for (U32 shown = 0; shown < TOP_COUNT; shown++) {
+        U32 best = nsyms;
+        for (U32 i = 0; i < nsyms; i++) {
+            if (syms[i].hits && (best == nsyms || syms[i].hits > syms[best].hits)) best = i;
+        }
+        if (best == nsyms) break;
+        print_row(syms[best].hits, p->samples, syms[best].name);
+        syms[best].hits = 0;
+    }
+    if (!nsyms) {
+        // Without symbols, list the hottest buckets instead
+        U8 label[32];
+        for (U32 shown = 0; shown < TOP_COUNT; shown++) {
+            U32 best = p->bucket_count;
+            for (U32 i = 0; i < p->bucket_count; i++) {
+                if (p->buckets[i] && (best == p->bucket_count || p->buckets[i] > p->buckets[best])) best = i;
+            }
+            if (best == p->bucket_count) break;
+            SPRINTF(label, "0x%08X", p->base + (best << p->shift));
+            print_row(p->buckets[best], p->samples, label);
+            p->buckets[best] = 0;
+        }
+    } else if (unknown) {
+        print_row(unknown, p->samples, "[before first symbol]");
+    }
+    if (p->outside) print_row(p->outside, p->samples, "[kernel / outside binary]");
+
+    if (syms) MFree(syms);
+    if (map) FCLOSE(map);
+    MFree(p);
+    return 0;
+}
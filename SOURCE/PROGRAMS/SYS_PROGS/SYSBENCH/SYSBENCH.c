@@ -0,0 +1,525 @@
+/*
+ * SYSBENCH.c — Micro-benchmarks of core system operations
+ *
+ * Uses the STD/BENCH harness to time a syscall round trip (through SYSCALL()
+ * and through int 0x80 and SYSENTER directly), the memory and string helpers,
+ * the user heap and the shared SYSINFO page. A YIELD round trip covers the
+ * task switches and CR3 loads in between. The draw cases render the same
+ * frame with one syscall per primitive and through a DRAW_BATCH, and report
+ * primitives per second for both. The text cases fill 32 lines of 128
+ * characters and report characters per second.
+ *
+ * SYSBENCH --ipc starts a second copy of itself as a message sink and
+ * streams 16 MB to it twice: as message data the kernel copies, and as
+ * shared memory regions moved in messages and handed back for reuse.
+ *
+ * SYSBENCH --pipe starts a copy that reads a pipe as its stdin. It reports
+ * the CPU time the copy uses while it waits for a message, polling and
+ * blocked in RECEIVE_MESSAGE, and how fast 16 MB go through the pipe.
+ */
+#include <STD/TYPEDEF.h>
+#include <STD/IO.h>
+#include <STD/MEM.h>
+#include <STD/STRING.h>
+#include <STD/TIME.h>
+#include <STD/SYSINFO.h>
+#include <STD/BENCH.h>
+#include <STD/GRAPHICS.h>
+#include <STD/PROC_COM.h>
+#include <STD/SHM.h>
+#include <STD/PIPE.h>
+#include <STD/FS_DISK.h>
+#include <STD/TASK.h>
+#include <CPU/SYSCALL/SYSCALL.h>
+
+#define DEFAULT_RUNS 1000
+#define BUF_SIZE     4096
+#define DRAW_RECTS   256
+#define DRAW_STRINGS 64
+#define TEXT_LINES   32
+#define TEXT_COLS    128
+
+#define IPC_CHUNK      (64 * 1024)
+#define IPC_TOTAL      (16 * 1024 * 1024)
+#define IPC_REGIONS    8
+#define IPC_START_MS   5000
+
+// Messages between SYSBENCH --ipc and its sink (user types start at 0x100000)
+#define IPC_MSG_READY  0x100100 // sink -> bench
+#define IPC_MSG_COPY   0x100101 // bench -> sink, data copied by the kernel
+#define IPC_MSG_SHM    0x100102 // both ways, region moved. signal = bytes used
+#define IPC_MSG_FLUSH  0x100103 // bench -> sink, answered with IPC_MSG_DONE
+#define IPC_MSG_DONE   0x100104 // sink -> bench, signal = bytes received since the last flush
+#define IPC_MSG_QUIT   0x100105
+
+#define PIPE_IDLE_MS   2000
+
+// Messages between SYSBENCH --pipe and its reader
+#define PIPE_MSG_READY 0x100110 // reader -> bench, signal = its pid
+#define PIPE_MSG_POLL  0x100111 // bench -> reader: wait PIPE_IDLE_MS polling GET_MESSAGE
+#define PIPE_MSG_BLOCK 0x100112 // bench -> reader: wait PIPE_IDLE_MS in RECEIVE_MESSAGE
+#define PIPE_MSG_IDLE  0x100113 // reader -> bench, signal = CPU ms used while waiting
+#define PIPE_MSG_DRAIN 0x100114 // bench -> reader: read stdin to its end
+#define PIPE_MSG_DONE  0x100115 // reader -> bench, signal = bytes read
+
+static U8 src_buf[BUF_SIZE];
+static U8 dst_buf[BUF_SIZE];
+static U8 text[257];
+static U8 text_line[TEXT_COLS + 1];
+
+static U0 HELP_MESSAGE(VOID) {
+    printf(
+        #include "SYSBENCH.HELP"
+    );
+}
+
+static VOID bench_null_syscall(VOIDPTR arg) { (void)arg; SYSCALL0(SYSCALL_NULL); }
+static VOID bench_null_int80(VOIDPTR arg)   { (void)arg; SYSCALL_INT(SYSCALL_NULL, 0, 0, 0, 0, 0); }
+static VOID bench_null_sysenter(VOIDPTR arg) { (void)arg; SYSCALL_SYSENTER(SYSCALL_NULL, 0, 0, 0, 0, 0); }
+static VOID bench_memcpy(VOIDPTR arg)       { (void)arg; MEMCPY(dst_buf, src_buf, BUF_SIZE); }
+static VOID bench_memcpy_opt(VOIDPTR arg)   { (void)arg; MEMCPY_OPT(dst_buf, src_buf, BUF_SIZE); }
+static VOID bench_memset(VOIDPTR arg)       { (void)arg; MEMSET(dst_buf, 0xA5, BUF_SIZE); }
+static VOID bench_strlen(VOIDPTR arg)       { (void)arg; STRLEN(text); }
+static VOID bench_uptime(VOIDPTR arg)       { (void)arg; GET_UPTIME_MS(); }
+static VOID bench_yield(VOIDPTR arg)        { (void)arg; YIELD(); }
+
+static VOID bench_malloc_free(VOIDPTR arg) {
+    (void)arg;
+    VOIDPTR p = MAlloc(64);
+    MFree(p);
+}
+
+static VOID bench_sysinfo_snapshot(VOIDPTR arg) {
+    SYSINFO_SNAPSHOT((SYSINFO_PAGE *)arg);
+}
+
+/* ---- Drawing: the same primitives trapped one by one or batched ---- */
+
+static DRAW_BATCH draw_batch;
+
+static VOID draw_rects(VOID) {
+    for (U32 i = 0; i < DRAW_RECTS; i++)
+        DRAW_FILLED_RECTANGLE((i % 32) * 32, (i / 32) * 32, 24, 24, VBE_COLOUR(i, 255 - i, 128));
+}
+
+static VOID draw_strings(VOID) {
+    for (U32 i = 0; i < DRAW_STRINGS; i++)
+        DRAW_8x8_STRING(8, i * 10, "atOS draw bench!", VBE_WHITE, VBE_BLACK);
+}
+
+static VOID draw_text(VOID) {
+    for (U32 i = 0; i < TEXT_LINES; i++)
+        DRAW_8x8_STRING(0, 400 + i * 8, text_line, VBE_GREEN, VBE_BLACK);
+}
+
+static VOID bench_rects_syscall(VOIDPTR arg)   { (void)arg; draw_rects(); }
+static VOID bench_strings_syscall(VOIDPTR arg) { (void)arg; draw_strings(); }
+static VOID bench_text_syscall(VOIDPTR arg)    { (void)arg; draw_text(); }
+
+static VOID bench_rects_batched(VOIDPTR arg) {
+    (void)arg;
+    DRAW_BATCH_BEGIN(&draw_batch);
+    draw_rects();
+    DRAW_BATCH_END();
+}
+
+static VOID bench_strings_batched(VOIDPTR arg) {
+    (void)arg;
+    DRAW_BATCH_BEGIN(&draw_batch);
+    draw_strings();
+    DRAW_BATCH_END();
+}
+
+static VOID bench_text_batched(VOIDPTR arg) {
+    (void)arg;
+    DRAW_BATCH_BEGIN(&draw_batch);
+    draw_text();
+    DRAW_BATCH_END();
+}
+
+static U8 ipc_buf[IPC_CHUNK];
+static U32 ipc_pool[IPC_REGIONS];
+static U32 ipc_pool_count;
+static volatile U32 ipc_sum;
+
+static VOID ipc_send(PROC_MESSAGE *msg) {
+    while (!SEND_MESSAGE(msg)) YIELD();
+}
+
+// Reads a word per 4 KB page, so the receiver really touches the data
+static VOID ipc_touch(PU8 p, U32 len) {
+    for (U32 i = 0; i + 4 <= len; i += 4096) ipc_sum += *(U32 *)(p + i);
+}
+
+static U32 ipc_sink(U32 bench) {
+    PROC_MESSAGE m = CREATE_PROC_MSG(bench, IPC_MSG_READY, NULL, 0, 0);
+    ipc_send(&m);
+    U32 bytes = 0;
+    for (;;) {
+        PROC_MESSAGE *msg = GET_MESSAGE();
+        if (!msg) {
+            YIELD();
+            continue;
+        }
+        switch (msg->type) {
+            case IPC_MSG_COPY:
+                if (msg->data_provided && msg->data) {
+                    ipc_touch(msg->data, msg->data_size);
+                    bytes += msg->data_size;
+                }
+                break;
+            case IPC_MSG_SHM:
+                if (msg->shm) {
+                    ipc_touch(msg->raw_data, msg->signal);
+                    bytes += msg->signal;
+                    m = CREATE_PROC_MSG_SHM(bench, IPC_MSG_SHM, msg->shm, 0);
+                    ipc_send(&m);
+                }
+                break;
+            case IPC_MSG_FLUSH:
+                m = CREATE_PROC_MSG(bench, IPC_MSG_DONE, NULL, 0, bytes);
+                ipc_send(&m);
+                bytes = 0;
+                break;
+            case IPC_MSG_QUIT:
+                FREE_MESSAGE(msg);
+                return 0;
+        }
+        FREE_MESSAGE(msg);
+    }
+}
+
+// Handles one message from the sink, or yields if there is none. Regions
+// coming back go to the pool. TRUE if it was of `type`
+static BOOLEAN ipc_take(U32 type, U32 *signal) {
+    PROC_MESSAGE *msg = GET_MESSAGE();
+    if (!msg) {
+        YIELD();
+        return FALSE;
+    }
+    BOOLEAN hit = msg->type == type;
+    if (msg->type == IPC_MSG_SHM && msg->shm && ipc_pool_count < IPC_REGIONS)
+        ipc_pool[ipc_pool_count++] = msg->shm;
+    if (hit && signal) *signal = msg->signal;
+    FREE_MESSAGE(msg);
+    return hit;
+}
+
+static VOID ipc_copy_stream(U32 sink) {
+    for (U32 sent = 0; sent < IPC_TOTAL; sent += IPC_CHUNK) {
+        PROC_MESSAGE m = CREATE_PROC_MSG(sink, IPC_MSG_COPY, ipc_buf, IPC_CHUNK, 0);
+        ipc_send(&m);
+    }
+}
+
+static VOID ipc_shm_stream(U32 sink) {
+    for (U32 sent = 0; sent < IPC_TOTAL; sent += IPC_CHUNK) {
+        while (!ipc_pool_count) ipc_take(IPC_MSG_SHM, NULLPTR);
+        PROC_MESSAGE m = CREATE_PROC_MSG_SHM(sink, IPC_MSG_SHM, ipc_pool[--ipc_pool_count], IPC_CHUNK);
+        ipc_send(&m);
+    }
+}
+
+static VOID ipc_report(PU8 name, VOID (*stream)(U32), U32 sink) {
+    U32 t0 = GET_UPTIME_MS();
+    stream(sink);
+    PROC_MESSAGE m = CREATE_PROC_MSG(sink, IPC_MSG_FLUSH, NULL, 0, 0);
+    ipc_send(&m);
+    U32 bytes = 0;
+    while (!ipc_take(IPC_MSG_DONE, &bytes)) ;
+    U32 ms = GET_UPTIME_MS() - t0;
+    if (!ms) ms = 1;
+    printf("%-24s %d KB in %d ms, %d MB/s\n", name, bytes / 1024, ms, (bytes / 1024) * 1000 / ms / 1024);
+}
+
+static U32 ipc_bench(PU8 self) {
+    FILE *f = FOPEN(self, MODE_FR);
+    if (!f) {
+        printf("sysbench: cannot read %s\n", self);
+        return 1;
+    }
+    U8 pid[12];
+    ITOA_U(PROC_GETPID(), pid, 10);
+    PPU8 argv = MAlloc(3 * sizeof(PU8)); // freed by the kernel with the strings
+    argv[0] = STRDUP(self);
+    argv[1] = STRDUP("--ipc-sink");
+    argv[2] = STRDUP(pid);
+    START_PROCESS(self, f->data, f->sz, TCB_STATE_ACTIVE, PROC_GETPPID(), argv, 3);
+
+    U32 sink = 0, t0 = GET_UPTIME_MS();
+    while (!sink && GET_UPTIME_MS() - t0 < IPC_START_MS) {
+        PROC_MESSAGE *msg = GET_MESSAGE();
+        if (!msg) {
+            YIELD();
+            continue;
+        }
+        if (msg->type == IPC_MSG_READY) sink = msg->sender_pid;
+        FREE_MESSAGE(msg);
+    }
+    FCLOSE(f);
+    if (!sink) {
+        printf("sysbench: the IPC sink did not start\n");
+        return 1;
+    }
+
+    for (U32 i = 0; i < IPC_CHUNK; i++) ipc_buf[i] = (U8)i;
+    ipc_pool_count = 0;
+    for (U32 i = 0; i < IPC_REGIONS; i++) {
+        U32 h = SHM_CREATE(NULLPTR, IPC_CHUNK);
+        if (!h) break;
+        MEMCPY(SHM_ADDR(h), ipc_buf, IPC_CHUNK);
+        ipc_pool[ipc_pool_count++] = h;
+    }
+
+    printf("Streaming %d KB in %d KB messages to pid %d:\n", IPC_TOTAL / 1024, IPC_CHUNK / 1024, sink);
+    ipc_report("copied message data", ipc_copy_stream, sink);
+    if (ipc_pool_count == IPC_REGIONS) {
+        ipc_report("moved SHM regions", ipc_shm_stream, sink);
+    } else {
+        printf("%-24s no shared memory\n", "moved SHM regions");
+    }
+
+    PROC_MESSAGE m = CREATE_PROC_MSG(sink, IPC_MSG_QUIT, NULL, 0, 0);
+    ipc_send(&m);
+    // The sink hands every region back before it answers a flush
+    for (U32 i = 0; i < ipc_pool_count; i++) SHM_CLOSE(ipc_pool[i]);
+    return 0;
+}
+
+static U32 own_cpu_ms(VOID) {
+    TCB *t = GET_CURRENT_TCB();
+    U32 ms = t ? t->info.cpu_time : 0;
+    FREE_TCB(t);
+    return ms;
+}
+
+static VOID pipe_reply(U32 bench, U32 type, U32 signal) {
+    PROC_MESSAGE m = CREATE_PROC_MSG(bench, type, NULL, 0, signal);
+    ipc_send(&m);
+}
+
+// Waits PIPE_IDLE_MS for a message that never comes, the way main loops
+// did before RECEIVE_MESSAGE, or parked in it
+static U32 pipe_idle(BOOLEAN blocking) {
+    U32 cpu = own_cpu_ms();
+    U32 end = GET_UPTIME_MS() + PIPE_IDLE_MS;
+    U32 now;
+    while ((now = GET_UPTIME_MS()) < end) {
+        PROC_MESSAGE *msg = blocking ? RECEIVE_MESSAGE(end - now) : GET_MESSAGE();
+        if (msg) FREE_MESSAGE(msg);
+        else if (!blocking) YIELD();
+    }
+    return own_cpu_ms() - cpu;
+}
+
+static U32 pipe_reader(U32 bench) {
+    pipe_reply(bench, PIPE_MSG_READY, PROC_GETPID());
+    for (;;) {
+        PROC_MESSAGE *msg = RECEIVE_MESSAGE(U32_MAX);
+        if (!msg) continue;
+        U32 type = msg->type;
+        FREE_MESSAGE(msg);
+        switch (type) {
+            case PIPE_MSG_POLL:
+            case PIPE_MSG_BLOCK:
+                pipe_reply(bench, PIPE_MSG_IDLE, pipe_idle(type == PIPE_MSG_BLOCK));
+                break;
+            case PIPE_MSG_DRAIN: {
+                U32 bytes = 0, n;
+                while ((n = STDIN_READ(ipc_buf, IPC_CHUNK)) > 0) {
+                    ipc_touch(ipc_buf, n);
+                    bytes += n;
+                }
+                pipe_reply(bench, PIPE_MSG_DONE, bytes);
+                return 0;
+            }
+        }
+    }
+}
+
+// Next message of `type` from the reader, or FALSE after `timeout_ms`
+static BOOLEAN pipe_expect(U32 type, U32 timeout_ms, U32 *signal) {
+    U32 end = GET_UPTIME_MS() + timeout_ms;
+    U32 now;
+    while ((now = GET_UPTIME_MS()) < end) {
+        PROC_MESSAGE *msg = RECEIVE_MESSAGE(end - now);
+        if (!msg) continue;
+        BOOLEAN hit = msg->type == type;
+        if (hit && signal) *signal = msg->signal;
+        FREE_MESSAGE(msg);
+        if (hit) return TRUE;
+    }
+    return FALSE;
+}
+
+static U32 pipe_bench(PU8 self) {
+    FILE *f = FOPEN(self, MODE_FR);
+    if (!f) {
+        printf("sysbench: cannot read %s\n", self);
+        return 1;
+    }
+    U32 pipe = PIPE_CREATE();
+    if (!pipe) {
+        FCLOSE(f);
+        printf("sysbench: cannot create a pipe\n");
+        return 1;
+    }
+    U8 pid[12];
+    ITOA_U(PROC_GETPID(), pid, 10);
+    PPU8 argv = MAlloc(3 * sizeof(PU8)); // freed by the kernel with the strings
+    argv[0] = STRDUP(self);
+    argv[1] = STRDUP("--pipe-reader");
+    argv[2] = STRDUP(pid);
+    // The read end goes to the reader, the write end stays here
+    START_PROCESS_PIPED(self, f->data, f->sz, TCB_STATE_ACTIVE, PROC_GETPPID(), argv, 3, pipe, 0);
+
+    U32 reader = 0;
+    pipe_expect(PIPE_MSG_READY, IPC_START_MS, &reader);
+    FCLOSE(f);
+    if (!reader) {
+        PIPE_CLOSE(pipe, PIPE_END_BOTH);
+        printf("sysbench: the pipe reader did not start\n");
+        return 1;
+    }
+
+    printf("Reader pid %d waiting %d ms for a message:\n", reader, PIPE_IDLE_MS);
+    static CONST struct { PU8 name; U32 type; } idle[] = {
+        { "polling GET_MESSAGE",    PIPE_MSG_POLL },
+        { "blocked RECEIVE_MESSAGE", PIPE_MSG_BLOCK },
+    };
+    for (U32 i = 0; i < sizeof(idle) / sizeof(idle[0]); i++) {
+        pipe_reply(reader, idle[i].type, 0);
+        U32 cpu = 0;
+        if (!pipe_expect(PIPE_MSG_IDLE, PIPE_IDLE_MS + IPC_START_MS, &cpu)) {
+            printf("%-24s no answer\n", idle[i].name);
+            continue;
+        }
+        printf("%-24s %d ms CPU, %d%%\n", idle[i].name, cpu, cpu * 100 / PIPE_IDLE_MS);
+    }
+
+    for (U32 i = 0; i < IPC_CHUNK; i++) ipc_buf[i] = (U8)i;
+    U32 t0 = GET_UPTIME_MS();
+    pipe_reply(reader, PIPE_MSG_DRAIN, 0);
+    U32 sent = 0;
+    while (sent < IPC_TOTAL) {
+        U32 n = PIPE_WRITE(pipe, ipc_buf, IPC_CHUNK);
+        sent += n;
+        if (n < IPC_CHUNK) break; // the reader went away
+    }
+    PIPE_CLOSE(pipe, PIPE_END_WRITE); // end of stream for the reader
+    U32 bytes = 0;
+    if (!pipe_expect(PIPE_MSG_DONE, IPC_START_MS, &bytes)) {
+        printf("%-24s no answer\n", "pipe stream");
+        return 1;
+    }
+    U32 ms = GET_UPTIME_MS() - t0;
+    if (!ms) ms = 1;
+    printf("%-24s %d KB in %d ms, %d MB/s (%d KB ring)\n", "pipe stream", bytes / 1024, ms,
+           (bytes / 1024) * 1000 / ms / 1024, PIPE_BUFFER_SIZE / 1024);
+    return 0;
+}
+
+typedef struct {
+    PU8 name;
+    BENCH_FN fn;
+} BENCH_CASE;
+
+typedef struct {
+    PU8 name;
+    BENCH_FN fn;
+    U32 ops;
+} DRAW_CASE;
+
+CMAIN() {
+    U32 runs = DEFAULT_RUNS;
+    for (U32 i = 1; i < argc; i++) {
+        if (STRCMP(argv[i], "-h") == 0 || STRCMP(argv[i], "--help") == 0) {
+            HELP_MESSAGE();
+            return 0;
+        }
+    }
+    if (argc > 2 && STRCMP(argv[1], "--ipc-sink") == 0) {
+        U32 bench = 0;
+        return ATOI_E(argv[2], &bench) ? ipc_sink(bench) : 1;
+    }
+    if (argc > 1 && STRCMP(argv[1], "--ipc") == 0) return ipc_bench(argv[0]);
+    if (argc > 2 && STRCMP(argv[1], "--pipe-reader") == 0) {
+        U32 bench = 0;
+        return ATOI_E(argv[2], &bench) ? pipe_reader(bench) : 1;
+    }
+    if (argc > 1 && STRCMP(argv[1], "--pipe") == 0) return pipe_bench(argv[0]);
+    if (argc > 1 && (!ATOI_E(argv[1], &runs) || !runs)) {
+        printf("sysbench: invalid run count '%s'\n", argv[1]);
+        return 1;
+    }
+    if (!TSC_KHZ()) {
+        printf("sysbench: no calibrated TSC\n");
+        return 1;
+    }
+
+    for (U32 i = 0; i < BUF_SIZE; i++) src_buf[i] = (U8)i;
+    MEMSET(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    for (U32 i = 0; i < TEXT_COLS; i++) text_line[i] = (U8)('!' + i % 94);
+    text_line[TEXT_COLS] = '\0';
+
+    SYSINFO_PAGE si;
+    BENCH_CASE cases[] = {
+        { "null syscall",         bench_null_syscall },
+        { "null syscall, int 0x80", bench_null_int80 },
+        { "null syscall, SYSENTER", bench_null_sysenter },
+        { "MEMCPY 4 KB",          bench_memcpy },
+        { "MEMCPY_OPT 4 KB",      bench_memcpy_opt },
+        { "MEMSET 4 KB",          bench_memset },
+        { "STRLEN 256",           bench_strlen },
+        { "MAlloc+MFree 64",      bench_malloc_free },
+        { "SYSINFO_SNAPSHOT",     bench_sysinfo_snapshot },
+        { "GET_UPTIME_MS",        bench_uptime },
+        { "YIELD round trip",     bench_yield },
+    };
+
+    BOOLEAN sysenter = (SYSINFO_GET()->features & SYSINFO_FEATURE_SYSENTER) != 0;
+    U32 features = SYSINFO_GET()->features;
+    printf("TSC: %d kHz, %d runs each, syscalls via %s\n", TSC_KHZ(), runs, sysenter ? "SYSENTER" : "int 0x80");
+    printf("Paging: %s pages, %s kernel mappings\n", (features & SYSINFO_FEATURE_LARGE_PAGES) ? "4 MB and 4 KB" : "4 KB",
+           (features & SYSINFO_FEATURE_GLOBAL_PAGES) ? "global" : "non-global");
+    for (U32 i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        BENCH_RESULT r;
+        if (cases[i].fn == bench_null_sysenter && !sysenter) {
+            printf("%-24s unsupported\n", cases[i].name);
+            continue;
+        }
+        if (!BENCH_RUN(cases[i].fn, &si, runs, &r)) {
+            printf("%-24s failed\n", cases[i].name);
+            continue;
+        }
+        BENCH_PRINT(cases[i].name, &r);
+    }
+
+    if (!DRAW_BATCH_INIT(&draw_batch, 0)) {
+        printf("sysbench: out of memory\n");
+        return 1;
+    }
+    DRAW_CASE draws[] = {
+        { "256 rects, syscalls",   bench_rects_syscall,   DRAW_RECTS },
+        { "256 rects, batched",    bench_rects_batched,   DRAW_RECTS },
+        { "64 strings, syscalls",  bench_strings_syscall, DRAW_STRINGS },
+        { "64 strings, batched",   bench_strings_batched, DRAW_STRINGS },
+        { "4096 chars, syscalls",  bench_text_syscall,    TEXT_LINES * TEXT_COLS },
+        { "4096 chars, batched",   bench_text_batched,    TEXT_LINES * TEXT_COLS },
+    };
+    printf("\nDraw primitives per second (median):\n");
+    for (U32 i = 0; i < sizeof(draws) / sizeof(draws[0]); i++) {
+        BENCH_RESULT r;
+        if (!BENCH_RUN(draws[i].fn, NULLPTR, runs, &r)) {
+            printf("%-24s failed\n", draws[i].name);
+            continue;
+        }
+        U32 us = r.median_ns / 1000;
+        if (!us) us = 1;
+        BENCH_PRINT(draws[i].name, &r);
+        printf("%-24s %d ops/s\n", "", draws[i].ops * 1000000 / us);
+    }
+    DRAW_BATCH_FREE(&draw_batch);
+    return 0;
+}
@@ -7,6 +7,7 @@
 #include <STD/STRING.h>
 #include <STD/MEM.h>
 #include <STD/DEBUG.h>
+#include <STD/SYSINFO.h>
 
 PATGL_NODE task_list;
 PATGL_NODE header_label;
@@ -14,6 +15,7 @@ PATGL_NODE proc_header;
 PATGL_NODE perf_panel;
 PATGL_NODE perf_heap_label;
 PATGL_NODE perf_tasks_label;
+PATGL_NODE perf_system_label;
 
 PATGL_NODE btn_tab_proc;
 PATGL_NODE btn_tab_perf;
@@ -27,6 +29,16 @@ TCB *master_tcb;
 U32 active_pids[ACTIVE_PID_MAX_COUNT];
 U32 active_pid_count = 0;
 
+// ticks_run of every task at the previous refresh, for CPU%
+typedef struct {
+    U32 pid;
+    U32 ticks_run;
+} TASK_SAMPLE;
+
+TASK_SAMPLE last_samples[ACTIVE_PID_MAX_COUNT];
+U32 last_sample_count = 0;
+U32 last_sample_tick = 0;
+
 typedef enum {
     TAB_PROCESSES,
     TAB_PERFORMANCE
@@ -34,8 +46,19 @@ typedef enum {
 
 TMAN_TAB current_tab = TAB_PROCESSES;
 
+static U32 previous_ticks_run(U32 pid)
+{
+    for (U32 i = 0; i < last_sample_count; i++) {
+        if (last_samples[i].pid == pid) return last_samples[i].ticks_run;
+    }
+    return 0;
+}
+
 static VOID refresh_tasks(VOID)
 {
+    // Keep the selection across the periodic refresh
+    U32 selected = task_list->data.listbox.selected;
+    U32 scroll_offset = task_list->data.listbox.scroll_offset;
     if (current_tab == TAB_PROCESSES) {
         ATGL_LISTBOX_CLEAR(task_list);
     }
@@ -43,20 +66,33 @@ static VOID refresh_tasks(VOID)
     
     if (!master_tcb) return;
 
+    SYSINFO_PAGE si;
+    SYSINFO_SNAPSHOT(&si);
+    U32 elapsed = si.ticks - last_sample_tick;
+
     TCB *current = master_tcb;
     U32 total_alloc_pages = 0;
+    U32 busiest_pid = 0, busiest_pct = 0;
 
     U32 last_pid = 0;
     
     do {
         U32 mem_pages = current->binary_pages + current->heap_pages + current->stack_pages + current->framebuffer_pages;
         total_alloc_pages += mem_pages;
+
+        U32 ran = current->info.ticks_run - previous_ticks_run(current->info.pid);
+        U32 cpu_pct = elapsed ? (ran * 100 + elapsed / 2) / elapsed : 0;
+        if (cpu_pct > 100) cpu_pct = 100;
+        if (current->info.pid != KERNEL_PID && cpu_pct > busiest_pct) {
+            busiest_pct = cpu_pct;
+            busiest_pid = current->info.pid;
+        }
         
         if (current_tab == TAB_PROCESSES) {
             CHAR buf[256];
             PU8 state_str = (PU8)"Unknown";
             if(current->info.state & TCB_STATE_INFO_CHILD_PROC_HANDLER) state_str = (PU8)"Shell";
-            else if (current->info.state & TCB_STATE_ACTIVE) state_str = (PU8)"Active";
+            else if (current->info.state & TCB_STATE_ACTIVE) state_str = current->wait_reason ? (PU8)"Blocked" : (PU8)"Active";
             else if (current->info.state & TCB_STATE_WAITING) state_str = (PU8)"Waiting";
             else if (current->info.state & TCB_STATE_SLEEPING) state_str = (PU8)"Sleeping";
             else if (current->info.state & TCB_STATE_ZOMBIE) state_str = (PU8)"Zombie";
@@ -68,13 +104,16 @@ static VOID refresh_tasks(VOID)
 
             U32 heap_allocated = current->info.heap_allocated;
             
-            SNPRINTF(buf, sizeof(buf), " %-5d | %-20s | %-8s | %5d KB, %5d KB | %-8d | %d |", 
-                     current->info.pid, current->info.name, state_str, mem_kb, heap_allocated / 1024, current->info.cpu_time, current->info.num_switches);
+            SNPRINTF(buf, sizeof(buf), " %-5d | %-20s | %-8s | %5d KB, %5d KB | %3d%% | %-8d | %-8d | %d/%d |", 
+                     current->info.pid, current->info.name, state_str, mem_kb, heap_allocated / 1024, cpu_pct, current->info.cpu_time / 1000,
+                     current->info.syscalls, current->info.voluntary_switches, current->info.involuntary_switches);
             
             ATGL_LISTBOX_ADD_ITEM(task_list, (PU8)buf);
         }
         
         if (active_pid_count < ACTIVE_PID_MAX_COUNT) {
+            last_samples[active_pid_count].pid = current->info.pid;
+            last_samples[active_pid_count].ticks_run = current->info.ticks_run;
             active_pids[active_pid_count++] = current->info.pid;
         }
         
@@ -82,16 +121,28 @@ static VOID refresh_tasks(VOID)
         current = current->next;
     } while(current != master_tcb && current != NULL && current->info.pid > last_pid); // Added check to prevent infinite loop in case of corrupted list
 
-    if (current_tab == TAB_PERFORMANCE) {
-        KHeap *kheap = GET_KERNEL_HEAP_INFO();
-        if (kheap) {
-            CHAR hbuf[128];
-            SNPRINTF(hbuf, sizeof(hbuf), "Kernel Heap: %d KB Free / %d KB Total", kheap->freeSize / 1024, kheap->totalSize / 1024);
-            ATGL_NODE_SET_TEXT(perf_heap_label, (PU8)hbuf);
+    last_sample_count = active_pid_count;
+    last_sample_tick = si.ticks;
+
+    if (current_tab == TAB_PROCESSES) {
+        if (selected < task_list->data.listbox.item_count) {
+            task_list->data.listbox.selected = selected;
+            task_list->data.listbox.scroll_offset = scroll_offset;
         }
+    }
+
+    if (current_tab == TAB_PERFORMANCE) {
+        CHAR hbuf[128];
+        SNPRINTF(hbuf, sizeof(hbuf), "Kernel Heap: %d KB Free / %d KB Total", si.kheap_free / 1024, si.kheap_total / 1024);
+        ATGL_NODE_SET_TEXT(perf_heap_label, (PU8)hbuf);
+
+        SNPRINTF(hbuf, sizeof(hbuf), "RAM: %d KB Free / %d KB Used | Uptime: %d s | Context switches: %d",
+                 si.ram_free / 1024, si.ram_used / 1024, si.uptime_ms / 1000, si.context_switches);
+        ATGL_NODE_SET_TEXT(perf_system_label, (PU8)hbuf);
         
         CHAR tbuf[128];
-        SNPRINTF(tbuf, sizeof(tbuf), "Processes: %d | App Memory Alloc: %d KB", active_pid_count, total_alloc_pages * 4);
+        SNPRINTF(tbuf, sizeof(tbuf), "Processes: %d | App Memory Alloc: %d KB | Busiest: PID %d at %d%% CPU",
+                 active_pid_count, total_alloc_pages * 4, busiest_pid, busiest_pct);
         ATGL_NODE_SET_TEXT(perf_tasks_label, (PU8)tbuf);
     }
 }
@@ -183,7 +234,7 @@ CMAIN()
     // Processes Column Header
     proc_header = ATGL_CREATE_PANEL(root, (ATGL_RECT){0, 40, width, 24}, ATGL_LAYOUT_HORIZONTAL, 4, 8);
     ATGL_NODE_SET_COLORS(proc_header, RGB(255, 255, 255), RGB(80, 80, 80));
-    ATGL_CREATE_LABEL(proc_header, (ATGL_RECT){0, 0, width, 24}, (PU8)" PID   | Name                 | State    | ProcMem, HeapMem   | CPU Time | Switches", RGB(220, 220, 220), RGB(80, 80, 80));
+    ATGL_CREATE_LABEL(proc_header, (ATGL_RECT){0, 0, width, 24}, (PU8)" PID   | Name                 | State    | ProcMem, HeapMem   | CPU  | CPU s    | Syscalls | Switches vol/invol", RGB(220, 220, 220), RGB(80, 80, 80));
 
     // Processes Listbox
     task_list = ATGL_CREATE_LISTBOX(root, (ATGL_RECT){0, 64, width, height - 64}, 20);
@@ -191,7 +242,8 @@ CMAIN()
     // Performance Tab Panel
     perf_panel = ATGL_CREATE_PANEL(root, (ATGL_RECT){0, 40, width, height - 40}, ATGL_LAYOUT_VERTICAL, 10, 10);
     perf_heap_label = ATGL_CREATE_LABEL(perf_panel, (ATGL_RECT){0, 0, 400, 24}, (PU8)"Heap info...", RGB(255, 255, 255), VBE_SEE_THROUGH);
-    perf_tasks_label = ATGL_CREATE_LABEL(perf_panel, (ATGL_RECT){0, 0, 400, 24}, (PU8)"Tasks info...", RGB(255, 255, 255), VBE_SEE_THROUGH);
+    perf_tasks_label = ATGL_CREATE_LABEL(perf_panel, (ATGL_RECT){0, 0, 600, 24}, (PU8)"Tasks info...", RGB(255, 255, 255), VBE_SEE_THROUGH);
+    perf_system_label = ATGL_CREATE_LABEL(perf_panel, (ATGL_RECT){0, 0, 600, 24}, (PU8)"System info...", RGB(255, 255, 255), VBE_SEE_THROUGH);
     
     set_tab(TAB_PROCESSES);
     
@@ -211,7 +263,7 @@ void ATGL_GRAPHICS_LOOP(U32 ticks)
 {
     static U32 last_tick = 0;
     if (ticks - last_tick >= 1000) { // Refresh every 1 second
-        // refresh_tasks();
+        refresh_tasks();
         last_tick = ticks;
     }
     ATGL_RENDER_TREE(ATGL_GET_SCREEN_ROOT_NODE());
@@ -6,6 +6,9 @@
  *   - Implemented `if COND then CMD [else CMD] fi`
  *   - Implemented `loop COND` / `end`
  *   - All output via TPUT_* macros (PUTS/PUTC/PUT_DEC/etc.)
+ *
+ * Interactive input is interpreted line by line here; script files are
+ * compiled to bytecode and run by BATSH_VM.c (see RUN_BATSH_FILE).
  */
 
 #include <PROC/PROC.h>
@@ -14,9 +17,13 @@
 #include <STD/AUDIO.h>
 #include <STD/MEM.h>
 #include <STD/PROC_COM.h>
+#include <STD/PIPE.h>
 #include <STD/DEBUG.h>
+#include <STD/TRACE.h>
+#include <STD/COMPORT.h>
 #include <PROGRAMS/SYS_PROGS/TSHELL/TSHELL.h>
 #include <PROGRAMS/SYS_PROGS/TSHELL/BATSH.h>
+#include <PROGRAMS/SYS_PROGS/TSHELL/BATSH_VM.h>
 
 /* ===================================================
  * Internal Shell State
@@ -62,6 +69,7 @@ CMD_FUNC(SHELL);
 CMD_FUNC(RESTART);
 CMD_FUNC(SHUTDOWN);
 CMD_FUNC(SLEEP);
+CMD_FUNC(TRACE);
 #define CMD_NONE NULLPTR
 
 /* =====================================
@@ -192,6 +200,7 @@ static const ShellCommand shell_commands[] ATTRIB_RODATA = {
     { "cd..",      CMD_CD_BACKWARDS,  "Change directory backwards" },
     { "dir",       CMD_DIR,           "List directory contents" },
     { "sleep",     CMD_SLEEP,         "Sleeps for a specified duration: sleep <s>" },
+    { "trace",     CMD_TRACE,         "Kernel event trace: trace [on|off|clear|dump|mark]" },
     { "mkdir",     CMD_NONE,         "Create a directory, -h for help" },
     { "rmdir",     CMD_NONE,         "Remove a directory, -h for help" },
     { "type",      CMD_TYPE,          "Print file contents" },
@@ -274,45 +283,34 @@ U8 BATSH_GET_MODE(VOID) { return batsh_mode; }
  * Variable system
  * =================================================== */
 
-static S32 FIND_VAR(PU8 name) {
+/* The line interpreter stores assignment targets as typed ("@name" or
+   "@{name}"), so a plain name also matches those spellings. */
+static BOOL VAR_NAME_DECORATED(PU8 stored, PU8 name) {
+    if (stored[0] != '@') return FALSE;
+    stored++;
+    if (stored[0] != '{') return STRICMP(stored, name) == 0;
+    U32 n = STRLEN(name);
+    return STRNICMP(stored + 1, name, n) == 0 && stored[n + 1] == '}' && stored[n + 2] == '\0';
+}
+
+static S32 FIND_VAR_IN(ShellVar *vars, U32 count, PU8 name) {
     if (!name) return -1;
-    for (U32 i = 0; i < shell_var_count; i++) {
-        if (STRICMP(name, shell_vars[i].name) == 0) return i;
+    for (U32 i = 0; i < count; i++) {
+        if (STRICMP(name, vars[i].name) == 0) return i;
     }
-    U32 name_len = STRLEN(name);
-
-    PU8 tmp1 = MAlloc(name_len + 2);
-    if (!tmp1) return -1;
-    tmp1[0] = '@';
-    MEMCPY(tmp1 + 1, name, name_len);
-    tmp1[name_len + 1] = '\0';
-    for (U32 i = 0; i < shell_var_count; i++) {
-        if (STRICMP(tmp1, shell_vars[i].name) == 0) {
-            MFree(tmp1);
-            return i;
-        }
+    for (U32 i = 0; i < count; i++) {
+        if (VAR_NAME_DECORATED(vars[i].name, name)) return i;
     }
-
-    PU8 tmp2 = MAlloc(name_len + 4);
-    if (!tmp2) { MFree(tmp1); return -1; }
-    tmp2[0] = '@'; tmp2[1] = '{';
-    MEMCPY(tmp2 + 2, name, name_len);
-    tmp2[name_len + 2] = '}';
-    tmp2[name_len + 3] = '\0';
-    for (U32 i = 0; i < shell_var_count; i++) {
-        if (STRICMP(tmp2, shell_vars[i].name) == 0) {
-            MFree(tmp1); MFree(tmp2);
-            return i;
-        }
-    }
-    MFree(tmp1); MFree(tmp2);
     return -1;
 }
 
+static S32 FIND_VAR(PU8 name) {
+    return FIND_VAR_IN(shell_vars, shell_var_count, name);
+}
+
 VOID SET_VAR(PU8 name, PU8 value) {
     S32 idx = FIND_VAR(name);
-    if (shell_var_count + 1 > MAX_VARS) return;
-    if (idx >= 0 && idx != -1) {
+    if (idx >= 0) {
         STRNCPY(shell_vars[idx].value, value, MAX_VAR_VALUE - 1);
     } else if (shell_var_count < MAX_VARS) {
         STRNCPY(shell_vars[shell_var_count].name, name, MAX_VAR_NAME - 1);
@@ -323,54 +321,25 @@ VOID SET_VAR(PU8 name, PU8 value) {
 
 PU8 GET_VAR(PU8 name) {
     S32 idx = FIND_VAR(name);
-    return (idx >= 0 && idx != -1) ? shell_vars[idx].value : (PU8)NULLPTR;
+    return (idx >= 0) ? shell_vars[idx].value : (PU8)NULLPTR;
 }
 
 static S32 FIND_INST_VAR(PU8 name, BATSH_INSTANCE *inst) {
-    if (!name || !inst) return -1;
-    for (U32 i = 0; i < inst->shell_var_count; i++) {
-        if (STRICMP(name, inst->shell_vars[i].name) == 0) return i;
-    }
-    U32 name_len = STRLEN(name);
-
-    PU8 tmp1 = MAlloc(name_len + 2);
-    if (!tmp1) return -1;
-    tmp1[0] = '@';
-    MEMCPY(tmp1 + 1, name, name_len);
-    tmp1[name_len + 1] = '\0';
-    for (U32 i = 0; i < inst->shell_var_count; i++) {
-        if (STRICMP(tmp1, inst->shell_vars[i].name) == 0) {
-            MFree(tmp1);
-            return i;
-        }
-    }
-
-    PU8 tmp2 = MAlloc(name_len + 4);
-    if (!tmp2) { MFree(tmp1); return -1; }
-    tmp2[0] = '@'; tmp2[1] = '{';
-    MEMCPY(tmp2 + 2, name, name_len);
-    tmp2[name_len + 2] = '}';
-    tmp2[name_len + 3] = '\0';
-    for (U32 i = 0; i < inst->shell_var_count; i++) {
-        if (STRICMP(tmp2, inst->shell_vars[i].name) == 0) {
-            MFree(tmp1); MFree(tmp2);
-            return i;
-        }
-    }
-    MFree(tmp1); MFree(tmp2);
-    return -1;
+    if (!inst) return -1;
+    return FIND_VAR_IN(inst->shell_vars, inst->shell_var_count, name);
 }
 
 BOOLEAN SET_INST_VAR(PU8 name, PU8 value, BATSH_INSTANCE *inst) {
     if (!inst) return FALSE;
-    if (inst->shell_var_count + 1 > MAX_VARS) return FALSE;
     S32 idx = FIND_INST_VAR(name, inst);
-    if (idx >= 0 && idx != -1) {
+    if (idx >= 0) {
         STRNCPY(inst->shell_vars[idx].value, value, MAX_VAR_VALUE - 1);
     } else if (inst->shell_var_count < MAX_VARS) {
         STRNCPY(inst->shell_vars[inst->shell_var_count].name, name, MAX_VAR_NAME - 1);
         STRNCPY(inst->shell_vars[inst->shell_var_count].value, value, MAX_VAR_VALUE - 1);
         inst->shell_var_count++;
+    } else {
+        return FALSE;
     }
     return TRUE;
 }
@@ -378,7 +347,7 @@ BOOLEAN SET_INST_VAR(PU8 name, PU8 value, BATSH_INSTANCE *inst) {
 PU8 GET_INST_VAR(PU8 name, BATSH_INSTANCE *inst) {
     if (!inst) return NULL;
     S32 idx = FIND_INST_VAR(name, inst);
-    return (idx >= 0 && idx != -1) ? inst->shell_vars[idx].value : NULLPTR;
+    return (idx >= 0) ? inst->shell_vars[idx].value : NULLPTR;
 }
 
 PU8 GET_INST_ARG(U32 index, BATSH_INSTANCE *inst) {
@@ -1406,6 +1375,12 @@ cleanup:
 VOID HANDLE_COMMAND(U8 *line) {
     if (STRLEN(line) == 0) return;
 
+    /* Programs connected with '|' bypass the built-in commands */
+    if (IS_PIPELINE(line)) {
+        RUN_PIPELINE(line);
+        return;
+    }
+
     U8 command[64];
     U32 i = 0, j = 0;
     while (line[i] && line[i] != ' ' && j < sizeof(command) - 1)
@@ -1431,23 +1406,129 @@ VOID HANDLE_COMMAND(U8 *line) {
  * BATSH File Runner
  * =================================================== */
 
+/*
+ * Script files are compiled to bytecode once (BATSH_VM.c) and the program is
+ * kept in a small cache keyed by path and contents, so running the same
+ * script again skips the compile. A changed file simply misses.
+ *
+ * A script can run other scripts, so a cached program may still be running
+ * further up the call chain: entries are pinned while they run and only
+ * unpinned ones are evicted.
+ */
+
+#define BATSH_CACHE_SLOTS 8
+
+typedef struct {
+    U8  path[FAT_MAX_PATH];
+    PU8 src;
+    U32 len;
+    BATSH_PROGRAM *prog;
+    U32 users;                  /* RUN_BATSH_FILE calls running it */
+} BATSH_CACHED;
+
+static BATSH_CACHED batsh_cache[BATSH_CACHE_SLOTS] ATTRIB_DATA = { 0 };
+static U32 batsh_cache_next ATTRIB_DATA = 0;
+
+static VOID VM_EXEC(VOIDPTR ctx, PU8 line) { (void)ctx; HANDLE_COMMAND(line); }
+static PU8  VM_GET_GLOBAL(VOIDPTR ctx, PU8 name) { (void)ctx; return GET_VAR(name); }
+static VOID VM_SET_GLOBAL(VOIDPTR ctx, PU8 name, PU8 value) { (void)ctx; SET_VAR(name, value); }
+static U32  VM_GLOBAL_GEN(VOIDPTR ctx) { (void)ctx; return shell_var_count; }
+
+static BOOL VM_EXISTS(VOIDPTR ctx, PU8 path) {
+    (void)ctx;
+    FAT_LFN_ENTRY ent;
+    U8 abs[512];
+    return ResolvePath(path, abs, sizeof(abs)) && FAT32_PATH_RESOLVE_ENTRY(abs, &ent);
+}
+
+/* Returns the program pinned in the cache, or uncached if every slot is in
+   use; hand it back with PUT_COMPILED either way. */
+static BATSH_PROGRAM *GET_COMPILED(FILE *file) {
+    PU8 src = (PU8)file->data;
+    U32 len = file->sz;
+
+    for (U32 i = 0; i < BATSH_CACHE_SLOTS; i++) {
+        BATSH_CACHED *c = &batsh_cache[i];
+        if (c->prog && c->len == len && STRICMP(c->path, file->path) == 0 &&
+            MEMCMP(c->src, src, len) == 0) {
+            c->users++;
+            return c->prog;
+        }
+    }
+
+    BATSH_VM_ERROR err = { 0 };
+    BATSH_PROGRAM *prog = BATSH_COMPILE(src, len, &err);
+    if (!prog) {
+        PUTS("BATSH: ");
+        PUTS(file->path);
+        PUTS(":");
+        PUT_DEC(err.line);
+        PUTS(": ");
+        PUTS((PU8)err.msg);
+        PRINTNEWLINE();
+        return NULLPTR;
+    }
+
+    /* Round-robin over the slots no running script holds */
+    BATSH_CACHED *c = NULLPTR;
+    for (U32 n = 0; n < BATSH_CACHE_SLOTS && !c; n++) {
+        BATSH_CACHED *s = &batsh_cache[batsh_cache_next];
+        batsh_cache_next = (batsh_cache_next + 1) % BATSH_CACHE_SLOTS;
+        if (!s->users) c = s;
+    }
+    if (!c) return prog;        /* run uncached; PUT_COMPILED frees it */
+
+    PU8 copy = MAlloc(len + 1);
+    if (!copy) return prog;
+    MEMCPY(copy, src, len);
+
+    if (c->prog) BATSH_FREE_PROGRAM(c->prog);
+    if (c->src) MFree(c->src);
+    STRNCPY(c->path, file->path, FAT_MAX_PATH - 1);
+    c->src  = copy;
+    c->len  = len;
+    c->prog = prog;
+    c->users = 1;
+    return prog;
+}
+
+static VOID PUT_COMPILED(BATSH_PROGRAM *prog) {
+    for (U32 i = 0; i < BATSH_CACHE_SLOTS; i++) {
+        if (batsh_cache[i].prog == prog) {
+            batsh_cache[i].users--;
+            return;
+        }
+    }
+    BATSH_FREE_PROGRAM(prog);
+}
+
 BOOLEAN RUN_BATSH_FILE(BATSH_INSTANCE *inst) {
-    if (!inst) return FALSE;
+    if (!inst || !inst->file) return FALSE;
 
     inst->echo = TRUE;
     inst->batsh_mode = TRUE;
 
-    while (1) {
-        U32 n = FREAD(inst->file, inst->line, inst->line_len - 1);
-        if (n == 0) break;
-        inst->line[n] = '\0';
-
-        if (!PARSE_BATSH_INPUT(inst->line, inst)) {
-            PUTS("BATSH parse error\n");
-        }
+    BATSH_PROGRAM *prog = GET_COMPILED(inst->file);
+    if (!prog) {
+        SET_VAR("ERRORLEVEL", "1");
+        return FALSE;
     }
 
-    return TRUE;
+    BATSH_VM_ENV env = {
+        .ctx               = inst,
+        .exec              = VM_EXEC,
+        .get_global        = VM_GET_GLOBAL,
+        .set_global        = VM_SET_GLOBAL,
+        .global_generation = VM_GLOBAL_GEN,
+        .exists            = VM_EXISTS,
+        .args              = inst->args,
+        .arg_count         = inst->arg_count,
+    };
+    BOOL ok = BATSH_RUN(prog, &env);
+    PUT_COMPILED(prog);
+
+    SET_VAR("ERRORLEVEL", ok ? "0" : "1");
+    return ok;
 }
 
 /* ===================================================
@@ -1526,6 +1607,10 @@ VOID SETUP_BATSH_PROCESSER(VOID) {
  * =================================================== */
 
 BOOLEAN RUN_PROCESS(PU8 line) {
+    return RUN_PROCESS_PIPED(line, 0, 0);
+}
+
+BOOLEAN RUN_PROCESS_PIPED(PU8 line, U32 stdin_pipe, U32 stdout_pipe) {
     if (!line || !*line) return FALSE;
 
     U8 original_line[512];
@@ -1692,13 +1777,18 @@ BOOLEAN RUN_PROCESS(PU8 line) {
 
     if (STRICMP(ext, "BIN") == 0) {
         U32 pid = PROC_GETPID();
-        U32 res = START_PROCESS(abs_path_buf, data, file_size,
-                                TCB_STATE_ACTIVE, pid, argv, argc);
+        U32 res = START_PROCESS_PIPED(abs_path_buf, data, file_size,
+                                      TCB_STATE_ACTIVE, pid, argv, argc,
+                                      stdin_pipe, stdout_pipe);
         if (res) PRINTNEWLINE();
         result = (res != 0);
     }
     else if (STRICMP(ext, "SH") == 0) {
-        result = RUN_BATSH_SCRIPT(abs_path_buf, argc, argv);
+        if (stdin_pipe || stdout_pipe) {
+            PUTS("\nError: Scripts can't be part of a pipeline.\n");
+        } else {
+            result = RUN_BATSH_SCRIPT(abs_path_buf, argc, argv);
+        }
         for (U32 i = 0; i < argc; i++) { if (argv[i]) MFree(argv[i]); }
         MFree(argv);
     }
@@ -1706,3 +1796,67 @@ BOOLEAN RUN_PROCESS(PU8 line) {
     MFree(prog_name);
     return result;
 }
+
+/* ===================================================
+ * Pipelines
+ * =================================================== */
+
+/* First '|' outside double quotes */
+static PU8 find_pipe_bar(PU8 line) {
+    BOOL quoted = FALSE;
+    for (; *line; line++) {
+        if (*line == '"') quoted = !quoted;
+        else if (*line == '|' && !quoted) return line;
+    }
+    return NULLPTR;
+}
+
+BOOLEAN IS_PIPELINE(PU8 line) {
+    return line && find_pipe_bar(line) != NULLPTR;
+}
+
+BOOLEAN RUN_PIPELINE(PU8 line) {
+    if (!line) return FALSE;
+    U8 copy[512];
+    STRNCPY(copy, line, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = 0;
+
+    PU8 stages[MAX_PIPELINE_STAGES];
+    U32 count = 0;
+    PU8 p = copy;
+    stages[count++] = p;
+    PU8 bar;
+    while ((bar = find_pipe_bar(p)) != NULLPTR) {
+        if (count == MAX_PIPELINE_STAGES) {
+            PUTS("\nError: Too many programs in the pipeline.\n");
+            return FALSE;
+        }
+        *bar = 0;
+        p = bar + 1;
+        stages[count++] = p;
+    }
+
+    /* Each pipe's write end goes to stage i, its read end stays with us
+       until stage i + 1 takes it. Ends of a stage that didn't start are
+       closed so its neighbours see end of stream or a broken pipe */
+    BOOLEAN ok = TRUE;
+    U32 in = 0;
+    for (U32 i = 0; i < count; i++) {
+        U32 out = 0;
+        if (i + 1 < count && !(out = PIPE_CREATE())) {
+            PUTS("\nError: Failed to create a pipe.\n");
+            if (in) PIPE_CLOSE(in, PIPE_END_READ);
+            return FALSE;
+        }
+        if (!RUN_PROCESS_PIPED(stages[i], in, out)) {
+            PUTS("\nError: Failed to start: ");
+            PUTS(stages[i]);
+            PRINTNEWLINE();
+            if (in) PIPE_CLOSE(in, PIPE_END_READ);
+            if (out) PIPE_CLOSE(out, PIPE_END_WRITE);
+            ok = FALSE;
+        }
+        in = out;
+    }
+    return ok;
+}
@@ -0,0 +1,832 @@
+/*
+ * BATSH_VM.c — BATSH script compiler and bytecode interpreter
+ *
+ * A script is split into statements (newline or ';' separated; a trailing
+ * '\' continues a line). Each statement compiles to a few U32 words:
+ *
+ *   word 0:  opcode in the low byte, operand A in the upper 24 bits
+ *   word 1+: further operands (template/expression/condition indices,
+ *            resolved jump targets)
+ *
+ * Command lines and assignment values become templates: runs of literal
+ * text from a string pool and references to interned variable slots or
+ * script arguments. Assignments whose value is only numbers, variables and
+ * + - * / are compiled to an expression and evaluated left to right, as the
+ * line interpreter in BATSH.c does.
+ *
+ * Block keywords (IF/ELSE/FI, LOOP/END, BREAK) are recognised at the start
+ * of a statement; the text after THEN or ELSE starts a new statement, so
+ *     if @{a} equ 1 then echo one; else echo other; fi
+ * works on one line.
+ */
+
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+#include <PROGRAMS/SYS_PROGS/TSHELL/BATSH_VM.h>
+
+/* ===================================================
+ * Program layout
+ * =================================================== */
+
+typedef enum {
+    OP_END,
+    OP_EXEC,        /* A=tmpl                      run expanded line       */
+    OP_SET,         /* A=slot [tmpl]               global if set, else local */
+    OP_SETG,        /* A=slot [tmpl]               always global           */
+    OP_CALC,        /* A=slot [expr]                                       */
+    OP_CALCG,       /* A=slot [expr]                                       */
+    OP_JMP,         /* A=target                                            */
+    OP_JF,          /* A=cond [target]             jump if cond is false   */
+    OP_FOR_INIT,    /* A=depth [start tmpl][end tmpl]                      */
+    OP_FOR_TEST,    /* A=depth [exit]              sets local I            */
+    OP_FOR_NEXT,    /* A=depth [test]                                      */
+    OP_WHILE_INIT,  /* A=depth                                             */
+    OP_WHILE_TEST,  /* A=depth [cond][exit]                                */
+} BATSH_OPCODE;
+
+#define OP_WORD(op, a)  ((U32)(op) | ((U32)(a) << 8))
+#define OP_CODE(w)      ((w) & 0xFF)
+#define OP_A(w)         ((w) >> 8)
+#define OP_A_MAX        0x00FFFFFF
+
+typedef enum {
+    PART_TEXT,      /* a = pool offset, b = length */
+    PART_VAR,       /* a = slot */
+    PART_ARG,       /* a = argument index */
+    PART_NUM,       /* expressions only: value */
+} BATSH_PART_KIND;
+
+typedef struct {
+    U8  kind;
+    U32 a;
+    U32 b;
+} BATSH_PART;
+
+typedef struct {
+    U8  op;         /* '+', '-', '*', '/' applied to the running result */
+    U8  kind;       /* PART_NUM, PART_VAR or PART_ARG */
+    I32 value;      /* number, slot or argument index */
+} BATSH_TERM;
+
+typedef struct {
+    U32 first;
+    U32 count;
+} BATSH_SPAN;
+
+typedef enum {
+    COND_EQU, COND_NEQ, COND_LSS, COND_LEQ, COND_GTR, COND_GEQ, COND_EXISTS,
+} BATSH_COND_OP;
+
+typedef struct {
+    U8  op;
+    U32 lhs;        /* templates */
+    U32 rhs;
+} BATSH_COND;
+
+struct _BATSH_PROGRAM {
+    U32        *code;   U32 code_len,  code_cap;
+    BATSH_PART *parts;  U32 part_len,  part_cap;
+    BATSH_SPAN *tmpls;  U32 tmpl_len,  tmpl_cap;
+    BATSH_TERM *terms;  U32 term_len,  term_cap;
+    BATSH_SPAN *exprs;  U32 expr_len,  expr_cap;
+    BATSH_COND *conds;  U32 cond_len,  cond_cap;
+    PU8         pool;   U32 pool_len,  pool_cap;
+    U32        *names;  U32 slot_count, slot_cap;   /* pool offsets */
+    U32 slot_i;                                     /* range loop counter */
+};
+
+static BOOL GROW(VOIDPTR *arr, U32 *cap, U32 need, U32 elem) {
+    if (need <= *cap) return TRUE;
+    U32 n = *cap ? *cap * 2 : 16;
+    while (n < need) n *= 2;
+    VOIDPTR p = ReAlloc(*arr, n * elem);
+    if (!p) return FALSE;
+    *arr = p;
+    *cap = n;
+    return TRUE;
+}
+
+#define PUSH(prog, arr, len, cap) \
+    GROW((VOIDPTR *)&(prog)->arr, &(prog)->cap, (prog)->len + 1, sizeof((prog)->arr[0]))
+
+/* ===================================================
+ * Compiler
+ * =================================================== */
+
+typedef enum { BLK_IF, BLK_ELSE, BLK_FOR, BLK_WHILE } BLOCK_KIND;
+
+typedef struct {
+    U8  kind;
+    U32 line;
+    U32 patch;      /* IF: JF target word / ELSE: JMP word / loops: exit word */
+    U32 top;        /* loops: pc of the test */
+    U32 breaks;     /* loops: chain of break JMPs, code index + 1 */
+} BLOCK;
+
+typedef struct {
+    BATSH_PROGRAM *p;
+    PU8 src;
+    U32 len;
+    U32 pos;
+    U32 line;       /* line of the next unread character */
+    U32 stmt_line;  /* line the current statement started on */
+    BATSH_VM_ERROR *err;
+    BOOL failed;
+    BLOCK blocks[BATSH_VM_MAX_DEPTH];
+    U32 depth;
+} COMPILER;
+
+static VOID FAIL(COMPILER *c, U32 line, const CHAR *msg) {
+    if (c->failed) return;
+    c->failed = TRUE;
+    if (c->err) {
+        c->err->line = line;
+        c->err->msg  = msg;
+    }
+}
+
+static BOOL IS_WS(U8 ch) { return ch == ' ' || ch == '\t' || ch == '\r'; }
+static BOOL IS_NAME(U8 ch) { return ISALNUM(ch) || ch == '_'; }
+
+static BOOL WORD_IS(PU8 s, U32 n, const CHAR *kw) {
+    return STRLEN((PU8)kw) == n && STRNICMP(s, (PU8)kw, n) == 0;
+}
+
+static U32 EMIT(COMPILER *c, U32 word) {
+    BATSH_PROGRAM *p = c->p;
+    if (p->code_len > OP_A_MAX) { FAIL(c, c->stmt_line, "script too large"); return 0; }
+    if (!PUSH(p, code, code_len, code_cap)) { FAIL(c, c->stmt_line, "out of memory"); return 0; }
+    p->code[p->code_len] = word;
+    return p->code_len++;
+}
+
+static U32 POOL_ADD(COMPILER *c, PU8 s, U32 n, BOOL terminate) {
+    BATSH_PROGRAM *p = c->p;
+    if (!GROW((VOIDPTR *)&p->pool, &p->pool_cap, p->pool_len + n + 1, 1)) {
+        FAIL(c, c->stmt_line, "out of memory");
+        return 0;
+    }
+    U32 off = p->pool_len;
+    MEMCPY(p->pool + off, s, n);
+    p->pool_len += n;
+    if (terminate) p->pool[p->pool_len++] = '\0';
+    return off;
+}
+
+/* Names are compared case-insensitively, like FIND_VAR in BATSH.c. This
+   runs once per reference at compile time, never while the script runs. */
+static U32 INTERN(COMPILER *c, PU8 name, U32 n) {
+    BATSH_PROGRAM *p = c->p;
+    for (U32 i = 0; i < p->slot_count; i++) {
+        PU8 other = p->pool + p->names[i];
+        if (STRLEN(other) == n && STRNICMP(other, name, n) == 0) return i;
+    }
+    if (!PUSH(p, names, slot_count, slot_cap)) { FAIL(c, c->stmt_line, "out of memory"); return 0; }
+    U32 off = POOL_ADD(c, name, n, TRUE);
+    p->names[p->slot_count] = off;
+    return p->slot_count++;
+}
+
+static BOOL ALL_DIGITS(PU8 s, U32 n) {
+    if (n == 0) return FALSE;
+    for (U32 i = 0; i < n; i++) if (!IS_DIGIT(s[i])) return FALSE;
+    return TRUE;
+}
+
+/* A variable reference: @name, @@name, @{name} or @@{name}. Bare names are
+   only accepted when `bare` is set (values, conditions, loop bounds). */
+static BOOL PARSE_REF(PU8 s, U32 e, U32 *i, BOOL bare, U32 *ns, U32 *nn) {
+    U32 j = *i;
+    if (j >= e || s[j] != '@') return FALSE;
+    j++;
+    if (j < e && s[j] == '@') j++;
+    if (j < e && s[j] == '{') {
+        U32 start = ++j;
+        while (j < e && s[j] != '}' && s[j] != '\n') j++;
+        if (j >= e || s[j] != '}' || j == start) return FALSE;
+        *ns = start; *nn = j - start;
+        *i = j + 1;
+        return TRUE;
+    }
+    if (!bare) return FALSE;
+    U32 start = j;
+    while (j < e && IS_NAME(s[j])) j++;
+    if (j == start) return FALSE;
+    *ns = start; *nn = j - start;
+    *i = j;
+    return TRUE;
+}
+
+static BOOL ADD_PART(COMPILER *c, U8 kind, U32 a, U32 b) {
+    BATSH_PROGRAM *p = c->p;
+    if (!PUSH(p, parts, part_len, part_cap)) { FAIL(c, c->stmt_line, "out of memory"); return FALSE; }
+    p->parts[p->part_len].kind = kind;
+    p->parts[p->part_len].a = a;
+    p->parts[p->part_len].b = b;
+    p->part_len++;
+    return TRUE;
+}
+
+static VOID FLUSH_TEXT(COMPILER *c, PU8 s, U32 from, U32 to) {
+    if (to > from) ADD_PART(c, PART_TEXT, POOL_ADD(c, s + from, to - from, FALSE), to - from);
+}
+
+static VOID REF_PART(COMPILER *c, PU8 s, U32 ns, U32 nn) {
+    if (ALL_DIGITS(s + ns, nn)) ADD_PART(c, PART_ARG, ATOI(s + ns), 0);
+    else                        ADD_PART(c, PART_VAR, INTERN(c, s + ns, nn), 0);
+}
+
+/* Compiles src[s, e) to a template and returns its index. */
+static U32 COMPILE_TMPL(COMPILER *c, U32 s, U32 e, BOOL bare) {
+    BATSH_PROGRAM *p = c->p;
+    PU8 src = c->src;
+    U32 first = p->part_len;
+    U32 lit = s;
+
+    for (U32 i = s; i < e && !c->failed;) {
+        /* Line continuation reads as one space */
+        if (src[i] == '\\' && (i + 1 < e) && (src[i + 1] == '\n' || src[i + 1] == '\r')) {
+            FLUSH_TEXT(c, src, lit, i);
+            i++;
+            while (i < e && (src[i] == '\r' || src[i] == '\n')) i++;
+            ADD_PART(c, PART_TEXT, POOL_ADD(c, (PU8)" ", 1, FALSE), 1);
+            lit = i;
+            continue;
+        }
+        U32 ns, nn, j = i;
+        BOOL word_start = (i == s) || IS_WS(src[i - 1]);
+        if (src[i] == '@' && PARSE_REF(src, e, &j, bare && word_start, &ns, &nn)) {
+            FLUSH_TEXT(c, src, lit, i);
+            REF_PART(c, src, ns, nn);
+            i = lit = j;
+            continue;
+        }
+        i++;
+    }
+    FLUSH_TEXT(c, src, lit, e);
+
+    if (!PUSH(p, tmpls, tmpl_len, tmpl_cap)) { FAIL(c, c->stmt_line, "out of memory"); return 0; }
+    p->tmpls[p->tmpl_len].first = first;
+    p->tmpls[p->tmpl_len].count = p->part_len - first;
+    return p->tmpl_len++;
+}
+
+/* Quoted operands lose their quotes and do not substitute bare names. */
+static U32 COMPILE_OPERAND(COMPILER *c, U32 s, U32 e) {
+    if (e - s >= 2 && c->src[s] == '"' && c->src[e - 1] == '"')
+        return COMPILE_TMPL(c, s + 1, e - 1, FALSE);
+    return COMPILE_TMPL(c, s, e, TRUE);
+}
+
+#define EXPR_MAX_TERMS 32
+
+/* Returns TRUE and the expression index if src[s, e) is arithmetic. */
+static BOOL COMPILE_EXPR(COMPILER *c, U32 s, U32 e, U32 *out) {
+    PU8 src = c->src;
+    BATSH_TERM terms[EXPR_MAX_TERMS];
+    U32 n = 0;
+    U8 op = '+';
+    U32 i = s;
+
+    while (TRUE) {
+        while (i < e && IS_WS(src[i])) i++;
+        if (i >= e || n == EXPR_MAX_TERMS) return FALSE;
+
+        BATSH_TERM *t = &terms[n];
+        U32 ns, nn;
+        t->op = op;
+        if (IS_DIGIT(src[i]) || (n == 0 && src[i] == '-' && i + 1 < e && IS_DIGIT(src[i + 1]))) {
+            BOOL neg = src[i] == '-';
+            if (neg) i++;
+            I32 v = 0;
+            while (i < e && IS_DIGIT(src[i])) v = v * 10 + (src[i++] - '0');
+            t->kind  = PART_NUM;
+            t->value = neg ? -v : v;
+        } else if (src[i] == '@' && PARSE_REF(src, e, &i, TRUE, &ns, &nn)) {
+            if (ALL_DIGITS(src + ns, nn)) { t->kind = PART_ARG; t->value = ATOI(src + ns); }
+            else                          { t->kind = PART_VAR; t->value = INTERN(c, src + ns, nn); }
+        } else {
+            return FALSE;
+        }
+        n++;
+
+        while (i < e && IS_WS(src[i])) i++;
+        if (i >= e) break;
+        if (src[i] != '+' && src[i] != '-' && src[i] != '*' && src[i] != '/') return FALSE;
+        op = src[i++];
+    }
+    if (n < 2) return FALSE;    /* a lone number or variable is a plain value */
+
+    BATSH_PROGRAM *p = c->p;
+    if (!GROW((VOIDPTR *)&p->terms, &p->term_cap, p->term_len + n, sizeof(BATSH_TERM)) ||
+        !PUSH(p, exprs, expr_len, expr_cap)) {
+        FAIL(c, c->stmt_line, "out of memory");
+        return FALSE;
+    }
+    MEMCPY(&p->terms[p->term_len], terms, n * sizeof(BATSH_TERM));
+    p->exprs[p->expr_len].first = p->term_len;
+    p->exprs[p->expr_len].count = n;
+    p->term_len += n;
+    *out = p->expr_len++;
+    return TRUE;
+}
+
+/* Next whitespace-separated word of src[*i, e); quoted words stay whole. */
+static BOOL NEXT_WORD(COMPILER *c, U32 *i, U32 e, U32 *ws, U32 *we) {
+    PU8 src = c->src;
+    U32 j = *i;
+    while (j < e && IS_WS(src[j])) j++;
+    if (j >= e) { *i = j; return FALSE; }
+    *ws = j;
+    if (src[j] == '"') {
+        j++;
+        while (j < e && src[j] != '"') j++;
+        if (j < e) j++;
+    } else {
+        while (j < e && !IS_WS(src[j])) j++;
+    }
+    *we = j;
+    *i = j;
+    return TRUE;
+}
+
+/* Indexed by BATSH_COND_OP */
+static const CHAR *const cond_names[] ATTRIB_RODATA = {
+    "equ", "neq", "lss", "leq", "gtr", "geq", "exists",
+};
+
+static BOOL COND_OP(PU8 s, U32 n, U8 *op) {
+    for (U32 k = 0; k < sizeof(cond_names) / sizeof(cond_names[0]); k++) {
+        if (WORD_IS(s, n, cond_names[k])) { *op = (U8)k; return TRUE; }
+    }
+    return FALSE;
+}
+
+/* Parses `lhs OP rhs` or `path EXISTS` starting at *i. */
+static BOOL COMPILE_COND(COMPILER *c, U32 *i, U32 e, U32 *out) {
+    U32 ls, le, os, oe, rs = 0, re = 0;
+    U8 op;
+    if (!NEXT_WORD(c, i, e, &ls, &le) || !NEXT_WORD(c, i, e, &os, &oe) ||
+        !COND_OP(c->src + os, oe - os, &op)) {
+        FAIL(c, c->stmt_line, "expected: lhs EQU|NEQ|LSS|LEQ|GTR|GEQ rhs, or path EXISTS");
+        return FALSE;
+    }
+    if (op != COND_EXISTS && !NEXT_WORD(c, i, e, &rs, &re)) {
+        FAIL(c, c->stmt_line, "missing right-hand side of condition");
+        return FALSE;
+    }
+
+    BATSH_PROGRAM *p = c->p;
+    U32 lhs = COMPILE_OPERAND(c, ls, le);
+    U32 rhs = op == COND_EXISTS ? COMPILE_TMPL(c, rs, rs, FALSE) : COMPILE_OPERAND(c, rs, re);
+    if (c->failed) return FALSE;
+    if (!PUSH(p, conds, cond_len, cond_cap)) { FAIL(c, c->stmt_line, "out of memory"); return FALSE; }
+    p->conds[p->cond_len].op  = op;
+    p->conds[p->cond_len].lhs = lhs;
+    p->conds[p->cond_len].rhs = rhs;
+    *out = p->cond_len++;
+    return TRUE;
+}
+
+static BLOCK *OPEN_BLOCK(COMPILER *c, U8 kind) {
+    if (c->depth >= BATSH_VM_MAX_DEPTH) { FAIL(c, c->stmt_line, "blocks nested too deeply"); return NULLPTR; }
+    BLOCK *b = &c->blocks[c->depth++];
+    MEMZERO(b, sizeof(*b));
+    b->kind = kind;
+    b->line = c->stmt_line;
+    return b;
+}
+
+static BOOL ONLY_WS(COMPILER *c, U32 i, U32 e) {
+    while (i < e && IS_WS(c->src[i])) i++;
+    return i >= e;
+}
+
+static VOID COMPILE_STATEMENT(COMPILER *c, U32 s, U32 e);
+
+static VOID COMPILE_IF(COMPILER *c, U32 i, U32 e) {
+    U32 cond, ws, we;
+    if (!COMPILE_COND(c, &i, e, &cond)) return;
+    U32 at = i;
+    if (NEXT_WORD(c, &at, e, &ws, &we) && WORD_IS(c->src + ws, we - ws, "then")) i = at;
+
+    BLOCK *b = OPEN_BLOCK(c, BLK_IF);
+    if (!b) return;
+    EMIT(c, OP_WORD(OP_JF, cond));
+    b->patch = EMIT(c, 0);
+    COMPILE_STATEMENT(c, i, e);
+}
+
+static VOID COMPILE_ELSE(COMPILER *c, U32 i, U32 e) {
+    BLOCK *b = c->depth ? &c->blocks[c->depth - 1] : NULLPTR;
+    if (!b || b->kind != BLK_IF) { FAIL(c, c->stmt_line, "ELSE without IF"); return; }
+    U32 jmp = EMIT(c, OP_WORD(OP_JMP, 0));
+    c->p->code[b->patch] = c->p->code_len;
+    b->kind  = BLK_ELSE;
+    b->patch = jmp;
+    COMPILE_STATEMENT(c, i, e);
+}
+
+static VOID COMPILE_FI(COMPILER *c) {
+    BLOCK *b = c->depth ? &c->blocks[c->depth - 1] : NULLPTR;
+    if (!b || (b->kind != BLK_IF && b->kind != BLK_ELSE)) { FAIL(c, c->stmt_line, "FI without IF"); return; }
+    if (b->kind == BLK_IF) c->p->code[b->patch] = c->p->code_len;
+    else                   c->p->code[b->patch] = OP_WORD(OP_JMP, c->p->code_len);
+    c->depth--;
+}
+
+static VOID COMPILE_LOOP(COMPILER *c, U32 i, U32 e) {
+    U32 at = i, as, ae, os, oe, bs, be;
+    BOOL range = NEXT_WORD(c, &at, e, &as, &ae) && NEXT_WORD(c, &at, e, &os, &oe) &&
+                 WORD_IS(c->src + os, oe - os, "to");
+    U32 d = c->depth;
+    BLOCK *b;
+
+    if (range) {
+        if (!NEXT_WORD(c, &at, e, &bs, &be) || !ONLY_WS(c, at, e)) {
+            FAIL(c, c->stmt_line, "expected: LOOP start TO end");
+            return;
+        }
+        U32 t_start = COMPILE_OPERAND(c, as, ae);
+        U32 t_end   = COMPILE_OPERAND(c, bs, be);
+        if (!(b = OPEN_BLOCK(c, BLK_FOR))) return;
+        EMIT(c, OP_WORD(OP_FOR_INIT, d));
+        EMIT(c, t_start);
+        EMIT(c, t_end);
+        b->top = EMIT(c, OP_WORD(OP_FOR_TEST, d));
+        b->patch = EMIT(c, 0);
+        return;
+    }
+
+    U32 cond;
+    if (!COMPILE_COND(c, &i, e, &cond)) return;
+    if (!ONLY_WS(c, i, e)) { FAIL(c, c->stmt_line, "unexpected text after LOOP condition"); return; }
+    if (!(b = OPEN_BLOCK(c, BLK_WHILE))) return;
+    EMIT(c, OP_WORD(OP_WHILE_INIT, d));
+    b->top = EMIT(c, OP_WORD(OP_WHILE_TEST, d));
+    EMIT(c, cond);
+    b->patch = EMIT(c, 0);
+}
+
+static VOID COMPILE_END(COMPILER *c) {
+    BLOCK *b = c->depth ? &c->blocks[c->depth - 1] : NULLPTR;
+    if (!b || (b->kind != BLK_FOR && b->kind != BLK_WHILE)) { FAIL(c, c->stmt_line, "END without LOOP"); return; }
+    BATSH_PROGRAM *p = c->p;
+    if (b->kind == BLK_FOR) {
+        EMIT(c, OP_WORD(OP_FOR_NEXT, c->depth - 1));
+        EMIT(c, b->top);
+    } else {
+        EMIT(c, OP_WORD(OP_JMP, b->top));
+    }
+    if (c->failed) return;
+
+    U32 exit = p->code_len;
+    p->code[b->patch] = exit;
+    for (U32 at = b->breaks; at;) {
+        U32 next = OP_A(p->code[at - 1]);
+        p->code[at - 1] = OP_WORD(OP_JMP, exit);
+        at = next;
+    }
+    c->depth--;
+}
+
+static VOID COMPILE_BREAK(COMPILER *c) {
+    for (U32 d = c->depth; d > 0; d--) {
+        BLOCK *b = &c->blocks[d - 1];
+        if (b->kind != BLK_FOR && b->kind != BLK_WHILE) continue;
+        /* Until END is compiled the operand links to the previous break */
+        U32 at = EMIT(c, OP_WORD(OP_JMP, b->breaks));
+        b->breaks = at + 1;
+        return;
+    }
+    FAIL(c, c->stmt_line, "BREAK outside LOOP");
+}
+
+/* `@name = value` / `@@name = value`. Returns FALSE if the statement is not
+   an assignment (it is then compiled as a command). */
+static BOOL COMPILE_ASSIGN(COMPILER *c, U32 s, U32 e) {
+    PU8 src = c->src;
+    BOOL global = s + 1 < e && src[s + 1] == '@';
+    U32 i = s, ns, nn;
+    if (!PARSE_REF(src, e, &i, TRUE, &ns, &nn)) return FALSE;
+    while (i < e && IS_WS(src[i])) i++;
+    if (i >= e || src[i] != '=') return FALSE;
+    if (ALL_DIGITS(src + ns, nn)) { FAIL(c, c->stmt_line, "cannot assign to a script argument"); return TRUE; }
+
+    U32 slot = INTERN(c, src + ns, nn);
+    U32 vs = i + 1, ve = e, idx;
+    while (vs < ve && IS_WS(src[vs])) vs++;
+
+    if (COMPILE_EXPR(c, vs, ve, &idx)) {
+        EMIT(c, OP_WORD(global ? OP_CALCG : OP_CALC, slot));
+    } else {
+        idx = COMPILE_OPERAND(c, vs, ve);
+        EMIT(c, OP_WORD(global ? OP_SETG : OP_SET, slot));
+    }
+    EMIT(c, idx);
+    return TRUE;
+}
+
+static VOID COMPILE_STATEMENT(COMPILER *c, U32 s, U32 e) {
+    PU8 src = c->src;
+    while (s < e && IS_WS(src[s])) s++;
+    while (e > s && IS_WS(src[e - 1])) e--;
+    if (s >= e || c->failed) return;
+
+    U32 i = s, ws, we;
+    NEXT_WORD(c, &i, e, &ws, &we);
+    PU8 w = src + ws;
+    U32 n = we - ws;
+
+    if      (WORD_IS(w, n, "if"))    COMPILE_IF(c, i, e);
+    else if (WORD_IS(w, n, "else"))  COMPILE_ELSE(c, i, e);
+    else if (WORD_IS(w, n, "loop"))  COMPILE_LOOP(c, i, e);
+    else if (WORD_IS(w, n, "fi") || WORD_IS(w, n, "end") || WORD_IS(w, n, "break")) {
+        if (!ONLY_WS(c, i, e)) { FAIL(c, c->stmt_line, "unexpected text after FI/END/BREAK"); return; }
+        if      (WORD_IS(w, n, "fi"))  COMPILE_FI(c);
+        else if (WORD_IS(w, n, "end")) COMPILE_END(c);
+        else                           COMPILE_BREAK(c);
+    }
+    else if (src[s] != '@' || !COMPILE_ASSIGN(c, s, e))
+        EMIT(c, OP_WORD(OP_EXEC, COMPILE_TMPL(c, s, e, FALSE)));
+}
+
+/* Finds the next statement. Skips comments (`#` at a word start, `rem`) and
+   stops at newline or at ';' outside quotes. Returns FALSE at end of input. */
+static BOOL NEXT_STATEMENT(COMPILER *c, U32 *s, U32 *e) {
+    PU8 src = c->src;
+    while (c->pos < c->len) {
+        U8 ch = src[c->pos];
+        if (ch == '\n') { c->line++; c->pos++; continue; }
+        if (IS_WS(ch) || ch == ';') { c->pos++; continue; }
+
+        BOOL rem = c->pos + 3 <= c->len && STRNICMP(src + c->pos, (PU8)"rem", 3) == 0 &&
+                   (c->pos + 3 == c->len || IS_WS(src[c->pos + 3]) || src[c->pos + 3] == '\n');
+        if (ch == '#' || rem) {
+            while (c->pos < c->len && src[c->pos] != '\n') c->pos++;
+            continue;
+        }
+        break;
+    }
+    if (c->pos >= c->len) return FALSE;
+
+    c->stmt_line = c->line;
+    *s = c->pos;
+    BOOL quoted = FALSE;
+    while (c->pos < c->len) {
+        U8 ch = src[c->pos];
+        if (ch == '"') quoted = !quoted;
+        else if (ch == '\\' && c->pos + 1 < c->len &&
+                 (src[c->pos + 1] == '\n' || src[c->pos + 1] == '\r')) {
+            c->pos++;
+            if (src[c->pos] == '\r' && c->pos + 1 < c->len && src[c->pos + 1] == '\n') c->pos++;
+            c->line++;
+        }
+        else if (ch == '\n') break;
+        else if (!quoted && ch == ';') break;
+        else if (!quoted && ch == '#' && IS_WS(src[c->pos - 1])) break;
+        c->pos++;
+    }
+    *e = c->pos;
+    return TRUE;
+}
+
+BATSH_PROGRAM *BATSH_COMPILE(PU8 src, U32 len, BATSH_VM_ERROR *err) {
+    COMPILER c;
+    MEMZERO(&c, sizeof(c));
+    c.src  = src;
+    c.len  = len;
+    c.line = 1;
+    c.err  = err;
+    c.p    = CAlloc(1, sizeof(BATSH_PROGRAM));
+    if (!c.p) { FAIL(&c, 0, "out of memory"); return NULLPTR; }
+    c.p->slot_i = INTERN(&c, (PU8)"I", 1);
+
+    U32 s, e;
+    while (!c.failed && NEXT_STATEMENT(&c, &s, &e))
+        COMPILE_STATEMENT(&c, s, e);
+
+    if (!c.failed && c.depth) {
+        BLOCK *b = &c.blocks[c.depth - 1];
+        FAIL(&c, b->line, (b->kind == BLK_FOR || b->kind == BLK_WHILE) ? "LOOP without END" : "IF without FI");
+    }
+    c.stmt_line = c.line;
+    EMIT(&c, OP_WORD(OP_END, 0));
+
+    if (c.failed) {
+        BATSH_FREE_PROGRAM(c.p);
+        return NULLPTR;
+    }
+    return c.p;
+}
+
+VOID BATSH_FREE_PROGRAM(BATSH_PROGRAM *p) {
+    if (!p) return;
+    if (p->code)  MFree(p->code);
+    if (p->parts) MFree(p->parts);
+    if (p->tmpls) MFree(p->tmpls);
+    if (p->terms) MFree(p->terms);
+    if (p->exprs) MFree(p->exprs);
+    if (p->conds) MFree(p->conds);
+    if (p->pool)  MFree(p->pool);
+    if (p->names) MFree(p->names);
+    MFree(p);
+}
+
+U32 BATSH_PROGRAM_CODE_LEN(const BATSH_PROGRAM *p) {
+    return p ? p->code_len : 0;
+}
+
+/* ===================================================
+ * Interpreter
+ * =================================================== */
+
+typedef struct {
+    const BATSH_PROGRAM *p;
+    const BATSH_VM_ENV *env;
+
+    U8 (*locals)[BATSH_VM_VALUE_MAX];
+    U8  *defined;
+    PU8 *global;        /* cached env->get_global() result per slot */
+    U32 *miss_gen;      /* generation + 1 of the last failed lookup, 0 = none */
+
+    struct { I32 cur; I32 end; U32 iters; } loops[BATSH_VM_MAX_DEPTH];
+
+    U8 line[BATSH_VM_LINE_MAX];
+    U8 rhs[BATSH_VM_LINE_MAX];
+} VM_STATE;
+
+static PU8 VM_GLOBAL(VM_STATE *vm, U32 slot) {
+    const BATSH_VM_ENV *env = vm->env;
+    if (vm->global[slot]) return vm->global[slot];
+    if (!env->get_global) return NULLPTR;
+
+    U32 gen = env->global_generation ? env->global_generation(env->ctx) + 1 : 0;
+    if (gen && vm->miss_gen[slot] == gen) return NULLPTR;
+    vm->global[slot] = env->get_global(env->ctx, vm->p->pool + vm->p->names[slot]);
+    if (!vm->global[slot]) vm->miss_gen[slot] = gen;
+    return vm->global[slot];
+}
+
+/* Same precedence as resolve_vars in BATSH.c: a non-empty global wins. */
+static PU8 VM_VALUE(VM_STATE *vm, U8 kind, U32 a) {
+    if (kind == PART_ARG) {
+        const BATSH_VM_ENV *env = vm->env;
+        return (a < env->arg_count && env->args[a]) ? env->args[a] : (PU8)"";
+    }
+    PU8 g = VM_GLOBAL(vm, a);
+    if (g && *g) return g;
+    return vm->defined[a] ? vm->locals[a] : (PU8)"";
+}
+
+static VOID VM_SET(VM_STATE *vm, U32 slot, PU8 value, BOOL global) {
+    if (global || VM_GLOBAL(vm, slot)) {
+        if (vm->env->set_global) vm->env->set_global(vm->env->ctx, vm->p->pool + vm->p->names[slot], value);
+        return;
+    }
+    STRNCPY(vm->locals[slot], value, BATSH_VM_VALUE_MAX - 1);
+    vm->locals[slot][BATSH_VM_VALUE_MAX - 1] = '\0';
+    vm->defined[slot] = TRUE;
+}
+
+static PU8 VM_EXPAND(VM_STATE *vm, U32 tmpl, PU8 out) {
+    const BATSH_PROGRAM *p = vm->p;
+    const BATSH_SPAN *t = &p->tmpls[tmpl];
+    U32 n = 0;
+    for (U32 k = 0; k < t->count; k++) {
+        const BATSH_PART *part = &p->parts[t->first + k];
+        PU8 s;
+        U32 len;
+        if (part->kind == PART_TEXT) { s = p->pool + part->a; len = part->b; }
+        else                         { s = VM_VALUE(vm, part->kind, part->a); len = STRLEN(s); }
+        if (len > BATSH_VM_LINE_MAX - 1 - n) len = BATSH_VM_LINE_MAX - 1 - n;
+        MEMCPY(out + n, s, len);
+        n += len;
+    }
+    out[n] = '\0';
+    return out;
+}
+
+static I32 VM_CALC(VM_STATE *vm, U32 expr) {
+    const BATSH_SPAN *x = &vm->p->exprs[expr];
+    I32 result = 0;
+    for (U32 k = 0; k < x->count; k++) {
+        const BATSH_TERM *t = &vm->p->terms[x->first + k];
+        I32 v = t->kind == PART_NUM ? t->value : ATOI_I32(VM_VALUE(vm, t->kind, (U32)t->value));
+        switch (t->op) {
+        case '+': result += v; break;
+        case '-': result -= v; break;
+        case '*': result *= v; break;
+        case '/': if (v != 0) result /= v; break;
+        }
+    }
+    return result;
+}
+
+static BOOL VM_COND(VM_STATE *vm, U32 idx) {
+    const BATSH_COND *cd = &vm->p->conds[idx];
+    PU8 l = VM_EXPAND(vm, cd->lhs, vm->line);
+    if (cd->op == COND_EXISTS)
+        return vm->env->exists ? vm->env->exists(vm->env->ctx, l) : FALSE;
+
+    PU8 r = VM_EXPAND(vm, cd->rhs, vm->rhs);
+    switch (cd->op) {
+    case COND_EQU: return STRICMP(l, r) == 0;
+    case COND_NEQ: return STRICMP(l, r) != 0;
+    case COND_LSS: return ATOI_I32(l) <  ATOI_I32(r);
+    case COND_LEQ: return ATOI_I32(l) <= ATOI_I32(r);
+    case COND_GTR: return ATOI_I32(l) >  ATOI_I32(r);
+    case COND_GEQ: return ATOI_I32(l) >= ATOI_I32(r);
+    }
+    return FALSE;
+}
+
+static VOID VM_SET_NUMBER(VM_STATE *vm, U32 slot, I32 v, BOOL global) {
+    U8 buf[16];
+    ITOA(v, buf, 10);
+    VM_SET(vm, slot, buf, global);
+}
+
+BOOL BATSH_RUN(const BATSH_PROGRAM *p, const BATSH_VM_ENV *env) {
+    if (!p || !env) return FALSE;
+    U32 slots = p->slot_count;
+    VM_STATE *vm = CAlloc(1, sizeof(VM_STATE));
+    if (!vm) return FALSE;
+    vm->p        = p;
+    vm->env      = env;
+    vm->locals   = CAlloc(slots, BATSH_VM_VALUE_MAX);
+    vm->defined  = CAlloc(slots, sizeof(U8));
+    vm->global   = CAlloc(slots, sizeof(PU8));
+    vm->miss_gen = CAlloc(slots, sizeof(U32));
+    BOOL ok = vm->locals && vm->defined && vm->global && vm->miss_gen;
+
+    const U32 *code = p->code;
+    U32 pc = 0;
+    while (ok) {
+        U32 w = code[pc];
+        U32 a = OP_A(w);
+        switch (OP_CODE(w)) {
+        case OP_EXEC:
+            if (env->exec) env->exec(env->ctx, VM_EXPAND(vm, a, vm->line));
+            pc += 1;
+            break;
+        case OP_SET:
+        case OP_SETG:
+            VM_SET(vm, a, VM_EXPAND(vm, code[pc + 1], vm->line), OP_CODE(w) == OP_SETG);
+            pc += 2;
+            break;
+        case OP_CALC:
+        case OP_CALCG:
+            VM_SET_NUMBER(vm, a, VM_CALC(vm, code[pc + 1]), OP_CODE(w) == OP_CALCG);
+            pc += 2;
+            break;
+        case OP_JMP:
+            pc = a;
+            break;
+        case OP_JF:
+            pc = VM_COND(vm, a) ? pc + 2 : code[pc + 1];
+            break;
+        case OP_FOR_INIT:
+            vm->loops[a].cur   = ATOI_I32(VM_EXPAND(vm, code[pc + 1], vm->line));
+            vm->loops[a].end   = ATOI_I32(VM_EXPAND(vm, code[pc + 2], vm->line));
+            vm->loops[a].iters = 0;
+            pc += 3;
+            break;
+        case OP_FOR_TEST:
+            if (vm->loops[a].cur > vm->loops[a].end || vm->loops[a].iters >= BATSH_VM_RANGE_MAX) {
+                pc = code[pc + 1];
+                break;
+            }
+            /* The counter is always a script local, as before */
+            ITOA(vm->loops[a].cur, vm->locals[p->slot_i], 10);
+            vm->defined[p->slot_i] = TRUE;
+            pc += 2;
+            break;
+        case OP_FOR_NEXT:
+            vm->loops[a].cur++;
+            vm->loops[a].iters++;
+            pc = code[pc + 1];
+            break;
+        case OP_WHILE_INIT:
+            vm->loops[a].iters = 0;
+            pc += 1;
+            break;
+        case OP_WHILE_TEST:
+            if (vm->loops[a].iters++ >= BATSH_VM_WHILE_MAX || !VM_COND(vm, code[pc + 1]))
+                pc = code[pc + 2];
+            else
+                pc += 3;
+            break;
+        case OP_END:
+        default:
+            goto done;
+        }
+    }
+done:
+    if (vm->locals)   MFree(vm->locals);
+    if (vm->defined)  MFree(vm->defined);
+    if (vm->global)   MFree(vm->global);
+    if (vm->miss_gen) MFree(vm->miss_gen);
+    MFree(vm);
+    return ok;
+}
@@ -0,0 +1,73 @@
+#ifndef BATSH_VM_H
+#define BATSH_VM_H
+
+#include <STD/TYPEDEF.h>
+
+/*
+ * ════════════════════════════════════════════════════════════════════════════
+ *  BATSH BYTECODE  (BATSH_VM.c)
+ *
+ *  Script files are compiled once into a flat U32 code stream. Jump targets
+ *  are resolved at compile time, variable names are interned into slots and
+ *  every command line becomes a template of literal text and slot references,
+ *  so running a loop body costs one template expansion per command instead
+ *  of a full re-tokenise/parse/resolve pass.
+ *
+ *  The core has no TSHELL dependencies: commands, globals and the file
+ *  system are reached through BATSH_VM_ENV, which lets the host tests drive
+ *  the interpreter with a fake shell.
+ * ════════════════════════════════════════════════════════════════════════════
+ */
+
+#define BATSH_VM_VALUE_MAX   256     /* same as MAX_VAR_VALUE in BATSH.h */
+#define BATSH_VM_LINE_MAX    1024    /* longest expanded command line */
+#define BATSH_VM_MAX_DEPTH   16      /* nested if/loop blocks */
+#define BATSH_VM_RANGE_MAX   100000  /* iteration cap of LOOP a TO b */
+#define BATSH_VM_WHILE_MAX   10000   /* iteration cap of LOOP lhs OP rhs */
+
+typedef struct _BATSH_PROGRAM BATSH_PROGRAM;
+
+/// @brief What the interpreter needs from the shell.
+typedef struct {
+    VOIDPTR ctx;
+
+    /// Runs one expanded command line.
+    VOID (*exec)(VOIDPTR ctx, PU8 line);
+
+    /// Returns the storage of global `name`, or NULLPTR. The pointer must stay
+    /// valid (and see later updates) while globals are only added, never
+    /// removed; the interpreter caches it per variable slot.
+    PU8  (*get_global)(VOIDPTR ctx, PU8 name);
+    VOID (*set_global)(VOIDPTR ctx, PU8 name, PU8 value);
+
+    /// Changes whenever a global is created, so cached misses can be retried.
+    U32  (*global_generation)(VOIDPTR ctx);
+
+    /// `path EXISTS` condition.
+    BOOL (*exists)(VOIDPTR ctx, PU8 path);
+
+    /// Script arguments, read by @{0}, @{1}, ...
+    PPU8 args;
+    U32  arg_count;
+} BATSH_VM_ENV;
+
+/// @brief Compile error: 1-based source line and a static message.
+typedef struct {
+    U32 line;
+    const CHAR *msg;
+} BATSH_VM_ERROR;
+
+/// @brief Compiles a whole script.
+/// @return The program (free with BATSH_FREE_PROGRAM), or NULLPTR with `err` filled in.
+BATSH_PROGRAM *BATSH_COMPILE(PU8 src, U32 len, BATSH_VM_ERROR *err);
+
+/// @brief Runs a compiled program. Locals live only for the duration of the run.
+/// @return FALSE if the run state could not be allocated.
+BOOL BATSH_RUN(const BATSH_PROGRAM *prog, const BATSH_VM_ENV *env);
+
+VOID BATSH_FREE_PROGRAM(BATSH_PROGRAM *prog);
+
+/// @brief Size of the code stream in U32 words, for diagnostics and benchmarks.
+U32 BATSH_PROGRAM_CODE_LEN(const BATSH_PROGRAM *prog);
+
+#endif /* BATSH_VM_H */
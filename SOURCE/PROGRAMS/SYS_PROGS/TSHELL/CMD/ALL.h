@@ -6,4 +6,5 @@
 #include <PROGRAMS/SYS_PROGS/TSHELL/CMD/TYPE.c>
 #include <PROGRAMS/SYS_PROGS/TSHELL/CMD/TAIL.c>
 #include <PROGRAMS/SYS_PROGS/TSHELL/CMD/COLOUR.c>
-#include <PROGRAMS/SYS_PROGS/TSHELL/CMD/SLEEP.c>
\ No newline at end of file
+#include <PROGRAMS/SYS_PROGS/TSHELL/CMD/SLEEP.c>
+#include <PROGRAMS/SYS_PROGS/TSHELL/CMD/TRACE.c>
\ No newline at end of file
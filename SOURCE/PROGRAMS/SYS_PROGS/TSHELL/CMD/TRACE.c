@@ -0,0 +1,81 @@
+/* CMD/TRACE.c — Kernel trace ring control for TSHELL */
+
+static const struct { const CHAR *name; U32 bit; } trace_classes[] ATTRIB_RODATA = {
+    { "sched",   TRACE_CLASS_SCHED },
+    { "syscall", TRACE_CLASS_SYSCALL },
+    { "irq",     TRACE_CLASS_IRQ },
+    { "disk",    TRACE_CLASS_DISK },
+    { "heap",    TRACE_CLASS_HEAP },
+    { "user",    TRACE_CLASS_USER },
+    { "all",     TRACE_CLASS_ALL },
+};
+#define TRACE_CLASS_COUNT (sizeof(trace_classes) / sizeof(trace_classes[0]))
+
+static VOID trace_usage(VOID) {
+    PUTS("Usage: trace                      show enabled classes" LEND);
+    PUTS("       trace on|off <class>...    classes: sched syscall irq disk heap user all" LEND);
+    PUTS("       trace clear                drop recorded events" LEND);
+    PUTS("       trace dump [2|3|4]         stream events to COMn (default COM2)" LEND);
+    PUTS("       trace mark <n>             record a marker event" LEND);
+}
+
+static VOID trace_status(VOID) {
+    U32 mask = TRACE_GET_MASK();
+    U8 buf[64];
+    SPRINTF(buf, "trace: %d events held, classes:", TRACE_COUNT());
+    PUTS(buf);
+    for (U32 i = 0; i < TRACE_CLASS_COUNT; i++) {
+        if (trace_classes[i].bit == TRACE_CLASS_ALL) continue;
+        if (mask & trace_classes[i].bit) {
+            PUTC(' ');
+            PUTS((PU8)trace_classes[i].name);
+        }
+    }
+    if (!mask) PUTS(" none");
+    PUTS(LEND);
+}
+
+VOID CMD_TRACE(U8 *line) {
+    ARG_ARRAY args;
+    RAW_LINE_TO_ARG_ARRAY(line, &args);
+    PRINTNEWLINE();
+
+    if (args.argc < 2) {
+        trace_status();
+    } else if (STRICMP(args.argv[1], "on") == 0 || STRICMP(args.argv[1], "off") == 0) {
+        BOOL on = STRICMP(args.argv[1], "on") == 0;
+        U32 mask = TRACE_GET_MASK();
+        for (U32 a = 2; a < args.argc; a++) {
+            U32 i = 0;
+            while (i < TRACE_CLASS_COUNT && STRICMP(args.argv[a], (PU8)trace_classes[i].name) != 0) i++;
+            if (i == TRACE_CLASS_COUNT) {
+                PUTS("trace: unknown class ");
+                PUTS(args.argv[a]);
+                PUTS(LEND);
+                continue;
+            }
+            mask = on ? (mask | trace_classes[i].bit) : (mask & ~trace_classes[i].bit);
+        }
+        TRACE_SET_MASK(mask);
+        trace_status();
+    } else if (STRICMP(args.argv[1], "clear") == 0) {
+        TRACE_CLEAR();
+        PUTS("trace: cleared" LEND);
+    } else if (STRICMP(args.argv[1], "dump") == 0) {
+        U16 port = COM2_PORT;
+        if (args.argc > 2) {
+            U32 n = ATOI(args.argv[2]);
+            if (n == 3) port = COM3_PORT;
+            else if (n == 4) port = COM4_PORT;
+            else if (n != 2) { trace_usage(); DELETE_ARG_ARRAY(&args); return; }
+        }
+        U8 buf[48];
+        SPRINTF(buf, "trace: %d events dumped" LEND, TRACE_DUMP(port));
+        PUTS(buf);
+    } else if (STRICMP(args.argv[1], "mark") == 0 && args.argc > 2) {
+        TRACE_MARK(ATOI(args.argv[2]), 0, 0);
+    } else {
+        trace_usage();
+    }
+    DELETE_ARG_ARRAY(&args);
+}
@@ -0,0 +1,187 @@
+/**
+ * UIBENCH - ATGL render pass benchmark
+ * Part of atOS
+ *
+ * Builds a TMAN-style screen with a few hundred widgets: a header of
+ * buttons, columns of labels and progress bars, and an opaque results
+ * panel over the middle of the columns. Then it times ATGL_RENDER_TREE
+ * with the STD/BENCH harness after typical changes:
+ *
+ *   full    the whole tree invalidated, as on the first frame
+ *   label   one label's text changed
+ *   bars    one column of progress bars updated
+ *   hidden  a label under the results panel changed
+ *   idle    nothing changed
+ *
+ * Each line gives the median frame time and the render stats of the
+ * last frame: damage rects, pixels repainted, nodes painted, and nodes
+ * skipped as clipped or occluded. ESC quits.
+ */
+#include <LIBRARIES/ATGL/ATGL.h>
+#include <STD/PROC_COM.h>
+#include <STD/STRING.h>
+#include <STD/DEBUG.h>
+#include <STD/TIME.h>
+#include <STD/BENCH.h>
+
+#define COLUMNS      6
+#define MAX_ROWS     32     // label + bar per row, ATGL_MAX_CHILDREN per column
+#define LABEL_H      12
+#define BAR_H        10
+#define RUNS         100
+
+PATGL_NODE root;
+PATGL_NODE results;
+
+PATGL_NODE labels[COLUMNS][MAX_ROWS];
+PATGL_NODE bars[COLUMNS][MAX_ROWS];
+U32 rows = 0;
+
+PATGL_NODE hidden_label;
+
+static U32 frame = 0;
+static BOOL benchmarked = FALSE;
+
+static VOID set_row_text(PATGL_NODE label, U32 row)
+{
+    CHAR buf[32];
+    SNPRINTF(buf, sizeof(buf), "Row %d: %d", row, frame);
+    ATGL_NODE_SET_TEXT(label, (PU8)buf);
+}
+
+static VOID bench_full(VOIDPTR arg)
+{
+    (void)arg;
+    ATGL_NODE_INVALIDATE(root);
+    ATGL_RENDER_TREE(root);
+}
+
+static VOID bench_label(VOIDPTR arg)
+{
+    (void)arg;
+    frame++;
+    set_row_text(labels[0][0], 0);
+    ATGL_RENDER_TREE(root);
+}
+
+static VOID bench_bars(VOIDPTR arg)
+{
+    (void)arg;
+    frame++;
+    for (U32 r = 0; r < rows; r++) {
+        ATGL_PROGRESSBAR_SET(bars[0][r], (frame + r * 7) % 100);
+    }
+    ATGL_RENDER_TREE(root);
+}
+
+static VOID bench_hidden(VOIDPTR arg)
+{
+    (void)arg;
+    frame++;
+    set_row_text(hidden_label, rows / 2);
+    ATGL_RENDER_TREE(root);
+}
+
+static VOID bench_idle(VOIDPTR arg)
+{
+    (void)arg;
+    ATGL_RENDER_TREE(root);
+}
+
+static VOID run_case(PU8 name, BENCH_FN fn)
+{
+    BENCH_RESULT r;
+    if (!BENCH_RUN(fn, NULLPTR, RUNS, &r)) return;
+
+    ATGL_RENDER_STATS s;
+    ATGL_GET_RENDER_STATS(&s);
+
+    DEBUG_PRINTF("[UIBENCH] %s: median %d us, %d rects, %d px, %d painted, %d clipped, %d occluded\n",
+                 name, r.median_ns / 1000, s.rects, s.pixels,
+                 s.painted, s.clipped, s.occluded);
+
+    CHAR buf[96];
+    SNPRINTF(buf, sizeof(buf), "%-7s %7d us %2d rects %7d px %4d drawn %3d occl",
+             name, r.median_ns / 1000, s.rects, s.pixels, s.painted, s.occluded);
+    ATGL_LISTBOX_ADD_ITEM(results, (PU8)buf);
+}
+
+static VOID run_benchmarks(VOID)
+{
+    if (!TSC_KHZ()) {
+        ATGL_LISTBOX_ADD_ITEM(results, (PU8)"No TSC, nothing timed");
+        return;
+    }
+    ATGL_RENDER_TREE(root);
+
+    run_case((PU8)"full",   bench_full);
+    run_case((PU8)"label",  bench_label);
+    run_case((PU8)"bars",   bench_bars);
+    run_case((PU8)"hidden", bench_hidden);
+    run_case((PU8)"idle",   bench_idle);
+}
+
+CMAIN()
+{
+    DISABLE_SHELL_KEYBOARD();
+    ON_EXIT(ENABLE_SHELL_KEYBOARD);
+
+    ATGL_INIT();
+    ATGL_CREATE_SCREEN(ATGL_SA_NONE);
+
+    U32 width = ATGL_GET_SCREEN_WIDTH();
+    U32 height = ATGL_GET_SCREEN_HEIGHT();
+
+    root = ATGL_GET_SCREEN_ROOT_NODE();
+
+    // Header
+    PATGL_NODE header = ATGL_CREATE_PANEL(root, (ATGL_RECT){0, 0, width, 40}, ATGL_LAYOUT_HORIZONTAL, 4, 8);
+    ATGL_NODE_SET_COLORS(header, RGB(255, 255, 255), RGB(40, 40, 40));
+    ATGL_CREATE_BUTTON(header, (ATGL_RECT){0, 0, 100, 24}, (PU8)"Processes", NULLPTR);
+    ATGL_CREATE_BUTTON(header, (ATGL_RECT){0, 0, 100, 24}, (PU8)"Performance", NULLPTR);
+    ATGL_CREATE_BUTTON(header, (ATGL_RECT){0, 0, 80, 24}, (PU8)"Refresh", NULLPTR);
+    ATGL_CREATE_LABEL(header, (ATGL_RECT){0, 0, 300, 24}, (PU8)"UIBENCH - ESC to quit", RGB(220, 220, 220), VBE_SEE_THROUGH);
+
+    // Columns of labels and progress bars
+    PATGL_NODE grid = ATGL_CREATE_PANEL(root, (ATGL_RECT){0, 40, width, height - 40}, ATGL_LAYOUT_HORIZONTAL, 4, 4);
+    I32 col_w = ((I32)width - 8 - 4 * (COLUMNS - 1)) / COLUMNS;
+    rows = (height - 40 - 16) / (LABEL_H + BAR_H + 4);
+    if (rows > MAX_ROWS) rows = MAX_ROWS;
+
+    for (U32 c = 0; c < COLUMNS; c++) {
+        PATGL_NODE col = ATGL_CREATE_PANEL(grid, (ATGL_RECT){0, 0, col_w, (I32)height - 48}, ATGL_LAYOUT_VERTICAL, 4, 2);
+        for (U32 r = 0; r < rows; r++) {
+            labels[c][r] = ATGL_CREATE_LABEL(col, (ATGL_RECT){0, 0, col_w - 8, LABEL_H}, (PU8)"", RGB(255, 255, 255), VBE_SEE_THROUGH);
+            set_row_text(labels[c][r], r);
+            bars[c][r] = ATGL_CREATE_PROGRESSBAR(col, (ATGL_RECT){0, 0, col_w - 8, BAR_H}, 100);
+            ATGL_PROGRESSBAR_SET(bars[c][r], (c * 13 + r * 7) % 100);
+        }
+    }
+    hidden_label = labels[COLUMNS / 2][rows / 2];
+
+    // Opaque results panel over the middle columns
+    PATGL_NODE overlay = ATGL_CREATE_PANEL(root, (ATGL_RECT){width / 4, height / 4, width / 2, height / 2}, ATGL_LAYOUT_NONE, 0, 0);
+    ATGL_NODE_SET_TEXT(overlay, (PU8)"Render pass, median of 100 frames");
+    results = ATGL_CREATE_LISTBOX(overlay, (ATGL_RECT){8, 16, (I32)width / 2 - 16, (I32)height / 2 - 24}, 12);
+
+    return 0;
+}
+
+void ATGL_EVENT_LOOP(ATGL_EVENT *ev)
+{
+    if (ev->type == ATGL_EVT_KEY_DOWN && ev->key.keycode == KEY_ESC) {
+        ATGL_QUIT();
+        return;
+    }
+    ATGL_DISPATCH_EVENT(root, ev);
+}
+
+void ATGL_GRAPHICS_LOOP(U32 ticks)
+{
+    (void)ticks;
+    if (!benchmarked) {
+        benchmarked = TRUE;
+        run_benchmarks();
+    }
+    ATGL_RENDER_TREE(root);
+}
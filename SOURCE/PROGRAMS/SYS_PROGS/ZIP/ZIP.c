@@ -1,3 +1,4 @@
+#include <LIBRARIES/ATZP/ATZ.h>
 #include <LIBRARIES/ATZP/ATZP.h>
 #include <STD/STRING.h>
 #include <STD/MEM.h>
@@ -6,45 +7,29 @@
 
 /*
  * ════════════════════════════════════════════════════════════════════
- *  ATZ Archive Format  (.atz)
+ *  ZIP - ATZ archive utility
  *
- *  [4]  magic        "ATZ1"
- *  [4]  file_count   U32
- *  Per file entry:
- *    [2]  name_len        U16
- *    [?]  name            bytes (relative stored path, no leading /)
- *    [4]  original_size   U32
- *    [4]  compressed_size U32
- *    [4]  data_offset     U32  (absolute byte offset from start of file)
- *    [1]  flags           U8   (bit 0 = 1: LZ4 compressed, 0: stored raw)
- *  Data section (compressed blocks back to back)
+ *  The archive format is described in LIBRARIES/ATZP/ATZ.h. New
+ *  archives are written as version 2 (central directory + CRC32);
+ *  version 1 archives can still be listed and extracted.
  *
  *  Usage:
- *    ZIP zip   <out.atz> <path1> [path2 ...]
- *    ZIP unzip <arch.atz> [dest/]
- *    ZIP list  <arch.atz>
+ *    ZIP zip     [--hc] <out.atz> <path1> [path2 ...]
+ *    ZIP unzip   <arch.atz> [dest/]
+ *    ZIP extract <arch.atz> <name> [dest/]
+ *    ZIP list    <arch.atz>
+ *    ZIP test    <arch.atz>
  * ════════════════════════════════════════════════════════════════════
  */
 
-#define ATZ_MAGIC       "ATZ1"
-#define ATZ_MAX_FILES   256
 #define ATZ_MAX_PATH    512
-#define ATZ_FLAG_LZ4    0x01  /* entry is LZ4 compressed */
-#define ATZ_HDR_ENTRY_FIXED (2 + 4 + 4 + 4 + 1)  /* name_len + orig + comp + off + flags */
 
-/* ── In-memory entry descriptor ──────────────────────────────────── */
 typedef struct {
-    U8  stored[ATZ_MAX_PATH];   /* relative name stored in archive     */
-    U8  fs_path[ATZ_MAX_PATH];  /* absolute FS path for reading/writing*/
-    U32 original_size;
-    U32 compressed_size;
-    U32 data_offset;
-    U8  flags;
-    PU8 compressed_data;        /* heap buffer, used during zip only   */
-} ATZ_ENTRY;
-
-static ATZ_ENTRY g_entries[ATZ_MAX_FILES];
-static U32       g_entry_count;
+    ATZ_WRITER *writer;
+    U32         files;
+    U32         total_orig;
+    BOOL        failed;
+} ZIP_JOB;
 
 /* ── Path helpers ─────────────────────────────────────────────────── */
 
@@ -75,26 +60,71 @@ static VOID ensure_dirs(PU8 path) {
     }
 }
 
+/* ── Archive I/O callbacks ───────────────────────────────────────── */
+
+static BOOL file_read_at(VOIDPTR io, U32 offset, PU8 buf, U32 len) {
+    FILE *f = (FILE *)io;
+    if (!FSEEK(f, offset)) return FALSE;
+    return FREAD(f, buf, len) == len;
+}
+
+static BOOL open_archive(PU8 path, FILE **out_file, ATZ_READER *r) {
+    FILE *f = FOPEN(path, MODE_FR);
+    if (!f) {
+        printf("[ZIP] Error: cannot open '%s'\n", path);
+        return FALSE;
+    }
+    if (!ATZ_READER_OPEN(r, file_read_at, f, FSIZE(f))) {
+        printf("[ZIP] Error: '%s' is not a valid ATZ archive.\n", path);
+        FCLOSE(f);
+        return FALSE;
+    }
+    *out_file = f;
+    return TRUE;
+}
+
+static VOID close_archive(FILE *f, ATZ_READER *r) {
+    ATZ_READER_CLOSE(r);
+    FCLOSE(f);
+}
+
 /* ── Recursive file collection ───────────────────────────────────── */
 
-static VOID collect_files(PU8 fs_path, PU8 stored_prefix) {
-    if (g_entry_count >= ATZ_MAX_FILES) {
-        printf("[ZIP] Warning: max file limit (%d) reached.\n", ATZ_MAX_FILES);
+/* Reads one file and hands it to the writer; nothing is kept per entry
+   except its directory record, so the file count is unbounded. */
+static VOID add_file(ZIP_JOB *job, PU8 fs_path, PU8 stored) {
+    FILE *f = FOPEN(fs_path, MODE_FR);
+    if (!f) {
+        printf("[ZIP] Error: cannot open '%s'\n", fs_path);
+        job->failed = TRUE;
+        return;
+    }
+
+    U32 orig = FSIZE(f);
+    PU8 raw = (PU8)MAlloc(orig ? orig : 1);
+    if (!raw) {
+        FCLOSE(f);
+        job->failed = TRUE;
         return;
     }
+    if (orig) FREAD(f, raw, orig);
+    FCLOSE(f);
+
+    if (!ATZ_WRITER_ADD(job->writer, stored, raw, orig)) {
+        printf("[ZIP] Error: cannot add '%s'\n", fs_path);
+        job->failed = TRUE;
+    } else {
+        job->files++;
+        job->total_orig += orig;
+    }
+    MFree(raw);
+}
+
+static VOID collect_files(ZIP_JOB *job, PU8 fs_path, PU8 stored_prefix) {
+    if (job->failed) return;
 
     if (FILE_EXISTS(fs_path)) {
-        /* Plain file - add entry */
-        ATZ_ENTRY *e = &g_entries[g_entry_count++];
-        STRNCPY((PU8)e->stored,  stored_prefix, ATZ_MAX_PATH - 1);
-        STRNCPY((PU8)e->fs_path, fs_path,        ATZ_MAX_PATH - 1);
-        e->stored[ATZ_MAX_PATH - 1]  = '\0';
-        e->fs_path[ATZ_MAX_PATH - 1] = '\0';
-        e->original_size    = 0;
-        e->compressed_size  = 0;
-        e->data_offset      = 0;
-        e->flags            = 0;
-        e->compressed_data  = NULLPTR;
+        add_file(job, fs_path, stored_prefix);
         return;
     }
 
@@ -130,7 +160,7 @@ static VOID collect_files(PU8 fs_path, PU8 stored_prefix) {
             U8 child_stored[ATZ_MAX_PATH];
             path_join(child_fs,     ATZ_MAX_PATH, fs_path,        (PU8)ch->lfn);
             path_join(child_stored, ATZ_MAX_PATH, stored_prefix,  (PU8)ch->lfn);
-            collect_files(child_fs, child_stored);
+            collect_files(job, child_fs, child_stored);
         }
         return;
     }
@@ -141,160 +171,130 @@ static VOID collect_files(PU8 fs_path, PU8 stored_prefix) {
 /* ── ZIP command ─────────────────────────────────────────────────── */
 
 static U32 cmd_zip(U32 argc, PPU8 argv) {
-    if (argc < 3) {
-        printf("Usage: ZIP zip <out.atz> <path1> [path2 ...]\n");
+    U32 first = 2;
+    U32 hc_level = 0;
+    if (argc > 2 && STRCMP(argv[2], "--hc") == 0) {
+        hc_level = LZ4HC_LEVEL_DEFAULT;
+        first++;
+    }
+    if (argc < first + 2) {
+        printf("Usage: ZIP zip [--hc] <out.atz> <path1> [path2 ...]\n");
         return 1;
     }
 
-    PU8 out_path = argv[2];
-    g_entry_count = 0;
-    U32 fi;
+    PU8 out_path = argv[first];
+    ATZ_MEM_SINK sink = { 0 };
+    ATZ_WRITER writer;
+    ZIP_JOB job = { 0 };
+    U32 rc = 1;
 
-    /* Collect all input paths */
+    if (!ATZ_WRITER_INIT(&writer, ATZ_MEM_SINK_WRITE, &sink, hc_level)) {
+        printf("[ZIP] Error: out of memory\n");
+        return 1;
+    }
+    job.writer = &writer;
+
+    /* Walk, read and compress each input straight into the archive image */
     U32 a;
-    for (a = 3; a < argc; a++) {
+    for (a = first + 1; a < argc && !job.failed; a++) {
         PU8 fspath = argv[a];
         /* Stored name = last path component */
         PU8 sep = STRRCHR(fspath, '/');
         PU8 stored_root = sep ? sep + 1 : fspath;
-        collect_files(fspath, stored_root);
+        collect_files(&job, fspath, stored_root);
     }
 
-    if (g_entry_count == 0) {
+    if (job.failed) goto zip_cleanup;
+    if (job.files == 0) {
         printf("[ZIP] No files found.\n");
-        return 1;
-    }
-
-    /* Compress each file */
-    for (fi = 0; fi < g_entry_count; fi++) {
-        ATZ_ENTRY *e = &g_entries[fi];
-
-        FILE *f = FOPEN((PU8)e->fs_path, MODE_FR);
-        if (!f) {
-            printf("[ZIP] Error: cannot open '%s'\n", e->fs_path);
-            goto zip_cleanup;
-        }
-
-        U32 orig = FSIZE(f);
-        e->original_size = orig;
-
-        PU8 raw = (PU8)MAlloc(orig ? orig : 1);
-        if (!raw) { FCLOSE(f); goto zip_cleanup; }
-        if (orig) FREAD(f, raw, orig);
-        FCLOSE(f);
-
-        U32 bound = LZ4_COMPRESS_BOUND(orig);
-        PU8 cmp   = (PU8)MAlloc(bound);
-        if (!cmp) { MFree(raw); goto zip_cleanup; }
-
-        U32 cmp_sz = 0;
-        if (orig > 0) cmp_sz = LZ4_COMPRESS(raw, orig, cmp, bound);
-        MFree(raw);
-
-        if (cmp_sz > 0 && cmp_sz < orig) {
-            /* Compressed is smaller - store LZ4 */
-            e->compressed_size = cmp_sz;
-            e->flags           = ATZ_FLAG_LZ4;
-            e->compressed_data = cmp;
-        } else {
-            /* Store raw (empty file, or compression expanded data) */
-            MFree(cmp);
-            e->compressed_size = orig;
-            e->flags           = 0;
-            e->compressed_data = NULLPTR;
-
-            if (orig > 0) {
-                /* Re-read raw for storage */
-                FILE *f2 = FOPEN((PU8)e->fs_path, MODE_FR);
-                if (!f2) goto zip_cleanup;
-                PU8 raw2 = (PU8)MAlloc(orig);
-                if (!raw2) { FCLOSE(f2); goto zip_cleanup; }
-                FREAD(f2, raw2, orig);
-                FCLOSE(f2);
-                e->compressed_data = raw2;
-            }
-        }
-    }
-
-    /* Calculate header size and assign data offsets */
-    U32 header_sz = 4 + 4; /* magic + count */
-    for (fi = 0; fi < g_entry_count; fi++) {
-        U16 nlen  = (U16)STRLEN(g_entries[fi].stored);
-        header_sz += ATZ_HDR_ENTRY_FIXED + nlen;
+        goto zip_cleanup;
     }
-    U32 data_off = header_sz;
-    for (fi = 0; fi < g_entry_count; fi++) {
-        g_entries[fi].data_offset = data_off;
-        data_off += g_entries[fi].compressed_size;
+    if (!ATZ_WRITER_FINISH(&writer)) {
+        printf("[ZIP] Error: cannot finish archive\n");
+        goto zip_cleanup;
     }
 
-    /* Write archive */
+    /* FWRITE rewrites the whole file, so the archive goes out in one call */
     if (FILE_EXISTS(out_path)) FILE_DELETE(out_path);
     if (!FILE_CREATE(out_path)) {
         printf("[ZIP] Error: cannot create '%s'\n", out_path);
         goto zip_cleanup;
     }
-    FILE *out = FOPEN(out_path, MODE_FA);
+    FILE *out = FOPEN(out_path, MODE_FW);
     if (!out) {
         printf("[ZIP] Error: cannot open output '%s'\n", out_path);
         goto zip_cleanup;
     }
-
-    /* Header */
-    FWRITE(out, (PU8)ATZ_MAGIC,       4);
-    FWRITE(out, (PU8)&g_entry_count,  4);
-    for (fi = 0; fi < g_entry_count; fi++) {
-        ATZ_ENTRY *e = &g_entries[fi];
-        U16 nlen = (U16)STRLEN(e->stored);
-        FWRITE(out, (PU8)&nlen,              2);
-        FWRITE(out, (PU8)e->stored,          nlen);
-        FWRITE(out, (PU8)&e->original_size,  4);
-        FWRITE(out, (PU8)&e->compressed_size,4);
-        FWRITE(out, (PU8)&e->data_offset,    4);
-        FWRITE(out, (PU8)&e->flags,          1);
-    }
-
-    /* Data blocks */
-    for (fi = 0; fi < g_entry_count; fi++) {
-        ATZ_ENTRY *e = &g_entries[fi];
-        if (e->compressed_size > 0 && e->compressed_data)
-            FWRITE(out, e->compressed_data, e->compressed_size);
-    }
+    U32 written = FWRITE(out, sink.data, sink.size);
     FCLOSE(out);
-
-    /* Summary */
-    U32 total_orig = 0, total_comp = 0;
-    for (fi = 0; fi < g_entry_count; fi++) {
-        total_orig += g_entries[fi].original_size;
-        total_comp += g_entries[fi].compressed_size;
+    if (written != sink.size) {
+        printf("[ZIP] Error: short write to '%s'\n", out_path);
+        goto zip_cleanup;
     }
+
     printf("[ZIP] Created '%s' - %u file(s), %u -> %u bytes",
-           out_path, g_entry_count, total_orig, total_comp);
-    if (total_orig > 0)
-        printf(" (%u%% of original)", (total_comp * 100) / total_orig);
+           out_path, job.files, job.total_orig, sink.size);
+    if (job.total_orig > 0)
+        printf(" (%u%% of original)", (sink.size * 100) / job.total_orig);
     printf("\n");
+    rc = 0;
 
 zip_cleanup:
-    for (fi = 0; fi < g_entry_count; fi++)
-        if (g_entries[fi].compressed_data) {
-            MFree(g_entries[fi].compressed_data);
-            g_entries[fi].compressed_data = NULLPTR;
-        }
-    return 0;
+    ATZ_WRITER_FREE(&writer);
+    ATZ_MEM_SINK_FREE(&sink);
+    return rc;
 }
 
-/* ── UNZIP command ───────────────────────────────────────────────── */
+/* ── Extraction ──────────────────────────────────────────────────── */
+
+/* Extracts one entry to dest/<stored name> (or <stored name> if dest is empty) */
+static BOOL extract_entry(ATZ_READER *r, ATZ_ENTRY *e, PU8 dest) {
+    U8 out_path[ATZ_MAX_PATH];
+    if (dest[0] != '\0')
+        path_join(out_path, ATZ_MAX_PATH, dest, e->name);
+    else
+        STRNCPY(out_path, e->name, ATZ_MAX_PATH - 1);
+    out_path[ATZ_MAX_PATH - 1] = '\0';
+
+    PU8 data = ATZ_READER_EXTRACT(r, e);
+    if (!data) {
+        printf("[ZIP] Error: '%s' is corrupt or out of memory\n", e->name);
+        return FALSE;
+    }
 
-static U32 cmd_unzip(U32 argc, PPU8 argv) {
-    if (argc < 3) {
-        printf("Usage: ZIP unzip <arch.atz> [dest/]\n");
-        return 1;
+    /* Ensure parent directories exist */
+    PU8 last_sep = STRRCHR(out_path, '/');
+    if (last_sep) {
+        U8 parent[ATZ_MAX_PATH];
+        U32 plen = (U32)(last_sep - out_path);
+        STRNCPY(parent, out_path, plen);
+        parent[plen] = '\0';
+        ensure_dirs(parent);
+        if (!DIR_EXISTS(parent)) DIR_CREATE(parent);
     }
 
-    PU8 arch_path = argv[2];
-    U8  dest[ATZ_MAX_PATH];
-    if (argc >= 4) {
-        STRNCPY(dest, argv[3], ATZ_MAX_PATH - 1);
+    BOOL ok = TRUE;
+    if (FILE_EXISTS(out_path)) FILE_DELETE(out_path);
+    FILE_CREATE(out_path);
+    if (e->original_size > 0) {
+        FILE *wf = FOPEN(out_path, MODE_FW);
+        if (wf) {
+            FWRITE(wf, data, e->original_size);
+            FCLOSE(wf);
+        } else {
+            printf("[ZIP] Error: cannot write '%s'\n", out_path);
+            ok = FALSE;
+        }
+    }
+    MFree(data);
+
+    if (ok) printf("  %s (%u bytes)\n", out_path, e->original_size);
+    return ok;
+}
+
+static VOID dest_from_arg(PU8 dest, U32 argc, PPU8 argv, U32 index) {
+    if (argc > index) {
+        STRNCPY(dest, argv[index], ATZ_MAX_PATH - 1);
         dest[ATZ_MAX_PATH - 1] = '\0';
         /* Strip trailing slash */
         U32 dlen = STRLEN(dest);
@@ -302,142 +302,62 @@ static U32 cmd_unzip(U32 argc, PPU8 argv) {
     } else {
         dest[0] = '\0'; /* extract in place (no prefix) */
     }
+}
 
-    FILE *arch = FOPEN(arch_path, MODE_FR);
-    if (!arch) {
-        printf("[ZIP] Error: cannot open '%s'\n", arch_path);
-        return 1;
-    }
+/* ── UNZIP command ───────────────────────────────────────────────── */
 
-    /* Verify magic */
-    U8 magic[4];
-    FREAD(arch, magic, 4);
-    if (magic[0] != 'A' || magic[1] != 'T' || magic[2] != 'Z' || magic[3] != '1') {
-        printf("[ZIP] Error: '%s' is not a valid ATZ archive.\n", arch_path);
-        FCLOSE(arch);
+static U32 cmd_unzip(U32 argc, PPU8 argv) {
+    if (argc < 3) {
+        printf("Usage: ZIP unzip <arch.atz> [dest/]\n");
         return 1;
     }
 
-    U32 file_count = 0;
-    FREAD(arch, (PU8)&file_count, 4);
-    printf("[ZIP] Extracting %u file(s) from '%s'...\n", file_count, arch_path);
+    U8 dest[ATZ_MAX_PATH];
+    dest_from_arg(dest, argc, argv, 3);
 
-    /* Read entry headers into memory */
-    ATZ_ENTRY *entries = (ATZ_ENTRY *)MAlloc(file_count * sizeof(ATZ_ENTRY));
-    if (!entries) {
-        printf("[ZIP] Error: out of memory\n");
-        FCLOSE(arch);
-        return 1;
-    }
+    FILE *arch;
+    ATZ_READER r;
+    if (!open_archive(argv[2], &arch, &r)) return 1;
 
+    printf("[ZIP] Extracting %u file(s) from '%s'...\n", r.count, argv[2]);
+    U32 errors = 0;
     U32 fi;
-    for (fi = 0; fi < file_count; fi++) {
-        ATZ_ENTRY *e = &entries[fi];
-        U16 nlen = 0;
-        FREAD(arch, (PU8)&nlen, 2);
-        if (nlen >= ATZ_MAX_PATH) nlen = ATZ_MAX_PATH - 1;
-        FREAD(arch, (PU8)e->stored, nlen);
-        e->stored[nlen] = '\0';
-        FREAD(arch, (PU8)&e->original_size,   4);
-        FREAD(arch, (PU8)&e->compressed_size, 4);
-        FREAD(arch, (PU8)&e->data_offset,     4);
-        FREAD(arch, (PU8)&e->flags,           1);
-        e->compressed_data = NULLPTR;
-    }
-
-    /* Extract each file */
-    for (fi = 0; fi < file_count; fi++) {
-        ATZ_ENTRY *e = &entries[fi];
-
-        /* Build output path */
-        U8 out_path[ATZ_MAX_PATH];
-        if (dest[0] != '\0')
-            path_join(out_path, ATZ_MAX_PATH, dest, (PU8)e->stored);
-        else
-            STRNCPY(out_path, (PU8)e->stored, ATZ_MAX_PATH - 1);
-        out_path[ATZ_MAX_PATH - 1] = '\0';
+    for (fi = 0; fi < r.count; fi++)
+        if (!extract_entry(&r, &r.entries[fi], dest)) errors++;
 
-        /* Seek to compressed data */
-        if (!FSEEK(arch, e->data_offset)) {
-            printf("[ZIP] Error: seek failed for '%s'\n", e->stored);
-            continue;
-        }
+    close_archive(arch, &r);
+    if (errors) {
+        printf("[ZIP] Done with %u error(s).\n", errors);
+        return 1;
+    }
+    printf("[ZIP] Done.\n");
+    return 0;
+}
 
-        /* Read compressed data */
-        PU8 cmp_buf = NULLPTR;
-        if (e->compressed_size > 0) {
-            cmp_buf = (PU8)MAlloc(e->compressed_size);
-            if (!cmp_buf) {
-                printf("[ZIP] Error: out of memory for '%s'\n", e->stored);
-                continue;
-            }
-            FREAD(arch, cmp_buf, e->compressed_size);
-        }
+/* ── EXTRACT command ─────────────────────────────────────────────── */
 
-        /* Decompress or copy */
-        PU8 out_data = NULLPTR;
-        U32 out_sz   = 0;
-
-        if (e->original_size == 0) {
-            /* Empty file */
-            out_data = NULLPTR;
-            out_sz   = 0;
-        } else if (e->flags & ATZ_FLAG_LZ4) {
-            out_data = (PU8)MAlloc(e->original_size);
-            if (!out_data) {
-                printf("[ZIP] Error: out of memory for '%s'\n", e->stored);
-                if (cmp_buf) MFree(cmp_buf);
-                continue;
-            }
-            out_sz = LZ4_DECOMPRESS(cmp_buf, e->compressed_size,
-                                    out_data, e->original_size);
-            if (out_sz == 0 && e->original_size > 0) {
-                printf("[ZIP] Error: decompression failed for '%s'\n", e->stored);
-                MFree(out_data);
-                if (cmp_buf) MFree(cmp_buf);
-                continue;
-            }
-        } else {
-            /* Stored raw */
-            out_data = cmp_buf;
-            out_sz   = e->compressed_size;
-            cmp_buf  = NULLPTR; /* transferred ownership */
-        }
-
-        /* Ensure parent directories exist */
-        PU8 last_sep = STRRCHR(out_path, '/');
-        if (last_sep) {
-            U8 parent[ATZ_MAX_PATH];
-            U32 plen = (U32)(last_sep - out_path);
-            STRNCPY(parent, out_path, plen);
-            parent[plen] = '\0';
-            ensure_dirs(parent);
-            if (!DIR_EXISTS(parent)) DIR_CREATE(parent);
-        }
+static U32 cmd_extract(U32 argc, PPU8 argv) {
+    if (argc < 4) {
+        printf("Usage: ZIP extract <arch.atz> <name> [dest/]\n");
+        return 1;
+    }
 
-        /* Write output file */
-        if (FILE_EXISTS(out_path)) FILE_DELETE(out_path);
-        FILE_CREATE(out_path);
-        if (out_sz > 0 && out_data) {
-            FILE *wf = FOPEN(out_path, MODE_FW);
-            if (wf) {
-                FWRITE(wf, out_data, out_sz);
-                FCLOSE(wf);
-            } else {
-                printf("[ZIP] Error: cannot write '%s'\n", out_path);
-            }
-        }
+    U8 dest[ATZ_MAX_PATH];
+    dest_from_arg(dest, argc, argv, 4);
 
-        printf("  %s (%u bytes)\n", out_path, e->original_size);
+    FILE *arch;
+    ATZ_READER r;
+    if (!open_archive(argv[2], &arch, &r)) return 1;
 
-        if (out_data) MFree(out_data);
-        if (cmp_buf)  MFree(cmp_buf);
-    }
+    U32 rc = 1;
+    ATZ_ENTRY *e = ATZ_READER_FIND(&r, argv[3]);
+    if (!e)
+        printf("[ZIP] Error: '%s' not found in archive.\n", argv[3]);
+    else if (extract_entry(&r, e, dest))
+        rc = 0;
 
-    FCLOSE(arch);
-    MFree(entries);
-    printf("[ZIP] Done.\n");
-    return 0;
+    close_archive(arch, &r);
+    return rc;
 }
 
 /* ── LIST command ────────────────────────────────────────────────── */
@@ -448,81 +368,90 @@ static U32 cmd_list(U32 argc, PPU8 argv) {
         return 1;
     }
 
-    FILE *arch = FOPEN(argv[2], MODE_FR);
-    if (!arch) {
-        printf("[ZIP] Error: cannot open '%s'\n", argv[2]);
-        return 1;
-    }
-
-    U8 magic[4];
-    FREAD(arch, magic, 4);
-    if (magic[0] != 'A' || magic[1] != 'T' || magic[2] != 'Z' || magic[3] != '1') {
-        printf("[ZIP] Error: not a valid ATZ archive.\n");
-        FCLOSE(arch);
-        return 1;
-    }
-
-    U32 file_count = 0;
-    FREAD(arch, (PU8)&file_count, 4);
+    FILE *arch;
+    ATZ_READER r;
+    if (!open_archive(argv[2], &arch, &r)) return 1;
 
-    printf("  %-40s  %10s  %10s  %s\n", "Name", "Original", "Stored", "Method");
-    printf("  %-40s  %10s  %10s  %s\n", "----", "--------", "------", "------");
+    printf("  %-40s  %10s  %10s  %-6s  %s\n", "Name", "Original", "Stored", "Method", "CRC32");
+    printf("  %-40s  %10s  %10s  %-6s  %s\n", "----", "--------", "------", "------", "-----");
 
     U32 total_orig = 0, total_comp = 0;
     U32 fi;
-    for (fi = 0; fi < file_count; fi++) {
-        U8  name[ATZ_MAX_PATH];
-        U32 orig, comp, off;
-        U8  flags;
-        U16 nlen = 0;
-
-        FREAD(arch, (PU8)&nlen, 2);
-        if (nlen >= ATZ_MAX_PATH) nlen = ATZ_MAX_PATH - 1;
-        FREAD(arch, name, nlen);
-        name[nlen] = '\0';
-        FREAD(arch, (PU8)&orig,  4);
-        FREAD(arch, (PU8)&comp,  4);
-        FREAD(arch, (PU8)&off,   4);
-        FREAD(arch, (PU8)&flags, 1);
-
-        PU8 method = (flags & ATZ_FLAG_LZ4) ? "lz4" : "store";
+    for (fi = 0; fi < r.count; fi++) {
+        ATZ_ENTRY *e = &r.entries[fi];
+        PU8 method = (e->flags & ATZ_FLAG_LZ4) ? "lz4" : "store";
 
         /* Truncate name display if too long */
         U8 disp[41];
-        U32 nlen32 = STRLEN(name);
-        if (nlen32 > 40) {
-            STRNCPY(disp, name, 37);
+        if (STRLEN(e->name) > 40) {
+            STRNCPY(disp, e->name, 37);
             disp[37] = '.'; disp[38] = '.'; disp[39] = '.'; disp[40] = '\0';
         } else {
-            STRCPY(disp, name);
+            STRCPY(disp, e->name);
         }
 
-        printf("  %-40s  %10u  %10u  %s\n", disp, orig, comp, method);
-        total_orig += orig;
-        total_comp += comp;
+        if (e->flags & ATZ_FLAG_CRC)
+            printf("  %-40s  %10u  %10u  %-6s  %08X\n", disp, e->original_size, e->compressed_size, method, e->crc32);
+        else
+            printf("  %-40s  %10u  %10u  %-6s  -\n", disp, e->original_size, e->compressed_size, method);
+        total_orig += e->original_size;
+        total_comp += e->compressed_size;
     }
 
     printf("  %-40s  %10s  %10s\n", "----", "--------", "------");
     printf("  %-40s  %10u  %10u", (PU8)"-", total_orig, total_comp);
     if (total_orig > 0)
         printf("  (%u%%)", (total_comp * 100) / total_orig);
-    printf("\n  %u file(s)\n", file_count);
+    printf("\n  %u file(s), format v%u\n", r.count, r.version);
 
-    FCLOSE(arch);
+    close_archive(arch, &r);
     return 0;
 }
 
+/* ── TEST command ────────────────────────────────────────────────── */
+
+static U32 cmd_test(U32 argc, PPU8 argv) {
+    if (argc < 3) {
+        printf("Usage: ZIP test <arch.atz>\n");
+        return 1;
+    }
+
+    FILE *arch;
+    ATZ_READER r;
+    if (!open_archive(argv[2], &arch, &r)) return 1;
+
+    U32 bad = 0;
+    U32 fi;
+    for (fi = 0; fi < r.count; fi++) {
+        PU8 data = ATZ_READER_EXTRACT(&r, &r.entries[fi]);
+        if (!data) {
+            printf("  FAIL  %s\n", r.entries[fi].name);
+            bad++;
+        } else {
+            MFree(data);
+        }
+    }
+
+    if (r.version < 2)
+        printf("[ZIP] Note: v1 archive has no checksums; only decoding was checked.\n");
+    printf("[ZIP] %u file(s) tested, %u error(s).\n", r.count, bad);
+    close_archive(arch, &r);
+    return bad ? 1 : 0;
+}
+
 /* ── Help ────────────────────────────────────────────────────────── */
 
 static VOID print_help(VOID) {
     printf("ZIP - ATZ archive utility (LZ4 compression)\n\n");
-    printf("  ZIP zip   <out.atz> <path1> [path2 ...]   Create archive\n");
-    printf("  ZIP unzip <arch.atz> [dest/]               Extract archive\n");
-    printf("  ZIP list  <arch.atz>                       List contents\n");
+    printf("  ZIP zip [--hc] <out.atz> <path1> [...]     Create archive\n");
+    printf("  ZIP unzip   <arch.atz> [dest/]             Extract archive\n");
+    printf("  ZIP extract <arch.atz> <name> [dest/]      Extract one file\n");
+    printf("  ZIP list    <arch.atz>                     List contents\n");
+    printf("  ZIP test    <arch.atz>                     Verify CRC32s\n");
     printf("  ZIP --help                                  Show this help\n\n");
     printf("  Directories are added recursively.\n");
-    printf("  Files are compressed with LZ4; stored raw if compression\n");
-    printf("  does not reduce size.\n");
+    printf("  Files are compressed with LZ4 (--hc: LZ4 HC); stored raw if\n");
+    printf("  compression does not reduce size.\n");
 }
 
 /* ── Entry point ─────────────────────────────────────────────────── */
@@ -533,9 +462,11 @@ U32 main(U32 argc, PPU8 argv) {
         return 0;
     }
 
-    if (STRCMP(argv[1], "zip") == 0)   return cmd_zip(argc, argv);
-    if (STRCMP(argv[1], "unzip") == 0) return cmd_unzip(argc, argv);
-    if (STRCMP(argv[1], "list") == 0)  return cmd_list(argc, argv);
+    if (STRCMP(argv[1], "zip") == 0)     return cmd_zip(argc, argv);
+    if (STRCMP(argv[1], "unzip") == 0)   return cmd_unzip(argc, argv);
+    if (STRCMP(argv[1], "extract") == 0) return cmd_extract(argc, argv);
+    if (STRCMP(argv[1], "list") == 0)    return cmd_list(argc, argv);
+    if (STRCMP(argv[1], "test") == 0)    return cmd_test(argc, argv);
 
     printf("[ZIP] Unknown command '%s'. Run ZIP --help for usage.\n", argv[1]);
     return 1;
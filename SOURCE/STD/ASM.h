@@ -97,6 +97,54 @@ static inline void mfence(void) {
     __asm__ volatile("mfence" ::: "memory");
 }
 
+// Time stamp counter. The low half alone covers intervals up to ~1 s
+static inline void rdtsc(U32 *lo, U32 *hi) {
+    __asm__ volatile("rdtsc" : "=a"(*lo), "=d"(*hi));
+}
+
+static inline U32 rdtsc_lo(void) {
+    U32 lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    (void)hi;
+    return lo;
+}
+
+// Model specific registers. Kernel only, and only after checking CPUID
+static inline void rdmsr(U32 msr, U32 *lo, U32 *hi) {
+    __asm__ volatile("rdmsr" : "=a"(*lo), "=d"(*hi) : "c"(msr));
+}
+
+static inline void wrmsr(U32 msr, U32 lo, U32 hi) {
+    __asm__ volatile("wrmsr" : : "c"(msr), "a"(lo), "d"(hi));
+}
+
+// a * b / c with a 64-bit intermediate and no libgcc. Saturates at U32_MAX
+static inline U32 umuldiv32(U32 a, U32 b, U32 c) {
+    U32 lo, hi, q, r;
+    __asm__("mull %3" : "=a"(lo), "=d"(hi) : "a"(a), "rm"(b));
+    if (hi >= c) return 0xFFFFFFFF;
+    __asm__("divl %4" : "=a"(q), "=d"(r) : "a"(lo), "d"(hi), "rm"(c));
+    (void)r;
+    return q;
+}
+
+static inline BOOL irq_enabled(void) {
+    U32 flags;
+    __asm__ volatile("pushfl; popl %0" : "=r"(flags));
+    return (flags & 0x200) != 0;
+}
+
+// Disables interrupts and returns the previous EFLAGS for irq_restore
+static inline U32 irq_save(void) {
+    U32 flags;
+    __asm__ volatile("pushfl; popl %0; cli" : "=r"(flags) :: "memory");
+    return flags;
+}
+
+static inline void irq_restore(U32 flags) {
+    if (flags & 0x200) __asm__ volatile("sti" ::: "memory");
+}
+
 static inline void NMI_enable() {
     _outb(0x70, _inb(0x70) & 0x7F);
     _inb(0x71);
@@ -0,0 +1,106 @@
+#include <STD/BENCH.h>
+#include <STD/TIME.h>
+#include <STD/MEM.h>
+#include <STD/IO.h>
+
+static U32 timer_overhead ATTRIB_DATA = 0;
+static BOOLEAN overhead_measured ATTRIB_DATA = FALSE;
+
+static VOID empty_fn(VOIDPTR arg) {
+    (void)arg;
+}
+
+// Shell sort, the sample count is small and this runs outside the timed region
+static VOID sort_u32(U32 *v, U32 n) {
+    for (U32 gap = n / 2; gap; gap /= 2) {
+        for (U32 i = gap; i < n; i++) {
+            U32 x = v[i];
+            U32 j = i;
+            while (j >= gap && v[j - gap] > x) {
+                v[j] = v[j - gap];
+                j -= gap;
+            }
+            v[j] = x;
+        }
+    }
+}
+
+static U32 time_call(BENCH_FN fn, VOIDPTR arg) {
+    U32 start = TSC_NOW();
+    fn(arg);
+    return TSC_NOW() - start;
+}
+
+static U32 measure_overhead(VOID) {
+    U32 best = U32_MAX;
+    for (U32 i = 0; i < 64; i++) {
+        U32 c = time_call(empty_fn, NULLPTR);
+        if (c < best) best = c;
+    }
+    return best;
+}
+
+VOID BENCH_SUMMARIZE(U32 *cycles, U32 n, BENCH_RESULT *out) {
+    MEMZERO(out, sizeof(BENCH_RESULT));
+    if (!n) return;
+    sort_u32(cycles, n);
+
+    U32 median = (n & 1) ? cycles[n / 2] : cycles[n / 2 - 1] + (cycles[n / 2] - cycles[n / 2 - 1]) / 2;
+    // Mean of per-run times in ns, accumulated without 64-bit division
+    U32 sum_ns = 0, rem = 0;
+    for (U32 i = 0; i < n; i++) {
+        U32 ns = TSC_TO_NS(cycles[i]);
+        sum_ns += ns / n;
+        rem += ns % n;
+        if (rem >= n) {
+            sum_ns += rem / n;
+            rem %= n;
+        }
+    }
+
+    out->runs = n;
+    out->min_ns = TSC_TO_NS(cycles[0]);
+    out->max_ns = TSC_TO_NS(cycles[n - 1]);
+    out->median_ns = TSC_TO_NS(median);
+    out->mean_ns = sum_ns;
+    out->median_cycles = median;
+}
+
+BOOLEAN BENCH_RUN(BENCH_FN fn, VOIDPTR arg, U32 runs, BENCH_RESULT *out) {
+    if (!fn || !out || !runs || !TSC_KHZ()) return FALSE;
+    if (runs > BENCH_MAX_RUNS) runs = BENCH_MAX_RUNS;
+
+    U32 *cycles = MAlloc(runs * sizeof(U32));
+    if (!cycles) return FALSE;
+    if (!overhead_measured) {
+        timer_overhead = measure_overhead();
+        overhead_measured = TRUE;
+    }
+
+    fn(arg);
+    for (U32 i = 0; i < runs; i++) {
+        U32 c = time_call(fn, arg);
+        cycles[i] = c > timer_overhead ? c - timer_overhead : 0;
+    }
+
+    BENCH_SUMMARIZE(cycles, runs, out);
+    MFree(cycles);
+    return TRUE;
+}
+
+// Prints ns below 10 us, us below 10 ms, ms beyond, so columns stay narrow
+static VOID print_time(U32 ns) {
+    if (ns < 10000) printf((PU8)" %7d ns", ns);
+    else if (ns < 10000000) printf((PU8)" %7d us", ns / 1000);
+    else printf((PU8)" %7d ms", ns / 1000000);
+}
+
+VOID BENCH_PRINT(PU8 name, BENCH_RESULT *r) {
+    printf((PU8)"%-24s %6d runs  min", name, r->runs);
+    print_time(r->min_ns);
+    printf((PU8)"  med");
+    print_time(r->median_ns);
+    printf((PU8)"  max");
+    print_time(r->max_ns);
+    printf((PU8)"\n");
+}
@@ -0,0 +1,44 @@
+/*+++
+    SOURCE/STD/BENCH.h - Micro-benchmark harness
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Times repeated calls of a function with the TSC (see TSC_NOW in
+    STD/TIME.h) and reports min/median/max. The cost of the timing itself
+    is measured once and subtracted from every sample.
+
+    The median is the number to compare; min shows the best case with warm
+    caches, max mostly shows timer interrupts and task switches.
+---*/
+#ifndef STD_BENCH_H
+#define STD_BENCH_H
+
+#include <STD/TYPEDEF.h>
+
+#define BENCH_MAX_RUNS 4096
+
+typedef VOID (*BENCH_FN)(VOIDPTR arg);
+
+typedef struct {
+    U32 runs;
+    U32 min_ns;
+    U32 median_ns;
+    U32 max_ns;
+    U32 mean_ns;
+    U32 median_cycles;
+} BENCH_RESULT;
+
+// Calls fn(arg) once to warm up, then `runs` timed times (capped at BENCH_MAX_RUNS).
+// Returns FALSE if the TSC is unavailable or out of memory
+BOOLEAN BENCH_RUN(BENCH_FN fn, VOIDPTR arg, U32 runs, BENCH_RESULT *out);
+
+// Fills `out` from raw cycle samples; sorts `cycles` in place
+VOID BENCH_SUMMARIZE(U32 *cycles, U32 n, BENCH_RESULT *out);
+
+// One aligned line: name, runs, min/median/max
+VOID BENCH_PRINT(PU8 name, BENCH_RESULT *r);
+
+#endif // STD_BENCH_H
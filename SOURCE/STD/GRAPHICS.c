@@ -1,12 +1,130 @@
 #include <STD/GRAPHICS.h>
 #include <CPU/SYSCALL/SYSCALL.h>
 #include <STD/MEM.h>
+#include <STD/STRING.h>
+
+/* ---- Batch recording ---- */
+
+static DRAW_BATCH *batch ATTRIB_DATA = NULLPTR;
+
+static inline BOOLEAN batch_clipped(DRAW_BATCH *b) {
+    return b->clip_w && b->clip_h;
+}
+
+static VOID write_clip(U32 *p, I32 x, I32 y, U32 w, U32 h) {
+    p[0] = VBE_CMD_HEADER(VBE_CMD_CLIP, VBE_CMD_CLIP_WORDS);
+    p[1] = (U32)x; p[2] = (U32)y;
+    p[3] = w; p[4] = h;
+}
+
+/* Room for `words` more words in the active batch, submitting it first when
+   full. NULLPTR when not batching or the command can never fit.
+   The kernel resets the clip on every submit, so a new segment starts by
+   setting the batch's clip again. */
+static U32 *batch_reserve(U32 words) {
+    if (!batch) return NULLPTR;
+    if (batch->used + words > batch->cap) DRAW_BATCH_SUBMIT(batch);
+    if (!batch->used && batch_clipped(batch)) {
+        if (VBE_CMD_CLIP_WORDS + words > batch->cap) return NULLPTR;
+        write_clip(batch->words, batch->clip_x, batch->clip_y, batch->clip_w, batch->clip_h);
+        batch->used = VBE_CMD_CLIP_WORDS;
+    }
+    if (batch->used + words > batch->cap) return NULLPTR;
+    U32 *p = &batch->words[batch->used];
+    batch->used += words;
+    return p;
+}
+
+/* Calls that always trap must land after what is already recorded */
+static inline VOID batch_flush(VOID) {
+    if (batch && batch->used) DRAW_BATCH_SUBMIT(batch);
+}
+
+static BOOLEAN batch_shape(U32 op, U32 a, U32 b, U32 c, U32 d, VBE_COLOUR colour) {
+    U32 *p = batch_reserve(VBE_CMD_SHAPE_WORDS);
+    if (!p) return FALSE;
+    p[0] = VBE_CMD_HEADER(op, VBE_CMD_SHAPE_WORDS);
+    p[1] = a; p[2] = b; p[3] = c; p[4] = d;
+    p[5] = colour;
+    return TRUE;
+}
+
+/* Runs too long for one segment are split, so they stay clipped */
+static BOOLEAN batch_glyphs(U32 x, U32 y, CONST U8 *str, U32 len, VBE_COLOUR fg, VBE_COLOUR bg) {
+    if (!batch || batch->cap <= VBE_CMD_CLIP_WORDS + VBE_CMD_GLYPHS_WORDS(0)) return FALSE;
+    U32 max = (batch->cap - VBE_CMD_CLIP_WORDS - VBE_CMD_GLYPHS_WORDS(0)) * 4;
+    while (len) {
+        U32 n = len < max ? len : max;
+        U32 *p = batch_reserve(VBE_CMD_GLYPHS_WORDS(n));
+        if (!p) return FALSE;
+        p[0] = VBE_CMD_HEADER(VBE_CMD_GLYPHS, VBE_CMD_GLYPHS_WORDS(n));
+        p[1] = x; p[2] = y;
+        p[3] = fg; p[4] = bg;
+        p[5] = n;
+        MEMCPY(&p[6], str, n);
+        x += n * VBE_CMD_GLYPH_ADVANCE;
+        str += n;
+        len -= n;
+    }
+    return TRUE;
+}
+
+BOOLEAN DRAW_BATCH_INIT(DRAW_BATCH *b, U32 cap_words) {
+    if (!b) return FALSE;
+    if (!cap_words) cap_words = DRAW_BATCH_DEFAULT_WORDS;
+    if (cap_words > VBE_CMD_MAX_WORDS) cap_words = VBE_CMD_MAX_WORDS;
+    b->words = MAlloc(cap_words * sizeof(U32));
+    b->used = 0;
+    b->cap = b->words ? cap_words : 0;
+    b->submits = 0;
+    b->clip_x = b->clip_y = 0;
+    b->clip_w = b->clip_h = 0;
+    return b->words != NULLPTR;
+}
+
+VOID DRAW_BATCH_FREE(DRAW_BATCH *b) {
+    if (!b) return;
+    if (batch == b) batch = NULLPTR;
+    if (b->words) MFree(b->words);
+    b->words = NULLPTR;
+    b->used = b->cap = 0;
+}
+
+U32 DRAW_BATCH_SUBMIT(DRAW_BATCH *b) {
+    if (!b || !b->used) return 0;
+    U32 drawn = SYSCALL2(SYSCALL_VBE_SUBMIT, (U32)b->words, b->used);
+    b->used = 0;
+    b->submits++;
+    return drawn;
+}
+
+VOID DRAW_BATCH_BEGIN(DRAW_BATCH *b) {
+    batch_flush();
+    batch = (b && b->words) ? b : NULLPTR;
+    if (batch) batch->clip_w = batch->clip_h = 0;
+}
+
+U32 DRAW_BATCH_END(VOID) {
+    DRAW_BATCH *b = batch;
+    batch = NULLPTR;
+    return DRAW_BATCH_SUBMIT(b);
+}
+
+/* ---- Drawing ---- */
 
 void FLUSH_VRAM(VOID) {
+    batch_flush();
     SYSCALL(SYSCALL_VBE_UPDATE_VRAM, 0, 0, 0, 0, 0);
 }
 
+VOID FLUSH_VRAM_RECTS(CONST VBE_RECT *rects, U32 count) {
+    batch_flush();
+    if (!rects || !count) return;
+    SYSCALL2(SYSCALL_VBE_UPDATE_VRAM, (U32)rects, count);
+}
+
 BOOLEAN DRAW_8x8_CHARACTER(U32 x, U32 y, U8 ch, VBE_COLOUR fg, VBE_COLOUR bg) {
+    if (batch_glyphs(x, y, &ch, 1, fg, bg)) return TRUE;
     SYSCALL(SYSCALL_VBE_DRAW_CHARACTER, (U32)x, (U32)y, (U32)ch, (U32)fg, (U32)bg);
 }
 
@@ -15,6 +133,8 @@ BOOLEAN DRAW_8x8_STRING(U32 x, U32 y, U8 *str, VBE_COLOUR fg, VBE_COLOUR bg) {
     if (!str) return;
     U32 len = STRLEN(str);
     if (len == 0) return;
+    if (batch_glyphs(x, y, str, len, fg, bg)) return TRUE;
+    batch_flush();
 
     /* Fast path: use a stack buffer to avoid heap alloc+free per call.
        Covers virtually all UI strings (ATGL_NODE_MAX_TEXT = 128).      */
@@ -36,30 +156,49 @@ BOOLEAN DRAW_8x8_STRING(U32 x, U32 y, U8 *str, VBE_COLOUR fg, VBE_COLOUR bg) {
     if (on_heap) MFree(m_str);
 }
 void CLEAR_SCREEN_COLOUR(VBE_COLOUR colour) {
+    U32 *p = batch_reserve(VBE_CMD_CLEAR_WORDS);
+    if (p) {
+        p[0] = VBE_CMD_HEADER(VBE_CMD_CLEAR, VBE_CMD_CLEAR_WORDS);
+        p[1] = colour;
+        return;
+    }
     SYSCALL(SYSCALL_VBE_CLEAR_SCREEN, (U32)colour, 0, 0, 0, 0);
 }
 BOOLEAN DRAW_PIXEL(VBE_PIXEL_INFO info) {
+    U32 *p = batch_reserve(VBE_CMD_PIXEL_WORDS);
+    if (p) {
+        p[0] = VBE_CMD_HEADER(VBE_CMD_PIXEL, VBE_CMD_PIXEL_WORDS);
+        p[1] = info.X; p[2] = info.Y;
+        p[3] = info.Colour;
+        return TRUE;
+    }
     SYSCALL(SYSCALL_VBE_DRAW_PIXEL, (U32)info.X, (U32)info.Y, (U32)info.Colour, 0, 0);
 }
 BOOLEAN DRAW_FRAMEBUFFER(U32 pos, VBE_COLOUR colour) {
+    batch_flush();
     SYSCALL(SYSCALL_VBE_DRAW_FRAMEBUFFER, (U32)pos, (U32)colour, 0, 0, 0);
 }
 BOOLEAN DRAW_ELLIPSE(U32 x, U32 y, U32 rx, U32 ry, VBE_COLOUR colour) {
+    if (batch_shape(VBE_CMD_ELLIPSE, x, y, rx, ry, colour)) return TRUE;
     SYSCALL(SYSCALL_VBE_DRAW_ELLIPSE, (U32)x, (U32)y, (U32)rx, (U32)ry, (U32)colour);
 }
 BOOLEAN DRAW_LINE(U32 x1, U32 y1, U32 x2, U32 y2, VBE_COLOUR colour) {
+    if (batch_shape(VBE_CMD_LINE, x1, y1, x2, y2, colour)) return TRUE;
     SYSCALL(SYSCALL_VBE_DRAW_LINE, (U32)x1, (U32)y1, (U32)x2, (U32)y2, (U32)colour);
 }
 BOOLEAN DRAW_RECTANGLE(U32 x, U32 y, U32 width, U32 height, VBE_COLOUR colour) {
+    if (batch_shape(VBE_CMD_RECT, x, y, width, height, colour)) return TRUE;
     SYSCALL(SYSCALL_VBE_DRAW_RECTANGLE, (U32)x, (U32)y, (U32)width, (U32)height, (U32)colour);
 }
 BOOLEAN DRAW_FILLED_RECTANGLE(U32 x, U32 y, U32 width, U32 height, VBE_COLOUR colour) {
+    if (batch_shape(VBE_CMD_FILL_RECT, x, y, width, height, colour)) return TRUE;
     SYSCALL(SYSCALL_VBE_DRAW_FILLED_RECTANGLE, (U32)x, (U32)y, (U32)width, (U32)height, (U32)colour);
 }
 BOOLEAN DRAW_TRIANGLE(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, VBE_COLOUR colour) {
-    SYSCALL(SYSCALL_VBE_DRAW_LINE, (U32)x1, (U32)y1, (U32)x2, (U32)y2, (U32)colour);
-    SYSCALL(SYSCALL_VBE_DRAW_LINE, (U32)x2, (U32)y2, (U32)x3, (U32)y3, (U32)colour);
-    SYSCALL(SYSCALL_VBE_DRAW_LINE, (U32)x3, (U32)y3, (U32)x1, (U32)y1, (U32)colour);
+    DRAW_LINE(x1, y1, x2, y2, colour);
+    DRAW_LINE(x2, y2, x3, y3, colour);
+    DRAW_LINE(x3, y3, x1, y1, colour);
+    return TRUE;
 }
 BOOLEAN DRAW_FILLED_TRIANGLE(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, VBE_COLOUR colour) {
     /* Scanline rasterisation: O(h) DRAW_LINE syscalls instead of
@@ -134,5 +273,31 @@ BOOLEAN DRAW_FILLED_TRIANGLE(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, VBE
 }
 
 BOOLEAN DRAW_FILLED_ELLIPSE(U32 x, U32 y, U32 rx, U32 ry, VBE_COLOUR colour) {
+    if (batch_shape(VBE_CMD_FILL_ELLIPSE, x, y, rx, ry, colour)) return TRUE;
     SYSCALL(SYSCALL_VBE_DRAW_FILLED_ELLIPSE, (U32)x, (U32)y, (U32)rx, (U32)ry, (U32)colour);
 }
+
+BOOLEAN DRAW_BLIT(I32 x, I32 y, U32 w, U32 h, CONST U32 *pixels, U32 stride) {
+    if (!pixels || !w || !h) return FALSE;
+    U32 cmd[VBE_CMD_BLIT_WORDS];
+    U32 *p = batch_reserve(VBE_CMD_BLIT_WORDS);
+    BOOLEAN now = (p == NULLPTR);
+    if (now) p = cmd;
+    p[0] = VBE_CMD_HEADER(VBE_CMD_BLIT, VBE_CMD_BLIT_WORDS);
+    p[1] = (U32)x; p[2] = (U32)y;
+    p[3] = w; p[4] = h;
+    p[5] = stride;
+    p[6] = (U32)pixels;
+    if (now) return SYSCALL2(SYSCALL_VBE_SUBMIT, (U32)cmd, VBE_CMD_BLIT_WORDS) == 1;
+    return TRUE;
+}
+
+VOID DRAW_SET_CLIP(I32 x, I32 y, U32 w, U32 h) {
+    if (!batch) return;
+    batch->clip_w = batch->clip_h = 0;  // a new segment needs only this one
+    U32 *p = batch_reserve(VBE_CMD_CLIP_WORDS);
+    if (!p) return;
+    write_clip(p, x, y, w, h);
+    batch->clip_x = x; batch->clip_y = y;
+    batch->clip_w = w; batch->clip_h = h;
+}
@@ -8,13 +8,20 @@
     Notes:
         - All drawing functions here write directly to the processes' VRAM buffer.
         - calling FLUSH_VRAM() is optional, VRAM is flushed automatically at a set interval. 
+        - Each call is one syscall. Between DRAW_BATCH_BEGIN and DRAW_BATCH_END the
+          same calls are recorded into a DRAW_BATCH instead and replayed by the
+          kernel in one SYSCALL_VBE_SUBMIT (see DRIVERS/VESA/VBE_CMD.h).
 ---*/
 #ifndef GRAPHICS_H
 #define GRAPHICS_H
 #include <STD/TYPEDEF.h>
 #include <DRIVERS/VESA/VBE.h>
+#include <DRIVERS/VESA/VBE_CMD.h>
 
 void FLUSH_VRAM(VOID);
+// Pushes only `count` areas of the VRAM buffer to the screen (at most
+// VBE_UPDATE_MAX_RECTS). With page flipping the kernel presents the whole frame.
+VOID FLUSH_VRAM_RECTS(CONST VBE_RECT *rects, U32 count);
 BOOLEAN DRAW_8x8_CHARACTER(U32 x, U32 y, U8 ch, VBE_COLOUR fg, VBE_COLOUR bg);
 BOOLEAN DRAW_8x8_STRING(U32 x, U32 y, U8 *str, VBE_COLOUR fg, VBE_COLOUR bg);
 void CLEAR_SCREEN_COLOUR(VBE_COLOUR colour);
@@ -30,4 +37,43 @@ BOOLEAN DRAW_FILLED_RECTANGLE(U32 x, U32 y, U32 width, U32 height, VBE_COLOUR co
 
 BOOLEAN DRAW_TRIANGLE(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, VBE_COLOUR colour);
 BOOLEAN DRAW_FILLED_TRIANGLE(U32 x1, U32 y1, U32 x2, U32 y2, U32 x3, U32 y3, VBE_COLOUR colour);
+
+// Copies a w*h block of 0x00RRGGBB pixels, `stride` pixels apart per row.
+// VBE_SEE_THROUGH pixels are skipped. While batching, `pixels` is read at submit time.
+BOOLEAN DRAW_BLIT(I32 x, I32 y, U32 w, U32 h, CONST U32 *pixels, U32 stride);
+
+// Clips the following batched calls to the rectangle until DRAW_BATCH_END,
+// including across the submits a full batch makes; w or h of 0 resets it.
+// Has no effect outside a batch.
+VOID DRAW_SET_CLIP(I32 x, I32 y, U32 w, U32 h);
+
+/* ---- Batched drawing ---- */
+
+#define DRAW_BATCH_DEFAULT_WORDS 4096
+
+typedef struct {
+    U32 *words;
+    U32 used;
+    U32 cap;
+    U32 submits;    // SYSCALL_VBE_SUBMITs issued so far
+    I32 clip_x;     // last DRAW_SET_CLIP, set again at the start of each submit
+    I32 clip_y;
+    U32 clip_w;
+    U32 clip_h;
+} DRAW_BATCH;
+
+// Allocates room for `cap_words` command words (0 = DRAW_BATCH_DEFAULT_WORDS)
+BOOLEAN DRAW_BATCH_INIT(DRAW_BATCH *b, U32 cap_words);
+VOID DRAW_BATCH_FREE(DRAW_BATCH *b);
+
+// Routes the DRAW_* calls above into `b` until DRAW_BATCH_END. A full batch is
+// submitted on its own, so recording never drops a command.
+VOID DRAW_BATCH_BEGIN(DRAW_BATCH *b);
+
+// Submits what is left and returns to one syscall per call.
+// Returns the number of commands the kernel drew in the final submit.
+U32 DRAW_BATCH_END(VOID);
+
+// Replays the recorded commands now and empties the batch
+U32 DRAW_BATCH_SUBMIT(DRAW_BATCH *b);
 #endif
\ No newline at end of file
@@ -8,8 +8,42 @@
 #include <PROGRAMS/SHELL/SHELL.h>
 #include <STD/DEBUG.h>
 #include <STD/ARG.h>
+#include <STD/PIPE.h>
 #ifndef __SHELL__
+// Output to a pipe is collected here and written a line at a time
+#define PIPE_OUT_BUF 512
+static U32 out_pipe ATTRIB_DATA = U32_MAX; // U32_MAX until asked for
+static U8 out_buf[PIPE_OUT_BUF] ATTRIB_DATA = {0};
+static U32 out_len ATTRIB_DATA = 0;
+
+static U32 stdout_pipe(VOID) {
+    if (out_pipe == U32_MAX) out_pipe = PIPE_STDOUT();
+    return out_pipe;
+}
+
+VOID STDOUT_FLUSH(VOID) {
+    if (!out_len || !stdout_pipe()) return;
+    PIPE_WRITE(out_pipe, out_buf, out_len);
+    out_len = 0;
+}
+
+static VOID pipe_putc(U8 c) {
+    out_buf[out_len++] = c;
+    if (c == '\n' || out_len == PIPE_OUT_BUF) STDOUT_FLUSH();
+}
+
+U32 STDIN_READ(PU8 buf, U32 len) {
+    U32 in = PIPE_STDIN();
+    if (!in || !buf || !len) return 0;
+    U32 n = PIPE_READ(in, buf, len);
+    return n == PIPE_ERROR ? 0 : n;
+}
+
 void putc(U8 c) {
+    if (stdout_pipe()) {
+        pipe_putc(c);
+        return;
+    }
     STDOUT_BUF *stdout = GET_PROC_STDOUT();
     if (!stdout) {
         DEBUG_PRINTF("Print without stdout");
@@ -25,6 +59,10 @@ void putc(U8 c) {
 }
 
 void puts(U8 *str) {
+    if (str && stdout_pipe()) {
+        while (*str) pipe_putc(*str++);
+        return;
+    }
     STDOUT_BUF *stdout = GET_PROC_STDOUT();
     if (!stdout || !str) return;
     U32 len = STRNLEN(str, STDOUT_MAX_LENGTH);
@@ -40,6 +78,13 @@ void puts(U8 *str) {
     stdout->proc_seq++;
 }
 #else
+VOID STDOUT_FLUSH(VOID) {
+    // the shell writes to its own console
+}
+U32 STDIN_READ(PU8 buf, U32 len) {
+    (void)buf; (void)len;
+    return 0;
+}
 void putc(U8 c) {
     (void)c;
     // legacy shell. not in use
@@ -24,6 +24,8 @@ REMARKS
 Function table:
     - puts
     - putc
+    - STDOUT_FLUSH
+    - STDIN_READ
 ---*/
 #ifndef IO_H
 #define IO_H
@@ -33,8 +35,15 @@ Function table:
 #include <DRIVERS/PS2/KEYBOARD_MOUSE.h> // For definitions
 
 #define line_end "\r\n"
+// Print to the shell, or to the stdout pipe when the program runs in a
+// pipeline (`A | B`). Pipe output goes out a line at a time
 void putc(U8 c);
 void puts(U8 *str);
+// Write out pipe output still held back. EXIT does this
+VOID STDOUT_FLUSH(VOID);
+// Read up to len bytes of the stdin pipe, waiting for them. 0 at the end of
+// the input, or when the program is not reading a pipe
+U32 STDIN_READ(PU8 buf, U32 len);
 
 
 // Executes a batsh shell command
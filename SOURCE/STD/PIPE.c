@@ -0,0 +1,32 @@
+#include <STD/PIPE.h>
+#include <STD/TASK.h>
+#include <CPU/SYSCALL/SYSCALL.h>
+
+U32 PIPE_CREATE(VOID) {
+    return SYSCALL1(SYSCALL_PIPE, PIPE_OP_CREATE);
+}
+U32 PIPE_READ(U32 pipe, PU8 buf, U32 len) {
+    U32 n;
+    while ((n = SYSCALL4(SYSCALL_PIPE, PIPE_OP_READ, pipe, (U32)buf, len)) == PIPE_WOULD_BLOCK)
+        YIELD();
+    return n;
+}
+U32 PIPE_WRITE(U32 pipe, PU8 buf, U32 len) {
+    U32 done = 0;
+    while (done < len) {
+        U32 n = SYSCALL4(SYSCALL_PIPE, PIPE_OP_WRITE, pipe, (U32)(buf + done), len - done);
+        if (n == PIPE_WOULD_BLOCK) YIELD();
+        else if (n == PIPE_ERROR) break;
+        else done += n;
+    }
+    return done;
+}
+VOID PIPE_CLOSE(U32 pipe, U32 ends) {
+    SYSCALL3(SYSCALL_PIPE, PIPE_OP_CLOSE, pipe, ends);
+}
+U32 PIPE_STDIN(VOID) {
+    return SYSCALL2(SYSCALL_PIPE, PIPE_OP_STDIO, 0);
+}
+U32 PIPE_STDOUT(VOID) {
+    return SYSCALL2(SYSCALL_PIPE, PIPE_OP_STDIO, 1);
+}
@@ -0,0 +1,34 @@
+/*+++
+    SOURCE/STD/PIPE.h - Pipes
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Byte streams between processes. PIPE_CREATE gives the caller both
+    ends; START_PROCESS_PIPED hands an end to a new process, which finds
+    it with PIPE_STDIN / PIPE_STDOUT. putc, puts and printf write to the
+    stdout pipe when there is one, STDIN_READ (STD/IO.h) reads stdin.
+
+    PIPE_READ and PIPE_WRITE sleep in the scheduler while the pipe is
+    empty or full, so a waiting process uses no CPU time.
+
+REMARKS
+    Handles are never 0. The kernel closes every end a process holds
+    when it exits.
+---*/
+#ifndef STD_PIPE_H
+#define STD_PIPE_H
+
+#include <STD/TYPEDEF.h>
+#include <PIPE/PIPE.h>
+
+U32 PIPE_CREATE(VOID);                     // 0 on failure
+U32 PIPE_READ(U32 pipe, PU8 buf, U32 len); // waits for data. 0 at end of stream, PIPE_ERROR if not a reader
+U32 PIPE_WRITE(U32 pipe, PU8 buf, U32 len);// waits for room. Bytes written, fewer if the readers went away
+VOID PIPE_CLOSE(U32 pipe, U32 ends);       // ends: PIPE_END_READ, PIPE_END_WRITE or PIPE_END_BOTH
+U32 PIPE_STDIN(VOID);                      // the pipe this process reads its input from, 0 for none
+U32 PIPE_STDOUT(VOID);                     // the pipe its output goes to, 0 for the shell
+
+#endif // STD_PIPE_H
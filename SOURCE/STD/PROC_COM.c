@@ -6,6 +6,8 @@
 #include <STD/DEBUG.h>
 #include <STD/TASK.h>
 #include <CPU/PIT/PIT.h>
+#include <STD/SYSINFO.h>
+#include <STD/IO.h>
 
 static TCB process ATTRIB_DATA = {0};
 static BOOLEAN process_fetched ATTRIB_DATA = FALSE;
@@ -46,17 +48,31 @@ U32 MESSAGE_AMOUNT() {
     return (U32)res;
 }
 
-VOID SEND_MESSAGE(PROC_MESSAGE *msg) {
-    if (!msg) return;
+BOOLEAN SEND_MESSAGE(PROC_MESSAGE *msg) {
+    if (!msg) return FALSE;
     PROC_MESSAGE *msg_copy = MAlloc(sizeof(PROC_MESSAGE));
-    if (!msg_copy) return;
+    if (!msg_copy) return FALSE;
     MEMCPY(msg_copy, msg, sizeof(PROC_MESSAGE));
-    SYSCALL1(SYSCALL_SEND_MESSAGE, (U32)msg_copy);
+    U32 res = SYSCALL1(SYSCALL_SEND_MESSAGE, (U32)msg_copy);
     MFree(msg_copy);
+    return res == 0;
 }
 PROC_MESSAGE *GET_MESSAGE() {
     return (PROC_MESSAGE *)SYSCALL0(SYSCALL_GET_MESSAGE);
 }
+PROC_MESSAGE *RECEIVE_MESSAGE(U32 timeout_ms) {
+    U32 start = GET_PIT_TICKS();
+    U32 left = timeout_ms;
+    for (;;) {
+        PROC_MESSAGE *msg = (PROC_MESSAGE *)SYSCALL1(SYSCALL_RECEIVE_MESSAGE, left);
+        if (msg || !left) return msg;
+        YIELD(); // parked until a message arrives or the time is up
+        if (timeout_ms != U32_MAX) {
+            U32 waited = (GET_PIT_TICKS() - start) * PIT_TICK_MS;
+            left = waited < timeout_ms ? timeout_ms - waited : 0;
+        }
+    }
+}
 
 VOID FREE_MESSAGE(PROC_MESSAGE *msg) {
     if (!msg) return;
@@ -159,22 +175,40 @@ void FREE_TCB(TCB *tcb) {
     MFree(tcb);
 }
 
+BOOLEAN PROFILE_START(U32 pid, U32 shift) {
+    return (BOOLEAN)SYSCALL3(SYSCALL_PROC_PROFILE, PROC_PROFILE_OP_START, pid, shift);
+}
+VOID PROFILE_STOP(U32 pid) {
+    SYSCALL2(SYSCALL_PROC_PROFILE, PROC_PROFILE_OP_STOP, pid);
+}
+PROC_PROFILE *PROFILE_READ(U32 pid) {
+    U32 size = sizeof(PROC_PROFILE) + PROC_PROFILE_MAX_BUCKETS * sizeof(U32);
+    PROC_PROFILE *p = MAlloc(size);
+    if (!p) return NULL;
+    U32 got = SYSCALL4(SYSCALL_PROC_PROFILE, PROC_PROFILE_OP_READ, pid, (U32)p, size);
+    if (got < sizeof(PROC_PROFILE)) {
+        MFree(p);
+        return NULL;
+    }
+    return p;
+}
+
 U32 GET_PIT_TICKS() {
-    return SYSCALL0(SYSCALL_GET_PIT_TICK);
+    return SYSINFO_TICKS();
 }
 
 U32 GET_SYS_SECONDS() {
-    return SYSCALL0(SYSCALL_GET_SECONDS);
+    return SYSINFO_TICKS() / TICKS_PER_SECOND;
 }
 
 U32 CPU_SLEEP(U32 ms) {
-    U32 ticks = GET_PIT_TICKS();
-    U32 target_ticks = ticks + (ms * TICKS_PER_SECOND) / 1000;
-    while (GET_PIT_TICKS() < target_ticks) {
+    U32 target_ticks = GET_PIT_TICKS() + (ms * TICKS_PER_SECOND) / 1000;
+    I32 left;
+    while ((left = (I32)(target_ticks - GET_PIT_TICKS())) > 0) {
+        SYSCALL1(SYSCALL_PIT_SLEEP, (U32)left * PIT_TICK_MS); // parks us until the next yield
         YIELD();
     }
-    
-    // return SYSCALL1(SYSCALL_PIT_SLEEP, ms);
+    return 0;
 }
 
 
@@ -182,6 +216,8 @@ U32 CPU_SLEEP(U32 ms) {
 VOID EXIT(U32 n) {
     PROC_MESSAGE msg;
 
+    STDOUT_FLUSH();
+
     DEBUG_PRINTF("[PROC COM] EXIT(%d) called\n", n);
     // msg = CREATE_PROC_MSG(KERNEL_PID, PROC_MSG_SET_FOCUS, NULL, 0, PROC_GETPPID());
     // SEND_MESSAGE(&msg);
@@ -376,6 +412,20 @@ BOOLEAN START_PROCESS(
     U32 parent_pid,
     PPU8 argv,
     U32 argc
+) {
+    return START_PROCESS_PIPED(proc_name, file, bin_size, initial_state, parent_pid, argv, argc, 0, 0);
+}
+
+BOOLEAN START_PROCESS_PIPED(
+    U8 *proc_name, 
+    VOIDPTR file, 
+    U32 bin_size, 
+    U32 initial_state, 
+    U32 parent_pid,
+    PPU8 argv,
+    U32 argc,
+    U32 stdin_pipe,
+    U32 stdout_pipe
 ) {
     RUN_BINARY_STRUCT *sc = MAlloc(sizeof(RUN_BINARY_STRUCT)); // Will be freed by kernel
     if(!sc) return FALSE;
@@ -386,6 +436,8 @@ BOOLEAN START_PROCESS(
     sc->parent_pid = parent_pid;
     sc->argv = argv;
     sc->argc = argc;
+    sc->stdin_pipe = stdin_pipe;
+    sc->stdout_pipe = stdout_pipe;
     PROC_MESSAGE msg;
     msg = CREATE_PROC_MSG_RAW(KERNEL_PID, PROC_MSG_CREATE_PROCESS, sc, sizeof(RUN_BINARY_STRUCT), 0xDEADBEEF);
     SEND_MESSAGE(&msg);
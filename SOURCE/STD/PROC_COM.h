@@ -69,6 +69,11 @@ TCB *GET_TCB_BY_PID(U32 pid); // Get TCB of process by PID, NULL if not found. M
 TCB *GET_PARENT_TCB(void); // Get your parent's TCB, NULL if no
 void FREE_TCB(TCB *tcb); // MFree a TCB received via GET_TCB_BY_PID
 
+// PIT-sampled EIP histogram of a process, see PROC_PROFILE in PROC/PROC.h
+BOOLEAN PROFILE_START(U32 pid, U32 shift); // shift = log2 bytes per bucket, 0 picks the smallest that fits
+VOID PROFILE_STOP(U32 pid);
+PROC_PROFILE *PROFILE_READ(U32 pid); // Snapshot of the histogram, NULL if not profiled. MFree when done
+
 #define KERNEL_PID 0
 #define CREATE_PROC_MSG(receiver, msg_type, data_ptr, data_sz, signal_val) \
     (PROC_MESSAGE){ \
@@ -100,13 +105,32 @@ void FREE_TCB(TCB *tcb); // MFree a TCB received via GET_TCB_BY_PID
         .raw_data_size = (raw_sz), \
     }
 
+// Hands a shared memory region (STD/SHM.h) to the receiver without copying.
+// It is unmapped here once sent; the receiver finds it at raw_data
+#define CREATE_PROC_MSG_SHM(receiver, msg_type, shm_handle, signal_val) \
+    (PROC_MESSAGE){ \
+        .sender_pid = PROC_GETPID(), \
+        .receiver_pid = (receiver), \
+        .type = (msg_type), \
+        .data_provided = FALSE, \
+        .data = NULL, \
+        .data_size = 0, \
+        .signal = (signal_val), \
+        .timestamp = 0, \
+        .read = FALSE, \
+        .raw_data = NULL, \
+        .raw_data_size = 0, \
+        .shm = (shm_handle), \
+    }
+
 
 /**
  * KRNLCOM
  */
 
 // Send a message to another process or the kernel, Create struct with CREATE_PROC_MSG
-VOID SEND_MESSAGE(PROC_MESSAGE *msg);
+// FALSE if the receiver does not exist or its queue is full; nothing was sent
+BOOLEAN SEND_MESSAGE(PROC_MESSAGE *msg);
 
 // Get amount of messages in your message queue
 U32 MESSAGE_AMOUNT();
@@ -115,14 +139,19 @@ U32 MESSAGE_AMOUNT();
 // Removed from message queue after calling
 PROC_MESSAGE *GET_MESSAGE();
 
-// MFree a message received via GET_MESSAGE
+// As GET_MESSAGE, but sleeps until a message arrives or timeout_ms pass.
+// U32_MAX waits forever, 0 does not wait. NULL on timeout
+PROC_MESSAGE *RECEIVE_MESSAGE(U32 timeout_ms);
+
+// MFree a message received via GET_MESSAGE. A region in msg->shm stays
+// mapped: SHM_CLOSE it or send it on
 VOID FREE_MESSAGE(PROC_MESSAGE *msg);
 
 U32 GET_PIT_TICKS();
 
 U32 GET_SYS_SECONDS();
 
-U32 CPU_SLEEP(U32 ms); // Sleep for given milliseconds
+U32 CPU_SLEEP(U32 ms); // Sleep for given milliseconds, without using CPU time
 
 VOID SYS_RESTART();
 VOID SYS_SHUTDOWN();
@@ -144,6 +173,20 @@ BOOLEAN START_PROCESS(
     PPU8 argv,
     U32 argc
 );
+// As START_PROCESS. The read end of stdin_pipe and the write end of
+// stdout_pipe (STD/PIPE.h) move from the caller to the new process; 0 for none.
+// The caller must not close the ends it passes
+BOOLEAN START_PROCESS_PIPED(
+    U8 *proc_name, 
+    VOIDPTR file, 
+    U32 bin_size, 
+    U32 initial_state, 
+    U32 parent_pid,
+    PPU8 argv,
+    U32 argc,
+    U32 stdin_pipe,
+    U32 stdout_pipe
+);
 VOID KILL_PROCESS_INSTANCE(U32 pid);
 VOID DISABLE_SHELL_KEYBOARD();
 VOID ENABLE_SHELL_KEYBOARD();
@@ -0,0 +1,22 @@
+#include <STD/SHM.h>
+#include <CPU/SYSCALL/SYSCALL.h>
+
+U32 SHM_CREATE(PU8 name, U32 size) {
+    return SYSCALL3(SYSCALL_SHM, SHM_OP_CREATE, (U32)name, size);
+}
+U32 SHM_OPEN(PU8 name) {
+    if (!name) return 0;
+    return SYSCALL2(SYSCALL_SHM, SHM_OP_OPEN, (U32)name);
+}
+U32 SHM_MAP(U32 handle) {
+    return SYSCALL2(SYSCALL_SHM, SHM_OP_MAP, handle);
+}
+VOID SHM_CLOSE(U32 handle) {
+    SYSCALL2(SYSCALL_SHM, SHM_OP_CLOSE, handle);
+}
+VOIDPTR SHM_ADDR(U32 handle) {
+    return (VOIDPTR)SYSCALL2(SYSCALL_SHM, SHM_OP_ADDR, handle);
+}
+U32 SHM_SIZE(U32 handle) {
+    return SYSCALL2(SYSCALL_SHM, SHM_OP_SIZE, handle);
+}
@@ -0,0 +1,33 @@
+/*+++
+    SOURCE/STD/SHM.h - Shared memory regions
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Pages mapped into several processes at the same address. Share a region
+    by name (SHM_CREATE / SHM_OPEN) or by handle (SHM_MAP), or move it to
+    another process in a message built with CREATE_PROC_MSG_SHM, which
+    costs no copy.
+
+    Every process that maps a region holds it until SHM_CLOSE or exit; the
+    pages are freed when nobody holds it any more.
+
+REMARKS
+    Handles are never 0. Region contents start zeroed.
+---*/
+#ifndef STD_SHM_H
+#define STD_SHM_H
+
+#include <STD/TYPEDEF.h>
+#include <SHM/SHM.h>
+
+U32 SHM_CREATE(PU8 name, U32 size);   // name may be NULL for an anonymous region. Mapped on success
+U32 SHM_OPEN(PU8 name);               // map a named region
+U32 SHM_MAP(U32 handle);              // map a region by handle, e.g. one another process created
+VOID SHM_CLOSE(U32 handle);           // unmap and let go
+VOIDPTR SHM_ADDR(U32 handle);         // NULL if not mapped here
+U32 SHM_SIZE(U32 handle);             // bytes, rounded up to whole pages
+
+#endif // STD_SHM_H
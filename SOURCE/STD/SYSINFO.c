@@ -0,0 +1,61 @@
+#include <STD/SYSINFO.h>
+#include <STD/ASM.h>
+#include <STD/MEM.h>
+
+#define PAGE ((const volatile SYSINFO_PAGE *)SYSINFO_VADDR)
+
+// Sequence counter reads: the kernel only writes from interrupt context, so
+// an odd value is never seen on a single CPU, but a retry is still needed
+// when the reader was interrupted halfway through.
+static inline U32 read_begin(void) {
+    U32 seq;
+    while ((seq = PAGE->seq) & 1) cpu_relax();
+    __asm__ volatile("" ::: "memory");
+    return seq;
+}
+
+static inline BOOL read_retry(U32 seq) {
+    __asm__ volatile("" ::: "memory");
+    return PAGE->seq != seq;
+}
+
+const volatile SYSINFO_PAGE *SYSINFO_GET(void) {
+    return PAGE;
+}
+
+VOID SYSINFO_SNAPSHOT(SYSINFO_PAGE *out) {
+    U32 seq;
+    do {
+        seq = read_begin();
+        MEMCPY(out, (const VOID *)PAGE, sizeof(SYSINFO_PAGE));
+    } while (read_retry(seq));
+}
+
+U32 SYSINFO_TICKS(void) {
+    return PAGE->ticks;
+}
+
+U32 SYSINFO_UPTIME_MS(void) {
+    return PAGE->uptime_ms;
+}
+
+U32 SYSINFO_REALTIME(U32 *ms_out) {
+    U32 seq, secs, ms;
+    do {
+        seq = read_begin();
+        secs = PAGE->realtime_s;
+        ms = PAGE->realtime_ms;
+    } while (read_retry(seq));
+    if (ms_out) *ms_out = ms;
+    return secs;
+}
+
+RTC_DATE_TIME SYSINFO_DATE_TIME(void) {
+    RTC_DATE_TIME dt;
+    U32 seq;
+    do {
+        seq = read_begin();
+        MEMCPY(&dt, (const VOID *)&PAGE->date_time, sizeof(RTC_DATE_TIME));
+    } while (read_retry(seq));
+    return dt;
+}
@@ -0,0 +1,36 @@
+/*+++
+    SOURCE/STD/SYSINFO.h - Syscall-free system information
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Readers for the kernel's shared SYSINFO page, mapped read-only into every
+    process. None of these functions trap into the kernel.
+
+REMARKS
+    NOT usable in kernel code.
+---*/
+#ifndef STD_SYSINFO_H
+#define STD_SYSINFO_H
+
+#include <STD/TYPEDEF.h>
+
+#define SYSINFO_ONLY_DEFINES
+#include <SYSINFO/SYSINFO.h>
+#undef SYSINFO_ONLY_DEFINES
+
+// Direct read-only view of the page. Fields may change between two reads;
+// use SYSINFO_SNAPSHOT when several of them must agree.
+const volatile SYSINFO_PAGE *SYSINFO_GET(void);
+
+// Consistent copy of the whole page
+VOID SYSINFO_SNAPSHOT(SYSINFO_PAGE *out);
+
+U32 SYSINFO_TICKS(void);                  // PIT ticks since boot
+U32 SYSINFO_UPTIME_MS(void);              // milliseconds since boot
+U32 SYSINFO_REALTIME(U32 *ms_out);        // seconds since 1970-01-01, sub-second part in ms_out (may be NULL)
+RTC_DATE_TIME SYSINFO_DATE_TIME(void);    // current date and time
+
+#endif // STD_SYSINFO_H
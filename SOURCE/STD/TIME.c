@@ -1,6 +1,8 @@
 #include <STD/TIME.h>
 #include <CPU/SYSCALL/SYSCALL.h>
 #include <STD/MEM.h>
+#include <STD/SYSINFO.h>
+#include <STD/ASM.h>
 
 #define SECONDS_PER_MIN 60
 #define SECONDS_PER_HOUR 3600
@@ -72,12 +74,36 @@ static void NORMALIZE_DATETIME(RTC_DATE_TIME *dt) {
 
 // Basic getters
 RTC_DATE_TIME GET_DATE_TIME(void) {
-    RTC_DATE_TIME retval = {0};
-    RTC_DATE_TIME *res = SYSCALL0(SYSCALL_GET_TIME);
-    if (!res) return retval;
-    MEMCPY(&retval, res, sizeof(RTC_DATE_TIME));
-    MFree(res);
-    return retval;
+    return SYSINFO_DATE_TIME();
+}
+
+U32 GET_UPTIME_MS(void) {
+    return SYSINFO_UPTIME_MS();
+}
+
+U32 GET_REALTIME(U32 *ms_out) {
+    return SYSINFO_REALTIME(ms_out);
+}
+
+static U32 tsc_khz ATTRIB_DATA = 0;
+
+U32 TSC_NOW(void) {
+    return rdtsc_lo();
+}
+
+U32 TSC_KHZ(void) {
+    if (!tsc_khz) tsc_khz = SYSCALL0(SYSCALL_TSC_KHZ);
+    return tsc_khz;
+}
+
+U32 TSC_TO_NS(U32 cycles) {
+    U32 khz = TSC_KHZ();
+    return khz ? umuldiv32(cycles, 1000000, khz) : 0;
+}
+
+U32 TSC_TO_US(U32 cycles) {
+    U32 khz = TSC_KHZ();
+    return khz ? umuldiv32(cycles, 1000, khz) : 0;
 }
 
 U32 GET_SECONDS(RTC_DATE_TIME *dt)      { return dt ? dt->seconds : 0xFFFFFFFF; }
@@ -17,6 +17,17 @@
 // RTC_DATE_TIME retrieval
 RTC_DATE_TIME GET_DATE_TIME(void);
 
+// Cheap clocks, read from the shared SYSINFO page without a syscall
+U32 GET_UPTIME_MS(void);          // milliseconds since boot
+U32 GET_REALTIME(U32 *ms_out);    // seconds since 1970-01-01, sub-second part in ms_out (may be NULL)
+
+// High resolution timing with the TSC, calibrated by the kernel at boot.
+// Deltas of TSC_NOW stamps are valid up to ~1 s; use GET_UPTIME_MS beyond that
+U32 TSC_NOW(void);                // cycle counter, low 32 bits
+U32 TSC_KHZ(void);                // TSC frequency in kHz, 0 if unavailable
+U32 TSC_TO_NS(U32 cycles);        // 0 if the TSC is unavailable
+U32 TSC_TO_US(U32 cycles);
+
 // Getters for components
 U32 GET_SECONDS(RTC_DATE_TIME *dt);       // 0-59
 U32 GET_MINUTES(RTC_DATE_TIME *dt);       // 0-59
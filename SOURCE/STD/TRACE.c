@@ -0,0 +1,26 @@
+#include <STD/TRACE.h>
+#include <CPU/SYSCALL/SYSCALL.h>
+
+U32 TRACE_GET_MASK(VOID) {
+    return SYSCALL1(SYSCALL_TRACE_CTL, TRACE_OP_GET_MASK);
+}
+
+U32 TRACE_SET_MASK(U32 mask) {
+    return SYSCALL2(SYSCALL_TRACE_CTL, TRACE_OP_SET_MASK, mask);
+}
+
+VOID TRACE_CLEAR(VOID) {
+    SYSCALL1(SYSCALL_TRACE_CTL, TRACE_OP_CLEAR);
+}
+
+U32 TRACE_COUNT(VOID) {
+    return SYSCALL1(SYSCALL_TRACE_CTL, TRACE_OP_COUNT);
+}
+
+U32 TRACE_DUMP(U16 port) {
+    return SYSCALL2(SYSCALL_TRACE_CTL, TRACE_OP_DUMP, port);
+}
+
+VOID TRACE_MARK(U32 a, U32 b, U32 c) {
+    SYSCALL4(SYSCALL_TRACE_CTL, TRACE_OP_MARK, a, b, c);
+}
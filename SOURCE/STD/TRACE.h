@@ -0,0 +1,44 @@
+/*+++
+    SOURCE/STD/TRACE.h - Kernel event trace control
+
+    Part of atOS
+
+    Licensed under the MIT License. See LICENSE file in the project root for full license information.
+
+DESCRIPTION
+    Wrappers around SYSCALL_TRACE_CTL. The kernel records context switches,
+    syscalls, IRQs, disk transfers and heap calls into a fixed ring; these
+    functions pick the recorded classes, add markers and stream the ring to
+    a COM port for TOOLS/TRACE to decode.
+
+REMARKS
+    NOT usable in kernel code, see DEBUG/TRACE.h there.
+---*/
+#ifndef STD_TRACE_H
+#define STD_TRACE_H
+
+#include <STD/TYPEDEF.h>
+
+#define TRACE_ONLY_DEFINES
+#include <DEBUG/TRACE.h>
+#undef TRACE_ONLY_DEFINES
+
+// Enabled TRACE_CLASS_* bits
+U32 TRACE_GET_MASK(VOID);
+
+// Returns the previous mask
+U32 TRACE_SET_MASK(U32 mask);
+
+// Drops all recorded events
+VOID TRACE_CLEAR(VOID);
+
+// Events currently held by the ring
+U32 TRACE_COUNT(VOID);
+
+// Streams the ring to `port` (0 = COM2). Returns the number of events written
+U32 TRACE_DUMP(U16 port);
+
+// Records a TRACE_EV_MARK event, if TRACE_CLASS_USER is enabled
+VOID TRACE_MARK(U32 a, U32 b, U32 c);
+
+#endif // STD_TRACE_H
@@ -0,0 +1,127 @@
+/* Host benchmark for LIBRARIES/ATZP: MB/s and ratio on a fixed corpus.
+   Build and run with `make bench` in TESTS/. */
+#include <LIBRARIES/ATZP/ATZP.h>
+#include <STD/MEM.h>
+
+extern int printf(const char *format, ...);
+extern long clock(void);
+#define HOST_CLOCKS_PER_SEC 1000000L
+
+#define CORPUS_SIZE (4 * 1024 * 1024)
+#define MIN_RUN_SECONDS 0.5
+
+static U32 rng_state;
+static U32 rng_next(void) {
+    rng_state = rng_state * 1103515245U + 12345U;
+    return rng_state >> 16;
+}
+
+/* Fixed corpora: source-like text, a binary table, and pure noise */
+static void make_text(PU8 buf, U32 len) {
+    static CONST CHAR *words[] = {
+        "U32 ", "PU8 ", "return ", "if (", ") {\n", "}\n", "    ", "MEMCPY(", "NULLPTR",
+        "ctx->", "window", "offset", " = ", "; ", "/* ", " */\n", "0x", "FALSE", "TRUE",
+    };
+    U32 i = 0;
+    rng_state = 1;
+    while (i < len) {
+        CONST CHAR *w = words[rng_next() % 19];
+        while (*w && i < len) buf[i++] = (U8)*w++;
+        if ((rng_next() & 15) == 0 && i < len) buf[i++] = (U8)('a' + rng_next() % 26);
+    }
+}
+
+static void make_binary(PU8 buf, U32 len) {
+    rng_state = 2;
+    for (U32 i = 0; i < len; i += 4) {
+        U32 v = (i / 4) * 3 + (rng_next() & 0x3);
+        for (U32 k = 0; k < 4 && i + k < len; k++) buf[i + k] = (U8)(v >> (8 * k));
+    }
+}
+
+static void make_noise(PU8 buf, U32 len) {
+    rng_state = 3;
+    for (U32 i = 0; i < len; i++) buf[i] = (U8)rng_next();
+}
+
+static double seconds(long c) { return (double)c / HOST_CLOCKS_PER_SEC; }
+
+typedef U32 (*COMPRESS_FN)(PU8 src, U32 len, PU8 dst, U32 cap, U32 param);
+
+static U32 run_fast(PU8 s, U32 l, PU8 d, U32 c, U32 p) { return LZ4_COMPRESS_FAST(s, l, d, c, p); }
+static U32 run_hc(PU8 s, U32 l, PU8 d, U32 c, U32 p) { return LZ4_COMPRESS_HC(s, l, d, c, p); }
+
+static U32 run_frame(PU8 s, U32 l, PU8 d, U32 c, U32 p) {
+    LZ4F_CCTX ctx;
+    U32 n, total = 0;
+    (void)c;
+    LZ4F_COMPRESS_BEGIN(&ctx, p, 0, d, LZ4F_HEADER_SIZE, &n);
+    total += n;
+    for (U32 i = 0; i < l; i += 16384) {
+        U32 part = (l - i < 16384) ? l - i : 16384;
+        LZ4F_COMPRESS_UPDATE(&ctx, s + i, part, d + total, LZ4F_UPDATE_BOUND(part), &n);
+        total += n;
+    }
+    LZ4F_COMPRESS_END(&ctx, d + total, LZ4F_END_BOUND, &n);
+    return total + n;
+}
+
+static void run_frame_decode(PU8 frame, U32 flen, PU8 out, U32 len) {
+    LZ4F_DCTX ctx;
+    U32 src_len = flen, dst_len = len;
+    LZ4F_DECOMPRESS_INIT(&ctx);
+    LZ4F_DECOMPRESS_UPDATE(&ctx, frame, &src_len, out, &dst_len);
+    LZ4F_DECOMPRESS_FREE(&ctx);
+}
+
+static void bench(CONST CHAR *corpus, CONST CHAR *name, COMPRESS_FN fn, U32 param,
+                  PU8 src, U32 len, PU8 cmp, U32 cap, PU8 out) {
+    U32 csize = 0, runs = 0;
+    long t0 = clock(), t;
+    do {
+        csize = fn(src, len, cmp, cap, param);
+        runs++;
+        t = clock() - t0;
+    } while (seconds(t) < MIN_RUN_SECONDS);
+    double c_mbs = (double)len * runs / (1024.0 * 1024.0) / seconds(t);
+
+    runs = 0;
+    t0 = clock();
+    do {
+        if (fn == run_frame) run_frame_decode(cmp, csize, out, len);
+        else LZ4_DECOMPRESS(cmp, csize, out, len);
+        runs++;
+        t = clock() - t0;
+    } while (seconds(t) < MIN_RUN_SECONDS);
+    double d_mbs = (double)len * runs / (1024.0 * 1024.0) / seconds(t);
+
+    printf("  %-7s %-12s %3u  ratio %6.3f  compress %8.1f MB/s  decompress %8.1f MB/s\n",
+           corpus, name, param, (double)len / (double)csize, c_mbs, d_mbs);
+}
+
+int main(void) {
+    U32 len = CORPUS_SIZE;
+    U32 cap = LZ4_COMPRESS_BOUND(len) + LZ4F_UPDATE_BOUND(len);
+    PU8 src = MAlloc(len);
+    PU8 cmp = MAlloc(cap);
+    PU8 out = MAlloc(len);
+
+    struct { CONST CHAR *name; void (*make)(PU8, U32); } corpora[] = {
+        { "text", make_text }, { "binary", make_binary }, { "noise", make_noise },
+    };
+
+    printf("=== ATZP benchmark (%u KB corpora) ===\n", len / 1024);
+    for (U32 i = 0; i < 3; i++) {
+        corpora[i].make(src, len);
+        bench(corpora[i].name, "fast", run_fast, 1, src, len, cmp, cap, out);
+        bench(corpora[i].name, "fast", run_fast, 8, src, len, cmp, cap, out);
+        bench(corpora[i].name, "hc", run_hc, 4, src, len, cmp, cap, out);
+        bench(corpora[i].name, "hc", run_hc, LZ4HC_LEVEL_DEFAULT, src, len, cmp, cap, out);
+        bench(corpora[i].name, "frame", run_frame, 1, src, len, cmp, cap, out);
+    }
+
+    MFree(src);
+    MFree(cmp);
+    MFree(out);
+    return 0;
+}
@@ -0,0 +1,67 @@
+/* Host benchmark for the BATSH bytecode interpreter (TSHELL/BATSH_VM.c):
+   compile time, cached run time and statements per second on the loop-heavy
+   HOME/SRC/BATSH/LOOPBENCH.SH. Build and run with `make bench` in TESTS/. */
+#include <PROGRAMS/SYS_PROGS/TSHELL/BATSH_VM.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+
+extern int printf(const char *format, ...);
+extern long clock(void);
+typedef struct HOST_FILE HOST_FILE;
+extern HOST_FILE *fopen(const char *path, const char *mode);
+extern int fclose(HOST_FILE *f);
+extern unsigned long fread(void *buf, unsigned long size, unsigned long n, HOST_FILE *f);
+#define HOST_CLOCKS_PER_SEC 1000000L
+
+#define SCRIPT "../HOME/SRC/BATSH/LOOPBENCH.SH"
+#define MIN_RUN_SECONDS 0.5
+
+static U32 lines_run;
+static U8  last_line[BATSH_VM_LINE_MAX];
+
+static VOID bench_exec(VOIDPTR ctx, PU8 line) {
+    lines_run++;
+    STRNCPY(last_line, line, sizeof(last_line) - 1);
+}
+
+static BATSH_VM_ENV env = { NULLPTR, bench_exec, NULLPTR, NULLPTR, NULLPTR, NULLPTR, NULLPTR, 0 };
+
+int main(void) {
+    static U8 src[1 << 16];
+    HOST_FILE *f = fopen(SCRIPT, "rb");
+    if (!f) { printf("cannot read %s\n", SCRIPT); return 1; }
+    U32 len = (U32)fread(src, 1, sizeof(src) - 1, f);
+    fclose(f);
+
+    printf("=== BATSH VM benchmark (%s, %u bytes) ===\n", SCRIPT, len);
+
+    BATSH_VM_ERROR err = { 0 };
+    U32 compiles = 0;
+    long t0 = clock();
+    double secs;
+    do {
+        BATSH_PROGRAM *p = BATSH_COMPILE(src, len, &err);
+        if (!p) { printf("line %u: %s\n", err.line, err.msg); return 1; }
+        BATSH_FREE_PROGRAM(p);
+        compiles++;
+        secs = (double)(clock() - t0) / HOST_CLOCKS_PER_SEC;
+    } while (secs < MIN_RUN_SECONDS);
+    printf("  compile      %10.2f us\n", secs * 1e6 / compiles);
+
+    BATSH_PROGRAM *p = BATSH_COMPILE(src, len, &err);
+    printf("  code size    %10u words\n", BATSH_PROGRAM_CODE_LEN(p));
+
+    U32 runs = 0;
+    t0 = clock();
+    do {
+        lines_run = 0;
+        BATSH_RUN(p, &env);
+        runs++;
+        secs = (double)(clock() - t0) / HOST_CLOCKS_PER_SEC;
+    } while (secs < MIN_RUN_SECONDS);
+    printf("  cached run   %10.2f us   (%u commands)\n", secs * 1e6 / runs, lines_run);
+    printf("  last line    %s\n", last_line);
+
+    BATSH_FREE_PROGRAM(p);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/* Host benchmark for JOT's piece table (JOT/TEXTBUF.c): load, line lookup,
+   a scripted editing session and full undo/redo on an 8 MB source-like
+   document. Build and run with `make bench` in TESTS/. */
+#include <PROGRAMS/SYS_PROGS/JOT/TEXTBUF.h>
+#include <STD/MEM.h>
+
+extern int printf(const char *format, ...);
+extern long clock(void);
+#define HOST_CLOCKS_PER_SEC 1000000L
+
+#define DOC_SIZE   (8 * 1024 * 1024)
+#define LOOKUPS    1000000
+#define EDITS      200000
+
+static U32 rng_state;
+static U32 rng_next(void) {
+    rng_state = rng_state * 1103515245U + 12345U;
+    return rng_state >> 16;
+}
+
+static U32 rng_below(U32 n) {
+    return ((rng_next() << 15) ^ rng_next()) % n;
+}
+
+static void make_doc(PU8 buf, U32 len) {
+    static CONST CHAR *words[] = {
+        "U32 ", "PU8 ", "return ", "if (", ") {\n", "}\n", "    ", "MEMCPY(", "NULLPTR",
+        "ctx->", "window", "offset", " = ", ";\n", "/* ", " */\n", "0x", "FALSE", "TRUE",
+    };
+    U32 i = 0;
+    rng_state = 1;
+    while (i < len) {
+        CONST CHAR *w = words[rng_next() % 19];
+        while (*w && i < len) buf[i++] = (U8)*w++;
+    }
+}
+
+static double seconds(long c) { return (double)c / HOST_CLOCKS_PER_SEC; }
+
+static void report(CONST CHAR *what, U32 count, long t) {
+    printf("  %-24s %8u ops  %9.3f ms  %8.3f us/op\n",
+           what, count, seconds(t) * 1e3, seconds(t) * 1e6 / count);
+}
+
+int main(void) {
+    PU8 doc = MAlloc(DOC_SIZE);
+    make_doc(doc, DOC_SIZE);
+
+    printf("=== TEXTBUF benchmark (%u KB document) ===\n", DOC_SIZE / 1024);
+
+    long t0 = clock();
+    TEXTBUF *tb = TEXTBUF_CREATE(doc, DOC_SIZE);
+    report("create + line index", 1, clock() - t0);
+    U32 lines = TEXTBUF_LINE_COUNT(tb);
+    printf("  %u lines\n", lines);
+
+    /* Random line -> offset -> line round trips */
+    U32 check = 0;
+    rng_state = 2;
+    t0 = clock();
+    for (U32 i = 0; i < LOOKUPS; i++) {
+        U32 line = rng_below(lines);
+        check += TEXTBUF_LINE_OF(tb, TEXTBUF_LINE_START(tb, line)) == line;
+    }
+    report("line lookup (pristine)", LOOKUPS, clock() - t0);
+    if (check != LOOKUPS) printf("  lookup mismatch!\n");
+
+    /* Editing session: jump to a line, type a few characters one at a
+       time, backspace over some, occasionally cut a whole line */
+    rng_state = 3;
+    U32 groups = 0;
+    t0 = clock();
+    for (U32 i = 0; i < EDITS; i++) {
+        U32 line = rng_below(TEXTBUF_LINE_COUNT(tb));
+        U32 at = TEXTBUF_LINE_START(tb, line) + rng_below(TEXTBUF_LINE_LENGTH(tb, line) + 1);
+        U32 op = rng_next() % 8;
+        if (op < 5) {
+            for (U32 k = 0; k < 4; k++) {
+                U8 c = (U8)('a' + rng_next() % 26);
+                TEXTBUF_INSERT(tb, at + k, &c, 1);
+            }
+        } else if (op < 7) {
+            if (at >= 2) {
+                TEXTBUF_DELETE(tb, at - 1, 1);
+                TEXTBUF_DELETE(tb, at - 2, 1);
+            }
+        } else {
+            U32 start = TEXTBUF_LINE_START(tb, line);
+            TEXTBUF_DELETE(tb, start, TEXTBUF_LINE_LENGTH(tb, line) + 1);
+        }
+        TEXTBUF_COMMIT(tb);
+        groups++;
+    }
+    report("scripted edits", EDITS, clock() - t0);
+    printf("  %u pieces, %u bytes\n", TEXTBUF_PIECE_COUNT(tb), TEXTBUF_LENGTH(tb));
+
+    rng_state = 4;
+    lines = TEXTBUF_LINE_COUNT(tb);
+    t0 = clock();
+    for (U32 i = 0; i < LOOKUPS; i++) TEXTBUF_LINE_START(tb, rng_below(lines));
+    report("line lookup (edited)", LOOKUPS, clock() - t0);
+
+    static U8 view[80 * 50];
+    t0 = clock();
+    for (U32 i = 0; i < LOOKUPS / 10; i++) {
+        U32 line = rng_below(lines);
+        TEXTBUF_READ(tb, TEXTBUF_LINE_START(tb, line), view, sizeof(view));
+    }
+    report("read 4 KB screen", LOOKUPS / 10, clock() - t0);
+
+    t0 = clock();
+    U32 undone = 0;
+    while (TEXTBUF_UNDO(tb, NULLPTR)) undone++;
+    report("undo all", undone, clock() - t0);
+    if (undone != groups || TEXTBUF_LENGTH(tb) != DOC_SIZE) printf("  undo mismatch!\n");
+
+    t0 = clock();
+    U32 redone = 0;
+    while (TEXTBUF_REDO(tb, NULLPTR)) redone++;
+    report("redo all", redone, clock() - t0);
+
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
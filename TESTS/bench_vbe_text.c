@@ -0,0 +1,129 @@
+/* Host benchmark for the span text renderer (DRIVERS/VESA/VBE_TEXT.c):
+   characters per second filling a 1024x768 24 bpp screen with FONT8x8
+   and the shell's FONT8x16, against the old one call per pixel path,
+   and rows alternating two colour pairs, with and without the span
+   table cache.
+   Build and run with `make bench` in TESTS/. */
+#define __RTOS__
+#include <DRIVERS/VESA/VBE.h>
+#undef __RTOS__
+#include <DRIVERS/VESA/VBE_TEXT.h>
+#include <DRIVERS/VESA/FONT8x8.h>
+#include <PROGRAMS/SHELL/FONT8x16.h>
+#include <STD/MEM.h>
+
+extern int printf(const char *format, ...);
+extern long clock(void);
+#define HOST_CLOCKS_PER_SEC 1000000L
+
+#define SCR_W 1024
+#define SCR_H 768
+#define BPP   3
+#define MIN_RUN_SECONDS 0.5
+
+static U8 *fb;
+static VBE_GLYPH_CACHE spans;
+static CONST VBE_FONT font8 = { &VBE_LETTERS[0][0], VBE_CHAR_HEIGHT, UNUSABLE_CHARS, VBE_MAX_CHARS };
+static CONST VBE_FONT font16 = { toshiba_t5200c_bios_vers_3__2__8x16, 16, 0, 256 };
+static U8 line[SCR_W / 8];
+
+static double seconds(long c) { return (double)c / HOST_CLOCKS_PER_SEC; }
+
+/* What VBE_DRAW_PIXEL did for every glyph pixel: bounds check, position,
+   then a switch on the pixel size */
+__attribute__((noinline))
+static BOOL pixel_path(I32 x, I32 y, VBE_PIXEL_COLOUR c) {
+    if (x < 0 || y < 0 || x >= SCR_W || y >= SCR_H) return FALSE;
+    if (c == VBE_SEE_THROUGH) return TRUE;
+    U32 pos = (U32)y * SCR_W * BPP + (U32)x * BPP;
+    switch (BPP) {
+        case 4: *(U32 *)(fb + pos) = c; break;
+        case 3:
+            fb[pos] = (U8)c;
+            fb[pos + 1] = (U8)(c >> 8);
+            fb[pos + 2] = (U8)(c >> 16);
+            break;
+        default: return FALSE;
+    }
+    return TRUE;
+}
+
+static U32 screen_pixel(CONST VBE_FONT *f, U32 advance) {
+    U32 chars = 0;
+    for (U32 y = 0; y + f->height <= SCR_H; y += f->height) {
+        for (U32 i = 0; i < SCR_W / advance; i++) {
+            U32 code = (U32)line[i] - f->first;
+            if (code >= f->count) continue;
+            for (U32 r = 0; r < f->height; r++) {
+                U8 bits = f->bits[code * f->height + r];
+                for (U32 c = 0; c < advance; c++)
+                    pixel_path(i * advance + c, y + r, (c < 8 && (bits & (0x80 >> c))) ? VBE_WHITE : VBE_BLACK);
+            }
+            chars++;
+        }
+    }
+    return chars;
+}
+
+static U32 screen_span(CONST VBE_FONT *f, U32 advance) {
+    VBE_TEXT_TARGET t = { fb, SCR_W * BPP, BPP, 0, 0, SCR_W, SCR_H };
+    U32 chars = 0;
+    for (U32 y = 0; y + f->height <= SCR_H; y += f->height)
+        chars += VBE_TEXT_RUN(&t, f, &spans, 0, (I32)y, line, SCR_W / advance, advance, VBE_WHITE, VBE_BLACK);
+    return chars;
+}
+
+/* A list with every other row selected: two fg/bg pairs, one per run */
+static U32 screen_pairs(CONST VBE_FONT *f, U32 advance, BOOL keep_tables) {
+    VBE_TEXT_TARGET t = { fb, SCR_W * BPP, BPP, 0, 0, SCR_W, SCR_H };
+    U32 chars = 0, row = 0;
+    for (U32 y = 0; y + f->height <= SCR_H; y += f->height, row++) {
+        if (!keep_tables) {
+            /* one table for every pair, as before the cache */
+            for (U32 i = 0; i < VBE_TEXT_SPAN_SLOTS; i++) spans.slot[i].bpp = 0;
+        }
+        BOOL selected = row & 1;
+        chars += VBE_TEXT_RUN(&t, f, &spans, 0, (I32)y, line, SCR_W / advance, advance,
+                              selected ? VBE_WHITE : VBE_BLACK, selected ? VBE_BLUE : VBE_WHITE);
+    }
+    return chars;
+}
+
+static U32 screen_pairs_rebuilt(CONST VBE_FONT *f, U32 advance) {
+    return screen_pairs(f, advance, FALSE);
+}
+
+static U32 screen_pairs_cached(CONST VBE_FONT *f, U32 advance) {
+    return screen_pairs(f, advance, TRUE);
+}
+
+static double run(CONST CHAR *name, U32 (*screen)(CONST VBE_FONT *, U32), CONST VBE_FONT *f, U32 advance) {
+    U32 chars = 0;
+    long t0 = clock(), t;
+    do {
+        chars += screen(f, advance);
+        t = clock() - t0;
+    } while (seconds(t) < MIN_RUN_SECONDS);
+    double cps = chars / seconds(t);
+    printf("  %-24s %10u chars  %9.3f ms  %8.2f M chars/s\n", name, chars, seconds(t) * 1e3, cps / 1e6);
+    return cps;
+}
+
+int main(void) {
+    fb = MAlloc(SCR_W * SCR_H * BPP);
+    for (U32 i = 0; i < sizeof(line); i++) line[i] = (U8)('!' + i % 94);
+
+    printf("=== VBE_TEXT benchmark (%ux%u, %u bpp) ===\n", SCR_W, SCR_H, BPP * 8);
+    double a = run("8x8 per pixel", screen_pixel, &font8, 8);
+    double b = run("8x8 spans", screen_span, &font8, 8);
+    printf("  speedup %.1fx\n", b / a);
+    a = run("8x16 shell per pixel", screen_pixel, &font16, 10);
+    b = run("8x16 shell spans", screen_span, &font16, 10);
+    printf("  speedup %.1fx\n", b / a);
+    a = run("8x8 two pairs rebuilt", screen_pairs_rebuilt, &font8, 8);
+    b = run("8x8 two pairs cached", screen_pairs_cached, &font8, 8);
+    printf("  speedup %.1fx\n", b / a);
+
+    MFree(fb);
+    return 0;
+}
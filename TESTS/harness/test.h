@@ -1,8 +1,11 @@
 #ifndef TEST_HARNESS_H
 #define TEST_HARNESS_H
 
-/* Forward declare printf to avoid pulling in host size_t before TYPEDEF.h */
+/* Forward declare printf to avoid pulling in host size_t before TYPEDEF.h.
+   Tests that include STD/IO.h first use its declaration instead. */
+#ifndef IO_H
 extern int printf(const char *format, ...);
+#endif
 
 #define TEST_ASSERT(cond) \
     do { \
@@ -0,0 +1,140 @@
+/* The assembler headers pull in STD/IO.h, so they go before the harness */
+#include <PROGRAMS/ASTRAC/ASSEMBLER/ASSEMBLER.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/MNEMONICS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/REGISTERS.h>
+#include <PROGRAMS/ASTRAC/ASSEMBLER/PHASH.h>
+#include <STD/STRING.h>
+#include "harness/test.h"
+
+#define MNEM_TOTAL (sizeof(asm_mnemonics) / sizeof(asm_mnemonics[0]))
+
+/* ============================================================
+   Reference: the linear scans the perfect hash replaced
+   ============================================================ */
+static U32 linear_mnemonics(PU8 name, U16 *out) {
+    U32 n = 0;
+    for (U32 i = 0; i < MNEM_TOTAL; i++)
+        if (asm_mnemonics[i].name && STRICMP(name, (PU8)asm_mnemonics[i].name) == 0)
+            out[n++] = (U16)i;
+    return n;
+}
+
+static const KEYWORD *linear_register(PU8 name) {
+    if (!name || !*name) return NULLPTR;
+    for (U32 i = 0; asm_registers[i].value; i++)
+        if (STRICMP(name, asm_registers[i].value) == 0) return &asm_registers[i];
+    return NULLPTR;
+}
+
+/* REGISTERS.h is a static table, so each object file has its own copy:
+   compare entries, not pointers */
+static BOOL same_register(const KEYWORD *a, const KEYWORD *b) {
+    if (!a || !b) return a == b;
+    return a->enum_val == b->enum_val && STRCMP(a->value, b->value) == 0;
+}
+
+/* Hash and linear scan agree on `name` for both tables */
+static int same_as_linear(PU8 name) {
+    U16 expect[MNEM_TOTAL];
+    U32 n = linear_mnemonics(name, expect);
+    U32 got_n = 0xFFFFFFFF;
+    const U16 *got = ASM_FIND_MNEMONIC(name, &got_n);
+
+    if (n == 0) {
+        if (got) return 0;
+    } else {
+        if (!got || got_n != n) return 0;
+        for (U32 i = 0; i < n; i++)
+            if (got[i] != expect[i]) return 0;
+    }
+    return same_register(ASM_FIND_REGISTER(name), linear_register(name));
+}
+
+static VOID to_upper(PU8 dst, PU8 src) {
+    while (*src) { *dst++ = TOUPPER(*src); src++; }
+    *dst = 0;
+}
+
+/* Alternates case: "mov" -> "MoV" */
+static VOID to_mixed(PU8 dst, PU8 src) {
+    for (U32 i = 0; src[i]; i++)
+        dst[i] = (i & 1) ? src[i] : TOUPPER(src[i]);
+    dst[STRLEN(src)] = 0;
+}
+
+/* ============================================================
+   Every table entry
+   ============================================================ */
+static int test_every_mnemonic_entry(void) {
+    U8 buf[64];
+    for (U32 i = 0; i < MNEM_TOTAL; i++) {
+        PU8 name = (PU8)asm_mnemonics[i].name;
+        if (!name) continue;
+        TEST_ASSERT(same_as_linear(name));
+        to_upper(buf, name);
+        TEST_ASSERT(same_as_linear(buf));
+        to_mixed(buf, name);
+        TEST_ASSERT(same_as_linear(buf));
+
+        /* The entry itself is among its name's variants */
+        U32 n = 0;
+        const U16 *v = ASM_FIND_MNEMONIC(name, &n);
+        BOOL found = FALSE;
+        for (U32 k = 0; v && k < n; k++) found |= v[k] == i;
+        TEST_ASSERT(found);
+    }
+    return 0;
+}
+
+static int test_every_register_entry(void) {
+    U8 buf[64];
+    for (U32 i = 0; asm_registers[i].value; i++) {
+        PU8 name = asm_registers[i].value;
+        TEST_ASSERT(same_register(ASM_FIND_REGISTER(name), &asm_registers[i]));
+        to_upper(buf, name);
+        TEST_ASSERT(same_as_linear(buf));
+        to_mixed(buf, name);
+        TEST_ASSERT(same_as_linear(buf));
+    }
+    return 0;
+}
+
+/* ============================================================
+   Non-keywords
+   ============================================================ */
+static int test_non_keywords(void) {
+    static const char *words[] = {
+        "", "_start", "main", "fn_0", "var_12", "movv", "mo", "eaxx", "ea",
+        "xmm8", "st", "cr1", "data", "DWORD", "ptr", "@@1", "movzxx", "jmp_", "0x10",
+    };
+    for (U32 i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        TEST_ASSERT(same_as_linear((PU8)words[i]));
+    TEST_ASSERT(ASM_FIND_MNEMONIC(NULLPTR, NULLPTR) == NULLPTR);
+    TEST_ASSERT(ASM_FIND_REGISTER(NULLPTR) == NULLPTR);
+    return 0;
+}
+
+/* Every identifier of up to three [a-z0-9] characters */
+static int test_exhaustive_short_names(void) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    U32 a = sizeof(alphabet) - 1;
+    U8 buf[4];
+    for (U32 len = 1; len <= 3; len++) {
+        U32 total = 1;
+        for (U32 k = 0; k < len; k++) total *= a;
+        for (U32 v = 0; v < total; v++) {
+            U32 x = v;
+            for (U32 k = 0; k < len; k++) { buf[k] = alphabet[x % a]; x /= a; }
+            buf[len] = 0;
+            TEST_ASSERT(same_as_linear(buf));
+        }
+    }
+    return 0;
+}
+
+TEST_MAIN("ASTRAC keyword perfect hash")
+    RUN_TEST(test_every_mnemonic_entry);
+    RUN_TEST(test_every_register_entry);
+    RUN_TEST(test_non_keywords);
+    RUN_TEST(test_exhaustive_short_names);
+TEST_RETURN
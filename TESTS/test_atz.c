@@ -0,0 +1,267 @@
+#include "harness/test.h"
+#include <LIBRARIES/ATZP/ATZ.h>
+#include <LIBRARIES/ATZP/ATZP.h>
+#include <LIBRARIES/ATHASH/CRC32.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+
+static U32 rng_state;
+static U32 rng_next(void) {
+    rng_state = rng_state * 1103515245U + 12345U;
+    return rng_state >> 16;
+}
+
+static void make_text(PU8 buf, U32 len, U32 seed) {
+    static CONST CHAR *words[] = { "atOS ", "archive ", "entry ", "crc ", "\n" };
+    U32 i = 0;
+    rng_state = seed;
+    while (i < len) {
+        CONST CHAR *w = words[rng_next() % 5];
+        while (*w && i < len) buf[i++] = (U8)*w++;
+    }
+}
+
+/* ============================================================
+   CRC32
+   ============================================================ */
+static int test_crc32_check_value(void) {
+    TEST_ASSERT(CRC32((PU8)"123456789", 9) == 0xCBF43926);
+    TEST_ASSERT(CRC32((PU8)"", 0) == 0);
+    TEST_ASSERT(CRC32((PU8)"a", 1) == 0xE8B7BE43);
+    TEST_ASSERT(CRC32((PU8)"The quick brown fox jumps over the lazy dog", 43) == 0x414FA339);
+    return 0;
+}
+
+/* Bitwise reference, one byte at a time */
+static U32 crc32_ref(PU8 p, U32 len) {
+    U32 c = 0xFFFFFFFF;
+    for (U32 i = 0; i < len; i++) {
+        c ^= p[i];
+        for (U32 k = 0; k < 8; k++) c = (c >> 1) ^ (0xEDB88320 & (0 - (c & 1)));
+    }
+    return ~c;
+}
+
+static int test_crc32_matches_bitwise_all_alignments(void) {
+    U8 buf[300];
+    rng_state = 42;
+    for (U32 i = 0; i < sizeof(buf); i++) buf[i] = (U8)rng_next();
+    for (U32 off = 0; off < 8; off++)
+        for (U32 len = 0; len < 40; len++)
+            TEST_ASSERT(CRC32(buf + off, len) == crc32_ref(buf + off, len));
+    TEST_ASSERT(CRC32(buf + 3, 290) == crc32_ref(buf + 3, 290));
+    return 0;
+}
+
+static int test_crc32_incremental(void) {
+    U8 buf[1000];
+    make_text(buf, sizeof(buf), 1);
+    U32 c = 0;
+    c = CRC32_UPDATE(c, buf, 1);
+    c = CRC32_UPDATE(c, buf + 1, 500);
+    c = CRC32_UPDATE(c, buf + 501, 499);
+    TEST_ASSERT(c == CRC32(buf, sizeof(buf)));
+    return 0;
+}
+
+/* ============================================================
+   Archive
+   ============================================================ */
+#define N_ENTRIES 300   /* more than the old ATZ1 limit of 256 */
+
+static U32 entry_size(U32 i) { return (i * 137) % 5000; }
+
+static void entry_name(PU8 out, U32 i) {
+    STRCPY(out, (PU8)"dir/file");
+    U32 n = STRLEN(out);
+    out[n++] = (U8)('0' + i / 100);
+    out[n++] = (U8)('0' + (i / 10) % 10);
+    out[n++] = (U8)('0' + i % 10);
+    out[n] = '\0';
+}
+
+static void entry_data(PU8 buf, U32 i) {
+    U32 len = entry_size(i);
+    if (i % 7 == 0) {
+        rng_state = i;
+        for (U32 k = 0; k < len; k++) buf[k] = (U8)rng_next();  /* stored raw */
+    } else {
+        make_text(buf, len, i);
+    }
+}
+
+static int build_archive(ATZ_MEM_SINK *sink, U32 hc_level) {
+    ATZ_WRITER w;
+    U8 name[32];
+    U8 buf[5000];
+    MEMZERO(sink, sizeof(*sink));
+    if (!ATZ_WRITER_INIT(&w, ATZ_MEM_SINK_WRITE, sink, hc_level)) return 0;
+    for (U32 i = 0; i < N_ENTRIES; i++) {
+        entry_name(name, i);
+        entry_data(buf, i);
+        if (!ATZ_WRITER_ADD(&w, name, buf, entry_size(i))) return 0;
+    }
+    int ok = ATZ_WRITER_FINISH(&w);
+    ATZ_WRITER_FREE(&w);
+    return ok;
+}
+
+static int test_archive_round_trip(void) {
+    ATZ_MEM_SINK sink;
+    ATZ_READER r;
+    U8 name[32];
+    U8 buf[5000];
+    TEST_ASSERT(build_archive(&sink, 0));
+
+    ATZ_MEM_SOURCE src = { sink.data, sink.size };
+    TEST_ASSERT(ATZ_READER_OPEN(&r, ATZ_MEM_SOURCE_READ_AT, &src, sink.size));
+    TEST_ASSERT(r.version == 2);
+    TEST_ASSERT(r.count == N_ENTRIES);
+
+    U32 lz4 = 0, raw = 0;
+    for (U32 i = 0; i < N_ENTRIES; i++) {
+        ATZ_ENTRY *e = &r.entries[i];
+        entry_name(name, i);
+        entry_data(buf, i);
+        TEST_ASSERT(STRCMP(e->name, name) == 0);
+        TEST_ASSERT(e->original_size == entry_size(i));
+        TEST_ASSERT(e->flags & ATZ_FLAG_CRC);
+        if (e->flags & ATZ_FLAG_LZ4) lz4++; else raw++;
+        PU8 out = ATZ_READER_EXTRACT(&r, e);
+        TEST_ASSERT(out != NULLPTR);
+        TEST_ASSERT(MEMCMP(out, buf, e->original_size) == 0);
+        MFree(out);
+    }
+    TEST_ASSERT(lz4 > 0 && raw > 0);
+
+    ATZ_READER_CLOSE(&r);
+    ATZ_MEM_SINK_FREE(&sink);
+    return 0;
+}
+
+/* Counts reads so random access can be checked to be O(1) seeks */
+typedef struct {
+    ATZ_MEM_SOURCE src;
+    U32 reads;
+} COUNTING_SOURCE;
+
+static BOOL counting_read_at(VOIDPTR io, U32 offset, PU8 buf, U32 len) {
+    COUNTING_SOURCE *c = (COUNTING_SOURCE *)io;
+    c->reads++;
+    return ATZ_MEM_SOURCE_READ_AT(&c->src, offset, buf, len);
+}
+
+static int test_archive_random_access(void) {
+    ATZ_MEM_SINK sink;
+    ATZ_READER r;
+    U8 buf[5000];
+    TEST_ASSERT(build_archive(&sink, LZ4HC_LEVEL_MIN));
+
+    COUNTING_SOURCE c = { { sink.data, sink.size }, 0 };
+    TEST_ASSERT(ATZ_READER_OPEN(&r, counting_read_at, &c, sink.size));
+    TEST_ASSERT(c.reads == 3);      /* magic, trailer, directory */
+
+    ATZ_ENTRY *e = ATZ_READER_FIND(&r, (PU8)"dir/file271");
+    TEST_ASSERT(e != NULLPTR);
+    TEST_ASSERT(ATZ_READER_FIND(&r, (PU8)"dir/missing") == NULLPTR);
+
+    c.reads = 0;
+    PU8 out = ATZ_READER_EXTRACT(&r, e);
+    TEST_ASSERT(out != NULLPTR);
+    TEST_ASSERT(c.reads == 1);
+    entry_data(buf, 271);
+    TEST_ASSERT(MEMCMP(out, buf, entry_size(271)) == 0);
+    MFree(out);
+
+    ATZ_READER_CLOSE(&r);
+    ATZ_MEM_SINK_FREE(&sink);
+    return 0;
+}
+
+static int test_archive_detects_corruption(void) {
+    ATZ_MEM_SINK sink;
+    ATZ_READER r;
+    TEST_ASSERT(build_archive(&sink, 0));
+    ATZ_MEM_SOURCE src = { sink.data, sink.size };
+
+    /* Flip a byte inside one entry's data: that entry fails, others still extract */
+    TEST_ASSERT(ATZ_READER_OPEN(&r, ATZ_MEM_SOURCE_READ_AT, &src, sink.size));
+    ATZ_ENTRY *e = &r.entries[5];
+    ATZ_ENTRY *other = &r.entries[6];
+    sink.data[e->data_offset + e->compressed_size / 2] ^= 0x20;
+    PU8 out = ATZ_READER_EXTRACT(&r, e);
+    TEST_ASSERT(out == NULLPTR);
+    out = ATZ_READER_EXTRACT(&r, other);
+    TEST_ASSERT(out != NULLPTR);
+    MFree(out);
+    ATZ_READER_CLOSE(&r);
+
+    /* A damaged directory is rejected at open */
+    U32 dir_offset = sink.data[sink.size - 20] | (sink.data[sink.size - 19] << 8) |
+                     (sink.data[sink.size - 18] << 16) | (sink.data[sink.size - 17] << 24);
+    sink.data[dir_offset + 3] ^= 0x01;
+    TEST_ASSERT(!ATZ_READER_OPEN(&r, ATZ_MEM_SOURCE_READ_AT, &src, sink.size));
+
+    /* Truncated archive */
+    TEST_ASSERT(!ATZ_READER_OPEN(&r, ATZ_MEM_SOURCE_READ_AT, &src, sink.size - 1));
+
+    ATZ_MEM_SINK_FREE(&sink);
+    return 0;
+}
+
+static int test_archive_empty_entries(void) {
+    ATZ_MEM_SINK sink = { 0 };
+    ATZ_WRITER w;
+    ATZ_READER r;
+    TEST_ASSERT(ATZ_WRITER_INIT(&w, ATZ_MEM_SINK_WRITE, &sink, 0));
+    TEST_ASSERT(ATZ_WRITER_ADD(&w, (PU8)"empty", NULLPTR, 0));
+    TEST_ASSERT(!ATZ_WRITER_ADD(&w, (PU8)"", (PU8)"x", 1));
+    TEST_ASSERT(ATZ_WRITER_FINISH(&w));
+    ATZ_WRITER_FREE(&w);
+
+    ATZ_MEM_SOURCE src = { sink.data, sink.size };
+    TEST_ASSERT(ATZ_READER_OPEN(&r, ATZ_MEM_SOURCE_READ_AT, &src, sink.size));
+    TEST_ASSERT(r.count == 1);
+    TEST_ASSERT(r.entries[0].original_size == 0);
+    PU8 out = ATZ_READER_EXTRACT(&r, &r.entries[0]);
+    TEST_ASSERT(out != NULLPTR);
+    MFree(out);
+    ATZ_READER_CLOSE(&r);
+    ATZ_MEM_SINK_FREE(&sink);
+    return 0;
+}
+
+static int test_archive_reads_v1(void) {
+    /* "ATZ1", 2 entries stored raw: "a" = "hello", "b/c" = "" */
+    static U8 v1[] = {
+        'A', 'T', 'Z', '1', 2, 0, 0, 0,
+        1, 0, 'a', 5, 0, 0, 0, 5, 0, 0, 0, 42, 0, 0, 0, 0,
+        3, 0, 'b', '/', 'c', 0, 0, 0, 0, 0, 0, 0, 0, 47, 0, 0, 0, 0,
+        'h', 'e', 'l', 'l', 'o'
+    };
+    ATZ_READER r;
+    ATZ_MEM_SOURCE src = { v1, sizeof(v1) };
+    TEST_ASSERT(sizeof(v1) == 47);
+    TEST_ASSERT(ATZ_READER_OPEN(&r, ATZ_MEM_SOURCE_READ_AT, &src, sizeof(v1)));
+    TEST_ASSERT(r.version == 1);
+    TEST_ASSERT(r.count == 2);
+    ATZ_ENTRY *e = ATZ_READER_FIND(&r, (PU8)"a");
+    TEST_ASSERT(e != NULLPTR && !(e->flags & ATZ_FLAG_CRC));
+    PU8 out = ATZ_READER_EXTRACT(&r, e);
+    TEST_ASSERT(out != NULLPTR && MEMCMP(out, "hello", 5) == 0);
+    MFree(out);
+    TEST_ASSERT(ATZ_READER_FIND(&r, (PU8)"b/c") != NULLPTR);
+    ATZ_READER_CLOSE(&r);
+    return 0;
+}
+
+TEST_MAIN("ATZ")
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_crc32_matches_bitwise_all_alignments);
+    RUN_TEST(test_crc32_incremental);
+    RUN_TEST(test_archive_round_trip);
+    RUN_TEST(test_archive_random_access);
+    RUN_TEST(test_archive_detects_corruption);
+    RUN_TEST(test_archive_empty_entries);
+    RUN_TEST(test_archive_reads_v1);
+TEST_RETURN
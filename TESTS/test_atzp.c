@@ -0,0 +1,267 @@
+#include "harness/test.h"
+#include <LIBRARIES/ATZP/ATZP.h>
+#include <STD/MEM.h>
+
+/* Deterministic test corpus: text-like runs mixed with noise */
+static U32 rng_state;
+static U32 rng_next(void) {
+    rng_state = rng_state * 1103515245U + 12345U;
+    return rng_state >> 16;
+}
+
+static void make_corpus(PU8 buf, U32 len, U32 seed) {
+    static CONST CHAR *words[] = { "atOS ", "kernel ", "LZ4 ", "frame ", "block ", "match ", "\n" };
+    U32 i = 0;
+    rng_state = seed;
+    while (i < len) {
+        if ((rng_next() & 7) == 0) {
+            buf[i++] = (U8)rng_next();
+            continue;
+        }
+        CONST CHAR *w = words[rng_next() % 7];
+        while (*w && i < len) buf[i++] = (U8)*w++;
+    }
+}
+
+static int round_trip_fast(PU8 src, U32 len, U32 acceleration) {
+    U32 bound = LZ4_COMPRESS_BOUND(len);
+    PU8 cmp = MAlloc(bound);
+    PU8 out = MAlloc(len + 1);
+    U32 c = LZ4_COMPRESS_FAST(src, len, cmp, bound, acceleration);
+    U32 d = c ? LZ4_DECOMPRESS(cmp, c, out, len) : 0;
+    int ok = c > 0 && d == len && MEMCMP(src, out, len) == 0;
+    MFree(cmp);
+    MFree(out);
+    return ok;
+}
+
+/* ============================================================
+   Block API
+   ============================================================ */
+static int test_lz4_small_inputs(void) {
+    U8 buf[16] = "abcdefghijklmno";
+    for (U32 n = 1; n <= 15; n++) TEST_ASSERT(round_trip_fast(buf, n, 1));
+    return 0;
+}
+
+static int test_lz4_round_trip_corpus(void) {
+    U32 len = 200000;
+    PU8 src = MAlloc(len);
+    make_corpus(src, len, 1);
+    TEST_ASSERT(round_trip_fast(src, len, 1));
+    TEST_ASSERT(round_trip_fast(src, len, 8));
+    TEST_ASSERT(round_trip_fast(src, len, LZ4_ACCELERATION_MAX));
+    MFree(src);
+    return 0;
+}
+
+static int test_lz4_incompressible(void) {
+    U32 len = 70000;
+    PU8 src = MAlloc(len);
+    rng_state = 7;
+    for (U32 i = 0; i < len; i++) src[i] = (U8)rng_next();
+    TEST_ASSERT(round_trip_fast(src, len, 1));
+    TEST_ASSERT(round_trip_fast(src, len, 4));
+    MFree(src);
+    return 0;
+}
+
+static int test_lz4_repeated_calls_share_table(void) {
+    /* Second call must not match against the first call's buffer */
+    U32 len = 4096;
+    PU8 a = MAlloc(len);
+    PU8 b = MAlloc(len);
+    make_corpus(a, len, 3);
+    make_corpus(b, len, 4);
+    TEST_ASSERT(round_trip_fast(a, len, 1));
+    TEST_ASSERT(round_trip_fast(b, len, 1));
+    TEST_ASSERT(round_trip_fast(a, len, 1));
+    MFree(a);
+    MFree(b);
+    return 0;
+}
+
+static int test_lz4_acceleration_tradeoff(void) {
+    U32 len = 100000;
+    U32 bound = LZ4_COMPRESS_BOUND(len);
+    PU8 src = MAlloc(len);
+    PU8 cmp = MAlloc(bound);
+    make_corpus(src, len, 5);
+    U32 c1 = LZ4_COMPRESS_FAST(src, len, cmp, bound, 1);
+    U32 c64 = LZ4_COMPRESS_FAST(src, len, cmp, bound, 64);
+    TEST_ASSERT(c1 > 0 && c64 > 0);
+    TEST_ASSERT(c1 <= c64);
+    MFree(src);
+    MFree(cmp);
+    return 0;
+}
+
+static int test_lz4_dst_too_small(void) {
+    U8 src[64];
+    U8 cmp[8];
+    for (U32 i = 0; i < sizeof(src); i++) src[i] = (U8)(i * 37);
+    TEST_ASSERT(LZ4_COMPRESS(src, sizeof(src), cmp, sizeof(cmp)) == 0);
+    return 0;
+}
+
+static int test_lz4hc_round_trip_and_ratio(void) {
+    U32 len = 150000;
+    U32 bound = LZ4_COMPRESS_BOUND(len);
+    PU8 src = MAlloc(len);
+    PU8 cmp = MAlloc(bound);
+    PU8 out = MAlloc(len);
+    make_corpus(src, len, 9);
+
+    U32 fast = LZ4_COMPRESS(src, len, cmp, bound);
+    U32 hc = LZ4_COMPRESS_HC(src, len, cmp, bound, LZ4HC_LEVEL_DEFAULT);
+    TEST_ASSERT(hc > 0);
+    TEST_ASSERT(hc < fast);
+    TEST_ASSERT(LZ4_DECOMPRESS(cmp, hc, out, len) == len);
+    TEST_ASSERT(MEMCMP(src, out, len) == 0);
+
+    hc = LZ4_COMPRESS_HC(src, 10, cmp, bound, LZ4HC_LEVEL_MIN);
+    TEST_ASSERT(LZ4_DECOMPRESS(cmp, hc, out, len) == 10);
+    MFree(src);
+    MFree(cmp);
+    MFree(out);
+    return 0;
+}
+
+/* ============================================================
+   Frame API
+   ============================================================ */
+static U32 frame_compress(PU8 src, U32 len, U32 chunk, U32 hc_level, PU8 out) {
+    LZ4F_CCTX c;
+    U32 n, total = 0;
+    if (!LZ4F_COMPRESS_BEGIN(&c, 1, hc_level, out, LZ4F_HEADER_SIZE, &n)) return 0;
+    total += n;
+    for (U32 i = 0; i < len; i += chunk) {
+        U32 part = (len - i < chunk) ? len - i : chunk;
+        if (!LZ4F_COMPRESS_UPDATE(&c, src + i, part, out + total, LZ4F_UPDATE_BOUND(part), &n)) return 0;
+        total += n;
+    }
+    if (!LZ4F_COMPRESS_END(&c, out + total, LZ4F_END_BOUND, &n)) return 0;
+    return total + n;
+}
+
+/* Feeds the frame in in_chunk pieces into an out_chunk sized window */
+static LZ4F_STATUS frame_decompress(PU8 frame, U32 len, U32 in_chunk, U32 out_chunk, PU8 out, U32 *out_len) {
+    LZ4F_DCTX d;
+    LZ4F_STATUS st = LZ4F_NEED_MORE;
+    U32 in = 0, produced = 0;
+    LZ4F_DECOMPRESS_INIT(&d);
+    while (st == LZ4F_NEED_MORE) {
+        U32 avail = (len - in < in_chunk) ? len - in : in_chunk;
+        U32 src_len = avail, dst_len = out_chunk;
+        st = LZ4F_DECOMPRESS_UPDATE(&d, frame + in, &src_len, out + produced, &dst_len);
+        in += src_len;
+        produced += dst_len;
+        if (st == LZ4F_NEED_MORE && src_len == 0 && dst_len == 0 && in == len) break;
+    }
+    LZ4F_DECOMPRESS_FREE(&d);
+    *out_len = produced;
+    return st;
+}
+
+static int test_lz4f_header_layout(void) {
+    U8 hdr[LZ4F_HEADER_SIZE];
+    LZ4F_CCTX c;
+    U32 n;
+    TEST_ASSERT(LZ4F_COMPRESS_BEGIN(&c, 1, 0, hdr, sizeof(hdr), &n));
+    TEST_ASSERT(n == LZ4F_HEADER_SIZE);
+    TEST_ASSERT(hdr[0] == 0x04 && hdr[1] == 0x22 && hdr[2] == 0x4D && hdr[3] == 0x18);
+    TEST_ASSERT(hdr[4] == 0x44);    /* version 01, linked blocks, content checksum */
+    TEST_ASSERT(hdr[5] == 0x40);    /* 64 KB blocks */
+    LZ4F_COMPRESS_FREE(&c);
+    return 0;
+}
+
+static int test_lz4f_round_trip_linked_blocks(void) {
+    U32 len = 300000;               /* several 64 KB blocks */
+    PU8 src = MAlloc(len);
+    PU8 frame = MAlloc(len + len / 8 + 1024);
+    PU8 out = MAlloc(len);
+    U32 got = 0;
+    make_corpus(src, len, 11);
+
+    U32 flen = frame_compress(src, len, 10007, 0, frame);
+    TEST_ASSERT(flen > 0 && flen < len);
+    TEST_ASSERT(frame_decompress(frame, flen, 4096, 777, out, &got) == LZ4F_FRAME_DONE);
+    TEST_ASSERT(got == len);
+    TEST_ASSERT(MEMCMP(src, out, len) == 0);
+
+    flen = frame_compress(src, len, len, LZ4HC_LEVEL_DEFAULT, frame);
+    TEST_ASSERT(flen > 0);
+    TEST_ASSERT(frame_decompress(frame, flen, 1, len, out, &got) == LZ4F_FRAME_DONE);
+    TEST_ASSERT(got == len);
+    TEST_ASSERT(MEMCMP(src, out, len) == 0);
+
+    MFree(src);
+    MFree(frame);
+    MFree(out);
+    return 0;
+}
+
+static int test_lz4f_empty_frame(void) {
+    U8 frame[64];
+    U8 out[4];
+    U32 got = 1;
+    U32 flen = frame_compress(NULLPTR, 0, 1, 0, frame);
+    TEST_ASSERT(flen == LZ4F_HEADER_SIZE + 8);
+    TEST_ASSERT(frame_decompress(frame, flen, flen, sizeof(out), out, &got) == LZ4F_FRAME_DONE);
+    TEST_ASSERT(got == 0);
+    return 0;
+}
+
+static int test_lz4f_detects_corruption(void) {
+    U32 len = 20000;
+    PU8 src = MAlloc(len);
+    PU8 frame = MAlloc(len + 1024);
+    PU8 out = MAlloc(len);
+    U32 got;
+    make_corpus(src, len, 13);
+
+    U32 flen = frame_compress(src, len, len, 0, frame);
+    frame[flen - 1] ^= 0x55;        /* content checksum */
+    TEST_ASSERT(frame_decompress(frame, flen, flen, len, out, &got) == LZ4F_ERROR);
+    frame[flen - 1] ^= 0x55;
+    frame[6] ^= 0x01;               /* header checksum */
+    TEST_ASSERT(frame_decompress(frame, flen, flen, len, out, &got) == LZ4F_ERROR);
+
+    MFree(src);
+    MFree(frame);
+    MFree(out);
+    return 0;
+}
+
+static int test_lz4f_decodes_reference_frame(void) {
+    /* `lz4 -B4 --content-size` of "atOS LZ4 frame " x 20 */
+    static U8 ref[] = {
+        0x04, 0x22, 0x4d, 0x18, 0x6c, 0x40, 0x2c, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x54, 0x1b, 0x00, 0x00, 0x00, 0xff, 0x00, 0x61, 0x74, 0x4f,
+        0x53, 0x20, 0x4c, 0x5a, 0x34, 0x20, 0x66, 0x72, 0x61, 0x6d, 0x65, 0x20,
+        0x0f, 0x00, 0xff, 0x06, 0x50, 0x72, 0x61, 0x6d, 0x65, 0x20, 0x00, 0x00,
+        0x00, 0x00, 0xd6, 0x6d, 0xea, 0x46
+    };
+    U8 out[400];
+    U32 got;
+    TEST_ASSERT(frame_decompress(ref, sizeof(ref), 5, sizeof(out), out, &got) == LZ4F_FRAME_DONE);
+    TEST_ASSERT(got == 300);
+    for (U32 i = 0; i < 300; i += 15) TEST_ASSERT(MEMCMP(out + i, "atOS LZ4 frame ", 15) == 0);
+    return 0;
+}
+
+TEST_MAIN("ATZP")
+    RUN_TEST(test_lz4_small_inputs);
+    RUN_TEST(test_lz4_round_trip_corpus);
+    RUN_TEST(test_lz4_incompressible);
+    RUN_TEST(test_lz4_repeated_calls_share_table);
+    RUN_TEST(test_lz4_acceleration_tradeoff);
+    RUN_TEST(test_lz4_dst_too_small);
+    RUN_TEST(test_lz4hc_round_trip_and_ratio);
+    RUN_TEST(test_lz4f_header_layout);
+    RUN_TEST(test_lz4f_round_trip_linked_blocks);
+    RUN_TEST(test_lz4f_empty_frame);
+    RUN_TEST(test_lz4f_detects_corruption);
+    RUN_TEST(test_lz4f_decodes_reference_frame);
+TEST_RETURN
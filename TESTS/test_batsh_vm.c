@@ -0,0 +1,219 @@
+#include <PROGRAMS/SYS_PROGS/TSHELL/BATSH_VM.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+#include "harness/test.h"
+
+/* ============================================================
+   Fake shell: records executed lines, keeps globals in a table
+   ============================================================ */
+#define FAKE_GLOBALS 16
+
+static U8  out[16384];
+static U32 out_len;
+static U32 exec_calls;
+static U8  g_name[FAKE_GLOBALS][32];
+static U8  g_value[FAKE_GLOBALS][BATSH_VM_VALUE_MAX];
+static U32 g_count;
+static U32 get_calls;
+
+static VOID fake_exec(VOIDPTR ctx, PU8 line) {
+    U32 n = STRLEN(line);
+    exec_calls++;
+    if (out_len + n + 2 >= sizeof(out)) return;
+    MEMCPY(out + out_len, line, n);
+    out_len += n;
+    out[out_len++] = '|';
+    out[out_len] = 0;
+}
+
+static PU8 fake_get(VOIDPTR ctx, PU8 name) {
+    get_calls++;
+    for (U32 i = 0; i < g_count; i++)
+        if (STRICMP(g_name[i], name) == 0) return g_value[i];
+    return NULLPTR;
+}
+
+static VOID fake_set(VOIDPTR ctx, PU8 name, PU8 value) {
+    PU8 v = fake_get(ctx, name);
+    if (!v) {
+        if (g_count == FAKE_GLOBALS) return;
+        STRNCPY(g_name[g_count], name, 31);
+        v = g_value[g_count++];
+    }
+    STRNCPY(v, value, BATSH_VM_VALUE_MAX - 1);
+}
+
+static U32 fake_gen(VOIDPTR ctx) { return g_count; }
+
+static BOOL fake_exists(VOIDPTR ctx, PU8 path) {
+    return STRICMP(path, (PU8)"/HOME/SEND.SH") == 0;
+}
+
+static PU8 script_args[] = { (PU8)"SCRIPT.SH", (PU8)"alpha", (PU8)"7" };
+
+static BATSH_VM_ENV env = {
+    NULLPTR, fake_exec, fake_get, fake_set, fake_gen, fake_exists, script_args, 3,
+};
+
+static VOID reset(VOID) {
+    out_len = 0;
+    out[0] = 0;
+    exec_calls = 0;
+    g_count = 0;
+    get_calls = 0;
+}
+
+/* Compiles and runs `src`; returns the '|'-joined executed lines */
+static PU8 run(const CHAR *src) {
+    reset();
+    BATSH_VM_ERROR err = { 0 };
+    BATSH_PROGRAM *p = BATSH_COMPILE((PU8)src, STRLEN((PU8)src), &err);
+    if (!p) {
+        printf("\n    compile error line %u: %s\n", err.line, err.msg);
+        return (PU8)"<compile error>";
+    }
+    BATSH_RUN(p, &env);
+    BATSH_FREE_PROGRAM(p);
+    return out;
+}
+
+static BOOL same(PU8 got, const CHAR *want) {
+    if (STRCMP(got, (PU8)want) == 0) return TRUE;
+    printf("\n    got:  %s\n    want: %s\n", got, want);
+    return FALSE;
+}
+
+/* Compile must fail on `line` */
+static BOOL fails_at(const CHAR *src, U32 line) {
+    BATSH_VM_ERROR err = { 0 };
+    BATSH_PROGRAM *p = BATSH_COMPILE((PU8)src, STRLEN((PU8)src), &err);
+    if (p) { BATSH_FREE_PROGRAM(p); return FALSE; }
+    return err.line == line && err.msg != NULLPTR;
+}
+
+/* ============================================================
+   Tests
+   ============================================================ */
+static int test_commands_and_comments(void) {
+    TEST_ASSERT(same(run("echo one\n# skipped\nrem skipped; too\n  dir  \r\necho a; echo b # tail\n"),
+                     "echo one|dir|echo a|echo b|"));
+    TEST_ASSERT(same(run("echo \"a;b\"; echo c\\\n  d\n"), "echo \"a;b\"|echo c   d|"));
+    return 0;
+}
+
+static int test_variables(void) {
+    TEST_ASSERT(same(run("@name = World\necho Hello @{name}!\n@name=there\necho @{NAME} @name\n"),
+                     "echo Hello World!|echo there @name|"));
+    TEST_ASSERT(same(run("@a = x\n@b = @a and @{a}\necho @{b} @{missing}.\n"), "echo x and x .|"));
+    TEST_ASSERT(same(run("@q = \"two words\"\necho [@{q}]\n"), "echo [two words]|"));
+    return 0;
+}
+
+static int test_args(void) {
+    TEST_ASSERT(same(run("echo @{0} @{1} @{2} [@{3}]\n@n = @{2} * 2\necho @{n}\n"),
+                     "echo SCRIPT.SH alpha 7 []|echo 14|"));
+    TEST_ASSERT(fails_at("\n@1 = 5\n", 2));
+    return 0;
+}
+
+static int test_arithmetic(void) {
+    TEST_ASSERT(same(run("@c = 5 + 3\n@d = @c * 2 - 1\n@e = 10-2*3\n@f = -4 + 1\n@g = 7 / 0\n"
+                         "echo @{c} @{d} @{e} @{f} @{g}\n"),
+                     "echo 8 15 24 -3 7|"));
+    /* Not arithmetic: kept as text */
+    TEST_ASSERT(same(run("@s = a + b\n@t = 5\n@u = 1+x\necho @{s}/@{t}/@{u}\n"), "echo a + b/5/1+x|"));
+    return 0;
+}
+
+static int test_if_else(void) {
+    TEST_ASSERT(same(run("@x = 3\n"
+                         "IF @x EQU 3 THEN\n  echo three\nELSE\n  echo other\nFI\n"
+                         "if @{x} gtr 5 then echo big; else echo small; fi\n"
+                         "if @x neq 3 then\n echo no\nfi\n"
+                         "if abc equ ABC then echo ci; fi\n"
+                         "if /HOME/SEND.SH exists then echo found; fi\n"
+                         "if /NOPE exists then echo bad; else echo none; fi\n"),
+                     "echo three|echo small|echo ci|echo found|echo none|"));
+    return 0;
+}
+
+static int test_range_loop(void) {
+    TEST_ASSERT(same(run("LOOP 1 TO 3\n  echo i=@{I}\nEND\n"), "echo i=1|echo i=2|echo i=3|"));
+    TEST_ASSERT(same(run("@n = 2\nloop 1 to @n\n loop 5 to 6\n  echo @{I}\n end\nend\n"),
+                     "echo 5|echo 6|echo 5|echo 6|"));
+    TEST_ASSERT(same(run("loop 3 to 1\necho never\nend\necho after\n"), "echo after|"));
+    /* Capped like the line interpreter */
+    run("loop 1 to 200000\n@k = @k + 1\nend\necho @{k}\n");
+    TEST_ASSERT(same(out, "echo 100000|"));
+    return 0;
+}
+
+static int test_condition_loop_and_break(void) {
+    TEST_ASSERT(same(run("@i = 0\nloop @i lss 3\n echo @{i}\n @i = @i + 1\nend\n"), "echo 0|echo 1|echo 2|"));
+    TEST_ASSERT(same(run("loop 1 to 10\n if @I equ 3 then\n  break\n fi\n echo @{I}\nend\necho done\n"),
+                     "echo 1|echo 2|echo done|"));
+    TEST_ASSERT(same(run("@i = 0\nloop 1 equ 1\n @i = @i + 1\n if @i geq 4 then break; fi\nend\necho @{i}\n"),
+                     "echo 4|"));
+    run("loop 1 equ 1\nend\n@z = 1\n");
+    TEST_ASSERT(exec_calls == 0);
+    return 0;
+}
+
+static int test_globals(void) {
+    reset();
+    const CHAR *src = "@@G = 1\n@G = 2\n@l = 5\necho @{G} @@{G} @{l}\n";
+    BATSH_VM_ERROR err;
+    BATSH_PROGRAM *p = BATSH_COMPILE((PU8)src, STRLEN((PU8)src), &err);
+    TEST_ASSERT(p != NULLPTR);
+    BATSH_RUN(p, &env);
+    /* A local assignment updates an existing global */
+    TEST_ASSERT(same(out, "echo 2 2 5|"));
+    TEST_ASSERT(g_count == 1 && STRCMP(g_value[0], (PU8)"2") == 0);
+
+    BATSH_FREE_PROGRAM(p);
+
+    /* Misses are cached until a global is created */
+    run("loop 1 to 50\n echo @{unset}\nend\n");
+    TEST_ASSERT(exec_calls == 50 && get_calls < 5);
+    return 0;
+}
+
+static int test_program_reuse(void) {
+    const CHAR *src = "@n = 0\nloop 1 to 4\n @n = @n + @I\nend\necho @{n}\n";
+    BATSH_VM_ERROR err;
+    BATSH_PROGRAM *p = BATSH_COMPILE((PU8)src, STRLEN((PU8)src), &err);
+    TEST_ASSERT(p != NULLPTR);
+    /* Locals start empty on every run */
+    for (U32 k = 0; k < 3; k++) {
+        reset();
+        TEST_ASSERT(BATSH_RUN(p, &env));
+        TEST_ASSERT(same(out, "echo 10|"));
+    }
+    BATSH_FREE_PROGRAM(p);
+    return 0;
+}
+
+static int test_compile_errors(void) {
+    TEST_ASSERT(fails_at("echo a\nfi\n", 2));
+    TEST_ASSERT(fails_at("loop 1 to 2\necho\n", 1));
+    TEST_ASSERT(fails_at("if a equ b then\n loop 1 to 2\n fi\nend\n", 3));
+    TEST_ASSERT(fails_at("echo\n\nbreak\n", 3));
+    TEST_ASSERT(fails_at("if a is b then echo x; fi\n", 1));
+    TEST_ASSERT(fails_at("else\n", 1));
+    TEST_ASSERT(fails_at("echo \\\nx\nend\n", 3));
+    TEST_ASSERT(fails_at("if a equ\n", 1));
+    return 0;
+}
+
+TEST_MAIN("BATSH VM")
+    RUN_TEST(test_commands_and_comments);
+    RUN_TEST(test_variables);
+    RUN_TEST(test_args);
+    RUN_TEST(test_arithmetic);
+    RUN_TEST(test_if_else);
+    RUN_TEST(test_range_loop);
+    RUN_TEST(test_condition_loop_and_break);
+    RUN_TEST(test_globals);
+    RUN_TEST(test_program_reuse);
+    RUN_TEST(test_compile_errors);
+TEST_RETURN
@@ -0,0 +1,121 @@
+#include "harness/test.h"
+#include <STD/BENCH.h>
+#include <STD/ASM.h>
+
+/* Scripted clock in place of STD/TIME.c: every TSC_NOW costs one cycle,
+   a benchmarked call costs whatever it adds. 1 cycle = 1 us at 1 MHz. */
+static U32 fake_clock;
+static U32 fake_khz = 1000;
+
+U32 TSC_NOW(void) { return fake_clock++; }
+U32 TSC_KHZ(void) { return fake_khz; }
+U32 TSC_TO_NS(U32 cycles) { return fake_khz ? umuldiv32(cycles, 1000000, fake_khz) : 0; }
+U32 TSC_TO_US(U32 cycles) { return fake_khz ? umuldiv32(cycles, 1000, fake_khz) : 0; }
+
+static void burn(VOIDPTR arg) { fake_clock += *(U32 *)arg; }
+
+/* Cost grows by one cycle per call, so samples are 7, 8, 9, ... */
+static void ramp(VOIDPTR arg) { fake_clock += (*(U32 *)arg)++; }
+
+/* ============================================================
+   umuldiv32
+   ============================================================ */
+static int test_umuldiv32_exact(void) {
+    TEST_ASSERT(umuldiv32(6, 7, 3) == 14);
+    TEST_ASSERT(umuldiv32(3000000000u, 1000000, 3000000) == 1000000000u);
+    TEST_ASSERT(umuldiv32(0xFFFFFFFF, 2, 4) == 0x7FFFFFFF);
+    return 0;
+}
+
+static int test_umuldiv32_saturates(void) {
+    TEST_ASSERT(umuldiv32(0xFFFFFFFF, 1000000, 1000) == 0xFFFFFFFF);
+    TEST_ASSERT(umuldiv32(1, 1, 0) == 0xFFFFFFFF);
+    return 0;
+}
+
+/* ============================================================
+   BENCH_SUMMARIZE
+   ============================================================ */
+static int test_summarize_odd(void) {
+    U32 c[] = { 5, 1, 3 };
+    BENCH_RESULT r;
+    BENCH_SUMMARIZE(c, 3, &r);
+    TEST_ASSERT(r.runs == 3);
+    TEST_ASSERT(r.min_ns == 1000);
+    TEST_ASSERT(r.median_ns == 3000);
+    TEST_ASSERT(r.max_ns == 5000);
+    TEST_ASSERT(r.mean_ns == 3000);
+    TEST_ASSERT(c[0] == 1 && c[1] == 3 && c[2] == 5);
+    return 0;
+}
+
+static int test_summarize_even(void) {
+    U32 c[] = { 40, 10, 30, 20 };
+    BENCH_RESULT r;
+    BENCH_SUMMARIZE(c, 4, &r);
+    TEST_ASSERT(r.median_cycles == 25);
+    TEST_ASSERT(r.mean_ns == 25000);
+    return 0;
+}
+
+static int test_summarize_empty(void) {
+    BENCH_RESULT r;
+    r.runs = 99;
+    BENCH_SUMMARIZE(NULLPTR, 0, &r);
+    TEST_ASSERT(r.runs == 0 && r.median_ns == 0);
+    return 0;
+}
+
+/* ============================================================
+   BENCH_RUN
+   ============================================================ */
+static int test_run_subtracts_overhead(void) {
+    U32 cost = 7;
+    BENCH_RESULT r;
+    TEST_ASSERT(BENCH_RUN(burn, &cost, 100, &r));
+    TEST_ASSERT(r.runs == 100);
+    TEST_ASSERT(r.median_cycles == 7);
+    TEST_ASSERT(r.min_ns == 7000 && r.max_ns == 7000);
+    return 0;
+}
+
+static int test_run_median_of_ramp(void) {
+    U32 cost = 7;   /* warm-up call takes 7, timed calls 8..12 */
+    BENCH_RESULT r;
+    TEST_ASSERT(BENCH_RUN(ramp, &cost, 5, &r));
+    TEST_ASSERT(r.min_ns == 8000);
+    TEST_ASSERT(r.median_ns == 10000);
+    TEST_ASSERT(r.max_ns == 12000);
+    return 0;
+}
+
+static int test_run_caps_runs(void) {
+    U32 cost = 1;
+    BENCH_RESULT r;
+    TEST_ASSERT(BENCH_RUN(burn, &cost, BENCH_MAX_RUNS + 10, &r));
+    TEST_ASSERT(r.runs == BENCH_MAX_RUNS);
+    return 0;
+}
+
+static int test_run_without_tsc(void) {
+    U32 cost = 1;
+    BENCH_RESULT r;
+    fake_khz = 0;
+    BOOLEAN ok = BENCH_RUN(burn, &cost, 10, &r);
+    fake_khz = 1000;
+    TEST_ASSERT(!ok);
+    TEST_ASSERT(!BENCH_RUN(NULLPTR, &cost, 10, &r));
+    return 0;
+}
+
+TEST_MAIN("BENCH")
+    RUN_TEST(test_umuldiv32_exact);
+    RUN_TEST(test_umuldiv32_saturates);
+    RUN_TEST(test_summarize_odd);
+    RUN_TEST(test_summarize_even);
+    RUN_TEST(test_summarize_empty);
+    RUN_TEST(test_run_subtracts_overhead);
+    RUN_TEST(test_run_median_of_ramp);
+    RUN_TEST(test_run_caps_runs);
+    RUN_TEST(test_run_without_tsc);
+TEST_RETURN
@@ -0,0 +1,347 @@
+/* Tests for the page frame buddy allocator (MEMORY/BUDDY/BUDDY.c).
+   The trace tests replay process spawn/exit and shared memory churn
+   against the pool, placed the way KREQUEST_USER_PAGES places runs, and
+   against the old first-fit bytemap scan. They check the pool fails no
+   more often than first fit and print how fragmented each ends up. */
+#include <MEMORY/BUDDY/BUDDY.h>
+#include "harness/test.h"
+
+#define BASE       0x10000              /* MEM_USER_SPACE_BASE / PAGE_SIZE */
+#define POOL       (1u << 16)           /* the 256 MiB user window */
+#define SMALL_POOL 4096
+
+static U8 meta[BUDDY_META_BYTES(POOL)];
+static U16 owner[POOL];                 /* 0 = free, else the allocation id + 1 */
+static U8 used[POOL];                   /* first-fit model */
+static BUDDY_POOL pool;
+
+static void fresh(U32 frames) {
+    BUDDY_INIT(&pool, BASE, frames, meta);
+    BUDDY_FREE(&pool, BASE, frames);
+}
+
+/* Every frame is free in exactly the pool's view and the counters add up */
+static int consistent(U32 frames) {
+    U32 free_frames = 0, blocks = 0;
+    for (U32 i = 0; i < frames; i++) {
+        BOOL is_free = BUDDY_IS_FREE(&pool, BASE + i);
+        if (is_free != (owner[i] == 0)) return 0;
+        free_frames += is_free;
+    }
+    for (U32 o = 0; o <= BUDDY_MAX_ORDER; o++) {
+        U32 n = 0;
+        for (U32 at = pool.head[o]; at != BUDDY_NONE; at = pool.next[at]) {
+            if (at & ((1u << o) - 1)) return 0;
+            n++;
+        }
+        if (n != pool.blocks[o]) return 0;
+        blocks += n;
+    }
+    return free_frames == pool.free_frames && (blocks > 0) == (free_frames > 0);
+}
+
+static void mark(U32 frame, U32 count, U16 id) {
+    for (U32 i = 0; i < count; i++) owner[frame - BASE + i] = id;
+}
+
+/* ============================================================
+   Basic operations
+   ============================================================ */
+static int test_free_all_is_one_block(void) {
+    fresh(SMALL_POOL);
+    TEST_ASSERT(pool.free_frames == SMALL_POOL);
+    TEST_ASSERT(pool.blocks[12] == 1);
+    TEST_ASSERT(BUDDY_LARGEST_FREE(&pool) == SMALL_POOL);
+    return 0;
+}
+
+static int test_alloc_splits_free_merges(void) {
+    fresh(SMALL_POOL);
+    U32 a = BUDDY_ALLOC(&pool, 1);
+    TEST_ASSERT(a == BASE);
+    for (U32 o = 0; o < 12; o++) TEST_ASSERT(pool.blocks[o] == 1);
+    TEST_ASSERT(pool.free_frames == SMALL_POOL - 1);
+    BUDDY_FREE(&pool, a, 1);
+    TEST_ASSERT(pool.blocks[12] == 1);
+    TEST_ASSERT(pool.free_frames == SMALL_POOL);
+    return 0;
+}
+
+static int test_odd_run_returns_tail(void) {
+    fresh(SMALL_POOL);
+    U32 a = BUDDY_ALLOC(&pool, 5);
+    TEST_ASSERT(a == BASE);
+    TEST_ASSERT(pool.free_frames == SMALL_POOL - 5);
+    TEST_ASSERT(!BUDDY_IS_FREE(&pool, BASE + 4));
+    TEST_ASSERT(BUDDY_IS_FREE(&pool, BASE + 5));
+    TEST_ASSERT(BUDDY_IS_FREE(&pool, BASE + 7));
+    U32 b = BUDDY_ALLOC(&pool, 3);
+    TEST_ASSERT(b >= BASE + 5);
+    BUDDY_FREE(&pool, a, 5);
+    BUDDY_FREE(&pool, b, 3);
+    TEST_ASSERT(pool.blocks[12] == 1);
+    return 0;
+}
+
+static int test_pool_not_power_of_two(void) {
+    BUDDY_INIT(&pool, BASE, 1000, meta);
+    BUDDY_FREE(&pool, BASE, 1000);
+    TEST_ASSERT(pool.free_frames == 1000);
+    TEST_ASSERT(BUDDY_LARGEST_FREE(&pool) == 512);
+    TEST_ASSERT(BUDDY_ALLOC(&pool, 600) == BUDDY_NONE);
+    U32 a = BUDDY_ALLOC(&pool, 512);
+    TEST_ASSERT(a == BASE);
+    TEST_ASSERT(pool.free_frames == 488);
+    TEST_ASSERT(BUDDY_ALLOC(&pool, 488) == BUDDY_NONE);     /* 256 + 128 + ... left, no 512 */
+    TEST_ASSERT(BUDDY_ALLOC(&pool, 256) == BASE + 512);
+    return 0;
+}
+
+static int test_full_pool_and_bounds(void) {
+    fresh(SMALL_POOL);
+    TEST_ASSERT(BUDDY_ALLOC(&pool, 0) == BUDDY_NONE);
+    TEST_ASSERT(BUDDY_ALLOC(&pool, SMALL_POOL) == BASE);
+    TEST_ASSERT(BUDDY_ALLOC(&pool, 1) == BUDDY_NONE);
+    TEST_ASSERT(BUDDY_LARGEST_FREE(&pool) == 0);
+    TEST_ASSERT(!BUDDY_IS_FREE(&pool, BASE - 1));
+    TEST_ASSERT(!BUDDY_IS_FREE(&pool, BASE + SMALL_POOL));
+    BUDDY_FREE(&pool, BASE + SMALL_POOL - 1, 2);    /* runs off the end: ignored */
+    TEST_ASSERT(pool.free_frames == 0);
+    return 0;
+}
+
+static int test_take_carves_range(void) {
+    fresh(SMALL_POOL);
+    TEST_ASSERT(BUDDY_TAKE(&pool, BASE + 3, 700));
+    TEST_ASSERT(pool.free_frames == SMALL_POOL - 700);
+    TEST_ASSERT(BUDDY_IS_FREE(&pool, BASE + 2));
+    TEST_ASSERT(!BUDDY_IS_FREE(&pool, BASE + 3));
+    TEST_ASSERT(!BUDDY_IS_FREE(&pool, BASE + 702));
+    TEST_ASSERT(BUDDY_IS_FREE(&pool, BASE + 703));
+    TEST_ASSERT(!BUDDY_TAKE(&pool, BASE + 100, 1));
+    BUDDY_FREE(&pool, BASE + 3, 700);
+    TEST_ASSERT(pool.blocks[12] == 1);
+    return 0;
+}
+
+static int test_find_run_best_fit(void) {
+    fresh(SMALL_POOL);
+    TEST_ASSERT(BUDDY_TAKE(&pool, BASE, SMALL_POOL));
+    BUDDY_FREE(&pool, BASE + 10, 300);      /* runs of 300, 100 and 150 */
+    BUDDY_FREE(&pool, BASE + 1000, 100);
+    BUDDY_FREE(&pool, BASE + 2000, 150);
+    TEST_ASSERT(BUDDY_FIND_RUN(&pool, 120) == BASE + 2000);
+    TEST_ASSERT(BUDDY_FIND_RUN(&pool, 100) == BASE + 1000);
+    TEST_ASSERT(BUDDY_FIND_RUN(&pool, 200) == BASE + 10);
+    TEST_ASSERT(BUDDY_FIND_RUN(&pool, 301) == BUDDY_NONE);
+    TEST_ASSERT(BUDDY_FIND_RUN(&pool, 0) == BUDDY_NONE);
+    /* not aligned and made of many blocks, still one run */
+    TEST_ASSERT(BUDDY_TAKE(&pool, BASE + 10, 300));
+    TEST_ASSERT(pool.free_frames == 250);
+    TEST_ASSERT(BUDDY_IS_FREE(&pool, BASE + 1000));
+    return 0;
+}
+
+/* E820 style: RAM in pieces with holes, handed over run by run */
+static int test_init_from_runs(void) {
+    BUDDY_INIT(&pool, BASE, SMALL_POOL, meta);
+    for (U32 i = 0; i < SMALL_POOL; i++) owner[i] = 1;
+    BUDDY_FREE(&pool, BASE + 1, 99);
+    BUDDY_FREE(&pool, BASE + 160, 3000);
+    BUDDY_FREE(&pool, BASE + 3200, 896);
+    mark(BASE + 1, 99, 0);
+    mark(BASE + 160, 3000, 0);
+    mark(BASE + 3200, 896, 0);
+    TEST_ASSERT(consistent(SMALL_POOL));
+    TEST_ASSERT(pool.free_frames == 99 + 3000 + 896);
+    TEST_ASSERT(BUDDY_LARGEST_FREE(&pool) == 1024);
+    return 0;
+}
+
+/* ============================================================
+   Trace replay
+   ============================================================ */
+#define MAX_LIVE 256
+
+typedef struct {
+    U32 frame;
+    U32 count;
+} RUN;
+
+static U32 seed;
+static U32 rnd(U32 n) {
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) % n;
+}
+
+/* REQUEST_PAGES_RAW before the pool: first fit from a moving index */
+static U32 ff_index;
+static U32 first_fit(U32 count) {
+    for (U32 pass = 0; pass < 2; pass++) {
+        U32 start = pass ? 0 : ff_index, end = pass ? ff_index : POOL, run = 0;
+        for (U32 i = start; i < end; i++) {
+            if (used[i]) {
+                run = 0;
+                continue;
+            }
+            if (++run == count) {
+                U32 first = i + 1 - count;
+                for (U32 j = first; j <= i; j++) used[j] = 1;
+                ff_index = (i + 1) % POOL;
+                return BASE + first;
+            }
+        }
+    }
+    return BUDDY_NONE;
+}
+
+static void ff_free(U32 frame, U32 count) {
+    for (U32 i = 0; i < count; i++) used[frame - BASE + i] = 0;
+    if (frame - BASE < ff_index) ff_index = frame - BASE;
+}
+
+static U32 scan_owner(U32 count) {
+    for (U32 i = 0, run = 0; i < POOL; i++) {
+        run = owner[i] ? 0 : run + 1;
+        if (run == count) return BASE + i + 1 - count;
+    }
+    return BUDDY_NONE;
+}
+
+/* KREQUEST_USER_PAGES: a power of two is one block, anything else is
+   packed into the best fitting run */
+static U32 user_pages(U32 count) {
+    U32 a = BUDDY_NONE;
+    if (!(count & (count - 1))) a = BUDDY_ALLOC(&pool, count);
+    if (a == BUDDY_NONE) {
+        a = BUDDY_FIND_RUN(&pool, count);
+        if (a != BUDDY_NONE && !BUDDY_TAKE(&pool, a, count)) return BUDDY_NONE;
+    }
+    return a;
+}
+
+/* 1 - largest free run / free frames, in percent */
+static U32 fragmentation(const U8 *map_used, const U16 *map_owner) {
+    U32 free_frames = 0, run = 0, largest = 0;
+    for (U32 i = 0; i < POOL; i++) {
+        BOOL busy = map_used ? map_used[i] : map_owner[i];
+        run = busy ? 0 : run + 1;
+        free_frames += !busy;
+        if (run > largest) largest = run;
+    }
+    return free_frames ? 100 - largest * 100 / free_frames : 0;
+}
+
+/* A process image as setup_user_process sizes it: binary, heap, 4 MB
+   stack, a 1024x768x4 framebuffer and a padding page */
+static U32 process_pages(void) {
+    return (1 + rnd(64)) + 4 + 1024 + 768 + 1;
+}
+
+static U32 shm_pages(void) {
+    return 1 + rnd(rnd(4) ? 16 : 256);
+}
+
+typedef U32 (*SIZE_FN)(void);
+
+typedef struct {
+    const CHAR *name;
+    U32 ops;
+    SIZE_FN sizes[2];
+} TRACE;
+
+static int replay(const TRACE *t) {
+    static RUN buddy_live[MAX_LIVE], ff_live[MAX_LIVE];
+    U32 live = 0, buddy_fail = 0, ff_fail = 0, peak = 0;
+    U32 samples = 0, buddy_frag = 0, ff_frag = 0;
+
+    fresh(POOL);
+    for (U32 i = 0; i < POOL; i++) { owner[i] = 0; used[i] = 0; }
+    ff_index = 0;
+    seed = 0xA7051u;
+
+    for (U32 op = 0; op < t->ops; op++) {
+        if (live && (live == MAX_LIVE || rnd(100) < 45)) {
+            U32 k = rnd(live);
+            BUDDY_FREE(&pool, buddy_live[k].frame, buddy_live[k].count);
+            mark(buddy_live[k].frame, buddy_live[k].count, 0);
+            ff_free(ff_live[k].frame, ff_live[k].count);
+            buddy_live[k] = buddy_live[--live];
+            ff_live[k] = ff_live[live];
+            continue;
+        }
+        U32 count = t->sizes[rnd(2)]();
+        U32 a = user_pages(count);
+        U32 f = first_fit(count);
+        /* the run search sees every free frame, a scan would not do better */
+        if (a == BUDDY_NONE) TEST_ASSERT(scan_owner(count) == BUDDY_NONE);
+        if (a == BUDDY_NONE) buddy_fail++;
+        if (f == BUDDY_NONE) ff_fail++;
+        /* Keep both with the same runs live, or the one that placed more
+           would be replaying a fuller pool from here on */
+        if (a == BUDDY_NONE || f == BUDDY_NONE) {
+            if (a != BUDDY_NONE) BUDDY_FREE(&pool, a, count);
+            if (f != BUDDY_NONE) ff_free(f, count);
+            continue;
+        }
+        for (U32 i = 0; i < count; i++) TEST_ASSERT(owner[a - BASE + i] == 0);
+        mark(a, count, (U16)(live + 1));
+        buddy_live[live] = (RUN){ a, count };
+        ff_live[live] = (RUN){ f, count };
+        live++;
+        if (POOL - pool.free_frames > peak) peak = POOL - pool.free_frames;
+        if (op % 64 == 0) {
+            TEST_ASSERT(consistent(POOL));
+            buddy_frag += fragmentation(NULLPTR, owner);
+            ff_frag += fragmentation(used, NULLPTR);
+            samples++;
+        }
+    }
+    TEST_ASSERT(consistent(POOL));
+
+    printf("\n    %-6s %5u ops, %3u live, peak %5u frames\n"
+           "      failed: buddy %u, first fit %u\n"
+           "      fragmentation on average: buddy %u%%, first fit %u%%\n  %-45s ",
+           t->name, t->ops, live, peak, buddy_fail, ff_fail,
+           buddy_frag / samples, ff_frag / samples, "");
+
+    TEST_ASSERT(buddy_fail <= ff_fail);
+
+    while (live) {
+        live--;
+        BUDDY_FREE(&pool, buddy_live[live].frame, buddy_live[live].count);
+        mark(buddy_live[live].frame, buddy_live[live].count, 0);
+    }
+    TEST_ASSERT(pool.free_frames == POOL);
+    TEST_ASSERT(pool.blocks[BUDDY_MAX_ORDER] == 1);
+    return 0;
+}
+
+static int test_trace_processes(void) {
+    TRACE t = { "spawn", 4000, { process_pages, process_pages } };
+    return replay(&t);
+}
+
+static int test_trace_mixed(void) {
+    TRACE t = { "mixed", 8000, { process_pages, shm_pages } };
+    return replay(&t);
+}
+
+static int test_trace_small(void) {
+    TRACE t = { "shm", 8000, { shm_pages, shm_pages } };
+    return replay(&t);
+}
+
+TEST_MAIN("BUDDY")
+    RUN_TEST(test_free_all_is_one_block);
+    RUN_TEST(test_alloc_splits_free_merges);
+    RUN_TEST(test_odd_run_returns_tail);
+    RUN_TEST(test_pool_not_power_of_two);
+    RUN_TEST(test_full_pool_and_bounds);
+    RUN_TEST(test_take_carves_range);
+    RUN_TEST(test_find_run_best_fit);
+    RUN_TEST(test_init_from_runs);
+    RUN_TEST(test_trace_processes);
+    RUN_TEST(test_trace_mixed);
+    RUN_TEST(test_trace_small);
+TEST_RETURN
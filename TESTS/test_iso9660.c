@@ -0,0 +1,281 @@
+#include <FS/ISO9660/ISO9660.h>
+#include <DRIVERS/ATAPI/ATAPI.h>
+#include <MEMORY/HEAP/KHEAP.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+#include "harness/test.h"
+
+extern void *malloc(unsigned long size);
+extern void  free(void *ptr);
+extern void *realloc(void *ptr, unsigned long size);
+
+/* ============================================================
+   Fake CD-ROM: an in-memory image, with read accounting.
+   The image is built here rather than with xorriso/genisoimage
+   so the test runs without either tool installed.
+   ============================================================ */
+#define SECTOR        ISO9660_SECTOR_SIZE
+#define IMAGE_SECTORS 40
+#define BIN_FILES     60
+
+static U8  image[IMAGE_SECTORS * SECTOR];
+static U32 read_calls;
+static U32 sectors_read;
+
+VOIDPTR KMALLOC(U32 size) { return malloc(size); }
+VOID KFREE(VOIDPTR ptr) { free(ptr); }
+VOIDPTR KREALLOC(VOIDPTR addr, U32 size) { return realloc(addr, size); }
+
+U32 INITIALIZE_ATAPI() { return ATAPI_SECONDARY_MASTER; }
+U32 GET_ATAPI_INFO() { return ATAPI_SECONDARY_MASTER; }
+U32 ATAPI_CALC_SECTORS(U32 len) { return (len + ATAPI_SECTOR_SIZE - 1) / ATAPI_SECTOR_SIZE; }
+
+U32 READ_CDROM(U32 where, U32 lba, U32 sectors, U8 *buf) {
+    if (where == ATA_FAILED || lba + sectors > IMAGE_SECTORS) return ATA_FAILED;
+    read_calls++;
+    sectors_read += sectors;
+    MEMCPY(buf, image + lba * SECTOR, sectors * SECTOR);
+    return ATA_SUCCESS;
+}
+
+static VOID reset_counts(VOID) {
+    read_calls = 0;
+    sectors_read = 0;
+}
+
+/* Directory writer: records never straddle a sector */
+typedef struct {
+    U32 lba;
+    U32 pos;
+} DIR_WRITER;
+
+static VOID put_record(DIR_WRITER *w, U32 lba, U32 size, BOOL dir, const CHAR *name, U32 name_len) {
+    U32 len = 33 + name_len + ((33 + name_len) & 1);
+    if (w->pos % SECTOR + len > SECTOR) w->pos = (w->pos / SECTOR + 1) * SECTOR;
+    IsoDirectoryRecord *r = (IsoDirectoryRecord *)(image + w->lba * SECTOR + w->pos);
+    r->length = (U8)len;
+    r->extentLocationLE_LBA = lba;
+    r->extentLengthLE = size;
+    r->fileFlags = dir ? ISO9660_FILE_FLAG_DIRECTORY : 0;
+    r->fileNameLength = (U8)name_len;
+    MEMCPY(r->fileIdentifier, name, name_len);
+    w->pos += len;
+}
+
+static VOID put_dots(DIR_WRITER *w, U32 self_size, U32 parent_lba, U32 parent_size) {
+    put_record(w, w->lba, self_size, TRUE, "\0", 1);
+    put_record(w, parent_lba, parent_size, TRUE, "\1", 1);
+}
+
+static VOID put_file(DIR_WRITER *w, U32 lba, U32 size, const CHAR *name) {
+    put_record(w, lba, size, FALSE, name, STRLEN((PU8)name));
+}
+
+static VOID put_dir(DIR_WRITER *w, U32 lba, U32 size, const CHAR *name) {
+    put_record(w, lba, size, TRUE, name, STRLEN((PU8)name));
+}
+
+static U32 put_path_entry(U32 pos, const CHAR *name, U32 len, U32 lba, U16 parent) {
+    PathTableEntry *e = (PathTableEntry *)(image + 18 * SECTOR + pos);
+    e->nameLength = (U8)len;
+    e->lbaLocation = lba;
+    e->parentDirNum = parent;
+    MEMCPY(e->name, name, len);
+    return pos + 8 + len + (len & 1);
+}
+
+/*
+ *  /README.TXT;1
+ *  /ATOS/KERNEL.BIN;1
+ *  /ATOS/BIN/F00.BIN;1 .. F59.BIN;1     (two-sector extent)
+ *  /HOME/SRC/VBR.BIN;1
+ */
+static VOID build_image(VOID) {
+    MEMZERO(image, sizeof(image));
+
+    PrimaryVolumeDescriptor *pvd = (PrimaryVolumeDescriptor *)(image + 16 * SECTOR);
+    pvd->TypeCode = 1;
+    MEMCPY(pvd->standardIdentifier, "CD001", 5);
+    pvd->version = 1;
+    pvd->volumeSpaceSizeLE = IMAGE_SECTORS;
+    pvd->logicalBlockSizeLE = SECTOR;
+    pvd->rootDirectoryRecord.length = 34;
+    pvd->rootDirectoryRecord.extentLocationLE_LBA = 20;
+    pvd->rootDirectoryRecord.extentLengthLE = SECTOR;
+    pvd->rootDirectoryRecord.fileFlags = ISO9660_FILE_FLAG_DIRECTORY;
+    pvd->rootDirectoryRecord.fileNameLength = 1;
+    image[17 * SECTOR] = 0xFF;
+    MEMCPY(image + 17 * SECTOR + 1, "CD001", 5);
+
+    /* Path table: root=1, ATOS=2, HOME=3, BIN=4, SRC=5 */
+    U32 pos = put_path_entry(0, "\0", 1, 20, 1);
+    pos = put_path_entry(pos, "ATOS", 4, 21, 1);
+    pos = put_path_entry(pos, "HOME", 4, 24, 1);
+    pos = put_path_entry(pos, "BIN", 3, 22, 2);
+    pos = put_path_entry(pos, "SRC", 3, 25, 3);
+    pvd->pathTableSizeLE = pos;
+    pvd->pathTableLocationLE = 18;
+
+    DIR_WRITER root = { 20, 0 }, atos = { 21, 0 }, bin = { 22, 0 }, home = { 24, 0 }, src = { 25, 0 };
+    put_dots(&root, SECTOR, 20, SECTOR);
+    put_dir(&root, 21, SECTOR, "ATOS");
+    put_dir(&root, 24, SECTOR, "HOME");
+    put_file(&root, 30, 5, "README.TXT;1");
+
+    put_dots(&atos, SECTOR, 20, SECTOR);
+    put_dir(&atos, 22, 2 * SECTOR, "BIN");
+    put_file(&atos, 31, 1000, "KERNEL.BIN;1");
+
+    put_dots(&bin, 2 * SECTOR, 21, SECTOR);
+    for (U32 i = 0; i < BIN_FILES; i++) {
+        CHAR name[16] = "F00.BIN;1";
+        name[1] = '0' + i / 10;
+        name[2] = '0' + i % 10;
+        put_file(&bin, 32 + i % 8, 100 + i, name);
+    }
+
+    put_dots(&home, SECTOR, 20, SECTOR);
+    put_dir(&home, 25, SECTOR, "SRC");
+
+    put_dots(&src, SECTOR, 24, SECTOR);
+    put_file(&src, 39, 512, "VBR.BIN;1");
+}
+
+static IsoDirectoryRecord root_record(VOID) {
+    return ((PrimaryVolumeDescriptor *)(image + 16 * SECTOR))->rootDirectoryRecord;
+}
+
+/* Looks up `path` (normalised form) from the image root */
+static BOOL find(const CHAR *path, IsoDirectoryRecord *out) {
+    IsoDirectoryRecord root = root_record();
+    return ISO9660_READ_DIRECTORY_RECORD((CHAR *)path, &root, out);
+}
+
+/* ============================================================
+   Tests
+   ============================================================ */
+
+/* Before any PVD is loaded there is no path table: directories are walked
+   through the extent cache */
+static int test_walk_without_path_table(void) {
+    IsoDirectoryRecord rec;
+    reset_counts();
+    TEST_ASSERT(find("ATOS/BIN/F37.BIN;1", &rec));
+    TEST_ASSERT(rec.extentLocationLE_LBA == 32 + 37 % 8 && rec.extentLengthLE == 137);
+    /* root + ATOS + both BIN sectors */
+    TEST_ASSERT(sectors_read == 4);
+
+    reset_counts();
+    TEST_ASSERT(find("ATOS/BIN/F59.BIN;1", &rec) && rec.extentLengthLE == 159);
+    TEST_ASSERT(find("ATOS/BIN/F00.BIN;1", &rec) && rec.extentLengthLE == 100);
+    TEST_ASSERT(find("ATOS/KERNEL.BIN;1", &rec) && rec.extentLengthLE == 1000);
+    TEST_ASSERT(find("/README.TXT;1", &rec) && rec.extentLocationLE_LBA == 30);
+    TEST_ASSERT(sectors_read == 0);
+
+    /* The second BIN sector was parsed past the padding */
+    TEST_ASSERT(!find("ATOS/BIN/F60.BIN;1", &rec));
+    TEST_ASSERT(!find("ATOS/F00.BIN;1", &rec));
+    /* A file is not a directory */
+    TEST_ASSERT(!find("README.TXT;1/X;1", &rec));
+    TEST_ASSERT(sectors_read == 0);
+    return 0;
+}
+
+static int test_path_table_lookup(void) {
+    ISO9660_CACHE_FLUSH();
+    reset_counts();
+    IsoDirectoryRecord *rec = ISO9660_FILERECORD_TO_MEMORY((CHAR *)"home/src/vbr.bin");
+    TEST_ASSERT(rec != NULLPTR);
+    TEST_ASSERT(rec->extentLocationLE_LBA == 39 && rec->extentLengthLE == 512);
+    ISO9660_FREE_MEMORY(rec);
+    /* PVD + path table + SRC: HOME is never read */
+    TEST_ASSERT(read_calls == 3 && sectors_read == 3);
+
+    reset_counts();
+    rec = ISO9660_FILERECORD_TO_MEMORY((CHAR *)"ATOS/BIN/F12.BIN");
+    TEST_ASSERT(rec != NULLPTR && rec->extentLengthLE == 112);
+    ISO9660_FREE_MEMORY(rec);
+    /* BIN only, sized from its "." record: first sector, then the rest */
+    TEST_ASSERT(read_calls == 2 && sectors_read == 2);
+
+    reset_counts();
+    for (U32 i = 0; i < 100; i++) {
+        rec = ISO9660_FILERECORD_TO_MEMORY((CHAR *)"ATOS/BIN/F45.BIN");
+        TEST_ASSERT(rec != NULLPTR && rec->extentLengthLE == 145);
+        ISO9660_FREE_MEMORY(rec);
+    }
+    TEST_ASSERT(read_calls == 0);
+
+    /* Unknown directories fail in the path table without any I/O */
+    TEST_ASSERT(ISO9660_FILERECORD_TO_MEMORY((CHAR *)"NOPE/F00.BIN") == NULLPTR);
+    TEST_ASSERT(ISO9660_FILERECORD_TO_MEMORY((CHAR *)"ATOS/SRC/VBR.BIN") == NULLPTR);
+    TEST_ASSERT(read_calls == 0);
+    return 0;
+}
+
+static int test_directory_records(void) {
+    IsoDirectoryRecord rec;
+    IsoDirectoryRecord root = root_record();
+
+    /* NORMALIZE appends ";1" to directories too */
+    IsoDirectoryRecord *dir = ISO9660_FILERECORD_TO_MEMORY((CHAR *)"HOME/SRC");
+    TEST_ASSERT(dir != NULLPTR && ISO9660_GET_TYPE(dir) == ISO9660_TYPE_DIRECTORY);
+    TEST_ASSERT(dir->extentLocationLE_LBA == 25);
+    ISO9660_FREE_MEMORY(dir);
+
+    TEST_ASSERT(ISO9660_PATH_TABLE_SEARCH((CHAR *)"ATOS/BIN", &rec, &root));
+    TEST_ASSERT(rec.extentLocationLE_LBA == 22 && rec.extentLengthLE == 2 * SECTOR);
+    TEST_ASSERT(ISO9660_PATH_TABLE_SEARCH((CHAR *)"HOME;1", &rec, &root) && rec.extentLocationLE_LBA == 24);
+    TEST_ASSERT(!ISO9660_PATH_TABLE_SEARCH((CHAR *)"HOME/BIN", &rec, &root));
+    return 0;
+}
+
+static int test_dir_contents_cached(void) {
+    IsoDirectoryRecord bin, rec;
+    U32 count = 0;
+    U8 ok = FALSE;
+
+    ISO9660_CACHE_FLUSH();
+    TEST_ASSERT(find("ATOS/BIN;1", &bin));
+    TEST_ASSERT(find("ATOS/BIN/F00.BIN;1", &rec));
+
+    reset_counts();
+    IsoDirectoryRecord **list = ISO9660_GET_DIR_CONTENTS(&bin, FALSE, &count, &ok);
+    TEST_ASSERT(ok && count == BIN_FILES);
+    TEST_ASSERT(list[0]->fileNameLength == 9 && MEMCMP(list[0]->fileIdentifier, "F00.BIN;1", 9) == 0);
+    TEST_ASSERT(MEMCMP(list[BIN_FILES - 1]->fileIdentifier, "F59.BIN;1", 9) == 0);
+    ISO9660_FREE_LIST(list, count);
+    /* Same extent the lookup cached */
+    TEST_ASSERT(read_calls == 0);
+    return 0;
+}
+
+static int test_cache_eviction(void) {
+    IsoDirectoryRecord rec;
+    IsoDirectoryRecord root = root_record();
+
+    TEST_ASSERT(find("README.TXT;1", &rec));
+    /* List a full cache's worth of other (empty, all-zero) extents */
+    for (U32 lba = 1; lba <= ISO9660_DIR_CACHE_SLOTS; lba++) {
+        IsoDirectoryRecord other = root;
+        U32 count;
+        U8 ok;
+        other.extentLocationLE_LBA = lba;
+        TEST_ASSERT(ISO9660_GET_DIR_CONTENTS(&other, FALSE, &count, &ok) == NULLPTR && ok && count == 0);
+    }
+    /* The root was least recently used and had to be read again */
+    reset_counts();
+    TEST_ASSERT(find("README.TXT;1", &rec) && rec.extentLocationLE_LBA == 30);
+    TEST_ASSERT(sectors_read == 1);
+    TEST_ASSERT(find("README.TXT;1", &rec) && sectors_read == 1);
+    return 0;
+}
+
+TEST_MAIN("ISO9660")
+    build_image();
+    RUN_TEST(test_walk_without_path_table);
+    RUN_TEST(test_path_table_lookup);
+    RUN_TEST(test_directory_records);
+    RUN_TEST(test_dir_contents_cached);
+    RUN_TEST(test_cache_eviction);
+TEST_RETURN
@@ -0,0 +1,167 @@
+#include "harness/test.h"
+#include <LIBRARIES/ATHASH/SHA1.h>
+#include <LIBRARIES/ATHASH/SHA256.h>
+#include <STD/MEM.h>
+
+static CONST CHAR MSG448[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+static CONST CHAR MSG896[] = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                             "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+
+static U32 cstr_len(CONST CHAR *s) {
+    U32 n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+static BOOL hex_eq(CONST U8 *digest, U32 len, CONST CHAR *hex) {
+    static CONST CHAR digits[] = "0123456789abcdef";
+    for (U32 i = 0; i < len; i++) {
+        if (hex[i*2] != digits[digest[i] >> 4] || hex[i*2 + 1] != digits[digest[i] & 0xF])
+            return FALSE;
+    }
+    return hex[len * 2] == '\0';
+}
+
+static BOOL sha1_is(CONST U8 *data, U32 len, CONST CHAR *hex) {
+    U8 d[SHA1_DIGEST_SIZE];
+    SHA1_HASH(data, len, d);
+    return hex_eq(d, SHA1_DIGEST_SIZE, hex);
+}
+
+static BOOL sha256_is(CONST U8 *data, U32 len, CONST CHAR *hex) {
+    U8 d[SHA256_DIGEST_SIZE];
+    SHA256_HASH(data, len, d);
+    return hex_eq(d, SHA256_DIGEST_SIZE, hex);
+}
+
+/* Lengths around the 56-byte padding boundary */
+static void fill_pattern(PU8 buf, U32 len) {
+    for (U32 i = 0; i < len; i++) buf[i] = (U8)(i * 7 + 1);
+}
+
+/* ============================================================
+   SHA-1
+   ============================================================ */
+static int test_sha1_nist_vectors(void) {
+    TEST_ASSERT(sha1_is((CONST U8 *)"abc", 3, "a9993e364706816aba3e25717850c26c9cd0d89d"));
+    TEST_ASSERT(sha1_is((CONST U8 *)"", 0, "da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+    TEST_ASSERT(sha1_is((CONST U8 *)MSG448, cstr_len(MSG448), "84983e441c3bd26ebaae4aa1f95129e5e54670f1"));
+    TEST_ASSERT(sha1_is((CONST U8 *)MSG896, cstr_len(MSG896), "a49b2446a02c645bf419f995b67091253a04a259"));
+    return 0;
+}
+
+static int test_sha1_million_a(void) {
+    U8 chunk[1000];
+    MEMSET(chunk, 'a', sizeof(chunk));
+    SHA1_CTX ctx;
+    U8 d[SHA1_DIGEST_SIZE];
+    SHA1_INIT(&ctx);
+    for (U32 i = 0; i < 1000; i++) SHA1_UPDATE(&ctx, chunk, sizeof(chunk));
+    SHA1_FINAL(d, &ctx);
+    TEST_ASSERT(hex_eq(d, SHA1_DIGEST_SIZE, "34aa973cd4c4daa4f61eeb2bdbad27316534016f"));
+    return 0;
+}
+
+static int test_sha1_padding_boundaries(void) {
+    U8 buf[119];
+    fill_pattern(buf, sizeof(buf));
+    TEST_ASSERT(sha1_is(buf, 55, "04bb34aef4880b625e6b1564a014abd25fc02bfe"));
+    TEST_ASSERT(sha1_is(buf, 56, "83b9fcb6d3e3b20f376ab989a1b6353bcc6c0f44"));
+    TEST_ASSERT(sha1_is(buf, 63, "ab15090e8dbe512f3733350f9623ab11f9b5165b"));
+    TEST_ASSERT(sha1_is(buf, 64, "54305ee7e4c7bc5a96afc6d1994fc52d9bcb665f"));
+    TEST_ASSERT(sha1_is(buf, 65, "5985422a25357371ebd2a7f6ecd7eebed43db42c"));
+    TEST_ASSERT(sha1_is(buf, 119, "6839d6c27f22ed884ac43ae6bd3bfcee9e04b938"));
+    return 0;
+}
+
+/* Two updates split at every offset, plus byte-at-a-time, match one shot */
+static int test_sha1_streaming_splits(void) {
+    U8 buf[200], ref[SHA1_DIGEST_SIZE], d[SHA1_DIGEST_SIZE];
+    fill_pattern(buf, sizeof(buf));
+    SHA1_HASH(buf, sizeof(buf), ref);
+    for (U32 split = 0; split <= sizeof(buf); split++) {
+        SHA1_CTX ctx;
+        SHA1_INIT(&ctx);
+        SHA1_UPDATE(&ctx, buf, split);
+        SHA1_UPDATE(&ctx, buf + split, sizeof(buf) - split);
+        SHA1_FINAL(d, &ctx);
+        TEST_ASSERT(MEMCMP(d, ref, SHA1_DIGEST_SIZE) == 0);
+    }
+    SHA1_CTX ctx;
+    SHA1_INIT(&ctx);
+    for (U32 i = 0; i < sizeof(buf); i++) SHA1_UPDATE(&ctx, &buf[i], 1);
+    SHA1_FINAL(d, &ctx);
+    TEST_ASSERT(MEMCMP(d, ref, SHA1_DIGEST_SIZE) == 0);
+    return 0;
+}
+
+/* ============================================================
+   SHA-256
+   ============================================================ */
+static int test_sha256_nist_vectors(void) {
+    TEST_ASSERT(sha256_is((CONST U8 *)"abc", 3,
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    TEST_ASSERT(sha256_is((CONST U8 *)"", 0,
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    TEST_ASSERT(sha256_is((CONST U8 *)MSG448, cstr_len(MSG448),
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+    TEST_ASSERT(sha256_is((CONST U8 *)MSG896, cstr_len(MSG896),
+        "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1"));
+    return 0;
+}
+
+static int test_sha256_million_a(void) {
+    U8 chunk[1000];
+    MEMSET(chunk, 'a', sizeof(chunk));
+    SHA256_CTX ctx;
+    U8 d[SHA256_DIGEST_SIZE];
+    SHA256_INIT(&ctx);
+    for (U32 i = 0; i < 1000; i++) SHA256_UPDATE(&ctx, chunk, sizeof(chunk));
+    SHA256_FINAL(d, &ctx);
+    TEST_ASSERT(hex_eq(d, SHA256_DIGEST_SIZE,
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+    return 0;
+}
+
+static int test_sha256_padding_boundaries(void) {
+    U8 buf[119];
+    fill_pattern(buf, sizeof(buf));
+    TEST_ASSERT(sha256_is(buf, 55, "16fa57a0a3423a715d594516339f36189d6b5f93754a9714fef202616a9fabfe"));
+    TEST_ASSERT(sha256_is(buf, 56, "c37b44e5f1b18554b36966f4f8e08bfbf3164c4b6c10374d12d89850892073c5"));
+    TEST_ASSERT(sha256_is(buf, 63, "bbba992d2c85af960fb2987a1fd05e0aa82a3db3c740dd8982a9e273b75e36a3"));
+    TEST_ASSERT(sha256_is(buf, 64, "66bd4633ed6f71c4ecfa4763bf7ba1c8ec7612de9aa6c0578a7b675207c71e0b"));
+    TEST_ASSERT(sha256_is(buf, 65, "9f7dc47107b750a1f3d35db5d9547f24ef40da5b731b9540d4f43710a154f6c9"));
+    TEST_ASSERT(sha256_is(buf, 119, "a3ed307b730fa77c07531300c6e4a282330011d4d4caf6bb7b63ae05950f4b66"));
+    return 0;
+}
+
+static int test_sha256_streaming_splits(void) {
+    U8 buf[200], ref[SHA256_DIGEST_SIZE], d[SHA256_DIGEST_SIZE];
+    fill_pattern(buf, sizeof(buf));
+    SHA256_HASH(buf, sizeof(buf), ref);
+    for (U32 split = 0; split <= sizeof(buf); split++) {
+        SHA256_CTX ctx;
+        SHA256_INIT(&ctx);
+        SHA256_UPDATE(&ctx, buf, split);
+        SHA256_UPDATE(&ctx, buf + split, sizeof(buf) - split);
+        SHA256_FINAL(d, &ctx);
+        TEST_ASSERT(MEMCMP(d, ref, SHA256_DIGEST_SIZE) == 0);
+    }
+    SHA256_CTX ctx;
+    SHA256_INIT(&ctx);
+    for (U32 i = 0; i < sizeof(buf); i++) SHA256_UPDATE(&ctx, &buf[i], 1);
+    SHA256_FINAL(d, &ctx);
+    TEST_ASSERT(MEMCMP(d, ref, SHA256_DIGEST_SIZE) == 0);
+    return 0;
+}
+
+TEST_MAIN("SHA")
+    RUN_TEST(test_sha1_nist_vectors);
+    RUN_TEST(test_sha1_million_a);
+    RUN_TEST(test_sha1_padding_boundaries);
+    RUN_TEST(test_sha1_streaming_splits);
+    RUN_TEST(test_sha256_nist_vectors);
+    RUN_TEST(test_sha256_million_a);
+    RUN_TEST(test_sha256_padding_boundaries);
+    RUN_TEST(test_sha256_streaming_splits);
+TEST_RETURN
@@ -0,0 +1,284 @@
+#include <PROGRAMS/SYS_PROGS/JOT/TEXTBUF.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+#include "harness/test.h"
+
+/* ============================================================
+   Helpers
+   ============================================================ */
+static TEXTBUF *make(const CHAR *text) {
+    U32 len = STRLEN((PU8)text);
+    PU8 data = NULLPTR;
+    if (len) {
+        data = MAlloc(len);
+        MEMCPY(data, (PU8)text, len);
+    }
+    return TEXTBUF_CREATE(data, len);
+}
+
+static U8 got[1 << 16];
+
+/* Whole text equals `want` */
+static BOOL is(TEXTBUF *tb, const CHAR *want) {
+    U32 len = STRLEN((PU8)want);
+    if (TEXTBUF_LENGTH(tb) != len) return FALSE;
+    if (TEXTBUF_READ(tb, 0, got, sizeof(got)) != len) return FALSE;
+    return MEMCMP(got, (PU8)want, len) == 0;
+}
+
+static BOOL ins(TEXTBUF *tb, U32 off, const CHAR *s) {
+    return TEXTBUF_INSERT(tb, off, (PU8)s, STRLEN((PU8)s));
+}
+
+/* ============================================================
+   Lines
+   ============================================================ */
+static int test_empty(void) {
+    TEXTBUF *tb = TEXTBUF_CREATE(NULLPTR, 0);
+    TEST_ASSERT(tb);
+    TEST_ASSERT(TEXTBUF_LENGTH(tb) == 0);
+    TEST_ASSERT(TEXTBUF_LINE_COUNT(tb) == 1);
+    TEST_ASSERT(TEXTBUF_LINE_LENGTH(tb, 0) == 0);
+    TEST_ASSERT(TEXTBUF_LINE_START(tb, 3) == 0);
+    TEST_ASSERT(!TEXTBUF_UNDO(tb, NULLPTR));
+    TEST_ASSERT(ins(tb, 0, "x"));
+    TEST_ASSERT(is(tb, "x"));
+    TEST_ASSERT(!ins(tb, 5, "y"));
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+static int test_line_queries(void) {
+    TEXTBUF *tb = make("one\n\nthree\nfour\n");
+    TEST_ASSERT(TEXTBUF_LINE_COUNT(tb) == 5);
+    TEST_ASSERT(TEXTBUF_LINE_START(tb, 0) == 0);
+    TEST_ASSERT(TEXTBUF_LINE_START(tb, 1) == 4);
+    TEST_ASSERT(TEXTBUF_LINE_START(tb, 2) == 5);
+    TEST_ASSERT(TEXTBUF_LINE_START(tb, 3) == 11);
+    TEST_ASSERT(TEXTBUF_LINE_START(tb, 4) == 16);
+    TEST_ASSERT(TEXTBUF_LINE_LENGTH(tb, 0) == 3);
+    TEST_ASSERT(TEXTBUF_LINE_LENGTH(tb, 1) == 0);
+    TEST_ASSERT(TEXTBUF_LINE_LENGTH(tb, 2) == 5);
+    TEST_ASSERT(TEXTBUF_LINE_LENGTH(tb, 4) == 0);
+    TEST_ASSERT(TEXTBUF_LINE_OF(tb, 0) == 0);
+    TEST_ASSERT(TEXTBUF_LINE_OF(tb, 3) == 0);
+    TEST_ASSERT(TEXTBUF_LINE_OF(tb, 4) == 1);
+    TEST_ASSERT(TEXTBUF_LINE_OF(tb, 16) == 4);
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+/* ============================================================
+   Edits
+   ============================================================ */
+static int test_insert_delete(void) {
+    TEXTBUF *tb = make("hello world");
+    TEST_ASSERT(ins(tb, 5, ","));
+    TEST_ASSERT(ins(tb, 0, ">> "));
+    TEST_ASSERT(ins(tb, TEXTBUF_LENGTH(tb), "!\n"));
+    TEST_ASSERT(is(tb, ">> hello, world!\n"));
+    TEST_ASSERT(TEXTBUF_LINE_COUNT(tb) == 2);
+
+    /* Spans the original text and two inserts */
+    TEST_ASSERT(TEXTBUF_DELETE(tb, 1, 8));
+    TEST_ASSERT(is(tb, "> world!\n"));
+    TEST_ASSERT(TEXTBUF_DELETE(tb, 8, 100));
+    TEST_ASSERT(is(tb, "> world!"));
+    TEST_ASSERT(TEXTBUF_LINE_COUNT(tb) == 1);
+    TEST_ASSERT(TEXTBUF_DELETE(tb, 50, 1));
+    TEXTBUF_DELETE(tb, 0, TEXTBUF_LENGTH(tb));
+    TEST_ASSERT(is(tb, ""));
+    TEST_ASSERT(TEXTBUF_PIECE_COUNT(tb) == 0);
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+static int test_read_window(void) {
+    TEXTBUF *tb = make("abcdef");
+    ins(tb, 3, "XYZ");
+    U8 buf[8];
+    TEST_ASSERT(TEXTBUF_READ(tb, 2, buf, 4) == 4);
+    TEST_ASSERT(MEMCMP(buf, "cXYZ", 4) == 0);
+    TEST_ASSERT(TEXTBUF_READ(tb, 7, buf, 8) == 2);
+    TEST_ASSERT(MEMCMP(buf, "ef", 2) == 0);
+    TEST_ASSERT(TEXTBUF_READ(tb, 9, buf, 8) == 0);
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+/* Typing one character at a time must not add a piece per keystroke */
+static int test_typing_coalesces(void) {
+    TEXTBUF *tb = make("ab");
+    const CHAR *word = "typing\nmore";
+    for (U32 i = 0; word[i]; i++) {
+        TEST_ASSERT(TEXTBUF_INSERT(tb, 1 + i, (PU8)&word[i], 1));
+    }
+    TEST_ASSERT(is(tb, "atyping\nmoreb"));
+    TEST_ASSERT(TEXTBUF_PIECE_COUNT(tb) == 3);
+    TEST_ASSERT(TEXTBUF_LINE_START(tb, 1) == 8);
+
+    /* One record: a single undo step removes the whole run */
+    TEST_ASSERT(TEXTBUF_UNDO(tb, NULLPTR));
+    TEST_ASSERT(is(tb, "ab"));
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+/* ============================================================
+   Undo / redo
+   ============================================================ */
+static int test_undo_groups(void) {
+    TEXTBUF *tb = make("line1\nline2\n");
+    U32 cursor = 0;
+
+    ins(tb, 5, "A");
+    ins(tb, 6, "B");
+    TEXTBUF_COMMIT(tb);
+    TEXTBUF_DELETE(tb, 0, 8);           /* "line1AB\n" */
+    TEXTBUF_COMMIT(tb);
+    ins(tb, 0, "x");
+    TEXTBUF_DELETE(tb, 1, 1);
+    TEST_ASSERT(is(tb, "xine2\n"));
+
+    TEST_ASSERT(TEXTBUF_UNDO(tb, &cursor));
+    TEST_ASSERT(is(tb, "line2\n"));
+    TEST_ASSERT(cursor == 0);
+    TEST_ASSERT(TEXTBUF_UNDO(tb, &cursor));
+    TEST_ASSERT(is(tb, "line1AB\nline2\n"));
+    TEST_ASSERT(cursor == 8);
+    TEST_ASSERT(TEXTBUF_UNDO(tb, &cursor));
+    TEST_ASSERT(is(tb, "line1\nline2\n"));
+    TEST_ASSERT(cursor == 5);
+    TEST_ASSERT(!TEXTBUF_UNDO(tb, &cursor));
+
+    TEST_ASSERT(TEXTBUF_REDO(tb, &cursor));
+    TEST_ASSERT(is(tb, "line1AB\nline2\n"));
+    TEST_ASSERT(cursor == 7);
+    TEST_ASSERT(TEXTBUF_REDO(tb, &cursor));
+    TEST_ASSERT(is(tb, "line2\n"));
+    TEST_ASSERT(TEXTBUF_REDO(tb, &cursor));
+    TEST_ASSERT(is(tb, "xine2\n"));
+    TEST_ASSERT(!TEXTBUF_REDO(tb, &cursor));
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+static int test_edit_drops_redo(void) {
+    TEXTBUF *tb = make("abc");
+    TEXTBUF_DELETE(tb, 0, 1);
+    TEXTBUF_COMMIT(tb);
+    TEXTBUF_DELETE(tb, 0, 1);
+    TEST_ASSERT(TEXTBUF_UNDO(tb, NULLPTR));
+    TEST_ASSERT(is(tb, "bc"));
+    ins(tb, 2, "d");
+    TEST_ASSERT(!TEXTBUF_REDO(tb, NULLPTR));
+    TEST_ASSERT(is(tb, "bcd"));
+    TEST_ASSERT(TEXTBUF_UNDO(tb, NULLPTR));
+    TEST_ASSERT(is(tb, "bc"));
+    TEST_ASSERT(TEXTBUF_UNDO(tb, NULLPTR));
+    TEST_ASSERT(is(tb, "abc"));
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+/* ============================================================
+   Scripted edits against a flat reference copy
+   ============================================================ */
+#define MODEL_MAX 8192
+#define STEPS     600
+
+static U8  model[MODEL_MAX];
+static U32 model_len;
+static U8  snap[STEPS + 1][256];
+static U32 snap_len[STEPS + 1];
+static U32 rng = 7;
+
+static U32 rnd(U32 n) {
+    rng = rng * 1103515245U + 12345U;
+    return (rng >> 16) % n;
+}
+
+static BOOL matches_model(TEXTBUF *tb) {
+    if (TEXTBUF_LENGTH(tb) != model_len) return FALSE;
+    TEXTBUF_READ(tb, 0, got, model_len);
+    if (MEMCMP(got, model, model_len) != 0) return FALSE;
+    /* Every line start and every offset's line */
+    U32 line = 0, start = 0;
+    for (U32 i = 0; i <= model_len; i++) {
+        if (TEXTBUF_LINE_OF(tb, i) != line) return FALSE;
+        if (i == model_len || model[i] == '\n') {
+            if (TEXTBUF_LINE_START(tb, line) != start) return FALSE;
+            if (TEXTBUF_LINE_LENGTH(tb, line) != i - start) return FALSE;
+            line++;
+            start = i + 1;
+        }
+    }
+    return TEXTBUF_LINE_COUNT(tb) == line;
+}
+
+static int test_scripted_against_model(void) {
+    const CHAR *init = "int main(void) {\n    return 0;\n}\n";
+    TEXTBUF *tb = make(init);
+    model_len = STRLEN((PU8)init);
+    MEMCPY(model, (PU8)init, model_len);
+
+    U32 groups = 0;
+    for (U32 step = 0; step < STEPS; step++) {
+        BOOL insert = (rnd(10) < 6 || model_len < 8) && model_len + 8 <= 240;
+        if (insert) {
+            U8 text[8];
+            U32 n = 1 + rnd(sizeof(text));
+            for (U32 k = 0; k < n; k++) text[k] = rnd(5) ? (U8)('a' + rnd(26)) : '\n';
+            U32 at = rnd(model_len + 1);
+            TEST_ASSERT(TEXTBUF_INSERT(tb, at, text, n));
+            MEMMOVE(model + at + n, model + at, model_len - at);
+            MEMCPY(model + at, text, n);
+            model_len += n;
+        } else {
+            U32 at = rnd(model_len);
+            U32 n = 1 + rnd(12);
+            if (n > model_len - at) n = model_len - at;
+            TEST_ASSERT(TEXTBUF_DELETE(tb, at, n));
+            MEMMOVE(model + at, model + at + n, model_len - at - n);
+            model_len -= n;
+        }
+        TEST_ASSERT(matches_model(tb));
+        /* Every edit is its own group; remember the text after each */
+        TEXTBUF_COMMIT(tb);
+        groups++;
+        MEMCPY(snap[groups], model, model_len);
+        snap_len[groups] = model_len;
+    }
+    MEMCPY(snap[0], (PU8)init, STRLEN((PU8)init));
+    snap_len[0] = STRLEN((PU8)init);
+
+    /* Walk the whole history back and forth */
+    for (U32 g = groups; g-- > 0;) {
+        TEST_ASSERT(TEXTBUF_UNDO(tb, NULLPTR));
+        model_len = snap_len[g];
+        MEMCPY(model, snap[g], model_len);
+        TEST_ASSERT(matches_model(tb));
+    }
+    TEST_ASSERT(!TEXTBUF_UNDO(tb, NULLPTR));
+    TEST_ASSERT(TEXTBUF_PIECE_COUNT(tb) >= 1);
+    for (U32 g = 1; g <= groups; g++) {
+        TEST_ASSERT(TEXTBUF_REDO(tb, NULLPTR));
+        model_len = snap_len[g];
+        MEMCPY(model, snap[g], model_len);
+        TEST_ASSERT(matches_model(tb));
+    }
+    TEST_ASSERT(!TEXTBUF_REDO(tb, NULLPTR));
+    TEXTBUF_DESTROY(tb);
+    return 0;
+}
+
+TEST_MAIN("TEXTBUF")
+    RUN_TEST(test_empty);
+    RUN_TEST(test_line_queries);
+    RUN_TEST(test_insert_delete);
+    RUN_TEST(test_read_window);
+    RUN_TEST(test_typing_coalesces);
+    RUN_TEST(test_undo_groups);
+    RUN_TEST(test_edit_drops_redo);
+    RUN_TEST(test_scripted_against_model);
+TEST_RETURN
@@ -0,0 +1,180 @@
+#include "harness/test.h"
+/* FONT8x8 sizes are kernel-side definitions */
+#define __RTOS__
+#include <DRIVERS/VESA/VBE.h>
+#undef __RTOS__
+#include <DRIVERS/VESA/VBE_TEXT.h>
+#include <DRIVERS/VESA/FONT8x8.h>
+#include <PROGRAMS/SHELL/FONT8x16.h>
+
+/* Span renderer (DRIVERS/VESA/VBE_TEXT.c) against a per-pixel reference
+   that mirrors the old VBE_DRAW_CHARACTER loop, on 24 and 32 bpp buffers */
+
+#define W      96
+#define H      40
+#define MAXBPP 4
+
+static U8 fb_span[H * W * MAXBPP];
+static U8 fb_ref[H * W * MAXBPP];
+
+static CONST VBE_FONT font8 = { &VBE_LETTERS[0][0], VBE_CHAR_HEIGHT, UNUSABLE_CHARS, VBE_MAX_CHARS };
+static CONST VBE_FONT font16 = { toshiba_t5200c_bios_vers_3__2__8x16, 16, 0, 256 };
+static VBE_GLYPH_CACHE spans;
+
+static VBE_TEXT_TARGET target(U8 *fb, U32 bpp) {
+    VBE_TEXT_TARGET t = { fb, W * bpp, bpp, 0, 0, W, H };
+    return t;
+}
+
+static void fill(U8 *fb, U8 v) {
+    for (U32 i = 0; i < sizeof(fb_span); i++) fb[i] = (U8)(v + i * 13);
+}
+
+static void ref_pixel(CONST VBE_TEXT_TARGET *t, I32 x, I32 y, VBE_PIXEL_COLOUR c) {
+    if (x < t->cx0 || y < t->cy0 || x >= t->cx1 || y >= t->cy1) return;
+    if (c == VBE_SEE_THROUGH) return;
+    U8 *p = t->fb + (U32)y * t->pitch + (U32)x * t->bpp;
+    for (U32 k = 0; k < t->bpp; k++) p[k] = (U8)(c >> (8 * k));
+}
+
+static void ref_run(CONST VBE_TEXT_TARGET *t, CONST VBE_FONT *f, I32 x, I32 y,
+                    CONST U8 *text, U32 len, U32 advance, VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
+    for (U32 i = 0; i < len; i++, x += (I32)advance) {
+        U32 code = (U32)text[i] - f->first;
+        if (code >= f->count) continue;
+        for (U32 r = 0; r < f->height; r++) {
+            U8 bits = f->bits[code * f->height + r];
+            for (U32 c = 0; c < advance; c++) {
+                BOOL on = c < 8 && (bits & (0x80 >> c));
+                ref_pixel(t, x + (I32)c, y + (I32)r, on ? fg : bg);
+            }
+        }
+    }
+}
+
+static BOOL same(void) {
+    for (U32 i = 0; i < sizeof(fb_span); i++)
+        if (fb_span[i] != fb_ref[i]) return FALSE;
+    return TRUE;
+}
+
+/* The cache slot holding fg/bg at `bpp`, if any */
+static CONST VBE_GLYPH_SPANS *cached(U32 bpp, VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
+    for (U32 i = 0; i < VBE_TEXT_SPAN_SLOTS; i++) {
+        CONST VBE_GLYPH_SPANS *s = &spans.slot[i];
+        if (s->bpp == bpp && s->fg == fg && s->bg == bg) return s;
+    }
+    return NULLPTR;
+}
+
+/* Draws the same run with both renderers over identical backgrounds */
+static BOOL run_matches(U32 bpp, CONST VBE_FONT *f, I32 cx0, I32 cy0, I32 cx1, I32 cy1,
+                        I32 x, I32 y, CONST CHAR *text, U32 advance,
+                        VBE_PIXEL_COLOUR fg, VBE_PIXEL_COLOUR bg) {
+    U32 len = 0;
+    while (text[len]) len++;
+    fill(fb_span, 7);
+    fill(fb_ref, 7);
+    VBE_TEXT_TARGET ts = target(fb_span, bpp), tr = target(fb_ref, bpp);
+    ts.cx0 = tr.cx0 = cx0; ts.cy0 = tr.cy0 = cy0;
+    ts.cx1 = tr.cx1 = cx1; ts.cy1 = tr.cy1 = cy1;
+    VBE_TEXT_RUN(&ts, f, &spans, x, y, (CONST U8 *)text, len, advance, fg, bg);
+    ref_run(&tr, f, x, y, (CONST U8 *)text, len, advance, fg, bg);
+    return same();
+}
+
+static int test_opaque_8x8(void) {
+    for (U32 bpp = 3; bpp <= 4; bpp++) {
+        TEST_ASSERT(run_matches(bpp, &font8, 0, 0, W, H, 0, 0, "Hello, atOS!", 8, VBE_WHITE, VBE_BLACK));
+        TEST_ASSERT(run_matches(bpp, &font8, 0, 0, W, H, 3, 5, "{[(~#@$%)]}", 8, 0x123456, 0xABCDEF));
+    }
+    return 0;
+}
+
+static int test_opaque_8x16_spacing(void) {
+    for (U32 bpp = 3; bpp <= 4; bpp++) {
+        TEST_ASSERT(run_matches(bpp, &font16, 0, 0, W, H, 1, 2, "\xDB shell\x01", 10, VBE_WHITE, VBE_BLUE));
+        TEST_ASSERT(run_matches(bpp, &font16, 0, 0, W, H, 0, 20, "abcdefgh", 12, VBE_GREEN, VBE_BLACK));
+    }
+    return 0;
+}
+
+static int test_clipped_edges(void) {
+    for (U32 bpp = 3; bpp <= 4; bpp++) {
+        /* Off every screen edge */
+        TEST_ASSERT(run_matches(bpp, &font8, 0, 0, W, H, -5, -3, "clip me please", 8, VBE_WHITE, VBE_BLACK));
+        TEST_ASSERT(run_matches(bpp, &font16, 0, 0, W, H, 60, 30, "right+bottom", 10, VBE_WHITE, VBE_BLACK));
+        /* Clip rectangle cutting through glyphs and through spacing */
+        TEST_ASSERT(run_matches(bpp, &font16, 13, 4, 51, 17, 0, 0, "0123456789", 10, 0x00FF8800, 0x00002244));
+        TEST_ASSERT(run_matches(bpp, &font16, 19, 0, 20, H, 0, 0, "0123456789", 10, VBE_WHITE, VBE_BLACK));
+    }
+    return 0;
+}
+
+static int test_see_through(void) {
+    for (U32 bpp = 3; bpp <= 4; bpp++) {
+        TEST_ASSERT(run_matches(bpp, &font8, 0, 0, W, H, 2, 2, "transparent", 8, VBE_WHITE, VBE_SEE_THROUGH));
+        TEST_ASSERT(run_matches(bpp, &font16, 0, 0, W, H, -4, 1, "stencil", 10, VBE_SEE_THROUGH, VBE_RED));
+    }
+    return 0;
+}
+
+static int test_missing_glyphs_untouched(void) {
+    /* Space and control codes are below FONT8x8's first glyph */
+    TEST_ASSERT(run_matches(4, &font8, 0, 0, W, H, 0, 0, "a b\tc", 8, VBE_WHITE, VBE_BLACK));
+    fill(fb_span, 7);
+    fill(fb_ref, 7);
+    VBE_TEXT_TARGET t = target(fb_span, 4);
+    TEST_ASSERT(VBE_TEXT_RUN(&t, &font8, &spans, 0, 0, (CONST U8 *)"   ", 3, 8, VBE_WHITE, VBE_BLACK) == 0);
+    TEST_ASSERT(same());
+    return 0;
+}
+
+static int test_colour_changes_rebuild(void) {
+    /* The table follows fg/bg and pixel size between runs */
+    TEST_ASSERT(run_matches(4, &font8, 0, 0, W, H, 0, 0, "AAAA", 8, VBE_WHITE, VBE_BLACK));
+    TEST_ASSERT(run_matches(4, &font8, 0, 0, W, H, 0, 0, "AAAA", 8, VBE_BLACK, VBE_WHITE));
+    TEST_ASSERT(run_matches(3, &font8, 0, 0, W, H, 0, 0, "AAAA", 8, VBE_BLACK, VBE_WHITE));
+    TEST_ASSERT(cached(3, VBE_BLACK, VBE_WHITE));
+    return 0;
+}
+
+static int test_cache_keeps_recent_pairs(void) {
+    /* Four pairs fit; a fifth replaces the least recently used one */
+    static CONST VBE_PIXEL_COLOUR fg[5] = { VBE_WHITE, VBE_BLACK, VBE_RED, VBE_GREEN, VBE_YELLOW };
+    static CONST VBE_PIXEL_COLOUR bg[5] = { VBE_BLACK, VBE_WHITE, VBE_BLUE, VBE_BLACK, VBE_BLUE };
+    for (U32 i = 0; i < VBE_TEXT_SPAN_SLOTS; i++) spans.slot[i].bpp = 0;
+    for (U32 i = 0; i < 4; i++)
+        TEST_ASSERT(run_matches(4, &font8, 0, 0, W, H, 0, 0, "Ab", 8, fg[i], bg[i]));
+    CONST VBE_GLYPH_SPANS *first = cached(4, fg[0], bg[0]);
+    TEST_ASSERT(first && cached(4, fg[3], bg[3]));
+    TEST_ASSERT(run_matches(4, &font8, 0, 0, W, H, 0, 0, "Ab", 8, fg[0], bg[0]));
+    TEST_ASSERT(cached(4, fg[0], bg[0]) == first);
+    TEST_ASSERT(run_matches(4, &font8, 0, 0, W, H, 0, 0, "Ab", 8, fg[4], bg[4]));
+    TEST_ASSERT(!cached(4, fg[1], bg[1]));
+    TEST_ASSERT(cached(4, fg[0], bg[0]) == first && cached(4, fg[2], bg[2]) && cached(4, fg[4], bg[4]));
+    TEST_ASSERT(run_matches(4, &font8, 0, 0, W, H, 0, 0, "Ab", 8, fg[1], bg[1]));
+    return 0;
+}
+
+static int test_return_counts_visible(void) {
+    VBE_TEXT_TARGET t = target(fb_span, 4);
+    CONST U8 *s = (CONST U8 *)"0123456789ABCDEF";
+    TEST_ASSERT(VBE_TEXT_RUN(&t, &font8, &spans, 0, 0, s, 16, 8, VBE_WHITE, VBE_BLACK) == 12);
+    TEST_ASSERT(VBE_TEXT_RUN(&t, &font8, &spans, -12, 0, s, 16, 8, VBE_WHITE, VBE_BLACK) == 13);
+    TEST_ASSERT(VBE_TEXT_RUN(&t, &font8, &spans, 0, H, s, 16, 8, VBE_WHITE, VBE_BLACK) == 0);
+    TEST_ASSERT(VBE_TEXT_RUN(&t, &font8, &spans, W, 0, s, 16, 8, VBE_WHITE, VBE_BLACK) == 0);
+    TEST_ASSERT(VBE_TEXT_RUN(&t, &font8, &spans, -128, 0, s, 16, 8, VBE_WHITE, VBE_BLACK) == 0);
+    return 0;
+}
+
+TEST_MAIN("VBE_TEXT")
+    RUN_TEST(test_opaque_8x8);
+    RUN_TEST(test_opaque_8x16_spacing);
+    RUN_TEST(test_clipped_edges);
+    RUN_TEST(test_see_through);
+    RUN_TEST(test_missing_glyphs_untouched);
+    RUN_TEST(test_colour_changes_rebuild);
+    RUN_TEST(test_cache_keeps_recent_pairs);
+    RUN_TEST(test_return_counts_visible);
+TEST_RETURN
@@ -0,0 +1,173 @@
+/*
+ * Host-side ATZ archive tool.
+ *
+ * Built from the same LIBRARIES/ATZP and ATHASH sources that ZIP.BIN uses,
+ * so archives made here open on atOS and vice versa.
+ *
+ *   ATZ.out create  <out.atz> <file> [file ...]   (stored under the given name)
+ *   ATZ.out list    <arch.atz>
+ *   ATZ.out extract <arch.atz> <name> <out_file>
+ *   ATZ.out test    <arch.atz>                    (CRC-check every entry)
+ *   ATZ.out check   <arch.atz> <file> [file ...]  (byte-compare against originals)
+ *
+ * The atOS headers redefine size_t, so libc is declared by hand here.
+ */
+#include <LIBRARIES/ATZP/ATZ.h>
+#include <LIBRARIES/ATZP/ATZP.h>
+#include <STD/STRING.h>
+#include <STD/MEM.h>
+
+typedef struct HOST_FILE HOST_FILE;
+extern HOST_FILE *fopen(const char *path, const char *mode);
+extern int fclose(HOST_FILE *f);
+extern unsigned long fread(void *buf, unsigned long size, unsigned long n, HOST_FILE *f);
+extern unsigned long fwrite(const void *buf, unsigned long size, unsigned long n, HOST_FILE *f);
+extern int printf(const char *format, ...);
+extern void *malloc(unsigned long n);
+extern void *realloc(void *p, unsigned long n);
+extern void free(void *p);
+
+/* Reads a whole host file; returns NULLPTR on error. */
+static PU8 load_file(CONST CHAR *path, U32 *out_len) {
+    HOST_FILE *f = fopen(path, "rb");
+    if (!f) return NULLPTR;
+    U32 cap = 65536, len = 0;
+    PU8 buf = malloc(cap);
+    while (buf) {
+        unsigned long n = fread(buf + len, 1, cap - len, f);
+        len += (U32)n;
+        if (len < cap) break;
+        cap *= 2;
+        buf = realloc(buf, cap);
+    }
+    fclose(f);
+    *out_len = len;
+    return buf;
+}
+
+static BOOL save_file(CONST CHAR *path, PU8 data, U32 len) {
+    HOST_FILE *f = fopen(path, "wb");
+    if (!f) return FALSE;
+    BOOL ok = fwrite(data, 1, len, f) == len;
+    return fclose(f) == 0 && ok;
+}
+
+static BOOL open_archive(CONST CHAR *path, ATZ_MEM_SOURCE *src, ATZ_READER *r) {
+    src->data = load_file(path, &src->size);
+    if (!src->data) {
+        printf("cannot read '%s'\n", path);
+        return FALSE;
+    }
+    if (!ATZ_READER_OPEN(r, ATZ_MEM_SOURCE_READ_AT, src, src->size)) {
+        printf("'%s' is not a valid ATZ archive\n", path);
+        free(src->data);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static int cmd_create(int argc, char **argv) {
+    ATZ_MEM_SINK sink = { 0 };
+    ATZ_WRITER w;
+    int rc = 1;
+    if (!ATZ_WRITER_INIT(&w, ATZ_MEM_SINK_WRITE, &sink, 0)) return 1;
+    for (int i = 3; i < argc; i++) {
+        U32 len;
+        PU8 data = load_file(argv[i], &len);
+        if (!data) {
+            printf("cannot read '%s'\n", argv[i]);
+            goto out;
+        }
+        BOOL ok = ATZ_WRITER_ADD(&w, (PU8)argv[i], data, len);
+        free(data);
+        if (!ok) goto out;
+    }
+    if (ATZ_WRITER_FINISH(&w) && save_file(argv[2], sink.data, sink.size)) {
+        printf("%s: %u entries, %u bytes\n", argv[2], w.count, sink.size);
+        rc = 0;
+    }
+out:
+    ATZ_WRITER_FREE(&w);
+    ATZ_MEM_SINK_FREE(&sink);
+    return rc;
+}
+
+static int cmd_list(char *path) {
+    ATZ_MEM_SOURCE src;
+    ATZ_READER r;
+    if (!open_archive(path, &src, &r)) return 1;
+    for (U32 i = 0; i < r.count; i++) {
+        ATZ_ENTRY *e = &r.entries[i];
+        printf("%10u %10u %-5s %08x %s\n", e->original_size, e->compressed_size,
+               (e->flags & ATZ_FLAG_LZ4) ? "lz4" : "store", e->crc32, e->name);
+    }
+    printf("%u entries, format v%u\n", r.count, r.version);
+    ATZ_READER_CLOSE(&r);
+    free(src.data);
+    return 0;
+}
+
+static int cmd_extract(char *path, char *name, char *out_path) {
+    ATZ_MEM_SOURCE src;
+    ATZ_READER r;
+    int rc = 1;
+    if (!open_archive(path, &src, &r)) return 1;
+    ATZ_ENTRY *e = ATZ_READER_FIND(&r, (PU8)name);
+    PU8 data = e ? ATZ_READER_EXTRACT(&r, e) : NULLPTR;
+    if (!data)
+        printf("cannot extract '%s'\n", name);
+    else if (save_file(out_path, data, e->original_size))
+        rc = 0;
+    if (data) MFree(data);
+    ATZ_READER_CLOSE(&r);
+    free(src.data);
+    return rc;
+}
+
+/* test: every entry decodes and matches its CRC.
+   check: additionally, every listed host file matches its entry byte for byte. */
+static int cmd_verify(int argc, char **argv, BOOL compare) {
+    ATZ_MEM_SOURCE src;
+    ATZ_READER r;
+    U32 bad = 0;
+    if (!open_archive(argv[2], &src, &r)) return 1;
+
+    for (U32 i = 0; i < r.count; i++) {
+        PU8 data = ATZ_READER_EXTRACT(&r, &r.entries[i]);
+        if (!data) {
+            printf("FAIL %s\n", r.entries[i].name);
+            bad++;
+        } else {
+            MFree(data);
+        }
+    }
+
+    for (int i = 3; compare && i < argc; i++) {
+        U32 len;
+        PU8 orig = load_file(argv[i], &len);
+        ATZ_ENTRY *e = ATZ_READER_FIND(&r, (PU8)argv[i]);
+        PU8 data = e ? ATZ_READER_EXTRACT(&r, e) : NULLPTR;
+        if (!orig || !data || e->original_size != len || MEMCMP(orig, data, len) != 0) {
+            printf("MISMATCH %s\n", argv[i]);
+            bad++;
+        }
+        if (orig) free(orig);
+        if (data) MFree(data);
+    }
+
+    printf("%u entries, %u error(s)\n", r.count, bad);
+    ATZ_READER_CLOSE(&r);
+    free(src.data);
+    return bad ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 4 && STRCMP((PU8)argv[1], (PU8)"create") == 0)  return cmd_create(argc, argv);
+    if (argc == 3 && STRCMP((PU8)argv[1], (PU8)"list") == 0)    return cmd_list(argv[2]);
+    if (argc == 5 && STRCMP((PU8)argv[1], (PU8)"extract") == 0) return cmd_extract(argv[2], argv[3], argv[4]);
+    if (argc == 3 && STRCMP((PU8)argv[1], (PU8)"test") == 0)    return cmd_verify(argc, argv, FALSE);
+    if (argc >= 4 && STRCMP((PU8)argv[1], (PU8)"check") == 0)   return cmd_verify(argc, argv, TRUE);
+
+    printf("usage: ATZ.out create|list|extract|test|check ...\n");
+    return 2;
+}
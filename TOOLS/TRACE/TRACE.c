@@ -0,0 +1,341 @@
+/*
+ * Host-side decoder for kernel trace dumps (DEBUG/TRACE.h).
+ *
+ * Capture the COM port the dump was sent to (COM2 by default, which
+ * `make run` pipes to OUTPUT/SERIAL/SERIAL2), then:
+ *
+ *   TRACE.out <capture> [-q] [-l cols] [-p pid] [-c class,class...]
+ *
+ *   -q         summary only, no event listing
+ *   -l cols    draw a per-task CPU lane chart `cols` characters wide
+ *   -p pid     only list events of one task
+ *   -c classes only list these classes (sched syscall irq disk heap user)
+ *
+ * The capture may hold other bytes and several dumps; every dump found is
+ * decoded. The atOS headers redefine size_t, so libc is declared by hand.
+ */
+#define TRACE_ONLY_DEFINES
+#include <DEBUG/TRACE.h>
+
+typedef struct HOST_FILE HOST_FILE;
+extern HOST_FILE *fopen(const char *path, const char *mode);
+extern int fclose(HOST_FILE *f);
+extern unsigned long fread(void *buf, unsigned long size, unsigned long n, HOST_FILE *f);
+extern int printf(const char *format, ...);
+extern void *malloc(unsigned long n);
+extern void *calloc(unsigned long n, unsigned long size);
+extern void *realloc(void *p, unsigned long n);
+extern void free(void *p);
+extern int atoi(const char *s);
+extern int strcmp(const char *a, const char *b);
+extern int strncmp(const char *a, const char *b, unsigned long n);
+extern void *memcpy(void *dst, const void *src, unsigned long n);
+
+typedef unsigned long long u64;
+
+#define MAX_PIDS 65536
+
+static const struct { const char *name; U32 bit; } classes[] = {
+    { "sched",   TRACE_CLASS_SCHED },
+    { "syscall", TRACE_CLASS_SYSCALL },
+    { "irq",     TRACE_CLASS_IRQ },
+    { "disk",    TRACE_CLASS_DISK },
+    { "heap",    TRACE_CLASS_HEAP },
+    { "user",    TRACE_CLASS_USER },
+};
+#define CLASS_COUNT (sizeof(classes) / sizeof(classes[0]))
+
+static int opt_quiet = 0;
+static int opt_lanes = 0;
+static int opt_pid = -1;
+static U32 opt_classes = TRACE_CLASS_ALL;
+
+static PU8 load_file(const char *path, U32 *out_len) {
+    HOST_FILE *f = fopen(path, "rb");
+    if (!f) return NULLPTR;
+    U32 cap = 65536, len = 0;
+    PU8 buf = malloc(cap);
+    while (buf) {
+        unsigned long n = fread(buf + len, 1, cap - len, f);
+        len += (U32)n;
+        if (len < cap) break;
+        cap *= 2;
+        PU8 tmp = realloc(buf, cap);
+        if (!tmp) { free(buf); buf = NULLPTR; }
+        buf = tmp;
+    }
+    fclose(f);
+    *out_len = len;
+    return buf;
+}
+
+static u64 tsc_of(const TRACE_EVENT *e) {
+    return ((u64)e->tsc_hi << 32) | e->tsc_lo;
+}
+
+static const char *event_name(U32 ev) {
+    switch (ev) {
+        case TRACE_EV_SWITCH:         return "SWITCH";
+        case TRACE_EV_FLUSH:          return "FLUSH";
+        case TRACE_EV_SYSCALL_ENTER:  return "SYSCALL";
+        case TRACE_EV_SYSCALL_EXIT:   return "SYSRET";
+        case TRACE_EV_IRQ:            return "IRQ";
+        case TRACE_EV_DISK_SUBMIT:    return "DISK_SUBMIT";
+        case TRACE_EV_DISK_COMPLETE:  return "DISK_DONE";
+        case TRACE_EV_KMALLOC:        return "KMALLOC";
+        case TRACE_EV_KFREE:          return "KFREE";
+        case TRACE_EV_MARK:           return "MARK";
+    }
+    return "?";
+}
+
+static void print_details(const TRACE_EVENT *e) {
+    switch (e->event) {
+        case TRACE_EV_SWITCH:         printf("%u -> %u", e->a, e->b); break;
+        case TRACE_EV_FLUSH:          printf("pid %u, %u bytes in %u cycles", e->c, e->b, e->a); break;
+        case TRACE_EV_SYSCALL_ENTER:  printf("#%u a1=0x%x", e->a, e->b); break;
+        case TRACE_EV_SYSCALL_EXIT:   printf("#%u ret=0x%x", e->a, e->b); break;
+        case TRACE_EV_IRQ:            printf("vector 0x%x (IRQ%u)", e->a, e->a - 0x20); break;
+        case TRACE_EV_DISK_SUBMIT:
+            printf("%s dev %u lba %u x%u", (e->c & 0x100) ? "write" : "read", e->c & 0xFF, e->a, e->b);
+            break;
+        case TRACE_EV_DISK_COMPLETE:  printf("lba %u %s status 0x%x", e->a, e->b ? "ok" : "FAILED", e->c); break;
+        case TRACE_EV_KMALLOC:        printf("0x%08x size %u", e->a, e->b); break;
+        case TRACE_EV_KFREE:          printf("0x%08x size %u", e->a, e->b); break;
+        case TRACE_EV_MARK:           printf("%u %u %u", e->a, e->b, e->c); break;
+        default:                      printf("0x%x 0x%x 0x%x", e->a, e->b, e->c); break;
+    }
+}
+
+static void print_mask(U32 mask) {
+    int any = 0;
+    for (U32 i = 0; i < CLASS_COUNT; i++)
+        if (mask & classes[i].bit) { printf(" %s", classes[i].name); any = 1; }
+    if (!any) printf(" none");
+}
+
+typedef struct {
+    u64 count;
+    u64 cycles;
+} STAT;
+
+/* Lane chart: one row per task, '#' when it ran for most of a column, '+' for part of it */
+static void draw_lanes(const TRACE_EVENT *ev, U32 count, u64 t0, u64 t1, double cyc_per_us) {
+    if (t1 <= t0 || opt_lanes < 8) return;
+    u64 span = t1 - t0;
+    U32 cols = (U32)opt_lanes;
+    U8 *seen = calloc(MAX_PIDS, 1);
+    u64 **cells = calloc(MAX_PIDS, sizeof(u64 *));
+    if (!seen || !cells) return;
+
+    int cur = -1;
+    u64 since = t0;
+    for (U32 i = 0; i <= count; i++) {
+        int last = (i == count);
+        if (!last && ev[i].event != TRACE_EV_SWITCH) continue;
+        u64 at = last ? t1 : tsc_of(&ev[i]);
+        int pid = (cur < 0 && !last) ? (int)ev[i].a : cur;
+        if (pid >= 0 && at > since) {
+            if (!cells[pid]) cells[pid] = calloc(cols, sizeof(u64));
+            seen[pid] = 1;
+            /* Spread [since, at) over the columns it covers */
+            for (u64 s = since; s < at;) {
+                U32 col = (U32)((s - t0) * cols / span);
+                if (col >= cols) break;
+                u64 col_end = t0 + (span * (col + 1) + cols - 1) / cols;
+                u64 e = at < col_end ? at : col_end;
+                if (e <= s) break;
+                cells[pid][col] += e - s;
+                s = e;
+            }
+        }
+        if (!last) { cur = (int)ev[i].b; since = at; }
+    }
+
+    u64 per_col = span / cols;
+    if (cyc_per_us > 0) printf("\nCPU lanes (%u columns, %.3f ms each):\n", cols, per_col / cyc_per_us / 1000.0);
+    else printf("\nCPU lanes (%u columns, %llu cycles each):\n", cols, per_col);
+    for (int pid = 0; pid < MAX_PIDS; pid++) {
+        if (!seen[pid]) continue;
+        printf("  pid %5d |", pid);
+        for (U32 c = 0; c < cols; c++) {
+            u64 v = cells[pid][c];
+            printf("%c", v == 0 ? ' ' : (v * 2 >= per_col ? '#' : '+'));
+        }
+        printf("|\n");
+        free(cells[pid]);
+    }
+    free(cells);
+    free(seen);
+}
+
+static void decode(const TRACE_DUMP_HEADER *h, const TRACE_EVENT *ev, U32 index) {
+    u64 base = ((u64)h->base_tsc_hi << 32) | h->base_tsc_lo;
+    u64 now  = ((u64)h->now_tsc_hi << 32) | h->now_tsc_lo;
+    U32 ticks = h->now_tick - h->base_tick;
+    double cyc_per_us = 0;
+    if (ticks && h->tick_hz && now > base)
+        cyc_per_us = (double)(now - base) / ((double)ticks * 1000000.0 / h->tick_hz);
+
+    printf("dump %u: %u events, %u lost, classes", index, h->count, h->lost);
+    print_mask(h->mask);
+    if (cyc_per_us > 0) printf(", %.1f TSC cycles/us\n", cyc_per_us);
+    else printf(", no clock calibration (times in cycles)\n");
+    if (!h->count) return;
+
+    u64 t0 = tsc_of(&ev[0]);
+    u64 t1 = tsc_of(&ev[h->count - 1]);
+#define TIME(c) (cyc_per_us > 0 ? (double)(c) / cyc_per_us : (double)(c))
+
+    STAT *sys = calloc(256, sizeof(STAT));
+    STAT irq[16] = { 0 };
+    STAT disk = { 0 };
+    STAT flush = { 0 };
+    u64 *run = calloc(MAX_PIDS, sizeof(u64));
+    u64 *sys_enter = calloc(MAX_PIDS, sizeof(u64));
+    U32 *sys_num = calloc(MAX_PIDS, sizeof(U32));
+    u64 disk_submit = 0;
+    u64 kmallocs = 0, kfrees = 0, kbytes = 0;
+    if (!sys || !run || !sys_enter || !sys_num) return;
+
+    if (!opt_quiet) printf("%14s %10s %5s  %-12s %s\n", cyc_per_us > 0 ? "time_us" : "cycles", "delta", "pid", "event", "details");
+
+    u64 prev = t0;
+    int cur = -1;
+    u64 since = t0;
+    for (U32 i = 0; i < h->count; i++) {
+        const TRACE_EVENT *e = &ev[i];
+        u64 t = tsc_of(e);
+        if (e->event == TRACE_EV_NONE) continue;
+
+        switch (e->event) {
+            case TRACE_EV_SWITCH:
+                if (cur >= 0) run[cur] += t - since;
+                cur = (int)e->b;
+                since = t;
+                break;
+            case TRACE_EV_SYSCALL_ENTER:
+                sys_enter[e->pid] = t;
+                sys_num[e->pid] = e->a;
+                break;
+            case TRACE_EV_SYSCALL_EXIT:
+                if (sys_enter[e->pid] && sys_num[e->pid] == e->a && e->a < 256) {
+                    sys[e->a].count++;
+                    sys[e->a].cycles += t - sys_enter[e->pid];
+                }
+                sys_enter[e->pid] = 0;
+                break;
+            case TRACE_EV_FLUSH:
+                flush.count++;
+                flush.cycles += e->a;
+                break;
+            case TRACE_EV_IRQ:
+                if (e->a >= 0x20 && e->a < 0x30) irq[e->a - 0x20].count++;
+                break;
+            case TRACE_EV_DISK_SUBMIT:
+                disk_submit = t;
+                break;
+            case TRACE_EV_DISK_COMPLETE:
+                if (disk_submit) { disk.count++; disk.cycles += t - disk_submit; }
+                disk_submit = 0;
+                break;
+            case TRACE_EV_KMALLOC: kmallocs++; kbytes += e->b; break;
+            case TRACE_EV_KFREE:   kfrees++; break;
+        }
+
+        if (opt_quiet) continue;
+        if (!(TRACE_CLASS_OF(e->event) & opt_classes)) continue;
+        if (opt_pid >= 0 && e->pid != opt_pid && !(e->event == TRACE_EV_SWITCH && (int)e->b == opt_pid)) continue;
+        printf("%14.3f %+10.3f %5u  %-12s ", TIME(t - t0), TIME(t - prev), e->pid, event_name(e->event));
+        print_details(e);
+        printf("\n");
+        prev = t;
+    }
+    if (cur >= 0) run[cur] += t1 - since;
+
+    double total = TIME(t1 - t0);
+    printf("\nspan %.3f %s\n", total, cyc_per_us > 0 ? "us" : "cycles");
+    printf("CPU time per task:\n");
+    for (int pid = 0; pid < MAX_PIDS; pid++)
+        if (run[pid]) printf("  pid %5d  %12.3f  %5.1f%%\n", pid, TIME(run[pid]), t1 > t0 ? 100.0 * run[pid] / (t1 - t0) : 0.0);
+    printf("Syscalls (count, mean latency):\n");
+    for (U32 n = 0; n < 256; n++)
+        if (sys[n].count) printf("  #%-4u %8llu  %10.3f\n", n, sys[n].count, TIME(sys[n].cycles / sys[n].count));
+    printf("IRQs:");
+    for (U32 n = 0; n < 16; n++) if (irq[n].count) printf("  IRQ%u=%llu", n, irq[n].count);
+    printf("\n");
+    if (flush.count) printf("Framebuffer flush: %llu, mean %.3f\n", flush.count, TIME(flush.cycles / flush.count));
+    if (disk.count) printf("Disk: %llu transfers, mean %.3f\n", disk.count, TIME(disk.cycles / disk.count));
+    if (kmallocs || kfrees) printf("Heap: %llu KMALLOC (%llu bytes), %llu KFREE\n", kmallocs, kbytes, kfrees);
+
+    if (opt_lanes) draw_lanes(ev, h->count, t0, t1, cyc_per_us);
+    printf("\n");
+#undef TIME
+
+    free(sys); free(run); free(sys_enter); free(sys_num);
+}
+
+static U32 parse_classes(const char *s) {
+    U32 mask = 0;
+    while (*s) {
+        U32 len = 0;
+        while (s[len] && s[len] != ',') len++;
+        for (U32 i = 0; i < CLASS_COUNT; i++)
+            if (strncmp(s, classes[i].name, len) == 0 && classes[i].name[len] == 0) mask |= classes[i].bit;
+        s += len;
+        if (*s == ',') s++;
+    }
+    return mask;
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULLPTR;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) opt_quiet = 1;
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) opt_lanes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) opt_pid = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) opt_classes = parse_classes(argv[++i]);
+        else path = argv[i];
+    }
+    if (!path) {
+        printf("Usage: %s <capture> [-q] [-l cols] [-p pid] [-c class,...]\n", argv[0]);
+        return 1;
+    }
+
+    U32 len = 0;
+    PU8 buf = load_file(path, &len);
+    if (!buf) {
+        printf("Cannot read %s\n", path);
+        return 1;
+    }
+
+    U32 found = 0;
+    for (U32 off = 0; off + sizeof(TRACE_DUMP_HEADER) <= len; off++) {
+        TRACE_DUMP_HEADER h;
+        memcpy(&h, buf + off, sizeof(h));
+        if (h.magic != TRACE_DUMP_MAGIC) continue;
+        if (h.version != TRACE_DUMP_VERSION || h.event_size != sizeof(TRACE_EVENT) || h.count > TRACE_RING_ENTRIES) {
+            printf("offset %u: unsupported dump (version %u, event size %u)\n", off, h.version, h.event_size);
+            continue;
+        }
+        U32 body = h.count * sizeof(TRACE_EVENT);
+        if (off + sizeof(h) + body + 4 > len) {
+            printf("offset %u: truncated dump\n", off);
+            break;
+        }
+        PU8 p = buf + off + sizeof(h);
+        U32 sum = 0, want;
+        for (U32 k = 0; k < body; k++) sum += p[k];
+        memcpy(&want, p + body, 4);
+        if (sum != want) printf("offset %u: checksum mismatch, decoding anyway\n", off);
+
+        TRACE_EVENT *ev = malloc(body ? body : 1);
+        memcpy(ev, p, body);
+        decode(&h, ev, ++found);
+        free(ev);
+        off += sizeof(h) + body + 3;
+    }
+    if (!found) printf("No trace dump found in %s\n", path);
+    free(buf);
+    return found ? 0 : 1;
+}